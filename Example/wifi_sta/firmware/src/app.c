@@ -28,6 +28,7 @@
 // *****************************************************************************
 
 #include "app.h"
+#include "app_lease.h"
 #include "cJSON.h"
 #include "system/wifi/sys_wifi.h"
 #include "atca_basic.h"
@@ -315,6 +316,7 @@ void APP_Tasks ( void )
         {                   
             if((TCPIP_STACK_Status(sysObj.tcpip) == SYS_STATUS_READY))
             {     
+                APP_LEASE_Initialize();
                 appData.state = APP_MOUNT_DISK;
             }
             
@@ -745,6 +747,7 @@ void APP_Tasks ( void )
                 if(SWITCH1_Get() == SWITCH1_STATE_PRESSED)    
                 {
                     LED_RED_Toggle();
+                    APP_LEASE_Erase();
                     if(SYS_FS_FileDirectoryRemove(FFS_WIFI_CFG_FILE) == SYS_FS_RES_SUCCESS)                        
                     {
                         vTaskDelay(1000 / portTICK_PERIOD_MS);
@@ -764,6 +767,7 @@ void APP_Tasks ( void )
                             SYS_CONSOLE_MESSAGE("##############################################################\n\r");
                             SYS_CONSOLE_PRINT("Triggering Connection to FFS configured home AP \t%s\n\r", ffsWifiCfg.staConfig.ssid);
                             SYS_CONSOLE_MESSAGE("##############################################################\n\r");  
+                            APP_LEASE_Restore(ffsWifiCfg.staConfig.ssid);
                             appData.state = APP_STATE_SERVICE_TASKS;
                         }
                     }    
@@ -956,10 +960,24 @@ void APP_Tasks ( void )
         
         case APP_STATE_FFS_TASK:
         {                  
-            volatile SYS_TIME_HANDLE ffsTmrHdl;
-            ffsTmrHdl = SYS_TIME_CallbackRegisterMS(ffs_status_indicate, (uintptr_t)ffsTmrHdl, 1000, SYS_TIME_PERIODIC);
+            appData.ffsTimerHandle = SYS_TIME_CallbackRegisterMS(ffs_status_indicate, (uintptr_t)appData.ffsTimerHandle, 1000, SYS_TIME_PERIODIC);
             WDT_Enable();
-            if(FFS_Tasks(&sysObj) == FFS_STATE_DONE && (wifiConnCount > 1))
+            appData.state = APP_STATE_FFS_PROVISIONING;
+            break;
+        }
+        
+        case APP_STATE_FFS_PROVISIONING:
+        {
+            FFS_STATE_t ffsState = FFS_Tasks(&sysObj);
+            
+            /* Provisioning in progress: each call only checks the Wi-Fi join or DSS
+               request in flight, so the other application states keep running */
+            if(ffsState == FFS_STATE_PROVISIONING)
+            {
+                break;
+            }
+            
+            if(ffsState == FFS_STATE_DONE && (wifiConnCount > 1))
             {
                 SYS_FS_HANDLE ffsFileHandle;   
                 wifiConnCount = 0;
@@ -993,7 +1011,7 @@ void APP_Tasks ( void )
                 SYS_CONSOLE_MESSAGE("\n\n\n\r###############################\n\rFFS Failure!\n\r###############################\n\r");                
             }
             WDT_Disable();
-            SYS_TIME_TimerDestroy(ffsTmrHdl);
+            SYS_TIME_TimerDestroy(appData.ffsTimerHandle);
             LED_GREEN_Off();
             appData.state = APP_STATE_SERVICE_TASKS;
             break;    
@@ -1001,7 +1019,7 @@ void APP_Tasks ( void )
         
         case APP_STATE_SERVICE_TASKS:
         {
-            
+            APP_LEASE_Tasks();
             break;
         } 
         
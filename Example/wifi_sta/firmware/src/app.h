@@ -62,6 +62,10 @@ extern "C" {
 #define FFS_DEVICE_CFG_FILE_NAME                "ffs_device.cfg"
 #define FFS_DEVICE_WIFI_CFG_FILE_NAME                "ffs_wifi.cfg"
 #define FFS_DEVICE_FTPAUTH_FILE_NAME        "ftp_auth.cfg"
+#define FFS_DEVICE_LEASE_FILE_NAME              "ffs_lease.cfg"
+#define FFS_DEVICE_SETUP_CACHE_FILE_NAME        "ffs_setup.cache"
+#define FFS_DEVICE_CHECKPOINT_FILE_NAME         "ffs_checkpoint.bin"
+#define FFS_DEVICE_CHECKPOINT_TMP_FILE_NAME     "ffs_checkpoint.tmp"
     
 #define FFS_ROOT_CERT_FILE                              APP_MOUNT_NAME"/"FFS_ROOT_CERT_FILE_NAME
 #define FFS_DEVICE_PUB_KEY_FILE                     APP_MOUNT_NAME"/"FFS_DEVICE_PUB_KEY_FILE_NAME
@@ -72,6 +76,10 @@ extern "C" {
 #define FFS_WIFI_CFG_FILE                                   APP_MOUNT_NAME"/"FFS_DEVICE_WIFI_CFG_FILE_NAME
 #define FFS_DEVICE_CFG_FILE                             APP_MOUNT_NAME"/"FFS_DEVICE_CFG_FILE_NAME 
 #define FFS_FTPAUTH_FILE                                   APP_MOUNT_NAME"/"FFS_DEVICE_FTPAUTH_FILE_NAME
+#define FFS_LEASE_FILE                                       APP_MOUNT_NAME"/"FFS_DEVICE_LEASE_FILE_NAME
+#define FFS_SETUP_CACHE_FILE                           APP_MOUNT_NAME"/"FFS_DEVICE_SETUP_CACHE_FILE_NAME
+#define FFS_CHECKPOINT_FILE                            APP_MOUNT_NAME"/"FFS_DEVICE_CHECKPOINT_FILE_NAME
+#define FFS_CHECKPOINT_TMP_FILE                        APP_MOUNT_NAME"/"FFS_DEVICE_CHECKPOINT_TMP_FILE_NAME
     
 #define FFS_DEVICE_NAME_JSON_TAG                                           "device_name"
     
@@ -135,6 +143,7 @@ extern "C" {
     typedef enum {
         FFS_STATE_INIT = 0,
                 FFS_STATE_START,
+                FFS_STATE_PROVISIONING,
                 FFS_STATE_HTTP,
                 FFS_STATE_DONE,
     }FFS_STATE_t; 
@@ -146,6 +155,9 @@ extern "C" {
         
         /* The app performs ffs tasks */
         APP_STATE_FFS_TASK,
+
+        /* The app runs the FFS provisioning, one state at a time */
+        APP_STATE_FFS_PROVISIONING,
                 
         APP_STATE_SERVICE_TASKS,
 
@@ -317,6 +329,9 @@ extern "C" {
         
         long fileSize;
         
+        /* FFS status indication and watchdog timer */
+        SYS_TIME_HANDLE ffsTimerHandle;
+        
     } APP_DATA;
     
     extern APP_DATA appData;
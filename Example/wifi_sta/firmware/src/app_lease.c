@@ -0,0 +1,378 @@
+/*******************************************************************************
+  MPLAB Harmony Application Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_lease.c
+
+  Summary:
+    DHCP lease and gateway ARP persistence for fast reconnect after reboot.
+
+  Description:
+    The DHCP client normally starts every boot with a full
+    DISCOVER/OFFER/REQUEST/ACK exchange followed by an ARP resolution of the
+    gateway. This module saves the bound lease and the gateway MAC address so
+    that the next boot can request the known address directly (INIT-REBOOT)
+    and pre-warm the gateway ARP entry.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <string.h>
+#include "app.h"
+#include "app_lease.h"
+#include "system/wifi/sys_wifi.h"
+
+#define APP_LEASE_MAGIC                 0x4C454153      // "LEAS"
+#define APP_LEASE_VERSION               1
+#define APP_LEASE_INTERFACE_NAME        "PIC32MZW1"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Last lease read from or written to the lease file */
+static APP_LEASE_RECORD appLease;
+static bool appLeaseValid = false;
+
+/* Saved lease to request once the link is up, copied for the stack handler */
+static volatile bool appLeaseRequestPending = false;
+static IPV4_ADDR appLeaseRequestAddress;
+static IPV4_ADDR appLeaseRequestGateway;
+static TCPIP_MAC_ADDR appLeaseRequestGatewayMac;
+static bool appLeaseRequestGatewayMacValid;
+
+/* An INIT-REBOOT with the saved lease is in progress */
+static volatile bool appLeaseRestoring = false;
+
+/* Events recorded by the stack handlers, consumed by APP_LEASE_Tasks */
+static volatile bool appLeaseBound = false;
+static volatile bool appLeaseRejected = false;
+static volatile bool appLeaseArpSolved = false;
+
+/* Gateway resolved by the ARP handler; written by the stack task, read by the
+   application task, both inside a scheduler lock */
+static IPV4_ADDR appLeaseArpAddress;
+static TCPIP_MAC_ADDR appLeaseArpMac;
+
+static TCPIP_NET_HANDLE appLeaseNetHandle = 0;
+static TCPIP_DHCP_HANDLE appLeaseDhcpHandle = 0;
+static TCPIP_ARP_HANDLE appLeaseArpHandle = 0;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint32_t APP_LEASE_Checksum(const APP_LEASE_RECORD *lease)
+{
+    /* FNV-1a over everything but the checksum itself */
+    const uint8_t *data = (const uint8_t *)lease;
+    uint32_t checksum = 0x811C9DC5;
+    size_t index;
+
+    for(index = 0; index < offsetof(APP_LEASE_RECORD, checksum); index++)
+    {
+        checksum = (checksum ^ data[index]) * 0x01000193;
+    }
+
+    return checksum;
+}
+
+static bool APP_LEASE_Read(APP_LEASE_RECORD *lease)
+{
+    SYS_FS_HANDLE fileHandle;
+    bool isValid = false;
+
+    fileHandle = SYS_FS_FileOpen(FFS_LEASE_FILE, SYS_FS_FILE_OPEN_READ);
+    if(fileHandle == SYS_FS_HANDLE_INVALID)
+    {
+        return false;
+    }
+
+    if(SYS_FS_FileRead(fileHandle, (void *)lease, sizeof(*lease)) == sizeof(*lease))
+    {
+        isValid = lease->magic == APP_LEASE_MAGIC
+                && lease->version == APP_LEASE_VERSION
+                && lease->size == sizeof(*lease)
+                && lease->checksum == APP_LEASE_Checksum(lease);
+    }
+
+    SYS_FS_FileClose(fileHandle);
+
+    return isValid;
+}
+
+static bool APP_LEASE_Write(APP_LEASE_RECORD *lease)
+{
+    SYS_FS_HANDLE fileHandle;
+    bool isWritten = false;
+
+    lease->magic = APP_LEASE_MAGIC;
+    lease->version = APP_LEASE_VERSION;
+    lease->size = sizeof(*lease);
+    lease->checksum = APP_LEASE_Checksum(lease);
+
+    fileHandle = SYS_FS_FileOpen(FFS_LEASE_FILE, SYS_FS_FILE_OPEN_WRITE);
+    if(fileHandle == SYS_FS_HANDLE_INVALID)
+    {
+        SYS_CONSOLE_MESSAGE("Failed to open the DHCP lease file\n\r");
+        return false;
+    }
+
+    if(SYS_FS_FileWrite(fileHandle, (void *)lease, sizeof(*lease)) == sizeof(*lease))
+    {
+        SYS_FS_FileSync(fileHandle);
+        isWritten = true;
+    }
+    else
+    {
+        SYS_CONSOLE_MESSAGE("Failed to write the DHCP lease file\n\r");
+    }
+
+    SYS_FS_FileClose(fileHandle);
+
+    return isWritten;
+}
+
+/* Request the saved address (INIT-REBOOT) and pre-warm the gateway entry, so
+   the first packets after the ACK need no ARP resolution. Runs once the link
+   is up, normally from the stack task: a request made before would be reset
+   to a discovery by the link-up event. */
+static void APP_LEASE_Request(void)
+{
+    appLeaseRestoring = TCPIP_DHCP_Request(appLeaseNetHandle, appLeaseRequestAddress);
+    if(appLeaseRestoring && appLeaseRequestGatewayMacValid)
+    {
+        /* Not permanent: the entry still follows the normal ARP updates/timeouts */
+        TCPIP_ARP_EntrySet(appLeaseNetHandle, &appLeaseRequestGateway, &appLeaseRequestGatewayMac, false);
+    }
+}
+
+/* Take the pending request; only one of the stack and application tasks gets it. */
+static bool APP_LEASE_ClaimRequest(void)
+{
+    OSAL_CRITSECT_DATA_TYPE critStatus = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+    bool isPending = appLeaseRequestPending;
+    appLeaseRequestPending = false;
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critStatus);
+
+    return isPending;
+}
+
+static void APP_LEASE_DhcpEventHandler(TCPIP_NET_HANDLE hNet, TCPIP_DHCP_EVENT_TYPE evType, const void* param)
+{
+    (void)hNet;
+    (void)param;
+
+    if(evType == DHCP_EVENT_CONN_ESTABLISHED && APP_LEASE_ClaimRequest())
+    {
+        APP_LEASE_Request();
+    }
+    else if(evType == DHCP_EVENT_BOUND)
+    {
+        appLeaseBound = true;
+    }
+    else if(evType == DHCP_EVENT_NACK && appLeaseRestoring)
+    {
+        /* The server no longer honors the saved lease */
+        appLeaseRestoring = false;
+        appLeaseRejected = true;
+    }
+}
+
+static void APP_LEASE_ArpEventHandler(TCPIP_NET_HANDLE hNet, const IPV4_ADDR* ipAdd,
+        const TCPIP_MAC_ADDR* MACAddr, TCPIP_ARP_EVENT_TYPE evType, const void* param)
+{
+    (void)hNet;
+    (void)param;
+
+    if((evType == ARP_EVENT_SOLVED || evType == ARP_EVENT_UPDATED) && ipAdd->Val == TCPIP_STACK_NetAddressGateway(appLeaseNetHandle))
+    {
+        OSAL_CRITSECT_DATA_TYPE critStatus = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+        appLeaseArpAddress.Val = ipAdd->Val;
+        memcpy(&appLeaseArpMac, MACAddr, sizeof(appLeaseArpMac));
+        appLeaseArpSolved = true;
+        OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critStatus);
+    }
+}
+
+/* Build the record for the lease just bound and pre-warm the gateway entry. */
+static void APP_LEASE_Bound(void)
+{
+    APP_LEASE_RECORD lease;
+    TCPIP_DHCP_INFO dhcpInfo;
+    SYS_WIFI_CONFIG wifiConfig;
+
+    if(!TCPIP_DHCP_InfoGet(appLeaseNetHandle, &dhcpInfo) || dhcpInfo.status < TCPIP_DHCP_BOUND
+            || SYS_WIFI_CtrlMsg(sysObj.syswifi, SYS_WIFI_GETWIFICONFIG, &wifiConfig, sizeof(wifiConfig)) != SYS_WIFI_SUCCESS)
+    {
+        return;
+    }
+
+    memset(&lease, 0, sizeof(lease));
+    memcpy(lease.ssid, wifiConfig.staConfig.ssid, APP_LEASE_SSID_LENGTH);
+    lease.address.Val = dhcpInfo.dhcpAddress.Val;
+    lease.mask.Val = dhcpInfo.subnetMask.Val;
+    lease.gateway.Val = TCPIP_STACK_NetAddressGateway(appLeaseNetHandle);
+    lease.serverAddress.Val = dhcpInfo.serverAddress.Val;
+    lease.leaseDuration = dhcpInfo.leaseDuration;
+    if(dhcpInfo.leaseStartTime + dhcpInfo.leaseDuration > dhcpInfo.dhcpTime)
+    {
+        lease.leaseTimeLeft = dhcpInfo.leaseStartTime + dhcpInfo.leaseDuration - dhcpInfo.dhcpTime;
+    }
+
+    /* Same network, address and gateway: the saved gateway MAC is still good */
+    bool isSameLease = appLeaseValid
+            && !memcmp(lease.ssid, appLease.ssid, sizeof(lease.ssid))
+            && lease.address.Val == appLease.address.Val
+            && lease.gateway.Val == appLease.gateway.Val;
+
+    if(TCPIP_ARP_IsResolved(appLeaseNetHandle, &lease.gateway, &lease.gatewayMac))
+    {
+        lease.gatewayMacValid = true;
+    }
+    else if(isSameLease && appLease.gatewayMacValid)
+    {
+        memcpy(&lease.gatewayMac, &appLease.gatewayMac, sizeof(lease.gatewayMac));
+        lease.gatewayMacValid = true;
+    }
+    appLeaseRestoring = false;
+
+    /* Renewals only change the lease time; rewrite only on a new lease */
+    if(isSameLease && lease.gatewayMacValid == appLease.gatewayMacValid
+            && !memcmp(&lease.gatewayMac, &appLease.gatewayMac, sizeof(lease.gatewayMac))
+            && lease.leaseDuration == appLease.leaseDuration)
+    {
+        return;
+    }
+
+    if(APP_LEASE_Write(&lease))
+    {
+        appLease = lease;
+        appLeaseValid = true;
+    }
+}
+
+/* Record a (changed) gateway MAC address for the saved lease. */
+static void APP_LEASE_GatewaySolved(void)
+{
+    IPV4_ADDR arpAddress;
+    TCPIP_MAC_ADDR arpMac;
+
+    OSAL_CRITSECT_DATA_TYPE critStatus = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+    appLeaseArpSolved = false;
+    arpAddress.Val = appLeaseArpAddress.Val;
+    memcpy(&arpMac, &appLeaseArpMac, sizeof(arpMac));
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critStatus);
+
+    if(!appLeaseValid || arpAddress.Val != appLease.gateway.Val
+            || (appLease.gatewayMacValid && !memcmp(&arpMac, &appLease.gatewayMac, sizeof(arpMac))))
+    {
+        return;
+    }
+
+    APP_LEASE_RECORD lease = appLease;
+    memcpy(&lease.gatewayMac, &arpMac, sizeof(lease.gatewayMac));
+    lease.gatewayMacValid = true;
+
+    if(APP_LEASE_Write(&lease))
+    {
+        appLease = lease;
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void APP_LEASE_Initialize ( void )
+{
+    appLeaseNetHandle = TCPIP_STACK_NetHandleGet(APP_LEASE_INTERFACE_NAME);
+
+    if(appLeaseDhcpHandle == 0)
+    {
+        appLeaseDhcpHandle = TCPIP_DHCP_HandlerRegister(appLeaseNetHandle, APP_LEASE_DhcpEventHandler, NULL);
+    }
+
+    if(appLeaseArpHandle == 0)
+    {
+        appLeaseArpHandle = TCPIP_ARP_HandlerRegister(appLeaseNetHandle, APP_LEASE_ArpEventHandler, NULL);
+    }
+}
+
+bool APP_LEASE_Restore ( const uint8_t *ssid )
+{
+    appLeaseValid = APP_LEASE_Read(&appLease);
+    if(!appLeaseValid)
+    {
+        return false;
+    }
+
+    if(memcmp(appLease.ssid, ssid, APP_LEASE_SSID_LENGTH) || appLease.leaseTimeLeft == 0)
+    {
+        return false;
+    }
+
+    appLeaseRequestAddress.Val = appLease.address.Val;
+    appLeaseRequestGateway.Val = appLease.gateway.Val;
+    memcpy(&appLeaseRequestGatewayMac, &appLease.gatewayMac, sizeof(appLeaseRequestGatewayMac));
+    appLeaseRequestGatewayMacValid = appLease.gatewayMacValid;
+
+    char address[20];
+    TCPIP_Helper_IPAddressToString(&appLease.address, address, sizeof(address));
+    SYS_CONSOLE_PRINT("Requesting the saved DHCP lease %s\n\r", address);
+
+    /* Hand the request to the stack task, or make it now if the link is already up */
+    appLeaseRequestPending = true;
+    if(TCPIP_STACK_NetIsLinked(appLeaseNetHandle) && APP_LEASE_ClaimRequest())
+    {
+        APP_LEASE_Request();
+    }
+
+    return true;
+}
+
+void APP_LEASE_Erase ( void )
+{
+    appLeaseValid = false;
+    appLeaseRequestPending = false;
+    appLeaseRestoring = false;
+    SYS_FS_FileDirectoryRemove(FFS_LEASE_FILE);
+}
+
+void APP_LEASE_Tasks ( void )
+{
+    if(appLeaseRejected)
+    {
+        appLeaseRejected = false;
+        SYS_CONSOLE_MESSAGE("Saved DHCP lease rejected, using discovery\n\r");
+        APP_LEASE_Erase();
+    }
+
+    if(appLeaseBound)
+    {
+        appLeaseBound = false;
+        APP_LEASE_Bound();
+    }
+
+    if(appLeaseArpSolved)
+    {
+        APP_LEASE_GatewaySolved();
+    }
+}
+
+/*******************************************************************************
+ End of File
+ */
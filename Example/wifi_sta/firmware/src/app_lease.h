@@ -0,0 +1,186 @@
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_lease.h
+
+  Summary:
+    DHCP lease and gateway ARP persistence for fast reconnect after reboot.
+
+  Description:
+    This header file provides the prototypes of the lease persistence module.
+    Once the station is bound, the DHCP lease (address, mask, gateway, server
+    ID and remaining lease time) and the MAC address of the gateway are saved
+    to the file system. On the next boot the saved address is requested
+    directly (DHCP INIT-REBOOT) instead of going through DISCOVER/OFFER, and
+    the gateway ARP entry is pre-warmed as soon as the lease is confirmed.
+*******************************************************************************/
+
+#ifndef _APP_LEASE_H
+#define _APP_LEASE_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "configuration.h"
+#include "definitions.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define APP_LEASE_SSID_LENGTH          32
+
+// *****************************************************************************
+/* Persisted DHCP lease
+
+  Summary:
+    DHCP lease record stored in the lease file.
+
+  Description:
+    This structure holds everything needed to skip the DHCP discovery and the
+    gateway ARP resolution on the next boot. The record is only used for the
+    network identified by ssid.
+
+  Remarks:
+    The lease time left is the time left when the record was saved; the
+    device has no real time clock across reboots, so the DHCP server remains
+    the authority on whether the lease is still valid (it NAKs a stale
+    INIT-REBOOT request and the client falls back to discovery).
+*/
+
+typedef struct __attribute__((packed, aligned(4)))
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    uint8_t ssid[APP_LEASE_SSID_LENGTH + 1];
+    uint8_t gatewayMacValid;
+    TCPIP_MAC_ADDR gatewayMac;
+    IPV4_ADDR address;
+    IPV4_ADDR mask;
+    IPV4_ADDR gateway;
+    IPV4_ADDR serverAddress;
+    uint32_t leaseDuration;
+    uint32_t leaseTimeLeft;
+    uint32_t checksum;
+} APP_LEASE_RECORD;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_LEASE_Initialize ( void )
+
+  Summary:
+    Registers the DHCP and ARP event handlers used to track the lease.
+
+  Precondition:
+    The TCP/IP stack must be ready.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+*/
+
+void APP_LEASE_Initialize ( void );
+
+/*******************************************************************************
+  Function:
+    bool APP_LEASE_Restore ( const uint8_t *ssid )
+
+  Summary:
+    Requests the saved lease for the network being joined.
+
+  Description:
+    Reads the lease file and, if it belongs to the network ssid and still had
+    lease time left, asks the DHCP client to request the saved address
+    (INIT-REBOOT) as soon as the link comes up. The saved gateway MAC address
+    is installed in the ARP cache along with the request, before the lease is
+    acknowledged.
+
+  Precondition:
+    The disk must be mounted and APP_LEASE_Initialize called.
+
+  Parameters:
+    ssid - SSID of the network the station is connecting to.
+
+  Returns:
+    - true  - if the saved address will be requested.
+    - false - if there is no usable lease; the normal DHCP discovery is used.
+*/
+
+bool APP_LEASE_Restore ( const uint8_t *ssid );
+
+/*******************************************************************************
+  Function:
+    void APP_LEASE_Erase ( void )
+
+  Summary:
+    Deletes the saved lease.
+
+  Remarks:
+    Must be called whenever the saved Wi-Fi configuration is deleted.
+*/
+
+void APP_LEASE_Erase ( void );
+
+/*******************************************************************************
+  Function:
+    void APP_LEASE_Tasks ( void )
+
+  Summary:
+    Saves lease changes.
+
+  Description:
+    The DHCP and ARP event handlers only record what changed; the file system
+    updates are done here, from the application task.
+
+  Precondition:
+    The disk must be mounted.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+*/
+
+void APP_LEASE_Tasks ( void );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _APP_LEASE_H */
+
+/*******************************************************************************
+ End of File
+ */
@@ -69,6 +69,9 @@
 #define configCHECK_FOR_STACK_OVERFLOW          2
 #define configUSE_MALLOC_FAILED_HOOK            1
 
+/* Tagged heap accounting in heap_3.c and the OSAL, see system/memtrack. */
+#define SYS_MEMTRACK_ENABLED
+
 /* Run time and task stats gathering related definitions. */
 #define configGENERATE_RUN_TIME_STATS           0
 #define configUSE_TRACE_FACILITY                0
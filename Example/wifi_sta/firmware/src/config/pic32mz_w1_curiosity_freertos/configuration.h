@@ -115,6 +115,8 @@ extern "C" {
 
 #define SYS_FS_LFS_MAX_SS                	SYS_FS_MEDIA_MAX_BLOCK_SIZE
 #define SYS_FS_ALIGNED_BUFFER_LEN      	2048
+/* Sequential read-ahead: one more SYS_FS_ALIGNED_BUFFER_LEN buffer per media */
+#define SYS_FS_LFS_READ_AHEAD          	1
 
 
 
@@ -139,6 +141,22 @@ extern "C" {
 
 #define SYS_NET_CLICMD_ENABLED
 
+/* Multiplexed NET service, off by default: SYS_NET_MUX_ENABLED runs all the
+   instances, and their callbacks, from one service task */
+/* #define SYS_NET_MUX_ENABLED */
+#define SYS_NET_MUX_RTOS_STACK_SIZE             2048
+#define SYS_NET_MUX_RTOS_TASK_PRIORITY          1
+#define SYS_NET_MUX_BUSY_TIMEOUT                10
+#define SYS_NET_MUX_IDLE_TIMEOUT                1000
+
+
+/* Memory tracking, enabled by SYS_MEMTRACK_ENABLED in FreeRTOSConfig.h */
+#define SYS_MEMTRACK_CLICMD_ENABLED
+#define SYS_MEMTRACK_EVENT_LOG_SIZE             256
+#define SYS_MEMTRACK_MAX_SITES                  16
+/* Linker heap size (heap-size in the project configuration) */
+#define SYS_MEMTRACK_HEAP_SIZE                  175000
+
 
 
 
@@ -240,12 +258,20 @@ extern "C" {
 #define MICROCHIP_TCPIP
 #include "osal/osal.h"
 #define XMALLOC_OVERRIDE
+#ifdef SYS_MEMTRACK_ENABLED
+#include "system/memtrack/sys_memtrack.h"
+#define XMALLOC(s, h, type)  SYS_MEMTRACK_Malloc((s), SYS_MEMTRACK_TAG_TLS)
+#define XFREE(p, h, type)    SYS_MEMTRACK_Free((p))
+#else
 #define XMALLOC(s, h, type)  OSAL_Malloc((s))
 #define XFREE(p, h, type)    OSAL_Free((p))
+#endif
 #define HAVE_FFDHE_2048
 #define NO_PWDBASED
 #define HAVE_TLS_EXTENSIONS
 #define HAVE_SNI
+#define HAVE_SESSION_TICKET
+#define SMALL_SESSION_CACHE
 #define NO_OLD_TLS
 #define USE_FAST_MATH
 
@@ -416,6 +442,7 @@ extern "C" {
 
 
 #define SYS_WIFIPROV_NVMADDR        		0x900FF000
+#define SYS_WIFIPROV_NVM_PAGES        		2
 #define SYS_WIFIPROV_SAVECONFIG        			false
 
 
@@ -478,11 +505,19 @@ extern "C" {
 /*** TCPIP Heap Configuration ***/
 #define TCPIP_STACK_USE_EXTERNAL_HEAP
 
+#ifdef SYS_MEMTRACK_ENABLED
+#define TCPIP_STACK_MALLOC_FUNC                     SYS_MEMTRACK_TCPIP_Malloc
+
+#define TCPIP_STACK_CALLOC_FUNC                     SYS_MEMTRACK_TCPIP_Calloc
+
+#define TCPIP_STACK_FREE_FUNC                       SYS_MEMTRACK_TCPIP_Free
+#else
 #define TCPIP_STACK_MALLOC_FUNC                     malloc
 
 #define TCPIP_STACK_CALLOC_FUNC                     calloc
 
 #define TCPIP_STACK_FREE_FUNC                       free
+#endif
 
 
 
@@ -633,6 +668,13 @@ extern "C" {
 #define SYS_WIFI_SCAN_NUM_PROBES            1
 #define SYS_WIFI_SCAN_MATCH_MODE        	WDRV_PIC32MZW_SCAN_MATCH_MODE_FIND_ALL
 
+/* Scan cache shared by the Wi-Fi service console, FFS and the application */
+#define SYS_SCANCACHE_ENABLED
+#define SYS_SCANCACHE_MEMORY_SIZE           1632
+#define SYS_SCANCACHE_MAX_CLIENTS           4
+#define SYS_SCANCACHE_ENTRY_MAX_AGE         60000
+#define SYS_SCANCACHE_SCAN_TIMEOUT          10000
+
 
 
 
@@ -70,6 +70,7 @@
 #include "system/fs/sys_fs_littlefs_interface.h"
 #include "driver/ba414e/drv_ba414e.h"
 #include "system/net/sys_net.h"
+#include "system/memtrack/sys_memtrack.h"
 #include "peripheral/nvm/plib_nvm.h"
 #include "peripheral/uart/plib_uart3.h"
 #include "peripheral/uart/plib_uart1.h"
@@ -87,6 +88,7 @@
 #include "wolfssl/wolfcrypt/port/pic32/crypt_wolfcryptcb.h"
 #include "driver/wifi/pic32mzw1/include/wdrv_pic32mzw_api.h"
 #include "system/wifi/sys_wifi.h"
+#include "system/scancache/sys_scancache.h"
 #include "system/console/sys_console.h"
 #include "system/console/src/sys_console_uart_definitions.h"
 #include "FreeRTOS.h"
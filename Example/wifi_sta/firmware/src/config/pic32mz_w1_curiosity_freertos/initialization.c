@@ -831,9 +831,13 @@ void SYS_Initialize ( void* data )
 
     SYS_CMD_Initialize((SYS_MODULE_INIT*)&sysCmdInit);
 
+    SYS_MEMTRACK_Initialize();
+
     sysObj.sysDebug = SYS_DEBUG_Initialize(SYS_DEBUG_INDEX_0, (SYS_MODULE_INIT*)&debugInit);
 
 
+    SYS_SCANCACHE_Initialize();
+
     /* WiFi Service Initialization */
     sysObj.syswifi = SYS_WIFI_Initialize(NULL,NULL,NULL);
     SYS_ASSERT(sysObj.syswifi  != SYS_MODULE_OBJ_INVALID, "SYS_WIFI_Initialize Failed" );
@@ -0,0 +1,12 @@
+/*******************************************************************************
+  Host stand-in for the XC32 <sys/kmem.h>
+
+  The heap managers include it for the KSEG address translation, which is
+  done in tcpip_heap_alloc.c and is not needed on a development host.
+  This file is not part of the target build.
+*******************************************************************************/
+
+#ifndef _HOST_SYS_KMEM_H
+#define _HOST_SYS_KMEM_H
+
+#endif  // _HOST_SYS_KMEM_H
@@ -0,0 +1,99 @@
+/*******************************************************************************
+  TCP/IP Stack Private Definitions - Host Build
+
+  Summary:
+    Stand-in for tcpip_private.h when the heap managers are built on a
+    development host.
+
+  Description:
+    The heap managers (tcpip_heap_internal.c, tcpip_heap_pool.c) only need the
+    heap definitions and the OSAL semaphores from the stack private header.
+    With this directory ahead of the library directory on the include path,
+    they build on a host without the rest of the stack, the device headers or
+    an RTOS. The semaphores do nothing: the host programs are single threaded.
+    This file is not part of the target build.
+*******************************************************************************/
+
+/*****************************************************************************
+ Copyright (C) 2012-2018 Microchip Technology Inc. and its subsidiaries.
+
+Microchip Technology Inc. and its subsidiaries.
+
+Subject to your compliance with these terms, you may use Microchip software
+and any derivatives exclusively with Microchip products. It is your
+responsibility to comply with third party license terms applicable to your
+use of third party software (including open source software) that may
+accompany Microchip software.
+
+THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A PARTICULAR
+PURPOSE.
+
+IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*****************************************************************************/
+
+#ifndef __TCPIP_STACK_PRIVATE_H__
+#define __TCPIP_STACK_PRIVATE_H__
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "tcpip/tcpip_heap.h"
+#include "tcpip/src/tcpip_heap_alloc.h"
+
+// OSAL semaphores used by the heap managers
+typedef int OSAL_SEM_HANDLE_TYPE;
+
+typedef enum
+{
+    OSAL_SEM_TYPE_BINARY,
+    OSAL_SEM_TYPE_COUNTING
+}OSAL_SEM_TYPE;
+
+typedef enum
+{
+    OSAL_RESULT_NOT_IMPLEMENTED = -1,
+    OSAL_RESULT_FALSE = 0,
+    OSAL_RESULT_TRUE = 1
+}OSAL_RESULT;
+
+#define OSAL_WAIT_FOREVER   (uint16_t)0xFFFF
+
+static __inline__ OSAL_RESULT OSAL_SEM_Create(OSAL_SEM_HANDLE_TYPE* semID, OSAL_SEM_TYPE type, uint8_t maxCount, uint8_t initialCount)
+{
+    (void)type;
+    (void)maxCount;
+    *semID = initialCount;
+    return OSAL_RESULT_TRUE;
+}
+
+static __inline__ OSAL_RESULT OSAL_SEM_Delete(OSAL_SEM_HANDLE_TYPE* semID)
+{
+    (void)semID;
+    return OSAL_RESULT_TRUE;
+}
+
+static __inline__ OSAL_RESULT OSAL_SEM_Pend(OSAL_SEM_HANDLE_TYPE* semID, uint16_t waitMS)
+{
+    (void)semID;
+    (void)waitMS;
+    return OSAL_RESULT_TRUE;
+}
+
+static __inline__ OSAL_RESULT OSAL_SEM_Post(OSAL_SEM_HANDLE_TYPE* semID)
+{
+    (void)semID;
+    return OSAL_RESULT_TRUE;
+}
+
+#endif  // __TCPIP_STACK_PRIVATE_H__
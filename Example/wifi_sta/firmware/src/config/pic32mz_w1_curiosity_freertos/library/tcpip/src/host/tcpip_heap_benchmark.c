@@ -0,0 +1,454 @@
+/*******************************************************************************
+  TCPIP Heap Allocation Trace Benchmark
+
+  Summary:
+    Host benchmark comparing the first fit internal heap with the pool heap.
+
+  Description:
+    This program generates an allocation trace modeled on the TCP/IP stack
+    heap users of this configuration (TCP and UDP sockets with their buffers,
+    TCP segments and small packets, DNS and DHCP exchanges) and replays the
+    same trace on the internal heap (tcpip_heap_internal.c) and on the pool
+    heap (tcpip_heap_pool.c) built with the same amount of memory.
+    For each heap it reports the time per allocation/free, the failed
+    allocations, the high watermark, the smallest largest free block and the
+    fragmentation index seen during the replay, then the per entry occupancy
+    of the pool. It is a host tool only and is not part of the target build.
+*******************************************************************************/
+
+/*****************************************************************************
+ Copyright (C) 2012-2018 Microchip Technology Inc. and its subsidiaries.
+
+Microchip Technology Inc. and its subsidiaries.
+
+Subject to your compliance with these terms, you may use Microchip software
+and any derivatives exclusively with Microchip products. It is your
+responsibility to comply with third party license terms applicable to your
+use of third party software (including open source software) that may
+accompany Microchip software.
+
+THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A PARTICULAR
+PURPOSE.
+
+IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*****************************************************************************/
+
+#include "tcpip/src/tcpip_private.h"
+
+#include <getopt.h>
+#include <stdio.h>
+#include <time.h>
+
+// trace generation
+
+#define BENCH_GROUP_ITEMS       3       // max allocations done together
+#define BENCH_SAMPLE_STEPS      64      // steps between heap samples
+
+// a heap user: allocations done together and released together
+typedef struct
+{
+    const char* name;
+    uint16_t    minSize[BENCH_GROUP_ITEMS];
+    uint16_t    maxSize[BENCH_GROUP_ITEMS];
+    uint16_t    minLife;        // steps
+    uint16_t    maxLife;        // steps
+    uint16_t    weight;         // how often the user allocates
+    uint16_t    maxLive;        // max groups alive at any time
+}BENCH_HEAP_USER;
+
+// sizes follow configuration.h (TCPIP_TCP_SOCKET_DEFAULT_TX/RX_SIZE,
+// TCPIP_UDP_SOCKET_DEFAULT_TX_SIZE, TCPIP_TCP_MAX_SOCKETS, etc.)
+static const BENCH_HEAP_USER benchHeapUsers[] =
+{
+    // socket descriptor, TX and RX buffers
+    { "tcp socket",     { 200, 1024, 2048 },    { 240, 1024, 2048 },    500,    5000,   1,  5 },
+    // socket descriptor and TX buffer
+    { "udp socket",     { 100, 512 },           { 140, 512 },           200,    3000,   1,  5 },
+    // full size segment waiting for an ACK
+    { "tcp segment",    { 1560 },               { 1600 },               1,      20,     12, 8 },
+    // ACKs, ARP and ICMP packets
+    { "small packet",   { 60 },                 { 180 },                1,      10,     14, 16 },
+    // cache entry and query/response packet
+    { "dns",            { 40, 300 },            { 96, 512 },            5,      60,     3,  4 },
+    { "dhcp",           { 548 },                { 620 },                2,      20,     1,  2 },
+};
+
+#define BENCH_USERS     (sizeof(benchHeapUsers) / sizeof(*benchHeapUsers))
+
+// pool entries sized for the users above
+static TCPIP_STACK_HEAP_POOL_ENTRY benchPoolEntries[] =
+{
+    { .entrySize = 128,     .nBlocks = 24,  .nExpBlks = 4 },
+    { .entrySize = 256,     .nBlocks = 12,  .nExpBlks = 2 },
+    { .entrySize = 512,     .nBlocks = 10,  .nExpBlks = 1 },
+    { .entrySize = 640,     .nBlocks = 4,   .nExpBlks = 1 },
+    { .entrySize = 1024,    .nBlocks = 6,   .nExpBlks = 1 },
+    { .entrySize = 1664,    .nBlocks = 10,  .nExpBlks = 1 },
+    { .entrySize = 2048,    .nBlocks = 6,   .nExpBlks = 1 },
+};
+
+#define BENCH_POOL_EXPANSION_SIZE   4096
+
+// one trace operation: allocate size bytes in slot or, if size == 0, free the slot
+typedef struct
+{
+    uint16_t    slot;
+    uint16_t    size;
+}BENCH_TRACE_OP;
+
+typedef struct
+{
+    BENCH_TRACE_OP* ops;
+    size_t          nOps;
+    size_t          nAllocs;
+    uint16_t        nSlots;
+}BENCH_TRACE;
+
+typedef struct
+{
+    unsigned    steps;
+    uint32_t    seed;
+    size_t      heapSize;       // internal heap size; 0: same as the pool
+}BENCH_OPTIONS;
+
+typedef struct
+{
+    uint64_t    elapsedNs;
+    size_t      failures;
+    size_t      highWatermark;
+    size_t      minMaxSize;     // smallest largest free block
+    unsigned    maxFragIndex;
+    unsigned    avgFragIndex;
+}BENCH_RESULT;
+
+static uint32_t benchRandom(uint32_t* pState)
+{
+    // xorshift32
+    uint32_t x = *pState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *pState = x;
+}
+
+static unsigned benchRange(uint32_t* pState, unsigned min, unsigned max)
+{
+    return min + benchRandom(pState) % (max - min + 1);
+}
+
+static bool benchTraceGenerate(BENCH_TRACE* pTrace, const BENCH_OPTIONS* pOpt)
+{
+    typedef struct
+    {
+        unsigned    expiry;     // step the group is released; 0: unused
+        uint16_t    slots[BENCH_GROUP_ITEMS];
+        uint8_t     nItems;
+        uint8_t     user;
+    }BENCH_GROUP;
+
+    BENCH_GROUP groups[64];
+    uint16_t    freeSlots[64 * BENCH_GROUP_ITEMS];
+    unsigned    live[BENCH_USERS] = { 0 };
+    unsigned    totWeight, step, ix, jx, pick;
+    uint16_t    nFreeSlots;
+    size_t      maxOps;
+    uint32_t    rnd = pOpt->seed ? pOpt->seed : 1;
+
+    memset(groups, 0, sizeof(groups));
+    for(nFreeSlots = 0; nFreeSlots < sizeof(freeSlots) / sizeof(*freeSlots); nFreeSlots++)
+    {
+        freeSlots[nFreeSlots] = sizeof(freeSlots) / sizeof(*freeSlots) - 1 - nFreeSlots;
+    }
+
+    totWeight = 0;
+    for(ix = 0; ix < BENCH_USERS; ix++)
+    {
+        totWeight += benchHeapUsers[ix].weight;
+    }
+
+    // every step allocates at most a group and every allocation is freed once
+    maxOps = (size_t)(pOpt->steps + 1) * BENCH_GROUP_ITEMS * 2;
+    pTrace->ops = malloc(maxOps * sizeof(*pTrace->ops));
+    if(pTrace->ops == 0)
+    {
+        return false;
+    }
+    pTrace->nOps = 0;
+    pTrace->nAllocs = 0;
+    pTrace->nSlots = sizeof(freeSlots) / sizeof(*freeSlots);
+
+    for(step = 1; step <= pOpt->steps + 1; step++)
+    {
+        // release the expired groups; everything is released after the last step
+        for(ix = 0; ix < sizeof(groups) / sizeof(*groups); ix++)
+        {
+            BENCH_GROUP* pGroup = groups + ix;
+            if(pGroup->expiry != 0 && (pGroup->expiry <= step || step > pOpt->steps))
+            {
+                for(jx = 0; jx < pGroup->nItems; jx++)
+                {
+                    pTrace->ops[pTrace->nOps++] = (BENCH_TRACE_OP){ .slot = pGroup->slots[jx], .size = 0 };
+                    freeSlots[nFreeSlots++] = pGroup->slots[jx];
+                }
+                live[pGroup->user]--;
+                pGroup->expiry = 0;
+            }
+        }
+
+        if(step > pOpt->steps)
+        {
+            break;
+        }
+
+        pick = benchRandom(&rnd) % totWeight;
+        for(ix = 0; pick >= benchHeapUsers[ix].weight; ix++)
+        {
+            pick -= benchHeapUsers[ix].weight;
+        }
+
+        const BENCH_HEAP_USER* pUser = benchHeapUsers + ix;
+        if(live[ix] == pUser->maxLive)
+        {
+            continue;
+        }
+
+        for(jx = 0; jx < sizeof(groups) / sizeof(*groups) && groups[jx].expiry != 0; jx++);
+        if(jx == sizeof(groups) / sizeof(*groups))
+        {
+            continue;
+        }
+
+        BENCH_GROUP* pGroup = groups + jx;
+        pGroup->expiry = step + benchRange(&rnd, pUser->minLife, pUser->maxLife);
+        pGroup->user = ix;
+        pGroup->nItems = 0;
+        live[ix]++;
+        for(jx = 0; jx < BENCH_GROUP_ITEMS && pUser->maxSize[jx] != 0; jx++)
+        {
+            uint16_t slot = freeSlots[--nFreeSlots];
+            pGroup->slots[pGroup->nItems++] = slot;
+            pTrace->ops[pTrace->nOps++] = (BENCH_TRACE_OP){ .slot = slot, .size = benchRange(&rnd, pUser->minSize[jx], pUser->maxSize[jx]) };
+            pTrace->nAllocs++;
+        }
+    }
+
+    return true;
+}
+
+static uint64_t benchNowNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+}
+
+// replays the trace on a heap
+// when pResult is 0 only the time is measured; otherwise the heap is sampled
+static void benchReplay(TCPIP_STACK_HEAP_HANDLE heapH, const BENCH_TRACE* pTrace, void** slots, BENCH_RESULT* pResult)
+{
+    size_t ix;
+    uint64_t fragSum = 0;
+    size_t nSamples = 0;
+    const BENCH_TRACE_OP* pOp = pTrace->ops;
+
+    memset(slots, 0, pTrace->nSlots * sizeof(*slots));
+    if(pResult)
+    {
+        pResult->failures = 0;
+        pResult->minMaxSize = TCPIP_HEAP_MaxSize(heapH);
+        pResult->maxFragIndex = 0;
+    }
+
+    for(ix = 0; ix < pTrace->nOps; ix++, pOp++)
+    {
+        if(pOp->size != 0)
+        {
+            slots[pOp->slot] = TCPIP_HEAP_Malloc(heapH, pOp->size);
+            if(slots[pOp->slot] == 0 && pResult)
+            {
+                pResult->failures++;
+            }
+        }
+        else if(slots[pOp->slot] != 0)
+        {
+            TCPIP_HEAP_Free(heapH, slots[pOp->slot]);
+            slots[pOp->slot] = 0;
+        }
+
+        if(pResult && (ix % BENCH_SAMPLE_STEPS) == 0)
+        {
+            size_t maxSize = TCPIP_HEAP_MaxSize(heapH);
+            unsigned fragIndex = TCPIP_HEAP_FragmentationIndex(heapH);
+            if(maxSize < pResult->minMaxSize)
+            {
+                pResult->minMaxSize = maxSize;
+            }
+            if(fragIndex > pResult->maxFragIndex)
+            {
+                pResult->maxFragIndex = fragIndex;
+            }
+            fragSum += fragIndex;
+            nSamples++;
+        }
+    }
+
+    if(pResult)
+    {
+        pResult->highWatermark = TCPIP_HEAP_HighWatermark(heapH);
+        pResult->avgFragIndex = nSamples ? (unsigned)(fragSum / nSamples) : 0;
+    }
+}
+
+static bool benchRun(const char* name, TCPIP_STACK_HEAP_HANDLE heapH, const BENCH_TRACE* pTrace, void** slots)
+{
+    BENCH_RESULT result;
+
+    benchReplay(heapH, pTrace, slots, &result);
+
+    // timed run, without sampling
+    uint64_t start = benchNowNs();
+    benchReplay(heapH, pTrace, slots, 0);
+    result.elapsedNs = benchNowNs() - start;
+
+    printf("%-10s %8zu %8.1f ns/op  failed %6zu  watermark %7zu  min largest free %7zu  frag index avg %4u max %4u\n",
+            name, TCPIP_HEAP_Size(heapH), (double)result.elapsedNs / pTrace->nOps, result.failures,
+            result.highWatermark, result.minMaxSize, result.avgFragIndex, result.maxFragIndex);
+
+    // the trace frees everything it allocates
+    return TCPIP_HEAP_FreeSize(heapH) == TCPIP_HEAP_Size(heapH);
+}
+
+static void benchPoolList(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_POOL_ENTRY_LIST entryList;
+    int ix;
+
+    printf("%-10s %8s %8s %8s %10s\n", "pool entry", "blocks", "max used", "free", "expansion");
+    for(ix = 0; ix < TCPIP_HEAP_POOL_Entries(heapH); ix++)
+    {
+        if(TCPIP_HEAP_POOL_EntryList(heapH, ix, &entryList))
+        {
+            printf("%10d %8d %8d %8d %10d\n", entryList.blockSize, entryList.nBlocks,
+                    entryList.maxUsedBlocks, entryList.freeBlocks, entryList.expansionSize);
+        }
+    }
+}
+
+static void benchUsage(const char* program)
+{
+    fprintf(stderr, "Usage: %s [--steps N] [--seed N] [--heap-size BYTES]\n", program);
+}
+
+int main(int argc, char** argv)
+{
+    BENCH_OPTIONS options =
+    {
+        .steps = 200000,
+        .seed = 0x2545F491,
+        .heapSize = 0,
+    };
+    static const struct option longOptions[] =
+    {
+        { "steps", required_argument, NULL, 'n' },
+        { "seed", required_argument, NULL, 's' },
+        { "heap-size", required_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    const TCPIP_STACK_HEAP_POOL_CONFIG poolConfig =
+    {
+        .heapType = TCPIP_STACK_HEAP_TYPE_INTERNAL_HEAP_POOL,
+        .heapFlags = TCPIP_STACK_HEAP_FLAG_ALLOC_UNCACHED,
+        .heapUsage = TCPIP_STACK_HEAP_USE_DEFAULT,
+        .malloc_fnc = malloc,
+        .calloc_fnc = calloc,
+        .free_fnc = free,
+        .nPoolEntries = sizeof(benchPoolEntries) / sizeof(*benchPoolEntries),
+        .pEntries = benchPoolEntries,
+        .expansionHeapSize = BENCH_POOL_EXPANSION_SIZE,
+    };
+    TCPIP_STACK_HEAP_INTERNAL_CONFIG internalConfig =
+    {
+        .heapType = TCPIP_STACK_HEAP_TYPE_INTERNAL_HEAP,
+        .heapFlags = TCPIP_STACK_HEAP_FLAG_ALLOC_UNCACHED,
+        .heapUsage = TCPIP_STACK_HEAP_USE_DEFAULT,
+        .malloc_fnc = malloc,
+        .calloc_fnc = calloc,
+        .free_fnc = free,
+    };
+    TCPIP_STACK_HEAP_HANDLE poolH, internalH;
+    TCPIP_STACK_HEAP_RES res;
+    BENCH_TRACE trace;
+    void** slots;
+    int option;
+    bool ok;
+
+    while((option = getopt_long(argc, argv, "n:s:h:", longOptions, NULL)) != -1)
+    {
+        switch(option)
+        {
+            case 'n':
+                options.steps = (unsigned)strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                options.seed = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'h':
+                options.heapSize = (size_t)strtoul(optarg, NULL, 0);
+                break;
+            default:
+                benchUsage(argv[0]);
+                return 2;
+        }
+    }
+
+    if(options.steps == 0)
+    {
+        benchUsage(argv[0]);
+        return 2;
+    }
+
+    poolH = TCPIP_HEAP_CreateInternalPool(&poolConfig, &res);
+    if(poolH == 0)
+    {
+        fprintf(stderr, "pool heap creation failed: %d\n", res);
+        return 1;
+    }
+
+    // same memory as the pool, plus the internal heap descriptor
+    internalConfig.heapSize = options.heapSize ? options.heapSize : TCPIP_HEAP_Size(poolH) + 256;
+    internalH = TCPIP_HEAP_CreateInternal(&internalConfig, &res);
+    if(internalH == 0)
+    {
+        fprintf(stderr, "internal heap creation failed: %d\n", res);
+        TCPIP_HEAP_Delete(poolH);
+        return 1;
+    }
+
+    if(!benchTraceGenerate(&trace, &options) || (slots = malloc(trace.nSlots * sizeof(*slots))) == 0)
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    printf("trace: %u steps, %zu allocations, %zu operations\n", options.steps, trace.nAllocs, trace.nOps);
+    printf("%-10s %8s\n", "heap", "size");
+    ok = benchRun("internal", internalH, &trace, slots);
+    ok = benchRun("pool", poolH, &trace, slots) && ok;
+    benchPoolList(poolH);
+
+    // every block is back: both heaps can be deleted
+    ok = TCPIP_HEAP_Delete(internalH) == TCPIP_STACK_HEAP_RES_OK && ok;
+    ok = TCPIP_HEAP_Delete(poolH) == TCPIP_STACK_HEAP_RES_OK && ok;
+
+    free(slots);
+    free(trace.ops);
+    return ok ? 0 : 1;
+}
@@ -3017,6 +3017,7 @@ static int _Command_HeapInfo(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
         (*pCmdIO->pCmdApi->print)(cmdIoParam, "Heap type: %s. Initial created heap size: %d Bytes\r\n", typeMsg, heapSize);
         (*pCmdIO->pCmdApi->print)(cmdIoParam, "Allocable block heap size: %d Bytes\r\n", TCPIP_HEAP_MaxSize(heapH));
         (*pCmdIO->pCmdApi->print)(cmdIoParam, "All available heap size: %d Bytes, high watermark: %d\r\n", TCPIP_HEAP_FreeSize(heapH), TCPIP_HEAP_HighWatermark(heapH));
+        (*pCmdIO->pCmdApi->print)(cmdIoParam, "Fragmentation index: %d/1000\r\n", TCPIP_HEAP_FragmentationIndex(heapH));
         (*pCmdIO->pCmdApi->print)(cmdIoParam, "Last heap error: 0x%x\r\n", TCPIP_HEAP_LastError(heapH));
 
 #if defined(TCPIP_STACK_DRAM_DEBUG_ENABLE)    
@@ -5402,13 +5403,14 @@ static int _Command_HeapList(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
         }
 
         (*pCmdIO->pCmdApi->print)(cmdIoParam, "Entry ix: %d, blockSize: %d, nBlocks: %d, freeBlocks: %d\r\n", ix, entryList.blockSize, entryList.nBlocks, entryList.freeBlocks);
-        (*pCmdIO->pCmdApi->print)(cmdIoParam, "Entry ix: %d, totEntrySize: %d, totFreeSize: %d\r\n", ix, entryList.totEntrySize, entryList.totFreeSize);
+        (*pCmdIO->pCmdApi->print)(cmdIoParam, "Entry ix: %d, totEntrySize: %d, totFreeSize: %d, maxUsedBlocks: %d\r\n", ix, entryList.totEntrySize, entryList.totFreeSize, entryList.maxUsedBlocks);
 
         totSize += entryList.totEntrySize;
         totFreeSize += entryList.totFreeSize;
         expansionSize = entryList.expansionSize;
     }
     (*pCmdIO->pCmdApi->print)(cmdIoParam, "Pool Heap total size: %d, total free: %d, expansion: %d\r\n", totSize, totFreeSize, expansionSize);
+    (*pCmdIO->pCmdApi->print)(cmdIoParam, "Pool Heap largest free block: %d, fragmentation index: %d/1000\r\n", TCPIP_HEAP_MaxSize(heapH), TCPIP_HEAP_FragmentationIndex(heapH));
 
     return false;
 }
@@ -558,6 +558,24 @@ static __inline__ TCPIP_STACK_HEAP_RES __attribute__((always_inline)) TCPIP_HEAP
 }
 #define TCPIP_HEAP_LastError(h) TCPIP_HEAP_LastErrorInline(h)
 
+// fragmentation index of the heap, in 1/1000 units:
+// 1000 * (1 - largest allocable block / all free space)
+// 0 means that all the free space can be returned as one block;
+// it gets close to 1000 when the free space is scattered in small blocks
+// (or, for a pool heap, spread over many entries).
+// Heaps that do not report their free space (external) return 0.
+static __inline__ unsigned int __attribute__((always_inline)) TCPIP_HEAP_FragmentationIndex(TCPIP_STACK_HEAP_HANDLE h)
+{
+    size_t freeSize = TCPIP_HEAP_FreeSize(h);
+    size_t maxSize = TCPIP_HEAP_MaxSize(h);
+
+    if(freeSize == 0 || maxSize >= freeSize)
+    {
+        return 0;
+    }
+    return 1000 - (unsigned int)((maxSize * 1000) / freeSize);
+}
+
 
 // pool heap specific functionality for managing entries, sizes, etc.
 // these functions should be called with a valid pool heap handle!
@@ -570,6 +588,8 @@ typedef struct
     int freeBlocks;
     int totEntrySize;
     int totFreeSize;
+    // the high watermark of the blocks in use
+    int maxUsedBlocks;
     // the expansion size at the moment of call
     // Note that this is a global pool number, not per entry  
     int expansionSize;
@@ -0,0 +1,698 @@
+/*******************************************************************************
+  TCPIP Heap Pool Allocation Manager
+
+  Summary:
+    Size class pool implementation of the TCP/IP stack heap.
+
+  Description:
+    The pool heap is made of entries (size classes). Each entry owns a slab of
+    fixed size blocks that are created when the heap is created and kept in a
+    per entry free list, so allocation and deallocation do not search or
+    coalesce and the heap does not fragment within an entry.
+    An allocation is served from the smallest entry whose blocks fit the
+    request; when that entry is exhausted, new blocks may be carved from the
+    expansion area or, unless TCPIP_STACK_HEAP_FLAG_POOL_STRICT is set, the
+    block is taken from a larger entry.
+*******************************************************************************/
+
+/*****************************************************************************
+ Copyright (C) 2012-2018 Microchip Technology Inc. and its subsidiaries.
+
+Microchip Technology Inc. and its subsidiaries.
+
+Subject to your compliance with these terms, you may use Microchip software
+and any derivatives exclusively with Microchip products. It is your
+responsibility to comply with third party license terms applicable to your
+use of third party software (including open source software) that may
+accompany Microchip software.
+
+THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A PARTICULAR
+PURPOSE.
+
+IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*****************************************************************************/
+
+
+
+
+
+
+
+
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "tcpip/src/tcpip_private.h"
+// definitions
+
+
+// min heap alignment
+// always power of 2
+#if defined(__PIC32MZ__) || defined(__PIC32WK__)
+typedef struct __attribute__((aligned(16)))
+{
+    uint64_t     pad[2];
+}_heap_Align;
+#elif defined(__PIC32C__) || defined(__SAMA5D2__) || defined(__SAM9X60__)
+typedef struct __attribute__((aligned(32)))
+{
+    uint32_t     pad[8];
+}_heap_Align;
+#else   // PIC32MX, PIC32MK
+typedef uint32_t _heap_Align;
+#endif  // defined(__PIC32MZ__) || defined(__PIC32WK__)
+
+
+struct _tag_TCPIP_HEAP_POOL_ENTRY_DCPT;
+
+// block header
+// a free block links to the next free block in its entry
+// an allocated block points to the entry that owns it
+typedef union __attribute__((aligned(16))) _tag_poolNode
+{
+    _heap_Align x;
+    union _tag_poolNode*                        next;
+    struct _tag_TCPIP_HEAP_POOL_ENTRY_DCPT*     pEntry;
+}_poolNode;
+
+
+typedef struct _tag_TCPIP_HEAP_POOL_ENTRY_DCPT
+{
+    _poolNode*      freeList;           // free blocks of this entry
+    size_t          blockUnits;         // size of a block, including its header, units
+    uint16_t        entrySize;          // requested block size, as configured
+    uint16_t        nBlocks;            // blocks owned by this entry, including the expansion ones
+    uint16_t        freeBlocks;         // blocks in the free list
+    uint16_t        maxUsedBlocks;      // high watermark of the blocks in use
+    uint8_t         nExpBlks;           // blocks to carve from the expansion area when the entry runs out
+}TCPIP_HEAP_POOL_ENTRY_DCPT;
+
+
+typedef struct
+{
+    TCPIP_HEAP_POOL_ENTRY_DCPT* _poolEntries;   // pool entries, in ascending block size order
+    uint16_t        _nPoolEntries;              // number of entries
+    _poolNode*      _poolStart;                 // first block of the pool
+    _poolNode*      _poolEnd;                   // end of the pool, including the expansion area
+    _poolNode*      _expansionStart;            // not yet used part of the expansion area
+    size_t          _poolUnits;                 // size of the pool, units
+    size_t          _poolAllocatedUnits;        // how many units allocated out there
+    size_t          _poolWatermark;             // max allocated units
+    TCPIP_STACK_HEAP_RES  _lastHeapErr;         // last error encountered
+    TCPIP_STACK_HEAP_FLAGS _heapFlags;          // heap flags
+    void*           allocatedBuffer;            // buffer initially allocated for this heap
+    void            (*free_fnc)(void* ptr);     // free function needed to delete the heap
+
+    OSAL_SEM_HANDLE_TYPE _heapSemaphore;
+
+    // alignment padding
+    // TCPIP_HEAP_POOL_ENTRY_DCPT _entries[0];  // the entries descriptors
+    // _poolNode _pool[0];                      // the pool itself
+}TCPIP_HEAP_POOL_DCPT; // descriptor of a pool heap
+
+
+// local data
+//
+
+static TCPIP_STACK_HEAP_RES   _TCPIP_HEAP_Delete(TCPIP_STACK_HEAP_HANDLE heapH);
+static void*            _TCPIP_HEAP_Malloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nBytes);
+static void*            _TCPIP_HEAP_Calloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nElems, size_t elemSize);
+static size_t           _TCPIP_HEAP_Free(TCPIP_STACK_HEAP_HANDLE heapH, const void* pBuff);
+
+static size_t           _TCPIP_HEAP_Size(TCPIP_STACK_HEAP_HANDLE heapH);
+static size_t           _TCPIP_HEAP_MaxSize(TCPIP_STACK_HEAP_HANDLE heapH);
+static size_t           _TCPIP_HEAP_FreeSize(TCPIP_STACK_HEAP_HANDLE heapH);
+static size_t           _TCPIP_HEAP_HighWatermark(TCPIP_STACK_HEAP_HANDLE heapH);
+static TCPIP_STACK_HEAP_RES   _TCPIP_HEAP_LastError(TCPIP_STACK_HEAP_HANDLE heapH);
+#if defined(TCPIP_STACK_DRAM_DEBUG_ENABLE)
+static size_t           _TCPIP_HEAP_AllocSize(TCPIP_STACK_HEAP_HANDLE heapH, const void* ptr);
+#endif  // defined(TCPIP_STACK_DRAM_DEBUG_ENABLE)
+
+// maps a buffer to non cached memory
+const void* _TCPIP_HEAP_BufferMapNonCached(const void* buffer, size_t buffSize);
+
+
+
+
+// the heap object
+static const TCPIP_HEAP_OBJECT      _tcpip_heap_pool_object =
+{
+    .TCPIP_HEAP_Delete = _TCPIP_HEAP_Delete,
+    .TCPIP_HEAP_Malloc = _TCPIP_HEAP_Malloc,
+    .TCPIP_HEAP_Calloc = _TCPIP_HEAP_Calloc,
+    .TCPIP_HEAP_Free = _TCPIP_HEAP_Free,
+    .TCPIP_HEAP_Size = _TCPIP_HEAP_Size,
+    .TCPIP_HEAP_MaxSize = _TCPIP_HEAP_MaxSize,
+    .TCPIP_HEAP_FreeSize = _TCPIP_HEAP_FreeSize,
+    .TCPIP_HEAP_HighWatermark = _TCPIP_HEAP_HighWatermark,
+    .TCPIP_HEAP_LastError = _TCPIP_HEAP_LastError,
+#if defined(TCPIP_STACK_DRAM_DEBUG_ENABLE)
+    .TCPIP_HEAP_AllocSize = _TCPIP_HEAP_AllocSize,
+#endif  // defined(TCPIP_STACK_DRAM_DEBUG_ENABLE)
+};
+
+typedef struct
+{
+    TCPIP_HEAP_OBJECT       heapObj;    // heap object API
+    TCPIP_HEAP_POOL_DCPT    heapDcpt;   // private heap object data
+}TCPIP_HEAP_POOL_OBJ_INSTANCE;
+
+
+
+// local prototypes
+//
+
+// returns the TCPIP_HEAP_POOL_OBJ_INSTANCE associated with a heap handle
+// null if invalid
+static __inline__ TCPIP_HEAP_POOL_OBJ_INSTANCE* __attribute__((always_inline)) _TCPIP_HEAP_ObjInstance(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+#if defined(TCPIP_STACK_DRAM_DEBUG_ENABLE)
+    if(heapH)
+    {
+        TCPIP_HEAP_POOL_OBJ_INSTANCE* pInst = (TCPIP_HEAP_POOL_OBJ_INSTANCE*)heapH;
+        if(pInst->heapObj.TCPIP_HEAP_Delete == _TCPIP_HEAP_Delete)
+        {
+            return pInst;
+        }
+    }
+    return 0;
+#else
+    return (heapH == 0) ? 0 : (TCPIP_HEAP_POOL_OBJ_INSTANCE*)heapH;
+#endif  // defined(TCPIP_STACK_DRAM_DEBUG_ENABLE)
+
+}
+
+// returns the TCPIP_HEAP_POOL_DCPT associated with a heap handle
+// null if invalid
+static __inline__ TCPIP_HEAP_POOL_DCPT* __attribute__((always_inline)) _TCPIP_HEAP_ObjDcpt(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_POOL_OBJ_INSTANCE* hInst = _TCPIP_HEAP_ObjInstance(heapH);
+
+    return (hInst == 0) ? 0 : &hInst->heapDcpt;
+}
+
+// returns the TCPIP_HEAP_POOL_DCPT associated with a heap handle
+// the handle is always checked to be a pool heap
+// used by the pool specific API that could be called with any heap handle
+static TCPIP_HEAP_POOL_DCPT* _TCPIP_HEAP_PoolDcpt(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_POOL_OBJ_INSTANCE* pInst = (TCPIP_HEAP_POOL_OBJ_INSTANCE*)heapH;
+    if(pInst != 0 && pInst->heapObj.TCPIP_HEAP_Delete == _TCPIP_HEAP_Delete)
+    {
+        return &pInst->heapDcpt;
+    }
+
+    return 0;
+}
+
+// number of units needed for a block of nBytes, including its header
+static __inline__ size_t __attribute__((always_inline)) _TCPIP_HEAP_BlockUnits(size_t nBytes)
+{
+    return (nBytes + sizeof(_poolNode) - 1) / sizeof(_poolNode) + 1;
+}
+
+// carves up to nBlocks blocks for the entry from the expansion area
+// returns the number of blocks added to the entry free list
+// called with the heap locked
+static int _TCPIP_HEAP_EntryExpand(TCPIP_HEAP_POOL_DCPT* hDcpt, TCPIP_HEAP_POOL_ENTRY_DCPT* pEntry, int nBlocks)
+{
+    int ix;
+    _poolNode* pNode;
+
+    for(ix = 0; ix < nBlocks; ix++)
+    {
+        if((size_t)(hDcpt->_poolEnd - hDcpt->_expansionStart) < pEntry->blockUnits || pEntry->nBlocks == UINT16_MAX)
+        {
+            break;
+        }
+
+        pNode = hDcpt->_expansionStart;
+        hDcpt->_expansionStart += pEntry->blockUnits;
+        pNode->next = pEntry->freeList;
+        pEntry->freeList = pNode;
+        pEntry->nBlocks++;
+        pEntry->freeBlocks++;
+    }
+
+    return ix;
+}
+
+// API
+
+TCPIP_STACK_HEAP_HANDLE TCPIP_HEAP_CreateInternalPool(const TCPIP_STACK_HEAP_POOL_CONFIG* pHeapConfig, TCPIP_STACK_HEAP_RES* pRes)
+{
+    TCPIP_HEAP_POOL_DCPT* hDcpt;
+    TCPIP_HEAP_POOL_OBJ_INSTANCE* hInst;
+    TCPIP_HEAP_POOL_ENTRY_DCPT* pEntry;
+    const TCPIP_STACK_HEAP_POOL_ENTRY* pCfgEntry;
+    size_t          headerSize, poolUnits, expansionUnits;
+    uint8_t*        allocatedHeapBuffer;
+    uint8_t*        alignHeapBuffer;
+    size_t          heapBufferSize;
+    uintptr_t       alignBuffer;
+    _poolNode*      pNode;
+    int             ix, jx, nEntries;
+    TCPIP_STACK_HEAP_RES  res;
+
+
+    while(true)
+    {
+        hDcpt =0;
+        hInst = 0;
+
+        if( pHeapConfig == 0 || pHeapConfig->nPoolEntries == 0 || pHeapConfig->pEntries == 0)
+        {
+            res = TCPIP_STACK_HEAP_RES_INIT_ERR;
+            break;
+        }
+
+        // entries need distinct, non zero block sizes
+        nEntries = pHeapConfig->nPoolEntries;
+        poolUnits = 0;
+        pCfgEntry = pHeapConfig->pEntries;
+        for(ix = 0; ix < nEntries; ix++, pCfgEntry++)
+        {
+            if(pCfgEntry->entrySize == 0)
+            {
+                break;
+            }
+            for(jx = 0; jx < ix; jx++)
+            {
+                if(pHeapConfig->pEntries[jx].entrySize == pCfgEntry->entrySize)
+                {
+                    break;
+                }
+            }
+            if(jx != ix)
+            {
+                break;
+            }
+            poolUnits += pCfgEntry->nBlocks * _TCPIP_HEAP_BlockUnits(pCfgEntry->entrySize);
+        }
+
+        if(ix != nEntries)
+        {
+            res = TCPIP_STACK_HEAP_RES_INIT_ERR;
+            break;
+        }
+
+        expansionUnits = pHeapConfig->expansionHeapSize / sizeof(_poolNode);
+        poolUnits += expansionUnits;
+        if(poolUnits == 0)
+        {
+            res = TCPIP_STACK_HEAP_RES_BUFF_SIZE_ERR;
+            break;
+        }
+
+        headerSize = ((sizeof(TCPIP_HEAP_POOL_OBJ_INSTANCE) + nEntries * sizeof(TCPIP_HEAP_POOL_ENTRY_DCPT) + sizeof(_poolNode) - 1) / sizeof(_poolNode)) * sizeof(_poolNode);
+
+        heapBufferSize = headerSize + poolUnits * sizeof(_poolNode) + sizeof(_heap_Align) - 1;
+        allocatedHeapBuffer = (uint8_t*)(*pHeapConfig->malloc_fnc)(heapBufferSize);
+
+        if(allocatedHeapBuffer == 0)
+        {
+            res = TCPIP_STACK_HEAP_RES_CREATE_ERR;
+            break;
+        }
+
+
+        // align properly: round up
+        alignBuffer = ((uintptr_t)allocatedHeapBuffer + sizeof(_heap_Align)-1 ) & ~(sizeof(_heap_Align)-1);
+        heapBufferSize -= (uint8_t*)alignBuffer - allocatedHeapBuffer ;
+        alignHeapBuffer = (uint8_t*)alignBuffer;
+
+        // check if mapping needed; always alloc uncached!
+        // if((pHeapConfig->heapFlags & TCPIP_STACK_HEAP_FLAG_ALLOC_UNCACHED) != 0)
+        {
+            alignHeapBuffer = (uint8_t*)_TCPIP_HEAP_BufferMapNonCached(alignHeapBuffer, heapBufferSize);
+        }
+        hInst = (TCPIP_HEAP_POOL_OBJ_INSTANCE*)alignHeapBuffer;
+        hInst->heapObj = _tcpip_heap_pool_object;
+        hDcpt = &hInst->heapDcpt;
+        hDcpt->_poolEntries = (TCPIP_HEAP_POOL_ENTRY_DCPT*)(hInst + 1);
+        hDcpt->_nPoolEntries = nEntries;
+        hDcpt->_poolStart = (_poolNode*)(alignHeapBuffer + headerSize);
+        hDcpt->_poolEnd = hDcpt->_poolStart + poolUnits;
+        hDcpt->_expansionStart = hDcpt->_poolEnd - expansionUnits;
+        hDcpt->_poolUnits = poolUnits;
+        hDcpt->_poolAllocatedUnits = 0;
+        hDcpt->_poolWatermark = 0;
+        hDcpt->_lastHeapErr = TCPIP_STACK_HEAP_RES_OK;
+        hDcpt->_heapFlags = pHeapConfig->heapFlags;
+        hDcpt->allocatedBuffer = allocatedHeapBuffer;
+        hDcpt->free_fnc = pHeapConfig->free_fnc;
+
+        // insert the entries in ascending size order
+        pCfgEntry = pHeapConfig->pEntries;
+        for(ix = 0; ix < nEntries; ix++, pCfgEntry++)
+        {
+            for(jx = ix; jx > 0 && hDcpt->_poolEntries[jx - 1].entrySize > pCfgEntry->entrySize; jx--)
+            {
+                hDcpt->_poolEntries[jx] = hDcpt->_poolEntries[jx - 1];
+            }
+            pEntry = hDcpt->_poolEntries + jx;
+            memset(pEntry, 0, sizeof(*pEntry));
+            pEntry->entrySize = pCfgEntry->entrySize;
+            pEntry->blockUnits = _TCPIP_HEAP_BlockUnits(pCfgEntry->entrySize);
+            pEntry->nBlocks = pCfgEntry->nBlocks;
+            pEntry->nExpBlks = pCfgEntry->nExpBlks;
+        }
+
+        // carve the slabs; blocks are handed out in address order
+        pNode = hDcpt->_poolStart;
+        pEntry = hDcpt->_poolEntries;
+        for(ix = 0; ix < nEntries; ix++, pEntry++)
+        {
+            pNode += pEntry->nBlocks * pEntry->blockUnits;
+            for(jx = 0; jx < pEntry->nBlocks; jx++)
+            {
+                _poolNode* pBlock = pNode - (jx + 1) * pEntry->blockUnits;
+                pBlock->next = pEntry->freeList;
+                pEntry->freeList = pBlock;
+            }
+            pEntry->freeBlocks = pEntry->nBlocks;
+        }
+
+        if(OSAL_SEM_Create(&hDcpt->_heapSemaphore, OSAL_SEM_TYPE_BINARY, 1, 1) != OSAL_RESULT_TRUE)
+        {
+            (*pHeapConfig->free_fnc)(allocatedHeapBuffer);
+            hInst = 0;
+            res = TCPIP_STACK_HEAP_RES_SYNCH_ERR;
+            break;
+        }
+
+        res = TCPIP_STACK_HEAP_RES_OK;
+        break;
+    }
+
+    if(pRes)
+    {
+        *pRes = res;
+    }
+
+    return hInst;
+
+}
+
+int TCPIP_HEAP_POOL_Entries(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_POOL_DCPT* hDcpt = _TCPIP_HEAP_PoolDcpt(heapH);
+
+    return (hDcpt == 0) ? 0 : hDcpt->_nPoolEntries;
+}
+
+bool TCPIP_HEAP_POOL_EntryList(TCPIP_STACK_HEAP_HANDLE heapH, int entryIx, TCPIP_HEAP_POOL_ENTRY_LIST* pList)
+{
+    TCPIP_HEAP_POOL_DCPT* hDcpt;
+    TCPIP_HEAP_POOL_ENTRY_DCPT* pEntry;
+
+    hDcpt = _TCPIP_HEAP_PoolDcpt(heapH);
+    if(hDcpt == 0 || entryIx < 0 || entryIx >= hDcpt->_nPoolEntries)
+    {
+        return false;
+    }
+
+    if(pList)
+    {
+        pEntry = hDcpt->_poolEntries + entryIx;
+
+        OSAL_SEM_Pend(&hDcpt->_heapSemaphore, OSAL_WAIT_FOREVER);
+        pList->blockSize = pEntry->entrySize;
+        pList->nBlocks = pEntry->nBlocks;
+        pList->freeBlocks = pEntry->freeBlocks;
+        pList->maxUsedBlocks = pEntry->maxUsedBlocks;
+        pList->totEntrySize = pEntry->nBlocks * pEntry->blockUnits * sizeof(_poolNode);
+        pList->totFreeSize = pEntry->freeBlocks * pEntry->blockUnits * sizeof(_poolNode);
+        pList->expansionSize = (hDcpt->_poolEnd - hDcpt->_expansionStart) * sizeof(_poolNode);
+        OSAL_SEM_Post(&hDcpt->_heapSemaphore);
+    }
+
+    return true;
+}
+
+// internal functions
+//
+// deallocates the heap
+// NOTE: check is done if some blocks are still in use!
+static TCPIP_STACK_HEAP_RES _TCPIP_HEAP_Delete(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_POOL_OBJ_INSTANCE* hInst;
+    TCPIP_HEAP_POOL_DCPT*   hDcpt;
+
+    hInst = _TCPIP_HEAP_ObjInstance(heapH);
+
+    if(hInst == 0)
+    {
+        return TCPIP_STACK_HEAP_RES_NO_HEAP;
+    }
+
+    hDcpt = &hInst->heapDcpt;
+
+    if(hDcpt->_poolAllocatedUnits != 0)
+    {
+        //  deallocating a heap not completely de-allocated
+        return (hDcpt->_lastHeapErr = TCPIP_STACK_HEAP_RES_IN_USE);
+    }
+
+    OSAL_SEM_Delete(&hDcpt->_heapSemaphore);
+    // invalidate it
+    memset(&hInst->heapObj, 0, sizeof(hInst->heapObj));
+    (*hDcpt->free_fnc)(hDcpt->allocatedBuffer);
+
+    return TCPIP_STACK_HEAP_RES_OK;
+}
+
+
+static void* _TCPIP_HEAP_Malloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nBytes)
+{
+    TCPIP_HEAP_POOL_DCPT*  hDcpt;
+    TCPIP_HEAP_POOL_ENTRY_DCPT *pEntry, *pLast;
+    _poolNode*  ptr;
+    uint16_t    usedBlocks;
+
+
+    hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
+
+	if(hDcpt == 0 || nBytes == 0)
+	{
+		return 0;
+	}
+
+    // the entries are sorted: find the smallest one that fits
+    pLast = hDcpt->_poolEntries + hDcpt->_nPoolEntries;
+    for(pEntry = hDcpt->_poolEntries; pEntry != pLast; pEntry++)
+    {
+        if(pEntry->entrySize >= nBytes)
+        {
+            break;
+        }
+    }
+
+    OSAL_SEM_Pend(&hDcpt->_heapSemaphore, OSAL_WAIT_FOREVER);
+
+    ptr = 0;
+    for(; pEntry != pLast; pEntry++)
+    {
+        if(pEntry->freeList == 0 && pEntry->nExpBlks != 0)
+        {
+            _TCPIP_HEAP_EntryExpand(hDcpt, pEntry, pEntry->nExpBlks);
+        }
+
+        if((ptr = pEntry->freeList) != 0)
+        {   // found block
+            pEntry->freeList = ptr->next;
+            pEntry->freeBlocks--;
+            break;
+        }
+
+        if((hDcpt->_heapFlags & TCPIP_STACK_HEAP_FLAG_POOL_STRICT) != 0)
+        {   // no other entry allowed
+            break;
+        }
+    }
+
+    if(ptr == 0)
+    {
+        hDcpt->_lastHeapErr = TCPIP_STACK_HEAP_RES_NO_MEM;
+        OSAL_SEM_Post(&hDcpt->_heapSemaphore);
+        return 0;
+    }
+
+    ptr->pEntry = pEntry;
+    usedBlocks = pEntry->nBlocks - pEntry->freeBlocks;
+    if(usedBlocks > pEntry->maxUsedBlocks)
+    {
+        pEntry->maxUsedBlocks = usedBlocks;
+    }
+
+    if((hDcpt->_poolAllocatedUnits += pEntry->blockUnits) > hDcpt->_poolWatermark)
+    {
+        hDcpt->_poolWatermark = hDcpt->_poolAllocatedUnits;
+    }
+    OSAL_SEM_Post(&hDcpt->_heapSemaphore);
+    return ptr + 1;
+}
+
+static void* _TCPIP_HEAP_Calloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nElems, size_t elemSize)
+{
+    void* pBuff = _TCPIP_HEAP_Malloc(heapH, nElems * elemSize);
+    if(pBuff)
+    {
+        memset(pBuff, 0, nElems * elemSize);
+    }
+
+    return pBuff;
+
+}
+
+static size_t _TCPIP_HEAP_Free(TCPIP_STACK_HEAP_HANDLE heapH, const void* pBuff)
+{
+    TCPIP_HEAP_POOL_DCPT*  hDcpt;
+    TCPIP_HEAP_POOL_ENTRY_DCPT* pEntry;
+    _poolNode*  ptr;
+
+    hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
+
+    if(hDcpt == 0 || pBuff == 0)
+	{
+        return 0;
+    }
+
+    ptr = (_poolNode*)pBuff - 1;
+
+    OSAL_SEM_Pend(&hDcpt->_heapSemaphore, OSAL_WAIT_FOREVER);
+
+    pEntry = (ptr < hDcpt->_poolStart || ptr >= hDcpt->_expansionStart) ? 0 : ptr->pEntry;
+    if(pEntry < hDcpt->_poolEntries || pEntry >= hDcpt->_poolEntries + hDcpt->_nPoolEntries)
+    {
+        hDcpt->_lastHeapErr = TCPIP_STACK_HEAP_RES_PTR_ERR;   // not one of our pointers!!!
+        OSAL_SEM_Post(&hDcpt->_heapSemaphore);
+        return 0;
+    }
+
+    ptr->next = pEntry->freeList;
+    pEntry->freeList = ptr;
+    pEntry->freeBlocks++;
+
+    hDcpt->_poolAllocatedUnits -= pEntry->blockUnits;
+    OSAL_SEM_Post(&hDcpt->_heapSemaphore);
+    return pEntry->blockUnits * sizeof(_poolNode);
+}
+
+
+static size_t _TCPIP_HEAP_Size(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_POOL_DCPT*      hDcpt;
+
+    hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
+
+    if(hDcpt)
+    {
+        return hDcpt->_poolUnits * sizeof(_poolNode);
+    }
+
+    return 0;
+}
+
+static size_t _TCPIP_HEAP_FreeSize(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_POOL_DCPT*      hDcpt;
+
+    hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
+
+
+    if(hDcpt)
+    {
+        return (hDcpt->_poolUnits - hDcpt->_poolAllocatedUnits) * sizeof(_poolNode);
+    }
+    return 0;
+}
+
+static size_t _TCPIP_HEAP_HighWatermark(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_POOL_DCPT*      hDcpt;
+
+    hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
+
+    if(hDcpt)
+    {
+        return hDcpt->_poolWatermark * sizeof(_poolNode);
+    }
+    return 0;
+}
+
+// the largest block that can be allocated right now:
+// a free block or one that can be carved from the expansion area
+// Note: the block of the largest entry is not necessarily available
+// when TCPIP_STACK_HEAP_FLAG_POOL_STRICT is set
+static size_t _TCPIP_HEAP_MaxSize(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_POOL_DCPT   *hDcpt;
+    TCPIP_HEAP_POOL_ENTRY_DCPT *pEntry;
+    size_t      expansionUnits;
+    size_t      max_nunits;
+
+    max_nunits = 0;
+
+    hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
+    if(hDcpt)
+    {
+        OSAL_SEM_Pend(&hDcpt->_heapSemaphore, OSAL_WAIT_FOREVER);
+
+        expansionUnits = hDcpt->_poolEnd - hDcpt->_expansionStart;
+        for(pEntry = hDcpt->_poolEntries + hDcpt->_nPoolEntries - 1; pEntry >= hDcpt->_poolEntries; pEntry--)
+        {
+            if(pEntry->freeList != 0 || (pEntry->nExpBlks != 0 && expansionUnits >= pEntry->blockUnits))
+            {   // found block
+                max_nunits = pEntry->blockUnits;
+                break;
+            }
+        }
+        OSAL_SEM_Post(&hDcpt->_heapSemaphore);
+    }
+
+    return max_nunits * sizeof(_poolNode);
+
+}
+
+
+static TCPIP_STACK_HEAP_RES _TCPIP_HEAP_LastError(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_POOL_DCPT*      hDcpt;
+    TCPIP_STACK_HEAP_RES  res;
+
+    hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
+
+    if(hDcpt)
+    {
+        res = hDcpt->_lastHeapErr;
+        hDcpt->_lastHeapErr = TCPIP_STACK_HEAP_RES_OK;
+        return res;
+    }
+
+    return TCPIP_STACK_HEAP_RES_NO_HEAP;
+
+}
+
+#if defined(TCPIP_STACK_DRAM_DEBUG_ENABLE)
+static size_t _TCPIP_HEAP_AllocSize(TCPIP_STACK_HEAP_HANDLE heapH, const void* ptr)
+{
+    if(ptr)
+    {
+        _poolNode* hPtr = (_poolNode*)ptr -1;
+        return hPtr->pEntry->blockUnits * sizeof(_poolNode);
+    }
+
+    return 0;
+}
+#endif  // defined(TCPIP_STACK_DRAM_DEBUG_ENABLE)
+
@@ -43,6 +43,7 @@ THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
 #include "wolfssl/ssl.h"
 #include "wolfssl/wolfcrypt/logging.h"
 #include "wolfssl/wolfcrypt/random.h"
+#include "wolfssl/wolfcrypt/hash.h"
 
 extern  int CheckAvailableSize(WOLFSSL *ssl, int size);
 
@@ -52,6 +53,9 @@ typedef struct
     WOLFSSL_CTX* context;
     NET_PRES_TransportObject * transObject;
     bool isInited;
+    // Set when a resumed handshake fails, so the next one starts fresh
+    bool skipResumption;
+    NET_PRES_EncHandshakeStats handshakeStats;
 }net_pres_wolfsslInfo;
 
 // Temporary fix till crypto library is upgraded to recent wolfssl versions.
@@ -108,6 +112,38 @@ int NET_PRES_EncGlue_StreamClientSendCb0(void *sslin, char *buf, int sz, void *c
 static uint8_t _net_pres_wolfsslUsers = 0;
 
 		
+// Attach the cached session for this host, if any, to a new connection.
+// wolfSSL keeps client sessions in its static cache (which outlives the
+// socket and the network interface) keyed by a server ID; the ID used
+// here is a digest of the host name, so each host resumes its own session
+// regardless of the address it resolved to.
+static void NET_PRES_EncGlue_StreamClientResumeSession0(WOLFSSL* ssl, const char * hostName)
+{
+    byte serverId[WC_SHA_DIGEST_SIZE];
+    int newSession = net_pres_wolfSSLInfoStreamClient0.skipResumption ? 1 : 0;
+
+    net_pres_wolfSSLInfoStreamClient0.skipResumption = false;
+    if (wc_ShaHash((const byte *)hostName, strlen(hostName), serverId) != 0)
+    {
+        return;
+    }
+    wolfSSL_set_timeout(ssl, NET_PRES_TLS_SESSION_TIMEOUT);
+#ifdef HAVE_SESSION_TICKET
+    wolfSSL_UseSessionTicket(ssl);
+#endif
+    wolfSSL_SetServerID(ssl, serverId, sizeof(serverId), newSession);
+}
+
+bool NET_PRES_EncProviderStreamClientGetHandshakeStats0(NET_PRES_EncHandshakeStats * stats)
+{
+    if (stats == NULL)
+    {
+        return false;
+    }
+    *stats = net_pres_wolfSSLInfoStreamClient0.handshakeStats;
+    return true;
+}
+
 bool NET_PRES_EncProviderStreamClientInit0(NET_PRES_TransportObject * transObject)
 {
     const uint8_t * caCertsPtr;
@@ -189,8 +225,10 @@ bool NET_PRES_EncProviderStreamClientOpen0(uintptr_t transHandle, void * provide
         }
         if (wolfSSL_UseSNI(ssl, WOLFSSL_SNI_HOST_NAME, NET_PRES_SNI_HOST_NAME, strlen(NET_PRES_SNI_HOST_NAME)) != WOLFSSL_SUCCESS)
         {
+            wolfSSL_free(ssl);
             return false;
         }
+        NET_PRES_EncGlue_StreamClientResumeSession0(ssl, NET_PRES_SNI_HOST_NAME);
         memcpy(providerData, &ssl, sizeof(WOLFSSL*));
         return true;
 }
@@ -206,6 +244,14 @@ NET_PRES_EncSessionStatus NET_PRES_EncProviderClientConnect0(void * providerData
     switch (result)
     {
         case SSL_SUCCESS:
+            if (wolfSSL_session_reused(ssl))
+            {
+                net_pres_wolfSSLInfoStreamClient0.handshakeStats.resumed++;
+            }
+            else
+            {
+                net_pres_wolfSSLInfoStreamClient0.handshakeStats.full++;
+            }
             return NET_PRES_ENC_SS_OPEN;
         default:
         {
@@ -216,6 +262,9 @@ NET_PRES_EncSessionStatus NET_PRES_EncProviderClientConnect0(void * providerData
                 case SSL_ERROR_WANT_WRITE:
                     return NET_PRES_ENC_SS_CLIENT_NEGOTIATING;
                 default:
+                    net_pres_wolfSSLInfoStreamClient0.handshakeStats.failed++;
+                    // Don't offer the same session again; the server may have dropped it
+                    net_pres_wolfSSLInfoStreamClient0.skipResumption = true;
                     return NET_PRES_ENC_SS_FAILED;
             }
         }
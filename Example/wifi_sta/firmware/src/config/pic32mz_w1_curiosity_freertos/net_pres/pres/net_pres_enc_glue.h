@@ -44,6 +44,14 @@ THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
 #ifdef __CPLUSPLUS
 extern "C" {
 #endif
+// TLS handshake counters for the stream client provider
+typedef struct
+{
+    uint32_t full;      // handshakes that negotiated a new session
+    uint32_t resumed;   // handshakes that resumed a cached session
+    uint32_t failed;    // handshakes that failed
+}NET_PRES_EncHandshakeStats;
+
 extern NET_PRES_EncProviderObject net_pres_EncProviderStreamClient0;
 bool NET_PRES_EncProviderStreamClientInit0(struct _NET_PRES_TransportObject * transObject);
 bool NET_PRES_EncProviderStreamClientDeinit0(void);
@@ -58,7 +66,12 @@ int32_t NET_PRES_EncProviderReadReady0(void * providerData);
 int32_t NET_PRES_EncProviderPeek0(void * providerData, uint8_t * buffer, uint16_t size);
 int32_t NET_PRES_EncProviderOutputSize0(void * providerData, int32_t inSize);
 int32_t NET_PRES_EncProviderMaxOutputSize0(void * providerData);
+bool NET_PRES_EncProviderStreamClientGetHandshakeStats0(NET_PRES_EncHandshakeStats * stats);
 #define NET_PRES_SNI_HOST_NAME		"dp-sps-na.amazon.com"
+// Lifetime (seconds) of a cached client session; the server may expire it sooner
+#ifndef NET_PRES_TLS_SESSION_TIMEOUT
+#define NET_PRES_TLS_SESSION_TIMEOUT	3600
+#endif
 #ifdef __CPLUSPLUS
 }
 #endif
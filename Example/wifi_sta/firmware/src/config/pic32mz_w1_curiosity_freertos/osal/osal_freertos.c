@@ -55,6 +55,10 @@
 
 #include "osal/osal_freertos.h"
 
+#ifdef SYS_MEMTRACK_ENABLED
+#include "system/memtrack/sys_memtrack.h"
+#endif
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: OSAL Routines
@@ -773,7 +777,21 @@ OSAL_RESULT OSAL_MUTEX_Unlock(OSAL_MUTEX_HANDLE_TYPE* mutexID)
  */
 void* OSAL_Malloc(size_t size)
 {
+#ifdef SYS_MEMTRACK_ENABLED
+    void* pData = SYS_MEMTRACK_AllocFrom(size, SYS_MEMTRACK_TAG_OSAL, __builtin_return_address(0));
+
+#if (configUSE_MALLOC_FAILED_HOOK == 1)
+    if (pData == NULL)
+    {
+        extern void vApplicationMallocFailedHook(void);
+        vApplicationMallocFailedHook();
+    }
+#endif
+
+    return pData;
+#else
     return pvPortMalloc(size);
+#endif
 }
 
 // *****************************************************************************
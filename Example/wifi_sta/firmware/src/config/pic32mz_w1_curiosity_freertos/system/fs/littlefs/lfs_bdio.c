@@ -43,15 +43,39 @@
 
 #include <stdlib.h>
 #include "system/fs/sys_fs_media_manager.h"
+#include "osal/osal.h"
 
 #include "sys/kmem.h"
 
 #define CACHE_ALIGN_CHECK  (CACHE_LINE_SIZE - 1)
 
+/* Read the next block in the background once two consecutive blocks were read,
+ * at the cost of a second SYS_FS_ALIGNED_BUFFER_LEN buffer per media */
+#ifndef SYS_FS_LFS_READ_AHEAD
+#define SYS_FS_LFS_READ_AHEAD       0
+#endif
+
+#define LFS_BDIO_NO_BLOCK           ((lfs_block_t) -1)
+
+typedef enum
+{
+    LFS_BDIO_READ_AHEAD_NONE = 0,
+    LFS_BDIO_READ_AHEAD_PENDING,
+    LFS_BDIO_READ_AHEAD_READY
+} LFS_BDIO_READ_AHEAD_STATE;
+
 typedef struct
 {
     uint8_t alignedBuffer[SYS_FS_ALIGNED_BUFFER_LEN] __ALIGNED(CACHE_LINE_SIZE);
-    SYS_FS_MEDIA_COMMAND_STATUS commandStatus;
+#if (SYS_FS_LFS_READ_AHEAD == 1)
+    uint8_t readAheadBuffer[SYS_FS_ALIGNED_BUFFER_LEN] __ALIGNED(CACHE_LINE_SIZE);
+    lfs_block_t readAheadBlock;
+    LFS_BDIO_READ_AHEAD_STATE readAheadState;
+    lfs_block_t lastReadBlock;
+#endif
+    OSAL_SEM_DECLARE(commandDone);
+    bool commandDoneCreated;
+    volatile SYS_FS_MEDIA_COMMAND_STATUS commandStatus;
     SYS_FS_MEDIA_BLOCK_COMMAND_HANDLE commandHandle;
 } SYS_FS_BD_DATA;
 
@@ -68,9 +92,11 @@ void bdEventHandler
     {
         case SYS_FS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE:
             gSysFsDiskData[context].commandStatus = SYS_FS_MEDIA_COMMAND_COMPLETED;
+            OSAL_SEM_Post(&gSysFsDiskData[context].commandDone);
             break;
         case SYS_FS_MEDIA_EVENT_BLOCK_COMMAND_ERROR:
             gSysFsDiskData[context].commandStatus= SYS_FS_MEDIA_COMMAND_UNKNOWN;
+            OSAL_SEM_Post(&gSysFsDiskData[context].commandDone);
             break;
         default:
             break;
@@ -88,11 +114,14 @@ static BDSTATUS bd_checkCommandStatus(uint8_t pdrv)
     }
     else
     {
-        /* process the read request by blocking on the task routine that process the
-         I/O request */
+        /* Drive the request once from this task; the rest of it is driven by
+         * the memory driver task, and bdEventHandler wakes us up when it ends */
+        SYS_FS_MEDIA_MANAGER_TransferTask (pdrv);
+
+        /* A completion left over from an earlier request only costs one more pass */
         while (gSysFsDiskData[pdrv].commandStatus == SYS_FS_MEDIA_COMMAND_IN_PROGRESS)
         {
-            SYS_FS_MEDIA_MANAGER_TransferTask (pdrv);
+            OSAL_SEM_Pend(&gSysFsDiskData[pdrv].commandDone, OSAL_WAIT_FOREVER);
         }
 
 
@@ -131,6 +160,50 @@ static BDSTATUS disk_read_aligned
     return result;
 }
 
+#if (SYS_FS_LFS_READ_AHEAD == 1)
+/* Start reading a block into the read-ahead buffer without waiting for it */
+static void bd_readAheadStart(uint8_t pdrv, const struct lfs_config *cfg, lfs_block_t block)
+{
+    if ((cfg->block_size > SYS_FS_ALIGNED_BUFFER_LEN) || (block >= cfg->block_count))
+    {
+        return;
+    }
+
+    gSysFsDiskData[pdrv].commandStatus = SYS_FS_MEDIA_COMMAND_IN_PROGRESS;
+
+    gSysFsDiskData[pdrv].commandHandle = SYS_FS_MEDIA_MANAGER_SectorRead(pdrv,
+            gSysFsDiskData[pdrv].readAheadBuffer,
+            block * (cfg->block_size / SYS_FS_LFS_MAX_SS),
+            cfg->block_size / SYS_FS_LFS_MAX_SS);
+
+    if (gSysFsDiskData[pdrv].commandHandle != SYS_FS_MEDIA_BLOCK_COMMAND_HANDLE_INVALID)
+    {
+        gSysFsDiskData[pdrv].readAheadBlock = block;
+        gSysFsDiskData[pdrv].readAheadState = LFS_BDIO_READ_AHEAD_PENDING;
+    }
+}
+
+/* The media takes one request at a time: complete any read-ahead before the
+ * next request is submitted */
+static void bd_readAheadComplete(uint8_t pdrv)
+{
+    if (gSysFsDiskData[pdrv].readAheadState == LFS_BDIO_READ_AHEAD_PENDING)
+    {
+        gSysFsDiskData[pdrv].readAheadState = (bd_checkCommandStatus(pdrv) == RES_OK) ?
+                LFS_BDIO_READ_AHEAD_READY : LFS_BDIO_READ_AHEAD_NONE;
+    }
+}
+
+/* Drop the read-ahead and the sequential history, e.g. before the media changes */
+static void bd_readAheadReset(uint8_t pdrv)
+{
+    bd_readAheadComplete(pdrv);
+    gSysFsDiskData[pdrv].readAheadState = LFS_BDIO_READ_AHEAD_NONE;
+    gSysFsDiskData[pdrv].readAheadBlock = LFS_BDIO_NO_BLOCK;
+    gSysFsDiskData[pdrv].lastReadBlock = LFS_BDIO_NO_BLOCK;
+}
+#endif
+
 BDSTATUS lfs_bdio_initilize (
     uint8_t pdrv                /* Physical drive nmuber to identify the drive */
 )
@@ -141,6 +214,24 @@ BDSTATUS lfs_bdio_initilize (
         break;
     }
 
+    if (pdrv >= SYS_FS_MEDIA_NUMBER)
+    {
+        return RES_PARERR;
+    }
+
+    if (gSysFsDiskData[pdrv].commandDoneCreated == false)
+    {
+        if (OSAL_SEM_Create(&gSysFsDiskData[pdrv].commandDone, OSAL_SEM_TYPE_BINARY, 1, 0) != OSAL_RESULT_TRUE)
+        {
+            return RES_ERROR;
+        }
+        gSysFsDiskData[pdrv].commandDoneCreated = true;
+    }
+
+#if (SYS_FS_LFS_READ_AHEAD == 1)
+    bd_readAheadReset(pdrv);
+#endif
+
     SYS_FS_MEDIA_MANAGER_RegisterTransferHandler( (void *) bdEventHandler );
     return 0;
 }
@@ -151,27 +242,48 @@ int lfs_bdio_read(const struct lfs_config *cfg, lfs_block_t block,
     
     BDSTATUS result = RES_ERROR;
     BLOCK_DEV *bd = cfg->context;
-    uint32_t sector = block * (cfg->block_size/ SYS_FS_LFS_MAX_SS);
+    uint32_t sector = block * (cfg->block_size/ SYS_FS_LFS_MAX_SS) + off / SYS_FS_LFS_MAX_SS;
     uint32_t count = size/ SYS_FS_LFS_MAX_SS;
 
-    uint32_t i = 0;
     uint32_t sector_aligned_index = 0;
     uint8_t (*sector_ptr)[SYS_FS_LFS_MAX_SS] = (uint8_t (*)[])buffer;
     uint8_t *buff_prt = (uint8_t*) buffer;
-	
 
+#if (SYS_FS_LFS_READ_AHEAD == 1)
+    bool isWholeBlock = (off == 0) && (size == cfg->block_size);
+
+    bd_readAheadComplete(bd->disk_num);
+
+    if (isWholeBlock && (gSysFsDiskData[bd->disk_num].readAheadState == LFS_BDIO_READ_AHEAD_READY)
+            && (gSysFsDiskData[bd->disk_num].readAheadBlock == block))
+    {
+        /* Sequential read: the block is already in the read-ahead buffer */
+        memcpy(buffer, gSysFsDiskData[bd->disk_num].readAheadBuffer, size);
+        result = RES_OK;
+    }
+    else
+#endif
     /* Use Aligned Buffer if input buffer is in Cacheable address space and
      * is not aligned to cache line size */
     if ((IS_KVA0((uint8_t *)buffer) == true) && (((uint32_t)buffer & CACHE_ALIGN_CHECK) != 0))
     {
-        /* For unaligned buffers, if count is > 2, then always read the first sector into the internal aligned buffer since the starting address of app buffer is unaligned.
-         * After this, find the first 512 byte aligned address in the app buffer and copy the remaining (count-1) sectors into the app buffer directly.
-         * After this, move the count-1 sectors in app buffer to the end (i.e. start of 1st sector) in app buffer.
-         * Finally, copy the first sector from internal aligned buffer to app buffer.
-         * For unaligned buffers, if count is < 2, then directly use the internal aligned buffer and then copy it to app buffer as there is no gain in following the above logic.
-        */
-        if (count > 2)
+        if (size <= SYS_FS_ALIGNED_BUFFER_LEN)
         {
+            /* Read all the sectors with a single transfer into the internal aligned buffer */
+            result = disk_read_aligned(bd->disk_num, gSysFsDiskData[bd->disk_num].alignedBuffer, sector, count);
+
+            if (result == RES_OK)
+            {
+                memcpy(buffer, gSysFsDiskData[bd->disk_num].alignedBuffer, size);
+            }
+        }
+        else
+        {
+            /* Larger than the internal aligned buffer: read the first sector into the internal aligned buffer since the starting address of app buffer is unaligned.
+             * After this, find the first 512 byte aligned address in the app buffer and copy the remaining (count-1) sectors into the app buffer directly.
+             * After this, move the count-1 sectors in app buffer to the end (i.e. start of 1st sector) in app buffer.
+             * Finally, copy the first sector from internal aligned buffer to app buffer.
+            */
             /* Read first sector from media into internal aligned buffer */
             result = disk_read_aligned(bd->disk_num, gSysFsDiskData[bd->disk_num].alignedBuffer, sector, 1);
 
@@ -193,34 +305,36 @@ int lfs_bdio_read(const struct lfs_config *cfg, lfs_block_t block,
                 }
             }
         }
-		else
-        {
-            for (i = 0; i < count; i++)
-            {
-                result = disk_read_aligned(bd->disk_num, gSysFsDiskData[bd->disk_num].alignedBuffer, (sector + i), 1);
-
-                if (result == RES_OK)
-                {
-                    /* Copy the read data from the internal aligned buffer to the start of the application buffer */
-                    memcpy(&sector_ptr[i], gSysFsDiskData[bd->disk_num].alignedBuffer, SYS_FS_LFS_MAX_SS);
-                }
-                else
-                {
-                    break;
-                }
-            }
-        }		
     }
     else
     {
         result = disk_read_aligned(bd->disk_num, buffer, sector, count);
-		
-        if (result != RES_OK)
+    }
+
+    if (result != RES_OK)
+    {
+        return LFS_ERR_IO;
+    }
+
+#if (SYS_FS_LFS_READ_AHEAD == 1)
+    if (isWholeBlock)
+    {
+        if (gSysFsDiskData[bd->disk_num].readAheadBlock == block)
+        {
+            gSysFsDiskData[bd->disk_num].readAheadState = LFS_BDIO_READ_AHEAD_NONE;
+        }
+
+        /* Two consecutive blocks: fetch the next one while littlefs consumes this one */
+        if ((gSysFsDiskData[bd->disk_num].lastReadBlock != LFS_BDIO_NO_BLOCK)
+                && (gSysFsDiskData[bd->disk_num].lastReadBlock + 1 == block)
+                && (gSysFsDiskData[bd->disk_num].readAheadState == LFS_BDIO_READ_AHEAD_NONE))
         {
-            return LFS_ERR_IO;
+            bd_readAheadStart(bd->disk_num, cfg, block + 1);
         }
+        gSysFsDiskData[bd->disk_num].lastReadBlock = block;
     }
-    
+#endif
+
     return LFS_ERR_OK;
 }
 
@@ -237,6 +351,10 @@ int lfs_bdio_prog(const struct lfs_config *cfg, lfs_block_t block,
 
     data = (uint8_t*) buffer;
 
+#if (SYS_FS_LFS_READ_AHEAD == 1)
+    bd_readAheadReset(bd->disk_num);
+#endif
+
     /* Use Aligned Buffer if input buffer is in Cacheable address space and
      * is not aligned to cache line size */
     if ((IS_KVA0((uint8_t *)buffer) == true) && (((uint32_t)buffer & CACHE_ALIGN_CHECK) != 0))
@@ -304,6 +422,10 @@ int lfs_bdio_erase(const struct lfs_config *cfg, lfs_block_t block) {
     uint8_t buffer[SYS_FS_LFS_MAX_SS];
     memset(buffer, 0xff, sizeof(buffer));
 
+#if (SYS_FS_LFS_READ_AHEAD == 1)
+    bd_readAheadReset(bd->disk_num);
+#endif
+
     gSysFsDiskData[bd->disk_num].commandStatus = SYS_FS_MEDIA_COMMAND_IN_PROGRESS;
     gSysFsDiskData[bd->disk_num].commandHandle = SYS_FS_MEDIA_BLOCK_COMMAND_HANDLE_INVALID;
     
@@ -0,0 +1,326 @@
+/*******************************************************************************
+  LittleFS Block Device Benchmark.
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    lfs_bdio_benchmark.c
+
+  Summary:
+    Host count of the block operations LittleFS issues to mount, write and
+    read a file.
+
+  Description:
+    This program mounts LittleFS with the same geometry as the target
+    (sys_fs_littlefs_interface.c) on the file-backed block device
+    (lfs_bdio_file.c) and reports the number of block device reads, progs and
+    erases each mount, file write and file read issues.
+
+    It does not exercise lfs_bdio.c: the times it prints are those of LittleFS
+    and of the host file I/O, not of the SST26 transfers, and say nothing of
+    the target block device. It is a host tool only and is not part of the
+    target build.
+*******************************************************************************/
+
+/*******************************************************************************
+* Copyright (C) 2021 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *******************************************************************************/
+
+#include "lfs_bdio_file.h"
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Same geometry as sys_fs_littlefs_interface.c */
+#define     LFS_READ_SIZE   2048
+#define     LFS_PROG_SIZE   2048
+#define     LFS_BLOCK_SIZE   2048
+#define     LFS_BLOCK_COUNT   (64*1024/2048)
+#define     LFS_BLOCK_CYCLES   16
+#define     LFS_CACHE_SIZE   2048
+#define     LFS_LOOKAHEAD_SIZE   64
+
+#define BENCHMARK_FILE_NAME         "benchmark.bin"
+#define BENCHMARK_CHUNK_SIZE        256
+
+static uint8_t ReadBuf[LFS_CACHE_SIZE];
+static uint8_t ProgBuf[LFS_CACHE_SIZE];
+static uint8_t LookaheadBuf[LFS_LOOKAHEAD_SIZE];
+static BLOCK_DEV benchmarkDevice = { .disk_num = 0 };
+
+static const struct lfs_config cfg = {
+        .context        = &benchmarkDevice,
+        .read           = lfs_bdio_read,
+        .prog           = lfs_bdio_prog,
+        .erase          = lfs_bdio_erase,
+        .sync           = lfs_bdio_sync,
+        .read_size      = LFS_READ_SIZE,
+        .prog_size      = LFS_PROG_SIZE,
+        .block_size     = LFS_BLOCK_SIZE,
+        .block_count    = LFS_BLOCK_COUNT,
+        .block_cycles   = LFS_BLOCK_CYCLES,
+        .cache_size     = LFS_CACHE_SIZE,
+        .lookahead_size = LFS_LOOKAHEAD_SIZE,
+        .read_buffer    = ReadBuf,
+        .prog_buffer    = ProgBuf,
+        .lookahead_buffer = LookaheadBuf,
+};
+
+typedef struct
+{
+    const char *imagePath;
+    unsigned iterations;
+    lfs_size_t fileSize;
+} BENCHMARK_OPTIONS;
+
+static uint64_t benchmarkNowNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+}
+
+static void benchmarkReport(const char *name, unsigned iterations, uint64_t elapsedNs, uint64_t bytes)
+{
+    LFS_BDIO_FILE_STATS stats;
+    lfs_bdio_file_stats(benchmarkDevice.disk_num, &stats, true);
+
+    printf("%-18s %12.1f us/op", name, elapsedNs / 1000.0 / iterations);
+    if (bytes)
+    {
+        printf(" %9.2f MB/s", bytes * 1000.0 / elapsedNs);
+    }
+    else
+    {
+        printf(" %14s", "");
+    }
+    printf("  reads %5.1f  progs %5.1f  erases %5.1f  per op\n",
+            (double) stats.reads / iterations, (double) stats.progs / iterations,
+            (double) stats.erases / iterations);
+}
+
+static int benchmarkWriteFile(lfs_t *lfs, const uint8_t *data, lfs_size_t size)
+{
+    lfs_file_t file;
+    lfs_size_t written;
+    int err = lfs_file_open(lfs, &file, BENCHMARK_FILE_NAME, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+    if (err)
+    {
+        return err;
+    }
+
+    /* Write in chunks, like the application does through SYS_FS_FileWrite */
+    for (written = 0; written < size; written += BENCHMARK_CHUNK_SIZE)
+    {
+        lfs_size_t chunk = size - written < BENCHMARK_CHUNK_SIZE ? size - written : BENCHMARK_CHUNK_SIZE;
+        if (lfs_file_write(lfs, &file, data + written, chunk) != (lfs_ssize_t) chunk)
+        {
+            lfs_file_close(lfs, &file);
+            return LFS_ERR_IO;
+        }
+    }
+
+    return lfs_file_close(lfs, &file);
+}
+
+static int benchmarkReadFile(lfs_t *lfs, uint8_t *data, lfs_size_t size)
+{
+    lfs_file_t file;
+    lfs_size_t read;
+    int err = lfs_file_open(lfs, &file, BENCHMARK_FILE_NAME, LFS_O_RDONLY);
+    if (err)
+    {
+        return err;
+    }
+
+    for (read = 0; read < size; read += BENCHMARK_CHUNK_SIZE)
+    {
+        lfs_size_t chunk = size - read < BENCHMARK_CHUNK_SIZE ? size - read : BENCHMARK_CHUNK_SIZE;
+        if (lfs_file_read(lfs, &file, data + read, chunk) != (lfs_ssize_t) chunk)
+        {
+            lfs_file_close(lfs, &file);
+            return LFS_ERR_CORRUPT;
+        }
+    }
+
+    return lfs_file_close(lfs, &file);
+}
+
+static int benchmarkRun(const BENCHMARK_OPTIONS *options)
+{
+    lfs_t lfs;
+    LFS_BDIO_FILE_STATS stats;
+    uint64_t start;
+    unsigned i;
+    int err;
+
+    uint8_t *expected = malloc(options->fileSize);
+    uint8_t *actual = malloc(options->fileSize);
+    if (!expected || !actual)
+    {
+        free(expected);
+        free(actual);
+        return LFS_ERR_NOMEM;
+    }
+    for (i = 0; i < options->fileSize; i++)
+    {
+        expected[i] = (uint8_t) (i * 31 + 7);
+    }
+
+    err = lfs_format(&lfs, &cfg);
+    if (err)
+    {
+        fprintf(stderr, "lfs_format failed: %d\n", err);
+        goto done;
+    }
+    lfs_bdio_file_stats(benchmarkDevice.disk_num, &stats, true);
+
+    /* Mount/unmount */
+    start = benchmarkNowNs();
+    for (i = 0; i < options->iterations && !err; i++)
+    {
+        err = lfs_mount(&lfs, &cfg);
+        if (!err)
+        {
+            err = lfs_unmount(&lfs);
+        }
+    }
+    if (err)
+    {
+        fprintf(stderr, "lfs_mount failed: %d\n", err);
+        goto done;
+    }
+    benchmarkReport("mount", options->iterations, benchmarkNowNs() - start, 0);
+
+    err = lfs_mount(&lfs, &cfg);
+    if (err)
+    {
+        fprintf(stderr, "lfs_mount failed: %d\n", err);
+        goto done;
+    }
+    lfs_bdio_file_stats(benchmarkDevice.disk_num, &stats, true);
+
+    /* Write (create/truncate) */
+    start = benchmarkNowNs();
+    for (i = 0; i < options->iterations && !err; i++)
+    {
+        err = benchmarkWriteFile(&lfs, expected, options->fileSize);
+    }
+    if (err)
+    {
+        fprintf(stderr, "write failed: %d\n", err);
+        lfs_unmount(&lfs);
+        goto done;
+    }
+    benchmarkReport("write", options->iterations, benchmarkNowNs() - start,
+            (uint64_t) options->fileSize * options->iterations);
+
+    /* Sequential read */
+    start = benchmarkNowNs();
+    for (i = 0; i < options->iterations && !err; i++)
+    {
+        err = benchmarkReadFile(&lfs, actual, options->fileSize);
+    }
+    if (err || memcmp(expected, actual, options->fileSize))
+    {
+        fprintf(stderr, "read failed: %d\n", err);
+        err = err ? err : LFS_ERR_CORRUPT;
+        lfs_unmount(&lfs);
+        goto done;
+    }
+    benchmarkReport("read", options->iterations, benchmarkNowNs() - start,
+            (uint64_t) options->fileSize * options->iterations);
+
+    err = lfs_unmount(&lfs);
+
+done:
+    free(expected);
+    free(actual);
+    return err;
+}
+
+static void benchmarkUsage(const char *program)
+{
+    fprintf(stderr, "Usage: %s [--image PATH] [--iterations N] [--file-size BYTES]\n", program);
+}
+
+int main(int argc, char **argv)
+{
+    BENCHMARK_OPTIONS options = {
+        .imagePath = "lfs_benchmark.img",
+        .iterations = 100,
+        .fileSize = 8 * 1024
+    };
+    static const struct option longOptions[] = {
+        { "image", required_argument, NULL, 'i' },
+        { "iterations", required_argument, NULL, 'n' },
+        { "file-size", required_argument, NULL, 's' },
+        { NULL, 0, NULL, 0 }
+    };
+    int option;
+
+    while ((option = getopt_long(argc, argv, "i:n:s:", longOptions, NULL)) != -1)
+    {
+        switch (option)
+        {
+            case 'i':
+                options.imagePath = optarg;
+                break;
+            case 'n':
+                options.iterations = (unsigned) strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                options.fileSize = (lfs_size_t) strtoul(optarg, NULL, 0);
+                break;
+            default:
+                benchmarkUsage(argv[0]);
+                return 2;
+        }
+    }
+
+    /* Leave room for the metadata pairs and the copy-on-write of the file */
+    if (options.iterations == 0 || options.fileSize == 0
+            || options.fileSize > LFS_BLOCK_SIZE * LFS_BLOCK_COUNT / 4)
+    {
+        benchmarkUsage(argv[0]);
+        return 2;
+    }
+
+    /* Always start from a fresh image */
+    remove(options.imagePath);
+    if (lfs_bdio_file_open(benchmarkDevice.disk_num, options.imagePath, LFS_BLOCK_SIZE * LFS_BLOCK_COUNT) != RES_OK
+            || lfs_bdio_initilize(benchmarkDevice.disk_num) != RES_OK)
+    {
+        fprintf(stderr, "Unable to open %s\n", options.imagePath);
+        return 2;
+    }
+
+    printf("LittleFS block operations on %s (host file, not lfs_bdio.c)\n", options.imagePath);
+    int err = benchmarkRun(&options);
+    lfs_bdio_file_close(benchmarkDevice.disk_num);
+
+    return err ? 1 : 0;
+}
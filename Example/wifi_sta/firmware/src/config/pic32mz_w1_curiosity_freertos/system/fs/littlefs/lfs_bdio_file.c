@@ -0,0 +1,257 @@
+/*******************************************************************************
+  File-backed Block Device Interface Implementation.
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    lfs_bdio_file.c
+
+  Summary:
+    This file contains a host implementation of the Low Level Block Device
+    Interface functions backed by an image file.
+
+  Description:
+    This file implements the lfs_bdio.h API on top of a POSIX file so that the
+    same LittleFS configuration can be mounted, read and written on a
+    development machine. Erased blocks read back as 0xFF like the flash media.
+*******************************************************************************/
+
+/*******************************************************************************
+* Copyright (C) 2021 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *******************************************************************************/
+
+#include "lfs_bdio_file.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+
+typedef struct
+{
+    int fd;
+    lfs_size_t size;
+    LFS_BDIO_FILE_STATS stats;
+} LFS_BDIO_FILE_DATA;
+
+static LFS_BDIO_FILE_DATA gFileDiskData[LFS_BDIO_FILE_MAX_DRIVES] = {
+    [0 ... (LFS_BDIO_FILE_MAX_DRIVES - 1)] = { .fd = -1 }
+};
+
+static LFS_BDIO_FILE_DATA *bd_fileData(const struct lfs_config *cfg)
+{
+    BLOCK_DEV *bd = cfg->context;
+
+    if ((bd->disk_num >= LFS_BDIO_FILE_MAX_DRIVES) || (gFileDiskData[bd->disk_num].fd < 0))
+    {
+        return NULL;
+    }
+
+    return &gFileDiskData[bd->disk_num];
+}
+
+static bool bd_fileRange(const struct lfs_config *cfg, const LFS_BDIO_FILE_DATA *data,
+        lfs_block_t block, lfs_off_t off, lfs_size_t size, off_t *position)
+{
+    uint64_t start = (uint64_t) block * cfg->block_size + off;
+
+    if ((block >= cfg->block_count) || (off + size > cfg->block_size) || (start + size > data->size))
+    {
+        return false;
+    }
+
+    *position = (off_t) start;
+    return true;
+}
+
+BDSTATUS lfs_bdio_file_open(uint8_t pdrv, const char *path, lfs_size_t size)
+{
+    uint8_t erased[512];
+    off_t current;
+
+    if ((pdrv >= LFS_BDIO_FILE_MAX_DRIVES) || (path == NULL) || (size == 0))
+    {
+        return RES_PARERR;
+    }
+
+    lfs_bdio_file_close(pdrv);
+
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+    {
+        return RES_NOTRDY;
+    }
+
+    /* Grow a new or short image with erased (0xFF) bytes */
+    current = lseek(fd, 0, SEEK_END);
+    if (current < 0)
+    {
+        close(fd);
+        return RES_ERROR;
+    }
+
+    memset(erased, 0xff, sizeof(erased));
+    while ((lfs_size_t) current < size)
+    {
+        size_t chunk = size - (lfs_size_t) current;
+        if (chunk > sizeof(erased))
+        {
+            chunk = sizeof(erased);
+        }
+
+        if (write(fd, erased, chunk) != (ssize_t) chunk)
+        {
+            close(fd);
+            return RES_ERROR;
+        }
+        current += chunk;
+    }
+
+    gFileDiskData[pdrv].fd = fd;
+    gFileDiskData[pdrv].size = size;
+    memset(&gFileDiskData[pdrv].stats, 0, sizeof(gFileDiskData[pdrv].stats));
+
+    return RES_OK;
+}
+
+void lfs_bdio_file_close(uint8_t pdrv)
+{
+    if ((pdrv < LFS_BDIO_FILE_MAX_DRIVES) && (gFileDiskData[pdrv].fd >= 0))
+    {
+        close(gFileDiskData[pdrv].fd);
+        gFileDiskData[pdrv].fd = -1;
+    }
+}
+
+void lfs_bdio_file_stats(uint8_t pdrv, LFS_BDIO_FILE_STATS *stats, bool clear)
+{
+    if (pdrv >= LFS_BDIO_FILE_MAX_DRIVES)
+    {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+
+    *stats = gFileDiskData[pdrv].stats;
+    if (clear)
+    {
+        memset(&gFileDiskData[pdrv].stats, 0, sizeof(gFileDiskData[pdrv].stats));
+    }
+}
+
+BDSTATUS lfs_bdio_initilize (
+    uint8_t pdrv                /* Physical drive nmuber to identify the drive */
+)
+{
+    if ((pdrv >= LFS_BDIO_FILE_MAX_DRIVES) || (gFileDiskData[pdrv].fd < 0))
+    {
+        return RES_NOTRDY;
+    }
+
+    return RES_OK;
+}
+
+/// block device API ///
+int lfs_bdio_read(const struct lfs_config *cfg, lfs_block_t block,
+        lfs_off_t off, void *buffer, lfs_size_t size) {
+
+    LFS_BDIO_FILE_DATA *data = bd_fileData(cfg);
+    off_t position;
+
+    if ((data == NULL) || !bd_fileRange(cfg, data, block, off, size, &position))
+    {
+        return LFS_ERR_INVAL;
+    }
+
+    if (pread(data->fd, buffer, size, position) != (ssize_t) size)
+    {
+        return LFS_ERR_IO;
+    }
+
+    data->stats.reads++;
+    data->stats.bytesRead += size;
+    return LFS_ERR_OK;
+}
+
+int lfs_bdio_prog(const struct lfs_config *cfg, lfs_block_t block,
+        lfs_off_t off, const void *buffer, lfs_size_t size) {
+
+    LFS_BDIO_FILE_DATA *data = bd_fileData(cfg);
+    off_t position;
+
+    if ((data == NULL) || !bd_fileRange(cfg, data, block, off, size, &position))
+    {
+        return LFS_ERR_INVAL;
+    }
+
+    if (pwrite(data->fd, buffer, size, position) != (ssize_t) size)
+    {
+        return LFS_ERR_IO;
+    }
+
+    data->stats.progs++;
+    data->stats.bytesProgrammed += size;
+    return LFS_ERR_OK;
+}
+
+int lfs_bdio_erase(const struct lfs_config *cfg, lfs_block_t block) {
+
+    LFS_BDIO_FILE_DATA *data = bd_fileData(cfg);
+    uint8_t erased[512];
+    off_t position;
+    lfs_off_t off;
+
+    if ((data == NULL) || !bd_fileRange(cfg, data, block, 0, cfg->block_size, &position))
+    {
+        return LFS_ERR_INVAL;
+    }
+
+    memset(erased, 0xff, sizeof(erased));
+    for (off = 0; off < cfg->block_size; off += sizeof(erased))
+    {
+        size_t chunk = cfg->block_size - off;
+        if (chunk > sizeof(erased))
+        {
+            chunk = sizeof(erased);
+        }
+
+        if (pwrite(data->fd, erased, chunk, position + off) != (ssize_t) chunk)
+        {
+            return LFS_ERR_IO;
+        }
+    }
+
+    data->stats.erases++;
+    return LFS_ERR_OK;
+}
+
+int lfs_bdio_sync(const struct lfs_config *cfg) {
+
+    LFS_BDIO_FILE_DATA *data = bd_fileData(cfg);
+
+    if (data == NULL)
+    {
+        return LFS_ERR_INVAL;
+    }
+
+    data->stats.syncs++;
+    return LFS_ERR_OK;
+}
@@ -0,0 +1,82 @@
+/*******************************************************************************
+  File-backed Block Device Interface Implementation.
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    lfs_bdio_file.h
+
+  Summary:
+    File-backed twin of the LittleFS block device for host builds.
+
+  Description:
+    This file declares a host (POSIX) implementation of the lfs_bdio.h block
+    device API backed by an image file instead of the SPI flash media. It is
+    not part of the target build; it lets the LittleFS mount, read and write
+    paths be exercised on a development machine and counts the block
+    operations they issue.
+*******************************************************************************/
+
+/*******************************************************************************
+* Copyright (C) 2021 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *******************************************************************************/
+
+#ifndef LFS_BDIO_FILE_H
+#define LFS_BDIO_FILE_H
+
+#include "lfs_bdio.h"
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define LFS_BDIO_FILE_MAX_DRIVES    1
+
+/* Block device operation counters */
+typedef struct
+{
+    uint32_t reads;
+    uint32_t progs;
+    uint32_t erases;
+    uint32_t syncs;
+    uint64_t bytesRead;
+    uint64_t bytesProgrammed;
+} LFS_BDIO_FILE_STATS;
+
+// Attach an image file to a drive, creating or resizing it to size bytes
+BDSTATUS lfs_bdio_file_open(uint8_t pdrv, const char *path, lfs_size_t size);
+
+// Detach the image file of a drive
+void lfs_bdio_file_close(uint8_t pdrv);
+
+// Get and clear the operation counters of a drive
+void lfs_bdio_file_stats(uint8_t pdrv, LFS_BDIO_FILE_STATS *stats, bool clear);
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,55 @@
+/*******************************************************************************
+  Memory Tracking Host Configuration
+
+  Summary:
+    Host stand-in of the configuration.h used by sys_memtrack.c.
+
+  Description:
+    Builds the memory tracking service into the host unit tests: no RTOS
+    lock, the process clock as the tick and a small timeline. This file is
+    not part of the target build.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+Copyright (C) 2020 released Microchip Technology Inc.  All rights reserved.
+
+Microchip licenses to you the right to use, modify, copy and distribute
+Software only when embedded on a Microchip microcontroller or digital signal
+controller that is integrated into your product or third party product
+(pursuant to the sublicense terms in the accompanying license agreement).
+
+You should refer to the license agreement accompanying this Software for
+additional information regarding your rights and obligations.
+
+SOFTWARE AND DOCUMENTATION ARE PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF
+MERCHANTABILITY, TITLE, NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE.
+IN NO EVENT SHALL MICROCHIP OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER
+CONTRACT, NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR
+OTHER LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR
+CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT OF
+SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+(INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef _SYS_MEMTRACK_HOST_CONFIGURATION_H
+#define _SYS_MEMTRACK_HOST_CONFIGURATION_H
+
+#include <time.h>
+
+#define SYS_MEMTRACK_ENABLED
+
+/* Single threaded tests */
+#define SYS_MEMTRACK_LOCK()
+#define SYS_MEMTRACK_UNLOCK()
+#define SYS_MEMTRACK_TICK()             ((uint32_t)(clock() / (CLOCKS_PER_SEC / 1000)))
+#define SYS_MEMTRACK_TICK_RATE          1000
+
+#define SYS_MEMTRACK_EVENT_LOG_SIZE     16
+#define SYS_MEMTRACK_MAX_SITES          4
+#define SYS_MEMTRACK_HEAP_SIZE          175000
+
+#endif // _SYS_MEMTRACK_HOST_CONFIGURATION_H
@@ -0,0 +1,721 @@
+/*******************************************************************************
+  Memory Tracking System Service Implementation
+
+  File Name:
+    sys_memtrack.c
+
+  Summary:
+    Tagged accounting of the heap allocations.
+
+  Description:
+    Every tracked block is allocated from the C library heap with a header in
+    front of the user data. The header links the block into the live block list
+    and keeps its tag, size, call site and allocation sequence number, so that
+    the per tag statistics, the call sites and the leaks can be computed at
+    any time. The allocations and frees are also recorded in a circular
+    timeline that is written out by SYS_MEMTRACK_Dump().
+ *******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+Copyright (C) 2020 released Microchip Technology Inc.  All rights reserved.
+
+Microchip licenses to you the right to use, modify, copy and distribute
+Software only when embedded on a Microchip microcontroller or digital signal
+controller that is integrated into your product or third party product
+(pursuant to the sublicense terms in the accompanying license agreement).
+
+You should refer to the license agreement accompanying this Software for
+additional information regarding your rights and obligations.
+
+SOFTWARE AND DOCUMENTATION ARE PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF
+MERCHANTABILITY, TITLE, NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE.
+IN NO EVENT SHALL MICROCHIP OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER
+CONTRACT, NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR
+OTHER LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR
+CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT OF
+SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+(INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "configuration.h"
+#include "system/memtrack/sys_memtrack.h"
+
+#ifndef SYS_MEMTRACK_LOCK
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* The C library heap is not thread safe: same protection as heap_3.c */
+#define SYS_MEMTRACK_LOCK()         vTaskSuspendAll()
+#define SYS_MEMTRACK_UNLOCK()       (void)xTaskResumeAll()
+#define SYS_MEMTRACK_TICK()         ((uint32_t)xTaskGetTickCount())
+#define SYS_MEMTRACK_TICK_RATE      configTICK_RATE_HZ
+#endif
+
+#ifdef SYS_MEMTRACK_CLICMD_ENABLED
+#include "system/command/sys_command.h"
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data Types and Data
+// *****************************************************************************
+// *****************************************************************************
+
+/* Header in front of every tracked block */
+typedef struct _SYS_MEMTRACK_HDR
+{
+    struct _SYS_MEMTRACK_HDR *next;
+    struct _SYS_MEMTRACK_HDR *prev;
+    const void *caller;
+    uint32_t size;
+    uint32_t seq;
+    uint32_t check;     /* SYS_MEMTRACK_CHECK ^ header address */
+    uint8_t tag;
+} SYS_MEMTRACK_HDR;
+
+/* Keeps the user data 8 byte aligned */
+#define SYS_MEMTRACK_HDR_SIZE       ((sizeof(SYS_MEMTRACK_HDR) + 7) & ~(size_t)7)
+
+#define SYS_MEMTRACK_CHECK          0x4D54524BUL
+
+/* Distinct call sites aggregated by SYS_MEMTRACK_Sites() */
+#define SYS_MEMTRACK_SITE_TABLE_SIZE    48
+
+/* Dump record sizes */
+#define SYS_MEMTRACK_DUMP_HEADER_SIZE   32
+#define SYS_MEMTRACK_DUMP_TAG_SIZE      24
+#define SYS_MEMTRACK_DUMP_SITE_SIZE     12
+#define SYS_MEMTRACK_DUMP_EVENT_SIZE    20
+
+typedef struct
+{
+    uint32_t tick;
+    const void *caller;
+    uint32_t size;
+    uint32_t tagLiveBytes;
+    uint8_t tag;
+    uint8_t kind;
+} SYS_MEMTRACK_EVENT;
+
+typedef struct
+{
+    SYS_MEMTRACK_HDR *liveList;
+    SYS_MEMTRACK_TAG_STATS tags[SYS_MEMTRACK_TAG_COUNT];
+    uint32_t liveBytes;
+    uint32_t peakBytes;
+    uint32_t seq;
+    uint32_t droppedEvents;
+    uint32_t foreignFrees;
+    uint16_t eventHead;         /* next event slot */
+    uint16_t eventCount;
+    bool frozen;                /* timeline being dumped */
+    SYS_MEMTRACK_EVENT events[SYS_MEMTRACK_EVENT_LOG_SIZE];
+} SYS_MEMTRACK_DCPT;
+
+/* Zero initialized: tracking works before SYS_MEMTRACK_Initialize() */
+static SYS_MEMTRACK_DCPT gMemTrack;
+
+static SYS_MEMTRACK_SITE gMemTrackSites[SYS_MEMTRACK_SITE_TABLE_SIZE];
+
+static const char* const gMemTrackTagNames[SYS_MEMTRACK_TAG_COUNT] =
+{
+    "other",    // SYS_MEMTRACK_TAG_OTHER
+    "rtos",     // SYS_MEMTRACK_TAG_RTOS
+    "osal",     // SYS_MEMTRACK_TAG_OSAL
+    "tcpip",    // SYS_MEMTRACK_TAG_TCPIP
+    "tls",      // SYS_MEMTRACK_TAG_TLS
+    "ffs",      // SYS_MEMTRACK_TAG_FFS
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Called with the lock taken */
+static void _SYS_MEMTRACK_Record(SYS_MEMTRACK_EVENT_KIND kind, uint8_t tag, uint32_t size, const void *caller)
+{
+    SYS_MEMTRACK_EVENT *pEvent;
+
+    if (gMemTrack.frozen)
+    {
+        gMemTrack.droppedEvents++;
+        return;
+    }
+
+    pEvent = gMemTrack.events + gMemTrack.eventHead;
+    pEvent->tick = SYS_MEMTRACK_TICK();
+    pEvent->caller = caller;
+    pEvent->size = size;
+    pEvent->tagLiveBytes = gMemTrack.tags[tag].liveBytes;
+    pEvent->tag = tag;
+    pEvent->kind = (uint8_t)kind;
+
+    if (++gMemTrack.eventHead == SYS_MEMTRACK_EVENT_LOG_SIZE)
+    {
+        gMemTrack.eventHead = 0;
+    }
+
+    if (gMemTrack.eventCount < SYS_MEMTRACK_EVENT_LOG_SIZE)
+    {
+        gMemTrack.eventCount++;
+    }
+    else
+    {   // the oldest event was overwritten
+        gMemTrack.droppedEvents++;
+    }
+}
+
+static void _SYS_MEMTRACK_Put32(uint8_t *pBuff, uint32_t value)
+{
+    pBuff[0] = (uint8_t)value;
+    pBuff[1] = (uint8_t)(value >> 8);
+    pBuff[2] = (uint8_t)(value >> 16);
+    pBuff[3] = (uint8_t)(value >> 24);
+}
+
+static void _SYS_MEMTRACK_Put16(uint8_t *pBuff, uint16_t value)
+{
+    pBuff[0] = (uint8_t)value;
+    pBuff[1] = (uint8_t)(value >> 8);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void* SYS_MEMTRACK_AllocFrom(size_t size, SYS_MEMTRACK_TAG tag, const void *caller)
+{
+    SYS_MEMTRACK_HDR *pHdr;
+    SYS_MEMTRACK_TAG_STATS *pStats;
+
+    if (tag >= SYS_MEMTRACK_TAG_COUNT)
+    {
+        tag = SYS_MEMTRACK_TAG_OTHER;
+    }
+    pStats = gMemTrack.tags + tag;
+
+    SYS_MEMTRACK_LOCK();
+
+    if (size > UINT32_MAX - SYS_MEMTRACK_HDR_SIZE)
+    {
+        pHdr = NULL;
+    }
+    else
+    {
+        pHdr = (SYS_MEMTRACK_HDR*)malloc(SYS_MEMTRACK_HDR_SIZE + size);
+    }
+
+    if (pHdr == NULL)
+    {
+        pStats->failures++;
+        _SYS_MEMTRACK_Record(SYS_MEMTRACK_EVENT_FAIL, tag, (uint32_t)size, caller);
+        SYS_MEMTRACK_UNLOCK();
+        return NULL;
+    }
+
+    pHdr->caller = caller;
+    pHdr->size = (uint32_t)size;
+    pHdr->seq = ++gMemTrack.seq;
+    pHdr->check = SYS_MEMTRACK_CHECK ^ (uint32_t)(uintptr_t)pHdr;
+    pHdr->tag = (uint8_t)tag;
+
+    pHdr->prev = NULL;
+    pHdr->next = gMemTrack.liveList;
+    if (gMemTrack.liveList != NULL)
+    {
+        gMemTrack.liveList->prev = pHdr;
+    }
+    gMemTrack.liveList = pHdr;
+
+    pStats->allocs++;
+    pStats->liveBlocks++;
+    pStats->liveBytes += size;
+    if (pStats->liveBytes > pStats->peakBytes)
+    {
+        pStats->peakBytes = pStats->liveBytes;
+    }
+
+    gMemTrack.liveBytes += size;
+    if (gMemTrack.liveBytes > gMemTrack.peakBytes)
+    {
+        gMemTrack.peakBytes = gMemTrack.liveBytes;
+    }
+
+    _SYS_MEMTRACK_Record(SYS_MEMTRACK_EVENT_ALLOC, tag, (uint32_t)size, caller);
+
+    SYS_MEMTRACK_UNLOCK();
+
+    return (uint8_t*)pHdr + SYS_MEMTRACK_HDR_SIZE;
+}
+
+__attribute__((noinline)) void* SYS_MEMTRACK_Malloc(size_t size, SYS_MEMTRACK_TAG tag)
+{
+    return SYS_MEMTRACK_AllocFrom(size, tag, __builtin_return_address(0));
+}
+
+__attribute__((noinline)) void* SYS_MEMTRACK_Calloc(size_t nElems, size_t elemSize, SYS_MEMTRACK_TAG tag)
+{
+    void *ptr;
+    size_t size = nElems * elemSize;
+
+    if (elemSize != 0 && nElems > SIZE_MAX / elemSize)
+    {   // overflow: accounted as a failed allocation
+        size = SIZE_MAX;
+    }
+
+    ptr = SYS_MEMTRACK_AllocFrom(size, tag, __builtin_return_address(0));
+    if (ptr != NULL)
+    {
+        memset(ptr, 0, size);
+    }
+
+    return ptr;
+}
+
+void SYS_MEMTRACK_Free(void *ptr)
+{
+    SYS_MEMTRACK_HDR *pHdr;
+    SYS_MEMTRACK_TAG_STATS *pStats;
+
+    if (ptr == NULL)
+    {
+        return;
+    }
+
+    pHdr = (SYS_MEMTRACK_HDR*)((uint8_t*)ptr - SYS_MEMTRACK_HDR_SIZE);
+
+    SYS_MEMTRACK_LOCK();
+
+    if (pHdr->check != (SYS_MEMTRACK_CHECK ^ (uint32_t)(uintptr_t)pHdr) || pHdr->tag >= SYS_MEMTRACK_TAG_COUNT)
+    {   // not allocated by the service
+        gMemTrack.foreignFrees++;
+        free(ptr);
+        SYS_MEMTRACK_UNLOCK();
+        return;
+    }
+
+    if (pHdr->prev != NULL)
+    {
+        pHdr->prev->next = pHdr->next;
+    }
+    else
+    {
+        gMemTrack.liveList = pHdr->next;
+    }
+    if (pHdr->next != NULL)
+    {
+        pHdr->next->prev = pHdr->prev;
+    }
+
+    pStats = gMemTrack.tags + pHdr->tag;
+    pStats->frees++;
+    pStats->liveBlocks--;
+    pStats->liveBytes -= pHdr->size;
+    gMemTrack.liveBytes -= pHdr->size;
+
+    _SYS_MEMTRACK_Record(SYS_MEMTRACK_EVENT_FREE, pHdr->tag, pHdr->size, pHdr->caller);
+
+    /* Catches a double free */
+    pHdr->check = 0;
+    free(pHdr);
+
+    SYS_MEMTRACK_UNLOCK();
+}
+
+__attribute__((noinline)) void* SYS_MEMTRACK_TCPIP_Malloc(size_t size)
+{
+    return SYS_MEMTRACK_AllocFrom(size, SYS_MEMTRACK_TAG_TCPIP, __builtin_return_address(0));
+}
+
+__attribute__((noinline)) void* SYS_MEMTRACK_TCPIP_Calloc(size_t nElems, size_t elemSize)
+{
+    void *ptr;
+    size_t size = nElems * elemSize;
+
+    if (elemSize != 0 && nElems > SIZE_MAX / elemSize)
+    {   // overflow: accounted as a failed allocation
+        size = SIZE_MAX;
+    }
+
+    ptr = SYS_MEMTRACK_AllocFrom(size, SYS_MEMTRACK_TAG_TCPIP, __builtin_return_address(0));
+    if (ptr != NULL)
+    {
+        memset(ptr, 0, size);
+    }
+
+    return ptr;
+}
+
+void SYS_MEMTRACK_TCPIP_Free(void *ptr)
+{
+    SYS_MEMTRACK_Free(ptr);
+}
+
+bool SYS_MEMTRACK_TagStats(SYS_MEMTRACK_TAG tag, SYS_MEMTRACK_TAG_STATS *pStats)
+{
+    if (tag >= SYS_MEMTRACK_TAG_COUNT || pStats == NULL)
+    {
+        return false;
+    }
+
+    SYS_MEMTRACK_LOCK();
+    *pStats = gMemTrack.tags[tag];
+    SYS_MEMTRACK_UNLOCK();
+
+    return true;
+}
+
+const char* SYS_MEMTRACK_TagName(SYS_MEMTRACK_TAG tag)
+{
+    return tag < SYS_MEMTRACK_TAG_COUNT ? gMemTrackTagNames[tag] : "?";
+}
+
+uint32_t SYS_MEMTRACK_LiveBytes(void)
+{
+    return gMemTrack.liveBytes;
+}
+
+uint32_t SYS_MEMTRACK_PeakBytes(void)
+{
+    return gMemTrack.peakBytes;
+}
+
+uint32_t SYS_MEMTRACK_Mark(void)
+{
+    return gMemTrack.seq;
+}
+
+size_t SYS_MEMTRACK_Leaks(SYS_MEMTRACK_TAG tag, uint32_t mark, SYS_MEMTRACK_BLOCK_INFO *pLeaks, size_t maxLeaks)
+{
+    SYS_MEMTRACK_HDR *pHdr;
+    size_t nLeaks = 0;
+
+    SYS_MEMTRACK_LOCK();
+
+    for (pHdr = gMemTrack.liveList; pHdr != NULL; pHdr = pHdr->next)
+    {
+        if (pHdr->seq <= mark || (tag != SYS_MEMTRACK_TAG_ANY && pHdr->tag != tag))
+        {
+            continue;
+        }
+
+        if (nLeaks < maxLeaks)
+        {
+            pLeaks[nLeaks].ptr = (uint8_t*)pHdr + SYS_MEMTRACK_HDR_SIZE;
+            pLeaks[nLeaks].caller = pHdr->caller;
+            pLeaks[nLeaks].size = pHdr->size;
+            pLeaks[nLeaks].seq = pHdr->seq;
+            pLeaks[nLeaks].tag = pHdr->tag;
+        }
+        nLeaks++;
+    }
+
+    SYS_MEMTRACK_UNLOCK();
+
+    return nLeaks;
+}
+
+size_t SYS_MEMTRACK_Sites(SYS_MEMTRACK_SITE *pSites, size_t maxSites)
+{
+    SYS_MEMTRACK_HDR *pHdr;
+    SYS_MEMTRACK_SITE *pSite;
+    size_t nSites = 0;
+    size_t ix, jx, best;
+
+    SYS_MEMTRACK_LOCK();
+
+    for (pHdr = gMemTrack.liveList; pHdr != NULL; pHdr = pHdr->next)
+    {
+        for (ix = 0; ix < nSites; ix++)
+        {
+            pSite = gMemTrackSites + ix;
+            if (pSite->caller == pHdr->caller && pSite->tag == pHdr->tag)
+            {
+                break;
+            }
+        }
+
+        if (ix == nSites)
+        {
+            if (nSites == SYS_MEMTRACK_SITE_TABLE_SIZE)
+            {   // table full: account to the last entry
+                ix = nSites - 1;
+                gMemTrackSites[ix].caller = NULL;
+            }
+            else
+            {
+                gMemTrackSites[ix].caller = pHdr->caller;
+                gMemTrackSites[ix].tag = pHdr->tag;
+                gMemTrackSites[ix].bytes = 0;
+                gMemTrackSites[ix].blocks = 0;
+                nSites++;
+            }
+        }
+
+        gMemTrackSites[ix].bytes += pHdr->size;
+        gMemTrackSites[ix].blocks++;
+    }
+
+    /* Selection of the largest sites */
+    for (ix = 0; ix < maxSites && ix < nSites; ix++)
+    {
+        best = ix;
+        for (jx = ix + 1; jx < nSites; jx++)
+        {
+            if (gMemTrackSites[jx].bytes > gMemTrackSites[best].bytes)
+            {
+                best = jx;
+            }
+        }
+
+        pSites[ix] = gMemTrackSites[best];
+        gMemTrackSites[best] = gMemTrackSites[ix];
+    }
+
+    SYS_MEMTRACK_UNLOCK();
+
+    return ix;
+}
+
+size_t SYS_MEMTRACK_Dump(SYS_MEMTRACK_WRITE_FUNC writeFunc, void *param)
+{
+    SYS_MEMTRACK_TAG_STATS tags[SYS_MEMTRACK_TAG_COUNT];
+    SYS_MEMTRACK_SITE sites[SYS_MEMTRACK_MAX_SITES];
+    uint8_t record[SYS_MEMTRACK_DUMP_HEADER_SIZE];
+    uint32_t peakBytes, droppedEvents, foreignFrees;
+    uint16_t eventCount, eventIx;
+    size_t nSites, ix;
+    size_t written = 0;
+
+    nSites = SYS_MEMTRACK_Sites(sites, SYS_MEMTRACK_MAX_SITES);
+
+    /* The timeline is not changed until the dump is done */
+    SYS_MEMTRACK_LOCK();
+    gMemTrack.frozen = true;
+    memcpy(tags, gMemTrack.tags, sizeof(tags));
+    peakBytes = gMemTrack.peakBytes;
+    droppedEvents = gMemTrack.droppedEvents;
+    foreignFrees = gMemTrack.foreignFrees;
+    eventCount = gMemTrack.eventCount;
+    eventIx = (gMemTrack.eventHead + SYS_MEMTRACK_EVENT_LOG_SIZE - eventCount) % SYS_MEMTRACK_EVENT_LOG_SIZE;
+    SYS_MEMTRACK_UNLOCK();
+
+    _SYS_MEMTRACK_Put32(record + 0, SYS_MEMTRACK_DUMP_MAGIC);
+    _SYS_MEMTRACK_Put16(record + 4, SYS_MEMTRACK_DUMP_VERSION);
+    _SYS_MEMTRACK_Put16(record + 6, SYS_MEMTRACK_TAG_COUNT);
+    _SYS_MEMTRACK_Put16(record + 8, (uint16_t)nSites);
+    _SYS_MEMTRACK_Put16(record + 10, eventCount);
+    _SYS_MEMTRACK_Put32(record + 12, SYS_MEMTRACK_TICK_RATE);
+    _SYS_MEMTRACK_Put32(record + 16, SYS_MEMTRACK_HEAP_SIZE);
+    _SYS_MEMTRACK_Put32(record + 20, peakBytes);
+    _SYS_MEMTRACK_Put32(record + 24, droppedEvents);
+    _SYS_MEMTRACK_Put32(record + 28, foreignFrees);
+    writeFunc(record, SYS_MEMTRACK_DUMP_HEADER_SIZE, param);
+    written += SYS_MEMTRACK_DUMP_HEADER_SIZE;
+
+    for (ix = 0; ix < SYS_MEMTRACK_TAG_COUNT; ix++)
+    {
+        _SYS_MEMTRACK_Put32(record + 0, tags[ix].liveBytes);
+        _SYS_MEMTRACK_Put32(record + 4, tags[ix].peakBytes);
+        _SYS_MEMTRACK_Put32(record + 8, tags[ix].liveBlocks);
+        _SYS_MEMTRACK_Put32(record + 12, tags[ix].allocs);
+        _SYS_MEMTRACK_Put32(record + 16, tags[ix].frees);
+        _SYS_MEMTRACK_Put32(record + 20, tags[ix].failures);
+        writeFunc(record, SYS_MEMTRACK_DUMP_TAG_SIZE, param);
+        written += SYS_MEMTRACK_DUMP_TAG_SIZE;
+    }
+
+    for (ix = 0; ix < nSites; ix++)
+    {
+        _SYS_MEMTRACK_Put32(record + 0, (uint32_t)(uintptr_t)sites[ix].caller);
+        _SYS_MEMTRACK_Put32(record + 4, sites[ix].bytes);
+        _SYS_MEMTRACK_Put16(record + 8, sites[ix].blocks);
+        record[10] = sites[ix].tag;
+        record[11] = 0;
+        writeFunc(record, SYS_MEMTRACK_DUMP_SITE_SIZE, param);
+        written += SYS_MEMTRACK_DUMP_SITE_SIZE;
+    }
+
+    for (; eventCount != 0; eventCount--)
+    {
+        const SYS_MEMTRACK_EVENT *pEvent = gMemTrack.events + eventIx;
+
+        _SYS_MEMTRACK_Put32(record + 0, pEvent->tick);
+        _SYS_MEMTRACK_Put32(record + 4, (uint32_t)(uintptr_t)pEvent->caller);
+        _SYS_MEMTRACK_Put32(record + 8, pEvent->size);
+        _SYS_MEMTRACK_Put32(record + 12, pEvent->tagLiveBytes);
+        record[16] = pEvent->tag;
+        record[17] = pEvent->kind;
+        _SYS_MEMTRACK_Put16(record + 18, 0);
+        writeFunc(record, SYS_MEMTRACK_DUMP_EVENT_SIZE, param);
+        written += SYS_MEMTRACK_DUMP_EVENT_SIZE;
+
+        if (++eventIx == SYS_MEMTRACK_EVENT_LOG_SIZE)
+        {
+            eventIx = 0;
+        }
+    }
+
+    SYS_MEMTRACK_LOCK();
+    gMemTrack.frozen = false;
+    SYS_MEMTRACK_UNLOCK();
+
+    return written;
+}
+
+void SYS_MEMTRACK_Reset(void)
+{
+    size_t ix;
+
+    SYS_MEMTRACK_LOCK();
+
+    for (ix = 0; ix < SYS_MEMTRACK_TAG_COUNT; ix++)
+    {
+        gMemTrack.tags[ix].peakBytes = gMemTrack.tags[ix].liveBytes;
+    }
+    gMemTrack.peakBytes = gMemTrack.liveBytes;
+    gMemTrack.eventHead = 0;
+    gMemTrack.eventCount = 0;
+    gMemTrack.droppedEvents = 0;
+
+    SYS_MEMTRACK_UNLOCK();
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Console Command
+// *****************************************************************************
+// *****************************************************************************
+
+#ifdef SYS_MEMTRACK_CLICMD_ENABLED
+
+/* Dump line: 32 bytes as hex */
+#define SYS_MEMTRACK_DUMP_LINE_SIZE     32
+
+typedef struct
+{
+    SYS_CMD_DEVICE_NODE* pCmdIO;
+    uint8_t line[SYS_MEMTRACK_DUMP_LINE_SIZE];
+    size_t lineLen;
+} SYS_MEMTRACK_DUMP_PRINTER;
+
+static void _SYS_MEMTRACK_PrintLine(SYS_MEMTRACK_DUMP_PRINTER *pPrinter)
+{
+    char hex[2 * SYS_MEMTRACK_DUMP_LINE_SIZE + 1];
+    static const char digits[] = "0123456789abcdef";
+    size_t ix;
+
+    for (ix = 0; ix < pPrinter->lineLen; ix++)
+    {
+        hex[2 * ix] = digits[pPrinter->line[ix] >> 4];
+        hex[2 * ix + 1] = digits[pPrinter->line[ix] & 0x0F];
+    }
+    hex[2 * ix] = 0;
+
+    (*pPrinter->pCmdIO->pCmdApi->print)(pPrinter->pCmdIO->cmdIoParam, "%s\r\n", hex);
+    pPrinter->lineLen = 0;
+}
+
+static void _SYS_MEMTRACK_DumpWrite(const uint8_t *data, size_t size, void *param)
+{
+    SYS_MEMTRACK_DUMP_PRINTER *pPrinter = (SYS_MEMTRACK_DUMP_PRINTER*)param;
+
+    while (size--)
+    {
+        pPrinter->line[pPrinter->lineLen++] = *data++;
+        if (pPrinter->lineLen == SYS_MEMTRACK_DUMP_LINE_SIZE)
+        {
+            _SYS_MEMTRACK_PrintLine(pPrinter);
+        }
+    }
+}
+
+static int _Command_MemTrack(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
+{
+    const void* cmdIoParam = pCmdIO->cmdIoParam;
+    SYS_MEMTRACK_TAG_STATS stats;
+    size_t ix;
+
+    if (argc < 2 || strcmp(argv[1], "stats") == 0)
+    {
+        (*pCmdIO->pCmdApi->print)(cmdIoParam, "tag       live     peak   blocks   allocs    frees  fails\r\n");
+        for (ix = 0; ix < SYS_MEMTRACK_TAG_COUNT; ix++)
+        {
+            SYS_MEMTRACK_TagStats((SYS_MEMTRACK_TAG)ix, &stats);
+            (*pCmdIO->pCmdApi->print)(cmdIoParam, "%-6s %7lu  %7lu  %7lu  %7lu  %7lu  %5lu\r\n",
+                    SYS_MEMTRACK_TagName((SYS_MEMTRACK_TAG)ix), (unsigned long)stats.liveBytes,
+                    (unsigned long)stats.peakBytes, (unsigned long)stats.liveBlocks,
+                    (unsigned long)stats.allocs, (unsigned long)stats.frees, (unsigned long)stats.failures);
+        }
+        (*pCmdIO->pCmdApi->print)(cmdIoParam, "total  %7lu  %7lu  of %lu heap bytes\r\n",
+                (unsigned long)SYS_MEMTRACK_LiveBytes(), (unsigned long)SYS_MEMTRACK_PeakBytes(),
+                (unsigned long)SYS_MEMTRACK_HEAP_SIZE);
+    }
+    else if (strcmp(argv[1], "sites") == 0)
+    {
+        SYS_MEMTRACK_SITE sites[SYS_MEMTRACK_MAX_SITES];
+        size_t nSites = SYS_MEMTRACK_Sites(sites, SYS_MEMTRACK_MAX_SITES);
+
+        (*pCmdIO->pCmdApi->print)(cmdIoParam, "caller      tag      bytes  blocks\r\n");
+        for (ix = 0; ix < nSites; ix++)
+        {
+            (*pCmdIO->pCmdApi->print)(cmdIoParam, "0x%08lx  %-6s %7lu  %6u\r\n",
+                    (unsigned long)(uintptr_t)sites[ix].caller, SYS_MEMTRACK_TagName((SYS_MEMTRACK_TAG)sites[ix].tag),
+                    (unsigned long)sites[ix].bytes, sites[ix].blocks);
+        }
+    }
+    else if (strcmp(argv[1], "dump") == 0)
+    {
+        SYS_MEMTRACK_DUMP_PRINTER printer;
+        size_t size;
+
+        printer.pCmdIO = pCmdIO;
+        printer.lineLen = 0;
+        (*pCmdIO->pCmdApi->msg)(cmdIoParam, "MEMTRACK-DUMP-BEGIN\r\n");
+        size = SYS_MEMTRACK_Dump(_SYS_MEMTRACK_DumpWrite, &printer);
+        if (printer.lineLen != 0)
+        {
+            _SYS_MEMTRACK_PrintLine(&printer);
+        }
+        (*pCmdIO->pCmdApi->print)(cmdIoParam, "MEMTRACK-DUMP-END %lu\r\n", (unsigned long)size);
+    }
+    else if (strcmp(argv[1], "reset") == 0)
+    {
+        SYS_MEMTRACK_Reset();
+    }
+    else
+    {
+        (*pCmdIO->pCmdApi->msg)(cmdIoParam, "Usage: memtrack [stats|sites|dump|reset]\r\n");
+        return false;
+    }
+
+    return true;
+}
+
+static const SYS_CMD_DESCRIPTOR gMemTrackCmdTbl[] =
+{
+    {"memtrack", (SYS_CMD_FNC)_Command_MemTrack, ": heap usage per tag [stats|sites|dump|reset]"},
+};
+
+#endif  // SYS_MEMTRACK_CLICMD_ENABLED
+
+void SYS_MEMTRACK_Initialize(void)
+{
+#ifdef SYS_MEMTRACK_CLICMD_ENABLED
+    SYS_CMD_ADDGRP(gMemTrackCmdTbl, sizeof(gMemTrackCmdTbl) / sizeof(*gMemTrackCmdTbl), "memtrack", ": memory tracking commands");
+#endif
+}
@@ -0,0 +1,282 @@
+/*******************************************************************************
+  Memory Tracking System Service
+
+  File Name:
+    sys_memtrack.h
+
+  Summary:
+    Tagged accounting of the heap allocations.
+
+  Description:
+    FreeRTOS (heap_3), the OSAL, the TCP/IP external heap, wolfSSL and the FFS
+    user context all allocate from the single linker heap. The memory tracking
+    service sits between these allocators and the C library heap and keeps,
+    for every subsystem tag, the live and peak bytes, the allocation call
+    sites and a timeline of the allocations.
+
+    Every tracked block is preceded by a small header that links it into the
+    live block list. A block can be freed through any of the tracked free
+    functions; a block that was not allocated by the service is handed back to
+    the C library free() unchanged.
+
+    The statistics are printed by the "memtrack" console command, which can
+    also dump them in a binary format rendered on the host by
+    tools/memtrack-report.py.
+ *******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+Copyright (C) 2020 released Microchip Technology Inc.  All rights reserved.
+
+Microchip licenses to you the right to use, modify, copy and distribute
+Software only when embedded on a Microchip microcontroller or digital signal
+controller that is integrated into your product or third party product
+(pursuant to the sublicense terms in the accompanying license agreement).
+
+You should refer to the license agreement accompanying this Software for
+additional information regarding your rights and obligations.
+
+SOFTWARE AND DOCUMENTATION ARE PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF
+MERCHANTABILITY, TITLE, NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE.
+IN NO EVENT SHALL MICROCHIP OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER
+CONTRACT, NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR
+OTHER LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR
+CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT OF
+SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+(INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef _SYS_MEMTRACK_H
+#define _SYS_MEMTRACK_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+    extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Constants
+// *****************************************************************************
+// *****************************************************************************
+
+/* Number of allocation events kept for the timeline */
+#ifndef SYS_MEMTRACK_EVENT_LOG_SIZE
+#define SYS_MEMTRACK_EVENT_LOG_SIZE     256
+#endif
+
+/* Number of call sites reported by SYS_MEMTRACK_Sites() in the dump */
+#ifndef SYS_MEMTRACK_MAX_SITES
+#define SYS_MEMTRACK_MAX_SITES          16
+#endif
+
+/* Size of the linker heap, reported in the dump */
+#ifndef SYS_MEMTRACK_HEAP_SIZE
+#define SYS_MEMTRACK_HEAP_SIZE          0
+#endif
+
+/* Binary dump identification */
+#define SYS_MEMTRACK_DUMP_MAGIC         0x4B52544DUL    // "MTRK"
+#define SYS_MEMTRACK_DUMP_VERSION       1
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Allocation tags
+
+  Summary:
+    Subsystem an allocation is accounted to.
+*/
+typedef enum
+{
+    // Allocations without a more specific tag
+    SYS_MEMTRACK_TAG_OTHER = 0,
+
+    // pvPortMalloc(): FreeRTOS objects and direct users
+    SYS_MEMTRACK_TAG_RTOS,
+
+    // OSAL_Malloc() users
+    SYS_MEMTRACK_TAG_OSAL,
+
+    // TCP/IP stack external heap
+    SYS_MEMTRACK_TAG_TCPIP,
+
+    // wolfSSL XMALLOC()
+    SYS_MEMTRACK_TAG_TLS,
+
+    // FFS user context and configuration map
+    SYS_MEMTRACK_TAG_FFS,
+
+    SYS_MEMTRACK_TAG_COUNT,
+
+    // Any tag, for SYS_MEMTRACK_Leaks()
+    SYS_MEMTRACK_TAG_ANY = 0xFF,
+} SYS_MEMTRACK_TAG;
+
+// *****************************************************************************
+/* Allocation event kinds
+
+  Summary:
+    Kind of a timeline event in the binary dump.
+*/
+typedef enum
+{
+    SYS_MEMTRACK_EVENT_ALLOC = 0,
+    SYS_MEMTRACK_EVENT_FREE,
+    SYS_MEMTRACK_EVENT_FAIL,
+} SYS_MEMTRACK_EVENT_KIND;
+
+// *****************************************************************************
+/* Tag statistics
+
+  Summary:
+    Accounting of one tag, returned by SYS_MEMTRACK_TagStats().
+
+  Remarks:
+    The bytes are the requested sizes, without the tracking header.
+*/
+typedef struct
+{
+    uint32_t liveBytes;
+    uint32_t peakBytes;
+    uint32_t liveBlocks;
+    uint32_t allocs;
+    uint32_t frees;
+    uint32_t failures;
+} SYS_MEMTRACK_TAG_STATS;
+
+// *****************************************************************************
+/* Call site
+
+  Summary:
+    Live allocations of one call site, returned by SYS_MEMTRACK_Sites().
+*/
+typedef struct
+{
+    const void *caller;
+    uint32_t bytes;
+    uint16_t blocks;
+    uint8_t tag;
+} SYS_MEMTRACK_SITE;
+
+// *****************************************************************************
+/* Live block
+
+  Summary:
+    Block still allocated, returned by SYS_MEMTRACK_Leaks().
+*/
+typedef struct
+{
+    const void *ptr;
+    const void *caller;
+    uint32_t size;
+    uint32_t seq;
+    uint8_t tag;
+} SYS_MEMTRACK_BLOCK_INFO;
+
+// *****************************************************************************
+/* Dump writer
+
+  Summary:
+    Receives the binary dump of SYS_MEMTRACK_Dump() in pieces.
+
+  Remarks:
+    Called outside of the tracking lock, so it can block and print.
+*/
+typedef void (*SYS_MEMTRACK_WRITE_FUNC)(const uint8_t *data, size_t size, void *param);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Registers the "memtrack" console command. The allocations are tracked
+   from reset, before this call. */
+void SYS_MEMTRACK_Initialize(void);
+
+/* Tracked allocation accounted to the tag and to the given call site */
+void* SYS_MEMTRACK_AllocFrom(size_t size, SYS_MEMTRACK_TAG tag, const void *caller);
+
+/* Tracked allocations accounted to the tag and to the caller */
+void* SYS_MEMTRACK_Malloc(size_t size, SYS_MEMTRACK_TAG tag);
+void* SYS_MEMTRACK_Calloc(size_t nElems, size_t elemSize, SYS_MEMTRACK_TAG tag);
+
+/* Frees a tracked block, or hands an untracked one to free() */
+void SYS_MEMTRACK_Free(void *ptr);
+
+/* TCP/IP external heap allocation functions (TCPIP_STACK_MALLOC_FUNC...) */
+void* SYS_MEMTRACK_TCPIP_Malloc(size_t size);
+void* SYS_MEMTRACK_TCPIP_Calloc(size_t nElems, size_t elemSize);
+void SYS_MEMTRACK_TCPIP_Free(void *ptr);
+
+/* Statistics of a tag; false for an invalid tag */
+bool SYS_MEMTRACK_TagStats(SYS_MEMTRACK_TAG tag, SYS_MEMTRACK_TAG_STATS *pStats);
+
+/* Name of a tag, "?" for an invalid one */
+const char* SYS_MEMTRACK_TagName(SYS_MEMTRACK_TAG tag);
+
+/* Live and peak bytes of all the tags */
+uint32_t SYS_MEMTRACK_LiveBytes(void);
+uint32_t SYS_MEMTRACK_PeakBytes(void);
+
+/* Allocation sequence number, to be passed to SYS_MEMTRACK_Leaks() */
+uint32_t SYS_MEMTRACK_Mark(void);
+
+/* Fills up to maxLeaks blocks of the tag (or SYS_MEMTRACK_TAG_ANY)
+   allocated since the mark and still live. Returns the number of such
+   blocks, which can exceed maxLeaks. */
+size_t SYS_MEMTRACK_Leaks(SYS_MEMTRACK_TAG tag, uint32_t mark, SYS_MEMTRACK_BLOCK_INFO *pLeaks, size_t maxLeaks);
+
+/* Fills up to maxSites call sites holding the most live bytes, largest
+   first. Returns the number of sites filled. */
+size_t SYS_MEMTRACK_Sites(SYS_MEMTRACK_SITE *pSites, size_t maxSites);
+
+/* Writes the binary dump: header, tag statistics, call sites and the
+   timeline. The timeline is not recorded while the dump is written.
+   Returns the number of bytes written. */
+size_t SYS_MEMTRACK_Dump(SYS_MEMTRACK_WRITE_FUNC writeFunc, void *param);
+
+/* Restarts the peaks from the live bytes and clears the timeline */
+void SYS_MEMTRACK_Reset(void);
+
+// *****************************************************************************
+/* Tracked allocation in the optional users
+
+  Summary:
+    Allocate through the service when SYS_MEMTRACK_ENABLED, otherwise
+    through the C library.
+*/
+#ifdef SYS_MEMTRACK_ENABLED
+#define SYS_MEMTRACK_MALLOC(size, tag)  SYS_MEMTRACK_Malloc((size), (tag))
+#define SYS_MEMTRACK_FREE(ptr)          SYS_MEMTRACK_Free((ptr))
+#else
+#define SYS_MEMTRACK_MALLOC(size, tag)  malloc((size))
+#define SYS_MEMTRACK_FREE(ptr)          free((ptr))
+#endif
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif // _SYS_MEMTRACK_H
@@ -52,10 +52,20 @@ typedef struct
     NET_PRES_SKT_T sock_type;
     IP_ADDRESS_TYPE addr_type;
     SYS_NET_TimerInfo timerInfo;
+#ifdef SYS_NET_MUX_ENABLED
+    volatile uint16_t pendingSignals; /* TCP/IP signals not yet handled by the service task */
+    volatile uint8_t readiness; /* SYS_NET_READY flags */
+    volatile bool closePending; /* SYS_NET_Close() called from a callback on the service task */
+#endif
 } SYS_NET_Handle;
 
 static SYS_NET_Handle g_asSysNetHandle[SYS_NET_MAX_NUM_OF_SOCKETS];
 static OSAL_SEM_HANDLE_TYPE g_SysNetSemaphore; /* Semaphore for Critical Section */
+#ifdef SYS_NET_MUX_ENABLED
+static OSAL_SEM_HANDLE_TYPE g_SysNetMuxEvent; /* Signaled to wake up the service task */
+static OSAL_MUTEX_HANDLE_TYPE g_SysNetMuxLock; /* Held by the service task while it runs an instance */
+static TaskHandle_t g_SysNetMuxTask; /* Service task running SYS_NET_MUX_Tasks() */
+#endif
 uint32_t g_u32SysNetInitDone = 0;
 
 #ifdef SYS_NET_ENABLE_DEBUG_PRINT
@@ -101,9 +111,52 @@ SYS_MODULE_OBJ g_NetAppDbgHdl;
 #define SYS_NET_PERIOIDC_TIMEOUT   30 //Sec
 #define SYS_NET_TIMEOUT_CONST (SYS_NET_PERIOIDC_TIMEOUT * SYS_TMR_TickCounterFrequencyGet())
 
+#ifdef SYS_NET_MUX_ENABLED
+static void SYS_NET_SetReadiness(SYS_NET_Handle *hdl, uint8_t set, uint8_t clear)
+{
+    OSAL_CRITSECT_DATA_TYPE critSect = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+
+    hdl->readiness = (hdl->readiness & ~clear) | set;
+
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critSect);
+}
+
+static void SYS_NET_StatusReadiness(SYS_NET_Handle *hdl, SYS_NET_STATUS status)
+{
+    switch (status)
+    {
+    case SYS_NET_STATUS_CONNECTED:
+        SYS_NET_SetReadiness(hdl, SYS_NET_READY_CONNECTED | SYS_NET_READY_WRITABLE, SYS_NET_READY_CLOSED);
+        break;
+
+    case SYS_NET_STATUS_PEER_SENT_FIN:
+        /* Pending data can still be read */
+        SYS_NET_SetReadiness(hdl, SYS_NET_READY_CLOSED, SYS_NET_READY_CONNECTED | SYS_NET_READY_WRITABLE);
+        break;
+
+    default:
+        if (hdl->readiness & SYS_NET_READY_CONNECTED)
+        {
+            SYS_NET_SetReadiness(hdl, SYS_NET_READY_CLOSED, SYS_NET_READY_CONNECTED | SYS_NET_READY_READABLE | SYS_NET_READY_WRITABLE);
+        }
+        else
+        {
+            SYS_NET_SetReadiness(hdl, 0, SYS_NET_READY_READABLE | SYS_NET_READY_WRITABLE);
+        }
+        break;
+    }
+}
+#endif
+
 static inline void SYS_NET_SetInstStatus(SYS_NET_Handle *hdl, SYS_NET_STATUS status)
 {
     hdl->status = status;
+#ifdef SYS_NET_MUX_ENABLED
+    SYS_NET_StatusReadiness(hdl, status);
+
+    /* Let the service task act on the new state */
+    OSAL_SEM_Post(&g_SysNetMuxEvent);
+#endif
     SYS_NETDEBUG_INFO_PRINT(g_NetAppDbgHdl, NET_CFG, "Handle (0x%p) State (%s)\r\n", hdl, SYS_NET_GET_STATUS_STR(status));
 }
 
@@ -482,6 +535,22 @@ int32_t SYS_NET_Initialize()
         return SYS_NET_FAILURE;
     }
 
+#ifdef SYS_NET_MUX_ENABLED
+    /* Create Semaphore for waking up the service task on TCP/IP signals */
+    if (OSAL_SEM_Create(&g_SysNetMuxEvent, OSAL_SEM_TYPE_BINARY, 1, 0) != OSAL_RESULT_TRUE)
+    {
+        SYS_CONSOLE_MESSAGE("NET_SRVC: Failed to Initialize Service as Mux Semaphore NOT created\r\n");
+        return SYS_NET_FAILURE;
+    }
+
+    /* Create Mutex for serializing SYS_NET_Close() with the service task */
+    if (OSAL_MUTEX_Create(&g_SysNetMuxLock) != OSAL_RESULT_TRUE)
+    {
+        SYS_CONSOLE_MESSAGE("NET_SRVC: Failed to Initialize Service as Mux Mutex NOT created\r\n");
+        return SYS_NET_FAILURE;
+    }
+#endif
+
 #ifdef SYS_NET_CLICMD_ENABLED	
     /* Add Sys NET Commands to System Command service */
     if (!SYS_CMD_ADDGRP(g_SysNetCmdTbl, sizeof (g_SysNetCmdTbl) / sizeof (*g_SysNetCmdTbl), "sysnet", ": Sys NET commands"))
@@ -501,6 +570,10 @@ void SYS_NET_Deinitialize()
 {
     /* Delete Semaphore */
     OSAL_SEM_Delete(&g_SysNetSemaphore);
+#ifdef SYS_NET_MUX_ENABLED
+    OSAL_SEM_Delete(&g_SysNetMuxEvent);
+    OSAL_MUTEX_Delete(&g_SysNetMuxLock);
+#endif
 }
 
 static void* SYS_NET_AllocHandle()
@@ -679,19 +752,63 @@ TCPIP_DNS_RESULT SYS_NET_DNS_Resolve(SYS_NET_Handle *hdl)
     return result;
 }
 
+#ifdef SYS_NET_MUX_ENABLED
+/*
+ ** Record the signal for the service task and wake it up.
+ ** Runs in the TCP/IP stack task context.
+ */
+static void SYS_NET_MUX_Signal(SYS_NET_Handle *hdl, uint16_t sigType)
+{
+    OSAL_CRITSECT_DATA_TYPE critSect;
+    uint16_t rxData = (hdl->cfg_info.ip_prot == SYS_NET_IP_PROT_TCP) ?
+        TCPIP_TCP_SIGNAL_RX_DATA : TCPIP_UDP_SIGNAL_RX_DATA;
+
+    critSect = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+
+    if (sigType & rxData)
+    {
+        hdl->readiness |= SYS_NET_READY_READABLE;
+    }
+
+    if (hdl->cfg_info.ip_prot == SYS_NET_IP_PROT_TCP)
+    {
+        /* Report TX space only to a writer that got SYS_NET_PUT_NOT_READY */
+        if ((sigType & TCPIP_TCP_SIGNAL_TX_SPACE) &&
+            ((hdl->readiness & (SYS_NET_READY_CONNECTED | SYS_NET_READY_WRITABLE)) == SYS_NET_READY_CONNECTED))
+        {
+            hdl->readiness |= SYS_NET_READY_WRITABLE;
+        }
+        else
+        {
+            sigType &= ~TCPIP_TCP_SIGNAL_TX_SPACE;
+        }
+    }
+
+    hdl->pendingSignals |= sigType;
+
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critSect);
+
+    OSAL_SEM_Post(&g_SysNetMuxEvent);
+}
+#endif
+
 void SYS_NET_NetPres_Signal(NET_PRES_SKT_HANDLE_T handle, NET_PRES_SIGNAL_HANDLE hNet,
                             uint16_t sigType, const void* param)
 {
+    SYS_NET_Handle *hdl = (SYS_NET_Handle *) param;
+
     /* Peer sent a FIN to close the connection */
-    if (sigType & TCPIP_TCP_SIGNAL_RX_FIN)
+    if ((hdl->cfg_info.ip_prot == SYS_NET_IP_PROT_TCP) && (sigType & TCPIP_TCP_SIGNAL_RX_FIN))
     {
-        SYS_NET_Handle *hdl = (SYS_NET_Handle *) param;
-
         SYS_NETDEBUG_DBG_PRINT(g_NetAppDbgHdl, NET_CFG, "Received FIN from Peer\r\n");
 
         if(hdl->status == SYS_NET_STATUS_CONNECTED)
             SYS_NET_SetInstStatus(hdl, SYS_NET_STATUS_PEER_SENT_FIN);
     }
+
+#ifdef SYS_NET_MUX_ENABLED
+    SYS_NET_MUX_Signal(hdl, sigType);
+#endif
 }
 
 bool SYS_NET_Set_Sock_Option(SYS_NET_Handle *hdl)
@@ -780,6 +897,12 @@ SYS_MODULE_OBJ SYS_NET_Open(SYS_NET_Config *cfg, SYS_NET_CALLBACK net_cb, void *
         return SYS_MODULE_OBJ_INVALID;
     }
 
+#ifdef SYS_NET_MUX_ENABLED
+    hdl->pendingSignals = 0;
+    hdl->readiness = 0;
+    hdl->closePending = false;
+#endif
+
     /* Copy the config info and the fn ptr into the Handle */
     if (cfg == NULL)
     {
@@ -1752,24 +1875,153 @@ static void SYS_NET_Server_Task(SYS_NET_Handle *hdl)
     return;
 }
 
-void SYS_NET_Task(SYS_MODULE_OBJ obj)
+static void SYS_NET_Inst_Close(SYS_NET_Handle *hdl)
 {
-    SYS_NET_Handle *hdl = (SYS_NET_Handle*) obj;
+    /* Close socket */
+    NET_PRES_SocketClose(hdl->socket);
+
+    /* Delete Semaphore */
+    OSAL_SEM_Delete(&hdl->InstSemaphore);
+
+    /* Free the handle */
+    SYS_NET_FreeHandle(hdl);
+}
 
+static void SYS_NET_Inst_Task(SYS_NET_Handle *hdl)
+{
+    if (hdl->cfg_info.mode == SYS_NET_MODE_CLIENT)
+    {
+        /* Client Mode */
+        SYS_NET_Client_Task(hdl);
+    }
+    else
+    {
+        /* Server Mode */
+        SYS_NET_Server_Task(hdl);
+    }
+}
+
+void SYS_NET_Task(SYS_MODULE_OBJ obj)
+{
+#ifdef SYS_NET_MUX_ENABLED
+    /* The instances are run by SYS_NET_MUX_Tasks() */
+    (void) obj;
+#else
     if (obj != SYS_MODULE_OBJ_INVALID)
     {
-        if (hdl->cfg_info.mode == SYS_NET_MODE_CLIENT)
+        SYS_NET_Inst_Task((SYS_NET_Handle*) obj);
+    }
+#endif
+}
+
+#ifdef SYS_NET_MUX_ENABLED
+/*
+ ** The handle status as seen by the service task; SYS_NET_AllocHandle() and
+ ** SYS_NET_FreeHandle() change it with g_SysNetSemaphore taken.
+ */
+static uint8_t SYS_NET_Inst_GetStatus(SYS_NET_Handle *hdl)
+{
+    uint8_t status;
+
+    OSAL_SEM_Pend(&g_SysNetSemaphore, OSAL_WAIT_FOREVER);
+    status = hdl->status;
+    OSAL_SEM_Post(&g_SysNetSemaphore);
+
+    return status;
+}
+
+/*
+ ** The socket signals only cover an established connection and a server
+ ** awaiting one; the other states need to be polled.
+ */
+static bool SYS_NET_MUX_NeedsPoll(SYS_NET_Handle *hdl)
+{
+    switch (SYS_NET_Inst_GetStatus(hdl))
+    {
+    case SYS_NET_STATUS_IDLE:
+    case SYS_NET_STATUS_CONNECTED:
+    case SYS_NET_STATUS_SERVER_AWAITING_CONNECTION:
+        return false;
+
+    default:
+        return true;
+    }
+}
+
+void SYS_NET_MUX_Tasks(void)
+{
+    uint32_t timeout = SYS_NET_MUX_IDLE_TIMEOUT;
+    uint16_t signals;
+    uint8_t i;
+
+    g_SysNetMuxTask = xTaskGetCurrentTaskHandle();
+
+    for (i = 0; i < SYS_NET_MAX_NUM_OF_SOCKETS; i++)
+    {
+        if (SYS_NET_MUX_NeedsPoll(&g_asSysNetHandle[i]))
         {
-            /* Client Mode */
-            SYS_NET_Client_Task(hdl);
+            timeout = SYS_NET_MUX_BUSY_TIMEOUT;
+            break;
         }
-        else
+    }
+
+    /* Wait for a TCP/IP signal, a state change or the poll timeout */
+    OSAL_SEM_Pend(&g_SysNetMuxEvent, timeout);
+
+    for (i = 0; i < SYS_NET_MAX_NUM_OF_SOCKETS; i++)
+    {
+        SYS_NET_Handle *hdl = &g_asSysNetHandle[i];
+        OSAL_CRITSECT_DATA_TYPE critSect;
+
+        /* SYS_NET_Close() from other tasks waits for the instance to be done */
+        OSAL_MUTEX_Lock(&g_SysNetMuxLock, OSAL_WAIT_FOREVER);
+
+        if (SYS_NET_Inst_GetStatus(hdl) == SYS_NET_STATUS_IDLE)
         {
-            /* Server Mode */
-            SYS_NET_Server_Task(hdl);
+            OSAL_MUTEX_Unlock(&g_SysNetMuxLock);
+            continue;
+        }
+
+        critSect = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+        signals = hdl->pendingSignals;
+        hdl->pendingSignals = 0;
+        OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critSect);
+
+        SYS_NET_Inst_Task(hdl);
+
+        /* TX space is only recorded after a SYS_NET_PUT_NOT_READY */
+        if ((hdl->cfg_info.ip_prot == SYS_NET_IP_PROT_TCP) &&
+            (signals & TCPIP_TCP_SIGNAL_TX_SPACE) && !hdl->closePending &&
+            (SYS_NET_Inst_GetStatus(hdl) == SYS_NET_STATUS_CONNECTED) && hdl->callback_fn)
+        {
+            hdl->callback_fn(SYS_NET_EVNT_WRITE_READY, NULL, hdl->cookie);
+        }
+
+        /* Deferred SYS_NET_Close() from a callback */
+        if (hdl->closePending)
+        {
+            hdl->closePending = false;
+
+            if (SYS_NET_Inst_GetStatus(hdl) != SYS_NET_STATUS_IDLE)
+            {
+                SYS_NET_Inst_Close(hdl);
+            }
         }
+
+        OSAL_MUTEX_Unlock(&g_SysNetMuxLock);
+    }
+}
+
+uint32_t SYS_NET_GetReadiness(SYS_MODULE_OBJ obj)
+{
+    if (obj == SYS_MODULE_OBJ_INVALID)
+    {
+        return 0;
     }
+
+    return ((SYS_NET_Handle*) obj)->readiness;
 }
+#endif
 
 int32_t SYS_NET_SendMsg(SYS_MODULE_OBJ obj, uint8_t *data, uint16_t len)
 {
@@ -1783,6 +2035,19 @@ int32_t SYS_NET_SendMsg(SYS_MODULE_OBJ obj, uint8_t *data, uint16_t len)
         return SYS_NET_INVALID_HANDLE;
     }
 
+#ifdef SYS_NET_MUX_ENABLED
+    /* Answer from the readiness without taking the semaphore */
+    if (!(hdl->readiness & SYS_NET_READY_CONNECTED))
+    {
+        return SYS_NET_SERVICE_DOWN;
+    }
+
+    if (!(hdl->readiness & SYS_NET_READY_WRITABLE))
+    {
+        return SYS_NET_PUT_NOT_READY;
+    }
+#endif
+
     if (SYS_NET_TakeSemaphore(hdl) == 0)
     {
         return SYS_NET_SEM_OPERATION_FAILURE;
@@ -1800,6 +2065,13 @@ int32_t SYS_NET_SendMsg(SYS_MODULE_OBJ obj, uint8_t *data, uint16_t len)
     wMaxPut = NET_PRES_SocketWriteIsReady(hdl->socket, len, len);
     if (wMaxPut == 0)
     {
+#ifdef SYS_NET_MUX_ENABLED
+        /* Set again, with a SYS_NET_EVNT_WRITE_READY, on TX space */
+        if (hdl->cfg_info.ip_prot == SYS_NET_IP_PROT_TCP)
+        {
+            SYS_NET_SetReadiness(hdl, 0, SYS_NET_READY_WRITABLE);
+        }
+#endif
         SYS_NET_GiveSemaphore(hdl);
         SYS_NETDEBUG_ERR_PRINT(g_NetAppDbgHdl, NET_DATA, "TCP/IP Write NOT ready\r\n");
         return SYS_NET_PUT_NOT_READY;
@@ -1931,14 +2203,28 @@ void SYS_NET_Close(SYS_MODULE_OBJ obj)
         return;
     }
 
-    /* Close socket */
-    NET_PRES_SocketClose(hdl->socket);
+#ifdef SYS_NET_MUX_ENABLED
+    if (xTaskGetCurrentTaskHandle() == g_SysNetMuxTask)
+    {
+        /* Called from a callback: the service task is still running the
+         * instance, so it closes it once the instance task returns */
+        hdl->closePending = true;
+        return;
+    }
 
-    /* Delete Semaphore */
-    OSAL_SEM_Delete(&hdl->InstSemaphore);
+    /* Wait until the service task is not running any instance */
+    OSAL_MUTEX_Lock(&g_SysNetMuxLock, OSAL_WAIT_FOREVER);
 
-    /* Free the handle */
-    SYS_NET_FreeHandle(hdl);
+    /* The service task may have freed it on a disconnect */
+    if (SYS_NET_Inst_GetStatus(hdl) != SYS_NET_STATUS_IDLE)
+    {
+        SYS_NET_Inst_Close(hdl);
+    }
+
+    OSAL_MUTEX_Unlock(&g_SysNetMuxLock);
+#else
+    SYS_NET_Inst_Close(hdl);
+#endif
 }
 
 SYS_NET_STATUS SYS_NET_GetStatus(SYS_MODULE_OBJ obj)
@@ -1963,6 +2249,17 @@ int32_t SYS_NET_RecvMsg(SYS_MODULE_OBJ obj, void *buffer, uint16_t length)
         return SYS_NET_INVALID_HANDLE;
     }
 
+#ifdef SYS_NET_MUX_ENABLED
+    /* Answer from the readiness without taking the semaphore */
+    if (!(hdl->readiness & SYS_NET_READY_READABLE))
+    {
+        return (hdl->readiness & SYS_NET_READY_CONNECTED) ? SYS_NET_GET_NOT_READY : SYS_NET_SERVICE_DOWN;
+    }
+
+    /* Cleared before reading so that a signal during the read sets it again */
+    SYS_NET_SetReadiness(hdl, 0, SYS_NET_READY_READABLE);
+#endif
+
     if (SYS_NET_TakeSemaphore(hdl) == 0)
     {
         return SYS_NET_SEM_OPERATION_FAILURE;
@@ -1993,6 +2290,13 @@ int32_t SYS_NET_RecvMsg(SYS_MODULE_OBJ obj, void *buffer, uint16_t length)
     /* Get Data from the NET Stack  */
     len = NET_PRES_SocketRead(hdl->socket, buffer, len);
 
+#ifdef SYS_NET_MUX_ENABLED
+    if (NET_PRES_SocketReadIsReady(hdl->socket))
+    {
+        SYS_NET_SetReadiness(hdl, SYS_NET_READY_READABLE, 0);
+    }
+#endif
+
     SYS_NET_GiveSemaphore(hdl);
 
     return len;
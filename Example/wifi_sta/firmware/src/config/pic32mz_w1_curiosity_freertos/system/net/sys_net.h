@@ -349,10 +349,39 @@ typedef enum
 
     // TCP Server is awaiting connection
     SYS_NET_EVNT_SERVER_AWAITING_CONNECTION,
+
+    // Received only in Multiplexed Mode - TX space available again after SYS_NET_PUT_NOT_READY
+    SYS_NET_EVNT_WRITE_READY,
 } SYS_NET_EVENT;
 
 // *****************************************************************************
 
+/* System NET Readiness values
+
+  Summary:
+    Identifies the readiness of the Sys Net Instance returned by SYS_NET_GetReadiness().
+
+  Remarks:
+    Only available in Multiplexed Mode (SYS_NET_MUX_ENABLED). The values are
+    bit flags and can be combined.
+ */
+typedef enum
+{
+    // NET Socket connected to Peer
+    SYS_NET_READY_CONNECTED = 0x01,
+
+    // Data available for SYS_NET_RecvMsg()
+    SYS_NET_READY_READABLE = 0x02,
+
+    // TX space available for SYS_NET_SendMsg()
+    SYS_NET_READY_WRITABLE = 0x04,
+
+    // Connection closed by the Peer or the Lower Layer
+    SYS_NET_READY_CLOSED = 0x08,
+} SYS_NET_READY;
+
+// *****************************************************************************
+
 /* System NET Control Message values
 
   Summary:
@@ -732,6 +761,12 @@ SYS_MODULE_OBJ SYS_NET_Open(SYS_NET_Config *cfg, SYS_NET_CALLBACK Net_cb, void *
   Remarks:
        Once the Open operation has been called, the Close operation must be 
            called before the Open operation can be called again.
+
+       In Multiplexed Mode (SYS_NET_MUX_ENABLED) the callbacks run on the
+       service task. Called from another task, this function waits until the
+       service task is done with the instance, so no callback runs once it
+       returns; the caller must not hold anything the callbacks wait for.
+       Called from a callback, the instance is closed when the callback returns.
  */
 
 void SYS_NET_Close(SYS_MODULE_OBJ);
@@ -768,6 +803,9 @@ void SYS_NET_Close(SYS_MODULE_OBJ);
                 }
         </code>
 
+  Remarks:
+       In Multiplexed Mode (SYS_NET_MUX_ENABLED) the instances are run by
+       SYS_NET_MUX_Tasks() and this function does nothing.
  */
 
 void SYS_NET_Task(SYS_MODULE_OBJ obj);
@@ -851,6 +889,98 @@ int32_t SYS_NET_SetConfigParam(SYS_MODULE_OBJ obj,
                                uint32_t paramType,
                                void *data);
 
+#ifdef SYS_NET_MUX_ENABLED
+// *****************************************************************************
+/* Multiplexed Mode Service Task Timeouts
+
+  Summary:
+    Maximum time (in ms) the service task waits for a TCP/IP signal.
+
+  Remarks:
+    DNS resolution, TLS negotiation and the Lower Layer status do not raise
+    socket signals, so the service task wakes up every SYS_NET_MUX_BUSY_TIMEOUT
+    while any instance is in one of these states, and every
+    SYS_NET_MUX_IDLE_TIMEOUT otherwise.
+ */
+#ifndef SYS_NET_MUX_BUSY_TIMEOUT
+#define SYS_NET_MUX_BUSY_TIMEOUT    10
+#endif
+
+#ifndef SYS_NET_MUX_IDLE_TIMEOUT
+#define SYS_NET_MUX_IDLE_TIMEOUT    1000
+#endif
+
+// *****************************************************************************
+/* Function:
+    void SYS_NET_MUX_Tasks(void)
+
+  Summary:
+       Executes the SYS NET service state machine for all the instances
+
+   Description:
+                In Multiplexed Mode one service task owns all the Net Sockets.
+                This function waits for a TCP/IP signal on any of the sockets
+                and then runs the state machine of every open instance, invoking
+                the user callbacks for the resulting events. SYS_NET_Task() does
+                nothing in this mode.
+  
+  Precondition:
+       SYS_NET_Initialize should have been called before calling this function
+
+  Parameters:
+       None
+
+   Returns:
+        None
+
+   Example:
+        <code>
+                while(1)
+                {
+                        SYS_NET_MUX_Tasks();
+                }
+        </code>
+
+ */
+
+void SYS_NET_MUX_Tasks(void);
+
+// *****************************************************************************
+/* Function:
+       uint32_t SYS_NET_GetReadiness(SYS_MODULE_OBJ obj)
+
+  Summary:
+      Returns the readiness of the Net Socket as SYS_NET_READY flags.
+
+  Description:
+       The readiness is updated from the TCP/IP signals and does not take
+       the instance semaphore, so it can be used to decide whether to call
+       SYS_NET_SendMsg()/ SYS_NET_RecvMsg() without blocking.
+
+  Precondition:
+       SYS_NET_Open should have been called.
+
+  Parameters:
+       obj  	- SYS NET object handle, returned from SYS_NET_Open<br>
+	   
+  Returns:
+                Combination of SYS_NET_READY flags, 0 for an invalid handle
+
+  Example:
+       <code>
+       // Handle "objSysNet" value must have been returned from SYS_NET_Open.	   
+                if (SYS_NET_GetReadiness(objSysNet) & SYS_NET_READY_READABLE)
+                {
+                        len = SYS_NET_RecvMsg(objSysNet, buffer, sizeof(buffer));
+                }
+       </code>
+
+  Remarks:
+       None.
+ */
+uint32_t SYS_NET_GetReadiness(SYS_MODULE_OBJ obj);
+#endif
+
 #ifndef SYS_NET_ENABLE_DEBUG_PRINT
 #define SYS_NETDEBUG_DBG_PRINT(obj, flow, fmt, ...)
 #define SYS_NETDEBUG_INFO_PRINT(obj, flow, fmt, ...)
@@ -0,0 +1,57 @@
+/*******************************************************************************
+  Wi-Fi Scan Cache Host Configuration
+
+  Summary:
+    Host stand-in of the configuration.h used by sys_scancache.c.
+
+  Description:
+    Builds the scan cache service into the host unit tests: no RTOS lock, a
+    tick set by the tests and a small table. This file is not part of the
+    target build.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+Copyright (C) 2020 released Microchip Technology Inc.  All rights reserved.
+
+Microchip licenses to you the right to use, modify, copy and distribute
+Software only when embedded on a Microchip microcontroller or digital signal
+controller that is integrated into your product or third party product
+(pursuant to the sublicense terms in the accompanying license agreement).
+
+You should refer to the license agreement accompanying this Software for
+additional information regarding your rights and obligations.
+
+SOFTWARE AND DOCUMENTATION ARE PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF
+MERCHANTABILITY, TITLE, NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE.
+IN NO EVENT SHALL MICROCHIP OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER
+CONTRACT, NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR
+OTHER LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR
+CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT OF
+SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+(INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef _SYS_SCANCACHE_HOST_CONFIGURATION_H
+#define _SYS_SCANCACHE_HOST_CONFIGURATION_H
+
+#include <stdint.h>
+
+/* Time in ms, advanced by the tests */
+extern uint32_t sysScanCacheHostTick;
+
+/* Single threaded tests */
+#define SYS_SCANCACHE_LOCK_CREATE()
+#define SYS_SCANCACHE_LOCK()
+#define SYS_SCANCACHE_UNLOCK()
+#define SYS_SCANCACHE_TICK()            sysScanCacheHostTick
+
+#define SYS_SCANCACHE_MEMORY_SIZE       108     /* 4 BSSs with a 3 byte SSID */
+#define SYS_SCANCACHE_MAX_CLIENTS       2
+#define SYS_SCANCACHE_ENTRY_MAX_AGE     30000
+#define SYS_SCANCACHE_SCAN_TIMEOUT      5000
+
+#endif // _SYS_SCANCACHE_HOST_CONFIGURATION_H
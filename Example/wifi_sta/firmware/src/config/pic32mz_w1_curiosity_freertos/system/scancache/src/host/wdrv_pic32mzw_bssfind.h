@@ -0,0 +1,61 @@
+/*******************************************************************************
+  Host stand-in for the PIC32MZW1 driver wdrv_pic32mzw_bssfind.h
+
+  Declares the BSS information delivered by the driver scan callback, with
+  the same members as the driver types. The driver headers depend on the
+  whole target configuration and are not used on a development host.
+  This file is not part of the target build.
+*******************************************************************************/
+
+#ifndef _HOST_WDRV_PIC32MZW_BSSFIND_H
+#define _HOST_WDRV_PIC32MZW_BSSFIND_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define WDRV_PIC32MZW_MAX_SSID_LEN      32
+#define WDRV_PIC32MZW_MAC_ADDR_LEN      6
+
+typedef uintptr_t DRV_HANDLE;
+
+typedef uint8_t WDRV_PIC32MZW_CHANNEL_ID;
+typedef uint8_t WDRV_PIC32MZW_SEC_MASK;
+
+typedef enum
+{
+    WDRV_PIC32MZW_AUTH_TYPE_DEFAULT,
+    WDRV_PIC32MZW_AUTH_TYPE_OPEN,
+    WDRV_PIC32MZW_AUTH_TYPE_WEP,
+    WDRV_PIC32MZW_AUTH_TYPE_WPAWPA2_PERSONAL,
+    WDRV_PIC32MZW_AUTH_TYPE_WPA2_PERSONAL,
+} WDRV_PIC32MZW_AUTH_TYPE;
+
+typedef struct _WDRV_PIC32MZW_SSID
+{
+    uint8_t name[WDRV_PIC32MZW_MAX_SSID_LEN];
+    uint8_t length;
+} WDRV_PIC32MZW_SSID;
+
+typedef struct _WDRV_PIC32MZW_MAC_ADDR
+{
+    uint8_t addr[WDRV_PIC32MZW_MAC_ADDR_LEN];
+    bool valid;
+} WDRV_PIC32MZW_MAC_ADDR;
+
+typedef struct
+{
+    WDRV_PIC32MZW_SSID ssid;
+    WDRV_PIC32MZW_MAC_ADDR bssid;
+    WDRV_PIC32MZW_CHANNEL_ID channel;
+    bool cloaked;
+} WDRV_PIC32MZW_BSS_CONTEXT;
+
+typedef struct
+{
+    WDRV_PIC32MZW_BSS_CONTEXT ctx;
+    int8_t rssi;
+    WDRV_PIC32MZW_SEC_MASK secCapabilities;
+    WDRV_PIC32MZW_AUTH_TYPE authTypeRecommended;
+} WDRV_PIC32MZW_BSS_INFO;
+
+#endif  // _HOST_WDRV_PIC32MZW_BSSFIND_H
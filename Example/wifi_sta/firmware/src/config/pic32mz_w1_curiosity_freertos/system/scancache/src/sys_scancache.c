@@ -0,0 +1,654 @@
+/*******************************************************************************
+  Wi-Fi Scan Cache System Service Implementation
+
+  File Name:
+    sys_scancache.c
+
+  Summary:
+    Shared table of the BSSs found by the Wi-Fi scans.
+
+  Description:
+    The table is a byte budget of SYS_SCANCACHE_MEMORY_SIZE holding compact
+    BSS records keyed by BSSID. The records grow from the start of the table
+    and the SSIDs are packed back to back from its end, so a BSS only takes
+    the bytes of its own SSID. The records are expanded back into the driver
+    BSS information when copied out.
+
+    The results of a scan are merged into the table as the driver delivers
+    them: new BSSs are appended and known ones refreshed in place. When there
+    is no room left, the entries seen the longest ago (the weakest first
+    among those of the same scan) are removed until the BSS fits, as long as
+    they are older or weaker than it; otherwise the BSS is dropped. When the
+    scan completes the entries not found for SYS_SCANCACHE_ENTRY_MAX_AGE are
+    removed and the generation is incremented. The clients are notified of
+    every change without the table lock held.
+ *******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+Copyright (C) 2020 released Microchip Technology Inc.  All rights reserved.
+
+Microchip licenses to you the right to use, modify, copy and distribute
+Software only when embedded on a Microchip microcontroller or digital signal
+controller that is integrated into your product or third party product
+(pursuant to the sublicense terms in the accompanying license agreement).
+
+You should refer to the license agreement accompanying this Software for
+additional information regarding your rights and obligations.
+
+SOFTWARE AND DOCUMENTATION ARE PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF
+MERCHANTABILITY, TITLE, NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE.
+IN NO EVENT SHALL MICROCHIP OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER
+CONTRACT, NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR
+OTHER LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR
+CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT OF
+SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+(INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <string.h>
+#include "configuration.h"
+#include "system/scancache/sys_scancache.h"
+
+#ifndef SYS_SCANCACHE_LOCK
+#include "osal/osal.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+static OSAL_MUTEX_HANDLE_TYPE gScanCacheMutex;
+
+#define SYS_SCANCACHE_LOCK_CREATE()     (void)OSAL_MUTEX_Create(&gScanCacheMutex)
+#define SYS_SCANCACHE_LOCK()            (void)OSAL_MUTEX_Lock(&gScanCacheMutex, OSAL_WAIT_FOREVER)
+#define SYS_SCANCACHE_UNLOCK()          (void)OSAL_MUTEX_Unlock(&gScanCacheMutex)
+#define SYS_SCANCACHE_TICK()            ((uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS))
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Data Types and Data
+// *****************************************************************************
+// *****************************************************************************
+
+/* BSS record; the SSID is kept in the string area at the end of the table */
+typedef struct
+{
+    uint32_t generation;
+    uint32_t lastSeen;
+    uint8_t bssid[WDRV_PIC32MZW_MAC_ADDR_LEN];
+    uint16_t ssidOffset;        /* in the table bytes */
+    uint8_t ssidLength;
+    uint8_t channel;
+    int8_t rssi;
+    uint8_t secCapabilities;
+    uint8_t authType;
+    bool cloaked;
+} SYS_SCANCACHE_RECORD;
+
+/* Fails to compile if the record does not have the size of the budget */
+typedef char SYS_SCANCACHE_RECORD_SIZE_CHECK[(sizeof(SYS_SCANCACHE_RECORD) == SYS_SCANCACHE_RECORD_SIZE) ? 1 : -1];
+
+/* Most entries removed to make room for a BSS */
+#define SYS_SCANCACHE_MAX_REMOVED       ((SYS_SCANCACHE_RECORD_SIZE + WDRV_PIC32MZW_MAX_SSID_LEN + \
+                                          SYS_SCANCACHE_RECORD_SIZE - 1) / SYS_SCANCACHE_RECORD_SIZE)
+
+typedef struct
+{
+    SYS_SCANCACHE_CALLBACK callback;
+    void *cookie;
+} SYS_SCANCACHE_CLIENT;
+
+typedef struct
+{
+    union
+    {
+        SYS_SCANCACHE_RECORD records[SYS_SCANCACHE_MAX_ENTRIES];
+        uint8_t bytes[SYS_SCANCACHE_MEMORY_SIZE];
+    } table;                    /* records from the start, SSIDs from the end */
+    uint8_t nRecords;
+    uint16_t ssidBytes;         /* bytes of the string area */
+    uint32_t generation;        /* completed scans */
+    bool scanning;
+    uint32_t scanStart;
+    uint32_t lastScanDone;
+    SYS_SCANCACHE_SCAN_FUNC scanFunc;
+    void *scanParam;
+    SYS_SCANCACHE_CLIENT clients[SYS_SCANCACHE_MAX_CLIENTS];
+    SYS_SCANCACHE_STATS stats;
+} SYS_SCANCACHE_DCPT;
+
+static SYS_SCANCACHE_DCPT gScanCache;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void _SYS_SCANCACHE_Notify(SYS_SCANCACHE_EVENT event, const SYS_SCANCACHE_ENTRY *pEntry, uint32_t generation)
+{
+    SYS_SCANCACHE_CLIENT clients[SYS_SCANCACHE_MAX_CLIENTS];
+    int ix;
+
+    SYS_SCANCACHE_LOCK();
+    memcpy(clients, gScanCache.clients, sizeof(clients));
+    SYS_SCANCACHE_UNLOCK();
+
+    for (ix = 0; ix < SYS_SCANCACHE_MAX_CLIENTS; ix++)
+    {
+        if (clients[ix].callback != NULL)
+        {
+            clients[ix].callback(event, pEntry, generation, clients[ix].cookie);
+        }
+    }
+}
+
+static void _SYS_SCANCACHE_RecordToEntry(const SYS_SCANCACHE_RECORD *pRecord, SYS_SCANCACHE_ENTRY *pEntry, uint32_t now)
+{
+    WDRV_PIC32MZW_BSS_INFO *pBSSInfo = &pEntry->bssInfo;
+
+    memset(pBSSInfo, 0, sizeof(*pBSSInfo));
+    memcpy(pBSSInfo->ctx.ssid.name, gScanCache.table.bytes + pRecord->ssidOffset, pRecord->ssidLength);
+    pBSSInfo->ctx.ssid.length = pRecord->ssidLength;
+    memcpy(pBSSInfo->ctx.bssid.addr, pRecord->bssid, WDRV_PIC32MZW_MAC_ADDR_LEN);
+    pBSSInfo->ctx.bssid.valid = true;
+    pBSSInfo->ctx.channel = (WDRV_PIC32MZW_CHANNEL_ID)pRecord->channel;
+    pBSSInfo->ctx.cloaked = pRecord->cloaked;
+    pBSSInfo->rssi = pRecord->rssi;
+    pBSSInfo->secCapabilities = (WDRV_PIC32MZW_SEC_MASK)pRecord->secCapabilities;
+    pBSSInfo->authTypeRecommended = (WDRV_PIC32MZW_AUTH_TYPE)pRecord->authType;
+    pEntry->generation = pRecord->generation;
+    pEntry->age = now - pRecord->lastSeen;
+}
+
+static uint8_t _SYS_SCANCACHE_SsidLength(const WDRV_PIC32MZW_BSS_INFO *pBSSInfo)
+{
+    return (pBSSInfo->ctx.ssid.length > WDRV_PIC32MZW_MAX_SSID_LEN) ? WDRV_PIC32MZW_MAX_SSID_LEN : pBSSInfo->ctx.ssid.length;
+}
+
+static bool _SYS_SCANCACHE_InfoChanged(const SYS_SCANCACHE_RECORD *pRecord, const WDRV_PIC32MZW_BSS_INFO *pNew)
+{
+    return (pRecord->rssi != pNew->rssi) ||
+           (pRecord->channel != (uint8_t)pNew->ctx.channel) ||
+           (pRecord->secCapabilities != (uint8_t)pNew->secCapabilities) ||
+           (pRecord->authType != (uint8_t)pNew->authTypeRecommended) ||
+           (pRecord->ssidLength != _SYS_SCANCACHE_SsidLength(pNew)) ||
+           (memcmp(gScanCache.table.bytes + pRecord->ssidOffset, pNew->ctx.ssid.name, pRecord->ssidLength) != 0);
+}
+
+/* Called with the lock taken */
+static uint16_t _SYS_SCANCACHE_FreeBytes(void)
+{
+    return SYS_SCANCACHE_MEMORY_SIZE - (gScanCache.nRecords * SYS_SCANCACHE_RECORD_SIZE) - gScanCache.ssidBytes;
+}
+
+/* Called with the lock taken: packs the SSID at the end of the string area.
+   The caller checks there is room for it. */
+static void _SYS_SCANCACHE_StoreSsid(SYS_SCANCACHE_RECORD *pRecord, const uint8_t *ssid, uint8_t length)
+{
+    gScanCache.ssidBytes += length;
+    pRecord->ssidOffset = SYS_SCANCACHE_MEMORY_SIZE - gScanCache.ssidBytes;
+    pRecord->ssidLength = length;
+    memcpy(gScanCache.table.bytes + pRecord->ssidOffset, ssid, length);
+}
+
+/* Called with the lock taken: removes the SSID from the string area, moving
+   the SSIDs stored after it to close the gap */
+static void _SYS_SCANCACHE_ReleaseSsid(SYS_SCANCACHE_RECORD *pRecord)
+{
+    uint16_t areaStart = SYS_SCANCACHE_MEMORY_SIZE - gScanCache.ssidBytes;
+    uint8_t length = pRecord->ssidLength;
+    int ix;
+
+    if (length == 0)
+    {
+        return;
+    }
+
+    memmove(gScanCache.table.bytes + areaStart + length, gScanCache.table.bytes + areaStart, pRecord->ssidOffset - areaStart);
+    gScanCache.ssidBytes -= length;
+
+    for (ix = 0; ix < gScanCache.nRecords; ix++)
+    {
+        SYS_SCANCACHE_RECORD *pOther = gScanCache.table.records + ix;
+
+        if ((pOther->ssidLength != 0) && (pOther->ssidOffset < pRecord->ssidOffset))
+        {
+            pOther->ssidOffset += length;
+        }
+    }
+
+    pRecord->ssidOffset = 0;
+    pRecord->ssidLength = 0;
+}
+
+/* Called with the lock taken: removes a record, keeping the order of the others */
+static void _SYS_SCANCACHE_RemoveRecord(int ix)
+{
+    _SYS_SCANCACHE_ReleaseSsid(gScanCache.table.records + ix);
+    gScanCache.nRecords--;
+    memmove(gScanCache.table.records + ix, gScanCache.table.records + ix + 1, (gScanCache.nRecords - ix) * sizeof(SYS_SCANCACHE_RECORD));
+}
+
+/* Called with the lock taken */
+static int _SYS_SCANCACHE_FindRecord(const uint8_t *bssid)
+{
+    int ix;
+
+    for (ix = 0; ix < gScanCache.nRecords; ix++)
+    {
+        if (memcmp(gScanCache.table.records[ix].bssid, bssid, WDRV_PIC32MZW_MAC_ADDR_LEN) == 0)
+        {
+            return ix;
+        }
+    }
+
+    return -1;
+}
+
+/* True if the record was seen the longest ago, or is the weakest of the same scan */
+static bool _SYS_SCANCACHE_IsWorse(const SYS_SCANCACHE_RECORD *pRecord, uint32_t generation, int8_t rssi)
+{
+    return (pRecord->generation < generation) ||
+           ((pRecord->generation == generation) && (pRecord->rssi < rssi));
+}
+
+/* Called with the lock taken: the entry seen the longest ago, the weakest
+   one among those of the same scan, other than the one kept */
+static int _SYS_SCANCACHE_VictimRecord(int keep)
+{
+    int ix, victim = -1;
+
+    for (ix = 0; ix < gScanCache.nRecords; ix++)
+    {
+        const SYS_SCANCACHE_RECORD *pRecord = gScanCache.table.records + ix;
+
+        if ((ix != keep) &&
+            ((victim < 0) || _SYS_SCANCACHE_IsWorse(pRecord, gScanCache.table.records[victim].generation, gScanCache.table.records[victim].rssi)))
+        {
+            victim = ix;
+        }
+    }
+
+    return victim;
+}
+
+/* Called with the lock taken: frees size bytes by removing victims, as long
+   as they are worse than the BSS to store. Removes nothing and fails if that
+   is not enough. The removed entries are copied to pRemoved and the index
+   of the kept record is updated. */
+static bool _SYS_SCANCACHE_MakeRoom(uint16_t size, uint32_t generation, int8_t rssi, int *pKeep,
+                                    SYS_SCANCACHE_ENTRY *pRemoved, uint8_t *pnRemoved, uint32_t now)
+{
+    uint32_t available = _SYS_SCANCACHE_FreeBytes();
+    int ix;
+
+    for (ix = 0; (ix < gScanCache.nRecords) && (available < size); ix++)
+    {
+        const SYS_SCANCACHE_RECORD *pRecord = gScanCache.table.records + ix;
+
+        if ((ix != *pKeep) && _SYS_SCANCACHE_IsWorse(pRecord, generation, rssi))
+        {
+            available += SYS_SCANCACHE_RECORD_SIZE + pRecord->ssidLength;
+        }
+    }
+
+    if (available < size)
+    {
+        return false;
+    }
+
+    /* The victims come in order: all worse than the BSS to store */
+    while (_SYS_SCANCACHE_FreeBytes() < size)
+    {
+        ix = _SYS_SCANCACHE_VictimRecord(*pKeep);
+        _SYS_SCANCACHE_RecordToEntry(gScanCache.table.records + ix, pRemoved + (*pnRemoved)++, now);
+        _SYS_SCANCACHE_RemoveRecord(ix);
+        gScanCache.stats.dropped++;
+
+        if (ix < *pKeep)
+        {
+            (*pKeep)--;
+        }
+    }
+
+    return true;
+}
+
+static void _SYS_SCANCACHE_Merge(const WDRV_PIC32MZW_BSS_INFO *pBSSInfo, uint32_t now)
+{
+    SYS_SCANCACHE_RECORD *pRecord = NULL;
+    SYS_SCANCACHE_ENTRY entry, removed[SYS_SCANCACHE_MAX_REMOVED];
+    uint8_t nRemoved = 0, ssidLength = _SYS_SCANCACHE_SsidLength(pBSSInfo);
+    bool notifyEntry = false;
+    SYS_SCANCACHE_EVENT event = SYS_SCANCACHE_EVENT_ADDED;
+    uint32_t scanGeneration;
+    int ix, keep = -1;
+
+    SYS_SCANCACHE_LOCK();
+
+    scanGeneration = gScanCache.generation + 1;
+    ix = _SYS_SCANCACHE_FindRecord(pBSSInfo->ctx.bssid.addr);
+
+    if (ix >= 0)
+    {
+        pRecord = gScanCache.table.records + ix;
+        if (_SYS_SCANCACHE_InfoChanged(pRecord, pBSSInfo))
+        {
+            event = SYS_SCANCACHE_EVENT_UPDATED;
+            notifyEntry = true;
+        }
+
+        if (pRecord->ssidLength != ssidLength)
+        {
+            SYS_SCANCACHE_ENTRY previous;
+
+            _SYS_SCANCACHE_RecordToEntry(pRecord, &previous, now);
+            _SYS_SCANCACHE_ReleaseSsid(pRecord);
+
+            keep = ix;
+            if (_SYS_SCANCACHE_MakeRoom(ssidLength, scanGeneration, pBSSInfo->rssi, &keep, removed, &nRemoved, now))
+            {
+                pRecord = gScanCache.table.records + keep;
+            }
+            else
+            {   // the longer SSID does not fit any more
+                _SYS_SCANCACHE_RemoveRecord(ix);
+                removed[nRemoved++] = previous;
+                gScanCache.stats.dropped++;
+                notifyEntry = false;
+                pRecord = NULL;
+            }
+        }
+    }
+    else if (_SYS_SCANCACHE_MakeRoom(SYS_SCANCACHE_RECORD_SIZE + ssidLength, scanGeneration, pBSSInfo->rssi, &keep, removed, &nRemoved, now))
+    {
+        pRecord = gScanCache.table.records + gScanCache.nRecords++;
+        memcpy(pRecord->bssid, pBSSInfo->ctx.bssid.addr, WDRV_PIC32MZW_MAC_ADDR_LEN);
+        pRecord->ssidOffset = 0;
+        pRecord->ssidLength = 0;
+        notifyEntry = true;
+    }
+    else
+    {   // the table is full of BSSs of this scan, all stronger
+        gScanCache.stats.dropped++;
+    }
+
+    if (pRecord != NULL)
+    {
+        if (pRecord->ssidLength == ssidLength)
+        {
+            memcpy(gScanCache.table.bytes + pRecord->ssidOffset, pBSSInfo->ctx.ssid.name, ssidLength);
+        }
+        else
+        {
+            _SYS_SCANCACHE_StoreSsid(pRecord, pBSSInfo->ctx.ssid.name, ssidLength);
+        }
+        pRecord->channel = (uint8_t)pBSSInfo->ctx.channel;
+        pRecord->cloaked = pBSSInfo->ctx.cloaked;
+        pRecord->rssi = pBSSInfo->rssi;
+        pRecord->secCapabilities = (uint8_t)pBSSInfo->secCapabilities;
+        pRecord->authType = (uint8_t)pBSSInfo->authTypeRecommended;
+        pRecord->generation = scanGeneration;
+        pRecord->lastSeen = now;
+        _SYS_SCANCACHE_RecordToEntry(pRecord, &entry, now);
+    }
+
+    SYS_SCANCACHE_UNLOCK();
+
+    for (ix = 0; ix < nRemoved; ix++)
+    {
+        _SYS_SCANCACHE_Notify(SYS_SCANCACHE_EVENT_REMOVED, removed + ix, scanGeneration);
+    }
+    if (notifyEntry)
+    {
+        _SYS_SCANCACHE_Notify(event, &entry, scanGeneration);
+    }
+}
+
+static void _SYS_SCANCACHE_Complete(uint32_t now)
+{
+    SYS_SCANCACHE_ENTRY removed;
+    uint32_t generation;
+    bool found;
+    int ix;
+
+    /* Removes the aged entries, keeping the order of the others */
+    do
+    {
+        found = false;
+
+        SYS_SCANCACHE_LOCK();
+        for (ix = 0; ix < gScanCache.nRecords; ix++)
+        {
+            if ((now - gScanCache.table.records[ix].lastSeen) > SYS_SCANCACHE_ENTRY_MAX_AGE)
+            {
+                _SYS_SCANCACHE_RecordToEntry(gScanCache.table.records + ix, &removed, now);
+                _SYS_SCANCACHE_RemoveRecord(ix);
+                found = true;
+                break;
+            }
+        }
+        generation = gScanCache.generation;
+        SYS_SCANCACHE_UNLOCK();
+
+        if (found)
+        {
+            _SYS_SCANCACHE_Notify(SYS_SCANCACHE_EVENT_REMOVED, &removed, generation + 1);
+        }
+    } while (found);
+
+    SYS_SCANCACHE_LOCK();
+    generation = ++gScanCache.generation;
+    gScanCache.scanning = false;
+    gScanCache.lastScanDone = now;
+    SYS_SCANCACHE_UNLOCK();
+
+    _SYS_SCANCACHE_Notify(SYS_SCANCACHE_EVENT_SCAN_DONE, NULL, generation);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void SYS_SCANCACHE_Initialize(void)
+{
+    memset(&gScanCache, 0, sizeof(gScanCache));
+    SYS_SCANCACHE_LOCK_CREATE();
+}
+
+void SYS_SCANCACHE_SetScanner(SYS_SCANCACHE_SCAN_FUNC scanFunc, void *param)
+{
+    SYS_SCANCACHE_LOCK();
+    gScanCache.scanFunc = scanFunc;
+    gScanCache.scanParam = param;
+    SYS_SCANCACHE_UNLOCK();
+}
+
+SYS_SCANCACHE_CLIENT_HANDLE SYS_SCANCACHE_Subscribe(SYS_SCANCACHE_CALLBACK callback, void *cookie)
+{
+    SYS_SCANCACHE_CLIENT_HANDLE client = SYS_SCANCACHE_CLIENT_INVALID;
+    int ix;
+
+    if (callback == NULL)
+    {
+        return SYS_SCANCACHE_CLIENT_INVALID;
+    }
+
+    SYS_SCANCACHE_LOCK();
+    for (ix = 0; ix < SYS_SCANCACHE_MAX_CLIENTS; ix++)
+    {
+        if (gScanCache.clients[ix].callback == NULL)
+        {
+            gScanCache.clients[ix].callback = callback;
+            gScanCache.clients[ix].cookie = cookie;
+            client = ix;
+            break;
+        }
+    }
+    SYS_SCANCACHE_UNLOCK();
+
+    return client;
+}
+
+void SYS_SCANCACHE_Unsubscribe(SYS_SCANCACHE_CLIENT_HANDLE client)
+{
+    if ((client >= 0) && (client < SYS_SCANCACHE_MAX_CLIENTS))
+    {
+        SYS_SCANCACHE_LOCK();
+        gScanCache.clients[client].callback = NULL;
+        SYS_SCANCACHE_UNLOCK();
+    }
+}
+
+SYS_SCANCACHE_RESULT SYS_SCANCACHE_Request(uint32_t maxAge)
+{
+    SYS_SCANCACHE_SCAN_FUNC scanFunc;
+    void *scanParam;
+    uint32_t now = SYS_SCANCACHE_TICK();
+    bool lostScan;
+
+    SYS_SCANCACHE_LOCK();
+
+    if (gScanCache.scanning && ((now - gScanCache.scanStart) < SYS_SCANCACHE_SCAN_TIMEOUT))
+    {
+        gScanCache.stats.coalesced++;
+        SYS_SCANCACHE_UNLOCK();
+        return SYS_SCANCACHE_RESULT_ATTACHED;
+    }
+
+    lostScan = gScanCache.scanning;
+    if (lostScan)
+    {
+        gScanCache.scanning = false;
+        gScanCache.stats.failures++;
+    }
+    else if ((maxAge != 0) && (gScanCache.generation != 0) && ((now - gScanCache.lastScanDone) <= maxAge))
+    {
+        gScanCache.stats.cacheHits++;
+        SYS_SCANCACHE_UNLOCK();
+        return SYS_SCANCACHE_RESULT_CACHED;
+    }
+
+    scanFunc = gScanCache.scanFunc;
+    scanParam = gScanCache.scanParam;
+    if (scanFunc != NULL)
+    {
+        gScanCache.scanning = true;
+        gScanCache.scanStart = now;
+        gScanCache.stats.scans++;
+    }
+    else
+    {
+        gScanCache.stats.failures++;
+    }
+
+    SYS_SCANCACHE_UNLOCK();
+
+    if (lostScan)
+    {
+        _SYS_SCANCACHE_Notify(SYS_SCANCACHE_EVENT_SCAN_FAILED, NULL, gScanCache.generation);
+    }
+
+    if (scanFunc == NULL)
+    {
+        return SYS_SCANCACHE_RESULT_ERROR;
+    }
+
+    if (!scanFunc(scanParam))
+    {
+        SYS_SCANCACHE_LOCK();
+        gScanCache.scanning = false;
+        gScanCache.stats.failures++;
+        SYS_SCANCACHE_UNLOCK();
+
+        _SYS_SCANCACHE_Notify(SYS_SCANCACHE_EVENT_SCAN_FAILED, NULL, gScanCache.generation);
+        return SYS_SCANCACHE_RESULT_ERROR;
+    }
+
+    return SYS_SCANCACHE_RESULT_STARTED;
+}
+
+bool SYS_SCANCACHE_ScanHandler(DRV_HANDLE handle, uint8_t index, uint8_t ofTotal, WDRV_PIC32MZW_BSS_INFO *pBSSInfo)
+{
+    uint32_t now = SYS_SCANCACHE_TICK();
+
+    (void)handle;
+
+    if ((ofTotal != 0) && (pBSSInfo != NULL))
+    {
+        _SYS_SCANCACHE_Merge(pBSSInfo, now);
+    }
+
+    if (index >= ofTotal)
+    {
+        _SYS_SCANCACHE_Complete(now);
+    }
+
+    /* Receive all the results */
+    return true;
+}
+
+uint32_t SYS_SCANCACHE_Generation(void)
+{
+    return gScanCache.generation;
+}
+
+bool SYS_SCANCACHE_IsScanning(void)
+{
+    return gScanCache.scanning;
+}
+
+uint8_t SYS_SCANCACHE_Count(void)
+{
+    return gScanCache.nRecords;
+}
+
+bool SYS_SCANCACHE_Get(uint8_t index, SYS_SCANCACHE_ENTRY *pEntry)
+{
+    uint32_t now = SYS_SCANCACHE_TICK();
+    bool found = false;
+
+    SYS_SCANCACHE_LOCK();
+    if (index < gScanCache.nRecords)
+    {
+        _SYS_SCANCACHE_RecordToEntry(gScanCache.table.records + index, pEntry, now);
+        found = true;
+    }
+    SYS_SCANCACHE_UNLOCK();
+
+    return found;
+}
+
+bool SYS_SCANCACHE_Find(const uint8_t *bssid, SYS_SCANCACHE_ENTRY *pEntry)
+{
+    uint32_t now = SYS_SCANCACHE_TICK();
+    int ix;
+
+    SYS_SCANCACHE_LOCK();
+    ix = _SYS_SCANCACHE_FindRecord(bssid);
+    if (ix >= 0)
+    {
+        _SYS_SCANCACHE_RecordToEntry(gScanCache.table.records + ix, pEntry, now);
+    }
+    SYS_SCANCACHE_UNLOCK();
+
+    return ix >= 0;
+}
+
+void SYS_SCANCACHE_StatsGet(SYS_SCANCACHE_STATS *pStats)
+{
+    SYS_SCANCACHE_LOCK();
+    *pStats = gScanCache.stats;
+    SYS_SCANCACHE_UNLOCK();
+}
@@ -0,0 +1,287 @@
+/*******************************************************************************
+  Wi-Fi Scan Cache System Service
+
+  File Name:
+    sys_scancache.h
+
+  Summary:
+    Shared table of the BSSs found by the Wi-Fi scans.
+
+  Description:
+    The Wi-Fi service console and the FFS Wi-Fi manager both
+    need the list of the surrounding BSSs. Instead of each of them starting
+    its own scan and keeping its own copy of the results, the scan cache
+    service owns a single BSS table:
+
+      - Each completed scan increments the table generation. An entry
+        records the generation of the last scan that found it and its age.
+      - A scan request is served from the table when the last scan is
+        recent enough, and a request made while a scan is in flight is
+        attached to that scan instead of starting another one.
+      - Clients subscribe to be notified of the added, updated and removed
+        entries and of the end of each scan.
+
+    The scans themselves are started by the scanner registered with
+    SYS_SCANCACHE_SetScanner() (the Wi-Fi service, once it has opened the
+    driver), which delivers the results to SYS_SCANCACHE_ScanHandler().
+ *******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+Copyright (C) 2020 released Microchip Technology Inc.  All rights reserved.
+
+Microchip licenses to you the right to use, modify, copy and distribute
+Software only when embedded on a Microchip microcontroller or digital signal
+controller that is integrated into your product or third party product
+(pursuant to the sublicense terms in the accompanying license agreement).
+
+You should refer to the license agreement accompanying this Software for
+additional information regarding your rights and obligations.
+
+SOFTWARE AND DOCUMENTATION ARE PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF
+MERCHANTABILITY, TITLE, NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE.
+IN NO EVENT SHALL MICROCHIP OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER
+CONTRACT, NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR
+OTHER LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR
+CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT OF
+SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+(INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef _SYS_SCANCACHE_H
+#define _SYS_SCANCACHE_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdint.h>
+#include <stdbool.h>
+#include "wdrv_pic32mzw_bssfind.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+    extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Constants
+// *****************************************************************************
+// *****************************************************************************
+
+/* Bytes of the BSS table. Each BSS takes a record and the bytes of its SSID,
+   so the number of BSSs kept depends on the length of their SSIDs. The
+   default is the memory of 24 entries holding the whole driver BSS
+   information. */
+#ifndef SYS_SCANCACHE_MEMORY_SIZE
+#define SYS_SCANCACHE_MEMORY_SIZE       1632
+#endif
+
+/* Bytes of a BSS record, without the SSID */
+#define SYS_SCANCACHE_RECORD_SIZE       24
+
+/* Number of BSSs kept in the table when none has an SSID */
+#define SYS_SCANCACHE_MAX_ENTRIES       (SYS_SCANCACHE_MEMORY_SIZE / SYS_SCANCACHE_RECORD_SIZE)
+
+#if (SYS_SCANCACHE_MAX_ENTRIES > 255) || (SYS_SCANCACHE_MEMORY_SIZE > 65535)
+#error "SYS_SCANCACHE_MEMORY_SIZE too large"
+#endif
+
+/* Number of subscribed clients */
+#ifndef SYS_SCANCACHE_MAX_CLIENTS
+#define SYS_SCANCACHE_MAX_CLIENTS       4
+#endif
+
+/* Entries not found by any scan for this long (ms) are removed at the
+   end of the next scan */
+#ifndef SYS_SCANCACHE_ENTRY_MAX_AGE
+#define SYS_SCANCACHE_ENTRY_MAX_AGE     60000
+#endif
+
+/* A scan in flight for longer than this (ms) is considered lost and a new
+   request starts another one */
+#ifndef SYS_SCANCACHE_SCAN_TIMEOUT
+#define SYS_SCANCACHE_SCAN_TIMEOUT      10000
+#endif
+
+#define SYS_SCANCACHE_CLIENT_INVALID    (-1)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Scan request result
+
+  Summary:
+    How SYS_SCANCACHE_Request() served the request.
+*/
+typedef enum
+{
+    // No scan was started: the table is recent enough
+    SYS_SCANCACHE_RESULT_CACHED = 0,
+
+    // A new scan was started
+    SYS_SCANCACHE_RESULT_STARTED,
+
+    // The request was attached to the scan in flight
+    SYS_SCANCACHE_RESULT_ATTACHED,
+
+    // No scanner registered, or the scan could not be started
+    SYS_SCANCACHE_RESULT_ERROR,
+} SYS_SCANCACHE_RESULT;
+
+// *****************************************************************************
+/* Client notifications
+
+  Summary:
+    Events delivered to the subscribed clients.
+
+  Remarks:
+    The entry events carry the entry; the scan events carry no entry.
+*/
+typedef enum
+{
+    // A BSS not in the table was found
+    SYS_SCANCACHE_EVENT_ADDED = 0,
+
+    // A BSS in the table was found with a different RSSI, channel or security
+    SYS_SCANCACHE_EVENT_UPDATED,
+
+    // A BSS aged out of the table or was removed to make room for another one
+    SYS_SCANCACHE_EVENT_REMOVED,
+
+    // A scan completed; the table generation was incremented
+    SYS_SCANCACHE_EVENT_SCAN_DONE,
+
+    // The scan could not be started or was lost
+    SYS_SCANCACHE_EVENT_SCAN_FAILED,
+} SYS_SCANCACHE_EVENT;
+
+// *****************************************************************************
+/* Table entry
+
+  Summary:
+    A BSS of the table, as returned by SYS_SCANCACHE_Get().
+*/
+typedef struct
+{
+    /* Information of the last scan that found the BSS */
+    WDRV_PIC32MZW_BSS_INFO bssInfo;
+
+    /* Generation of the last scan that found the BSS */
+    uint32_t generation;
+
+    /* Time since the BSS was last found, in ms */
+    uint32_t age;
+} SYS_SCANCACHE_ENTRY;
+
+// *****************************************************************************
+/* Service statistics
+
+  Summary:
+    Counters returned by SYS_SCANCACHE_StatsGet().
+*/
+typedef struct
+{
+    /* Scans started */
+    uint32_t scans;
+
+    /* Requests served from the table */
+    uint32_t cacheHits;
+
+    /* Requests attached to a scan in flight */
+    uint32_t coalesced;
+
+    /* Scans failed to start or lost */
+    uint32_t failures;
+
+    /* BSSs dropped or removed because the table was full */
+    uint32_t dropped;
+} SYS_SCANCACHE_STATS;
+
+// *****************************************************************************
+/* Client callback
+
+  Summary:
+    Notification of a subscribed client.
+
+  Remarks:
+    Called from the context that delivered the scan results (usually the
+    Wi-Fi driver task) without the table lock held; the client can read the
+    table from the callback. pEntry is NULL for the scan events.
+*/
+typedef void (*SYS_SCANCACHE_CALLBACK)(SYS_SCANCACHE_EVENT event, const SYS_SCANCACHE_ENTRY *pEntry, uint32_t generation, void *cookie);
+
+// *****************************************************************************
+/* Scanner
+
+  Summary:
+    Starts a scan of all the channels delivering the results to
+    SYS_SCANCACHE_ScanHandler(). Returns false if the scan was not started.
+*/
+typedef bool (*SYS_SCANCACHE_SCAN_FUNC)(void *param);
+
+typedef int32_t SYS_SCANCACHE_CLIENT_HANDLE;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Empties the table */
+void SYS_SCANCACHE_Initialize(void);
+
+/* Registers the scanner, NULL when the driver is closed */
+void SYS_SCANCACHE_SetScanner(SYS_SCANCACHE_SCAN_FUNC scanFunc, void *param);
+
+/* Subscribes to the table changes and scan completions */
+SYS_SCANCACHE_CLIENT_HANDLE SYS_SCANCACHE_Subscribe(SYS_SCANCACHE_CALLBACK callback, void *cookie);
+void SYS_SCANCACHE_Unsubscribe(SYS_SCANCACHE_CLIENT_HANDLE client);
+
+/* Requests the table to be no older than maxAge ms; 0 always scans, or
+   attaches to the scan in flight. On SYS_SCANCACHE_RESULT_STARTED and
+   SYS_SCANCACHE_RESULT_ATTACHED the completion is notified to the
+   subscribed clients. */
+SYS_SCANCACHE_RESULT SYS_SCANCACHE_Request(uint32_t maxAge);
+
+/* Driver BSS find callback (WDRV_PIC32MZW_BSSFIND_NOTIFY_CALLBACK) of the
+   scans started by the scanner */
+bool SYS_SCANCACHE_ScanHandler(DRV_HANDLE handle, uint8_t index, uint8_t ofTotal, WDRV_PIC32MZW_BSS_INFO *pBSSInfo);
+
+/* Number of completed scans, 0 while the table was never filled */
+uint32_t SYS_SCANCACHE_Generation(void);
+
+/* True while a scan is in flight */
+bool SYS_SCANCACHE_IsScanning(void);
+
+/* Number of entries in the table */
+uint8_t SYS_SCANCACHE_Count(void);
+
+/* Copies an entry of the table. The entries keep their index while a scan
+   is in flight unless the table is full; the aged entries are removed at
+   the end of the scan. */
+bool SYS_SCANCACHE_Get(uint8_t index, SYS_SCANCACHE_ENTRY *pEntry);
+
+/* Copies the entry of a BSSID */
+bool SYS_SCANCACHE_Find(const uint8_t *bssid, SYS_SCANCACHE_ENTRY *pEntry);
+
+/* Copies the service counters */
+void SYS_SCANCACHE_StatsGet(SYS_SCANCACHE_STATS *pStats);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif // _SYS_SCANCACHE_H
@@ -143,6 +143,14 @@ bool      g_isRegDomainSetReq = false;
 
 /* Semaphore for Critical Section */
 static    OSAL_SEM_HANDLE_TYPE  g_wifiSrvcSemaphore;
+
+#ifdef SYS_SCANCACHE_ENABLED
+/* Console scan waiting for the scan cache */
+static    bool                  g_wifiSrvcScanPrint = false;
+
+/* Scan cache client printing the console scans */
+static    SYS_SCANCACHE_CLIENT_HANDLE g_wifiSrvcScanCacheClient = SYS_SCANCACHE_CLIENT_INVALID;
+#endif
 // *****************************************************************************
 
 // *****************************************************************************
@@ -618,13 +626,12 @@ static void SYS_WIFI_RegDomainCallback
 
 }
 
-/* Wi-Fi driver update the Scan result on callback*/
-static void SYS_WIFI_ScanHandler
+/* Print a scan result on the console */
+static void SYS_WIFI_PrintScanResult
 (
-    DRV_HANDLE handle, 
     uint8_t index, 
     uint8_t ofTotal, 
-    WDRV_PIC32MZW_BSS_INFO *pBSSInfo
+    const WDRV_PIC32MZW_BSS_INFO *pBSSInfo
 ) 
 {
     if (0 == ofTotal) 
@@ -682,6 +689,61 @@ static void SYS_WIFI_ScanHandler
     }
 }
 
+/* Wi-Fi driver update the Scan result on callback*/
+static void SYS_WIFI_ScanHandler
+(
+    DRV_HANDLE handle, 
+    uint8_t index, 
+    uint8_t ofTotal, 
+    WDRV_PIC32MZW_BSS_INFO *pBSSInfo
+) 
+{
+    SYS_WIFI_PrintScanResult(index, ofTotal, pBSSInfo);
+}
+
+#ifdef SYS_SCANCACHE_ENABLED
+/* Scan cache client: print the table when the console scan completes */
+static void SYS_WIFI_ScanCacheCallback
+(
+    SYS_SCANCACHE_EVENT event, 
+    const SYS_SCANCACHE_ENTRY *pEntry, 
+    uint32_t generation, 
+    void *cookie
+) 
+{
+    SYS_SCANCACHE_ENTRY entry;
+    uint8_t count;
+    uint8_t idx;
+
+    if (false == g_wifiSrvcScanPrint)
+    {
+        return;
+    }
+
+    if (SYS_SCANCACHE_EVENT_SCAN_DONE == event) 
+    {
+        g_wifiSrvcScanPrint = false;
+        count = SYS_SCANCACHE_Count();
+        if (0 == count)
+        {
+            SYS_WIFI_PrintScanResult(0, 0, NULL);
+        }
+        for (idx = 0; idx < count; idx++)
+        {
+            if (true == SYS_SCANCACHE_Get(idx, &entry))
+            {
+                SYS_WIFI_PrintScanResult(idx + 1, count, &entry.bssInfo);
+            }
+        }
+    }
+    else if (SYS_SCANCACHE_EVENT_SCAN_FAILED == event) 
+    {
+        g_wifiSrvcScanPrint = false;
+        SYS_CONSOLE_MESSAGE("Scan failed\r\n");
+    }
+}
+#endif
+
 static void SYS_WIFI_TCPIP_DHCP_EventHandler
 (
     TCPIP_NET_HANDLE hNet, 
@@ -799,10 +861,75 @@ static WDRV_PIC32MZW_SSID_LIST * SYS_WIFI_CreateSsidList(void)
     return result;
 }
 
+static SYS_WIFI_RESULT SYS_WIFI_StartScan
+(
+    uint8_t channel, 
+    uint8_t matchMode, 
+    WDRV_PIC32MZW_SSID_LIST * pSSIDList, 
+    WDRV_PIC32MZW_BSSFIND_NOTIFY_CALLBACK pNotifyCallback
+)
+{
+    uint8_t ret = SYS_WIFI_FAILURE;
+
+    if (WDRV_PIC32MZW_STATUS_OK == WDRV_PIC32MZW_BSSFindSetScanMatchMode(g_wifiSrvcObj.wifiSrvcDrvHdl, matchMode))
+    {
+        if (WDRV_PIC32MZW_STATUS_OK == WDRV_PIC32MZW_BSSFindSetEnabledChannels24(g_wifiSrvcObj.wifiSrvcDrvHdl, g_wifiSrvcScanConfig.chan24Mask))
+        {
+            if (WDRV_PIC32MZW_STATUS_OK == WDRV_PIC32MZW_BSSFindSetScanParameters(g_wifiSrvcObj.wifiSrvcDrvHdl, g_wifiSrvcScanConfig.numSlots, g_wifiSrvcScanConfig.activeSlotTime, g_wifiSrvcScanConfig.passiveSlotTime, g_wifiSrvcScanConfig.numProbes))
+            {
+                if (WDRV_PIC32MZW_STATUS_OK == WDRV_PIC32MZW_BSSFindFirst(g_wifiSrvcObj.wifiSrvcDrvHdl, channel, g_wifiSrvcScanConfig.mode, pSSIDList, pNotifyCallback))   
+                {
+                    ret = SYS_WIFI_SUCCESS ;
+                }
+            }
+        }
+    }
+    return ret;
+}
+
+#ifdef SYS_SCANCACHE_ENABLED
+/* Scan cache scanner: all the channels of the channel mask */
+static bool SYS_WIFI_ScanCacheScan(void *param)
+{
+    if (true == WDRV_PIC32MZW_BSSFindInProgress(g_wifiSrvcObj.wifiSrvcDrvHdl))
+    {
+        return false;
+    }
+    return (SYS_WIFI_SUCCESS == SYS_WIFI_StartScan(WDRV_PIC32MZW_CID_ANY, WDRV_PIC32MZW_SCAN_MATCH_MODE_FIND_ALL, NULL, SYS_SCANCACHE_ScanHandler));
+}
+
+/* A console scan of all the channels is served by the scan cache */
+static inline bool SYS_WIFI_IsCachedScan(void)
+{
+    bool fullScan = ((NULL == g_wifiSrvcScanConfig.pSsidList) || ('\0' == g_wifiSrvcScanConfig.pSsidList[0]) || (SYS_WIFI_SCAN_MODE_ACTIVE != g_wifiSrvcScanConfig.mode));
+
+    return ((NULL == g_wifiSrvcScanConfig.pNotifyCallback) || (SYS_WIFI_ScanHandler == g_wifiSrvcScanConfig.pNotifyCallback)) &&
+           (0 == g_wifiSrvcScanConfig.channel) && (WDRV_PIC32MZW_SCAN_MATCH_MODE_FIND_ALL == g_wifiSrvcScanConfig.matchMode) && fullScan;
+}
+#endif
+
 static SYS_WIFI_RESULT SYS_WIFI_SetScan (void)
 {
     uint8_t ret = SYS_WIFI_FAILURE;
     
+#ifdef SYS_SCANCACHE_ENABLED
+    if (true == SYS_WIFI_IsCachedScan())
+    {
+        /* Attached to the scan in flight, if any */
+        SYS_WIFI_PrintScanConfig();
+        g_wifiSrvcScanPrint = true;
+        if (SYS_SCANCACHE_RESULT_ERROR != SYS_SCANCACHE_Request(0))
+        {
+            ret = SYS_WIFI_SUCCESS;
+        }
+        else
+        {
+            g_wifiSrvcScanPrint = false;
+        }
+        return ret;
+    }
+#endif
+
     if (false == WDRV_PIC32MZW_BSSFindInProgress(g_wifiSrvcObj.wifiSrvcDrvHdl))
     {
         WDRV_PIC32MZW_SSID_LIST * pSSIDList = NULL;
@@ -821,19 +948,7 @@ static SYS_WIFI_RESULT SYS_WIFI_SetScan (void)
             g_wifiSrvcScanConfig.pNotifyCallback = SYS_WIFI_ScanHandler;
         }
 
-        if (WDRV_PIC32MZW_STATUS_OK == WDRV_PIC32MZW_BSSFindSetScanMatchMode(g_wifiSrvcObj.wifiSrvcDrvHdl, g_wifiSrvcScanConfig.matchMode))
-        {
-            if (WDRV_PIC32MZW_STATUS_OK == WDRV_PIC32MZW_BSSFindSetEnabledChannels24(g_wifiSrvcObj.wifiSrvcDrvHdl, g_wifiSrvcScanConfig.chan24Mask))
-            {
-                if (WDRV_PIC32MZW_STATUS_OK == WDRV_PIC32MZW_BSSFindSetScanParameters(g_wifiSrvcObj.wifiSrvcDrvHdl, g_wifiSrvcScanConfig.numSlots, g_wifiSrvcScanConfig.activeSlotTime, g_wifiSrvcScanConfig.passiveSlotTime, g_wifiSrvcScanConfig.numProbes))
-                {
-                    if (WDRV_PIC32MZW_STATUS_OK == WDRV_PIC32MZW_BSSFindFirst(g_wifiSrvcObj.wifiSrvcDrvHdl, g_wifiSrvcScanConfig.channel, g_wifiSrvcScanConfig.mode, pSSIDList, (WDRV_PIC32MZW_BSSFIND_NOTIFY_CALLBACK) g_wifiSrvcScanConfig.pNotifyCallback))   
-                    {
-                        ret = SYS_WIFI_SUCCESS ;
-                    }
-                }
-            }
-        }
+        ret = SYS_WIFI_StartScan(g_wifiSrvcScanConfig.channel, g_wifiSrvcScanConfig.matchMode, pSSIDList, (WDRV_PIC32MZW_BSSFIND_NOTIFY_CALLBACK) g_wifiSrvcScanConfig.pNotifyCallback);
     }
     return ret;
 }
@@ -1074,6 +1189,9 @@ static uint32_t SYS_WIFI_ExecuteBlock
                     wifiSrvcObj->wifiSrvcDrvHdl = WDRV_PIC32MZW_Open(0, 0);
                     if (DRV_HANDLE_INVALID != wifiSrvcObj->wifiSrvcDrvHdl) 
                     {
+#ifdef SYS_SCANCACHE_ENABLED
+                        SYS_SCANCACHE_SetScanner(SYS_WIFI_ScanCacheScan, NULL);
+#endif
                         if (WDRV_PIC32MZW_STATUS_OK == WDRV_PIC32MZW_RegDomainGet(wifiSrvcObj->wifiSrvcDrvHdl,WDRV_PIC32MZW_REGDOMAIN_SELECT_CURRENT,SYS_WIFI_RegDomainCallback))
                         {
                             SYS_WIFI_PrintWifiConfig();
@@ -1344,6 +1462,9 @@ static void SYS_WIFI_WIFIPROVCallBack
                             SYS_WIFI_DisConnect();
                         }
                             memcpy(&g_wifiSrvcConfig, wifiConfig, sizeof (SYS_WIFIPROV_CONFIG));
+#ifdef SYS_SCANCACHE_ENABLED
+                            SYS_SCANCACHE_SetScanner(NULL, NULL);
+#endif
                             WDRV_PIC32MZW_Close(g_wifiSrvcObj.wifiSrvcDrvHdl);
                             SYS_WIFI_SetTaskstatus(SYS_WIFI_STATUS_INIT);
                         }
@@ -1409,6 +1530,9 @@ SYS_MODULE_OBJ SYS_WIFI_Initialize
         SYS_WIFI_SetCookie(cookie);
         SYS_WIFI_InitStaConnInfo();
         SYS_WIFI_InitWifiScanInfoDefault();
+#ifdef SYS_SCANCACHE_ENABLED
+        g_wifiSrvcScanCacheClient = SYS_SCANCACHE_Subscribe(SYS_WIFI_ScanCacheCallback, NULL);
+#endif
 
         /* User has enabled Wi-Fi provisioning service using MHC */
         g_wifiSrvcProvObj= SYS_WIFIPROV_Initialize ((SYS_WIFIPROV_CONFIG *)config,SYS_WIFI_WIFIPROVCallBack,&g_wifiSrvcProvCookieVal);
@@ -1447,6 +1571,10 @@ SYS_WIFI_RESULT SYS_WIFI_Deinitialize
                 SYS_CONSOLE_MESSAGE(" AP mode Stop Failed \n");
             }
         }
+#ifdef SYS_SCANCACHE_ENABLED
+        SYS_SCANCACHE_SetScanner(NULL, NULL);
+        SYS_SCANCACHE_Unsubscribe(g_wifiSrvcScanCacheClient);
+#endif
         WDRV_PIC32MZW_Close(g_wifiSrvcObj.wifiSrvcDrvHdl);
         g_wifiSrvcInit = false;
         memset(&g_wifiSrvcObj,0,sizeof(SYS_WIFI_OBJ));
@@ -46,6 +46,24 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 #include "definitions.h"
 #include "configuration.h"
 #include "system/wifiprov/sys_wifiprov.h"
+#include "system/wifiprov/src/sys_wifiprov_journal.h"
+
+/* Number of flash pages of the configuration journal. The journal ends with
+   the page at SYS_WIFIPROV_NVMADDR and grows toward lower addresses; the
+   linker script keeps these pages out of the program memory. */
+#ifndef SYS_WIFIPROV_NVM_PAGES
+#define SYS_WIFIPROV_NVM_PAGES                  2
+#endif
+
+#define SYS_WIFIPROV_JOURNAL_ADDR   (SYS_WIFIPROV_NVMADDR - ((SYS_WIFIPROV_NVM_PAGES - 1) * NVM_FLASH_PAGESIZE))
+
+#if (SYS_WIFIPROV_NVM_PAGES < 2)
+#error "The Wi-Fi provisioning journal needs at least two NVM pages"
+#endif
+
+#if (SYS_WIFIPROV_JOURNAL_ROW_SIZE != NVM_FLASH_ROWSIZE) || (SYS_WIFIPROV_JOURNAL_PAGE_SIZE != NVM_FLASH_PAGESIZE)
+#error "The Wi-Fi provisioning journal geometry does not match the NVM"
+#endif
 
 
 // *****************************************************************************
@@ -90,6 +108,15 @@ static  SYS_WIFIPROV_CONFIG   g_wifiProvSrvcConfig CACHE_ALIGN;
 /* Wi-Fi Provisioning read Configuration*/
 static  SYS_WIFIPROV_CONFIG   g_wifiProvSrvcConfigRead;
 
+/* Wi-Fi Provisioning configuration journal */
+static  SYS_WIFIPROV_JOURNAL  g_wifiProvSrvcJournal CACHE_ALIGN;
+
+/* Wi-Fi Provisioning journal NVM access */
+static const SYS_WIFIPROV_NVM_INTERFACE g_wifiProvSrvcNvm = 
+{
+    NVM_Read, NVM_RowWrite, NVM_PageErase, NVM_IsBusy
+};
+
 /* Wi-Fi Provisioning Callback */
 static  SYS_WIFIPROV_CALLBACK g_wifiProvSrvcCallBack;
 
@@ -201,23 +228,48 @@ static void SYS_WIFIPROV_CheckConfig(void)
 
 static inline void SYS_WIFIPROV_NVMRead(void) 
 {
-    /* Start the NVM read operation */
+    /* Read the newest configuration saved in the journal */
     g_wifiProvSrvcObj.nvmTypeOfOperation = SYS_WIFIPROV_NVM_READ;
-    NVM_Read((uint32_t *)&g_wifiProvSrvcConfigRead, sizeof (g_wifiProvSrvcConfigRead), SYS_WIFIPROV_NVMADDR);
+    if (!SYS_WIFIPROV_JOURNAL_Find(&g_wifiProvSrvcJournal, &g_wifiProvSrvcConfigRead, sizeof (g_wifiProvSrvcConfigRead)))
+    {
+        /* Fall back to a configuration saved at SYS_WIFIPROV_NVMADDR without 
+           the journal; a journal record there does not hold a valid mode */
+        NVM_Read((uint32_t *)&g_wifiProvSrvcConfigRead, sizeof (g_wifiProvSrvcConfigRead), SYS_WIFIPROV_NVMADDR);
+        if ((SYS_WIFIPROV_STA != g_wifiProvSrvcConfigRead.mode) && (SYS_WIFIPROV_AP != g_wifiProvSrvcConfigRead.mode))
+        {
+            g_wifiProvSrvcConfigRead.saveConfig = 0xFF;
+        }
+    }
 }
 
-static inline void SYS_WIFIPROV_NVMWrite(void) 
+static inline bool SYS_WIFIPROV_NVMAppend(void) 
 {
-    /* Start the NVM Write operation */
-    g_wifiProvSrvcObj.nvmTypeOfOperation = SYS_WIFIPROV_NVM_WRITE;
-    NVM_RowWrite((uint32_t *)&g_wifiProvSrvcConfig, SYS_WIFIPROV_NVMADDR);
+    /* Start appending the configuration to the journal; a page is only 
+       erased when the journal moves into it */
+    g_wifiProvSrvcObj.nvmTypeOfOperation = SYS_WIFIPROV_NVM_ERASE;
+    return SYS_WIFIPROV_JOURNAL_Append(&g_wifiProvSrvcJournal, &g_wifiProvSrvcConfig, sizeof (g_wifiProvSrvcConfig));
 }
 
-static inline void SYS_WIFIPROV_NVMErase(void) 
+static inline bool SYS_WIFIPROV_NVMWrite(void) 
 {
-    /* Start the NVM Erase operation */
-    g_wifiProvSrvcObj.nvmTypeOfOperation = SYS_WIFIPROV_NVM_ERASE;
-    NVM_PageErase(SYS_WIFIPROV_NVMADDR);
+    /* Run the journal write, without waiting on the NVM controller */
+    g_wifiProvSrvcObj.nvmTypeOfOperation = SYS_WIFIPROV_NVM_WRITE;
+    switch (SYS_WIFIPROV_JOURNAL_Tasks(&g_wifiProvSrvcJournal))
+    {
+        case SYS_WIFIPROV_JOURNAL_STATUS_BUSY:
+        {
+            return false;
+        }
+        case SYS_WIFIPROV_JOURNAL_STATUS_ERROR:
+        {
+            SYS_CONSOLE_MESSAGE("Failed to save the Wi-Fi configuration in NVM\r\n");
+            return true;
+        }
+        default:
+        {
+            return true;
+        }
+    }
 }
 static void SYS_WIFIPROV_PrintConfig(void) 
 {
@@ -276,11 +328,10 @@ static SYS_WIFIPROV_STATUS SYS_WIFIPROV_ExecuteBlock
 
             case SYS_WIFIPROV_STATUS_NVM_ERASE:
             {
-                /* Check if NVM flash performing any operation */
-                if (!NVM_IsBusy()) 
+                /* Finish a previous save before starting the next one */
+                if ((SYS_WIFIPROV_JOURNAL_STATUS_BUSY != SYS_WIFIPROV_JOURNAL_Tasks(&g_wifiProvSrvcJournal))
+                        && SYS_WIFIPROV_NVMAppend()) 
                 {
-                    /* Start the NVM Erase Operation */
-                    SYS_WIFIPROV_NVMErase();                      
                     wifiProvSrvcObj->status = SYS_WIFIPROV_STATUS_NVM_WRITE;
                 }
                 break;
@@ -288,11 +339,9 @@ static SYS_WIFIPROV_STATUS SYS_WIFIPROV_ExecuteBlock
 
             case SYS_WIFIPROV_STATUS_NVM_WRITE:
             {
-                /* Check if NVM flash performing any operation */
-                if (!NVM_IsBusy()) 
+                /* Erase (if needed), write and verify the journal record */
+                if (SYS_WIFIPROV_NVMWrite()) 
                 {
-                    /* Start the NVM Write operation */
-                    SYS_WIFIPROV_NVMWrite();                      
                     wifiProvSrvcObj->status = SYS_WIFIPROV_STATUS_WAITFORWRITE;
                 }
                 break;
@@ -618,6 +667,7 @@ SYS_MODULE_OBJ SYS_WIFIPROV_Initialize
     
     if (SYS_WIFIPROV_STATUS_NONE == SYS_WIFIPROV_GetTaskstatus()) 
     {
+        SYS_WIFIPROV_JOURNAL_Initialize(&g_wifiProvSrvcJournal, &g_wifiProvSrvcNvm, SYS_WIFIPROV_JOURNAL_ADDR, SYS_WIFIPROV_NVM_PAGES);
         /* Set Wi-Fi provisioning service cookie */
         SYS_WIFIPROV_SetCookie(cookie);
         SYS_WIFIPROV_InitConfig(config);
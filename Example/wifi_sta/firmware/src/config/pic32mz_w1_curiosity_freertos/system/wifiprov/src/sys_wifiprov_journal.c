@@ -0,0 +1,382 @@
+/*******************************************************************************
+  Wi-Fi Provision System Service Configuration Journal Implementation
+
+  File Name:
+    sys_wifiprov_journal.c
+
+  Summary:
+    Source code for the Wi-Fi provisioning configuration journal.
+
+  Description:
+    Records are written to consecutive rows of the ring, each with a sequence
+    number one higher than the previous record. The newest record is the
+    valid one with the highest sequence number; the whole ring is scanned for
+    it, so the ring can span any number of pages.
+ *******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+Copyright (C) 2020 released Microchip Technology Inc.  All rights reserved.
+
+Microchip licenses to you the right to use, modify, copy and distribute
+Software only when embedded on a Microchip microcontroller or digital signal
+controller that is integrated into your product or third party product
+(pursuant to the sublicense terms in the accompanying license agreement).
+
+You should refer to the license agreement accompanying this Software for
+additional information regarding your rights and obligations.
+
+SOFTWARE AND DOCUMENTATION ARE PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF
+MERCHANTABILITY, TITLE, NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE.
+IN NO EVENT SHALL MICROCHIP OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER
+CONTRACT, NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR
+OTHER LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR
+CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT OF
+SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+(INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "sys_wifiprov_journal.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define SYS_WIFIPROV_JOURNAL_MAGIC          0x4A575057      // "WPWJ"
+#define SYS_WIFIPROV_JOURNAL_VERSION        1
+#define SYS_WIFIPROV_JOURNAL_ERASED         0xFFFFFFFF
+
+/* Flash is read in chunks of this size when scanning or verifying */
+#define SYS_WIFIPROV_JOURNAL_CHUNK_SIZE     64
+
+typedef struct
+{
+    uint32_t magic;
+    /* Never SYS_WIFIPROV_JOURNAL_ERASED */
+    uint32_t sequence;
+    uint16_t length;
+    uint16_t version;
+    /* CRC-32 of the fields above and the payload */
+    uint32_t crc;
+} SYS_WIFIPROV_JOURNAL_HEADER;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+static uint32_t SYS_WIFIPROV_JOURNAL_Crc
+(
+    uint32_t crc,
+    const uint8_t *data,
+    size_t length
+)
+{
+    /* CRC-32 (IEEE 802.3), bitwise: records are small and written rarely */
+    crc = ~crc;
+    while (length--)
+    {
+        uint8_t bit;
+
+        crc ^= *data++;
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+static inline uint32_t SYS_WIFIPROV_JOURNAL_SlotAddress
+(
+    const SYS_WIFIPROV_JOURNAL *journal,
+    uint32_t slot
+)
+{
+    return journal->address + (slot * SYS_WIFIPROV_JOURNAL_ROW_SIZE);
+}
+
+static inline SYS_WIFIPROV_JOURNAL_HEADER *SYS_WIFIPROV_JOURNAL_RowHeader
+(
+    SYS_WIFIPROV_JOURNAL *journal
+)
+{
+    return (SYS_WIFIPROV_JOURNAL_HEADER *) journal->row;
+}
+
+static inline uint8_t *SYS_WIFIPROV_JOURNAL_RowPayload
+(
+    SYS_WIFIPROV_JOURNAL *journal
+)
+{
+    return (uint8_t *) journal->row + SYS_WIFIPROV_JOURNAL_HEADER_SIZE;
+}
+
+/* Read a row into the row buffer and check it holds a valid record */
+static bool SYS_WIFIPROV_JOURNAL_ReadRecord
+(
+    SYS_WIFIPROV_JOURNAL *journal,
+    uint32_t slot,
+    uint16_t length
+)
+{
+    SYS_WIFIPROV_JOURNAL_HEADER *header = SYS_WIFIPROV_JOURNAL_RowHeader(journal);
+    uint32_t address = SYS_WIFIPROV_JOURNAL_SlotAddress(journal, slot);
+
+    journal->nvm->read(journal->row, SYS_WIFIPROV_JOURNAL_HEADER_SIZE, address);
+    if ((SYS_WIFIPROV_JOURNAL_MAGIC != header->magic)
+            || (SYS_WIFIPROV_JOURNAL_ERASED == header->sequence)
+            || (SYS_WIFIPROV_JOURNAL_VERSION != header->version)
+            || (length != header->length))
+    {
+        return false;
+    }
+
+    journal->nvm->read((uint32_t *) SYS_WIFIPROV_JOURNAL_RowPayload(journal), length, address + SYS_WIFIPROV_JOURNAL_HEADER_SIZE);
+    return header->crc == SYS_WIFIPROV_JOURNAL_Crc(SYS_WIFIPROV_JOURNAL_Crc(0, (const uint8_t *) header, offsetof(SYS_WIFIPROV_JOURNAL_HEADER, crc)),
+            SYS_WIFIPROV_JOURNAL_RowPayload(journal), length);
+}
+
+/* Compare flash with data, or with erased bytes when data is NULL */
+static bool SYS_WIFIPROV_JOURNAL_Compare
+(
+    SYS_WIFIPROV_JOURNAL *journal,
+    uint32_t address,
+    const uint8_t *data,
+    uint32_t length
+)
+{
+    uint32_t chunk[SYS_WIFIPROV_JOURNAL_CHUNK_SIZE / sizeof(uint32_t)];
+    uint32_t offset;
+    uint32_t index;
+
+    for (offset = 0; offset < length; offset += sizeof (chunk))
+    {
+        uint32_t size = ((length - offset) < sizeof (chunk)) ? (length - offset) : sizeof (chunk);
+
+        journal->nvm->read(chunk, size, address + offset);
+        if (data)
+        {
+            if (memcmp(chunk, data + offset, size))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            for (index = 0; index < ((size + 3) / sizeof(uint32_t)); index++)
+            {
+                if (SYS_WIFIPROV_JOURNAL_ERASED != chunk[index])
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/* Find the newest record; on success the row buffer holds it */
+static bool SYS_WIFIPROV_JOURNAL_Locate
+(
+    SYS_WIFIPROV_JOURNAL *journal,
+    uint16_t length
+)
+{
+    uint32_t newest = journal->slotCount;
+    uint32_t slot;
+
+    journal->located = true;
+    journal->nextSlot = 0;
+    journal->sequence = 1;
+
+    /* Only a row passing the CRC check is trusted: a write cut by a reset can
+       leave any sequence number in its header. A 32-bit sequence number does
+       not wrap within the flash endurance. */
+    for (slot = 0; slot < journal->slotCount; slot++)
+    {
+        if (SYS_WIFIPROV_JOURNAL_ReadRecord(journal, slot, length)
+                && (SYS_WIFIPROV_JOURNAL_RowHeader(journal)->sequence >= journal->sequence))
+        {
+            newest = slot;
+            journal->sequence = SYS_WIFIPROV_JOURNAL_RowHeader(journal)->sequence + 1;
+        }
+    }
+    if (journal->slotCount == newest)
+    {
+        return false;
+    }
+
+    journal->nextSlot = (newest + 1) % journal->slotCount;
+    return SYS_WIFIPROV_JOURNAL_ReadRecord(journal, newest, length);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+void SYS_WIFIPROV_JOURNAL_Initialize
+(
+    SYS_WIFIPROV_JOURNAL *journal,
+    const SYS_WIFIPROV_NVM_INTERFACE *nvm,
+    uint32_t address,
+    uint32_t pageCount
+)
+{
+    memset(journal, 0, sizeof (*journal));
+    journal->nvm = nvm;
+    journal->address = address;
+    journal->slotCount = pageCount * SYS_WIFIPROV_JOURNAL_ROWS_PER_PAGE;
+    journal->state = SYS_WIFIPROV_JOURNAL_STATE_IDLE;
+}
+
+bool SYS_WIFIPROV_JOURNAL_Find
+(
+    SYS_WIFIPROV_JOURNAL *journal,
+    void *data,
+    uint16_t length
+)
+{
+    if ((SYS_WIFIPROV_JOURNAL_STATE_IDLE != journal->state) || (length > SYS_WIFIPROV_JOURNAL_MAX_LENGTH))
+    {
+        return false;
+    }
+
+    if (!SYS_WIFIPROV_JOURNAL_Locate(journal, length))
+    {
+        return false;
+    }
+
+    memcpy(data, SYS_WIFIPROV_JOURNAL_RowPayload(journal), length);
+    return true;
+}
+
+bool SYS_WIFIPROV_JOURNAL_Append
+(
+    SYS_WIFIPROV_JOURNAL *journal,
+    const void *data,
+    uint16_t length
+)
+{
+    SYS_WIFIPROV_JOURNAL_HEADER *header = SYS_WIFIPROV_JOURNAL_RowHeader(journal);
+    uint32_t slot;
+
+    if ((SYS_WIFIPROV_JOURNAL_STATE_IDLE != journal->state) || (length > SYS_WIFIPROV_JOURNAL_MAX_LENGTH)
+            || (journal->slotCount < (2 * SYS_WIFIPROV_JOURNAL_ROWS_PER_PAGE)))
+    {
+        return false;
+    }
+
+    if (!journal->located)
+    {
+        SYS_WIFIPROV_JOURNAL_Locate(journal, length);
+    }
+
+    /* Rows can only be programmed once erased: skip to the next page if the
+       next row was left programmed (write cut by a reset, older layout) */
+    slot = journal->nextSlot;
+    if ((0 != (slot % SYS_WIFIPROV_JOURNAL_ROWS_PER_PAGE))
+            && !SYS_WIFIPROV_JOURNAL_Compare(journal, SYS_WIFIPROV_JOURNAL_SlotAddress(journal, slot), NULL, SYS_WIFIPROV_JOURNAL_ROW_SIZE))
+    {
+        slot = ((slot / SYS_WIFIPROV_JOURNAL_ROWS_PER_PAGE) + 1) * SYS_WIFIPROV_JOURNAL_ROWS_PER_PAGE;
+        slot %= journal->slotCount;
+    }
+    journal->nextSlot = slot;
+
+    /* Entering a page: erase it unless it is still blank (first pass) */
+    journal->state = SYS_WIFIPROV_JOURNAL_STATE_WRITE;
+    if ((0 == (slot % SYS_WIFIPROV_JOURNAL_ROWS_PER_PAGE))
+            && !SYS_WIFIPROV_JOURNAL_Compare(journal, SYS_WIFIPROV_JOURNAL_SlotAddress(journal, slot), NULL, SYS_WIFIPROV_JOURNAL_PAGE_SIZE))
+    {
+        journal->state = SYS_WIFIPROV_JOURNAL_STATE_ERASE;
+    }
+
+    memset(journal->row, 0xFF, sizeof (journal->row));
+    header->magic = SYS_WIFIPROV_JOURNAL_MAGIC;
+    header->sequence = journal->sequence;
+    header->length = length;
+    header->version = SYS_WIFIPROV_JOURNAL_VERSION;
+    memcpy(SYS_WIFIPROV_JOURNAL_RowPayload(journal), data, length);
+    header->crc = SYS_WIFIPROV_JOURNAL_Crc(SYS_WIFIPROV_JOURNAL_Crc(0, (const uint8_t *) header, offsetof(SYS_WIFIPROV_JOURNAL_HEADER, crc)),
+            SYS_WIFIPROV_JOURNAL_RowPayload(journal), length);
+
+    return true;
+}
+
+SYS_WIFIPROV_JOURNAL_STATUS SYS_WIFIPROV_JOURNAL_Tasks
+(
+    SYS_WIFIPROV_JOURNAL *journal
+)
+{
+    SYS_WIFIPROV_JOURNAL_HEADER *header = SYS_WIFIPROV_JOURNAL_RowHeader(journal);
+    uint32_t address = SYS_WIFIPROV_JOURNAL_SlotAddress(journal, journal->nextSlot);
+
+    switch (journal->state)
+    {
+        case SYS_WIFIPROV_JOURNAL_STATE_ERASE:
+        {
+            if (!journal->nvm->isBusy())
+            {
+                journal->state = journal->nvm->pageErase(address) ? SYS_WIFIPROV_JOURNAL_STATE_WRITE : SYS_WIFIPROV_JOURNAL_STATE_IDLE;
+                if (SYS_WIFIPROV_JOURNAL_STATE_IDLE == journal->state)
+                {
+                    return SYS_WIFIPROV_JOURNAL_STATUS_ERROR;
+                }
+            }
+            return SYS_WIFIPROV_JOURNAL_STATUS_BUSY;
+        }
+
+        case SYS_WIFIPROV_JOURNAL_STATE_WRITE:
+        {
+            if (!journal->nvm->isBusy())
+            {
+                journal->state = journal->nvm->rowWrite(journal->row, address) ? SYS_WIFIPROV_JOURNAL_STATE_VERIFY : SYS_WIFIPROV_JOURNAL_STATE_IDLE;
+                if (SYS_WIFIPROV_JOURNAL_STATE_IDLE == journal->state)
+                {
+                    return SYS_WIFIPROV_JOURNAL_STATUS_ERROR;
+                }
+            }
+            return SYS_WIFIPROV_JOURNAL_STATUS_BUSY;
+        }
+
+        case SYS_WIFIPROV_JOURNAL_STATE_VERIFY:
+        {
+            if (journal->nvm->isBusy())
+            {
+                return SYS_WIFIPROV_JOURNAL_STATUS_BUSY;
+            }
+
+            /* The row is programmed either way: move past it */
+            journal->state = SYS_WIFIPROV_JOURNAL_STATE_IDLE;
+            journal->nextSlot = (journal->nextSlot + 1) % journal->slotCount;
+            journal->sequence++;
+            if (!SYS_WIFIPROV_JOURNAL_Compare(journal, address, (const uint8_t *) journal->row, SYS_WIFIPROV_JOURNAL_HEADER_SIZE + header->length))
+            {
+                return SYS_WIFIPROV_JOURNAL_STATUS_ERROR;
+            }
+            return SYS_WIFIPROV_JOURNAL_STATUS_READY;
+        }
+
+        case SYS_WIFIPROV_JOURNAL_STATE_IDLE:
+        default:
+        {
+            return SYS_WIFIPROV_JOURNAL_STATUS_READY;
+        }
+    }
+}
+
+/* *****************************************************************************
+ End of File
+ */
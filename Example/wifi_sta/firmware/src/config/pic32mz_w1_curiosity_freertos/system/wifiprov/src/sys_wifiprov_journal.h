@@ -0,0 +1,266 @@
+/*******************************************************************************
+  Wi-Fi Provision System Service Configuration Journal
+
+  File Name:
+    sys_wifiprov_journal.h
+
+  Summary:
+    Wear-leveled, append-only store of the Wi-Fi provisioning configuration.
+
+  Description:
+    The journal keeps the saved configuration in a ring of NVM rows spread over
+    several flash pages. Every save appends a new record (sequence number,
+    format version, length and CRC-32 followed by the configuration) to the
+    next erased row; a page is erased only when the ring moves into it. On
+    boot the newest valid record is located with a scan of the ring.
+
+    The NVM access goes through SYS_WIFIPROV_NVM_INTERFACE so that the journal
+    can run on the flash controller (NVM plib) or on a RAM simulation on a
+    development host.
+ *******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+Copyright (C) 2020 released Microchip Technology Inc.  All rights reserved.
+
+Microchip licenses to you the right to use, modify, copy and distribute
+Software only when embedded on a Microchip microcontroller or digital signal
+controller that is integrated into your product or third party product
+(pursuant to the sublicense terms in the accompanying license agreement).
+
+You should refer to the license agreement accompanying this Software for
+additional information regarding your rights and obligations.
+
+SOFTWARE AND DOCUMENTATION ARE PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF
+MERCHANTABILITY, TITLE, NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE.
+IN NO EVENT SHALL MICROCHIP OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER
+CONTRACT, NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR
+OTHER LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR
+CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT OF
+SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+(INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef _SYS_WIFIPROV_JOURNAL_H
+#define _SYS_WIFIPROV_JOURNAL_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+    extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Constants
+// *****************************************************************************
+// *****************************************************************************
+
+/* Flash row (one record) and page (erase unit) sizes, NVM_FLASH_ROWSIZE and
+   NVM_FLASH_PAGESIZE on the PIC32MZ W1 */
+#ifndef SYS_WIFIPROV_JOURNAL_ROW_SIZE
+#define SYS_WIFIPROV_JOURNAL_ROW_SIZE       1024
+#endif
+
+#ifndef SYS_WIFIPROV_JOURNAL_PAGE_SIZE
+#define SYS_WIFIPROV_JOURNAL_PAGE_SIZE      4096
+#endif
+
+#define SYS_WIFIPROV_JOURNAL_ROWS_PER_PAGE  (SYS_WIFIPROV_JOURNAL_PAGE_SIZE / SYS_WIFIPROV_JOURNAL_ROW_SIZE)
+
+/* Record header: magic, sequence, length, version and CRC-32 */
+#define SYS_WIFIPROV_JOURNAL_HEADER_SIZE    16
+
+/* Largest record payload */
+#define SYS_WIFIPROV_JOURNAL_MAX_LENGTH     (SYS_WIFIPROV_JOURNAL_ROW_SIZE - SYS_WIFIPROV_JOURNAL_HEADER_SIZE)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* NVM access functions
+
+  Summary:
+    Flash operations used by the journal.
+
+  Description:
+    The functions have the same signatures and semantics as the NVM plib
+    functions: reads are synchronous, row writes and page erases are started
+    and then polled for completion with isBusy.
+*/
+typedef struct
+{
+    bool (*read)(uint32_t *data, uint32_t length, const uint32_t address);
+    bool (*rowWrite)(uint32_t *data, uint32_t address);
+    bool (*pageErase)(uint32_t address);
+    bool (*isBusy)(void);
+} SYS_WIFIPROV_NVM_INTERFACE;
+
+// *****************************************************************************
+/* Journal status
+
+  Summary:
+    Result of SYS_WIFIPROV_JOURNAL_Tasks().
+*/
+typedef enum
+{
+    /* No record is being written */
+    SYS_WIFIPROV_JOURNAL_STATUS_READY = 0,
+    /* A record is being written */
+    SYS_WIFIPROV_JOURNAL_STATUS_BUSY,
+    /* The last record could not be written or did not read back */
+    SYS_WIFIPROV_JOURNAL_STATUS_ERROR
+} SYS_WIFIPROV_JOURNAL_STATUS;
+
+typedef enum
+{
+    SYS_WIFIPROV_JOURNAL_STATE_IDLE = 0,
+    SYS_WIFIPROV_JOURNAL_STATE_ERASE,
+    SYS_WIFIPROV_JOURNAL_STATE_WRITE,
+    SYS_WIFIPROV_JOURNAL_STATE_VERIFY
+} SYS_WIFIPROV_JOURNAL_STATE;
+
+// *****************************************************************************
+/* Journal object
+
+  Summary:
+    State of one configuration journal.
+
+  Remarks:
+    The row buffer is the source of the row write; on the target the object
+    must be declared CACHE_ALIGN.
+*/
+typedef struct
+{
+    /* Record being written or read, padded with erased bytes to a row */
+    uint32_t row[SYS_WIFIPROV_JOURNAL_ROW_SIZE / sizeof(uint32_t)];
+    const SYS_WIFIPROV_NVM_INTERFACE *nvm;
+    /* Address of the first row of the ring */
+    uint32_t address;
+    /* Number of rows in the ring */
+    uint32_t slotCount;
+    /* Row the next record is written to */
+    uint32_t nextSlot;
+    /* Sequence number of the next record */
+    uint32_t sequence;
+    /* The newest record has been located */
+    bool located;
+    SYS_WIFIPROV_JOURNAL_STATE state;
+} SYS_WIFIPROV_JOURNAL;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void SYS_WIFIPROV_JOURNAL_Initialize(SYS_WIFIPROV_JOURNAL *journal,
+            const SYS_WIFIPROV_NVM_INTERFACE *nvm, uint32_t address,
+            uint32_t pageCount)
+
+  Summary:
+    Initializes a journal over pageCount flash pages starting at address.
+
+  Remarks:
+    At least two pages are needed: the page holding the newest record is
+    never erased.
+*/
+void SYS_WIFIPROV_JOURNAL_Initialize
+(
+    SYS_WIFIPROV_JOURNAL *journal,
+    const SYS_WIFIPROV_NVM_INTERFACE *nvm,
+    uint32_t address,
+    uint32_t pageCount
+);
+
+/*******************************************************************************
+  Function:
+    bool SYS_WIFIPROV_JOURNAL_Find(SYS_WIFIPROV_JOURNAL *journal, void *data,
+            uint16_t length)
+
+  Summary:
+    Reads the newest valid record.
+
+  Description:
+    Scans the ring for the valid record with the highest sequence number and
+    copies it to data. Torn or corrupted records are ignored, so the newest
+    intact record is returned.
+
+  Returns:
+    - true  - data holds the newest valid record of the given length.
+    - false - the journal holds no valid record; data is left unchanged.
+*/
+bool SYS_WIFIPROV_JOURNAL_Find
+(
+    SYS_WIFIPROV_JOURNAL *journal,
+    void *data,
+    uint16_t length
+);
+
+/*******************************************************************************
+  Function:
+    bool SYS_WIFIPROV_JOURNAL_Append(SYS_WIFIPROV_JOURNAL *journal,
+            const void *data, uint16_t length)
+
+  Summary:
+    Starts appending a record.
+
+  Description:
+    Copies data into the journal and selects the row to write; the flash
+    operations are then run by SYS_WIFIPROV_JOURNAL_Tasks(). A page erase is
+    only issued when the record is the first one written to a page that is
+    not already erased.
+
+  Returns:
+    - true  - the record is being written.
+    - false - a record is already being written or length is too large.
+*/
+bool SYS_WIFIPROV_JOURNAL_Append
+(
+    SYS_WIFIPROV_JOURNAL *journal,
+    const void *data,
+    uint16_t length
+);
+
+/*******************************************************************************
+  Function:
+    SYS_WIFIPROV_JOURNAL_STATUS SYS_WIFIPROV_JOURNAL_Tasks(
+            SYS_WIFIPROV_JOURNAL *journal)
+
+  Summary:
+    Advances the record being written; never waits for the flash.
+
+  Returns:
+    SYS_WIFIPROV_JOURNAL_STATUS_BUSY until the record is written and read
+    back, then SYS_WIFIPROV_JOURNAL_STATUS_READY, or
+    SYS_WIFIPROV_JOURNAL_STATUS_ERROR once if it failed.
+*/
+SYS_WIFIPROV_JOURNAL_STATUS SYS_WIFIPROV_JOURNAL_Tasks
+(
+    SYS_WIFIPROV_JOURNAL *journal
+);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _SYS_WIFIPROV_JOURNAL_H */
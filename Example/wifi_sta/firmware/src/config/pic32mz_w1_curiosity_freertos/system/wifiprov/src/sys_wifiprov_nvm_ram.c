@@ -0,0 +1,213 @@
+/*******************************************************************************
+  Wi-Fi Provision System Service RAM-simulated NVM Implementation
+
+  File Name:
+    sys_wifiprov_nvm_ram.c
+
+  Summary:
+    Host implementation of the NVM interface used by the configuration journal.
+
+  Description:
+    This file implements SYS_WIFIPROV_NVM_INTERFACE on a RAM array so that the
+    configuration journal can be exercised on a development machine. It is
+    not part of the target build.
+ *******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+Copyright (C) 2020 released Microchip Technology Inc.  All rights reserved.
+
+Microchip licenses to you the right to use, modify, copy and distribute
+Software only when embedded on a Microchip microcontroller or digital signal
+controller that is integrated into your product or third party product
+(pursuant to the sublicense terms in the accompanying license agreement).
+
+You should refer to the license agreement accompanying this Software for
+additional information regarding your rights and obligations.
+
+SOFTWARE AND DOCUMENTATION ARE PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF
+MERCHANTABILITY, TITLE, NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE.
+IN NO EVENT SHALL MICROCHIP OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER
+CONTRACT, NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR
+OTHER LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR
+CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT OF
+SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+(INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *******************************************************************************/
+//DOM-IGNORE-END
+
+#include <stdlib.h>
+#include <string.h>
+#include "sys_wifiprov_nvm_ram.h"
+
+#define SYS_WIFIPROV_NVM_RAM_NO_TEAR        0xFFFFFFFF
+
+typedef struct
+{
+    uint8_t *memory;
+    uint32_t *pageErases;
+    uint32_t address;
+    uint32_t size;
+    uint32_t erasePolls;
+    uint32_t writePolls;
+    uint32_t busy;
+    uint32_t tearBytes;
+    SYS_WIFIPROV_NVM_RAM_STATS stats;
+} SYS_WIFIPROV_NVM_RAM;
+
+static SYS_WIFIPROV_NVM_RAM g_nvmRam;
+
+static uint8_t *SYS_WIFIPROV_NVM_RAM_Map(uint32_t address, uint32_t length)
+{
+    if ((NULL == g_nvmRam.memory) || (address < g_nvmRam.address)
+            || ((address - g_nvmRam.address) > g_nvmRam.size)
+            || (length > (g_nvmRam.size - (address - g_nvmRam.address))))
+    {
+        return NULL;
+    }
+    return g_nvmRam.memory + (address - g_nvmRam.address);
+}
+
+static bool SYS_WIFIPROV_NVM_RAM_Read(uint32_t *data, uint32_t length, const uint32_t address)
+{
+    const uint8_t *source = SYS_WIFIPROV_NVM_RAM_Map(address, length);
+
+    if (NULL == source)
+    {
+        return false;
+    }
+    memcpy(data, source, length);
+    g_nvmRam.stats.reads++;
+    g_nvmRam.stats.bytesRead += length;
+    return true;
+}
+
+static bool SYS_WIFIPROV_NVM_RAM_RowWrite(uint32_t *data, uint32_t address)
+{
+    uint8_t *target = SYS_WIFIPROV_NVM_RAM_Map(address, SYS_WIFIPROV_JOURNAL_ROW_SIZE);
+    const uint8_t *source = (const uint8_t *) data;
+    uint32_t length = SYS_WIFIPROV_JOURNAL_ROW_SIZE;
+    uint32_t index;
+
+    if ((NULL == target) || (0 != (address % SYS_WIFIPROV_JOURNAL_ROW_SIZE)))
+    {
+        return false;
+    }
+    if (g_nvmRam.busy)
+    {
+        g_nvmRam.stats.busyViolations++;
+    }
+
+    if (g_nvmRam.tearBytes < length)
+    {
+        length = g_nvmRam.tearBytes;
+        g_nvmRam.tearBytes = SYS_WIFIPROV_NVM_RAM_NO_TEAR;
+    }
+
+    /* Programming can only clear bits */
+    for (index = 0; index < length; index++)
+    {
+        target[index] &= source[index];
+    }
+
+    g_nvmRam.stats.rowWrites++;
+    g_nvmRam.busy = g_nvmRam.writePolls;
+    return true;
+}
+
+static bool SYS_WIFIPROV_NVM_RAM_PageErase(uint32_t address)
+{
+    uint8_t *target = SYS_WIFIPROV_NVM_RAM_Map(address, SYS_WIFIPROV_JOURNAL_PAGE_SIZE);
+
+    if ((NULL == target) || (0 != (address % SYS_WIFIPROV_JOURNAL_PAGE_SIZE)))
+    {
+        return false;
+    }
+    if (g_nvmRam.busy)
+    {
+        g_nvmRam.stats.busyViolations++;
+    }
+
+    memset(target, 0xFF, SYS_WIFIPROV_JOURNAL_PAGE_SIZE);
+    g_nvmRam.pageErases[(address - g_nvmRam.address) / SYS_WIFIPROV_JOURNAL_PAGE_SIZE]++;
+    g_nvmRam.stats.pageErases++;
+    g_nvmRam.busy = g_nvmRam.erasePolls;
+    return true;
+}
+
+static bool SYS_WIFIPROV_NVM_RAM_IsBusy(void)
+{
+    if (g_nvmRam.busy)
+    {
+        g_nvmRam.busy--;
+        g_nvmRam.stats.busyPolls++;
+        return true;
+    }
+    return false;
+}
+
+const SYS_WIFIPROV_NVM_INTERFACE sysWifiProvNvmRam =
+{
+    .read = SYS_WIFIPROV_NVM_RAM_Read,
+    .rowWrite = SYS_WIFIPROV_NVM_RAM_RowWrite,
+    .pageErase = SYS_WIFIPROV_NVM_RAM_PageErase,
+    .isBusy = SYS_WIFIPROV_NVM_RAM_IsBusy,
+};
+
+bool SYS_WIFIPROV_NVM_RAM_Initialize(uint32_t address, uint32_t pageCount, uint32_t erasePolls, uint32_t writePolls)
+{
+    SYS_WIFIPROV_NVM_RAM_Deinitialize();
+
+    g_nvmRam.size = pageCount * SYS_WIFIPROV_JOURNAL_PAGE_SIZE;
+    g_nvmRam.memory = malloc(g_nvmRam.size);
+    g_nvmRam.pageErases = calloc(pageCount, sizeof (uint32_t));
+    if ((NULL == g_nvmRam.memory) || (NULL == g_nvmRam.pageErases))
+    {
+        SYS_WIFIPROV_NVM_RAM_Deinitialize();
+        return false;
+    }
+
+    memset(g_nvmRam.memory, 0xFF, g_nvmRam.size);
+    g_nvmRam.address = address;
+    g_nvmRam.erasePolls = erasePolls;
+    g_nvmRam.writePolls = writePolls;
+    g_nvmRam.tearBytes = SYS_WIFIPROV_NVM_RAM_NO_TEAR;
+    return true;
+}
+
+void SYS_WIFIPROV_NVM_RAM_Deinitialize(void)
+{
+    free(g_nvmRam.memory);
+    free(g_nvmRam.pageErases);
+    memset(&g_nvmRam, 0, sizeof (g_nvmRam));
+}
+
+uint8_t *SYS_WIFIPROV_NVM_RAM_Memory(void)
+{
+    return g_nvmRam.memory;
+}
+
+void SYS_WIFIPROV_NVM_RAM_TearNextWrite(uint32_t bytes)
+{
+    g_nvmRam.tearBytes = bytes;
+}
+
+void SYS_WIFIPROV_NVM_RAM_Stats(SYS_WIFIPROV_NVM_RAM_STATS *stats, bool clear)
+{
+    *stats = g_nvmRam.stats;
+    if (clear)
+    {
+        memset(&g_nvmRam.stats, 0, sizeof (g_nvmRam.stats));
+    }
+}
+
+uint32_t SYS_WIFIPROV_NVM_RAM_PageErases(uint32_t page)
+{
+    if ((NULL == g_nvmRam.pageErases) || (page >= (g_nvmRam.size / SYS_WIFIPROV_JOURNAL_PAGE_SIZE)))
+    {
+        return 0;
+    }
+    return g_nvmRam.pageErases[page];
+}
@@ -0,0 +1,96 @@
+/*******************************************************************************
+  Wi-Fi Provision System Service RAM-simulated NVM
+
+  File Name:
+    sys_wifiprov_nvm_ram.h
+
+  Summary:
+    RAM simulation of the NVM flash used by the configuration journal.
+
+  Description:
+    This file declares a host implementation of SYS_WIFIPROV_NVM_INTERFACE
+    backed by a RAM array. Programming only clears bits and erasing sets a
+    page back to 0xFF like the flash; row writes and page erases keep the
+    simulated controller busy for a configurable number of polls. Operation
+    and per-page erase counters give the write latency, boot-time lookup cost
+    and wear of the journal. It is not part of the target build.
+ *******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+Copyright (C) 2020 released Microchip Technology Inc.  All rights reserved.
+
+Microchip licenses to you the right to use, modify, copy and distribute
+Software only when embedded on a Microchip microcontroller or digital signal
+controller that is integrated into your product or third party product
+(pursuant to the sublicense terms in the accompanying license agreement).
+
+You should refer to the license agreement accompanying this Software for
+additional information regarding your rights and obligations.
+
+SOFTWARE AND DOCUMENTATION ARE PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF
+MERCHANTABILITY, TITLE, NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE.
+IN NO EVENT SHALL MICROCHIP OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER
+CONTRACT, NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR
+OTHER LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR
+CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT OF
+SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+(INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef _SYS_WIFIPROV_NVM_RAM_H
+#define _SYS_WIFIPROV_NVM_RAM_H
+
+#include "sys_wifiprov_journal.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+    extern "C" {
+#endif
+// DOM-IGNORE-END
+
+/* Simulated flash operation counters */
+typedef struct
+{
+    uint32_t reads;
+    uint32_t bytesRead;
+    uint32_t rowWrites;
+    uint32_t pageErases;
+    /* isBusy calls that returned true */
+    uint32_t busyPolls;
+    /* Operations started while the controller was busy */
+    uint32_t busyViolations;
+} SYS_WIFIPROV_NVM_RAM_STATS;
+
+/* NVM interface of the simulation */
+extern const SYS_WIFIPROV_NVM_INTERFACE sysWifiProvNvmRam;
+
+// Allocate pageCount erased pages at address; erases and row writes stay busy
+// for the given number of isBusy polls
+bool SYS_WIFIPROV_NVM_RAM_Initialize(uint32_t address, uint32_t pageCount, uint32_t erasePolls, uint32_t writePolls);
+
+// Free the simulated flash
+void SYS_WIFIPROV_NVM_RAM_Deinitialize(void);
+
+// Simulated flash contents, pageCount * SYS_WIFIPROV_JOURNAL_PAGE_SIZE bytes
+uint8_t *SYS_WIFIPROV_NVM_RAM_Memory(void);
+
+// Cut the next row write after its first bytes (reset while programming)
+void SYS_WIFIPROV_NVM_RAM_TearNextWrite(uint32_t bytes);
+
+// Get and optionally clear the operation counters
+void SYS_WIFIPROV_NVM_RAM_Stats(SYS_WIFIPROV_NVM_RAM_STATS *stats, bool clear);
+
+// Number of times a page has been erased
+uint32_t SYS_WIFIPROV_NVM_RAM_PageErases(uint32_t page);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _SYS_WIFIPROV_NVM_RAM_H */
@@ -129,6 +129,17 @@ void _SYS_CMD_Tasks(  void *pvParameters  )
     }
 }
 
+#ifdef SYS_NET_MUX_ENABLED
+void _SYS_NET_MUX_Tasks(  void *pvParameters  )
+{
+    while(1)
+    {
+        /* Blocks until a TCP/IP signal or the poll timeout */
+        SYS_NET_MUX_Tasks();
+    }
+}
+#endif
+
 
 static void _WDRV_PIC32MZW1_Tasks(  void *pvParameters  )
 {
@@ -194,6 +205,16 @@ void SYS_Tasks ( void )
         (TaskHandle_t*)NULL
     );
 
+#ifdef SYS_NET_MUX_ENABLED
+    xTaskCreate( _SYS_NET_MUX_Tasks,
+        "SYS_NET_MUX_TASKS",
+        SYS_NET_MUX_RTOS_STACK_SIZE,
+        (void*)NULL,
+        SYS_NET_MUX_RTOS_TASK_PRIORITY,
+        (TaskHandle_t*)NULL
+    );
+#endif
+
 
 
 
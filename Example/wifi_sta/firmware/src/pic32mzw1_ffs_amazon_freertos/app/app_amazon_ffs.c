@@ -112,13 +112,25 @@ FFS_STATE_t FFS_Tasks(SYSTEM_OBJECTS *sysObj)
         }
         case FFS_STATE_START:
         {            
-            if(ffsProvisionDevice(&ffsProvisionObj) == FFS_PROVISIONING_RESULT_PROVISIONED)
+            if(ffsProvisionDeviceStart(&ffsProvisionObj) == FFS_PROVISIONING_RESULT_PROVISIONED)
             {                                                            
-                gFfsTaskState = FFS_STATE_DONE;  
+                gFfsTaskState = FFS_STATE_PROVISIONING;  
             }                     
             break;    
         }       
         
+        case FFS_STATE_PROVISIONING:
+        {
+            FFS_PROVISIONING_RESULT provisioningResult;
+            
+            /* Poll provisioning; the call returns without waiting on the network */
+            if(ffsProvisionDeviceStep(&provisioningResult))
+            {
+                gFfsTaskState = (provisioningResult == FFS_PROVISIONING_RESULT_PROVISIONED) ? FFS_STATE_DONE : FFS_STATE_START;
+            }
+            break;
+        }
+        
         case FFS_STATE_DONE:
         {
             FFS_DeInit(); 
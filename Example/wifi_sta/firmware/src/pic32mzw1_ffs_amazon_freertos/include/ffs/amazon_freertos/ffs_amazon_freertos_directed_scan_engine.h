@@ -0,0 +1,125 @@
+/** @file ffs_amazon_freertos_directed_scan_engine.h
+ *
+ * @brief Radio-independent directed-scan scheduling.
+ *
+ * Probes one channel at a time for a given SSID and stops on the first
+ * match. The channels are ordered by the channel the SSID was last found
+ * on, then the social channels 1, 6 and 11, then the remaining enabled
+ * channels. Each channel has its own active-probe dwell time, starting
+ * short and doubling on every pass that does not find the SSID there.
+ *
+ * @copyright 2020 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#ifndef FFS_AMAZON_FREERTOS_DIRECTED_SCAN_ENGINE_H_
+#define FFS_AMAZON_FREERTOS_DIRECTED_SCAN_ENGINE_H_
+
+#include "ffs/common/ffs_result.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FFS_DIRECTED_SCAN_MAX_CHANNEL       (13)    /**< Highest 2.4GHz channel probed */
+#define FFS_DIRECTED_SCAN_ALL_CHANNELS      (0x1FFF) /**< Channel mask of channels 1 to 13 */
+
+#ifndef FFS_MAX_RETRY_DIRECTED_SCAN
+#define FFS_MAX_RETRY_DIRECTED_SCAN         (8)     /**< Passes over the enabled channels */
+#endif
+
+#ifndef FFS_DIRECTED_SCAN_MAX_TIME_MS
+#define FFS_DIRECTED_SCAN_MAX_TIME_MS       (2000)  /**< Total dwell time before giving up */
+#endif
+
+#ifndef FFS_DIRECTED_SCAN_MIN_DWELL_MS
+#define FFS_DIRECTED_SCAN_MIN_DWELL_MS      (20)    /**< First active-probe dwell time on a channel */
+#endif
+
+#ifndef FFS_DIRECTED_SCAN_MAX_DWELL_MS
+#define FFS_DIRECTED_SCAN_MAX_DWELL_MS      (160)   /**< Longest active-probe dwell time on a channel */
+#endif
+
+#ifndef FFS_DIRECTED_SCAN_DWELL_GROWTH
+#define FFS_DIRECTED_SCAN_DWELL_GROWTH      (4)     /**< Dwell time factor after a missed pass */
+#endif
+
+/** @brief Probe a channel for an SSID.
+ *
+ * Sends probe requests for the SSID on the channel for the dwell time and
+ * reports whether the SSID answered.
+ *
+ * @param radio Radio argument given to @ref ffsDirectedScanEngineInit
+ * @param channel Channel (1 to @ref FFS_DIRECTED_SCAN_MAX_CHANNEL)
+ * @param dwellMs Time to spend on the channel
+ * @param ssid Null-terminated SSID
+ * @param found Destination for "the SSID answered"
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+typedef FFS_RESULT (*FfsDirectedScanProbe_t)(void *radio, uint8_t channel, uint16_t dwellMs, const char *ssid,
+        bool *found);
+
+/** @brief Directed-scan engine.
+ */
+typedef struct {
+    FfsDirectedScanProbe_t probe;                       //!< Channel probe
+    void *radio;                                        //!< Probe argument
+    uint16_t channelMask;                               //!< Enabled channels (bit n - 1 for channel n)
+    uint8_t lastChannel;                                //!< Channel of the last match (0 if none)
+    uint16_t dwellMs[FFS_DIRECTED_SCAN_MAX_CHANNEL];    //!< Dwell time of each channel
+} FfsDirectedScanEngine_t;
+
+/** @brief Initialize a directed-scan engine.
+ *
+ * @param engine Engine to initialize
+ * @param probe Channel probe
+ * @param radio Probe argument
+ * @param channelMask Enabled channels (bit n - 1 for channel n)
+ */
+void ffsDirectedScanEngineInit(FfsDirectedScanEngine_t *engine, FfsDirectedScanProbe_t probe, void *radio,
+        uint16_t channelMask);
+
+/** @brief Get the order the channels are probed in.
+ *
+ * @param engine Engine
+ * @param channels Destination for the channels (@ref FFS_DIRECTED_SCAN_MAX_CHANNEL entries)
+ *
+ * @returns Number of channels
+ */
+uint8_t ffsDirectedScanEngineGetChannelOrder(const FfsDirectedScanEngine_t *engine, uint8_t *channels);
+
+/** @brief Look for an SSID.
+ *
+ * Probes the channels in order for up to \a maximumPasses passes, stopping
+ * on the first match or before a probe would take the total dwell time past
+ * \a maximumTimeMs. The dwell times are reset at the start of the search.
+ *
+ * @param engine Engine
+ * @param ssid Null-terminated SSID
+ * @param maximumPasses Passes over the enabled channels
+ * @param maximumTimeMs Total dwell time of the search
+ * @param found Destination for "the SSID was found"
+ * @param channel Destination for the channel the SSID was found on (NULL to ignore)
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDirectedScanEngineRun(FfsDirectedScanEngine_t *engine, const char *ssid, uint8_t maximumPasses,
+        uint32_t maximumTimeMs, bool *found, uint8_t *channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FFS_AMAZON_FREERTOS_DIRECTED_SCAN_ENGINE_H_ */
@@ -16,6 +16,7 @@
 
 #include <inttypes.h>
 
+#include "ffs/common/ffs_dns_cache.h"
 #include "ffs/common/ffs_http.h"
 #include "ffs/common/ffs_result.h"
 #include "ffs/compat/ffs_user_context.h"
@@ -47,6 +48,9 @@ typedef enum {
     SYS_HTTP_CLIENT_STATE_IDLE = 0,
     SYS_HTTP_CLIENT_STATE_RUNNUNG,
     SYS_HTTP_CLIENT_STATE_CONNECT_REQ,
+    SYS_HTTP_CLIENT_STATE_RESOLVE_WAIT,
+    SYS_HTTP_CLIENT_STATE_RESOLVED,
+    SYS_HTTP_CLIENT_STATE_RESOLVE_FAILED,
     SYS_HTTP_CLIENT_STATE_CONNECT_WAIT,
     SYS_HTTP_CLIENT_STATE_CONNECTED,
     //SYS_HTTP_CLIENT_STATE_DISCONNECTED,
@@ -158,6 +162,32 @@ void ffsHttpClientDisconnectServer(FfsHttpsConnectionContext_t *ffsHttpsConnCont
  */
 FFS_RESULT ffsHttpPost(struct FfsUserContext_s *userContext, FfsHttpRequest_t *request, void *callbackDataPointer);
 
+/** @brief Drop negative DNS answers, \a e.g., after switching networks.
+ *
+ * @return Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsHttpClientFlushNegativeDnsCache(void);
+
+/** @brief Get (and log) the DNS cache hit/miss and time-saved counters.
+ *
+ * @param statistics Destination for the counters.
+ *
+ * @return Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsHttpClientGetDnsCacheStatistics(FfsDnsCacheStatistics_t *statistics);
+
+/** @brief Get (and log) the TLS handshake counters of the HTTPS transport.
+ *
+ * A resumed handshake reuses a session cached from an earlier connection to
+ * the same host and skips the certificate exchange.
+ *
+ * @param fullHandshakes Destination for the number of full handshakes.
+ * @param resumedHandshakes Destination for the number of resumed handshakes.
+ *
+ * @return Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsHttpClientGetTlsHandshakeStatistics(uint32_t *fullHandshakes, uint32_t *resumedHandshakes);
+
 /** @brief Initialize connection context to be used to make
  * HTTPS requests.
  * 
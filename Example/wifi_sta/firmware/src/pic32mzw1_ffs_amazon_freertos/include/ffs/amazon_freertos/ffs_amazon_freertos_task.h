@@ -105,4 +105,25 @@ typedef struct {
  */
 FFS_PROVISIONING_RESULT ffsProvisionDevice(FfsProvisioningArguments_t *ffsProvisioningArguments);
 
+/** @brief Start provisioning the device. Call @ref ffsProvisionDeviceStep until it
+ * returns true; no call waits on the network, so the caller's loop keeps running
+ * while provisioning is in progress.
+ *
+ * @param ffsProvisioningArguments Provisioning arguments, kept until provisioning ends.
+ *
+ * @return Enumerated [Provisioning Result](@ref FFS_PROVISIONING_RESULT);
+ * FFS_PROVISIONING_RESULT_PROVISIONED if provisioning started
+ */
+FFS_PROVISIONING_RESULT ffsProvisionDeviceStart(FfsProvisioningArguments_t *ffsProvisioningArguments);
+
+/** @brief Advance the provisioning started by @ref ffsProvisionDeviceStart.
+ * Checks the Wi-Fi connection or DSS request in progress and, once it completed,
+ * starts the one of the next state. Returns without waiting for either.
+ *
+ * @param provisioningResult Destination of the provisioning result, once provisioning ended
+ *
+ * @return true if provisioning ended
+ */
+bool ffsProvisionDeviceStep(FFS_PROVISIONING_RESULT *provisioningResult);
+
 #endif /* FFS_AMAZON_FREERTOS_TASK_H_ */
\ No newline at end of file
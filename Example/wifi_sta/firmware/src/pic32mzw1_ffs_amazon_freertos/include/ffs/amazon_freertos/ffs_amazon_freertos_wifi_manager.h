@@ -24,12 +24,13 @@
 #define FFS_WIFI_MANAGER_MAX_WIFI_ATTEMPTS      (5)  /**< Maximum number of APs in wifi attempt list */
 #define FFS_WIFI_MAX_APS_SUPPORTED              (20) /**< Maximum number of APs in scan list */
 #define FFS_WIFI_MAX_SSID_LEN                   (33)//wificonfigMAX_SSID_LEN /**< Length of Wi-Fi SSID */
+#define FFS_WIFI_SCAN_MAX_AGE_MS                (10000) /**< Age of the scan cache entries given to FFS, and of a table reused without scanning */
 
 /**
- * @brief Wi-Fi scan results list
+ * @brief Wi-Fi scan results list, as BSSIDs of the scan cache entries
  */
 typedef struct {
-    WDRV_PIC32MZW_BSS_INFO  apInfo[FFS_WIFI_MAX_APS_SUPPORTED];
+    uint8_t                 bssid[FFS_WIFI_MAX_APS_SUPPORTED][WDRV_PIC32MZW_MAC_ADDR_LEN];
     uint8_t                 numAp;
     uint8_t                 valid;
 } FfsWifiScanResults_t;
@@ -77,12 +78,19 @@ FFS_RESULT ffsWifiManagerGetStaCredentials(const FfsUserContext_t *userContext,
 FFS_RESULT ffsWifiManagerClearStaCredentials(const FfsUserContext_t *userContext);
 
 /**
- * @brief Connect to the Wi-Fi network with credentials previously loaded
+ * @brief Look for the Wi-Fi network with credentials previously loaded, so the connection can skip the full scan
+ */
+FFS_RESULT ffsWifiManagerActiveScanForNetwork(const FfsUserContext_t *userContext);
+
+/**
+ * @brief Start connecting to the Wi-Fi network with credentials previously loaded
+ *
+ * The connection advances each time @ref ffsWifiManagerGetConnectionDetails is called.
  */
 FFS_RESULT ffsWifiManagerConnect(FfsUserContext_t *userContext);
 
 /**
- * @brief Get the current Wi-Fi profile
+ * @brief Get the current Wi-Fi profile, advancing a connection in progress
  */
 FFS_RESULT ffsWifiManagerGetConnectionDetails(const FfsUserContext_t *userContext, SYS_WIFI_CONFIG *const wifiNetWorkProfile, FFS_WIFI_CONNECTION_STATE *const connectionState);
 
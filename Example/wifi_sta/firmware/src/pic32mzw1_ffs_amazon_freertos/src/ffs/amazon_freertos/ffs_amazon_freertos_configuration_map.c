@@ -16,6 +16,7 @@
 #include <stdlib.h>
 
 #include "definitions.h"
+#include "app.h"
 #include "wolfssl/wolfcrypt/asn_public.h"
 
 #include "ffs/amazon_freertos/ffs_amazon_freertos_device_configuration.h"
@@ -31,6 +32,8 @@
 
 static FFS_RESULT ffsInitializeConfigurationMapEntryStream(FfsStream_t *stream, const char *entry);
 static FFS_RESULT ffsDeinitializeConfigurationMapEntryStream(FfsStream_t *stream);
+static FFS_RESULT ffsWriteConfigurationFile(const char *path, FfsStream_t *stream);
+static FFS_RESULT ffsReadConfigurationFile(const char *path, FfsStream_t *stream);
 
 /*
  * Initialize the Ffs Wi-Fi Amazon freertos configuration map.
@@ -135,6 +138,12 @@ FFS_RESULT ffsSetConfigurationMapValue(struct FfsUserContext_s *userContext, con
         configurationEntryStream = &configurationMap->softwareVersionIndexStream;
     }
 
+    // The encoded setup network cache is kept on the file system with the credentials.
+    if (!strcmp(configurationKey, FFS_CONFIGURATION_ENTRY_KEY_ENCODED_SETUP_NETWORK_CACHE)
+            && configurationValue->type == FFS_MAP_VALUE_TYPE_BYTES) {
+        return ffsWriteConfigurationFile(FFS_SETUP_CACHE_FILE, &configurationValue->bytesStream);
+    }
+
     if (!configurationEntryStream) {
         ffsLogWarning("Client does not support storing this configuration");
         return FFS_NOT_IMPLEMENTED;
@@ -232,6 +241,12 @@ FFS_RESULT ffsGetConfigurationMapValue(struct FfsUserContext_s *userContext, con
 
         FFS_CHECK_RESULT(ffsWriteStream((const unsigned char *) FFS_STREAM_NEXT_READ(userContext->deviceTypePublicKey), 
                 FFS_STREAM_DATA_SIZE(userContext->deviceTypePublicKey), &fetchedConfigurationValue.bytesStream));    
+    } else if (!strcmp(FFS_CONFIGURATION_ENTRY_KEY_ENCODED_SETUP_NETWORK_CACHE, configurationKey)) {
+        fetchedConfigurationValue.type = FFS_MAP_VALUE_TYPE_BYTES;
+        FFS_RESULT result = ffsReadConfigurationFile(FFS_SETUP_CACHE_FILE, &fetchedConfigurationValue.bytesStream);
+        if (result != FFS_SUCCESS) {
+            return result;
+        }
     } else {
         ffsLogWarning("Unknown configuration key \"%s\"", configurationKey);
         // Don't check this since it may not be an error.
@@ -244,7 +259,7 @@ FFS_RESULT ffsGetConfigurationMapValue(struct FfsUserContext_s *userContext, con
 }
 
 static FFS_RESULT ffsInitializeConfigurationMapEntryStream(FfsStream_t *stream, const char *entry) {
-    uint8_t *buffer = (uint8_t *)malloc(sizeof(uint8_t) * CONFIGURATION_MAP_ENTRY_BUFFER_SIZE);
+    uint8_t *buffer = (uint8_t *)SYS_MEMTRACK_MALLOC(sizeof(uint8_t) * CONFIGURATION_MAP_ENTRY_BUFFER_SIZE, SYS_MEMTRACK_TAG_FFS);
     memset(buffer, 0, sizeof(uint8_t) * CONFIGURATION_MAP_ENTRY_BUFFER_SIZE);
     if (!buffer) return FFS_ERROR;
 
@@ -257,7 +272,68 @@ static FFS_RESULT ffsInitializeConfigurationMapEntryStream(FfsStream_t *stream,
 }
 
 static FFS_RESULT ffsDeinitializeConfigurationMapEntryStream(FfsStream_t *stream) {
-    if (FFS_STREAM_BUFFER(*stream)) free(FFS_STREAM_BUFFER(*stream));
+    if (FFS_STREAM_BUFFER(*stream)) SYS_MEMTRACK_FREE(FFS_STREAM_BUFFER(*stream));
     FFS_CHECK_RESULT(ffsSetStreamToNull(stream));
     return FFS_SUCCESS;
 }
+
+/*
+ * Replace a configuration file with the stream data.
+ */
+static FFS_RESULT ffsWriteConfigurationFile(const char *path, FfsStream_t *stream)
+{
+    SYS_FS_HANDLE fileHandle = SYS_FS_FileOpen(path, SYS_FS_FILE_OPEN_WRITE);
+    if (fileHandle == SYS_FS_HANDLE_INVALID) {
+        ffsLogWarning("Unable to open \"%s\" for writing", path);
+        return FFS_ERROR;
+    }
+
+    size_t dataSize = FFS_STREAM_DATA_SIZE(*stream);
+    bool written = SYS_FS_FileWrite(fileHandle, FFS_STREAM_NEXT_READ(*stream), dataSize) == dataSize;
+    if (written) {
+        SYS_FS_FileSync(fileHandle);
+    }
+    SYS_FS_FileClose(fileHandle);
+
+    if (!written) {
+        ffsLogWarning("Unable to write \"%s\"", path);
+        // Do not leave a truncated file behind.
+        SYS_FS_FileDirectoryRemove(path);
+        return FFS_ERROR;
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Read a configuration file into the stream.
+ */
+static FFS_RESULT ffsReadConfigurationFile(const char *path, FfsStream_t *stream)
+{
+    SYS_FS_FSTAT fileStatus;
+    if (SYS_FS_FileStat(path, &fileStatus) != SYS_FS_RES_SUCCESS) {
+        ffsLogDebug("No configuration file \"%s\"", path);
+        return FFS_NOT_IMPLEMENTED;
+    }
+
+    if (fileStatus.fsize > FFS_STREAM_SPACE_SIZE(*stream)) {
+        ffsLogWarning("Configuration file \"%s\" is too large", path);
+        return FFS_OVERRUN;
+    }
+
+    SYS_FS_HANDLE fileHandle = SYS_FS_FileOpen(path, SYS_FS_FILE_OPEN_READ);
+    if (fileHandle == SYS_FS_HANDLE_INVALID) {
+        return FFS_ERROR;
+    }
+
+    size_t readSize = SYS_FS_FileRead(fileHandle, FFS_STREAM_NEXT_WRITE(*stream), fileStatus.fsize);
+    SYS_FS_FileClose(fileHandle);
+
+    if (readSize != fileStatus.fsize) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    stream->dataSize += readSize;
+
+    return FFS_SUCCESS;
+}
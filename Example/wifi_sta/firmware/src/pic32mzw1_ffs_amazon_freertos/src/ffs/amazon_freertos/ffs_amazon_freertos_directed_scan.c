@@ -0,0 +1,209 @@
+/** @file ffs_amazon_freertos_directed_scan.c
+ *
+ * @brief Sending probe request with SSID specified.
+ *
+ * Directed scan of the PIC32MZW1: the directed-scan engine probes one
+ * channel at a time with WDRV_PIC32MZW_BSSFindFirst, filtered on the SSID.
+ *
+ * @copyright 2020 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include <string.h>
+#include "definitions.h"
+#include "wdrv_pic32mzw_bssfind.h"
+
+#include "ffs/amazon_freertos/ffs_amazon_freertos_directed_scan.h"
+#include "ffs/amazon_freertos/ffs_amazon_freertos_task.h"
+#include "ffs/common/ffs_check_result.h"
+#include "ffs/common/ffs_logging.h"
+
+#ifndef FFS_DIRECTED_SCAN_CHANNEL_MASK
+#define FFS_DIRECTED_SCAN_CHANNEL_MASK      WDRV_PIC32MZW_CM_2_4G_DEFAULT   // Channels 1 through 11
+#endif
+
+#define FFS_DIRECTED_SCAN_PROBES            (2)     // Probe requests per channel
+#define FFS_DIRECTED_SCAN_GUARD_MS          (200)   // Time allowed for the results after the dwell time
+#define FFS_DIRECTED_SCAN_BUSY_TRIES        (5)     // Tries while another scan is in flight
+
+// sDirectedScanEventGroup bits
+#define FFS_DIRECTED_SCAN_BIT_DONE          (1<<0)
+
+FFS_DECLARE_EVENT_GROUP(sDirectedScanEventGroup);
+
+// Directed-scan engine and the state of the probe in flight.
+static FfsDirectedScanEngine_t sDirectedScanEngine;
+static bool sDirectedScanEngineInitialized = false;
+static WDRV_PIC32MZW_SSID_LIST sDirectedScanSsidList;
+static volatile bool sDirectedScanFound;
+
+// Static functions.
+static FFS_RESULT ffsDirectedScanPic32mzwProbe(void *radio, uint8_t channel, uint16_t dwellMs, const char *ssid,
+        bool *found);
+static bool ffsDirectedScanPic32mzwCallback(DRV_HANDLE handle, uint8_t index, uint8_t ofTotal,
+        WDRV_PIC32MZW_BSS_INFO *pBSSInfo);
+
+/*
+ * Perform a directed scan for an SSID.
+ */
+FFS_RESULT ffsDirectedScan(const FfsUserContext_t *userContext, const char *ssid, bool *const found)
+{
+    DRV_HANDLE handle = DRV_HANDLE_INVALID;
+
+    *found = false;
+
+    if (strlen(ssid) > WDRV_PIC32MZW_MAX_SSID_LEN)
+    {
+        ffsLogError("SSID too long for a directed scan: %s", ssid);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    if (SYS_WIFI_CtrlMsg(userContext->sysObj->syswifi, SYS_WIFI_GETDRVHANDLE, &handle, sizeof(DRV_HANDLE))
+            != SYS_WIFI_SUCCESS || handle == DRV_HANDLE_INVALID)
+    {
+        ffsLogWarning("Wi-Fi driver not open. Skip directed scan...");
+        return FFS_NOT_IMPLEMENTED;
+    }
+
+    if (!sDirectedScanEventGroup)
+    {
+        FFS_INIT_EVENT_GROUP(sDirectedScanEventGroup);
+    }
+
+    // The last-seen channel is kept from one directed scan to the next.
+    if (!sDirectedScanEngineInitialized)
+    {
+        ffsDirectedScanEngineInit(&sDirectedScanEngine, ffsDirectedScanPic32mzwProbe, NULL,
+                FFS_DIRECTED_SCAN_CHANNEL_MASK);
+        sDirectedScanEngineInitialized = true;
+    }
+    sDirectedScanEngine.radio = (void *) handle;
+
+    // Only the SSID we are looking for is reported by the driver.
+    memset(&sDirectedScanSsidList, 0, sizeof(sDirectedScanSsidList));
+    sDirectedScanSsidList.ssid.length = strlen(ssid);
+    memcpy(sDirectedScanSsidList.ssid.name, ssid, sDirectedScanSsidList.ssid.length);
+
+    if (WDRV_PIC32MZW_BSSFindSetScanMatchMode(handle, WDRV_PIC32MZW_SCAN_MATCH_MODE_STOP_ON_FIRST)
+            != WDRV_PIC32MZW_STATUS_OK)
+    {
+        ffsLogWarning("Unable to set the scan match mode.");
+    }
+
+    uint8_t channel = 0;
+    FFS_RESULT result = ffsDirectedScanEngineRun(&sDirectedScanEngine, ssid, FFS_MAX_RETRY_DIRECTED_SCAN,
+            FFS_DIRECTED_SCAN_MAX_TIME_MS, found, &channel);
+
+    if (result != FFS_SUCCESS)
+    {
+        ffsLogError("Directed-scanning WiFi failed. Directed SSID: %s; Returned code: %d", ssid, result);
+        FFS_FAIL(result);
+    }
+
+    if (*found)
+    {
+        ffsLogDebug("Scanned WiFi matches on channel %d.", channel);
+    }
+    else
+    {
+        ffsLogDebug("Didn't find WiFi with SSID: %s", ssid);
+        sDirectedScanEngine.lastChannel = 0;
+    }
+
+    return FFS_SUCCESS;
+
+error:
+    FFS_FAIL(FFS_ERROR);
+}
+
+/*
+ * Get the channel of the last directed-scan match.
+ */
+uint8_t ffsDirectedScanGetLastChannel(void)
+{
+    return sDirectedScanEngineInitialized ? sDirectedScanEngine.lastChannel : 0;
+}
+
+/** @brief Probe a channel for the SSID in sDirectedScanSsidList.
+ */
+static FFS_RESULT ffsDirectedScanPic32mzwProbe(void *radio, uint8_t channel, uint16_t dwellMs, const char *ssid,
+        bool *found)
+{
+    const DRV_HANDLE handle = (DRV_HANDLE) radio;
+    WDRV_PIC32MZW_STATUS status;
+
+    (void) ssid;
+
+    if (WDRV_PIC32MZW_BSSFindSetScanParameters(handle, 0, dwellMs, 0, FFS_DIRECTED_SCAN_PROBES)
+            != WDRV_PIC32MZW_STATUS_OK)
+    {
+        ffsLogError("Unable to set the active dwell time: %d ms", dwellMs);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    sDirectedScanFound = false;
+    xEventGroupClearBits(sDirectedScanEventGroup, FFS_DIRECTED_SCAN_BIT_DONE);
+
+    // Another scan (e.g. a scan cache refresh) may be in flight.
+    for (int tryNum = 0; ; tryNum++)
+    {
+        status = WDRV_PIC32MZW_BSSFindFirst(handle, (WDRV_PIC32MZW_CHANNEL_ID) channel, true,
+                &sDirectedScanSsidList, ffsDirectedScanPic32mzwCallback);
+
+        if (status != WDRV_PIC32MZW_STATUS_SCAN_IN_PROGRESS || tryNum >= FFS_DIRECTED_SCAN_BUSY_TRIES)
+        {
+            break;
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(FFS_DIRECTED_SCAN_GUARD_MS));
+    }
+
+    if (status != WDRV_PIC32MZW_STATUS_OK)
+    {
+        ffsLogError("WDRV_PIC32MZW_BSSFindFirst failed on channel %d: %d", channel, status);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    const EventBits_t eventBits = xEventGroupWaitBits(sDirectedScanEventGroup, FFS_DIRECTED_SCAN_BIT_DONE,
+            pdTRUE, pdFALSE, pdMS_TO_TICKS(dwellMs + FFS_DIRECTED_SCAN_GUARD_MS));
+
+    if (!(eventBits & FFS_DIRECTED_SCAN_BIT_DONE))
+    {
+        ffsLogWarning("Directed scan of channel %d timed out.", channel);
+    }
+
+    *found = sDirectedScanFound;
+    return FFS_SUCCESS;
+}
+
+/** @brief Driver BSS find callback of the directed-scan probes.
+ */
+static bool ffsDirectedScanPic32mzwCallback(DRV_HANDLE handle, uint8_t index, uint8_t ofTotal,
+        WDRV_PIC32MZW_BSS_INFO *pBSSInfo)
+{
+    (void) handle;
+
+    if (ofTotal && pBSSInfo
+            && pBSSInfo->ctx.ssid.length == sDirectedScanSsidList.ssid.length
+            && !memcmp(pBSSInfo->ctx.ssid.name, sDirectedScanSsidList.ssid.name, pBSSInfo->ctx.ssid.length))
+    {
+        sDirectedScanFound = true;
+    }
+
+    // Stop on the first match or the last result.
+    if (sDirectedScanFound || index >= ofTotal)
+    {
+        xEventGroupSetBits(sDirectedScanEventGroup, FFS_DIRECTED_SCAN_BIT_DONE);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,145 @@
+/** @file ffs_amazon_freertos_directed_scan_engine.c
+ *
+ * @brief Radio-independent directed-scan scheduling.
+ *
+ * @copyright 2020 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/amazon_freertos/ffs_amazon_freertos_directed_scan_engine.h"
+#include "ffs/common/ffs_check_result.h"
+#include "ffs/common/ffs_logging.h"
+
+#include <stddef.h>
+
+#define CHANNEL_BIT(channel)    ((uint16_t) (1 << ((channel) - 1)))
+
+/** @brief Social channels, probed right after the last-seen channel. */
+static const uint8_t SOCIAL_CHANNELS[] = { 1, 6, 11 };
+
+// Static functions.
+static void ffsAddChannel(uint8_t channel, uint16_t channelMask, uint16_t *addedMask, uint8_t *channels,
+        uint8_t *count);
+
+/*
+ * Initialize a directed-scan engine.
+ */
+void ffsDirectedScanEngineInit(FfsDirectedScanEngine_t *engine, FfsDirectedScanProbe_t probe, void *radio,
+        uint16_t channelMask)
+{
+    engine->probe = probe;
+    engine->radio = radio;
+    engine->channelMask = channelMask & FFS_DIRECTED_SCAN_ALL_CHANNELS;
+    engine->lastChannel = 0;
+
+    for (uint8_t index = 0; index < FFS_DIRECTED_SCAN_MAX_CHANNEL; index++) {
+        engine->dwellMs[index] = FFS_DIRECTED_SCAN_MIN_DWELL_MS;
+    }
+}
+
+/*
+ * Get the order the channels are probed in.
+ */
+uint8_t ffsDirectedScanEngineGetChannelOrder(const FfsDirectedScanEngine_t *engine, uint8_t *channels)
+{
+    uint16_t addedMask = 0;
+    uint8_t count = 0;
+
+    // Last-seen channel first.
+    if (engine->lastChannel) {
+        ffsAddChannel(engine->lastChannel, engine->channelMask, &addedMask, channels, &count);
+    }
+
+    // Then the social channels.
+    for (size_t index = 0; index < sizeof(SOCIAL_CHANNELS); index++) {
+        ffsAddChannel(SOCIAL_CHANNELS[index], engine->channelMask, &addedMask, channels, &count);
+    }
+
+    // Then the rest.
+    for (uint8_t channel = 1; channel <= FFS_DIRECTED_SCAN_MAX_CHANNEL; channel++) {
+        ffsAddChannel(channel, engine->channelMask, &addedMask, channels, &count);
+    }
+
+    return count;
+}
+
+/*
+ * Look for an SSID.
+ */
+FFS_RESULT ffsDirectedScanEngineRun(FfsDirectedScanEngine_t *engine, const char *ssid, uint8_t maximumPasses,
+        uint32_t maximumTimeMs, bool *found, uint8_t *channel)
+{
+    uint8_t channels[FFS_DIRECTED_SCAN_MAX_CHANNEL];
+    const uint8_t channelCount = ffsDirectedScanEngineGetChannelOrder(engine, channels);
+    uint32_t elapsedMs = 0;
+
+    *found = false;
+
+    for (uint8_t index = 0; index < FFS_DIRECTED_SCAN_MAX_CHANNEL; index++) {
+        engine->dwellMs[index] = FFS_DIRECTED_SCAN_MIN_DWELL_MS;
+    }
+
+    // The last match is likely to answer again, give it a longer first look.
+    if (engine->lastChannel && (engine->channelMask & CHANNEL_BIT(engine->lastChannel))) {
+        engine->dwellMs[engine->lastChannel - 1] = 2 * FFS_DIRECTED_SCAN_MIN_DWELL_MS;
+    }
+
+    for (uint8_t pass = 0; pass < maximumPasses; pass++) {
+        for (uint8_t index = 0; index < channelCount; index++) {
+            const uint8_t probedChannel = channels[index];
+            uint16_t *dwellMs = &engine->dwellMs[probedChannel - 1];
+
+            // Out of time: leave the rest to the connection's own scan.
+            if (elapsedMs + *dwellMs > maximumTimeMs) {
+                ffsLogDebug("Directed scan for \"%s\" stopped after %u ms.", ssid, (unsigned int) elapsedMs);
+                return FFS_SUCCESS;
+            }
+            elapsedMs += *dwellMs;
+
+            FFS_CHECK_RESULT(engine->probe(engine->radio, probedChannel, *dwellMs, ssid, found));
+
+            if (*found) {
+                ffsLogDebug("Found \"%s\" on channel %d (pass %d, dwell %d ms).", ssid, probedChannel, pass,
+                        *dwellMs);
+                engine->lastChannel = probedChannel;
+                if (channel) {
+                    *channel = probedChannel;
+                }
+                return FFS_SUCCESS;
+            }
+
+            // Not there (or not answering fast enough): stay longer next pass.
+            *dwellMs *= FFS_DIRECTED_SCAN_DWELL_GROWTH;
+            if (*dwellMs > FFS_DIRECTED_SCAN_MAX_DWELL_MS) {
+                *dwellMs = FFS_DIRECTED_SCAN_MAX_DWELL_MS;
+            }
+        }
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Append an enabled channel not already in the list.
+ */
+static void ffsAddChannel(uint8_t channel, uint16_t channelMask, uint16_t *addedMask, uint8_t *channels,
+        uint8_t *count)
+{
+    if (channel < 1 || channel > FFS_DIRECTED_SCAN_MAX_CHANNEL) {
+        return;
+    }
+
+    if (!(channelMask & CHANNEL_BIT(channel)) || (*addedMask & CHANNEL_BIT(channel))) {
+        return;
+    }
+
+    *addedMask |= CHANNEL_BIT(channel);
+    channels[(*count)++] = channel;
+}
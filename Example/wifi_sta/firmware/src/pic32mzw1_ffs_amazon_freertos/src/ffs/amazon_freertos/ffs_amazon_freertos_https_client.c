@@ -14,7 +14,9 @@
 
 /* FFS includes */
 #include "ffs/common/ffs_check_result.h"
+#include "ffs/common/ffs_dns_cache.h"
 #include "ffs/common/ffs_logging.h"
+#include "ffs/compat/ffs_common_compat.h"
 #include "ffs/compat/ffs_dss_client_compat.h"
 #include "ffs/dss/ffs_dss_client.h"
 #include "ffs/amazon_freertos/ffs_amazon_freertos_task.h"
@@ -22,10 +24,17 @@
 
 
 #include "definitions.h"
+#include "net_pres/pres/net_pres_enc_glue.h"
 #include "ssl.h"
 #include <string.h>
 
 #define FFS_HTTPS_TIMEOUT_MS                5000
+#define FFS_HTTPS_REQUEST_QUEUE_LENGTH      4
+/* Response handlers (DSS parsing, signature checks) run on the request task,
+   which logs its stack high-water mark after each operation. */
+#ifndef FFS_HTTPS_REQUEST_TASK_STACK_SIZE
+#define FFS_HTTPS_REQUEST_TASK_STACK_SIZE   4096
+#endif
 #define FFS_AMAZON_SIGNATURE_HEADER_FIELD   "x-amzn-dss-signature"
 #define FFS_AMAZON_REQUEST_ID_HEADER_FIELD  "x-amzn-RequestId"
 #define FFS_HTTPS_CONNECT_TRIES             7
@@ -33,6 +42,12 @@
 #define FFS_MAX_HEADER_VALUE_SIZE           256
 #define FFS_HTTPS_USER_BUFFER_SIZE          512
 
+#define FFS_HTTPS_DNS_CACHE_ENTRIES         4
+#define FFS_HTTPS_DNS_RESOLVE_TIMEOUT_MS    10000
+/* Define to persist positive DNS answers across reboots (littlefs). */
+//#define FFS_HTTPS_DNS_CACHE_FILE            "/mnt/myDrive1/ffs_dns.cache"
+#define FFS_HTTPS_DNS_CACHE_FILE_SIZE       512
+
 #define HTTP_PROTO_NAME               "HTTP/1.1"
 #define HTTP_USER_AGENT               "FFS/1.0"
 
@@ -53,6 +68,7 @@
 #define FFS_HTTP_CLIENT_BIT_REQUEST_ERROR         (1<<6)
 #define FFS_HTTP_CLIENT_BIT_RESPONSE_SUCCESS      (1<<7)
 #define FFS_HTTP_CLIENT_BIT_RESPONSE_ERROR        (1<<8)
+#define FFS_HTTP_CLIENT_BIT_CANCEL                (1<<9)
 
 
 //Event Groups
@@ -65,6 +81,45 @@ static HTTP_Streamer_t sHttpStreamer;
 FFS_DECLARE_LOCK_FOR(sHttpConnProfile);
 FFS_DECLARE_LOCK_FOR(sHttpStreamer);
 
+/* DNS answer cache for the DSS endpoints. */
+static FfsDnsCache_t sDnsCache;
+static FfsDnsCacheEntry_t sDnsCacheEntries[FFS_HTTPS_DNS_CACHE_ENTRIES];
+static char sDnsResolvedAddress[FFS_DNS_CACHE_MAXIMUM_ADDRESS_LENGTH + 1];
+static uint32_t sDnsResolveStartMs;
+static bool sDnsCacheHit;
+
+FFS_DECLARE_LOCK_FOR(sDnsCache);
+
+/** @brief Asynchronous HTTP operation, queued to the request task.
+ */
+struct FfsHttpOperation_s {
+    struct FfsUserContext_s *userContext; //!< User context.
+    FfsHttpRequest_t *request; //!< Original request.
+    void *callbackDataPointer; //!< Data for the request callbacks.
+    FfsHttpCompletionCallback_t onComplete; //!< Completion callback (optional).
+    bool hasDeadline; //!< Is there a time limit?
+    TickType_t deadline; //!< Tick count at which the operation times out.
+    volatile bool isCancelled; //!< Cancelled by the caller?
+    SemaphoreHandle_t completeSemaphore; //!< Given on completion (NULL if detached).
+    FFS_RESULT result; //!< Completion result.
+};
+
+// Operations waiting for the request task, which is started by the first one.
+static QueueHandle_t sHttpRequestQueue;
+static TaskHandle_t sHttpRequestTask;
+
+// Held for a whole request, so blocking and queued requests share the single connection.
+static SemaphoreHandle_t sHttpConnectionLock;
+
+// Held while response handlers run, so a cancel never races them.
+static SemaphoreHandle_t sHttpOperationLock;
+
+static FFS_RESULT ffsPrivateHttpOperationCheck(FfsHttpOperation_t *operation);
+static FFS_RESULT ffsPrivateHttpPost(FfsUserContext_t *userContext, FfsHttpRequest_t *request,
+        void *callbackDataPointer, FfsHttpOperation_t *operation);
+static FFS_RESULT ffsPrivateHttpHandleResponse(FfsHttpRequest_t *request, void *callbackDataPointer,
+        uint16_t httpStatusCode);
+
 void SYS_HTTP_Client_Socket_Callback(uint32_t event, void *data, void* cookie);
 
 static int32_t httpStreamInit(HTTP_Streamer_t *streamer, uint8_t *buffer, uint16_t len, STREAM_WRITER funcPtr)
@@ -129,6 +184,14 @@ FFS_RESULT ffsHttpClientConnect(FfsHttpsConnectionContext_t *connCtx, SYS_HTTP_C
             sHttpConnProfile.httpConnected = true;
             connCtx->connHdl = &sHttpConnProfile;             
             ffsPrivateHttpClientSetState(SYS_HTTP_CLIENT_STATE_CONNECTED);
+
+            uint32_t fullHandshakes;
+            uint32_t resumedHandshakes;
+            if (ffsHttpClientGetTlsHandshakeStatistics(&fullHandshakes, &resumedHandshakes) == FFS_SUCCESS)
+            {
+                ffsLogDebug("TLS handshakes: %u full, %u resumed.", (unsigned int) fullHandshakes,
+                        (unsigned int) resumedHandshakes);
+            }
         }
     }
     
@@ -206,7 +269,254 @@ FFS_RESULT ffsDssClientGetBuffers(struct FfsUserContext_s *userContext,
     return FFS_SUCCESS;
 }
 
-bool ffsPrivateHttpClientConnect()
+static uint32_t ffsPrivateDnsCacheTimeMs(void)
+{
+    return (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+#if defined(FFS_HTTPS_DNS_CACHE_FILE)
+static void ffsPrivateDnsCacheLoad(void)
+{
+    FFS_TEMPORARY_OUTPUT_STREAM(cacheStream, FFS_HTTPS_DNS_CACHE_FILE_SIZE);
+    SYS_FS_HANDLE fileHandle = SYS_FS_FileOpen(FFS_HTTPS_DNS_CACHE_FILE, SYS_FS_FILE_OPEN_READ);
+    if (fileHandle == SYS_FS_HANDLE_INVALID)
+    {
+        return;
+    }
+    size_t readSize = SYS_FS_FileRead(fileHandle, FFS_STREAM_NEXT_WRITE(cacheStream), FFS_STREAM_SPACE_SIZE(cacheStream));
+    SYS_FS_FileClose(fileHandle);
+    if (readSize == (size_t)-1)
+    {
+        return;
+    }
+    cacheStream.dataSize += readSize;
+    if (ffsDnsCacheDeserialize(&sDnsCache, ffsPrivateDnsCacheTimeMs(), &cacheStream) != FFS_SUCCESS)
+    {
+        ffsLogWarning("Ignoring unreadable DNS cache file");
+    }
+}
+
+static void ffsPrivateDnsCacheSave(void)
+{
+    FFS_TEMPORARY_OUTPUT_STREAM(cacheStream, FFS_HTTPS_DNS_CACHE_FILE_SIZE);
+    if (ffsDnsCacheSerialize(&sDnsCache, ffsPrivateDnsCacheTimeMs(), &cacheStream) != FFS_SUCCESS)
+    {
+        return;
+    }
+    SYS_FS_HANDLE fileHandle = SYS_FS_FileOpen(FFS_HTTPS_DNS_CACHE_FILE, SYS_FS_FILE_OPEN_WRITE);
+    if (fileHandle == SYS_FS_HANDLE_INVALID)
+    {
+        return;
+    }
+    SYS_FS_FileWrite(fileHandle, FFS_STREAM_NEXT_READ(cacheStream), FFS_STREAM_DATA_SIZE(cacheStream));
+    SYS_FS_FileSync(fileHandle);
+    SYS_FS_FileClose(fileHandle);
+}
+#else
+#define ffsPrivateDnsCacheLoad()
+#define ffsPrivateDnsCacheSave()
+#endif
+
+/*
+ * Look up the server in the DNS cache. On a hit the cached address is copied
+ * to sDnsResolvedAddress.
+ */
+static FFS_RESULT ffsPrivateDnsCacheLookup(FFS_DNS_CACHE_LOOKUP_RESULT *lookupResult)
+{
+    FfsStream_t hostStream = FFS_STRING_INPUT_STREAM(sHttpConnProfile.httpCfg.url);
+    FfsStream_t addressStream = ffsCreateOutputStream((uint8_t *)sDnsResolvedAddress, FFS_DNS_CACHE_MAXIMUM_ADDRESS_LENGTH);
+    FFS_RESULT result;
+
+    memset(sDnsResolvedAddress, 0, sizeof(sDnsResolvedAddress));
+    FFS_TAKE_LOCK_FOR(sDnsCache);
+    result = ffsDnsCacheLookup(&sDnsCache, &hostStream, ffsPrivateDnsCacheTimeMs(), &addressStream, lookupResult);
+    FFS_GIVE_LOCK_FOR(sDnsCache);
+
+    return result;
+}
+
+/*
+ * Record a resolved address (or a failure, if address is NULL).
+ */
+static FFS_RESULT ffsPrivateDnsCacheUpdate(const char *address, uint32_t ttlMs)
+{
+    FfsStream_t hostStream = FFS_STRING_INPUT_STREAM(sHttpConnProfile.httpCfg.url);
+    uint32_t nowMs = ffsPrivateDnsCacheTimeMs();
+    uint32_t resolveDurationMs = nowMs - sDnsResolveStartMs;
+    FFS_RESULT result;
+
+    FFS_TAKE_LOCK_FOR(sDnsCache);
+    if (address)
+    {
+        result = ffsDnsCacheInsert(&sDnsCache, &hostStream, address, ttlMs, resolveDurationMs, nowMs);
+        if (result == FFS_SUCCESS)
+        {
+            ffsPrivateDnsCacheSave();
+        }
+    }
+    else
+    {
+        result = ffsDnsCacheInsertNegative(&sDnsCache, &hostStream, resolveDurationMs, nowMs);
+    }
+    FFS_GIVE_LOCK_FOR(sDnsCache);
+
+    return result;
+}
+
+/*
+ * Drop the cached address of the server (it did not answer).
+ */
+static FFS_RESULT ffsPrivateDnsCacheRemove(void)
+{
+    FfsStream_t hostStream = FFS_STRING_INPUT_STREAM(sHttpConnProfile.httpCfg.url);
+
+    FFS_TAKE_LOCK_FOR(sDnsCache);
+    ffsDnsCacheRemove(&sDnsCache, &hostStream);
+    FFS_GIVE_LOCK_FOR(sDnsCache);
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Get the time-to-live of the TCP/IP stack's answer for the server.
+ */
+static uint32_t ffsPrivateDnsAnswerTtlMs(void)
+{
+    char hostName[FFS_DNS_CACHE_MAXIMUM_HOST_LENGTH + 1];
+    IPV4_ADDR ipv4Entry;
+    TCPIP_DNS_ENTRY_QUERY dnsQuery;
+
+    memset(&dnsQuery, 0, sizeof(dnsQuery));
+    dnsQuery.hostName = hostName;
+    dnsQuery.nameLen = sizeof(hostName);
+    dnsQuery.ipv4Entry = &ipv4Entry;
+    dnsQuery.nIPv4Entries = 1;
+
+    for (int index = 0; TCPIP_DNS_EntryQuery(&dnsQuery, index) != TCPIP_DNS_RES_NO_IX_ENTRY; index++)
+    {
+        if (dnsQuery.status == TCPIP_DNS_RES_OK && strcmp(hostName, sHttpConnProfile.httpCfg.url) == 0)
+        {
+            return dnsQuery.ttlTime * 1000;
+        }
+    }
+
+    /* Unknown; the cache applies its minimum. */
+    return 0;
+}
+
+/*
+ * Start resolving the server name, from the DNS cache if possible.
+ */
+static SYS_HTTP_CLIENT_STATUS_t ffsPrivateHttpClientResolve(void)
+{
+    FFS_DNS_CACHE_LOOKUP_RESULT lookupResult = FFS_DNS_CACHE_MISS;
+
+    sDnsCacheHit = false;
+    sDnsResolveStartMs = ffsPrivateDnsCacheTimeMs();
+    ffsPrivateDnsCacheLookup(&lookupResult);
+
+    switch (lookupResult)
+    {
+        case FFS_DNS_CACHE_HIT:
+            ffsLogDebug("DNS cache hit: %s -> %s", sHttpConnProfile.httpCfg.url, sDnsResolvedAddress);
+            sDnsCacheHit = true;
+            return SYS_HTTP_CLIENT_STATE_RESOLVED;
+
+        case FFS_DNS_CACHE_NEGATIVE_HIT:
+            ffsLogWarning("DNS cache: %s recently failed to resolve", sHttpConnProfile.httpCfg.url);
+            return SYS_HTTP_CLIENT_STATE_RESOLVE_FAILED;
+
+        default:
+            break;
+    }
+
+    TCPIP_DNS_RESULT dnsResult = TCPIP_DNS_Resolve(sHttpConnProfile.httpCfg.url, TCPIP_DNS_TYPE_A);
+    if (dnsResult == TCPIP_DNS_RES_NAME_IS_IPADDRESS)
+    {
+        strncpy(sDnsResolvedAddress, sHttpConnProfile.httpCfg.url, FFS_DNS_CACHE_MAXIMUM_ADDRESS_LENGTH);
+        return SYS_HTTP_CLIENT_STATE_RESOLVED;
+    }
+    if (dnsResult < 0)
+    {
+        ffsPrivateDnsCacheUpdate(NULL, 0);
+        return SYS_HTTP_CLIENT_STATE_RESOLVE_FAILED;
+    }
+    return SYS_HTTP_CLIENT_STATE_RESOLVE_WAIT;
+}
+
+/*
+ * Poll a pending name resolution.
+ */
+static SYS_HTTP_CLIENT_STATUS_t ffsPrivateHttpClientResolveWait(void)
+{
+    IPV4_ADDR serverIp;
+    TCPIP_DNS_RESULT dnsResult = TCPIP_DNS_IsNameResolved(sHttpConnProfile.httpCfg.url, &serverIp, NULL);
+
+    if (dnsResult == TCPIP_DNS_RES_PENDING)
+    {
+        if ((ffsPrivateDnsCacheTimeMs() - sDnsResolveStartMs) < FFS_HTTPS_DNS_RESOLVE_TIMEOUT_MS)
+        {
+            return SYS_HTTP_CLIENT_STATE_RESOLVE_WAIT;
+        }
+        dnsResult = TCPIP_DNS_RES_SERVER_TMO;
+    }
+
+    if (dnsResult != TCPIP_DNS_RES_OK)
+    {
+        ffsLogError("DNS resolution of %s failed: %d", sHttpConnProfile.httpCfg.url, dnsResult);
+        ffsPrivateDnsCacheUpdate(NULL, 0);
+        return SYS_HTTP_CLIENT_STATE_RESOLVE_FAILED;
+    }
+
+    TCPIP_Helper_IPAddressToString(&serverIp, sDnsResolvedAddress, sizeof(sDnsResolvedAddress));
+    ffsPrivateDnsCacheUpdate(sDnsResolvedAddress, ffsPrivateDnsAnswerTtlMs());
+    return SYS_HTTP_CLIENT_STATE_RESOLVED;
+}
+
+/*
+ * Flush negative DNS answers (on a network switch).
+ */
+FFS_RESULT ffsHttpClientFlushNegativeDnsCache(void)
+{
+    FFS_TAKE_LOCK_FOR(sDnsCache);
+    ffsDnsCacheFlushNegative(&sDnsCache);
+    FFS_GIVE_LOCK_FOR(sDnsCache);
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Get the DNS cache counters.
+ */
+FFS_RESULT ffsHttpClientGetDnsCacheStatistics(FfsDnsCacheStatistics_t *statistics)
+{
+    FFS_TAKE_LOCK_FOR(sDnsCache);
+    *statistics = sDnsCache.statistics;
+    ffsDnsCacheLogStatistics(&sDnsCache);
+    FFS_GIVE_LOCK_FOR(sDnsCache);
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Get the TLS handshake counters.
+ */
+FFS_RESULT ffsHttpClientGetTlsHandshakeStatistics(uint32_t *fullHandshakes, uint32_t *resumedHandshakes)
+{
+    NET_PRES_EncHandshakeStats stats;
+
+    if (!NET_PRES_EncProviderStreamClientGetHandshakeStats0(&stats))
+    {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    *fullHandshakes = stats.full;
+    *resumedHandshakes = stats.resumed;
+
+    return FFS_SUCCESS;
+}
+
+bool ffsPrivateHttpClientConnect(const char *serverAddress)
 {
     SYS_NET_Config sSysNetCfg;
 
@@ -215,7 +525,8 @@ bool ffsPrivateHttpClientConnect()
     memset(&sSysNetCfg, 0, sizeof (sSysNetCfg));
     sSysNetCfg.enable_tls = sHttpConnProfile.httpCfg.isHttps;            
     sSysNetCfg.port = sHttpConnProfile.httpCfg.port;            
-    strcpy(sSysNetCfg.host_name, sHttpConnProfile.httpCfg.url);
+    /* Connect to the resolved address; SNI uses the configured host name. */
+    strcpy(sSysNetCfg.host_name, serverAddress);
     
     sSysNetCfg.intf = SYS_NET_INDEX0_INTF;
     sSysNetCfg.mode = SYS_NET_MODE_CLIENT;
@@ -246,12 +557,28 @@ static void ffsPrivateHttpClientManagerTask(void *cookie)
         {            
             case SYS_HTTP_CLIENT_STATE_CONNECT_REQ:
             {
-                if(ffsPrivateHttpClientConnect() == true)
+                ffsPrivateHttpClientSetState(ffsPrivateHttpClientResolve());
+            }
+            break;
+            case SYS_HTTP_CLIENT_STATE_RESOLVE_WAIT:
+            {
+                ffsPrivateHttpClientSetState(ffsPrivateHttpClientResolveWait());
+            }
+            break;
+            case SYS_HTTP_CLIENT_STATE_RESOLVED:
+            {
+                if(ffsPrivateHttpClientConnect(sDnsResolvedAddress) == true)
                 {
                     ffsPrivateHttpClientSetState(SYS_HTTP_CLIENT_STATE_CONNECT_WAIT);
                 }                
             }
             break;
+            case SYS_HTTP_CLIENT_STATE_RESOLVE_FAILED:
+            {
+                ffsPrivateHttpClientSetState(SYS_HTTP_CLIENT_STATE_IDLE);
+                xEventGroupSetBits(sHttpClientResultEventGroup, FFS_HTTP_CLIENT_BIT_CONNECT_ERROR);
+            }
+            break;
             case SYS_HTTP_CLIENT_STATE_SEND_REQ:
             {
                 int32_t result;                 
@@ -283,6 +610,57 @@ static void ffsPrivateHttpClientManagerTask(void *cookie)
 }
 
 
+static void ffsPrivateHttpClientRequestTask(void *cookie)
+{
+    FfsHttpOperation_t *operation;
+
+    while(1)
+    {
+        if (xQueueReceive(sHttpRequestQueue, &operation, portMAX_DELAY) != pdPASS)
+        {
+            continue;
+        }
+
+        xSemaphoreTake(sHttpConnectionLock, portMAX_DELAY);
+
+        FFS_RESULT result = ffsPrivateHttpPost(operation->userContext, operation->request,
+                operation->callbackDataPointer, operation);
+
+        /**A stopped operation may leave its response on the link; start the next one afresh.*/
+        FFS_RESULT stopResult = ffsPrivateHttpOperationCheck(operation);
+        if (stopResult != FFS_SUCCESS)
+        {
+            ffsLogWarning("HTTPS operation %s", stopResult == FFS_TIMEOUT ? "timed out" : "cancelled");
+            result = stopResult;
+            if (operation->userContext->ffsHttpsConnContext.isConnected)
+            {
+                ffsHttpClientDisconnectServer(&operation->userContext->ffsHttpsConnContext);
+                operation->userContext->ffsHttpsConnContext.isConnected = false;
+            }
+        }
+
+        xSemaphoreGive(sHttpConnectionLock);
+
+        ffsLogDebug("HTTPS request task stack high-water mark: %u words",
+                (unsigned int) uxTaskGetStackHighWaterMark(NULL));
+
+        if (operation->onComplete)
+        {
+            operation->onComplete(operation, result, operation->callbackDataPointer);
+        }
+
+        if (operation->completeSemaphore)
+        {
+            operation->result = result;
+            xSemaphoreGive(operation->completeSemaphore);
+        }
+        else
+        {
+            vPortFree(operation);
+        }
+    }
+}
+
 static uint8_t ffsPrivateRequestInit(SYS_HTTP_Req_Info *reqInfo, SYS_HTTP_Resp_Info *respInfo)
 {
     FFS_TAKE_LOCK_FOR(sHttpConnProfile);
@@ -434,6 +812,13 @@ void SYS_HTTP_Client_Socket_Callback(uint32_t event, void *data, void* cookie) {
         case SYS_NET_EVNT_SOCK_OPEN_FAILED:
         case SYS_NET_EVNT_SSL_FAILED:               
         {                        
+            /* A cached address that cannot be reached is stale. */
+            if (sDnsCacheHit && !hdl->httpConnected)
+            {
+                sDnsCacheHit = false;
+                ffsPrivateDnsCacheRemove();
+            }
+
             const EventBits_t resultBits = FFS_HTTP_CLIENT_BIT_CONNECT_ERROR;
             xEventGroupSetBits(sHttpClientResultEventGroup, resultBits);
         }
@@ -459,6 +844,13 @@ FFS_RESULT ffsInitializeHttpsConnectionContext(FfsHttpsConnectionContext_t *ffsH
 
     FFS_INIT_LOCK_FOR(sHttpConnProfile);
     FFS_INIT_LOCK_FOR(sHttpStreamer);
+    FFS_INIT_LOCK_FOR(sDnsCache);
+
+    if (ffsInitializeDnsCache(&sDnsCache, sDnsCacheEntries, FFS_HTTPS_DNS_CACHE_ENTRIES) != FFS_SUCCESS)
+    {
+        goto error;
+    }
+    ffsPrivateDnsCacheLoad();
     
     sHttpConnProfile.netSrvcHdl = SYS_MODULE_OBJ_INVALID;
     
@@ -474,6 +866,25 @@ FFS_RESULT ffsInitializeHttpsConnectionContext(FfsHttpsConnectionContext_t *ffsH
                 (void * const)&sHttpConnProfile,
                 1,
                 (TaskHandle_t*)NULL); 
+
+    /* Locks and queue for asynchronous operations, kept across reinitialization. */
+    if (!sHttpConnectionLock)
+    {
+        sHttpConnectionLock = xSemaphoreCreateMutex();
+    }
+    if (!sHttpOperationLock)
+    {
+        sHttpOperationLock = xSemaphoreCreateMutex();
+    }
+    if (!sHttpRequestQueue)
+    {
+        sHttpRequestQueue = xQueueCreate(FFS_HTTPS_REQUEST_QUEUE_LENGTH, sizeof(FfsHttpOperation_t *));
+    }
+    if (!sHttpConnectionLock || !sHttpOperationLock || !sHttpRequestQueue)
+    {
+        ffsLogError("Cannot allocate the HTTPS request queue.");
+        goto error;
+    }
     return FFS_SUCCESS;
     
 error:
@@ -555,10 +966,51 @@ FFS_RESULT ffsHttpClientReadContentLen(uint32_t *httpContentLen)
     return FFS_SUCCESS;
 }
 
-FFS_RESULT ffsHttpClientReadResponse(uint16_t *respStatus)
+/** @brief Check whether an operation was cancelled or ran past its deadline.
+ */
+static FFS_RESULT ffsPrivateHttpOperationCheck(FfsHttpOperation_t *operation)
+{
+    if (!operation)
+    {
+        return FFS_SUCCESS;
+    }
+    if (operation->isCancelled)
+    {
+        return FFS_ERROR;
+    }
+    if (operation->hasDeadline && (int32_t) (xTaskGetTickCount() - operation->deadline) >= 0)
+    {
+        return FFS_TIMEOUT;
+    }
+    return FFS_SUCCESS;
+}
+
+FFS_RESULT ffsHttpClientReadResponse(FfsHttpOperation_t *operation, uint16_t *respStatus)
 {
     char *dataPtr;
-    const EventBits_t eventBits = xEventGroupWaitBits(sHttpClientResultEventGroup, FFS_HTTP_CLIENT_BIT_RESPONSE_SUCCESS | FFS_HTTP_CLIENT_BIT_RESPONSE_ERROR, pdTRUE, pdFALSE, FFS_HTTPS_TIMEOUT_MS);
+    EventBits_t eventBits = 0;
+    const TickType_t timeout = xTaskGetTickCount() + pdMS_TO_TICKS(FFS_HTTPS_TIMEOUT_MS);
+
+    /**Wait for the response, the operation deadline or a cancel, whichever comes first.*/
+    while (!(eventBits & (FFS_HTTP_CLIENT_BIT_RESPONSE_SUCCESS | FFS_HTTP_CLIENT_BIT_RESPONSE_ERROR)))
+    {
+        FFS_CHECK_RESULT(ffsPrivateHttpOperationCheck(operation));
+
+        TickType_t waitUntil = timeout;
+        if (operation && operation->hasDeadline && (int32_t) (operation->deadline - timeout) < 0)
+        {
+            waitUntil = operation->deadline;
+        }
+        const int32_t waitTicks = (int32_t) (waitUntil - xTaskGetTickCount());
+        if (waitTicks <= 0)
+        {
+            FFS_CHECK_RESULT(ffsPrivateHttpOperationCheck(operation));
+            break;
+        }
+
+        /**A cancel bit meant for an earlier operation only costs one more pass.*/
+        eventBits = xEventGroupWaitBits(sHttpClientResultEventGroup, FFS_HTTP_CLIENT_BIT_RESPONSE_SUCCESS | FFS_HTTP_CLIENT_BIT_RESPONSE_ERROR | FFS_HTTP_CLIENT_BIT_CANCEL, pdTRUE, pdFALSE, (TickType_t) waitTicks);
+    }
     if (eventBits & FFS_HTTP_CLIENT_BIT_RESPONSE_SUCCESS)
     {                   
         dataPtr = strstr((char *)sHttpConnProfile.pUserBuff, "HTTP/");
@@ -592,13 +1044,33 @@ FFS_RESULT ffsHttpClientReadHeader(const char *httpHeader, uint8_t *httpValue, s
     return FFS_SUCCESS;
 }
 
+
 /*
  * Execute a post operation.
  */
 FFS_RESULT ffsHttpPost(FfsUserContext_t *userContext, FfsHttpRequest_t *request, void *callbackDataPointer)
+{
+    if (!sHttpConnectionLock || xSemaphoreTake(sHttpConnectionLock, portMAX_DELAY) != pdPASS) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    FFS_RESULT result = ffsPrivateHttpPost(userContext, request, callbackDataPointer, NULL);
+
+    xSemaphoreGive(sHttpConnectionLock);
+
+    return result;
+}
+
+/** @brief Execute a post operation, stopping between phases if the
+ * operation (optional) is cancelled or times out.
+ */
+static FFS_RESULT ffsPrivateHttpPost(FfsUserContext_t *userContext, FfsHttpRequest_t *request,
+        void *callbackDataPointer, FfsHttpOperation_t *operation)
 {   
     ffsLogDebug("Amazon free RTOS HTTPS compat function start...");
     
+    FFS_CHECK_RESULT(ffsPrivateHttpOperationCheck(operation));
+
     if (!userContext->ffsHttpsConnContext.isConnected)
     {
         ffsLogDebug("Creating New HTTPS Link!");
@@ -606,6 +1078,8 @@ FFS_RESULT ffsHttpPost(FfsUserContext_t *userContext, FfsHttpRequest_t *request,
                 request->url.port));
     }
 
+    FFS_CHECK_RESULT(ffsPrivateHttpOperationCheck(operation));
+
     // Create request and response structs    
     SYS_HTTP_Req_Info requestInfo;
     SYS_HTTP_Resp_Info responseInfo;    
@@ -650,16 +1124,40 @@ FFS_RESULT ffsHttpPost(FfsUserContext_t *userContext, FfsHttpRequest_t *request,
      * headers are stored in the provided ucHTTPSResponseUserBuffer right after
      * the HTTPS Client response context. */
     uint16_t httpStatusCode = 0;
-    result = ffsHttpClientReadResponse(&httpStatusCode);
+    result = ffsHttpClientReadResponse(operation, &httpStatusCode);
 
-    if (result != FFS_SUCCESS) {
+    if (result == FFS_TIMEOUT) {
+        FFS_FAIL(FFS_TIMEOUT);
+    } else if (result != FFS_SUCCESS) {
         ffsLogError("HTTP Client ReadResponseStatus Failed...");
         ffsLogError("HTTP Client Error code: %i", result);
         FFS_FAIL(FFS_ERROR);
     }
 
     ffsLogInfo("HTTPS operation returned: %d", httpStatusCode);
-        
+
+    // Run the response handlers unless the operation was stopped first.
+    if (xSemaphoreTake(sHttpOperationLock, portMAX_DELAY) != pdPASS) {
+        FFS_FAIL(FFS_TIMEOUT);
+    }
+    result = ffsPrivateHttpOperationCheck(operation);
+    if (result == FFS_SUCCESS) {
+        result = ffsPrivateHttpHandleResponse(request, callbackDataPointer, httpStatusCode);
+    }
+    xSemaphoreGive(sHttpOperationLock);
+
+    FFS_CHECK_RESULT(result);
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Run the request callbacks on a received response.
+ */
+static FFS_RESULT ffsPrivateHttpHandleResponse(FfsHttpRequest_t *request, void *callbackDataPointer,
+        uint16_t httpStatusCode)
+{
+    FFS_RESULT result;
+
     /* FFS expects callbacks they provided to be called after a successful response.
      * These callbacks process the status code, headers and response. */
     
@@ -740,4 +1238,111 @@ FFS_RESULT ffsHttpPost(FfsUserContext_t *userContext, FfsHttpRequest_t *request,
 
     // We are all done.
     return FFS_SUCCESS;
-}
\ No newline at end of file
+}
+
+/*
+ * Start an HTTP operation without waiting for it.
+ */
+FFS_RESULT ffsHttpExecuteAsync(struct FfsUserContext_s *userContext, FfsHttpRequest_t *request,
+        void *callbackDataPointer, uint32_t timeoutMs, FfsHttpCompletionCallback_t onComplete,
+        FfsHttpOperation_t **operation)
+{
+    if (!sHttpRequestQueue) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    // Blocking requests run on the caller's task; only the first queued one starts the request task.
+    if (xSemaphoreTake(sHttpOperationLock, portMAX_DELAY) != pdPASS) {
+        FFS_FAIL(FFS_ERROR);
+    }
+    if (!sHttpRequestTask && xTaskCreate((TaskFunction_t) ffsPrivateHttpClientRequestTask,
+                "ffsHttpRequest_Tasks",
+                FFS_HTTPS_REQUEST_TASK_STACK_SIZE,
+                NULL,
+                1,
+                &sHttpRequestTask) != pdPASS) {
+        sHttpRequestTask = NULL;
+    }
+    xSemaphoreGive(sHttpOperationLock);
+    if (!sHttpRequestTask) {
+        ffsLogError("Cannot create the HTTPS request task.");
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    FfsHttpOperation_t *newOperation = pvPortMalloc(sizeof(FfsHttpOperation_t));
+    if (!newOperation) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+    memset(newOperation, 0, sizeof(FfsHttpOperation_t));
+
+    newOperation->userContext = userContext;
+    newOperation->request = request;
+    newOperation->callbackDataPointer = callbackDataPointer;
+    newOperation->onComplete = onComplete;
+    if (timeoutMs) {
+        newOperation->hasDeadline = true;
+        newOperation->deadline = xTaskGetTickCount() + pdMS_TO_TICKS(timeoutMs);
+    }
+
+    // Only a waited operation needs a completion semaphore.
+    if (operation) {
+        newOperation->completeSemaphore = xSemaphoreCreateBinary();
+        if (!newOperation->completeSemaphore) {
+            vPortFree(newOperation);
+            FFS_FAIL(FFS_OVERRUN);
+        }
+    }
+
+    if (xQueueSend(sHttpRequestQueue, &newOperation, 0) != pdPASS) {
+        ffsLogError("HTTPS request queue full");
+        if (newOperation->completeSemaphore) {
+            vSemaphoreDelete(newOperation->completeSemaphore);
+        }
+        vPortFree(newOperation);
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    if (operation) {
+        *operation = newOperation;
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Wait for an HTTP operation to complete and release it.
+ */
+FFS_RESULT ffsHttpWait(struct FfsUserContext_s *userContext, FfsHttpOperation_t *operation)
+{
+    (void) userContext;
+
+    xSemaphoreTake(operation->completeSemaphore, portMAX_DELAY);
+
+    FFS_RESULT result = operation->result;
+    vSemaphoreDelete(operation->completeSemaphore);
+    vPortFree(operation);
+
+    return result;
+}
+
+/*
+ * Cancel an HTTP operation.
+ *
+ * Waits for response handlers already running, so it must not be called from
+ * one.
+ */
+FFS_RESULT ffsHttpCancel(struct FfsUserContext_s *userContext, FfsHttpOperation_t *operation)
+{
+    (void) userContext;
+
+    if (xSemaphoreTake(sHttpOperationLock, portMAX_DELAY) != pdPASS) {
+        FFS_FAIL(FFS_TIMEOUT);
+    }
+    operation->isCancelled = true;
+    xSemaphoreGive(sHttpOperationLock);
+
+    // Wake a response wait now rather than at its timeout.
+    xEventGroupSetBits(sHttpClientResultEventGroup, FFS_HTTP_CLIENT_BIT_CANCEL);
+
+    return FFS_SUCCESS;
+}
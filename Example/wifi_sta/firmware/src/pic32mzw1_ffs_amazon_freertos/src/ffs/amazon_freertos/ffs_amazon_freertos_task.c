@@ -14,14 +14,77 @@
  * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
  */
 
+#include "definitions.h"
 #include "ffs/amazon_freertos/ffs_amazon_freertos_task.h"
 #include "ffs/amazon_freertos/ffs_amazon_freertos_user_context.h"
 #include "ffs/common/ffs_logging.h"
 
+#include <string.h>
+
 #define FFS_MAX_WAIT_ON_QUEUE   15000
+#define FFS_MAX_REPORTED_LEAKS  8
+#define FFS_STEP_POLL_PERIOD_MS 100
+
+#ifdef SYS_MEMTRACK_ENABLED
+/*
+ * Report the FFS allocations made since the mark and not freed by the user
+ * context deinitialization.
+ */
+static void ffsReportLeaks(uint32_t mark)
+{
+    SYS_MEMTRACK_BLOCK_INFO leaks[FFS_MAX_REPORTED_LEAKS];
+    size_t leakCount = SYS_MEMTRACK_Leaks(SYS_MEMTRACK_TAG_FFS, mark, leaks, FFS_MAX_REPORTED_LEAKS);
+
+    for (size_t index = 0; index < leakCount && index < FFS_MAX_REPORTED_LEAKS; index++) {
+        ffsLogWarning("Leaked %lu bytes at %p, allocated from %p",
+                (unsigned long)leaks[index].size, leaks[index].ptr, leaks[index].caller);
+    }
+
+    if (leakCount) {
+        ffsLogError("%u FFS allocations not freed by the user context", (unsigned int)leakCount);
+    }
+}
+#endif
+
+/*
+ * Provisioning in progress, kept between two steps.
+ */
+static struct {
+    bool isActive;
+    FfsUserContext_t userContext;
+    FfsWifiProvisioneeContext_t *provisioneeContext;
+    FfsWifiProvisioneeStepStatus_t status;
+#ifdef SYS_MEMTRACK_ENABLED
+    uint32_t memTrackMark;
+#endif
+} sProvisioning;
 
 FFS_PROVISIONING_RESULT ffsProvisionDevice(FfsProvisioningArguments_t *provisioningArguments)
 {
+    FFS_PROVISIONING_RESULT provisioningResult = ffsProvisionDeviceStart(provisioningArguments);
+
+    if (provisioningResult != FFS_PROVISIONING_RESULT_PROVISIONED) {
+        return provisioningResult;
+    }
+
+    // Run the provisionee state machine to the end, sleeping while it waits on the network.
+    while (!ffsProvisionDeviceStep(&provisioningResult)) {
+        if (sProvisioning.status.awaitedEvent != FFS_WIFI_PROVISIONEE_EVENT_NONE) {
+            vTaskDelay(pdMS_TO_TICKS(FFS_STEP_POLL_PERIOD_MS));
+        }
+    }
+
+    return provisioningResult;
+}
+
+FFS_PROVISIONING_RESULT ffsProvisionDeviceStart(FfsProvisioningArguments_t *provisioningArguments)
+{
+    // Already provisioning?
+    if (sProvisioning.isActive) {
+        ffsLogError("Device provisioning already in progress.");
+        return FFS_PROVISIONING_RESULT_INIT_ERROR;
+    }
+
     // Provisioning arguments are null?
     if (provisioningArguments == NULL) {
         ffsLogError("Provide non-null arguments to provision device.");
@@ -59,30 +122,58 @@ FFS_PROVISIONING_RESULT ffsProvisionDevice(FfsProvisioningArguments_t *provision
     FfsStream_t publicKeyStream = ffsCreateInputStream((uint8_t *)provisioningArguments->publicKey, provisioningArguments->publicKeySize);
     FfsStream_t deviceTypePublicKeyStream = ffsCreateInputStream((uint8_t *)provisioningArguments->deviceTypePublicKey, provisioningArguments->deviceTypePublicKeySize);
     FfsStream_t certificateStream = ffsCreateInputStream((uint8_t *)provisioningArguments->certificate, provisioningArguments->certificateSize);
-   
-    // Result store
-    FFS_RESULT ffsResult = FFS_ERROR;
-    FFS_PROVISIONING_RESULT provisioningResult = FFS_PROVISIONING_RESULT_PROVISIONED;
+
+#ifdef SYS_MEMTRACK_ENABLED
+    sProvisioning.memTrackMark = SYS_MEMTRACK_Mark();
+#endif
 
     // Initialize a user context
-    FfsUserContext_t userContext = { 0 };    
-    ffsResult = ffsInitializeUserContext(&userContext, &privateKeyStream, &publicKeyStream, &deviceTypePublicKeyStream, &certificateStream);
-    
+    memset(&sProvisioning.userContext, 0, sizeof(sProvisioning.userContext));
+    FFS_RESULT ffsResult = ffsInitializeUserContext(&sProvisioning.userContext, &privateKeyStream, &publicKeyStream, &deviceTypePublicKeyStream, &certificateStream);
+
+    // Initialize the provisionee state machine
+    if (ffsResult == FFS_SUCCESS) {
+        ffsResult = ffsWifiProvisioneeInit(&sProvisioning.userContext, &sProvisioning.provisioneeContext);
+    }
+
     if (ffsResult != FFS_SUCCESS) {
         ffsLogError("Unable to initialize user context...");
-        provisioningResult = FFS_PROVISIONING_RESULT_INIT_ERROR;
-        goto finish;
+        ffsDeinitializeUserContext(&sProvisioning.userContext);
+#ifdef SYS_MEMTRACK_ENABLED
+        ffsReportLeaks(sProvisioning.memTrackMark);
+#endif
+        return FFS_PROVISIONING_RESULT_INIT_ERROR;
     }
-        
-    // Start the provisionee task in main thread
-    ffsResult = ffsWifiProvisioneeTask(&userContext);
 
-    if(ffsResult != FFS_SUCCESS)
-    {
-        provisioningResult = FFS_PROVISIONING_INTERNAL_ERROR;
+    memset(&sProvisioning.status, 0, sizeof(sProvisioning.status));
+    sProvisioning.isActive = true;
+    return FFS_PROVISIONING_RESULT_PROVISIONED;
+}
+
+bool ffsProvisionDeviceStep(FFS_PROVISIONING_RESULT *provisioningResult)
+{
+    // Nothing in progress?
+    if (!sProvisioning.isActive) {
+        *provisioningResult = FFS_PROVISIONING_RESULT_INIT_ERROR;
+        return true;
     }
 
-    finish:
-        ffsDeinitializeUserContext(&userContext);
-        return provisioningResult;
-}
\ No newline at end of file
+    // Check the awaited operation, or run the next provisionee state, without waiting on the network
+    const uint32_t nowMs = (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+    FFS_RESULT ffsResult = ffsWifiProvisioneeStep(sProvisioning.provisioneeContext, sProvisioning.status.awaitedEvent,
+            nowMs, &sProvisioning.status);
+
+    if (ffsResult == FFS_SUCCESS && !sProvisioning.status.isDone) {
+        return false;
+    }
+
+    *provisioningResult = (ffsResult == FFS_SUCCESS) ? FFS_PROVISIONING_RESULT_PROVISIONED : FFS_PROVISIONING_INTERNAL_ERROR;
+
+    ffsWifiProvisioneeDeinit(sProvisioning.provisioneeContext);
+    ffsDeinitializeUserContext(&sProvisioning.userContext);
+#ifdef SYS_MEMTRACK_ENABLED
+    ffsReportLeaks(sProvisioning.memTrackMark);
+#endif
+    sProvisioning.isActive = false;
+    return true;
+}
@@ -43,15 +43,15 @@ FFS_RESULT ffsInitializeUserContext(FfsUserContext_t *userContext, FfsStream_t *
     static uint8_t bodyBuffer[FFS_BODY_BUFFER_SIZE];
     static uint8_t reportingUrlBuffer[FFS_REPORTING_URL_BUFFER_SIZE];
 #else
-    uint8_t *hostBuffer = malloc(FFS_HOST_BUFFER_SIZE);
+    uint8_t *hostBuffer = SYS_MEMTRACK_MALLOC(FFS_HOST_BUFFER_SIZE, SYS_MEMTRACK_TAG_FFS);
     memset(hostBuffer, 0, FFS_HOST_BUFFER_SIZE);
-    uint8_t *sessionIdBuffer = malloc(FFS_SESSION_ID_BUFFER_SIZE);
+    uint8_t *sessionIdBuffer = SYS_MEMTRACK_MALLOC(FFS_SESSION_ID_BUFFER_SIZE, SYS_MEMTRACK_TAG_FFS);
     memset(sessionIdBuffer, 0, FFS_SESSION_ID_BUFFER_SIZE);
-    uint8_t *nonceBuffer = malloc(FFS_NONCE_BUFFER_SIZE);
+    uint8_t *nonceBuffer = SYS_MEMTRACK_MALLOC(FFS_NONCE_BUFFER_SIZE, SYS_MEMTRACK_TAG_FFS);
     memset(nonceBuffer, 0, FFS_NONCE_BUFFER_SIZE);
-    uint8_t *bodyBuffer = malloc(FFS_BODY_BUFFER_SIZE);
+    uint8_t *bodyBuffer = SYS_MEMTRACK_MALLOC(FFS_BODY_BUFFER_SIZE, SYS_MEMTRACK_TAG_FFS);
     memset(bodyBuffer, 0, FFS_BODY_BUFFER_SIZE);
-    uint8_t *reportingUrlBuffer = malloc(FFS_REPORTING_URL_BUFFER_SIZE);
+    uint8_t *reportingUrlBuffer = SYS_MEMTRACK_MALLOC(FFS_REPORTING_URL_BUFFER_SIZE, SYS_MEMTRACK_TAG_FFS);
     memset(reportingUrlBuffer, 0, FFS_REPORTING_URL_BUFFER_SIZE);
 #endif
     // DSS streams.
@@ -113,22 +113,22 @@ void ffsDeinitializeUserContext(FfsUserContext_t *userContext) {
 #ifndef FFS_STATIC_DSS_BUFFERS    
     // Free DSS Streams underlying buffers
     if (userContext->hostStream.data) {
-        free(userContext->hostStream.data);
+        SYS_MEMTRACK_FREE(userContext->hostStream.data);
     }
     if (userContext->sessionIdStream.data) {
-        free(userContext->sessionIdStream.data);
+        SYS_MEMTRACK_FREE(userContext->sessionIdStream.data);
     }
     if (userContext->nonceStream.data) {
-        free(userContext->nonceStream.data);
+        SYS_MEMTRACK_FREE(userContext->nonceStream.data);
     }
     if (userContext->bodyStream.data) {
-        free(userContext->bodyStream.data);
+        SYS_MEMTRACK_FREE(userContext->bodyStream.data);
     }
     if (userContext->accessTokenStream.data) {
-        free(userContext->accessTokenStream.data);
+        SYS_MEMTRACK_FREE(userContext->accessTokenStream.data);
     }
     if (userContext->reportingUrlStream.data) {
-        free(userContext->reportingUrlStream.data);
+        SYS_MEMTRACK_FREE(userContext->reportingUrlStream.data);
     }
 #endif    
 }
@@ -19,6 +19,7 @@
 
 #include "ffs/amazon_freertos/ffs_amazon_freertos_task.h"
 #include "ffs/amazon_freertos/ffs_amazon_freertos_wifi_manager.h"
+#include "ffs/amazon_freertos/ffs_amazon_freertos_directed_scan.h"
 #include "ffs/common/ffs_stream.h"
 #include "ffs/common/ffs_check_result.h"
 
@@ -34,14 +35,25 @@
 #define FFS_WIFI_MANAGER_BIT_DISCONNECT_SUCCESS (1<<4)
 #define FFS_WIFI_MANAGER_BIT_CONNECT_ERROR      (1<<5)
 
+// Steps of a connection, advanced by ffsWifiManagerGetConnectionDetails().
+typedef enum {
+    FFS_WIFI_MANAGER_CONNECT_PHASE_IDLE = 0,
+    FFS_WIFI_MANAGER_CONNECT_PHASE_DISCONNECTING,
+    FFS_WIFI_MANAGER_CONNECT_PHASE_CONNECTING
+} FFS_WIFI_MANAGER_CONNECT_PHASE;
+
 
 FFS_DECLARE_EVENT_GROUP(sTaskResultEventGroup); // ffsPrivateWifiManagerTask() sending the result of a finished function.
 
 
 // Static data and locks that protect them.
 static FfsWifiScanResults_t sWifiScanList;
+static SYS_SCANCACHE_CLIENT_HANDLE sWifiScanCacheClient = SYS_SCANCACHE_CLIENT_INVALID;
 static SYS_WIFI_CONFIG sWifiCurrStaProfile;
 static FFS_WIFI_CONNECTION_STATE sWifiCurrState;
+static uint8_t sWifiCurrStaChannel; // Channel the directed scan found sWifiCurrStaProfile on (0 if unknown).
+static FFS_WIFI_MANAGER_CONNECT_PHASE sWifiConnectPhase; // Step of the connection in progress.
+static bool sWifiConnectRetryOnAllChannels; // Retry on all the channels if the connection on a channel fails.
 
 
 FFS_DECLARE_LOCK_FOR(sWifiCurrStaProfile);
@@ -59,15 +71,20 @@ static uint8_t sWifiAttemptsNum = 0;
 uint32_t wifiConnCount;
 
 /**
- * @brief Do wifi scan, putting results in sWifiScanList.
+ * @brief Do wifi scan through the scan cache, putting results in sWifiScanList.
  */
 static FFS_RESULT ffsPrivateWifiManagerScan(FfsUserContext_t *userContext);
 
 /**
- * @brief Connect to AP stored in sWifiCurrStaProfile.
+ * @brief Start connecting to AP stored in sWifiCurrStaProfile.
  */
 static FFS_RESULT ffsPrivateWifiManagerConnect(FfsUserContext_t *userContext);
 
+/**
+ * @brief Advance the connection in progress without waiting for its result.
+ */
+static FFS_RESULT ffsPrivateWifiManagerPollConnect(FfsUserContext_t *userContext);
+
 /**
  * @brief Save the wifi that it attempts to connect to a list.
  */
@@ -99,10 +116,9 @@ static FFS_RESULT ffsPrivateWifiManagerConnect(FfsUserContext_t *userContext)
 {
     FFS_TAKE_LOCK_FOR(sWifiCurrStaProfile);
     
-    EventBits_t eventBits;    
-    
-    // Enable all the channels(0)
-    sWifiCurrStaProfile.staConfig.channel = 0;
+    // Use the channel of the directed scan, or enable all the channels(0)
+    sWifiCurrStaProfile.staConfig.channel = sWifiCurrStaChannel;
+    sWifiCurrStaChannel = 0;
     // Device doesn't wait for user request
     sWifiCurrStaProfile.staConfig.autoConnect = 1;
     
@@ -112,116 +128,157 @@ static FFS_RESULT ffsPrivateWifiManagerConnect(FfsUserContext_t *userContext)
     
     sWifiCurrStaProfile.mode = SYS_WIFI_STA;
 
+    // Results of an earlier attempt must not complete this one.
+    xEventGroupClearBits(sTaskResultEventGroup, FFS_WIFI_MANAGER_BIT_DISCONNECT_SUCCESS | FFS_WIFI_MANAGER_BIT_CONNECT_SUCCESS | FFS_WIFI_MANAGER_BIT_CONNECT_ERROR);
+    sWifiCurrState = FFS_WIFI_CONNECTION_STATE_UNAUTHENTICATED;
+
+    // The connection starts once the current one is dropped.
     if(SYS_WIFI_CtrlMsg (userContext->sysObj->syswifi, SYS_WIFI_DISCONNECT, NULL, 0) == SYS_WIFI_SUCCESS)
     {
-        eventBits = xEventGroupWaitBits(sTaskResultEventGroup, FFS_WIFI_MANAGER_BIT_DISCONNECT_SUCCESS, pdTRUE, pdFALSE, portMAX_DELAY);
-        if (eventBits & FFS_WIFI_MANAGER_BIT_CONNECT_ERROR) 
-        {
-            sWifiCurrState = FFS_WIFI_CONNECTION_STATE_FAILED;
-        }
-        else
+        sWifiConnectPhase = FFS_WIFI_MANAGER_CONNECT_PHASE_DISCONNECTING;
+    }
+    else
+    {
+        SYS_WIFI_CtrlMsg (userContext->sysObj->syswifi, SYS_WIFI_CONNECT, &sWifiCurrStaProfile, sizeof(SYS_WIFI_CONFIG));
+        sWifiConnectPhase = FFS_WIFI_MANAGER_CONNECT_PHASE_CONNECTING;
+    }
+
+    FFS_GIVE_LOCK_FOR(sWifiCurrStaProfile);
+    return FFS_SUCCESS;
+}
+
+static FFS_RESULT ffsPrivateWifiManagerPollConnect(FfsUserContext_t *userContext)
+{
+    EventBits_t eventBits;
+
+    FFS_TAKE_LOCK_FOR(sWifiCurrStaProfile);
+
+    if (sWifiConnectPhase == FFS_WIFI_MANAGER_CONNECT_PHASE_DISCONNECTING)
+    {
+        eventBits = xEventGroupClearBits(sTaskResultEventGroup, FFS_WIFI_MANAGER_BIT_DISCONNECT_SUCCESS);
+        if (eventBits & FFS_WIFI_MANAGER_BIT_DISCONNECT_SUCCESS)
         {
-            //sWifiCurrStaProfile.saveConfig = 1;
-            ffsLogDebug("Wi-Fi Disconnection successful\r\n");            
+            ffsLogDebug("Wi-Fi Disconnection successful\r\n");
+            SYS_WIFI_CtrlMsg (userContext->sysObj->syswifi, SYS_WIFI_CONNECT, &sWifiCurrStaProfile, sizeof(SYS_WIFI_CONFIG));
+            sWifiConnectPhase = FFS_WIFI_MANAGER_CONNECT_PHASE_CONNECTING;
         }
+        FFS_GIVE_LOCK_FOR(sWifiCurrStaProfile);
+        return FFS_SUCCESS;
     }
-        
-    SYS_WIFI_CtrlMsg (userContext->sysObj->syswifi, SYS_WIFI_CONNECT, &sWifiCurrStaProfile, sizeof(SYS_WIFI_CONFIG));    
-    
-    // Do connect
-    eventBits = xEventGroupWaitBits(sTaskResultEventGroup, FFS_WIFI_MANAGER_BIT_CONNECT_ERROR | FFS_WIFI_MANAGER_BIT_CONNECT_SUCCESS, pdTRUE, pdFALSE, portMAX_DELAY);
 
-    if (eventBits & FFS_WIFI_MANAGER_BIT_CONNECT_ERROR) 
+    if (sWifiConnectPhase != FFS_WIFI_MANAGER_CONNECT_PHASE_CONNECTING)
+    {
+        FFS_GIVE_LOCK_FOR(sWifiCurrStaProfile);
+        return FFS_SUCCESS;
+    }
+
+    eventBits = xEventGroupClearBits(sTaskResultEventGroup, FFS_WIFI_MANAGER_BIT_CONNECT_ERROR | FFS_WIFI_MANAGER_BIT_CONNECT_SUCCESS);
+    if (eventBits & FFS_WIFI_MANAGER_BIT_CONNECT_ERROR)
     {
         sWifiCurrState = FFS_WIFI_CONNECTION_STATE_FAILED;
-        goto error;
+        sWifiConnectPhase = FFS_WIFI_MANAGER_CONNECT_PHASE_IDLE;
+        const bool retryOnAllChannels = sWifiConnectRetryOnAllChannels;
+        sWifiConnectRetryOnAllChannels = false;
+        FFS_GIVE_LOCK_FOR(sWifiCurrStaProfile);
+
+        FFS_CHECK_RESULT(ffsPrivateSaveWifiAttempt(FFS_WIFI_CONNECTION_STATE_FAILED)); // Save attempted wifi
+        if (retryOnAllChannels)
+        {
+            // The network may have moved since it was seen: connect on all the channels.
+            ffsLogWarning("Connection on channel failed. Connecting on all channels...");
+            FFS_CHECK_RESULT(ffsPrivateWifiManagerConnect(userContext));
+        }
+        return FFS_SUCCESS;
     }
-    else
+    else if (eventBits & FFS_WIFI_MANAGER_BIT_CONNECT_SUCCESS)
     {
         ffsLogDebug("Connected to AP: %s:%s\n", sWifiCurrStaProfile.staConfig.ssid, sWifiCurrStaProfile.staConfig.psk);
         sWifiCurrState = FFS_WIFI_CONNECTION_STATE_ASSOCIATED;
-
+        sWifiConnectPhase = FFS_WIFI_MANAGER_CONNECT_PHASE_IDLE;
+        sWifiConnectRetryOnAllChannels = false;
         FFS_GIVE_LOCK_FOR(sWifiCurrStaProfile);
-        FFS_CHECK_RESULT(ffsPrivateSaveWifiAttempt(FFS_WIFI_CONNECTION_STATE_ASSOCIATED)); // Save attempted wifi        
+
+        FFS_CHECK_RESULT(ffsPrivateSaveWifiAttempt(FFS_WIFI_CONNECTION_STATE_ASSOCIATED)); // Save attempted wifi
         // Reset connection
         userContext->ffsHttpsConnContext.isConnected = false;
         return FFS_SUCCESS;
     }
-error:
+
     FFS_GIVE_LOCK_FOR(sWifiCurrStaProfile);
-    FFS_CHECK_RESULT(ffsPrivateSaveWifiAttempt(FFS_WIFI_CONNECTION_STATE_FAILED)); // Save attempted wifi
-    FFS_FAIL(FFS_ERROR)
+    return FFS_SUCCESS;
 }
 
-/* Wi-Fi driver triggers a callback to update each Scan result one-by-one*/
-bool ffsPrivateWifiScanHandler (DRV_HANDLE handle, uint8_t index, uint8_t ofTotal, WDRV_PIC32MZW_BSS_INFO *pBSSInfo)
+/* Scan cache triggers a callback at the end of each scan */
+static void ffsPrivateWifiScanCacheCallback(SYS_SCANCACHE_EVENT event, const SYS_SCANCACHE_ENTRY *entry, uint32_t generation, void *cookie)
 {
-    
-    FFS_TAKE_LOCK_FOR(sWifiScanList);    
-       
-    if (index == 1)
-    {            
-        memset(&sWifiScanList, 0, sizeof(FfsWifiScanResults_t));            
+    if (event == SYS_SCANCACHE_EVENT_SCAN_DONE)
+    {
+        xEventGroupSetBits(sTaskResultEventGroup, FFS_WIFI_MANAGER_BIT_SCAN_SUCCESS);
     }
-    else
-    {            
-        if(pBSSInfo->ctx.ssid.length != 0 && sWifiScanList.numAp < FFS_WIFI_MAX_APS_SUPPORTED)
-        {
-            ffsLogDebug("%s", pBSSInfo->ctx.ssid.name);
-            memcpy((void *)&sWifiScanList.apInfo[sWifiScanList.numAp++], pBSSInfo, sizeof(WDRV_PIC32MZW_BSS_INFO));
-        }
+    else if (event == SYS_SCANCACHE_EVENT_SCAN_FAILED)
+    {
+        xEventGroupSetBits(sTaskResultEventGroup, FFS_WIFI_MANAGER_BIT_SCAN_ERROR);
     }
+}
 
-    if(index == ofTotal)
+/* Take the APs with an SSID found within FFS_WIFI_SCAN_MAX_AGE_MS out of the scan cache table */
+static void ffsPrivateWifiUpdateScanList(void)
+{
+    SYS_SCANCACHE_ENTRY entry;
+    uint8_t count;
+    uint8_t index;
+
+    FFS_TAKE_LOCK_FOR(sWifiScanList);
+
+    sWifiScanList.numAp = 0;
+    count = SYS_SCANCACHE_Count();
+    for (index = 0; index < count && sWifiScanList.numAp < FFS_WIFI_MAX_APS_SUPPORTED; index++)
     {
-        sWifiScanList.valid = true;
-        const EventBits_t resultBits = FFS_WIFI_MANAGER_BIT_SCAN_SUCCESS;
-        xEventGroupSetBits(sTaskResultEventGroup, resultBits);
+        if (SYS_SCANCACHE_Get(index, &entry) && entry.bssInfo.ctx.ssid.length != 0
+                && entry.age <= FFS_WIFI_SCAN_MAX_AGE_MS)
+        {
+            ffsLogDebug("%s", entry.bssInfo.ctx.ssid.name);
+            memcpy(sWifiScanList.bssid[sWifiScanList.numAp++], entry.bssInfo.ctx.bssid.addr, WDRV_PIC32MZW_MAC_ADDR_LEN);
+        }
     }
-                    
+    sWifiScanList.valid = true;
+
     FFS_GIVE_LOCK_FOR(sWifiScanList);
-    
-    // return true to receive further results; otherwise return false if desired
-    return true;
 }
 
 static FFS_RESULT ffsPrivateWifiManagerScan(FfsUserContext_t *userContext)
 {
-    SYS_WIFI_SCAN_CONFIG scanConfig;
-    SYS_WIFI_RESULT res;
+    SYS_SCANCACHE_RESULT result;
     SYS_WIFI_STATUS wifiStatus;
     
     userContext->scanListIndex = 0;
     wifiStatus = SYS_WIFI_GetStatus (userContext->sysObj->syswifi);
-    if (wifiStatus > SYS_WIFI_STATUS_WDRV_OPEN_REQ)
+    if (wifiStatus <= SYS_WIFI_STATUS_WDRV_OPEN_REQ)
+    {
+        ffsLogError("Wi-Fi driver not open");
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    // A recent table is reused, a scan in flight is joined.
+    xEventGroupClearBits(sTaskResultEventGroup, FFS_WIFI_MANAGER_BIT_SCAN_SUCCESS | FFS_WIFI_MANAGER_BIT_SCAN_ERROR);
+    result = SYS_SCANCACHE_Request(FFS_WIFI_SCAN_MAX_AGE_MS);
+    if (result == SYS_SCANCACHE_RESULT_ERROR)
+    {
+        SYS_CONSOLE_PRINT("Error Starting scan: %d\r\n", result);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    if (result != SYS_SCANCACHE_RESULT_CACHED)
     {
-        memset(&scanConfig, 0, sizeof(scanConfig));
-        res = SYS_WIFI_CtrlMsg(sysObj.syswifi, SYS_WIFI_GETSCANCONFIG, &scanConfig, sizeof(SYS_WIFI_SCAN_CONFIG));
-        if(SYS_WIFI_SUCCESS == res)
+        const EventBits_t eventBits = xEventGroupWaitBits(sTaskResultEventGroup, FFS_WIFI_MANAGER_BIT_SCAN_SUCCESS | FFS_WIFI_MANAGER_BIT_SCAN_ERROR, pdTRUE, pdFALSE, portMAX_DELAY);
+        if (eventBits & FFS_WIFI_MANAGER_BIT_SCAN_ERROR)
         {
-            //Received the wifiSrvcScanConfig data
-            char myAPlist[] = ""; // e.g. "myAP*OPENAP*Hello World!"
-            char delimiter  = ',';
-            scanConfig.channel         = 0;
-            scanConfig.numSlots        = 1;
-            scanConfig.mode            = SYS_WIFI_SCAN_MODE_ACTIVE;
-            scanConfig.pSsidList       = myAPlist;
-            scanConfig.delimChar       = delimiter;
-            scanConfig.pNotifyCallback = (void *)ffsPrivateWifiScanHandler;
-            scanConfig.numProbes       = 1;
-            scanConfig.activeSlotTime  = SYS_WIFI_SCAN_ACTIVE_SLOT_TIME;
-            scanConfig.passiveSlotTime = SYS_WIFI_SCAN_PASSIVE_SLOT_TIME;
-            scanConfig.chan24Mask      = SYS_WIFI_SCAN_CHANNEL24_MASK;
-            scanConfig.matchMode       = WDRV_PIC32MZW_SCAN_MATCH_MODE_FIND_ALL;
-            
-            res = SYS_WIFI_CtrlMsg(sysObj.syswifi,SYS_WIFI_SCANREQ, &scanConfig, sizeof(SYS_WIFI_SCAN_CONFIG));
-            if(SYS_WIFI_SUCCESS != res)
-            {
-                SYS_CONSOLE_PRINT("Error Starting scan: %d\r\n", res);                   
-                FFS_FAIL(FFS_ERROR);
-            }
+            FFS_FAIL(FFS_ERROR);
         }
     }
+
+    ffsPrivateWifiUpdateScanList();
+    ffsLogDebug("Found %d.", sWifiScanList.numAp);
     
     return FFS_SUCCESS; 
 }
@@ -237,9 +294,17 @@ FFS_RESULT ffsWifiManagerInit(FfsUserContext_t *const userContext)
     // Initialize static data.
     sWifiScanList.valid = false;
     sWifiCurrState = FFS_WIFI_CONNECTION_STATE_IDLE;
+    sWifiConnectPhase = FFS_WIFI_MANAGER_CONNECT_PHASE_IDLE;
 
     // Create Event Group    
     FFS_INIT_EVENT_GROUP(sTaskResultEventGroup);
+
+    // Scan results come from the shared scan cache.
+    sWifiScanCacheClient = SYS_SCANCACHE_Subscribe(ffsPrivateWifiScanCacheCallback, NULL);
+    if (sWifiScanCacheClient == SYS_SCANCACHE_CLIENT_INVALID)
+    {
+        goto error;
+    }
     
     SYS_WIFI_CtrlMsg (userContext->sysObj->syswifi, SYS_WIFI_REGCALLBACK, ffsPrivateWifiCallback, sizeof(SYS_WIFI_CALLBACK));
     
@@ -254,6 +319,9 @@ error:
 
 FFS_RESULT ffsWifiManagerDeinit(const FfsUserContext_t *userContext)
 {   
+    SYS_SCANCACHE_Unsubscribe(sWifiScanCacheClient);
+    sWifiScanCacheClient = SYS_SCANCACHE_CLIENT_INVALID;
+
     // Deinitialize locks.
     FFS_DEINIT_LOCK_FOR(sWifiScanList);
     FFS_DEINIT_LOCK_FOR(sWifiCurrStaProfile);
@@ -279,14 +347,7 @@ FFS_RESULT ffsWifiManagerGetScannedNumberOfAps(const FfsUserContext_t *userConte
 {        
     if(!sWifiScanList.valid)
     {        
-        ffsPrivateWifiManagerScan((FfsUserContext_t *)userContext);
-        const EventBits_t eventBits = xEventGroupWaitBits(sTaskResultEventGroup, FFS_WIFI_MANAGER_BIT_SCAN_SUCCESS | FFS_WIFI_MANAGER_BIT_SCAN_ERROR, pdTRUE, pdFALSE, portMAX_DELAY);
-        if (eventBits & FFS_WIFI_MANAGER_BIT_SCAN_ERROR)
-        {
-            FFS_FAIL(FFS_ERROR);
-        }
-        
-        ffsLogDebug("Found %d.", sWifiScanList.numAp);        
+        FFS_CHECK_RESULT(ffsPrivateWifiManagerScan((FfsUserContext_t *)userContext));
     }
     *numAp = sWifiScanList.numAp;
     
@@ -295,29 +356,30 @@ FFS_RESULT ffsWifiManagerGetScannedNumberOfAps(const FfsUserContext_t *userConte
 
 FFS_RESULT ffsWifiManagerGetScanResult(const FfsUserContext_t *userContext, WDRV_PIC32MZW_BSS_INFO *const scanResult, const uint8_t index)
 {
-    FFS_TAKE_LOCK_FOR(sWifiScanList);
+    SYS_SCANCACHE_ENTRY entry;
+
     // Do wifi scan if sWifiScanList is not valid.
     if (!sWifiScanList.valid)
     {
-        FFS_GIVE_LOCK_FOR(sWifiScanList);
-       
-        ffsPrivateWifiManagerScan((FfsUserContext_t *)userContext);
-        const EventBits_t eventBits = xEventGroupWaitBits(sTaskResultEventGroup, FFS_WIFI_MANAGER_BIT_SCAN_SUCCESS | FFS_WIFI_MANAGER_BIT_SCAN_ERROR, pdTRUE, pdFALSE, portMAX_DELAY);
-        if (eventBits & FFS_WIFI_MANAGER_BIT_SCAN_ERROR)
-        {
-            FFS_FAIL(FFS_ERROR);
-        }
-        ffsLogDebug("Found %d.", sWifiScanList.numAp);
-        FFS_TAKE_LOCK_FOR(sWifiScanList);
+        FFS_CHECK_RESULT(ffsPrivateWifiManagerScan((FfsUserContext_t *)userContext));
     }
 
+    FFS_TAKE_LOCK_FOR(sWifiScanList);
+
     if (index >= sWifiScanList.numAp)
     {
         ffsLogDebug("Index %d larger than numAp %d.", index, sWifiScanList.numAp);
         goto error;
     }
 
-    memcpy(scanResult, &sWifiScanList.apInfo[index], sizeof(SYS_WIFI_CONFIG));
+    // The entry may have aged out of the cache since the scan.
+    if (!SYS_SCANCACHE_Find(sWifiScanList.bssid[index], &entry))
+    {
+        ffsLogDebug("AP %d no longer in the scan cache.", index);
+        goto error;
+    }
+
+    memcpy(scanResult, &entry.bssInfo, sizeof(WDRV_PIC32MZW_BSS_INFO));
     
     FFS_GIVE_LOCK_FOR(sWifiScanList);
     return FFS_SUCCESS;
@@ -349,6 +411,7 @@ FFS_RESULT ffsWifiManagerLoadStaCredentials(const FfsUserContext_t *userContext,
     FFS_TAKE_LOCK_FOR(sWifiCurrStaProfile);
     memset(&sWifiCurrStaProfile, 0x0, sizeof(SYS_WIFI_CONFIG));
     memcpy(&sWifiCurrStaProfile, wifiCredentials, (sizeof(SYS_WIFI_CONFIG)));
+    sWifiCurrStaChannel = 0;
     
     sWifiCurrState = FFS_WIFI_CONNECTION_STATE_IDLE;
     FFS_GIVE_LOCK_FOR(sWifiCurrStaProfile);
@@ -372,19 +435,94 @@ FFS_RESULT ffsWifiManagerClearStaCredentials(const FfsUserContext_t *userContext
     return FFS_SUCCESS;
 }
 
+/* Channel of the strongest recent scan cache entry for an SSID (0 if none) */
+static uint8_t ffsPrivateWifiScanCacheChannel(const char *ssid)
+{
+    SYS_SCANCACHE_ENTRY entry;
+    const size_t ssidLength = strlen(ssid);
+    uint8_t channel = 0;
+    int8_t rssi = INT8_MIN;
+    uint8_t count = SYS_SCANCACHE_Count();
+
+    for (uint8_t index = 0; index < count; index++)
+    {
+        if (SYS_SCANCACHE_Get(index, &entry) && entry.age <= FFS_WIFI_SCAN_MAX_AGE_MS
+                && entry.bssInfo.ctx.ssid.length == ssidLength
+                && !memcmp(entry.bssInfo.ctx.ssid.name, ssid, ssidLength)
+                && (!channel || entry.bssInfo.rssi > rssi))
+        {
+            channel = entry.bssInfo.ctx.channel;
+            rssi = entry.bssInfo.rssi;
+        }
+    }
+
+    return channel;
+}
+
+FFS_RESULT ffsWifiManagerActiveScanForNetwork(const FfsUserContext_t *userContext)
+{
+    char ssid[FFS_WIFI_MAX_SSID_LEN + 1];
+    bool found = false;
+
+    FFS_TAKE_LOCK_FOR(sWifiCurrStaProfile);
+    memset(ssid, 0, sizeof(ssid));
+    strncpy(ssid, (const char *)sWifiCurrStaProfile.staConfig.ssid, FFS_WIFI_MAX_SSID_LEN);
+    sWifiCurrStaChannel = 0;
+    FFS_GIVE_LOCK_FOR(sWifiCurrStaProfile);
+
+    if (!ssid[0])
+    {
+        return FFS_SUCCESS;
+    }
+
+    // A recent scan already saw the network: no need to probe for it.
+    const uint8_t cachedChannel = ffsPrivateWifiScanCacheChannel(ssid);
+    if (cachedChannel)
+    {
+        ffsLogDebug("\"%s\" in the scan cache on channel %d. Skip directed scan...", ssid, cachedChannel);
+        FFS_TAKE_LOCK_FOR(sWifiCurrStaProfile);
+        sWifiCurrStaChannel = cachedChannel;
+        FFS_GIVE_LOCK_FOR(sWifiCurrStaProfile);
+        return FFS_SUCCESS;
+    }
+
+    const FFS_RESULT result = ffsDirectedScan(userContext, ssid, &found);
+    if (result == FFS_NOT_IMPLEMENTED)
+    {
+        return FFS_SUCCESS;
+    }
+    FFS_CHECK_RESULT(result);
+
+    if (found)
+    {
+        FFS_TAKE_LOCK_FOR(sWifiCurrStaProfile);
+        sWifiCurrStaChannel = ffsDirectedScanGetLastChannel();
+        FFS_GIVE_LOCK_FOR(sWifiCurrStaProfile);
+    }
+
+    return FFS_SUCCESS;
+}
+
 FFS_RESULT ffsWifiManagerConnect(FfsUserContext_t *userContext)
 {  
-    ffsPrivateWifiManagerConnect(userContext);
+    FFS_TAKE_LOCK_FOR(sWifiCurrStaProfile);
+    sWifiConnectRetryOnAllChannels = sWifiCurrStaChannel != 0;
+    FFS_GIVE_LOCK_FOR(sWifiCurrStaProfile);
+
+    FFS_CHECK_RESULT(ffsPrivateWifiManagerConnect(userContext));
     
     return FFS_SUCCESS;
 }
 
 FFS_RESULT ffsWifiManagerGetConnectionDetails(const FfsUserContext_t *userContext, SYS_WIFI_CONFIG *const wifiNetWorkProfile, FFS_WIFI_CONNECTION_STATE *const connectionState)
 {
-    
+    FFS_CHECK_RESULT(ffsPrivateWifiManagerPollConnect((FfsUserContext_t *)userContext));
+
     FFS_TAKE_LOCK_FOR(sWifiCurrStaProfile);
     
-    if (sWifiCurrState != FFS_WIFI_CONNECTION_STATE_ASSOCIATED && !WDRV_PIC32MZW_MACLinkCheck(userContext->sysObj->syswifi))
+    // The link is down until a connection in progress completes.
+    if (sWifiConnectPhase == FFS_WIFI_MANAGER_CONNECT_PHASE_IDLE && sWifiCurrState != FFS_WIFI_CONNECTION_STATE_ASSOCIATED
+            && !WDRV_PIC32MZW_MACLinkCheck(userContext->sysObj->syswifi))
     {
         sWifiCurrState = FFS_WIFI_CONNECTION_STATE_DISCONNECTED;
     }
@@ -14,6 +14,7 @@
 
 #include "FreeRTOS.h"
 #include "definitions.h"
+#include "app.h"
 #include "wdrv_pic32mzw.h"
 #include "net_pres/pres/net_pres_enc_glue.h"
 
@@ -170,6 +171,15 @@ FFS_RESULT ffsConnectToWifi(struct FfsUserContext_s *userContext)
         //NET_PRES_EncGlue_StreamClient_Set_Verify(1);
     }
     
+    /* Negative DNS answers from the previous network do not apply to the next one. */
+    ffsHttpClientFlushNegativeDnsCache();
+    
+    /* Probe for the network first; the connection then starts on the channel it answered on. */
+    if (ffsWifiManagerActiveScanForNetwork(userContext) != FFS_SUCCESS)
+    {
+        ffsLogWarning("Directed scan failed. Connecting on all channels...");
+    }
+
     FFS_CHECK_RESULT(ffsWifiManagerConnect(userContext));
 
     return FFS_SUCCESS;
@@ -303,6 +313,93 @@ FFS_RESULT ffsWifiProvisioneeCanGetWifiCredentials(struct FfsUserContext_s *user
     return FFS_SUCCESS;
 }
 
+/*
+ * Save the provisioning checkpoint.
+ *
+ * The record is written to a temporary file first and renamed over the
+ * previous one, so a reset during the write leaves the previous checkpoint.
+ */
+FFS_RESULT ffsSaveWifiProvisioneeCheckpoint(struct FfsUserContext_s *userContext,
+        FfsStream_t *checkpointStream)
+{
+    (void) userContext;
+
+    SYS_FS_HANDLE fileHandle = SYS_FS_FileOpen(FFS_CHECKPOINT_TMP_FILE, SYS_FS_FILE_OPEN_WRITE);
+    if (fileHandle == SYS_FS_HANDLE_INVALID) {
+        ffsLogWarning("Unable to open \"%s\" for writing", FFS_CHECKPOINT_TMP_FILE);
+        return FFS_ERROR;
+    }
+
+    size_t dataSize = FFS_STREAM_DATA_SIZE(*checkpointStream);
+    bool written = SYS_FS_FileWrite(fileHandle, FFS_STREAM_NEXT_READ(*checkpointStream), dataSize) == dataSize;
+    if (written) {
+        SYS_FS_FileSync(fileHandle);
+    }
+    SYS_FS_FileClose(fileHandle);
+
+    if (!written || SYS_FS_FileDirectoryRenameMove(FFS_CHECKPOINT_TMP_FILE, FFS_CHECKPOINT_FILE)
+            != SYS_FS_RES_SUCCESS) {
+        ffsLogWarning("Unable to write \"%s\"", FFS_CHECKPOINT_FILE);
+        SYS_FS_FileDirectoryRemove(FFS_CHECKPOINT_TMP_FILE);
+        return FFS_ERROR;
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Load the provisioning checkpoint.
+ */
+FFS_RESULT ffsLoadWifiProvisioneeCheckpoint(struct FfsUserContext_s *userContext,
+        FfsStream_t *checkpointStream)
+{
+    (void) userContext;
+
+    // No checkpoint?
+    SYS_FS_FSTAT fileStatus;
+    if (SYS_FS_FileStat(FFS_CHECKPOINT_FILE, &fileStatus) != SYS_FS_RES_SUCCESS) {
+        return FFS_SUCCESS;
+    }
+
+    if (fileStatus.fsize > FFS_STREAM_SPACE_SIZE(*checkpointStream)) {
+        ffsLogWarning("Checkpoint file \"%s\" is too large", FFS_CHECKPOINT_FILE);
+        return FFS_OVERRUN;
+    }
+
+    SYS_FS_HANDLE fileHandle = SYS_FS_FileOpen(FFS_CHECKPOINT_FILE, SYS_FS_FILE_OPEN_READ);
+    if (fileHandle == SYS_FS_HANDLE_INVALID) {
+        return FFS_ERROR;
+    }
+
+    size_t readSize = SYS_FS_FileRead(fileHandle, FFS_STREAM_NEXT_WRITE(*checkpointStream), fileStatus.fsize);
+    SYS_FS_FileClose(fileHandle);
+
+    if (readSize != fileStatus.fsize) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    checkpointStream->dataSize += readSize;
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Remove the stored provisioning checkpoint.
+ */
+FFS_RESULT ffsClearWifiProvisioneeCheckpoint(struct FfsUserContext_s *userContext)
+{
+    (void) userContext;
+
+    SYS_FS_FSTAT fileStatus;
+    if (SYS_FS_FileStat(FFS_CHECKPOINT_FILE, &fileStatus) == SYS_FS_RES_SUCCESS
+            && SYS_FS_FileDirectoryRemove(FFS_CHECKPOINT_FILE) != SYS_FS_RES_SUCCESS) {
+        ffsLogWarning("Unable to remove \"%s\"", FFS_CHECKPOINT_FILE);
+        return FFS_ERROR;
+    }
+
+    return FFS_SUCCESS;
+}
+
 FFS_RESULT ffsSetWifiProvisioneeState(struct FfsUserContext_s *userContext,
         FFS_WIFI_PROVISIONEE_STATE provisioneeState)
 {
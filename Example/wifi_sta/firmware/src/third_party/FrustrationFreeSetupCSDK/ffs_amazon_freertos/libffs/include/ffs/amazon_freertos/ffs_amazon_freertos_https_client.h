@@ -21,12 +21,44 @@
 #include "ffs/common/ffs_result.h"
 #include "ffs/compat/ffs_user_context.h"
 
+/** @brief Size of the pooled connection user buffer.
+ *
+ * Must be at least connectionUserBufferMinimumSize.
+ */
+#ifndef FFS_HTTPS_CONNECTION_USER_BUFFER_SIZE
+#define FFS_HTTPS_CONNECTION_USER_BUFFER_SIZE   512
+#endif
+
+/** @brief Size of the pooled request user buffer.
+ *
+ * Holds the request context followed by the request line and headers.
+ */
+#ifndef FFS_HTTPS_REQUEST_USER_BUFFER_SIZE
+#define FFS_HTTPS_REQUEST_USER_BUFFER_SIZE      1024
+#endif
+
+/** @brief Size of the pooled response user buffer.
+ *
+ * Holds the response context followed by the raw status line and headers.
+ */
+#ifndef FFS_HTTPS_RESPONSE_USER_BUFFER_SIZE
+#define FFS_HTTPS_RESPONSE_USER_BUFFER_SIZE     1536
+#endif
+
+/* User buffers handed to the HTTPS client library, reused by every request. */
+typedef struct {
+    uint8_t connectionUserBuffer[FFS_HTTPS_CONNECTION_USER_BUFFER_SIZE];
+    uint8_t requestUserBuffer[FFS_HTTPS_REQUEST_USER_BUFFER_SIZE];
+    uint8_t responseUserBuffer[FFS_HTTPS_RESPONSE_USER_BUFFER_SIZE];
+} FfsHttpsBufferPool_t;
+
 /* A struct to hold connection information. */
 typedef struct {
     bool isConnected;
     uint8_t *connectionContextBuffer;
     uint32_t connectionContextBufferSize;
     IotHttpsConnectionHandle_t connectionHandle;
+    FfsHttpsBufferPool_t bufferPool;
 } FfsHttpsConnectionContext_t;
 
 /**
@@ -34,6 +66,14 @@ typedef struct {
  */
 FFS_RESULT ffsHttpPost(struct FfsUserContext_s *userContext, FfsHttpRequest_t *request, void *callbackDataPointer);
 
+/**
+ * @brief Execute a post operation with a time limit for each send attempt.
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT); @ref FFS_TIMEOUT if the response did not arrive in time
+ */
+FFS_RESULT ffsHttpPostWithTimeout(struct FfsUserContext_s *userContext, FfsHttpRequest_t *request,
+        void *callbackDataPointer, uint32_t timeoutMs);
+
 /** @brief Initialize connection context to be used to make
  * HTTPS requests.
  * 
@@ -46,7 +86,8 @@ FFS_RESULT ffsInitializeHttpsConnectionContext(FfsHttpsConnectionContext_t *ffsH
 /** @brief De-Initialize connection context to be used to make
  * HTTPS requests.
  * 
- * Note: This will also disconnect from the underlying server if connected.
+ * Note: This will also disconnect from the underlying server if the
+ * connection is still alive.
  * 
  * @param ffsHttpsConnContext Context to initialize.
  * 
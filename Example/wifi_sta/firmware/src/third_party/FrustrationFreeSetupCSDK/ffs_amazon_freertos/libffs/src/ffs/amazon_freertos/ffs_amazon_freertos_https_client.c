@@ -22,19 +22,25 @@
 #include "ffs_amazon_freertos_credentials.h"
 
 /* Amazon Free RTOS includes */
+#include "FreeRTOS.h"
+#include "task.h"
 #include "iot_https_client.h"
 #include "platform/iot_network_freertos.h"
 
 #include <string.h>
+#include <strings.h>
 
 #define FFS_HTTPS_TIMEOUT_MS                5000
 #define FFS_AMAZON_SIGNATURE_HEADER_FIELD   "x-amzn-dss-signature"
 #define FFS_AMAZON_REQUEST_ID_HEADER_FIELD  "x-amzn-RequestId"
+#define FFS_CONNECTION_HEADER_FIELD         "Connection"
+#define FFS_CONNECTION_CLOSE_VALUE          "close"
 #define FFS_HTTPS_CONNECT_TRIES             7
 #define FFS_HTTPS_REQUEST_TRIES             3
-#define FFS_REQUEST_USER_BUFFER             requestUserBufferMinimumSize + 256
-#define FFS_RESPONSE_USER_BUFFER            responseUserBufferMinimumSize + 512
-#define FFS_MAX_HEADER_VALUE_SIZE           256
+#define FFS_HTTPS_INITIAL_BACKOFF_MS        250
+#define FFS_HTTPS_MAXIMUM_BACKOFF_MS        2000
+#define FFS_REQUEST_HEADER_SPACE            256
+#define FFS_RESPONSE_HEADER_SPACE           512
 
 #define STARFIELD_CLASS_2_CERTIFICATION_AUTHORITY \
     "-----BEGIN CERTIFICATE-----\n"\
@@ -69,34 +75,46 @@ static FFS_RESULT ffsConnectToServer(FfsHttpsConnectionContext_t *ffsHttpsConnCo
         FfsStream_t *hostStream, uint16_t port);
 static FFS_RESULT ffsHttpRequestInit(IotHttpsRequestHandle_t *requestHandle, 
         IotHttpsRequestInfo_t *requestInfo);
+/* Hand the interesting response headers to the header callback in one pass */
+static FFS_RESULT ffsHandleResponseHeaders(FfsHttpsConnectionContext_t *ffsHttpsConnContext,
+        FfsHttpRequest_t *request, void *callbackDataPointer);
+/* Wait before the next connection or request attempt */
+static void ffsBackOff(uint32_t *backoffMs);
 
 FFS_RESULT ffsInitializeHttpsConnectionContext(FfsHttpsConnectionContext_t *ffsHttpsConnContext) {
-    uint8_t *buffer = pvPortMalloc(connectionUserBufferMinimumSize);
-    
-    if (buffer == NULL) {
-        ffsLogError("Cannot allocate memory for connection context buffer.");
+    // The pool is sized at compile time, the library minimums are only known at run time.
+    if (FFS_HTTPS_CONNECTION_USER_BUFFER_SIZE < connectionUserBufferMinimumSize
+            || FFS_HTTPS_REQUEST_USER_BUFFER_SIZE < requestUserBufferMinimumSize + FFS_REQUEST_HEADER_SPACE
+            || FFS_HTTPS_RESPONSE_USER_BUFFER_SIZE < responseUserBufferMinimumSize + FFS_RESPONSE_HEADER_SPACE) {
+        ffsLogError("HTTPS buffer pool too small (minimums: %u/%u/%u).",
+                (unsigned int) connectionUserBufferMinimumSize,
+                (unsigned int) (requestUserBufferMinimumSize + FFS_REQUEST_HEADER_SPACE),
+                (unsigned int) (responseUserBufferMinimumSize + FFS_RESPONSE_HEADER_SPACE));
         FFS_FAIL(FFS_ERROR);
     }
 
     ffsHttpsConnContext->isConnected = false;
-    ffsHttpsConnContext->connectionContextBuffer = buffer;
-    ffsHttpsConnContext->connectionContextBufferSize = connectionUserBufferMinimumSize;
+    ffsHttpsConnContext->connectionContextBuffer = ffsHttpsConnContext->bufferPool.connectionUserBuffer;
+    ffsHttpsConnContext->connectionContextBufferSize = FFS_HTTPS_CONNECTION_USER_BUFFER_SIZE;
     ffsHttpsConnContext->connectionHandle = IOT_HTTPS_CONNECTION_HANDLE_INITIALIZER;
 
     return FFS_SUCCESS;
 }
 
 FFS_RESULT ffsDeinitializeHttpsConnectionContext(FfsHttpsConnectionContext_t *ffsHttpsConnContext) {
-    int disconnectionResult = -1;
-    
-    // IotHttpsClient_Disconnect() is unstable, so we do not disconnect it manually here.
-    ffsHttpsConnContext->connectionHandle = NULL;
-    
-    // De allocate the connection context buffer
-    if (ffsHttpsConnContext->connectionContextBuffer != NULL) {
-        free(ffsHttpsConnContext->connectionContextBuffer);
+    // Only disconnect a connection the server has not closed; disconnecting a dead one is what
+    // used to be unstable.
+    if (ffsHttpsConnContext->isConnected && ffsHttpsConnContext->connectionHandle != NULL) {
+        IotHttpsReturnCode_t result = IotHttpsClient_Disconnect(ffsHttpsConnContext->connectionHandle);
+
+        if (result != IOT_HTTPS_OK) {
+            ffsLogWarning("IotHttpsClient_Disconnect return %i", result);
+        }
     }
 
+    ffsHttpsConnContext->isConnected = false;
+    ffsHttpsConnContext->connectionHandle = NULL;
+
     return FFS_SUCCESS;
 }
 
@@ -118,6 +136,15 @@ FFS_RESULT ffsDssClientGetBuffers(struct FfsUserContext_s *userContext,
  * Execute a post operation.
  */
 FFS_RESULT ffsHttpPost(FfsUserContext_t *userContext, FfsHttpRequest_t *request, void *callbackDataPointer)
+{
+    return ffsHttpPostWithTimeout(userContext, request, callbackDataPointer, FFS_HTTPS_TIMEOUT_MS);
+}
+
+/*
+ * Execute a post operation with a time limit for each send attempt.
+ */
+FFS_RESULT ffsHttpPostWithTimeout(FfsUserContext_t *userContext, FfsHttpRequest_t *request,
+        void *callbackDataPointer, uint32_t timeoutMs)
 {   
     ffsLogDebug("Amazon free RTOS HTTPS compat function start...");
 
@@ -160,8 +187,7 @@ FFS_RESULT ffsHttpPost(FfsUserContext_t *userContext, FfsHttpRequest_t *request,
     IotHttpsResponseInfo_t responseInfo = IOT_HTTPS_RESPONSE_INFO_INITIALIZER;
     IotHttpsRequestHandle_t requestHandle = IOT_HTTPS_REQUEST_HANDLE_INITIALIZER;
     IotHttpsResponseHandle_t responseHandle = IOT_HTTPS_RESPONSE_HANDLE_INITIALIZER;
-    uint8_t requestBuffer[FFS_REQUEST_USER_BUFFER];
-    uint8_t responseBuffer[FFS_RESPONSE_USER_BUFFER];
+    FfsHttpsBufferPool_t *bufferPool = &userContext->ffsHttpsConnContext.bufferPool;
     int result = IOT_HTTPS_INTERNAL_ERROR;
 
     /************************** HTTPS request setup. ***************************/
@@ -176,8 +202,8 @@ FFS_RESULT ffsHttpPost(FfsUserContext_t *userContext, FfsHttpRequest_t *request,
     requestInfo.pPath = request->url.path;
     requestInfo.pathLen = strlen(request->url.path);
     requestInfo.method = IOT_HTTPS_METHOD_POST;
-    requestInfo.userBuffer.pBuffer = requestBuffer;
-    requestInfo.userBuffer.bufferLen = FFS_REQUEST_USER_BUFFER;
+    requestInfo.userBuffer.pBuffer = bufferPool->requestUserBuffer;
+    requestInfo.userBuffer.bufferLen = FFS_HTTPS_REQUEST_USER_BUFFER_SIZE;
     requestInfo.isAsync = false;
     requestInfo.u.pSyncInfo = &syncRequestInfo;
     requestInfo.isNonPersistent = false;
@@ -199,8 +225,8 @@ FFS_RESULT ffsHttpPost(FfsUserContext_t *userContext, FfsHttpRequest_t *request,
     syncResponseInfo.bodyLen = bodyStreamTotalSize - 1; // Save one byte for null termination
     
     // Set reponse context info
-    responseInfo.userBuffer.pBuffer = responseBuffer;
-    responseInfo.userBuffer.bufferLen = FFS_RESPONSE_USER_BUFFER;
+    responseInfo.userBuffer.pBuffer = bufferPool->responseUserBuffer;
+    responseInfo.userBuffer.bufferLen = FFS_HTTPS_RESPONSE_USER_BUFFER_SIZE;
     responseInfo.pSyncInfo = &syncResponseInfo;
 
     ffsLogDebug("Response Initialized successfully...");
@@ -209,39 +235,44 @@ FFS_RESULT ffsHttpPost(FfsUserContext_t *userContext, FfsHttpRequest_t *request,
     /* This synchronous send function blocks until the full response is received
      * from the network. */
 
-    // Make the request retrying on timeout
-    result = IotHttpsClient_SendSync(userContext->ffsHttpsConnContext.connectionHandle, requestHandle, 
-        &(responseHandle), &(responseInfo), FFS_HTTPS_TIMEOUT_MS);
-	
-    // Did we fail?
-    if (result != IOT_HTTPS_OK) {
-        ffsLogError("IotHttpsClient_SendSync Failed...");
+    // Make the request, reconnecting with backoff on network errors and timeouts
+    uint32_t backoffMs = FFS_HTTPS_INITIAL_BACKOFF_MS;
+    for (int tryNum = 1; ; tryNum++) {
+
+        // Clear the header area so the header scan stops at the end of this response.
+        memset(bufferPool->responseUserBuffer + responseUserBufferMinimumSize, 0,
+                FFS_HTTPS_RESPONSE_USER_BUFFER_SIZE - responseUserBufferMinimumSize);
+
+        result = IotHttpsClient_SendSync(userContext->ffsHttpsConnContext.connectionHandle, requestHandle, 
+            &(responseHandle), &(responseInfo), timeoutMs);
+
+        if (result == IOT_HTTPS_OK) {
+            break;
+        }
+
+        ffsLogError("IotHttpsClient_SendSync Failed (try %i)...", tryNum);
         ffsLogError("IOT_HTTPS Error code: %i", result);
-        
+
         // May be we disconnected from server or timed out?
-        if (result != IOT_HTTPS_NETWORK_ERROR && result != IOT_HTTPS_TIMEOUT_ERROR)
-        {
+        if (result != IOT_HTTPS_NETWORK_ERROR && result != IOT_HTTPS_TIMEOUT_ERROR) {
             FFS_FAIL(FFS_ERROR);
         }
 
+        // The library has torn the connection down.
+        userContext->ffsHttpsConnContext.isConnected = false;
+
+        if (tryNum >= FFS_HTTPS_REQUEST_TRIES) {
+            FFS_FAIL(result == IOT_HTTPS_TIMEOUT_ERROR ? FFS_TIMEOUT : FFS_ERROR);
+        }
+
         // Reconnect
+        ffsBackOff(&backoffMs);
         ffsLogDebug("ffsConnectToServer");
         FFS_CHECK_RESULT(ffsConnectToServer(&userContext->ffsHttpsConnContext, &request->url.hostStream,
             request->url.port));
         
         // Initialize Request
         FFS_CHECK_RESULT(ffsHttpRequestInit(&requestHandle, &requestInfo));
-        ffsLogStream("Body Stream", &request->bodyStream);
-        
-        // Make the request retrying on timeout
-        result = IotHttpsClient_SendSync(userContext->ffsHttpsConnContext.connectionHandle, requestHandle, 
-            &(responseHandle), &(responseInfo), FFS_HTTPS_TIMEOUT_MS);
-
-        if (result != IOT_HTTPS_OK) {
-            ffsLogError("IotHttpsClient_SendSync Failed after reconnect...");
-            ffsLogError("IOT_HTTPS Error code: %i", result);
-            FFS_FAIL(FFS_ERROR);
-        }
     }
 
     ffsLogDebug("Successfully made a request response cycle...");
@@ -284,36 +315,8 @@ FFS_RESULT ffsHttpPost(FfsUserContext_t *userContext, FfsHttpRequest_t *request,
         FFS_CHECK_RESULT(request->callbacks.handleStatusCode(httpStatusCode, callbackDataPointer));
     }
 
-    // Create a list of interesting headers for FFS
-    const char *interestingHeaders[] = {
-        FFS_AMAZON_SIGNATURE_HEADER_FIELD, 
-        FFS_AMAZON_REQUEST_ID_HEADER_FIELD, 
-        0
-    };
-
-    // Parse interesting headers and pass to handle header callback
-    FFS_TEMPORARY_OUTPUT_STREAM(headerValueStream, FFS_MAX_HEADER_VALUE_SIZE);
-    const char **iterator = &interestingHeaders;
-
-    while (*iterator != NULL) {
-        memset(FFS_STREAM_NEXT_WRITE(headerValueStream), 0, FFS_MAX_HEADER_VALUE_SIZE);
-        result = IotHttpsClient_ReadHeader(responseHandle, *iterator, strlen(*iterator),
-                (const char *) FFS_STREAM_NEXT_WRITE(headerValueStream), FFS_MAX_HEADER_VALUE_SIZE);
-
-        if (result != IOT_HTTPS_OK) {
-            ffsLogWarning("Could not find header %s in response.", *iterator);
-            ffsLogWarning("IotHttpsClient_ReadHeader return %i", result);
-        } else {
-            // use handle header callback
-            if (request->callbacks.handleHeader) {
-                FfsStream_t keyStream = FFS_STRING_INPUT_STREAM(*iterator);
-                FfsStream_t valueStream = FFS_STRING_INPUT_STREAM((const char *) FFS_STREAM_NEXT_WRITE(headerValueStream));
-                request->callbacks.handleHeader(&keyStream, &valueStream, callbackDataPointer);          
-            }
-        }
-
-        iterator ++;
-    }
+    // Pass the interesting headers to the handle header callback
+    FFS_CHECK_RESULT(ffsHandleResponseHeaders(&userContext->ffsHttpsConnContext, request, callbackDataPointer));
 
     uint32_t contentLength;
     result = IotHttpsClient_ReadContentLength(responseHandle, &contentLength);
@@ -352,7 +355,7 @@ static FFS_RESULT ffsConnectToServer(FfsHttpsConnectionContext_t *ffsHttpsConnCo
         .addressLen = FFS_STREAM_DATA_SIZE(*hostStream),
         .port = port,
         .userBuffer.pBuffer = ffsHttpsConnContext->connectionContextBuffer,
-        .userBuffer.bufferLen = connectionUserBufferMinimumSize,
+        .userBuffer.bufferLen = ffsHttpsConnContext->connectionContextBufferSize,
 
         /* Use FreeRTOS+TCP network. */
         .pNetworkInterface = IOT_NETWORK_INTERFACE_AFR,
@@ -371,15 +374,24 @@ static FFS_RESULT ffsConnectToServer(FfsHttpsConnectionContext_t *ffsHttpsConnCo
     // Reset connection handle because the previous one is bad
     memset(ffsHttpsConnContext->connectionContextBuffer, 0, ffsHttpsConnContext->connectionContextBufferSize);
 
+    ffsHttpsConnContext->isConnected = false;
+
     // Try to connect to the server
     int tryNum = 0;
     int result = IOT_HTTPS_NETWORK_ERROR;
+    uint32_t backoffMs = FFS_HTTPS_INITIAL_BACKOFF_MS;
     
     // Try in a loop. Connect is unreliable as the server may close the 
     // connection in some of the tries.
-    while (result != IOT_HTTPS_OK && tryNum < FFS_HTTPS_CONNECT_TRIES) {
+    while (true) {
         result = IotHttpsClient_Connect(&ffsHttpsConnContext->connectionHandle, &connectionInfo);
         tryNum += 1;
+
+        if (result == IOT_HTTPS_OK || tryNum >= FFS_HTTPS_CONNECT_TRIES) {
+            break;
+        }
+
+        ffsBackOff(&backoffMs);
     }
     
     // Did we succeed in connecting?
@@ -432,4 +444,104 @@ static FFS_RESULT ffsHttpRequestInit(IotHttpsRequestHandle_t *requestHandle, Iot
 
     ffsLogDebug("Request successfully initialized...");
     return FFS_SUCCESS;
-}
\ No newline at end of file
+}
+
+/** @brief Hand the interesting response headers to the header callback in one pass.
+ *
+ * The HTTPS client library stores the raw status line and headers right
+ * after the response context in the response user buffer. Walk them once
+ * instead of calling IotHttpsClient_ReadHeader (which rescans the whole
+ * block) for every header. A "Connection: close" response marks the
+ * connection as closed so that the next request reconnects.
+ */
+static FFS_RESULT ffsHandleResponseHeaders(FfsHttpsConnectionContext_t *ffsHttpsConnContext,
+        FfsHttpRequest_t *request, void *callbackDataPointer)
+{
+    const char *interestingHeaders[] = {
+        FFS_AMAZON_SIGNATURE_HEADER_FIELD,
+        FFS_AMAZON_REQUEST_ID_HEADER_FIELD
+    };
+    const size_t interestingHeaderCount = sizeof(interestingHeaders) / sizeof(interestingHeaders[0]);
+
+    const char *cursor = (const char *) ffsHttpsConnContext->bufferPool.responseUserBuffer
+            + responseUserBufferMinimumSize;
+    const char *end = (const char *) ffsHttpsConnContext->bufferPool.responseUserBuffer
+            + FFS_HTTPS_RESPONSE_USER_BUFFER_SIZE;
+    bool isStatusLine = true;
+
+    while (cursor < end && *cursor) {
+
+        // Find the end of the line.
+        const char *lineEnd = cursor;
+        while (lineEnd < end && *lineEnd && *lineEnd != '\r' && *lineEnd != '\n') {
+            lineEnd++;
+        }
+
+        // Empty line (end of the headers)?
+        if (lineEnd == cursor) {
+            break;
+        }
+
+        // Split "name: value".
+        const char *colon = memchr(cursor, ':', lineEnd - cursor);
+        if (!isStatusLine && colon) {
+            size_t nameLength = colon - cursor;
+            const char *value = colon + 1;
+            while (value < lineEnd && (*value == ' ' || *value == '\t')) {
+                value++;
+            }
+            size_t valueLength = lineEnd - value;
+            while (valueLength && (value[valueLength - 1] == ' ' || value[valueLength - 1] == '\t')) {
+                valueLength--;
+            }
+
+            // Header names are case-insensitive; pass the canonical name to the callback.
+            for (size_t index = 0; index < interestingHeaderCount; index++) {
+                if (nameLength == strlen(interestingHeaders[index])
+                        && !strncasecmp(cursor, interestingHeaders[index], nameLength)
+                        && request->callbacks.handleHeader) {
+                    FfsStream_t keyStream = FFS_STRING_INPUT_STREAM(interestingHeaders[index]);
+                    FfsStream_t valueStream = ffsCreateInputStream((uint8_t *) value, valueLength);
+                    FFS_CHECK_RESULT(request->callbacks.handleHeader(&keyStream, &valueStream,
+                            callbackDataPointer));
+                }
+            }
+
+            // Is the server closing the connection?
+            if (nameLength == strlen(FFS_CONNECTION_HEADER_FIELD)
+                    && !strncasecmp(cursor, FFS_CONNECTION_HEADER_FIELD, nameLength)
+                    && valueLength == strlen(FFS_CONNECTION_CLOSE_VALUE)
+                    && !strncasecmp(value, FFS_CONNECTION_CLOSE_VALUE, valueLength)) {
+                ffsLogDebug("Server is closing the connection.");
+                ffsHttpsConnContext->isConnected = false;
+            }
+        }
+        isStatusLine = false;
+
+        // Skip the line terminator.
+        cursor = lineEnd;
+        if (cursor < end && *cursor == '\r') {
+            cursor++;
+        }
+        if (cursor < end && *cursor == '\n') {
+            cursor++;
+        }
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Wait before the next connection or request attempt.
+ *
+ * Doubles the backoff for the next call, up to @ref FFS_HTTPS_MAXIMUM_BACKOFF_MS.
+ */
+static void ffsBackOff(uint32_t *backoffMs)
+{
+    ffsLogDebug("Backing off for %u ms", (unsigned int) *backoffMs);
+    vTaskDelay(pdMS_TO_TICKS(*backoffMs));
+
+    *backoffMs *= 2;
+    if (*backoffMs > FFS_HTTPS_MAXIMUM_BACKOFF_MS) {
+        *backoffMs = FFS_HTTPS_MAXIMUM_BACKOFF_MS;
+    }
+}
@@ -141,6 +141,58 @@ FFS_RESULT ffsGetRegistrationDetails(struct FfsUserContext_s *userContext, FfsRe
 }
 
 FFS_RESULT ffsHttpExecute(struct FfsUserContext_s *userContext, FfsHttpRequest_t *request, void *callbackDataPointer) {
-    FFS_CHECK_RESULT(ffsHttpPost(userContext, request, callbackDataPointer));
+    FfsHttpOperation_t *operation;
+    FFS_CHECK_RESULT(ffsHttpExecuteAsync(userContext, request, callbackDataPointer, 0, NULL, &operation));
+    FFS_CHECK_RESULT(ffsHttpWait(userContext, operation));
+    return FFS_SUCCESS;
+}
+
+/* The IotHttps client is used synchronously here, so an operation completes
+ * before ffsHttpExecuteAsync returns and there is never anything to cancel. */
+struct FfsHttpOperation_s {
+    FFS_RESULT result;
+};
+
+FFS_RESULT ffsHttpExecuteAsync(struct FfsUserContext_s *userContext, FfsHttpRequest_t *request,
+        void *callbackDataPointer, uint32_t timeoutMs, FfsHttpCompletionCallback_t onComplete,
+        FfsHttpOperation_t **operation) {
+    FfsHttpOperation_t detachedOperation;
+    FfsHttpOperation_t *newOperation = &detachedOperation;
+
+    if (operation) {
+        newOperation = pvPortMalloc(sizeof(FfsHttpOperation_t));
+        if (!newOperation) {
+            FFS_FAIL(FFS_OVERRUN);
+        }
+    }
+
+    if (timeoutMs) {
+        newOperation->result = ffsHttpPostWithTimeout(userContext, request, callbackDataPointer, timeoutMs);
+    } else {
+        newOperation->result = ffsHttpPost(userContext, request, callbackDataPointer);
+    }
+
+    if (onComplete) {
+        onComplete(newOperation, newOperation->result, callbackDataPointer);
+    }
+
+    if (operation) {
+        *operation = newOperation;
+    }
+    return FFS_SUCCESS;
+}
+
+FFS_RESULT ffsHttpWait(struct FfsUserContext_s *userContext, FfsHttpOperation_t *operation) {
+    (void) userContext;
+
+    FFS_RESULT result = operation->result;
+    vPortFree(operation);
+    return result;
+}
+
+FFS_RESULT ffsHttpCancel(struct FfsUserContext_s *userContext, FfsHttpOperation_t *operation) {
+    (void) userContext;
+    (void) operation;
+
     return FFS_SUCCESS;
 }
\ No newline at end of file
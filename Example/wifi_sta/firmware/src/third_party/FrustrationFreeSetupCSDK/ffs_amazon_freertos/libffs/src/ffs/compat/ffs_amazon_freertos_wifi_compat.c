@@ -333,6 +333,27 @@ FFS_RESULT ffsWifiProvisioneeCanProceed(struct FfsUserContext_s *userContext,
     return FFS_SUCCESS;
 }
 
+/*
+ * Provisioning checkpoints need persistent storage, which this port does not
+ * set up. A session interrupted by a reset starts over.
+ */
+FFS_RESULT ffsSaveWifiProvisioneeCheckpoint(struct FfsUserContext_s *userContext,
+        FfsStream_t *checkpointStream)
+{
+    return FFS_NOT_IMPLEMENTED;
+}
+
+FFS_RESULT ffsLoadWifiProvisioneeCheckpoint(struct FfsUserContext_s *userContext,
+        FfsStream_t *checkpointStream)
+{
+    return FFS_NOT_IMPLEMENTED;
+}
+
+FFS_RESULT ffsClearWifiProvisioneeCheckpoint(struct FfsUserContext_s *userContext)
+{
+    return FFS_NOT_IMPLEMENTED;
+}
+
 static FFS_RESULT ffsGetWifiConnectionErrorDetails(const FFS_WIFI_CONNECTION_STATE attemptState, bool *const hasErrorDetails, FfsErrorDetails_t *const errorDetails)
 {
     // The only failure wifi manager gives.
@@ -0,0 +1,375 @@
+/** @file ffs_common_benchmarks.c
+ *
+ * @brief JSON, stream and codec microbenchmarks.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_base64.h"
+#include "ffs/common/ffs_base85.h"
+#include "ffs/common/ffs_check_result.h"
+#include "ffs/common/ffs_hex.h"
+#include "ffs/common/ffs_json.h"
+#include "ffs/common/ffs_stream.h"
+#include "ffs_benchmark.h"
+#include "ffs_benchmark_payloads.h"
+
+#include <string.h>
+
+#define CODEC_PLAINTEXT_SIZE        (256)
+#define CODEC_BASE64_SIZE           (((CODEC_PLAINTEXT_SIZE + 2) / 3) * 4)
+#define CODEC_HEX_SIZE              (CODEC_PLAINTEXT_SIZE * 2)
+#define STREAM_DATA_SIZE            (1024)
+#define STREAM_CHUNK_SIZE           (16)
+
+/** @brief Quoted SSID as the DSS sends it, with every kind of escape.
+ */
+#define ESCAPED_JSON_STRING         "\"\\\"Guest \\u00e9t\\u00e9 5G\\\\wifi\\/home\\tnet\\\"\""
+
+/** @brief Raw string that needs escaping when encoded.
+ */
+#define UNESCAPED_STRING            "Home \"Network\"\\5G\tguest\r\n\x01\x1f end of the SSID"
+
+static uint8_t codecPlaintext[CODEC_PLAINTEXT_SIZE];
+static uint8_t codecBase64[CODEC_BASE64_SIZE];
+static uint8_t codecHex[CODEC_HEX_SIZE];
+
+/** @brief Create the codec inputs on first use.
+ */
+static FFS_RESULT ffsInitializeCodecData(void)
+{
+    static bool isInitialized = false;
+
+    if (isInitialized) {
+        return FFS_SUCCESS;
+    }
+
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    for (size_t i = 0; i < CODEC_PLAINTEXT_SIZE; i++) {
+        codecPlaintext[i] = (uint8_t) (i * 37 + 11);
+        codecHex[i * 2] = (uint8_t) HEX_DIGITS[codecPlaintext[i] >> 4];
+        codecHex[i * 2 + 1] = (uint8_t) HEX_DIGITS[codecPlaintext[i] & 0x0f];
+    }
+
+    FfsStream_t plaintextStream = ffsCreateInputStream(codecPlaintext, sizeof(codecPlaintext));
+    FfsStream_t base64Stream = ffsCreateOutputStream(codecBase64, sizeof(codecBase64));
+    FFS_CHECK_RESULT(ffsEncodeBase64(&plaintextStream, 0, NULL, &base64Stream));
+
+    isInitialized = true;
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Parse a flat response object and convert every field.
+ */
+static FFS_RESULT ffsBenchmarkParseJsonObject(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    (void) userContext;
+
+    const char *payload = POST_WIFI_SCAN_DATA_RESPONSE_PAYLOAD;
+    memcpy(buffer, payload, sizeof(POST_WIFI_SCAN_DATA_RESPONSE_PAYLOAD) - 1);
+    FfsStream_t payloadStream = ffsCreateInputStream(buffer, sizeof(POST_WIFI_SCAN_DATA_RESPONSE_PAYLOAD) - 1);
+
+    FfsJsonValue_t rootValue;
+    FFS_CHECK_RESULT(ffsInitializeJsonObject(&payloadStream, &rootValue));
+
+    FfsJsonField_t nonceField = ffsCreateJsonField("nonce", FFS_JSON_STRING);
+    FfsJsonField_t sessionIdField = ffsCreateJsonField("sessionId", FFS_JSON_STRING);
+    FfsJsonField_t canProceedField = ffsCreateJsonField("canProceed", FFS_JSON_BOOLEAN);
+    FfsJsonField_t sequenceNumberField = ffsCreateJsonField("sequenceNumber", FFS_JSON_NUMBER);
+    FfsJsonField_t totalCredentialsFoundField = ffsCreateJsonField("totalCredentialsFound", FFS_JSON_NUMBER);
+    FfsJsonField_t allCredentialsFoundField = ffsCreateJsonField("allCredentialsFound", FFS_JSON_BOOLEAN);
+    FfsJsonField_t *expectedFields[] = { &nonceField, &sessionIdField, &canProceedField,
+            &sequenceNumberField, &totalCredentialsFoundField, &allCredentialsFoundField, NULL };
+    FFS_CHECK_RESULT(ffsParseJsonObject(&rootValue, expectedFields));
+
+    const char *nonce;
+    const char *sessionId;
+    bool canProceed;
+    uint32_t sequenceNumber;
+    uint32_t totalCredentialsFound;
+    bool allCredentialsFound;
+    FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8String(&nonceField.value, &nonce));
+    FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8String(&sessionIdField.value, &sessionId));
+    FFS_CHECK_RESULT(ffsParseJsonBoolean(&canProceedField.value, &canProceed));
+    FFS_CHECK_RESULT(ffsParseJsonUint32(&sequenceNumberField.value, &sequenceNumber));
+    FFS_CHECK_RESULT(ffsParseJsonUint32(&totalCredentialsFoundField.value, &totalCredentialsFound));
+    FFS_CHECK_RESULT(ffsParseJsonBoolean(&allCredentialsFoundField.value, &allCredentialsFound));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Walk the objects of a JSON array.
+ */
+static FFS_RESULT ffsBenchmarkParseJsonArray(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    (void) userContext;
+
+    const char *payload = GET_WIFI_CREDENTIALS_RESPONSE_PAYLOAD;
+    memcpy(buffer, payload, sizeof(GET_WIFI_CREDENTIALS_RESPONSE_PAYLOAD) - 1);
+    FfsStream_t payloadStream = ffsCreateInputStream(buffer, sizeof(GET_WIFI_CREDENTIALS_RESPONSE_PAYLOAD) - 1);
+
+    FfsJsonValue_t rootValue;
+    FFS_CHECK_RESULT(ffsInitializeJsonObject(&payloadStream, &rootValue));
+
+    FfsJsonField_t listField = ffsCreateJsonField("wifiCredentialsList", FFS_JSON_ARRAY);
+    FfsJsonField_t *expectedFields[] = { &listField, NULL };
+    FFS_CHECK_RESULT(ffsParseJsonObject(&rootValue, expectedFields));
+
+    for (;;) {
+        FfsJsonValue_t elementValue;
+        bool isDone = false;
+        FFS_CHECK_RESULT(ffsParseJsonValue(&listField.value, &elementValue, &isDone));
+        if (isDone) {
+            break;
+        }
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Parse an object of long base64 strings and convert every field.
+ */
+static FFS_RESULT ffsBenchmarkParseJsonBase64Payload(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    (void) userContext;
+
+    const char *payload = BASE64_BLOB_RESPONSE_PAYLOAD;
+    memcpy(buffer, payload, sizeof(BASE64_BLOB_RESPONSE_PAYLOAD) - 1);
+    FfsStream_t payloadStream = ffsCreateInputStream(buffer, sizeof(BASE64_BLOB_RESPONSE_PAYLOAD) - 1);
+
+    FfsJsonValue_t rootValue;
+    FFS_CHECK_RESULT(ffsInitializeJsonObject(&payloadStream, &rootValue));
+
+    FfsJsonField_t nonceField = ffsCreateJsonField("nonce", FFS_JSON_STRING);
+    FfsJsonField_t sessionIdField = ffsCreateJsonField("sessionId", FFS_JSON_STRING);
+    FfsJsonField_t canProceedField = ffsCreateJsonField("canProceed", FFS_JSON_BOOLEAN);
+    FfsJsonField_t certificateField = ffsCreateJsonField("certificate", FFS_JSON_STRING);
+    FfsJsonField_t signatureField = ffsCreateJsonField("signature", FFS_JSON_STRING);
+    FfsJsonField_t registrationTokenField = ffsCreateJsonField("registrationToken", FFS_JSON_STRING);
+    FfsJsonField_t *expectedFields[] = { &nonceField, &sessionIdField, &canProceedField,
+            &certificateField, &signatureField, &registrationTokenField, NULL };
+    FFS_CHECK_RESULT(ffsParseJsonObject(&rootValue, expectedFields));
+
+    const char *nonce;
+    const char *sessionId;
+    bool canProceed;
+    FfsStream_t certificateStream;
+    FfsStream_t signatureStream;
+    FfsStream_t registrationTokenStream;
+    FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8String(&nonceField.value, &nonce));
+    FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8String(&sessionIdField.value, &sessionId));
+    FFS_CHECK_RESULT(ffsParseJsonBoolean(&canProceedField.value, &canProceed));
+    FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8(&certificateField.value, &certificateStream));
+    FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8(&signatureField.value, &signatureStream));
+    FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8(&registrationTokenField.value, &registrationTokenStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Decode an escaped JSON string.
+ */
+static FFS_RESULT ffsBenchmarkParseJsonQuotedString(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    (void) userContext;
+
+    // The string is decoded in place.
+    memcpy(buffer, ESCAPED_JSON_STRING, sizeof(ESCAPED_JSON_STRING) - 1);
+    FfsJsonValue_t stringValue = {
+        .type = FFS_JSON_STRING,
+        .valueStream = ffsCreateInputStream(buffer, sizeof(ESCAPED_JSON_STRING) - 1)
+    };
+    FfsStream_t destinationStream;
+    FFS_CHECK_RESULT(ffsParseJsonQuotedString(&stringValue, &destinationStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Encode an object with every field type.
+ */
+static FFS_RESULT ffsBenchmarkEncodeJsonObject(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsStream_t outputStream = ffsCreateOutputStream(buffer, FFS_BENCHMARK_BUFFER_SIZE);
+    FfsStream_t ssidStream = FFS_STRING_INPUT_STREAM("Home Network 5G");
+
+    FFS_CHECK_RESULT(ffsEncodeJsonObjectStart(&outputStream));
+    FFS_CHECK_RESULT(ffsEncodeJsonStringField("nonce", BENCHMARK_NONCE, &outputStream));
+    FFS_CHECK_RESULT(ffsEncodeJsonSeparator(&outputStream));
+    FFS_CHECK_RESULT(ffsEncodeJsonStringField("sessionId", BENCHMARK_SESSION_ID, &outputStream));
+    FFS_CHECK_RESULT(ffsEncodeJsonSeparator(&outputStream));
+    FFS_CHECK_RESULT(ffsEncodeJsonQuotedStreamField("ssid", &ssidStream, &outputStream));
+    FFS_CHECK_RESULT(ffsEncodeJsonSeparator(&outputStream));
+    FFS_CHECK_RESULT(ffsEncodeJsonInt32Field("rssi", -67, &outputStream));
+    FFS_CHECK_RESULT(ffsEncodeJsonSeparator(&outputStream));
+    FFS_CHECK_RESULT(ffsEncodeJsonUint32Field("sequenceNumber", 12, &outputStream));
+    FFS_CHECK_RESULT(ffsEncodeJsonSeparator(&outputStream));
+    FFS_CHECK_RESULT(ffsEncodeJsonBooleanField("canProceed", true, &outputStream));
+    FFS_CHECK_RESULT(ffsEncodeJsonObjectEnd(&outputStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Encode a string that needs escaping.
+ */
+static FFS_RESULT ffsBenchmarkEncodeJsonString(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsStream_t sourceStream = FFS_STRING_INPUT_STREAM(UNESCAPED_STRING);
+    FfsStream_t outputStream = ffsCreateOutputStream(buffer, FFS_BENCHMARK_BUFFER_SIZE);
+    FFS_CHECK_RESULT(ffsEncodeJsonString(&sourceStream, &outputStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Encode a long base64 string (nothing to escape).
+ */
+static FFS_RESULT ffsBenchmarkEncodeJsonBase64String(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsStream_t sourceStream = FFS_STRING_INPUT_STREAM(BENCHMARK_BASE64_BLOB);
+    FfsStream_t outputStream = ffsCreateOutputStream(buffer, FFS_BENCHMARK_BUFFER_SIZE);
+    FFS_CHECK_RESULT(ffsEncodeJsonString(&sourceStream, &outputStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Write, read and append a stream in small chunks.
+ */
+static FFS_RESULT ffsBenchmarkStreamWriteReadAppend(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    (void) userContext;
+
+    static const uint8_t CHUNK[STREAM_CHUNK_SIZE] = {
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+    };
+
+    FfsStream_t stream = ffsCreateOutputStream(buffer, STREAM_DATA_SIZE);
+    for (size_t i = 0; i < STREAM_DATA_SIZE / STREAM_CHUNK_SIZE; i++) {
+        FFS_CHECK_RESULT(ffsWriteStream(CHUNK, sizeof(CHUNK), &stream));
+    }
+
+    for (size_t i = 0; i < STREAM_DATA_SIZE / STREAM_CHUNK_SIZE; i++) {
+        uint8_t *data;
+        FFS_CHECK_RESULT(ffsReadStream(&stream, STREAM_CHUNK_SIZE, &data));
+    }
+
+    FFS_CHECK_RESULT(ffsRewindStream(&stream));
+    FfsStream_t destinationStream = ffsCreateOutputStream(buffer + STREAM_DATA_SIZE, STREAM_DATA_SIZE);
+    FFS_CHECK_RESULT(ffsAppendStream(&stream, &destinationStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Compare a stream with a string.
+ */
+static FFS_RESULT ffsBenchmarkStreamMatchesString(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    (void) userContext;
+    (void) buffer;
+
+    FfsStream_t stream = FFS_STRING_INPUT_STREAM(BENCHMARK_SESSION_ID);
+    if (!ffsStreamMatchesString(&stream, BENCHMARK_SESSION_ID)) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Base64-encode a binary buffer.
+ */
+static FFS_RESULT ffsBenchmarkEncodeBase64(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    (void) userContext;
+
+    FFS_CHECK_RESULT(ffsInitializeCodecData());
+
+    FfsStream_t plaintextStream = ffsCreateInputStream(codecPlaintext, sizeof(codecPlaintext));
+    FfsStream_t base64Stream = ffsCreateOutputStream(buffer, FFS_BENCHMARK_BUFFER_SIZE);
+    FFS_CHECK_RESULT(ffsEncodeBase64(&plaintextStream, 0, NULL, &base64Stream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Base64-decode a binary buffer.
+ */
+static FFS_RESULT ffsBenchmarkDecodeBase64(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    (void) userContext;
+
+    FFS_CHECK_RESULT(ffsInitializeCodecData());
+
+    FfsStream_t base64Stream = ffsCreateInputStream(codecBase64, sizeof(codecBase64));
+    FfsStream_t plaintextStream = ffsCreateOutputStream(buffer, FFS_BENCHMARK_BUFFER_SIZE);
+    FFS_CHECK_RESULT(ffsDecodeBase64(&base64Stream, &plaintextStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Base85-encode a binary buffer.
+ */
+static FFS_RESULT ffsBenchmarkEncodeBase85(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    (void) userContext;
+
+    FFS_CHECK_RESULT(ffsInitializeCodecData());
+
+    FfsStream_t plaintextStream = ffsCreateInputStream(codecPlaintext, sizeof(codecPlaintext));
+    FfsStream_t base85Stream = ffsCreateOutputStream(buffer, FFS_BENCHMARK_BUFFER_SIZE);
+    FFS_CHECK_RESULT(ffsEncodeBase85(&plaintextStream, &base85Stream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Parse a hex string.
+ */
+static FFS_RESULT ffsBenchmarkParseHex(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    (void) userContext;
+
+    FFS_CHECK_RESULT(ffsInitializeCodecData());
+
+    FfsStream_t hexStream = ffsCreateInputStream(codecHex, sizeof(codecHex));
+    FfsStream_t destinationStream = ffsCreateOutputStream(buffer, FFS_BENCHMARK_BUFFER_SIZE);
+    FFS_CHECK_RESULT(ffsParseHexStream(&hexStream, &destinationStream));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Common benchmarks.
+ */
+const FfsBenchmark_t FFS_COMMON_BENCHMARKS[] = {
+    { "json/parse_object", ffsBenchmarkParseJsonObject,
+            sizeof(POST_WIFI_SCAN_DATA_RESPONSE_PAYLOAD) - 1, false },
+    { "json/parse_array", ffsBenchmarkParseJsonArray,
+            sizeof(GET_WIFI_CREDENTIALS_RESPONSE_PAYLOAD) - 1, false },
+    { "json/parse_base64_payload", ffsBenchmarkParseJsonBase64Payload,
+            sizeof(BASE64_BLOB_RESPONSE_PAYLOAD) - 1, false },
+    { "json/parse_quoted_string", ffsBenchmarkParseJsonQuotedString,
+            sizeof(ESCAPED_JSON_STRING) - 1, false },
+    { "json/encode_object", ffsBenchmarkEncodeJsonObject, 0, false },
+    { "json/encode_string", ffsBenchmarkEncodeJsonString, sizeof(UNESCAPED_STRING) - 1, false },
+    { "json/encode_base64_string", ffsBenchmarkEncodeJsonBase64String,
+            sizeof(BENCHMARK_BASE64_BLOB) - 1, false },
+    { "stream/write_read_append", ffsBenchmarkStreamWriteReadAppend, STREAM_DATA_SIZE, false },
+    { "stream/matches_string", ffsBenchmarkStreamMatchesString, sizeof(BENCHMARK_SESSION_ID) - 1, false },
+    { "base64/encode", ffsBenchmarkEncodeBase64, CODEC_PLAINTEXT_SIZE, false },
+    { "base64/decode", ffsBenchmarkDecodeBase64, CODEC_BASE64_SIZE, false },
+    { "base85/encode", ffsBenchmarkEncodeBase85, CODEC_PLAINTEXT_SIZE, false },
+    { "hex/parse", ffsBenchmarkParseHex, CODEC_HEX_SIZE, false },
+    { NULL, NULL, 0, false }
+};
@@ -0,0 +1,541 @@
+/** @file ffs_dss_benchmarks.c
+ *
+ * @brief DSS model serializer and deserializer microbenchmarks.
+ *
+ * Model functions that are not implemented on the device side (request
+ * deserializers and response serializers) are not benchmarked.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_check_result.h"
+#include "ffs/dss/model/ffs_dss_compute_configuration_data_request.h"
+#include "ffs/dss/model/ffs_dss_compute_configuration_data_response.h"
+#include "ffs/dss/model/ffs_dss_device_details.h"
+#include "ffs/dss/model/ffs_dss_error_details.h"
+#include "ffs/dss/model/ffs_dss_get_wifi_credentials_request.h"
+#include "ffs/dss/model/ffs_dss_get_wifi_credentials_response.h"
+#include "ffs/dss/model/ffs_dss_post_wifi_scan_data_request.h"
+#include "ffs/dss/model/ffs_dss_post_wifi_scan_data_response.h"
+#include "ffs/dss/model/ffs_dss_registration_details.h"
+#include "ffs/dss/model/ffs_dss_report_request.h"
+#include "ffs/dss/model/ffs_dss_report_response.h"
+#include "ffs/dss/model/ffs_dss_start_pin_based_setup_request.h"
+#include "ffs/dss/model/ffs_dss_start_pin_based_setup_response.h"
+#include "ffs/dss/model/ffs_dss_start_provisioning_session_request.h"
+#include "ffs/dss/model/ffs_dss_start_provisioning_session_response.h"
+#include "ffs/dss/model/ffs_dss_wifi_connection_attempt.h"
+#include "ffs/dss/model/ffs_dss_wifi_connection_details.h"
+#include "ffs/dss/model/ffs_dss_wifi_credentials.h"
+#include "ffs/dss/model/ffs_dss_wifi_scan_result.h"
+#include "ffs_benchmark.h"
+#include "ffs_benchmark_payloads.h"
+
+#include <string.h>
+
+/** @brief Number of scan results in a serialized "post Wi-Fi scan data" page.
+ */
+#define SCAN_RESULTS_PER_PAGE           (8)
+
+/** @brief Number of connection attempts in a serialized "report" request.
+ */
+#define CONNECTION_ATTEMPTS_PER_REPORT  (3)
+
+/** @brief Device details sent with every request.
+ */
+static const FfsDssDeviceDetails_t DEVICE_DETAILS = {
+    .manufacturer = "Microchip Technology",
+    .deviceName = "PIC32MZW1 Curiosity",
+    .deviceModel = "EV12F11A",
+    .deviceSerial = "G030JU0660540206",
+    .productIndex = "Q9pp",
+    .softwareVersionIndex = "00",
+    .firmwareVersion = "1.0.3",
+    .hardwareVersion = "2.0.0"
+};
+
+/** @brief Initialize an input stream over a payload copied into the scratch buffer.
+ *
+ * The deserializers convert strings in place, so every operation parses a fresh copy.
+ */
+static FfsStream_t ffsCopyPayload(const char *payload, size_t payloadSize, uint8_t *buffer)
+{
+    memcpy(buffer, payload, payloadSize);
+    return ffsCreateInputStream(buffer, payloadSize);
+}
+
+/** @brief Initialize a scan result for a page entry.
+ */
+static void ffsInitializeBenchmarkScanResult(size_t index, uint8_t *bssid, FfsDssWifiScanResult_t *scanResult)
+{
+    static const char *SSIDS[SCAN_RESULTS_PER_PAGE] = {
+        "Home Network", "Home Network 5G", "NETGEAR42", "xfinitywifi",
+        "DIRECT-7B-HP OfficeJet", "Guest", "linksys", "TP-Link_2C4E"
+    };
+
+    memset(bssid, (int) (index * 0x11), 6);
+    bssid[5] = (uint8_t) index;
+
+    scanResult->ssidStream = ffsCreateInputStream((uint8_t *) SSIDS[index], strlen(SSIDS[index]));
+    scanResult->bssidStream = ffsCreateInputStream(bssid, 6);
+    scanResult->securityProtocol = (index % 3 == 2) ? FFS_DSS_WIFI_SECURITY_PROTOCOL_OPEN
+            : FFS_DSS_WIFI_SECURITY_PROTOCOL_WPA_PSK;
+    scanResult->frequencyBand = (index % 2) ? 5180 : 2437;
+    scanResult->signalStrength = -40 - (int32_t) index * 5;
+}
+
+/** @brief Initialize a failed connection attempt.
+ */
+static void ffsInitializeBenchmarkConnectionAttempt(FfsDssWifiConnectionAttempt_t *connectionAttempt)
+{
+    connectionAttempt->ssidStream = FFS_STRING_INPUT_STREAM("Home Network 5G");
+    connectionAttempt->securityProtocol = FFS_DSS_WIFI_SECURITY_PROTOCOL_WPA_PSK;
+    connectionAttempt->state = FFS_DSS_WIFI_CONNECTION_STATE_FAILED;
+    connectionAttempt->hasErrorDetails = true;
+    connectionAttempt->errorDetails.operation = "CONNECT";
+    connectionAttempt->errorDetails.cause = "AUTHENTICATION_FAILED";
+    connectionAttempt->errorDetails.details = "4-way handshake timed out";
+    connectionAttempt->errorDetails.code = "3:15";
+}
+
+/** @brief Serialize a "start provisioning session" request.
+ */
+static FFS_RESULT ffsBenchmarkSerializeStartProvisioningSessionRequest(struct FfsUserContext_s *userContext,
+        uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsDssStartProvisioningSessionRequest_t request = {
+        .nonce = BENCHMARK_NONCE
+    };
+    FfsStream_t outputStream = ffsCreateOutputStream(buffer, FFS_BENCHMARK_BUFFER_SIZE);
+    FFS_CHECK_RESULT(ffsDssSerializeStartProvisioningSessionRequest(&request, &outputStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Serialize a "start PIN-based setup" request.
+ */
+static FFS_RESULT ffsBenchmarkSerializeStartPinBasedSetupRequest(struct FfsUserContext_s *userContext,
+        uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsDssStartPinBasedSetupRequest_t request = {
+        .nonce = BENCHMARK_NONCE,
+        .sessionId = BENCHMARK_SESSION_ID,
+        .deviceDetails = DEVICE_DETAILS
+    };
+    FfsStream_t outputStream = ffsCreateOutputStream(buffer, FFS_BENCHMARK_BUFFER_SIZE);
+    FFS_CHECK_RESULT(ffsDssSerializeStartPinBasedSetupRequest(&request, &outputStream));
+    FFS_CHECK_RESULT(ffsDssAddHashedPinToStartPinBasedSetupRequest(BENCHMARK_HASHED_PIN, &outputStream));
+    FFS_CHECK_RESULT(ffsDssFinishSerializingStartPinBasedSetupRequest(&outputStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Serialize a "compute configuration data" request.
+ */
+static FFS_RESULT ffsBenchmarkSerializeComputeConfigurationDataRequest(struct FfsUserContext_s *userContext,
+        uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsDssComputeConfigurationDataRequest_t request = {
+        .nonce = BENCHMARK_NONCE,
+        .sessionId = BENCHMARK_SESSION_ID,
+        .deviceDetails = DEVICE_DETAILS
+    };
+    FfsStream_t outputStream = ffsCreateOutputStream(buffer, FFS_BENCHMARK_BUFFER_SIZE);
+    FFS_CHECK_RESULT(ffsDssSerializeComputeConfigurationDataRequest(&request, &outputStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Serialize the device details.
+ */
+static FFS_RESULT ffsBenchmarkSerializeDeviceDetails(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsDssDeviceDetails_t deviceDetails = DEVICE_DETAILS;
+    bool isEmpty;
+    FfsStream_t outputStream = ffsCreateOutputStream(buffer, FFS_BENCHMARK_BUFFER_SIZE);
+    FFS_CHECK_RESULT(ffsDssSerializeDeviceDetails(&deviceDetails, &isEmpty, &outputStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Serialize error details.
+ */
+static FFS_RESULT ffsBenchmarkSerializeErrorDetails(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    (void) userContext;
+
+    const FfsDssErrorDetails_t errorDetails = {
+        .operation = "CONNECT",
+        .cause = "AUTHENTICATION_FAILED",
+        .details = "4-way handshake timed out",
+        .code = "3:15"
+    };
+    bool isEmpty;
+    FfsStream_t outputStream = ffsCreateOutputStream(buffer, FFS_BENCHMARK_BUFFER_SIZE);
+    FFS_CHECK_RESULT(ffsDssSerializeErrorDetails(&errorDetails, &isEmpty, &outputStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Serialize a single Wi-Fi scan result.
+ */
+static FFS_RESULT ffsBenchmarkSerializeWifiScanResult(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    (void) userContext;
+
+    uint8_t bssid[6];
+    FfsDssWifiScanResult_t scanResult;
+    ffsInitializeBenchmarkScanResult(1, bssid, &scanResult);
+
+    FfsStream_t outputStream = ffsCreateOutputStream(buffer, FFS_BENCHMARK_BUFFER_SIZE);
+    FFS_CHECK_RESULT(ffsDssSerializeWifiScanResult(&scanResult, &outputStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Serialize a full "post Wi-Fi scan data" page.
+ */
+static FFS_RESULT ffsBenchmarkSerializePostWifiScanDataRequest(struct FfsUserContext_s *userContext,
+        uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsDssPostWifiScanDataRequest_t request = {
+        .nonce = BENCHMARK_NONCE,
+        .sessionId = BENCHMARK_SESSION_ID,
+        .deviceDetails = DEVICE_DETAILS,
+        .sequenceNumber = 1
+    };
+    FfsStream_t outputStream = ffsCreateOutputStream(buffer, FFS_BENCHMARK_BUFFER_SIZE);
+    FFS_CHECK_RESULT(ffsDssStartSerializingPostWifiScanDataRequest(&request, &outputStream));
+
+    for (size_t i = 0; i < SCAN_RESULTS_PER_PAGE; i++) {
+        uint8_t bssid[6];
+        FfsDssWifiScanResult_t scanResult;
+        ffsInitializeBenchmarkScanResult(i, bssid, &scanResult);
+
+        FFS_CHECK_RESULT(ffsDssAddScanResultToSerializedPostWifiScanDataRequest(&scanResult, &outputStream));
+    }
+
+    FFS_CHECK_RESULT(ffsDssFinishSerializingPostWifiScanDataRequest(&outputStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Serialize a "get Wi-Fi credentials" request.
+ */
+static FFS_RESULT ffsBenchmarkSerializeGetWifiCredentialsRequest(struct FfsUserContext_s *userContext,
+        uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsDssGetWifiCredentialsRequest_t request = {
+        .nonce = BENCHMARK_NONCE,
+        .sessionId = BENCHMARK_SESSION_ID,
+        .deviceDetails = DEVICE_DETAILS,
+        .sequenceNumber = 1
+    };
+    FfsStream_t outputStream = ffsCreateOutputStream(buffer, FFS_BENCHMARK_BUFFER_SIZE);
+    FFS_CHECK_RESULT(ffsDssSerializeGetWifiCredentialsRequest(&request, &outputStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Serialize a Wi-Fi connection attempt.
+ */
+static FFS_RESULT ffsBenchmarkSerializeWifiConnectionAttempt(struct FfsUserContext_s *userContext,
+        uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsDssWifiConnectionAttempt_t connectionAttempt;
+    ffsInitializeBenchmarkConnectionAttempt(&connectionAttempt);
+
+    FfsStream_t outputStream = ffsCreateOutputStream(buffer, FFS_BENCHMARK_BUFFER_SIZE);
+    FFS_CHECK_RESULT(ffsDssSerializeWifiConnectionAttempt(&connectionAttempt, &outputStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Serialize Wi-Fi connection details.
+ */
+static FFS_RESULT ffsBenchmarkSerializeWifiConnectionDetails(struct FfsUserContext_s *userContext,
+        uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsDssWifiConnectionDetails_t connectionDetails;
+    ffsInitializeBenchmarkConnectionAttempt(&connectionDetails);
+
+    FfsStream_t outputStream = ffsCreateOutputStream(buffer, FFS_BENCHMARK_BUFFER_SIZE);
+    FFS_CHECK_RESULT(ffsDssSerializeWifiConnectionDetails(&connectionDetails, &outputStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Serialize a "report" request with a few connection attempts.
+ */
+static FFS_RESULT ffsBenchmarkSerializeReportRequest(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsDssReportRequest_t request = {
+        .nonce = BENCHMARK_NONCE,
+        .sessionId = BENCHMARK_SESSION_ID,
+        .sequenceNumber = 7,
+        .provisioneeState = FFS_DSS_WIFI_PROVISIONEE_STATE_CONNECTING_TO_USER_NETWORK,
+        .registrationState = FFS_DSS_REGISTRATION_STATE_IN_PROGRESS,
+        .stateTransitionResult = FFS_DSS_REPORT_RESULT_FAILURE,
+        .deviceDetails = DEVICE_DETAILS
+    };
+    FfsStream_t outputStream = ffsCreateOutputStream(buffer, FFS_BENCHMARK_BUFFER_SIZE);
+    FFS_CHECK_RESULT(ffsDssStartSerializingReportRequest(&request, &outputStream));
+
+    for (size_t i = 0; i < CONNECTION_ATTEMPTS_PER_REPORT; i++) {
+        FfsDssWifiConnectionAttempt_t connectionAttempt;
+        ffsInitializeBenchmarkConnectionAttempt(&connectionAttempt);
+
+        FFS_CHECK_RESULT(ffsDssAddConnectionAttemptToSerializedReportRequest(&connectionAttempt,
+                &outputStream));
+    }
+
+    FFS_CHECK_RESULT(ffsDssFinishSerializingReportRequest(&outputStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Deserialize a "start provisioning session" response.
+ */
+static FFS_RESULT ffsBenchmarkDeserializeStartProvisioningSessionResponse(struct FfsUserContext_s *userContext,
+        uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsStream_t payloadStream = ffsCopyPayload(START_PROVISIONING_SESSION_RESPONSE_PAYLOAD,
+            sizeof(START_PROVISIONING_SESSION_RESPONSE_PAYLOAD) - 1, buffer);
+    FfsJsonValue_t rootValue;
+    FFS_CHECK_RESULT(ffsInitializeJsonObject(&payloadStream, &rootValue));
+
+    FfsDssStartProvisioningSessionResponse_t response;
+    FFS_CHECK_RESULT(ffsDssDeserializeStartProvisioningSessionResponse(&rootValue, &response));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Deserialize a "start PIN-based setup" response.
+ */
+static FFS_RESULT ffsBenchmarkDeserializeStartPinBasedSetupResponse(struct FfsUserContext_s *userContext,
+        uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsStream_t payloadStream = ffsCopyPayload(START_PIN_BASED_SETUP_RESPONSE_PAYLOAD,
+            sizeof(START_PIN_BASED_SETUP_RESPONSE_PAYLOAD) - 1, buffer);
+    FfsJsonValue_t rootValue;
+    FFS_CHECK_RESULT(ffsInitializeJsonObject(&payloadStream, &rootValue));
+
+    FfsDssStartPinBasedSetupResponse_t response;
+    FFS_CHECK_RESULT(ffsDssDeserializeStartPinBasedSetupResponse(&rootValue, &response));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Deserialize a "compute configuration data" response.
+ */
+static FFS_RESULT ffsBenchmarkDeserializeComputeConfigurationDataResponse(struct FfsUserContext_s *userContext,
+        uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsStream_t payloadStream = ffsCopyPayload(COMPUTE_CONFIGURATION_DATA_RESPONSE_PAYLOAD,
+            sizeof(COMPUTE_CONFIGURATION_DATA_RESPONSE_PAYLOAD) - 1, buffer);
+    FfsJsonValue_t rootValue;
+    FFS_CHECK_RESULT(ffsInitializeJsonObject(&payloadStream, &rootValue));
+
+    FfsDssComputeConfigurationDataResponse_t response;
+    FfsJsonValue_t configurationValue;
+    FFS_CHECK_RESULT(ffsDssDeserializeComputeConfigurationDataResponse(&rootValue, &response,
+            &configurationValue));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Deserialize registration details.
+ */
+static FFS_RESULT ffsBenchmarkDeserializeRegistrationDetails(struct FfsUserContext_s *userContext,
+        uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsStream_t payloadStream = ffsCopyPayload(REGISTRATION_DETAILS_PAYLOAD,
+            sizeof(REGISTRATION_DETAILS_PAYLOAD) - 1, buffer);
+    FfsJsonValue_t rootValue;
+    FFS_CHECK_RESULT(ffsInitializeJsonObject(&payloadStream, &rootValue));
+
+    FfsDssRegistrationDetails_t registrationDetails;
+    FFS_CHECK_RESULT(ffsDssDeserializeRegistrationDetails(&rootValue, &registrationDetails));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Deserialize a "post Wi-Fi scan data" response.
+ */
+static FFS_RESULT ffsBenchmarkDeserializePostWifiScanDataResponse(struct FfsUserContext_s *userContext,
+        uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsStream_t payloadStream = ffsCopyPayload(POST_WIFI_SCAN_DATA_RESPONSE_PAYLOAD,
+            sizeof(POST_WIFI_SCAN_DATA_RESPONSE_PAYLOAD) - 1, buffer);
+    FfsJsonValue_t rootValue;
+    FFS_CHECK_RESULT(ffsInitializeJsonObject(&payloadStream, &rootValue));
+
+    FfsDssPostWifiScanDataResponse_t response;
+    FFS_CHECK_RESULT(ffsDssDeserializePostWifiScanDataResponse(&rootValue, &response));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Deserialize a single Wi-Fi credentials object.
+ */
+static FFS_RESULT ffsBenchmarkDeserializeWifiCredentials(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsStream_t payloadStream = ffsCopyPayload(WIFI_CREDENTIALS_PAYLOAD,
+            sizeof(WIFI_CREDENTIALS_PAYLOAD) - 1, buffer);
+    FfsJsonValue_t rootValue;
+    FFS_CHECK_RESULT(ffsInitializeJsonObject(&payloadStream, &rootValue));
+
+    FfsDssWifiCredentials_t wifiCredentials;
+    FFS_CHECK_RESULT(ffsDssDeserializeWifiCredentials(&rootValue, &wifiCredentials));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Deserialize a "get Wi-Fi credentials" response and every credential in it.
+ */
+static FFS_RESULT ffsBenchmarkDeserializeGetWifiCredentialsResponse(struct FfsUserContext_s *userContext,
+        uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsStream_t payloadStream = ffsCopyPayload(GET_WIFI_CREDENTIALS_RESPONSE_PAYLOAD,
+            sizeof(GET_WIFI_CREDENTIALS_RESPONSE_PAYLOAD) - 1, buffer);
+    FfsJsonValue_t rootValue;
+    FFS_CHECK_RESULT(ffsInitializeJsonObject(&payloadStream, &rootValue));
+
+    FfsDssGetWifiCredentialsResponse_t response;
+    FfsJsonValue_t wifiCredentialsListValue;
+    FFS_CHECK_RESULT(ffsDssDeserializeGetWifiCredentialsResponse(&rootValue, &response,
+            &wifiCredentialsListValue));
+
+    for (;;) {
+        FfsJsonValue_t wifiCredentialsValue;
+        bool isDone = false;
+        FFS_CHECK_RESULT(ffsParseJsonValue(&wifiCredentialsListValue, &wifiCredentialsValue, &isDone));
+        if (isDone) {
+            break;
+        }
+
+        FfsDssWifiCredentials_t wifiCredentials;
+        FFS_CHECK_RESULT(ffsDssDeserializeWifiCredentials(&wifiCredentialsValue, &wifiCredentials));
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Deserialize a "report" response.
+ */
+static FFS_RESULT ffsBenchmarkDeserializeReportResponse(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsStream_t payloadStream = ffsCopyPayload(REPORT_RESPONSE_PAYLOAD,
+            sizeof(REPORT_RESPONSE_PAYLOAD) - 1, buffer);
+    FfsJsonValue_t rootValue;
+    FFS_CHECK_RESULT(ffsInitializeJsonObject(&payloadStream, &rootValue));
+
+    FfsDssReportResponse_t response;
+    FFS_CHECK_RESULT(ffsDssDeserializeReportResponse(&rootValue, &response));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Deserialize error details.
+ */
+static FFS_RESULT ffsBenchmarkDeserializeErrorDetails(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    (void) userContext;
+
+    FfsStream_t payloadStream = ffsCopyPayload(ERROR_DETAILS_PAYLOAD,
+            sizeof(ERROR_DETAILS_PAYLOAD) - 1, buffer);
+    FfsJsonValue_t rootValue;
+    FFS_CHECK_RESULT(ffsInitializeJsonObject(&payloadStream, &rootValue));
+
+    FfsDssErrorDetails_t errorDetails;
+    FFS_CHECK_RESULT(ffsDssDeserializeErrorDetails(&rootValue, &errorDetails));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * DSS benchmarks.
+ */
+const FfsBenchmark_t FFS_DSS_BENCHMARKS[] = {
+    { "dss/serialize_start_provisioning_session_request",
+            ffsBenchmarkSerializeStartProvisioningSessionRequest, 0, false },
+    { "dss/serialize_start_pin_based_setup_request",
+            ffsBenchmarkSerializeStartPinBasedSetupRequest, 0, false },
+    { "dss/serialize_compute_configuration_data_request",
+            ffsBenchmarkSerializeComputeConfigurationDataRequest, 0, false },
+    { "dss/serialize_device_details", ffsBenchmarkSerializeDeviceDetails, 0, false },
+    { "dss/serialize_error_details", ffsBenchmarkSerializeErrorDetails, 0, false },
+    { "dss/serialize_wifi_scan_result", ffsBenchmarkSerializeWifiScanResult, 0, false },
+    { "dss/serialize_post_wifi_scan_data_request",
+            ffsBenchmarkSerializePostWifiScanDataRequest, 0, false },
+    { "dss/serialize_get_wifi_credentials_request",
+            ffsBenchmarkSerializeGetWifiCredentialsRequest, 0, false },
+    { "dss/serialize_wifi_connection_attempt", ffsBenchmarkSerializeWifiConnectionAttempt, 0, false },
+    { "dss/serialize_wifi_connection_details", ffsBenchmarkSerializeWifiConnectionDetails, 0, false },
+    { "dss/serialize_report_request", ffsBenchmarkSerializeReportRequest, 0, false },
+    { "dss/deserialize_start_provisioning_session_response",
+            ffsBenchmarkDeserializeStartProvisioningSessionResponse,
+            sizeof(START_PROVISIONING_SESSION_RESPONSE_PAYLOAD) - 1, false },
+    { "dss/deserialize_start_pin_based_setup_response",
+            ffsBenchmarkDeserializeStartPinBasedSetupResponse,
+            sizeof(START_PIN_BASED_SETUP_RESPONSE_PAYLOAD) - 1, false },
+    { "dss/deserialize_compute_configuration_data_response",
+            ffsBenchmarkDeserializeComputeConfigurationDataResponse,
+            sizeof(COMPUTE_CONFIGURATION_DATA_RESPONSE_PAYLOAD) - 1, false },
+    { "dss/deserialize_registration_details", ffsBenchmarkDeserializeRegistrationDetails,
+            sizeof(REGISTRATION_DETAILS_PAYLOAD) - 1, false },
+    { "dss/deserialize_post_wifi_scan_data_response", ffsBenchmarkDeserializePostWifiScanDataResponse,
+            sizeof(POST_WIFI_SCAN_DATA_RESPONSE_PAYLOAD) - 1, false },
+    { "dss/deserialize_wifi_credentials", ffsBenchmarkDeserializeWifiCredentials,
+            sizeof(WIFI_CREDENTIALS_PAYLOAD) - 1, false },
+    { "dss/deserialize_get_wifi_credentials_response", ffsBenchmarkDeserializeGetWifiCredentialsResponse,
+            sizeof(GET_WIFI_CREDENTIALS_RESPONSE_PAYLOAD) - 1, false },
+    { "dss/deserialize_report_response", ffsBenchmarkDeserializeReportResponse,
+            sizeof(REPORT_RESPONSE_PAYLOAD) - 1, false },
+    { "dss/deserialize_error_details", ffsBenchmarkDeserializeErrorDetails,
+            sizeof(ERROR_DETAILS_PAYLOAD) - 1, false },
+    { NULL, NULL, 0, false }
+};
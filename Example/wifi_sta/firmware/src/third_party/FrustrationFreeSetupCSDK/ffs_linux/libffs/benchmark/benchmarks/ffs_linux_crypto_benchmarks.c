@@ -0,0 +1,151 @@
+/** @file ffs_linux_crypto_benchmarks.c
+ *
+ * @brief Linux crypto compatibility layer microbenchmarks.
+ *
+ * Every operation is timed twice: "uncached" empties the user context's
+ * crypto cache first, so it pays for the key parsing and context setup on
+ * every call as before the cache, and "cached" runs with the cache filled.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_check_result.h"
+#include "ffs/compat/ffs_common_compat.h"
+#include "ffs/compat/ffs_linux_user_context.h"
+#include "ffs/linux/ffs_linux_crypto_cache.h"
+#include "ffs/linux/ffs_linux_crypto_common.h"
+#include "ffs_benchmark.h"
+#include "ffs_benchmark_payloads.h"
+
+#include <string.h>
+
+#define SIGNATURE_BUFFER_SIZE           (128)
+#define SECRET_KEY_SIZE                 (32)
+
+/** @brief Payload signed and verified (a typical DSS response body).
+ */
+static const char SIGNED_PAYLOAD[] = GET_WIFI_CREDENTIALS_RESPONSE_PAYLOAD;
+
+/** @brief Signature of the payload, made on first use.
+ */
+static uint8_t payloadSignature[SIGNATURE_BUFFER_SIZE];
+static size_t payloadSignatureSize;
+
+/** @brief DER encoded ECDH peer key, encoded on first use.
+ */
+static uint8_t peerKeyDer[FFS_LINUX_CRYPTO_CACHE_MAXIMUM_DER_SIZE];
+static size_t peerKeyDerSize;
+
+/** @brief Sign the payload.
+ */
+static FFS_RESULT ffsBenchmarkSign(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    FfsStream_t payloadStream = ffsCreateInputStream((uint8_t *) SIGNED_PAYLOAD, sizeof(SIGNED_PAYLOAD) - 1);
+    FfsStream_t signatureStream = ffsCreateOutputStream(buffer, SIGNATURE_BUFFER_SIZE);
+    FFS_CHECK_RESULT(ffsSignPayload(userContext, &payloadStream, &signatureStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Verify the payload signature.
+ */
+static FFS_RESULT ffsBenchmarkVerify(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    // The benchmark user context verifies with the device's own public key.
+    if (!payloadSignatureSize) {
+        FfsStream_t payloadStream = ffsCreateInputStream((uint8_t *) SIGNED_PAYLOAD, sizeof(SIGNED_PAYLOAD) - 1);
+        FfsStream_t signatureStream = ffsCreateOutputStream(payloadSignature, sizeof(payloadSignature));
+        FFS_CHECK_RESULT(ffsSignPayload(userContext, &payloadStream, &signatureStream));
+        payloadSignatureSize = FFS_STREAM_DATA_SIZE(signatureStream);
+    }
+
+    FfsStream_t payloadStream = ffsCreateInputStream((uint8_t *) SIGNED_PAYLOAD, sizeof(SIGNED_PAYLOAD) - 1);
+    FfsStream_t signatureStream = ffsCreateInputStream(payloadSignature, payloadSignatureSize);
+    bool isVerified;
+    FFS_CHECK_RESULT(ffsVerifyCloudSignature(userContext, &payloadStream, &signatureStream, &isVerified));
+    if (!isVerified) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    (void) buffer;
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Compute the ECDH secret key with the cloud public key.
+ */
+static FFS_RESULT ffsBenchmarkEcdh(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    if (!peerKeyDerSize) {
+        FfsStream_t derStream = ffsCreateOutputStream(peerKeyDer, sizeof(peerKeyDer));
+        FFS_CHECK_RESULT(ffsGetDerEncodedPublicKeyFromEVPKey(userContext->cloudPublicKey, &derStream));
+        peerKeyDerSize = FFS_STREAM_DATA_SIZE(derStream);
+    }
+
+    FfsStream_t peerKeyStream = ffsCreateInputStream(peerKeyDer, peerKeyDerSize);
+    FfsStream_t secretKeyStream = ffsCreateOutputStream(buffer, SECRET_KEY_SIZE);
+    FFS_CHECK_RESULT(ffsComputeECDHKey(userContext, &peerKeyStream, &secretKeyStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Get the DER encoded device public key from the configuration map.
+ */
+static FFS_RESULT ffsBenchmarkGetDevicePublicKey(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    FfsMapValue_t configurationValue = {
+        .bytesStream = ffsCreateOutputStream(buffer, FFS_BENCHMARK_BUFFER_SIZE)
+    };
+    FFS_CHECK_RESULT(ffsGetConfigurationValue(userContext, FFS_CONFIGURATION_ENTRY_KEY_DEVICE_EC_PUBLIC_KEY_DER,
+            &configurationValue));
+
+    return FFS_SUCCESS;
+}
+
+static FFS_RESULT ffsBenchmarkSignUncached(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    ffsInvalidateLinuxCryptoCache(&userContext->cryptoCache);
+    return ffsBenchmarkSign(userContext, buffer);
+}
+
+static FFS_RESULT ffsBenchmarkVerifyUncached(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    ffsInvalidateLinuxCryptoCache(&userContext->cryptoCache);
+    return ffsBenchmarkVerify(userContext, buffer);
+}
+
+static FFS_RESULT ffsBenchmarkEcdhUncached(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    ffsInvalidateLinuxCryptoCache(&userContext->cryptoCache);
+    return ffsBenchmarkEcdh(userContext, buffer);
+}
+
+static FFS_RESULT ffsBenchmarkGetDevicePublicKeyUncached(struct FfsUserContext_s *userContext, uint8_t *buffer)
+{
+    ffsInvalidateLinuxCryptoCache(&userContext->cryptoCache);
+    return ffsBenchmarkGetDevicePublicKey(userContext, buffer);
+}
+
+/*
+ * Linux crypto benchmarks.
+ */
+const FfsBenchmark_t FFS_LINUX_CRYPTO_BENCHMARKS[] = {
+    { "linux_crypto/sign_uncached", ffsBenchmarkSignUncached, sizeof(SIGNED_PAYLOAD) - 1, true },
+    { "linux_crypto/sign_cached", ffsBenchmarkSign, sizeof(SIGNED_PAYLOAD) - 1, true },
+    { "linux_crypto/verify_uncached", ffsBenchmarkVerifyUncached, sizeof(SIGNED_PAYLOAD) - 1, true },
+    { "linux_crypto/verify_cached", ffsBenchmarkVerify, sizeof(SIGNED_PAYLOAD) - 1, true },
+    { "linux_crypto/ecdh_uncached", ffsBenchmarkEcdhUncached, 0, true },
+    { "linux_crypto/ecdh_cached", ffsBenchmarkEcdh, 0, true },
+    { "linux_crypto/get_device_public_key_der_uncached", ffsBenchmarkGetDevicePublicKeyUncached, 0, true },
+    { "linux_crypto/get_device_public_key_der_cached", ffsBenchmarkGetDevicePublicKey, 0, true },
+    { NULL, NULL, 0, false }
+};
@@ -0,0 +1,46 @@
+/** @file ffs_wifi_provisionee_benchmarks.c
+ *
+ * @brief Wi-Fi provisionee microbenchmarks.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_check_result.h"
+#include "ffs/common/ffs_wifi.h"
+#include "ffs/wifi_provisionee/ffs_wifi_provisionee_encoded_setup_network.h"
+#include "ffs_benchmark.h"
+
+#define ENCODED_SSID_BUFFER_SIZE        (FFS_MAXIMUM_SSID_SIZE)
+#define ENCODED_PASSPHRASE_BUFFER_SIZE  (64)
+
+/** @brief Compute the Amazon custom encoded setup network (SHA-256, ECDH, HMAC and codecs).
+ */
+static FFS_RESULT ffsBenchmarkComputeEncodedSetupNetwork(struct FfsUserContext_s *userContext,
+        uint8_t *buffer)
+{
+    FfsWifiConfiguration_t setupNetworkConfiguration = {
+        .ssidStream = ffsCreateOutputStream(buffer, ENCODED_SSID_BUFFER_SIZE),
+        .keyStream = ffsCreateOutputStream(buffer + ENCODED_SSID_BUFFER_SIZE, ENCODED_PASSPHRASE_BUFFER_SIZE)
+    };
+    FFS_CHECK_RESULT(ffsComputeAmazonCustomEncodedNetworkConfiguration(userContext,
+            &setupNetworkConfiguration));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Wi-Fi provisionee benchmarks.
+ */
+const FfsBenchmark_t FFS_WIFI_PROVISIONEE_BENCHMARKS[] = {
+    { "wifi_provisionee/compute_encoded_setup_network", ffsBenchmarkComputeEncodedSetupNetwork, 0, true },
+    { NULL, NULL, 0, false }
+};
@@ -0,0 +1,77 @@
+/** @file ffs_benchmark.h
+ *
+ * @brief Ffs microbenchmark definitions.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#ifndef FFS_BENCHMARK_H_
+#define FFS_BENCHMARK_H_
+
+#include "ffs/common/ffs_result.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct FfsUserContext_s;
+
+/** @brief Size of the shared output buffer handed to each benchmark.
+ */
+#define FFS_BENCHMARK_BUFFER_SIZE   (4096)
+
+/** @brief Benchmark operation.
+ *
+ * Run one operation. Each call must start from the same state so that
+ * repeated calls measure the same work.
+ *
+ * @param userContext User context (NULL unless the benchmark requires one)
+ * @param buffer Scratch buffer of \ref FFS_BENCHMARK_BUFFER_SIZE bytes
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+typedef FFS_RESULT (*FfsBenchmarkFunction_t)(struct FfsUserContext_s *userContext, uint8_t *buffer);
+
+/** @brief Benchmark definition.
+ */
+typedef struct {
+    const char *name; //!< Unique "group/name" benchmark name.
+    FfsBenchmarkFunction_t function; //!< Operation to time.
+    size_t bytesPerOperation; //!< Payload size processed per operation (0 if not applicable).
+    bool requiresUserContext; //!< Does the operation need an initialized Linux user context?
+} FfsBenchmark_t;
+
+/** @brief Common (JSON, stream and codec) benchmarks, terminated by a NULL name.
+ */
+extern const FfsBenchmark_t FFS_COMMON_BENCHMARKS[];
+
+/** @brief DSS model serializer and deserializer benchmarks, terminated by a NULL name.
+ */
+extern const FfsBenchmark_t FFS_DSS_BENCHMARKS[];
+
+/** @brief Wi-Fi provisionee benchmarks, terminated by a NULL name.
+ */
+extern const FfsBenchmark_t FFS_WIFI_PROVISIONEE_BENCHMARKS[];
+
+/** @brief Linux crypto (sign, verify, ECDH) benchmarks, terminated by a NULL name.
+ */
+extern const FfsBenchmark_t FFS_LINUX_CRYPTO_BENCHMARKS[];
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FFS_BENCHMARK_H_ */
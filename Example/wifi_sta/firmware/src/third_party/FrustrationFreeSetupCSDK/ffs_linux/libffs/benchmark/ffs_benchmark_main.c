@@ -0,0 +1,532 @@
+/** @file ffs_benchmark_main.c
+ *
+ * @brief Ffs microbenchmark runner.
+ *
+ * Runs every registered benchmark, writes the results as JSON and, given a
+ * baseline results file, fails when a benchmark has regressed by more than
+ * a threshold.
+ *
+ * Usage: all_benchmarks [--output FILE] [--compare BASELINE] [--threshold PERCENT]
+ *                       [--filter SUBSTRING] [--min-time MILLISECONDS]
+ *                       [--repetitions COUNT] [--quick]
+ *
+ * Exit status: 0 on success, 1 if a benchmark regressed past the threshold
+ * and 2 on any other error.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_check_result.h"
+#include "ffs/common/ffs_json.h"
+#include "ffs/compat/ffs_linux_logging.h"
+#include "ffs/compat/ffs_linux_user_context.h"
+#include "ffs_benchmark.h"
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCHMARK_RESULTS_VERSION           (1)
+#define DEFAULT_MINIMUM_TIME_MS             (200)
+#define DEFAULT_REPETITIONS                 (5)
+#define DEFAULT_THRESHOLD_PERCENT           (10.0)
+#define QUICK_MINIMUM_TIME_MS               (10)
+#define QUICK_REPETITIONS                   (1)
+#define MAXIMUM_REPETITIONS                 (100)
+#define MAXIMUM_NUMBER_SIZE                 (32)
+
+#define EXIT_REGRESSION                     (1)
+#define EXIT_ERROR                          (2)
+
+/** @brief Runner options.
+ */
+typedef struct {
+    const char *outputPath; //!< Results file (NULL for stdout).
+    const char *baselinePath; //!< Baseline results file (NULL to skip the comparison).
+    const char *filter; //!< Only run benchmarks whose name contains this (NULL for all).
+    double thresholdPercent; //!< Allowed slowdown \a vs. the baseline.
+    uint32_t minimumTimeMs; //!< Minimum measured time per repetition.
+    uint32_t repetitions; //!< Number of timed repetitions.
+} FfsBenchmarkOptions_t;
+
+/** @brief Result of one benchmark.
+ */
+typedef struct {
+    const FfsBenchmark_t *benchmark; //!< Benchmark definition.
+    const char *skipReason; //!< Why the benchmark was not run (NULL if it ran).
+    uint64_t iterations; //!< Operations per repetition.
+    double nsPerOperation; //!< Median time per operation.
+    double minimumNsPerOperation; //!< Fastest repetition's time per operation.
+} FfsBenchmarkResult_t;
+
+/** @brief Benchmark groups, in run order.
+ */
+static const FfsBenchmark_t *const BENCHMARK_GROUPS[] = {
+    FFS_COMMON_BENCHMARKS,
+    FFS_DSS_BENCHMARKS,
+    FFS_WIFI_PROVISIONEE_BENCHMARKS,
+    FFS_LINUX_CRYPTO_BENCHMARKS,
+    NULL
+};
+
+static uint8_t benchmarkBuffer[FFS_BENCHMARK_BUFFER_SIZE];
+
+// Static function prototypes.
+static FFS_RESULT ffsParseBenchmarkCommandLine(int argc, char **argv, FfsBenchmarkOptions_t *options);
+static FFS_RESULT ffsInitializeBenchmarkUserContext(FfsUserContext_t *userContext);
+static FFS_RESULT ffsRunBenchmark(const FfsBenchmarkOptions_t *options, FfsUserContext_t *userContext,
+        FfsBenchmarkResult_t *result);
+static FFS_RESULT ffsTimeBenchmark(const FfsBenchmark_t *benchmark, FfsUserContext_t *userContext,
+        uint64_t iterations, uint64_t *elapsedNs);
+static FFS_RESULT ffsWriteBenchmarkResults(const FfsBenchmarkOptions_t *options,
+        const FfsBenchmarkResult_t *results, size_t resultCount);
+static FFS_RESULT ffsCompareBenchmarkResults(const FfsBenchmarkOptions_t *options,
+        const FfsBenchmarkResult_t *results, size_t resultCount, bool *hasRegressed);
+static FFS_RESULT ffsReadBenchmarkFile(const char *path, uint8_t **data, size_t *dataSize);
+static const FfsBenchmarkResult_t *ffsFindBenchmarkResult(const FfsBenchmarkResult_t *results,
+        size_t resultCount, const char *name);
+static uint64_t ffsGetMonotonicNs(void);
+static int ffsCompareDoubles(const void *left, const void *right);
+
+int main(int argc, char **argv)
+{
+    FfsBenchmarkOptions_t options = {
+        .thresholdPercent = DEFAULT_THRESHOLD_PERCENT,
+        .minimumTimeMs = DEFAULT_MINIMUM_TIME_MS,
+        .repetitions = DEFAULT_REPETITIONS
+    };
+    if (ffsParseBenchmarkCommandLine(argc, argv, &options)) {
+        return EXIT_ERROR;
+    }
+
+    // Keep the library quiet so that logging is not measured (and stdout stays JSON).
+    ffsSetLogLevel(FFS_LOG_LEVEL_ERROR);
+
+    // Count the benchmarks.
+    size_t benchmarkCount = 0;
+    for (size_t group = 0; BENCHMARK_GROUPS[group]; group++) {
+        for (const FfsBenchmark_t *benchmark = BENCHMARK_GROUPS[group]; benchmark->name; benchmark++) {
+            benchmarkCount++;
+        }
+    }
+
+    FfsBenchmarkResult_t *results = (FfsBenchmarkResult_t *) calloc(benchmarkCount, sizeof(*results));
+    if (!results) {
+        return EXIT_ERROR;
+    }
+
+    // Benchmarks that need keys and the configuration map run against the Linux user context.
+    FfsUserContext_t userContext;
+    bool hasUserContext = ffsInitializeBenchmarkUserContext(&userContext) == FFS_SUCCESS;
+    if (!hasUserContext) {
+        fprintf(stderr, "Unable to initialize the user context (run from the build directory with ./data); "
+                "skipping benchmarks that need it\n");
+    }
+
+    // Run the benchmarks.
+    size_t resultCount = 0;
+    bool hasFailed = false;
+    for (size_t group = 0; BENCHMARK_GROUPS[group]; group++) {
+        for (const FfsBenchmark_t *benchmark = BENCHMARK_GROUPS[group]; benchmark->name; benchmark++) {
+            if (options.filter && !strstr(benchmark->name, options.filter)) {
+                continue;
+            }
+
+            FfsBenchmarkResult_t *result = &results[resultCount++];
+            result->benchmark = benchmark;
+
+            if (benchmark->requiresUserContext && !hasUserContext) {
+                result->skipReason = "no user context";
+                continue;
+            }
+
+            if (ffsRunBenchmark(&options, hasUserContext ? &userContext : NULL, result)) {
+                fprintf(stderr, "Benchmark %s failed\n", benchmark->name);
+                hasFailed = true;
+            }
+        }
+    }
+
+    if (hasUserContext) {
+        ffsDeinitializeUserContext(&userContext);
+    }
+
+    int exitStatus = EXIT_SUCCESS;
+    if (hasFailed || ffsWriteBenchmarkResults(&options, results, resultCount)) {
+        exitStatus = EXIT_ERROR;
+    } else if (options.baselinePath) {
+        bool hasRegressed = false;
+        if (ffsCompareBenchmarkResults(&options, results, resultCount, &hasRegressed)) {
+            exitStatus = EXIT_ERROR;
+        } else if (hasRegressed) {
+            exitStatus = EXIT_REGRESSION;
+        }
+    }
+
+    free(results);
+
+    return exitStatus;
+}
+
+/** @brief Parse the command line.
+ */
+static FFS_RESULT ffsParseBenchmarkCommandLine(int argc, char **argv, FfsBenchmarkOptions_t *options)
+{
+    static const struct option LONG_OPTIONS[] = {
+        { "output", required_argument, NULL, 'o' },
+        { "compare", required_argument, NULL, 'c' },
+        { "threshold", required_argument, NULL, 't' },
+        { "filter", required_argument, NULL, 'f' },
+        { "min-time", required_argument, NULL, 'm' },
+        { "repetitions", required_argument, NULL, 'r' },
+        { "quick", no_argument, NULL, 'q' },
+        { NULL, 0, NULL, 0 }
+    };
+
+    int option;
+    while ((option = getopt_long(argc, argv, "o:c:t:f:m:r:q", LONG_OPTIONS, NULL)) != -1) {
+        switch (option) {
+            case 'o':
+                options->outputPath = optarg;
+                break;
+            case 'c':
+                options->baselinePath = optarg;
+                break;
+            case 't':
+                options->thresholdPercent = atof(optarg);
+                break;
+            case 'f':
+                options->filter = optarg;
+                break;
+            case 'm':
+                options->minimumTimeMs = (uint32_t) strtoul(optarg, NULL, 10);
+                break;
+            case 'r':
+                options->repetitions = (uint32_t) strtoul(optarg, NULL, 10);
+                break;
+            case 'q':
+                options->minimumTimeMs = QUICK_MINIMUM_TIME_MS;
+                options->repetitions = QUICK_REPETITIONS;
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [--output FILE] [--compare BASELINE] [--threshold PERCENT] "
+                        "[--filter SUBSTRING] [--min-time MILLISECONDS] [--repetitions COUNT] [--quick]\n",
+                        argv[0]);
+                FFS_FAIL(FFS_ERROR);
+        }
+    }
+
+    if (!options->minimumTimeMs || !options->repetitions || options->repetitions > MAXIMUM_REPETITIONS
+            || options->thresholdPercent < 0) {
+        fprintf(stderr, "Invalid benchmark options\n");
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Initialize the Linux user context used by the key-dependent benchmarks.
+ *
+ * There is no cloud key in the data directory, so the device's own public key
+ * stands in as the ECDH peer; the cost of the computation is the same.
+ */
+static FFS_RESULT ffsInitializeBenchmarkUserContext(FfsUserContext_t *userContext)
+{
+    FFS_CHECK_RESULT(ffsInitializeUserContext(userContext));
+
+    if (!userContext->devicePublicKey || !EVP_PKEY_up_ref(userContext->devicePublicKey)) {
+        ffsDeinitializeUserContext(userContext);
+        FFS_FAIL(FFS_ERROR);
+    }
+    userContext->cloudPublicKey = userContext->devicePublicKey;
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Calibrate and time one benchmark.
+ */
+static FFS_RESULT ffsRunBenchmark(const FfsBenchmarkOptions_t *options, FfsUserContext_t *userContext,
+        FfsBenchmarkResult_t *result)
+{
+    const FfsBenchmark_t *benchmark = result->benchmark;
+    const uint64_t minimumTimeNs = (uint64_t) options->minimumTimeMs * 1000000;
+    uint64_t elapsedNs;
+
+    // Warm up (and check that the operation succeeds at all).
+    FFS_CHECK_RESULT(benchmark->function(userContext, benchmarkBuffer));
+
+    // Double the iteration count until a batch takes a measurable fraction of the target time.
+    uint64_t iterations = 1;
+    for (;;) {
+        FFS_CHECK_RESULT(ffsTimeBenchmark(benchmark, userContext, iterations, &elapsedNs));
+        if (elapsedNs >= minimumTimeNs / 8) {
+            break;
+        }
+        iterations *= 2;
+    }
+
+    // Scale it to the target time.
+    if (elapsedNs < minimumTimeNs) {
+        iterations = (uint64_t) ((double) iterations * minimumTimeNs / (elapsedNs ? elapsedNs : 1)) + 1;
+    }
+
+    // Time the repetitions.
+    double nsPerOperation[MAXIMUM_REPETITIONS];
+    for (uint32_t repetition = 0; repetition < options->repetitions; repetition++) {
+        FFS_CHECK_RESULT(ffsTimeBenchmark(benchmark, userContext, iterations, &elapsedNs));
+        nsPerOperation[repetition] = (double) elapsedNs / iterations;
+    }
+
+    qsort(nsPerOperation, options->repetitions, sizeof(nsPerOperation[0]), ffsCompareDoubles);
+
+    result->iterations = iterations;
+    result->nsPerOperation = nsPerOperation[options->repetitions / 2];
+    result->minimumNsPerOperation = nsPerOperation[0];
+
+    fprintf(stderr, "%-60s %12.1f ns/op\n", benchmark->name, result->nsPerOperation);
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Time a batch of operations.
+ */
+static FFS_RESULT ffsTimeBenchmark(const FfsBenchmark_t *benchmark, FfsUserContext_t *userContext,
+        uint64_t iterations, uint64_t *elapsedNs)
+{
+    uint64_t start = ffsGetMonotonicNs();
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        FFS_CHECK_RESULT(benchmark->function(userContext, benchmarkBuffer));
+    }
+
+    *elapsedNs = ffsGetMonotonicNs() - start;
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Write the results as JSON.
+ */
+static FFS_RESULT ffsWriteBenchmarkResults(const FfsBenchmarkOptions_t *options,
+        const FfsBenchmarkResult_t *results, size_t resultCount)
+{
+    FILE *file = stdout;
+    if (options->outputPath) {
+        file = fopen(options->outputPath, "w");
+        if (!file) {
+            fprintf(stderr, "Unable to open %s\n", options->outputPath);
+            FFS_FAIL(FFS_ERROR);
+        }
+    }
+
+    fprintf(file, "{\n  \"version\": %d,\n  \"minimumTimeMs\": %u,\n  \"repetitions\": %u,\n"
+            "  \"benchmarks\": [", BENCHMARK_RESULTS_VERSION, options->minimumTimeMs, options->repetitions);
+
+    bool isFirst = true;
+    for (size_t i = 0; i < resultCount; i++) {
+        const FfsBenchmarkResult_t *result = &results[i];
+        if (result->skipReason) {
+            continue;
+        }
+
+        fprintf(file, "%s\n    {\"name\": \"%s\", \"iterations\": %llu, \"nsPerOperation\": %.3f, "
+                "\"minimumNsPerOperation\": %.3f, \"bytesPerOperation\": %zu}",
+                isFirst ? "" : ",", result->benchmark->name, (unsigned long long) result->iterations,
+                result->nsPerOperation, result->minimumNsPerOperation, result->benchmark->bytesPerOperation);
+        isFirst = false;
+    }
+
+    fprintf(file, "\n  ],\n  \"skipped\": [");
+
+    isFirst = true;
+    for (size_t i = 0; i < resultCount; i++) {
+        const FfsBenchmarkResult_t *result = &results[i];
+        if (!result->skipReason) {
+            continue;
+        }
+
+        fprintf(file, "%s\n    {\"name\": \"%s\", \"reason\": \"%s\"}", isFirst ? "" : ",",
+                result->benchmark->name, result->skipReason);
+        isFirst = false;
+    }
+
+    fprintf(file, "\n  ]\n}\n");
+
+    if (file != stdout && fclose(file)) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Compare the results with a baseline results file.
+ *
+ * The baseline is parsed with the libffs JSON parser. Benchmarks missing from
+ * either side are reported but never fail the comparison.
+ */
+static FFS_RESULT ffsCompareBenchmarkResults(const FfsBenchmarkOptions_t *options,
+        const FfsBenchmarkResult_t *results, size_t resultCount, bool *hasRegressed)
+{
+    uint8_t *baselineData;
+    size_t baselineDataSize;
+    FFS_CHECK_RESULT(ffsReadBenchmarkFile(options->baselinePath, &baselineData, &baselineDataSize));
+
+    FFS_RESULT result = FFS_SUCCESS;
+    FfsStream_t baselineStream = ffsCreateInputStream(baselineData, baselineDataSize);
+    FfsJsonValue_t rootValue;
+    FfsJsonField_t benchmarksField = ffsCreateJsonField("benchmarks", FFS_JSON_ARRAY);
+    FfsJsonField_t *rootFields[] = { &benchmarksField, NULL };
+
+    if (ffsInitializeJsonObject(&baselineStream, &rootValue)
+            || ffsParseJsonObject(&rootValue, rootFields)
+            || ffsJsonFieldIsEmpty(&benchmarksField)) {
+        fprintf(stderr, "Invalid baseline file %s\n", options->baselinePath);
+        result = FFS_ERROR;
+        goto done;
+    }
+
+    *hasRegressed = false;
+    size_t comparedCount = 0;
+    for (;;) {
+        FfsJsonValue_t benchmarkValue;
+        bool isDone = false;
+        if (ffsParseJsonValue(&benchmarksField.value, &benchmarkValue, &isDone)) {
+            result = FFS_ERROR;
+            goto done;
+        }
+        if (isDone) {
+            break;
+        }
+
+        FfsJsonField_t nameField = ffsCreateJsonField("name", FFS_JSON_STRING);
+        FfsJsonField_t nsPerOperationField = ffsCreateJsonField("nsPerOperation", FFS_JSON_NUMBER);
+        FfsJsonField_t *benchmarkFields[] = { &nameField, &nsPerOperationField, NULL };
+
+        const char *name;
+        char number[MAXIMUM_NUMBER_SIZE];
+        size_t numberSize = 0;
+
+        if (ffsParseJsonObject(&benchmarkValue, benchmarkFields)
+                || ffsJsonFieldIsEmpty(&nameField) || ffsJsonFieldIsEmpty(&nsPerOperationField)
+                || ffsConvertJsonValueToUtf8String(&nameField.value, &name)
+                || (numberSize = FFS_STREAM_DATA_SIZE(nsPerOperationField.value.valueStream)) >= sizeof(number)) {
+            fprintf(stderr, "Invalid baseline entry in %s\n", options->baselinePath);
+            result = FFS_ERROR;
+            goto done;
+        }
+        memcpy(number, FFS_STREAM_NEXT_READ(nsPerOperationField.value.valueStream), numberSize);
+        number[numberSize] = '\0';
+        double baselineNsPerOperation = strtod(number, NULL);
+
+        const FfsBenchmarkResult_t *current = ffsFindBenchmarkResult(results, resultCount, name);
+        if (!current) {
+            if (!options->filter || strstr(name, options->filter)) {
+                fprintf(stderr, "%-60s not run\n", name);
+            }
+            continue;
+        }
+
+        double changePercent = (current->nsPerOperation - baselineNsPerOperation) * 100.0
+                / (baselineNsPerOperation > 0 ? baselineNsPerOperation : 1);
+        bool isRegression = changePercent > options->thresholdPercent;
+        fprintf(stderr, "%-60s %12.1f -> %12.1f ns/op (%+.1f%%)%s\n", name, baselineNsPerOperation,
+                current->nsPerOperation, changePercent, isRegression ? " REGRESSION" : "");
+
+        comparedCount++;
+        if (isRegression) {
+            *hasRegressed = true;
+        }
+    }
+
+    fprintf(stderr, "Compared %zu benchmarks against %s (threshold %.1f%%): %s\n", comparedCount,
+            options->baselinePath, options->thresholdPercent, *hasRegressed ? "REGRESSED" : "OK");
+
+done:
+    free(baselineData);
+
+    if (result) {
+        FFS_FAIL(result);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Read a whole file into a heap buffer.
+ */
+static FFS_RESULT ffsReadBenchmarkFile(const char *path, uint8_t **data, size_t *dataSize)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Unable to open %s\n", path);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    long fileSize = -1;
+    if (!fseek(file, 0, SEEK_END)) {
+        fileSize = ftell(file);
+    }
+    if (fileSize <= 0 || fseek(file, 0, SEEK_SET)) {
+        fclose(file);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    *data = (uint8_t *) malloc((size_t) fileSize);
+    if (!*data) {
+        fclose(file);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    *dataSize = fread(*data, 1, (size_t) fileSize, file);
+    fclose(file);
+
+    if (*dataSize != (size_t) fileSize) {
+        free(*data);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Find the result of a benchmark that ran.
+ */
+static const FfsBenchmarkResult_t *ffsFindBenchmarkResult(const FfsBenchmarkResult_t *results,
+        size_t resultCount, const char *name)
+{
+    for (size_t i = 0; i < resultCount; i++) {
+        if (!results[i].skipReason && !strcmp(results[i].benchmark->name, name)) {
+            return &results[i];
+        }
+    }
+
+    return NULL;
+}
+
+/** @brief Get the monotonic clock in nanoseconds.
+ */
+static uint64_t ffsGetMonotonicNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000000000 + (uint64_t) now.tv_nsec;
+}
+
+/** @brief qsort() comparator for doubles.
+ */
+static int ffsCompareDoubles(const void *left, const void *right)
+{
+    double leftValue = *(const double *) left;
+    double rightValue = *(const double *) right;
+
+    return (leftValue > rightValue) - (leftValue < rightValue);
+}
@@ -0,0 +1,161 @@
+/** @file ffs_benchmark_payloads.h
+ *
+ * @brief Recorded DSS payloads used by the Ffs microbenchmarks.
+ *
+ * The payloads are representative DSS response bodies (with the identifying
+ * values replaced) so that the deserializer benchmarks exercise the same
+ * field counts, string escapes and list lengths as a real setup.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#ifndef FFS_BENCHMARK_PAYLOADS_H_
+#define FFS_BENCHMARK_PAYLOADS_H_
+
+#define BENCHMARK_NONCE             "0BP1mq2Q7Ov7kWbN9wzRmA"
+#define BENCHMARK_SESSION_ID        "6b1f2d6e-0c57-4c9e-9a5d-2f1d3c7b8e90"
+#define BENCHMARK_SALT              "qVtb5m0S"
+#define BENCHMARK_HASHED_PIN        "zbgijVMu30HdCejO57VOwss9IIYnZ4a4TmVUS5XiG5E="
+
+/** @brief 64 base64 characters, the bulk of certificates, signatures and tokens.
+ */
+#define BENCHMARK_BASE64_LINE       "MIICxjCCAa6gAwIBAgIJAJq8sZ0tQ5mYv2Lk9Wc4Rn8sHA0GCSqGSIb3DQEBCwUA"
+#define BENCHMARK_BASE64_BLOCK      BENCHMARK_BASE64_LINE BENCHMARK_BASE64_LINE \
+                                    BENCHMARK_BASE64_LINE BENCHMARK_BASE64_LINE
+#define BENCHMARK_BASE64_BLOB       BENCHMARK_BASE64_BLOCK BENCHMARK_BASE64_BLOCK \
+                                    BENCHMARK_BASE64_BLOCK BENCHMARK_BASE64_BLOCK
+
+/** @brief "Start provisioning session" response.
+ */
+#define START_PROVISIONING_SESSION_RESPONSE_PAYLOAD "{" \
+        "\"nonce\":\"" BENCHMARK_NONCE "\"," \
+        "\"sessionId\":\"" BENCHMARK_SESSION_ID "\"," \
+        "\"canProceed\":true," \
+        "\"salt\":\"" BENCHMARK_SALT "\"" \
+        "}"
+
+/** @brief "Start PIN-based setup" response.
+ */
+#define START_PIN_BASED_SETUP_RESPONSE_PAYLOAD "{" \
+        "\"nonce\":\"" BENCHMARK_NONCE "\"," \
+        "\"canProceed\":true" \
+        "}"
+
+/** @brief Registration details object.
+ */
+#define REGISTRATION_DETAILS_PAYLOAD "{" \
+        "\"registrationToken\":\"Atzr|IwEBIKs0b6m9cT3Qy1vYp8Xk2u0ZfWl4rNe7dJ5gHcB1oMaV6sLqE9wFz3Ui8" \
+                "OtKjRyP2hDnC4xGb7A0mTe5QvS1lW9uY3Z6kN8oJd2fHr4pLgM7cXa0sVtB5\"," \
+        "\"expiresAt\":1571097600" \
+        "}"
+
+/** @brief "Compute configuration data" response.
+ */
+#define COMPUTE_CONFIGURATION_DATA_RESPONSE_PAYLOAD "{" \
+        "\"nonce\":\"" BENCHMARK_NONCE "\"," \
+        "\"configuration\":{" \
+            "\"LocaleConfiguration.LanguageLocale\":\"en-US\"," \
+            "\"LocaleConfiguration.CountryCode\":\"US\"," \
+            "\"LocaleConfiguration.CountryOfResidence\":\"US\"," \
+            "\"LocaleConfiguration.Region\":\"NA\"," \
+            "\"LocaleConfiguration.Realm\":\"USAmazon\"," \
+            "\"LocaleConfiguration.Marketplace\":\"ATVPDKIKX0DER\"" \
+        "}," \
+        "\"registrationDetails\":" REGISTRATION_DETAILS_PAYLOAD \
+        "}"
+
+/** @brief "Post Wi-Fi scan data" response.
+ */
+#define POST_WIFI_SCAN_DATA_RESPONSE_PAYLOAD "{" \
+        "\"nonce\":\"" BENCHMARK_NONCE "\"," \
+        "\"sessionId\":\"" BENCHMARK_SESSION_ID "\"," \
+        "\"canProceed\":true," \
+        "\"sequenceNumber\":1," \
+        "\"totalCredentialsFound\":2," \
+        "\"allCredentialsFound\":false" \
+        "}"
+
+/** @brief Single Wi-Fi credentials object.
+ */
+#define WIFI_CREDENTIALS_PAYLOAD "{" \
+        "\"frequency\":5180," \
+        "\"key\":\"\\\"c0rr3ct h0rse \\\\\\\"battery\\\\\\\" st@ple\\\"\"," \
+        "\"keyIndex\":0," \
+        "\"priority\":1," \
+        "\"securityProtocol\":\"WPA_PSK\"," \
+        "\"ssid\":\"\\\"Home Network 5G\\\"\"" \
+        "}"
+
+/** @brief "Get Wi-Fi credentials" response with a typical credentials list.
+ */
+#define GET_WIFI_CREDENTIALS_RESPONSE_PAYLOAD "{" \
+        "\"nonce\":\"" BENCHMARK_NONCE "\"," \
+        "\"sessionId\":\"" BENCHMARK_SESSION_ID "\"," \
+        "\"canProceed\":true," \
+        "\"sequenceNumber\":1," \
+        "\"allCredentialsReturned\":true," \
+        "\"wifiCredentialsList\":[" \
+            WIFI_CREDENTIALS_PAYLOAD "," \
+            "{" \
+                "\"frequency\":2437," \
+                "\"key\":\"\\\"c0rr3ct h0rse battery st@ple\\\"\"," \
+                "\"keyIndex\":0," \
+                "\"priority\":2," \
+                "\"securityProtocol\":\"WPA_PSK\"," \
+                "\"ssid\":\"\\\"Home Network\\\"\"" \
+            "},{" \
+                "\"frequency\":0," \
+                "\"keyIndex\":0," \
+                "\"priority\":3," \
+                "\"securityProtocol\":\"OPEN\"," \
+                "\"ssid\":\"\\\"Guest \\u00e9t\\u00e9\\\"\"" \
+            "},{" \
+                "\"frequency\":0," \
+                "\"key\":\"\\\"11111\\\"\"," \
+                "\"keyIndex\":0," \
+                "\"priority\":4," \
+                "\"securityProtocol\":\"WEP\"," \
+                "\"ssid\":\"\\\"Garage\\\"\"" \
+            "}" \
+        "]}"
+
+/** @brief Response dominated by base64 blobs (a certificate, a signature and a token).
+ */
+#define BASE64_BLOB_RESPONSE_PAYLOAD "{" \
+        "\"nonce\":\"" BENCHMARK_NONCE "\"," \
+        "\"sessionId\":\"" BENCHMARK_SESSION_ID "\"," \
+        "\"canProceed\":true," \
+        "\"certificate\":\"" BENCHMARK_BASE64_BLOB "\"," \
+        "\"signature\":\"" BENCHMARK_BASE64_BLOCK "\"," \
+        "\"registrationToken\":\"Atzr|" BENCHMARK_BASE64_BLOCK BENCHMARK_BASE64_BLOCK "\"" \
+        "}"
+
+/** @brief "Report" response.
+ */
+#define REPORT_RESPONSE_PAYLOAD "{" \
+        "\"nonce\":\"" BENCHMARK_NONCE "\"," \
+        "\"canProceed\":true," \
+        "\"nextProvisioningState\":\"GET_WIFI_LIST\"," \
+        "\"waitTime\":\"PT5S\"," \
+        "\"reason\":\"Waiting for the customer to confirm the network\"" \
+        "}"
+
+/** @brief Error details object.
+ */
+#define ERROR_DETAILS_PAYLOAD "{" \
+        "\"operation\":\"CONNECT\"," \
+        "\"cause\":\"AUTHENTICATION_FAILED\"," \
+        "\"details\":\"4-way handshake timed out after 3 attempts\"," \
+        "\"code\":\"3:15\"" \
+        "}"
+
+#endif /* FFS_BENCHMARK_PAYLOADS_H_ */
@@ -0,0 +1,884 @@
+/** @file ffs_factory_batch_main.c
+ *
+ * @brief Factory-line credential batch tool.
+ *
+ * Validates the certificate and private key of every device in a manifest
+ * and precomputes the nonce-independent part of its encoded setup network
+ * (auth material index and ECDH shared secret with the device type key),
+ * with one worker per core. Writes a ready-to-flash bundle for each valid
+ * device, with the files the PIC32MZW1 firmware reads from its file system,
+ * and an index of the whole batch.
+ *
+ * Manifest: one device per line, "device_id,certificate,private_key", with
+ * the PEM files relative to the manifest directory. Blank lines and lines
+ * starting with '#' are skipped. Device IDs are made of letters, digits,
+ * '.', '-' and '_', and name the bundle directories.
+ *
+ * Bundle (OUTPUT/device_id/):
+ *
+ *     certificate.pem, private_key.pem    Copies of the manifest files.
+ *     ffsDevPublic.key                    DER device public key.
+ *     ffsDevTypePublic.key                DER device type public key.
+ *     ffsRootCa.der                       DER root CA (with --root-ca).
+ *     ffs_setup.cache                     Encoded setup network cache.
+ *
+ * The index (OUTPUT/index.json) lists every device with its status, and the
+ * auth material index and key fingerprint of the valid ones.
+ *
+ * Usage: ffs_factory_batch --manifest FILE --device-type-key FILE --output DIRECTORY
+ *                          [--root-ca FILE] [--jobs COUNT]
+ *
+ * Exit status: 0 on success and 2 on error (invalid devices are results,
+ * reported in the index, not errors).
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_check_result.h"
+#include "ffs/compat/ffs_linux_logging.h"
+#include "ffs/compat/ffs_linux_user_context.h"
+#include "ffs/linux/ffs_linux_crypto_common.h"
+#include "ffs/wifi_provisionee/ffs_wifi_provisionee_encoded_setup_network.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <limits.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BATCH_INDEX_VERSION             (1)
+#define MAXIMUM_JOBS                    (256)
+#define MAXIMUM_DEVICE_ID_LENGTH        (64)
+#define MAXIMUM_MANIFEST_SIZE           (256 * 1024 * 1024)
+#define MAXIMUM_PEM_FILE_SIZE           (16 * 1024)
+#define MAXIMUM_ROOT_CA_FILE_SIZE       (16 * 1024)
+#define DER_PUBLIC_KEY_SIZE             (91) // P-256 public key, as read by the firmware.
+#define EC_KEY_BITS                     (256)
+
+#define INDEX_FILE_NAME                 "index.json"
+#define ROOT_CA_FILE_NAME               "ffsRootCa.der"
+#define DEVICE_PUBLIC_KEY_FILE_NAME     "ffsDevPublic.key"
+#define DEVICE_TYPE_KEY_FILE_NAME       "ffsDevTypePublic.key"
+#define CERTIFICATE_FILE_NAME           "certificate.pem"
+#define PRIVATE_KEY_FILE_NAME           "private_key.pem"
+#define SETUP_CACHE_FILE_NAME           "ffs_setup.cache"
+
+#define PUBLIC_FILE_MODE                (0644)
+#define PRIVATE_FILE_MODE               (0600) // Private key and setup network key material.
+
+#define EXIT_ERROR                      (2)
+
+/** @brief Tool options.
+ */
+typedef struct {
+    const char *manifestPath; //!< Device manifest.
+    const char *deviceTypeKeyPath; //!< PEM device type public key.
+    const char *rootCaPath; //!< DER or PEM root CA (NULL for none).
+    const char *outputPath; //!< Bundle directory.
+    uint32_t jobs; //!< Worker threads (0 for one per core).
+} FfsBatchOptions_t;
+
+/** @brief One manifest entry and its results.
+ */
+typedef struct {
+    const char *deviceId; //!< Device ID (bundle directory name).
+    const char *certificatePath; //!< PEM device certificate (relative to the manifest).
+    const char *privateKeyPath; //!< PEM device private key (relative to the manifest).
+    const char *error; //!< Why the device is invalid (NULL if valid).
+    FfsEncodedSetupNetworkCache_t cache; //!< Precomputed setup network key material.
+} FfsBatchDevice_t;
+
+/** @brief Batch shared by the workers.
+ */
+typedef struct {
+    const FfsBatchOptions_t *options; //!< Tool options.
+    char manifestDirectory[PATH_MAX]; //!< Directory the manifest paths are relative to.
+    char *manifest; //!< Manifest text (the devices point into it).
+    FfsBatchDevice_t *devices; //!< Manifest entries.
+    size_t deviceCount; //!< Number of manifest entries.
+    uint8_t deviceTypeKey[DER_PUBLIC_KEY_SIZE]; //!< DER device type public key.
+    uint8_t *rootCa; //!< DER root CA (NULL for none).
+    size_t rootCaSize; //!< DER root CA size.
+    pthread_mutex_t lock; //!< Protects the fields below.
+    size_t nextDevice; //!< Next device to claim.
+    FFS_RESULT result; //!< First worker error.
+} FfsBatch_t;
+
+static FFS_RESULT ffsParseBatchCommandLine(int argc, char **argv, FfsBatchOptions_t *options);
+static FFS_RESULT ffsLoadBatchManifest(FfsBatch_t *batch);
+static FFS_RESULT ffsLoadBatchDeviceTypeKey(FfsBatch_t *batch);
+static FFS_RESULT ffsLoadBatchRootCa(FfsBatch_t *batch);
+static FFS_RESULT ffsRunBatch(FfsBatch_t *batch, uint32_t jobs);
+static void *ffsRunBatchWorker(void *argument);
+static FFS_RESULT ffsProcessBatchDevice(FfsBatch_t *batch, FfsUserContext_t *userContext, FfsBatchDevice_t *device);
+static EVP_PKEY *ffsReadBatchPrivateKey(const uint8_t *buffer, size_t size);
+static const char *ffsValidateBatchCredentials(X509 *certificate, EVP_PKEY *privateKey);
+static FFS_RESULT ffsWriteBatchBundle(FfsBatch_t *batch, FfsBatchDevice_t *device,
+        const uint8_t *certificate, size_t certificateSize, const uint8_t *privateKey, size_t privateKeySize,
+        const uint8_t *devicePublicKey);
+static FFS_RESULT ffsWriteBatchIndex(const FfsBatch_t *batch, uint32_t jobs, uint64_t elapsedMs);
+static FFS_RESULT ffsReadBatchFile(const char *path, uint8_t *buffer, size_t bufferSize, size_t *size);
+static FFS_RESULT ffsWriteBatchFile(const char *directory, const char *name, const uint8_t *data, size_t size,
+        mode_t mode);
+static void ffsFreeBatch(FfsBatch_t *batch);
+static void ffsGetBatchPath(const FfsBatch_t *batch, const char *path, char *destination, size_t destinationSize);
+static bool ffsIsValidBatchDeviceId(const char *deviceId);
+static int ffsCompareBatchDeviceIds(const void *left, const void *right);
+static void ffsWriteBatchHex(FILE *file, const uint8_t *data, size_t size);
+static uint64_t ffsGetBatchTimeMs(void);
+
+int main(int argc, char **argv)
+{
+    FfsBatchOptions_t options = { 0 };
+    if (ffsParseBatchCommandLine(argc, argv, &options)) {
+        return EXIT_ERROR;
+    }
+
+    // Every device misses the setup network cache (the Linux client does not
+    // store one) and the compat layer logs the miss as an error: keep all the
+    // library logging out of the report. Devices are rejected with a reason.
+    ffsSetLogLevel((FFS_LOG_LEVEL) (FFS_LOG_LEVEL_ERROR + 1));
+
+    // Initialize the logging lock before the workers share it.
+    ffsLogDebug("Factory batch tool");
+
+    FfsBatch_t batch;
+    memset(&batch, 0, sizeof(batch));
+    batch.options = &options;
+
+    if (ffsLoadBatchManifest(&batch) || ffsLoadBatchDeviceTypeKey(&batch) || ffsLoadBatchRootCa(&batch)) {
+        ffsFreeBatch(&batch);
+        return EXIT_ERROR;
+    }
+
+    if (mkdir(options.outputPath, 0755) && errno != EEXIST) {
+        fprintf(stderr, "Unable to create %s\n", options.outputPath);
+        ffsFreeBatch(&batch);
+        return EXIT_ERROR;
+    }
+
+    uint32_t jobs = options.jobs;
+    if (!jobs) {
+        long processorCount = sysconf(_SC_NPROCESSORS_ONLN);
+        jobs = processorCount > 0 ? (uint32_t) processorCount : 1;
+    }
+    if (jobs > MAXIMUM_JOBS) {
+        jobs = MAXIMUM_JOBS;
+    }
+    if (jobs > batch.deviceCount) {
+        jobs = batch.deviceCount ? (uint32_t) batch.deviceCount : 1;
+    }
+
+    uint64_t startMs = ffsGetBatchTimeMs();
+    int exitStatus = EXIT_SUCCESS;
+    if (ffsRunBatch(&batch, jobs)) {
+        exitStatus = EXIT_ERROR;
+    }
+    uint64_t elapsedMs = ffsGetBatchTimeMs() - startMs;
+
+    if (exitStatus == EXIT_SUCCESS) {
+        size_t validCount = 0;
+        for (size_t i = 0; i < batch.deviceCount; i++) {
+            if (batch.devices[i].error) {
+                printf("%s: %s\n", batch.devices[i].deviceId, batch.devices[i].error);
+            } else {
+                validCount++;
+            }
+        }
+
+        printf("%zu devices, %zu valid, %zu invalid, %u jobs, %.3f s, %.0f devices/s\n", batch.deviceCount,
+                validCount, batch.deviceCount - validCount, jobs, elapsedMs / 1000.0,
+                elapsedMs ? batch.deviceCount * 1000.0 / elapsedMs : 0.0);
+
+        if (ffsWriteBatchIndex(&batch, jobs, elapsedMs)) {
+            exitStatus = EXIT_ERROR;
+        }
+    }
+
+    pthread_mutex_destroy(&batch.lock);
+    ffsFreeBatch(&batch);
+
+    return exitStatus;
+}
+
+/** @brief Free the manifest, the devices and the root CA.
+ */
+static void ffsFreeBatch(FfsBatch_t *batch)
+{
+    free(batch->devices);
+    free(batch->manifest);
+    free(batch->rootCa);
+}
+
+/** @brief Parse the command line.
+ */
+static FFS_RESULT ffsParseBatchCommandLine(int argc, char **argv, FfsBatchOptions_t *options)
+{
+    static const struct option LONG_OPTIONS[] = {
+        { "manifest", required_argument, NULL, 'm' },
+        { "device-type-key", required_argument, NULL, 't' },
+        { "root-ca", required_argument, NULL, 'r' },
+        { "output", required_argument, NULL, 'o' },
+        { "jobs", required_argument, NULL, 'j' },
+        { NULL, 0, NULL, 0 }
+    };
+
+    int option;
+    while ((option = getopt_long(argc, argv, "m:t:r:o:j:", LONG_OPTIONS, NULL)) != -1) {
+        switch (option) {
+            case 'm':
+                options->manifestPath = optarg;
+                break;
+            case 't':
+                options->deviceTypeKeyPath = optarg;
+                break;
+            case 'r':
+                options->rootCaPath = optarg;
+                break;
+            case 'o':
+                options->outputPath = optarg;
+                break;
+            case 'j':
+                options->jobs = (uint32_t) strtoul(optarg, NULL, 10);
+                break;
+            default:
+                options->manifestPath = NULL;
+                break;
+        }
+    }
+
+    if (!options->manifestPath || !options->deviceTypeKeyPath || !options->outputPath) {
+        fprintf(stderr, "Usage: %s --manifest FILE --device-type-key FILE --output DIRECTORY "
+                "[--root-ca FILE] [--jobs COUNT]\n", argv[0]);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Read the manifest and check the device IDs.
+ */
+static FFS_RESULT ffsLoadBatchManifest(FfsBatch_t *batch)
+{
+    const char *manifestPath = batch->options->manifestPath;
+
+    // The manifest paths are relative to its directory.
+    const char *lastSlash = strrchr(manifestPath, '/');
+    if (!lastSlash) {
+        strcpy(batch->manifestDirectory, ".");
+    } else if ((size_t) (lastSlash - manifestPath) < sizeof(batch->manifestDirectory)) {
+        memcpy(batch->manifestDirectory, manifestPath, lastSlash - manifestPath);
+        batch->manifestDirectory[lastSlash - manifestPath] = '\0';
+    } else {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    // Read the whole manifest; the devices point into it.
+    FILE *file = fopen(manifestPath, "rb");
+    if (!file) {
+        fprintf(stderr, "Unable to open %s\n", manifestPath);
+        FFS_FAIL(FFS_ERROR);
+    }
+    fseek(file, 0, SEEK_END);
+    long manifestSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (manifestSize < 0 || manifestSize > MAXIMUM_MANIFEST_SIZE) {
+        fclose(file);
+        fprintf(stderr, "Invalid manifest size\n");
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    batch->manifest = (char *) malloc((size_t) manifestSize + 1);
+    if (!batch->manifest) {
+        fclose(file);
+        FFS_FAIL(FFS_OVERRUN);
+    }
+    size_t readSize = fread(batch->manifest, 1, (size_t) manifestSize, file);
+    fclose(file);
+    if (readSize != (size_t) manifestSize) {
+        FFS_FAIL(FFS_ERROR);
+    }
+    batch->manifest[manifestSize] = '\0';
+
+    // At most one device per line.
+    size_t lineCount = 1;
+    for (const char *character = batch->manifest; *character; character++) {
+        lineCount += *character == '\n';
+    }
+    batch->devices = (FfsBatchDevice_t *) calloc(lineCount, sizeof(*batch->devices));
+    if (!batch->devices) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    char *line = batch->manifest;
+    for (size_t lineNumber = 1; line; lineNumber++) {
+        char *nextLine = strchr(line, '\n');
+        if (nextLine) {
+            *nextLine++ = '\0';
+        }
+        size_t lineLength = strlen(line);
+        if (lineLength && line[lineLength - 1] == '\r') {
+            line[--lineLength] = '\0';
+        }
+
+        if (lineLength && line[0] != '#') {
+            FfsBatchDevice_t *device = &batch->devices[batch->deviceCount++];
+            char *certificateSeparator = strchr(line, ',');
+            char *privateKeySeparator = certificateSeparator ? strchr(certificateSeparator + 1, ',') : NULL;
+            if (!privateKeySeparator || strchr(privateKeySeparator + 1, ',')) {
+                fprintf(stderr, "%s:%zu: expected device_id,certificate,private_key\n", manifestPath, lineNumber);
+                FFS_FAIL(FFS_ERROR);
+            }
+            *certificateSeparator = '\0';
+            *privateKeySeparator = '\0';
+
+            device->deviceId = line;
+            device->certificatePath = certificateSeparator + 1;
+            device->privateKeyPath = privateKeySeparator + 1;
+
+            if (!ffsIsValidBatchDeviceId(device->deviceId) || !*device->certificatePath
+                    || !*device->privateKeyPath) {
+                fprintf(stderr, "%s:%zu: invalid device entry\n", manifestPath, lineNumber);
+                FFS_FAIL(FFS_ERROR);
+            }
+        }
+
+        line = nextLine;
+    }
+
+    // Two entries with the same ID would write the same bundle.
+    if (batch->deviceCount) {
+        const FfsBatchDevice_t **sortedDevices = (const FfsBatchDevice_t **) malloc(
+                batch->deviceCount * sizeof(*sortedDevices));
+        if (!sortedDevices) {
+            FFS_FAIL(FFS_OVERRUN);
+        }
+        for (size_t i = 0; i < batch->deviceCount; i++) {
+            sortedDevices[i] = &batch->devices[i];
+        }
+        qsort(sortedDevices, batch->deviceCount, sizeof(*sortedDevices), ffsCompareBatchDeviceIds);
+
+        const char *duplicateId = NULL;
+        for (size_t i = 1; i < batch->deviceCount && !duplicateId; i++) {
+            if (!strcmp(sortedDevices[i - 1]->deviceId, sortedDevices[i]->deviceId)) {
+                duplicateId = sortedDevices[i]->deviceId;
+            }
+        }
+        free(sortedDevices);
+
+        if (duplicateId) {
+            fprintf(stderr, "Duplicate device %s\n", duplicateId);
+            FFS_FAIL(FFS_ERROR);
+        }
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Read the device type public key and convert it to DER once for all the devices.
+ */
+static FFS_RESULT ffsLoadBatchDeviceTypeKey(FfsBatch_t *batch)
+{
+    FILE *file = fopen(batch->options->deviceTypeKeyPath, "r");
+    if (!file) {
+        fprintf(stderr, "Unable to open %s\n", batch->options->deviceTypeKeyPath);
+        FFS_FAIL(FFS_ERROR);
+    }
+    EVP_PKEY *deviceTypeKey = PEM_read_PUBKEY(file, NULL, NULL, NULL);
+    fclose(file);
+
+    // The firmware only takes P-256 keys.
+    if (!deviceTypeKey || EVP_PKEY_base_id(deviceTypeKey) != EVP_PKEY_EC
+            || i2d_PUBKEY(deviceTypeKey, NULL) != DER_PUBLIC_KEY_SIZE) {
+        EVP_PKEY_free(deviceTypeKey);
+        fprintf(stderr, "The device type key is not a P-256 public key\n");
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    FfsStream_t deviceTypeKeyStream = ffsCreateOutputStream(batch->deviceTypeKey, sizeof(batch->deviceTypeKey));
+    FFS_RESULT result = ffsGetDerEncodedPublicKeyFromEVPKey(deviceTypeKey, &deviceTypeKeyStream);
+    EVP_PKEY_free(deviceTypeKey);
+
+    return result;
+}
+
+/** @brief Read the root CA (DER or PEM) and convert it to DER once for all the devices.
+ */
+static FFS_RESULT ffsLoadBatchRootCa(FfsBatch_t *batch)
+{
+    if (!batch->options->rootCaPath) {
+        return FFS_SUCCESS;
+    }
+
+    uint8_t buffer[MAXIMUM_ROOT_CA_FILE_SIZE];
+    size_t size;
+    if (ffsReadBatchFile(batch->options->rootCaPath, buffer, sizeof(buffer), &size)) {
+        fprintf(stderr, "Unable to read %s\n", batch->options->rootCaPath);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    const uint8_t *readPointer = buffer;
+    X509 *rootCa = d2i_X509(NULL, &readPointer, (long) size);
+    if (!rootCa) {
+        BIO *bio = BIO_new_mem_buf(buffer, (int) size);
+        rootCa = bio ? PEM_read_bio_X509(bio, NULL, NULL, NULL) : NULL;
+        BIO_free(bio);
+    }
+    if (!rootCa) {
+        fprintf(stderr, "%s is not a certificate\n", batch->options->rootCaPath);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    uint8_t *rootCaDer = NULL;
+    int rootCaSize = i2d_X509(rootCa, &rootCaDer);
+    X509_free(rootCa);
+    if (rootCaSize <= 0) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    // Keep the copy in a buffer the batch frees.
+    batch->rootCa = (uint8_t *) malloc((size_t) rootCaSize);
+    if (batch->rootCa) {
+        memcpy(batch->rootCa, rootCaDer, (size_t) rootCaSize);
+        batch->rootCaSize = (size_t) rootCaSize;
+    }
+    OPENSSL_free(rootCaDer);
+
+    if (!batch->rootCa) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Process every device on a pool of workers.
+ */
+static FFS_RESULT ffsRunBatch(FfsBatch_t *batch, uint32_t jobs)
+{
+    pthread_t workers[MAXIMUM_JOBS];
+    uint32_t workerCount = 0;
+
+    if (pthread_mutex_init(&batch->lock, NULL)) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    for (; workerCount < jobs; workerCount++) {
+        if (pthread_create(&workers[workerCount], NULL, ffsRunBatchWorker, batch)) {
+            pthread_mutex_lock(&batch->lock);
+            batch->result = FFS_ERROR;
+            pthread_mutex_unlock(&batch->lock);
+            break;
+        }
+    }
+
+    for (uint32_t i = 0; i < workerCount; i++) {
+        pthread_join(workers[i], NULL);
+    }
+
+    if (batch->result != FFS_SUCCESS) {
+        FFS_FAIL(batch->result);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Worker: claim the next device until there are none left.
+ */
+static void *ffsRunBatchWorker(void *argument)
+{
+    FfsBatch_t *batch = (FfsBatch_t *) argument;
+
+    // Only the key material and the configuration map lookups of the
+    // setup network computation use the context.
+    FfsUserContext_t userContext;
+    memset(&userContext, 0, sizeof(userContext));
+
+    // The device type key is the ECDH peer of every device.
+    FfsStream_t deviceTypeKeyStream = ffsCreateInputStream(batch->deviceTypeKey, sizeof(batch->deviceTypeKey));
+    FFS_RESULT result = ffsGetEVPKeyFromDerStream(&deviceTypeKeyStream, &userContext.cloudPublicKey);
+
+    while (result == FFS_SUCCESS) {
+        pthread_mutex_lock(&batch->lock);
+        size_t deviceIndex = batch->nextDevice;
+        if (batch->result != FFS_SUCCESS) {
+            deviceIndex = batch->deviceCount;
+        } else if (deviceIndex < batch->deviceCount) {
+            batch->nextDevice++;
+        }
+        pthread_mutex_unlock(&batch->lock);
+
+        if (deviceIndex == batch->deviceCount) {
+            break;
+        }
+
+        result = ffsProcessBatchDevice(batch, &userContext, &batch->devices[deviceIndex]);
+    }
+
+    if (result != FFS_SUCCESS) {
+        pthread_mutex_lock(&batch->lock);
+        if (batch->result == FFS_SUCCESS) {
+            batch->result = result;
+        }
+        pthread_mutex_unlock(&batch->lock);
+    }
+
+    // The cached contexts reference the last device's keys.
+    ffsInvalidateLinuxCryptoCache(&userContext.cryptoCache);
+    EVP_PKEY_free(userContext.cloudPublicKey);
+
+    return NULL;
+}
+
+/** @brief Validate one device and write its bundle.
+ *
+ * Invalid credentials are recorded in the device; only I/O errors on the
+ * bundle fail.
+ */
+static FFS_RESULT ffsProcessBatchDevice(FfsBatch_t *batch, FfsUserContext_t *userContext, FfsBatchDevice_t *device)
+{
+    uint8_t certificateBuffer[MAXIMUM_PEM_FILE_SIZE];
+    uint8_t privateKeyBuffer[MAXIMUM_PEM_FILE_SIZE];
+    uint8_t devicePublicKey[DER_PUBLIC_KEY_SIZE];
+    size_t certificateSize, privateKeySize;
+    char path[PATH_MAX];
+
+    ffsGetBatchPath(batch, device->certificatePath, path, sizeof(path));
+    if (ffsReadBatchFile(path, certificateBuffer, sizeof(certificateBuffer), &certificateSize)) {
+        device->error = "unable to read the certificate";
+        return FFS_SUCCESS;
+    }
+    ffsGetBatchPath(batch, device->privateKeyPath, path, sizeof(path));
+    if (ffsReadBatchFile(path, privateKeyBuffer, sizeof(privateKeyBuffer), &privateKeySize)) {
+        device->error = "unable to read the private key";
+        return FFS_SUCCESS;
+    }
+
+    // Parse both from the copies that go into the bundle.
+    BIO *certificateBio = BIO_new_mem_buf(certificateBuffer, (int) certificateSize);
+    X509 *certificate = certificateBio ? PEM_read_bio_X509(certificateBio, NULL, NULL, NULL) : NULL;
+    BIO_free(certificateBio);
+    EVP_PKEY *privateKey = ffsReadBatchPrivateKey(privateKeyBuffer, privateKeySize);
+    EVP_PKEY *publicKey = certificate ? X509_get_pubkey(certificate) : NULL;
+
+    if (!certificate) {
+        device->error = "invalid certificate";
+    } else if (!privateKey) {
+        device->error = "the private key is not an EC key";
+    } else {
+        device->error = ffsValidateBatchCredentials(certificate, privateKey);
+    }
+
+    // Precompute the auth material index and the ECDH shared secret.
+    if (!device->error) {
+        FfsStream_t devicePublicKeyStream = ffsCreateOutputStream(devicePublicKey, sizeof(devicePublicKey));
+
+        userContext->devicePrivateKey = privateKey;
+        userContext->devicePublicKey = publicKey;
+        if (ffsGetDerEncodedPublicKeyFromEVPKey(publicKey, &devicePublicKeyStream)
+                || ffsPrepareAmazonCustomEncodedNetworkCache(userContext, &device->cache)) {
+            device->error = "unable to compute the setup network key material";
+        }
+        userContext->devicePrivateKey = NULL;
+        userContext->devicePublicKey = NULL;
+    }
+
+    EVP_PKEY_free(publicKey);
+    EVP_PKEY_free(privateKey);
+    X509_free(certificate);
+
+    if (device->error) {
+        return FFS_SUCCESS;
+    }
+
+    return ffsWriteBatchBundle(batch, device, certificateBuffer, certificateSize, privateKeyBuffer,
+            privateKeySize, devicePublicKey);
+}
+
+/** @brief Parse a PEM EC private key (NULL if invalid).
+ *
+ * Decoding the DER as an EC key directly is several times faster than
+ * letting OpenSSL try every key type, and the private key parsing dominates
+ * the time per device.
+ */
+static EVP_PKEY *ffsReadBatchPrivateKey(const uint8_t *buffer, size_t size)
+{
+    BIO *bio = BIO_new_mem_buf(buffer, (int) size);
+    if (!bio) {
+        return NULL;
+    }
+
+    char *name = NULL;
+    char *header = NULL;
+    uint8_t *der = NULL;
+    long derSize = 0;
+    EVP_PKEY *privateKey = NULL;
+    if (PEM_read_bio(bio, &name, &header, &der, &derSize)) {
+        const uint8_t *readPointer = der;
+        privateKey = d2i_PrivateKey(EVP_PKEY_EC, NULL, &readPointer, derSize);
+    }
+
+    OPENSSL_free(name);
+    OPENSSL_free(header);
+    OPENSSL_free(der);
+    BIO_free(bio);
+
+    return privateKey;
+}
+
+/** @brief Check a certificate and private key pair (NULL if valid, else the reason).
+ */
+static const char *ffsValidateBatchCredentials(X509 *certificate, EVP_PKEY *privateKey)
+{
+    // The firmware only takes P-256 keys.
+    if (EVP_PKEY_base_id(privateKey) != EVP_PKEY_EC || EVP_PKEY_bits(privateKey) != EC_KEY_BITS) {
+        return "the private key is not a P-256 key";
+    }
+
+    if (X509_check_private_key(certificate, privateKey) != 1) {
+        return "the private key does not match the certificate";
+    }
+
+    // Same key, so the same DER size; checked against the firmware buffer anyway.
+    EVP_PKEY *publicKey = X509_get0_pubkey(certificate);
+    if (!publicKey || i2d_PUBKEY(publicKey, NULL) != DER_PUBLIC_KEY_SIZE) {
+        return "the certificate public key is not a P-256 key";
+    }
+
+    if (X509_cmp_current_time(X509_get0_notAfter(certificate)) <= 0) {
+        return "the certificate has expired";
+    }
+
+    return NULL;
+}
+
+/** @brief Write the bundle of a valid device.
+ */
+static FFS_RESULT ffsWriteBatchBundle(FfsBatch_t *batch, FfsBatchDevice_t *device,
+        const uint8_t *certificate, size_t certificateSize, const uint8_t *privateKey, size_t privateKeySize,
+        const uint8_t *devicePublicKey)
+{
+    char directory[PATH_MAX];
+    int directoryLength = snprintf(directory, sizeof(directory), "%s/%s", batch->options->outputPath,
+            device->deviceId);
+    if (directoryLength < 0 || (size_t) directoryLength >= sizeof(directory)) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    if (mkdir(directory, 0755) && errno != EEXIST) {
+        fprintf(stderr, "Unable to create %s\n", directory);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    FFS_TEMPORARY_OUTPUT_STREAM(cacheStream, FFS_ENCODED_SETUP_NETWORK_CACHE_SIZE);
+    FFS_CHECK_RESULT(ffsEncodeAmazonCustomEncodedNetworkCache(&device->cache, &cacheStream));
+
+    FFS_CHECK_RESULT(ffsWriteBatchFile(directory, CERTIFICATE_FILE_NAME, certificate, certificateSize,
+            PUBLIC_FILE_MODE));
+    FFS_CHECK_RESULT(ffsWriteBatchFile(directory, PRIVATE_KEY_FILE_NAME, privateKey, privateKeySize,
+            PRIVATE_FILE_MODE));
+    FFS_CHECK_RESULT(ffsWriteBatchFile(directory, DEVICE_PUBLIC_KEY_FILE_NAME, devicePublicKey,
+            DER_PUBLIC_KEY_SIZE, PUBLIC_FILE_MODE));
+    FFS_CHECK_RESULT(ffsWriteBatchFile(directory, DEVICE_TYPE_KEY_FILE_NAME, batch->deviceTypeKey,
+            sizeof(batch->deviceTypeKey), PUBLIC_FILE_MODE));
+    FFS_CHECK_RESULT(ffsWriteBatchFile(directory, SETUP_CACHE_FILE_NAME, FFS_STREAM_NEXT_READ(cacheStream),
+            FFS_STREAM_DATA_SIZE(cacheStream), PRIVATE_FILE_MODE));
+    if (batch->rootCa) {
+        FFS_CHECK_RESULT(ffsWriteBatchFile(directory, ROOT_CA_FILE_NAME, batch->rootCa, batch->rootCaSize,
+                PUBLIC_FILE_MODE));
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Write the index of the batch as JSON.
+ */
+static FFS_RESULT ffsWriteBatchIndex(const FfsBatch_t *batch, uint32_t jobs, uint64_t elapsedMs)
+{
+    char path[PATH_MAX];
+    int pathLength = snprintf(path, sizeof(path), "%s/%s", batch->options->outputPath, INDEX_FILE_NAME);
+    if (pathLength < 0 || (size_t) pathLength >= sizeof(path)) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "Unable to open %s\n", path);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    size_t validCount = 0;
+    for (size_t i = 0; i < batch->deviceCount; i++) {
+        validCount += !batch->devices[i].error;
+    }
+
+    fprintf(file, "{\n  \"version\": %d,\n  \"devices\": %zu,\n  \"valid\": %zu,\n  \"invalid\": %zu,\n"
+            "  \"jobs\": %u,\n  \"elapsedMs\": %llu,\n  \"rootCa\": %s,\n  \"entries\": [",
+            BATCH_INDEX_VERSION, batch->deviceCount, validCount, batch->deviceCount - validCount, jobs,
+            (unsigned long long) elapsedMs, batch->rootCa ? "true" : "false");
+
+    // The device IDs and errors need no escaping.
+    for (size_t i = 0; i < batch->deviceCount; i++) {
+        const FfsBatchDevice_t *device = &batch->devices[i];
+
+        fprintf(file, "%s\n    {\"id\": \"%s\", ", i ? "," : "", device->deviceId);
+        if (device->error) {
+            fprintf(file, "\"status\": \"invalid\", \"error\": \"%s\"}", device->error);
+        } else {
+            fprintf(file, "\"status\": \"valid\", \"authMaterialIndex\": \"");
+            ffsWriteBatchHex(file, device->cache.authMaterialIndex, sizeof(device->cache.authMaterialIndex));
+            fprintf(file, "\", \"fingerprint\": \"");
+            ffsWriteBatchHex(file, device->cache.fingerprint, sizeof(device->cache.fingerprint));
+            fprintf(file, "\"}");
+        }
+    }
+
+    fprintf(file, "\n  ]\n}\n");
+
+    if (fclose(file)) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Read a whole file into a buffer.
+ */
+static FFS_RESULT ffsReadBatchFile(const char *path, uint8_t *buffer, size_t bufferSize, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return FFS_ERROR;
+    }
+
+    *size = fread(buffer, 1, bufferSize, file);
+    bool isComplete = !ferror(file) && feof(file);
+    fclose(file);
+
+    // A full buffer means the file may be larger.
+    if (!isComplete || !*size) {
+        return FFS_ERROR;
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Write a bundle file.
+ *
+ * The file is created with the given mode; the mode of a file left by an
+ * earlier run is reset too.
+ */
+static FFS_RESULT ffsWriteBatchFile(const char *directory, const char *name, const uint8_t *data, size_t size,
+        mode_t mode)
+{
+    char path[PATH_MAX];
+    int pathLength = snprintf(path, sizeof(path), "%s/%s", directory, name);
+    if (pathLength < 0 || (size_t) pathLength >= sizeof(path)) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    int descriptor = open(path, O_WRONLY | O_CREAT | O_TRUNC, mode);
+    if (descriptor < 0 || fchmod(descriptor, mode)) {
+        fprintf(stderr, "Unable to open %s\n", path);
+        if (descriptor >= 0) {
+            close(descriptor);
+        }
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    FILE *file = fdopen(descriptor, "wb");
+    if (!file) {
+        fprintf(stderr, "Unable to open %s\n", path);
+        close(descriptor);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    size_t writtenSize = fwrite(data, 1, size, file);
+    if (fclose(file) || writtenSize != size) {
+        fprintf(stderr, "Unable to write %s\n", path);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Resolve a manifest path against the manifest directory.
+ *
+ * A truncated path fails to open.
+ */
+static void ffsGetBatchPath(const FfsBatch_t *batch, const char *path, char *destination, size_t destinationSize)
+{
+    if (path[0] == '/') {
+        snprintf(destination, destinationSize, "%s", path);
+    } else {
+        snprintf(destination, destinationSize, "%s/%s", batch->manifestDirectory, path);
+    }
+}
+
+/** @brief Is a device ID safe to use as a directory name?
+ */
+static bool ffsIsValidBatchDeviceId(const char *deviceId)
+{
+    size_t length = strlen(deviceId);
+
+    if (!length || length > MAXIMUM_DEVICE_ID_LENGTH || deviceId[0] == '.') {
+        return false;
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        char character = deviceId[i];
+        if (!(character >= 'a' && character <= 'z') && !(character >= 'A' && character <= 'Z')
+                && !(character >= '0' && character <= '9') && character != '.' && character != '-'
+                && character != '_') {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** @brief Device ID order for qsort.
+ */
+static int ffsCompareBatchDeviceIds(const void *left, const void *right)
+{
+    const FfsBatchDevice_t *leftDevice = *(const FfsBatchDevice_t * const *) left;
+    const FfsBatchDevice_t *rightDevice = *(const FfsBatchDevice_t * const *) right;
+
+    return strcmp(leftDevice->deviceId, rightDevice->deviceId);
+}
+
+/** @brief Write bytes as lowercase hex.
+ */
+static void ffsWriteBatchHex(FILE *file, const uint8_t *data, size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        fprintf(file, "%02x", data[i]);
+    }
+}
+
+/** @brief Get the current monotonic time in milliseconds.
+ */
+static uint64_t ffsGetBatchTimeMs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
@@ -21,10 +21,15 @@
 extern "C" {
 #endif
 
+#include "ffs/common/ffs_dns_cache.h"
 #include "ffs/common/ffs_wifi.h"
 #include "ffs/compat/ffs_linux_configuration_map.h"
 #include "ffs/compat/ffs_user_context.h"
 #include "ffs/dss/ffs_dss_client.h"
+#include "ffs/linux/ffs_linux_crypto_cache.h"
+#include "ffs/linux/ffs_linux_dns_cache.h"
+#include "ffs/linux/ffs_linux_http_trace.h"
+#include "ffs/linux/ffs_network_impairment.h"
 #include "ffs/linux/ffs_wifi_context.h"
 #include "ffs/wifi_provisionee/ffs_wifi_provisionee_state.h"
 
@@ -55,12 +60,21 @@ typedef struct FfsUserContext_s {
 
     EVP_PKEY *devicePrivateKey;                   //!< Device private key.
     EVP_PKEY *devicePublicKey;                    //!< Device public key.
+    FfsLinuxCryptoCache_t cryptoCache;            //!< OpenSSL contexts and encodings for the keys above.
 
     uint8_t *hostNameBuffer;                      //!< DSS client host name buffer.
     uint8_t *sessionIdBuffer;                     //!< DSS client session ID buffer.
     uint8_t *nonceBuffer;                         //!< DSS client nonce buffer.
     uint8_t *bodyBuffer;                          //!< DSS client body buffer.
 
+    FfsDnsCache_t dnsCache;                       //!< DNS answer cache (disabled if the entries are not set).
+    FfsDnsCacheEntry_t dnsCacheEntries[FFS_LINUX_DNS_CACHE_ENTRY_COUNT]; //!< DNS answer cache records.
+    const char *dnsCachePath;                     //!< Path of the persisted DNS cache (NULL to disable persistence).
+    const char *provisioneeCheckpointPath;        //!< Path of the provisioning checkpoint (NULL to disable checkpoints).
+    FfsNetworkImpairment_t *networkImpairment;    //!< Emulated network impairment for HTTP requests (NULL for none).
+    FfsHttpTraceRecorder_t *httpTraceRecorder;    //!< Recorder for completed HTTP exchanges (NULL for none).
+    FfsHttpTraceReplay_t *httpTraceReplay;        //!< Recorded HTTP exchanges served instead of the network (NULL for none).
+
     pthread_t taskThread;                         //!< Thread for the main task.
     sem_t *ffsTaskWifiSemaphore;                  //!< Semaphore to block the Ffs Wi-Fi provisionee task on async Wi-Fi manager operations.
     sem_t *backgroundWifiScanSemaphore;           //!< Semaphore for waiting to get the scan list.
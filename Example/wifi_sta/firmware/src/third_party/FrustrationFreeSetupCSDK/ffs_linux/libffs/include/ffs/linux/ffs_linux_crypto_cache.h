@@ -0,0 +1,158 @@
+/** @file ffs_linux_crypto_cache.h
+ *
+ * @brief Per-user-context cache of OpenSSL keys and contexts.
+ *
+ * Signing, signature verification and ECDH are called with the same keys for
+ * the whole provisioning session. Rather than creating the OpenSSL contexts
+ * (and parsing the ECDH peer key) on every call, the cache keeps them
+ * initialized for the key they were made for, together with the DER
+ * encodings of the device and cloud public keys.
+ *
+ * Every entry holds a reference to its key and is rebuilt when it is asked
+ * for with a different key, so replacing a key in the user context never
+ * returns stale results. The references keep replaced keys alive until the
+ * entry is rebuilt or the cache is invalidated with
+ * @ref ffsInvalidateLinuxCryptoCache.
+ *
+ * The cache is not thread-safe: like the rest of the user context, it is
+ * used by one thread at a time.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#ifndef FFS_LINUX_CRYPTO_CACHE_H_
+#define FFS_LINUX_CRYPTO_CACHE_H_
+
+#include "ffs/common/ffs_result.h"
+#include "ffs/common/ffs_stream.h"
+
+#include <openssl/evp.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Largest cached DER encoded public key (a P-256 key is 91 bytes).
+ *
+ * Larger keys are still supported, just not cached.
+ */
+#define FFS_LINUX_CRYPTO_CACHE_MAXIMUM_DER_SIZE     (160)
+
+/** @brief Cached DER encoding of a public key.
+ */
+typedef struct {
+    EVP_PKEY *key;                                          //!< Encoded key (referenced; NULL if empty).
+    uint8_t der[FFS_LINUX_CRYPTO_CACHE_MAXIMUM_DER_SIZE];   //!< DER encoding.
+    size_t derSize;                                         //!< DER encoding size.
+} FfsLinuxCachedDerKey_t;
+
+/** @brief Cached SHA-256 digest sign or verify context.
+ */
+typedef struct {
+    EVP_PKEY *key;                                          //!< Signing or verification key (referenced; NULL if empty).
+    EVP_MD_CTX *initializedContext;                         //!< Context right after the digest initialization.
+    EVP_MD_CTX *context;                                    //!< Working copy handed out for each operation.
+} FfsLinuxCachedDigestContext_t;
+
+/** @brief Cached ECDH derivation context.
+ */
+typedef struct {
+    EVP_PKEY *privateKey;                                   //!< Own private key (referenced; NULL if empty).
+    uint8_t peerDer[FFS_LINUX_CRYPTO_CACHE_MAXIMUM_DER_SIZE]; //!< DER encoded peer public key.
+    size_t peerDerSize;                                     //!< Peer public key size (0 if not cached).
+    EVP_PKEY_CTX *context;                                  //!< Derivation context holding the parsed peer key.
+} FfsLinuxCachedDeriveContext_t;
+
+/** @brief Linux crypto cache.
+ *
+ * A zero-filled cache is a valid empty cache.
+ */
+typedef struct {
+    FfsLinuxCachedDigestContext_t signContext;              //!< Device private key signing context.
+    FfsLinuxCachedDigestContext_t verifyContext;            //!< Cloud public key verification context.
+    FfsLinuxCachedDeriveContext_t deriveContext;            //!< ECDH context.
+    FfsLinuxCachedDerKey_t devicePublicKeyDer;              //!< Device public key DER encoding.
+    FfsLinuxCachedDerKey_t cloudPublicKeyDer;               //!< Cloud public key DER encoding.
+} FfsLinuxCryptoCache_t;
+
+/** @brief Initialize an empty crypto cache.
+ *
+ * @param cache Crypto cache
+ */
+void ffsInitializeLinuxCryptoCache(FfsLinuxCryptoCache_t *cache);
+
+/** @brief Empty the crypto cache, releasing its contexts and key references.
+ *
+ * The cache stays usable and fills up again on the next operations.
+ *
+ * @param cache Crypto cache
+ */
+void ffsInvalidateLinuxCryptoCache(FfsLinuxCryptoCache_t *cache);
+
+/** @brief Get a SHA-256 signing context ready for the payload.
+ *
+ * The context is owned by the cache and valid until the next call.
+ *
+ * @param cache Crypto cache
+ * @param privateKey Signing key
+ * @param context Destination context
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsGetCachedSignContext(FfsLinuxCryptoCache_t *cache, EVP_PKEY *privateKey,
+        EVP_MD_CTX **context);
+
+/** @brief Get a SHA-256 verification context ready for the payload.
+ *
+ * The context is owned by the cache and valid until the next call.
+ *
+ * @param cache Crypto cache
+ * @param publicKey Verification key
+ * @param context Destination context
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsGetCachedVerifyContext(FfsLinuxCryptoCache_t *cache, EVP_PKEY *publicKey,
+        EVP_MD_CTX **context);
+
+/** @brief Get an ECDH derivation context for a DER encoded peer public key.
+ *
+ * The context is owned by the cache and valid until the next call.
+ *
+ * @param cache Crypto cache
+ * @param privateKey Own private key
+ * @param peerDerStream DER encoded peer public key (not consumed)
+ * @param context Destination context
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsGetCachedDeriveContext(FfsLinuxCryptoCache_t *cache, EVP_PKEY *privateKey,
+        FfsStream_t *peerDerStream, EVP_PKEY_CTX **context);
+
+/** @brief Write the DER encoding of a public key, encoding it only once.
+ *
+ * @param cachedKey Cached encoding (\a e.g., the device or cloud public key one)
+ * @param publicKey Public key
+ * @param derStream Destination stream for the DER encoded bytes
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsGetCachedDerEncodedPublicKey(FfsLinuxCachedDerKey_t *cachedKey, EVP_PKEY *publicKey,
+        FfsStream_t *derStream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FFS_LINUX_CRYPTO_CACHE_H_ */
@@ -0,0 +1,85 @@
+/** @file ffs_linux_dns_cache.h
+ *
+ * @brief Linux DNS answer cache persistence and clock.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#ifndef FFS_LINUX_DNS_CACHE_H_
+#define FFS_LINUX_DNS_CACHE_H_
+
+#include "ffs/common/ffs_dns_cache.h"
+#include "ffs/common/ffs_result.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of records in the Linux client DNS cache.
+ */
+#define FFS_LINUX_DNS_CACHE_ENTRY_COUNT     (8)
+
+/** @brief Time-to-live given to answers learned through libcurl.
+ *
+ * libcurl does not expose the record time-to-live, so use a conservative
+ * fixed value.
+ */
+#define FFS_LINUX_DNS_CACHE_TTL_MS          (5 * 60 * 1000)
+
+/** @brief Serialized cache buffer size (enough for every record at maximum length).
+ */
+#define FFS_LINUX_DNS_CACHE_BUFFER_SIZE     (2 + FFS_LINUX_DNS_CACHE_ENTRY_COUNT \
+        * (2 + FFS_DNS_CACHE_MAXIMUM_HOST_LENGTH + FFS_DNS_CACHE_MAXIMUM_ADDRESS_LENGTH + 8))
+
+/** @brief Get the current monotonic time in milliseconds for the DNS cache.
+ *
+ * @returns Milliseconds since an arbitrary point (wraps at 2^32)
+ */
+uint32_t ffsLinuxGetDnsCacheTimeMs(void);
+
+/** @brief Load a serialized DNS cache from a file.
+ *
+ * A missing file is not an error.
+ *
+ * @param cache DNS cache
+ * @param path File path
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsLinuxLoadDnsCache(FfsDnsCache_t *cache, const char *path);
+
+/** @brief Save the DNS cache to a file.
+ *
+ * @param cache DNS cache
+ * @param path File path
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsLinuxSaveDnsCache(FfsDnsCache_t *cache, const char *path);
+
+/** @brief Write a cache serialized with ffsDnsCacheSerialize to a file.
+ *
+ * Lets a caller serialize the cache under its own lock and write the file
+ * outside it.
+ *
+ * @param serializedStream Serialized cache
+ * @param path File path
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsLinuxWriteDnsCache(FfsStream_t *serializedStream, const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FFS_LINUX_DNS_CACHE_H_ */
@@ -0,0 +1,218 @@
+/** @file ffs_linux_http_trace.h
+ *
+ * @brief Record and replay of HTTP exchanges for the Linux HTTP client.
+ *
+ * A recorder appends every completed exchange (request, response, result and
+ * timings) to a compact binary trace file. A replay serves the recorded
+ * responses back in order without touching the network, checks that each new
+ * request body is semantically equal to the recorded one and patches the
+ * values that legitimately change from run to run: volatile request values
+ * (\a e.g. the nonce) echoed in the response are substituted, and responses
+ * that carried a DSS signature are re-signed with a test key. Together with
+ * a client configured to trust that key, a trace drives the provisionee
+ * through a recorded session deterministically.
+ *
+ * Trace file layout (integers little-endian):
+ *
+ *     "FFST" version:u8
+ *     exchange*:
+ *         gapMs:u32 durationMs:u32 operation:u8 scheme:u8 port:u16
+ *         result:i8 statusCode:i32 host:str path:str
+ *         requestHeaderCount:u8 (name:str value:str)* requestBody:blob
+ *         responseHeaderCount:u8 (name:str value:str)* responseBody:blob
+ *
+ * where str is a u16 length followed by the bytes and blob is a u32 length
+ * followed by the bytes.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#ifndef FFS_LINUX_HTTP_TRACE_H_
+#define FFS_LINUX_HTTP_TRACE_H_
+
+#include "ffs/common/ffs_result.h"
+
+#include <openssl/evp.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FFS_HTTP_TRACE_MAGIC                ("FFST")
+#define FFS_HTTP_TRACE_VERSION              (1)
+
+/** @brief Largest number of headers recorded per message.
+ */
+#define FFS_HTTP_TRACE_MAXIMUM_HEADER_COUNT (32)
+
+/** @brief Response header holding the DSS signature of the body.
+ */
+#define FFS_HTTP_TRACE_SIGNATURE_HEADER     ("x-amzn-dss-signature")
+
+/** @brief Recorded header.
+ */
+typedef struct {
+    char *name;                         //!< Header name (null-terminated).
+    char *value;                        //!< Header value (null-terminated).
+} FfsHttpTraceHeader_t;
+
+/** @brief Recorded HTTP exchange.
+ *
+ * All pointers are owned by the exchange.
+ */
+typedef struct {
+    uint32_t gapMs;                     //!< Client time between the previous completion and this request.
+    uint32_t durationMs;                //!< Time from the request to its completion.
+    uint8_t operation;                  //!< @ref FFS_HTTP_OPERATION.
+    uint8_t scheme;                     //!< @ref FFS_HTTP_SCHEME.
+    uint16_t port;                      //!< Port (0 for the scheme default).
+    int8_t result;                      //!< Completion @ref FFS_RESULT.
+    int32_t statusCode;                 //!< Response status code (0 if none).
+    char *host;                         //!< Host (null-terminated).
+    char *path;                         //!< Path (null-terminated, possibly empty).
+    uint8_t requestHeaderCount;         //!< Request header count.
+    FfsHttpTraceHeader_t requestHeaders[FFS_HTTP_TRACE_MAXIMUM_HEADER_COUNT]; //!< Request headers.
+    uint8_t *requestBody;               //!< Request body.
+    uint32_t requestBodySize;           //!< Request body size.
+    uint8_t responseHeaderCount;        //!< Response header count.
+    FfsHttpTraceHeader_t responseHeaders[FFS_HTTP_TRACE_MAXIMUM_HEADER_COUNT]; //!< Response headers.
+    uint8_t *responseBody;              //!< Response body.
+    uint32_t responseBodySize;          //!< Response body size.
+} FfsHttpTraceExchange_t;
+
+/** @brief Trace recorder.
+ *
+ * Exchanges are written by a single thread (the HTTP client event loop).
+ */
+typedef struct {
+    FILE *file;                         //!< Trace file.
+    uint64_t lastCompletionMs;          //!< When the previous exchange completed (0 for none).
+    uint32_t exchangeCount;             //!< Exchanges recorded.
+} FfsHttpTraceRecorder_t;
+
+/** @brief Trace replay.
+ *
+ * Not thread-safe; the HTTP client replays under its own lock.
+ */
+typedef struct {
+    FfsHttpTraceExchange_t *exchanges;  //!< Recorded exchanges.
+    uint32_t exchangeCount;             //!< Recorded exchange count.
+    uint32_t nextExchange;              //!< Index of the next exchange to serve.
+    uint32_t timeWarpPercent;           //!< Recorded durations are replayed at this percentage (0 for no delay).
+    bool isStrict;                      //!< Fail requests that do not match the recording?
+    EVP_PKEY *signingKey;               //!< Key re-signing signed responses (NULL to serve them unchanged).
+    const char * const *volatileKeys;   //!< NULL-terminated JSON keys ignored when comparing request bodies.
+    uint64_t lastCompletionMs;          //!< When the previous replayed exchange completed (0 for none).
+    uint32_t mismatchCount;             //!< Requests that did not match the recording.
+    uint64_t recordedGapMs;             //!< Sum of the recorded client gaps.
+    uint64_t replayedGapMs;             //!< Sum of the client gaps during the replay.
+} FfsHttpTraceReplay_t;
+
+/** @brief JSON keys whose values change between otherwise identical sessions.
+ */
+extern const char * const FFS_HTTP_TRACE_DEFAULT_VOLATILE_KEYS[];
+
+/** @brief Open a trace file for recording.
+ *
+ * @param recorder Recorder to initialize
+ * @param path Trace file path (truncated)
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsOpenHttpTraceRecorder(FfsHttpTraceRecorder_t *recorder, const char *path);
+
+/** @brief Append an exchange to the trace.
+ *
+ * @param recorder Recorder
+ * @param exchange Completed exchange
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsRecordHttpTraceExchange(FfsHttpTraceRecorder_t *recorder, const FfsHttpTraceExchange_t *exchange);
+
+/** @brief Close the trace file.
+ *
+ * @param recorder Recorder
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsCloseHttpTraceRecorder(FfsHttpTraceRecorder_t *recorder);
+
+/** @brief Load a trace file for replay.
+ *
+ * @param replay Replay to initialize
+ * @param path Trace file path
+ * @param timeWarpPercent Replay speed as a percentage of the recorded durations (0 for no delay)
+ * @param signingKey Key re-signing signed responses (NULL to serve them unchanged)
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsLoadHttpTrace(FfsHttpTraceReplay_t *replay, const char *path, uint32_t timeWarpPercent,
+        EVP_PKEY *signingKey);
+
+/** @brief Release a loaded trace.
+ *
+ * @param replay Replay
+ */
+void ffsFreeHttpTrace(FfsHttpTraceReplay_t *replay);
+
+/** @brief Release the contents of an exchange.
+ *
+ * @param exchange Exchange
+ */
+void ffsFreeHttpTraceExchange(FfsHttpTraceExchange_t *exchange);
+
+/** @brief Are two request bodies semantically equal?
+ *
+ * Whitespace outside JSON strings is ignored, as are the values of the
+ * volatile keys.
+ *
+ * @param recordedBody Recorded body
+ * @param recordedBodySize Recorded body size
+ * @param body New body
+ * @param bodySize New body size
+ * @param volatileKeys NULL-terminated keys to ignore (NULL for none)
+ *
+ * @returns True if equal
+ */
+bool ffsHttpTraceBodiesMatch(const uint8_t *recordedBody, size_t recordedBodySize, const uint8_t *body,
+        size_t bodySize, const char * const *volatileKeys);
+
+/** @brief Build the response to a replayed request.
+ *
+ * String values of volatile keys that changed between the recorded and the
+ * new request are substituted in the response body, and a signed response
+ * is re-signed with the signing key.
+ *
+ * @param replay Replay
+ * @param exchange Recorded exchange
+ * @param requestBody New request body
+ * @param requestBodySize New request body size
+ * @param responseBody Destination for the response body (caller frees)
+ * @param responseBodySize Destination for the response body size
+ * @param signature Destination for the base64 signature header value (caller frees, NULL if unsigned)
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsPrepareHttpTraceResponse(FfsHttpTraceReplay_t *replay, const FfsHttpTraceExchange_t *exchange,
+        const uint8_t *requestBody, size_t requestBodySize, uint8_t **responseBody, size_t *responseBodySize,
+        char **signature);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FFS_LINUX_HTTP_TRACE_H_ */
@@ -0,0 +1,135 @@
+/** @file ffs_network_impairment.h
+ *
+ * @brief Network impairment emulation for the Linux HTTP client.
+ *
+ * An impairment sits between the DSS client and the transport: for every
+ * HTTP request it draws a plan from a named profile (latency, bandwidth,
+ * read size and at most one injected fault), which the HTTP client then
+ * applies. Draws come from a seeded generator, so a profile and a seed give
+ * the same sequence of plans on every run.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#ifndef FFS_NETWORK_IMPAIRMENT_H_
+#define FFS_NETWORK_IMPAIRMENT_H_
+
+#include "ffs/common/ffs_result.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Largest response offset at which an injected reset is placed.
+ */
+#define FFS_NETWORK_IMPAIRMENT_MAXIMUM_RESET_OFFSET     (512)
+
+/** @brief Latency distributions.
+ */
+typedef enum {
+    FFS_NETWORK_LATENCY_FIXED = 0,      //!< Always the base latency.
+    FFS_NETWORK_LATENCY_UNIFORM,        //!< Uniform between the base and the base plus the spread.
+    FFS_NETWORK_LATENCY_EXPONENTIAL     //!< Base plus an exponential tail with the spread as its mean.
+} FFS_NETWORK_LATENCY_DISTRIBUTION;
+
+/** @brief Injected faults.
+ */
+typedef enum {
+    FFS_NETWORK_FAULT_NONE = 0,         //!< Deliver the request.
+    FFS_NETWORK_FAULT_DNS_FAILURE,      //!< Fail to resolve the host.
+    FFS_NETWORK_FAULT_RESET,            //!< Reset the connection, possibly part way through the response.
+    FFS_NETWORK_FAULT_STALL             //!< Send the request but never answer, then drop the connection.
+} FFS_NETWORK_FAULT;
+
+/** @brief Impairment profile.
+ *
+ * Probabilities are per request, in parts per thousand. At most one fault
+ * is injected per request.
+ */
+typedef struct {
+    const char *name;                   //!< Profile name (\a e.g. "crowded-2.4ghz").
+    const char *description;            //!< Human readable description.
+    FFS_NETWORK_LATENCY_DISTRIBUTION latencyDistribution; //!< Latency distribution.
+    uint32_t latencyBaseMs;             //!< Minimum latency added before a request starts.
+    uint32_t latencySpreadMs;           //!< Latency spread (distribution dependent).
+    uint32_t bandwidthBytesPerSecond;   //!< Transfer rate cap in each direction (0 for none).
+    uint32_t maximumReadSize;           //!< Largest response chunk handed to the body callback (0 for no limit).
+    uint16_t dnsFailurePerMille;        //!< DNS failure probability.
+    uint16_t resetPerMille;             //!< Connection reset probability.
+    uint16_t stallPerMille;             //!< Stalled response probability.
+    uint32_t stallMs;                   //!< How long a stalled response holds the connection.
+} FfsNetworkImpairmentProfile_t;
+
+/** @brief Impairment applied to one request.
+ */
+typedef struct {
+    uint32_t delayMs;                   //!< Latency before the request starts.
+    FFS_NETWORK_FAULT fault;            //!< Injected fault.
+    uint32_t resetOffset;               //!< Response body bytes delivered before a reset.
+    uint32_t stallMs;                   //!< How long a stall holds the connection.
+    uint32_t bandwidthBytesPerSecond;   //!< Transfer rate cap (0 for none).
+    uint32_t maximumReadSize;           //!< Largest body chunk (0 for no limit).
+} FfsNetworkImpairmentPlan_t;
+
+/** @brief Network impairment state.
+ *
+ * Not thread-safe; the HTTP client draws plans under its own lock.
+ */
+typedef struct {
+    const FfsNetworkImpairmentProfile_t *profile; //!< Active profile.
+    uint64_t randomState;               //!< Generator state.
+    uint32_t requestCount;              //!< Plans drawn.
+    uint32_t dnsFailureCount;           //!< DNS failures injected.
+    uint32_t resetCount;                //!< Resets injected.
+    uint32_t stallCount;                //!< Stalls injected.
+} FfsNetworkImpairment_t;
+
+/** @brief Built-in profiles, terminated by a NULL name.
+ */
+extern const FfsNetworkImpairmentProfile_t FFS_NETWORK_IMPAIRMENT_PROFILES[];
+
+/** @brief Find a built-in profile by name.
+ *
+ * @param name Profile name
+ * @param profile Destination for the profile
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsFindNetworkImpairmentProfile(const char *name, const FfsNetworkImpairmentProfile_t **profile);
+
+/** @brief Initialize an impairment.
+ *
+ * @param impairment Impairment to initialize
+ * @param profile Profile to apply
+ * @param seed Generator seed
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsInitializeNetworkImpairment(FfsNetworkImpairment_t *impairment,
+        const FfsNetworkImpairmentProfile_t *profile, uint32_t seed);
+
+/** @brief Draw the impairment for the next request.
+ *
+ * @param impairment Impairment
+ * @param plan Destination for the plan
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsPlanNetworkImpairment(FfsNetworkImpairment_t *impairment, FfsNetworkImpairmentPlan_t *plan);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FFS_NETWORK_IMPAIRMENT_H_ */
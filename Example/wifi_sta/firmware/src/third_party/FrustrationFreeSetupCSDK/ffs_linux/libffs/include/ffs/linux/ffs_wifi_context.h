@@ -42,6 +42,7 @@ typedef struct FfsWifiContext_s {
     FfsLinkedList_t connectionAttemptList; //!< Wi-Fi connection attempts.
     const char *interface; //!< Wi-Fi interface to use (\a e.g. "wlan0").
     const char *driver; //!< Wi-Fi driver to use (\a e.g. "wext").
+    const char *wpaControlPath; //!< WPA supplicant control socket (\a e.g. "/var/run/wpa_supplicant/wlan0"); NULL to use the shell tools.
     uint8_t ssidBuffer[FFS_MAXIMUM_SSID_SIZE]; //!< Buffer for the connection details SSID.
     FfsWifiConnectionDetails_t connectionDetails; //!< Current Wi-Fi connection state.
 } FfsLinuxWifiContext_t;
@@ -0,0 +1,167 @@
+/** @file ffs_raspbian_wpa_ctrl.h
+ *
+ * @brief Raspbian Wi-Fi management over the WPA supplicant control socket.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#ifndef FFS_RASPBIAN_WPA_CTRL_H_
+#define FFS_RASPBIAN_WPA_CTRL_H_
+
+#include "ffs/common/ffs_result.h"
+#include "ffs/common/ffs_wifi.h"
+#include "ffs/linux/ffs_wifi_context.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FFS_WPA_CTRL_MAXIMUM_PATH_SIZE      (108) //!< Size of \a sun_path.
+#define FFS_WPA_CTRL_MAXIMUM_MESSAGE_SIZE   (8192) //!< Largest reply or event we read.
+#define FFS_WPA_CTRL_REQUEST_TIMEOUT_MILLI  (2000)
+#define FFS_WPA_CTRL_SCAN_TIMEOUT_MILLI     (10000)
+
+/** @brief WPA supplicant control interface connection.
+ *
+ * Two datagram sockets connected to the supplicant's per-interface control
+ * socket: one for request/reply pairs and one attached for unsolicited
+ * events, the same split used by \a wpa_cli.
+ */
+typedef struct {
+    int commandSocket; //!< Request/reply socket.
+    int monitorSocket; //!< Attached event socket.
+    char commandPath[FFS_WPA_CTRL_MAXIMUM_PATH_SIZE]; //!< Local address of the request socket.
+    char monitorPath[FFS_WPA_CTRL_MAXIMUM_PATH_SIZE]; //!< Local address of the event socket.
+    int networkId; //!< Supplicant network added by the last connection; -1 if none.
+} FfsRaspbianWpaCtrl_t;
+
+/** @brief Open a control interface connection and attach for events.
+ *
+ * @param ctrl Control interface connection
+ * @param controlPath Supplicant control socket (\a e.g. "/var/run/wpa_supplicant/wlan0")
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsRaspbianWpaCtrlOpen(FfsRaspbianWpaCtrl_t *ctrl, const char *controlPath);
+
+/** @brief Close a control interface connection.
+ *
+ * @param ctrl Control interface connection
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsRaspbianWpaCtrlClose(FfsRaspbianWpaCtrl_t *ctrl);
+
+/** @brief Send a command and wait for its reply.
+ *
+ * The reply is null-terminated. A "FAIL" reply is returned as-is; callers
+ * decide what it means for their command.
+ *
+ * @param ctrl Control interface connection
+ * @param command Null-terminated command
+ * @param reply Destination reply buffer
+ * @param replySize Size of the reply buffer
+ * @param timeoutMs Timeout in milliseconds
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT); @ref FFS_TIMEOUT if no reply arrives
+ */
+FFS_RESULT ffsRaspbianWpaCtrlRequest(FfsRaspbianWpaCtrl_t *ctrl, const char *command,
+        char *reply, size_t replySize, int32_t timeoutMs);
+
+/** @brief Wait for one of a set of events.
+ *
+ * Events are matched by prefix after the "<level>" marker; other events
+ * are discarded.
+ *
+ * @param ctrl Control interface connection
+ * @param events Event name prefixes (\a e.g. "CTRL-EVENT-CONNECTED")
+ * @param eventCount Number of prefixes
+ * @param timeoutMs Timeout in milliseconds
+ * @param eventIndex Destination index of the matched prefix
+ * @param event Destination for the matched event text (optional)
+ * @param eventSize Size of the event buffer
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT); @ref FFS_TIMEOUT if nothing matched
+ */
+FFS_RESULT ffsRaspbianWpaCtrlWaitForEvent(FfsRaspbianWpaCtrl_t *ctrl, const char *const *events,
+        size_t eventCount, int32_t timeoutMs, size_t *eventIndex, char *event, size_t eventSize);
+
+/** @brief Scan and replace the scan list with the supplicant's results.
+ *
+ * @param ctrl Control interface connection
+ * @param wifiContext Wi-Fi context
+ * @param ssidStream SSID to probe for, or NULL for a broadcast scan
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsRaspbianWpaCtrlScan(FfsRaspbianWpaCtrl_t *ctrl, FfsLinuxWifiContext_t *wifiContext,
+        FfsStream_t *ssidStream);
+
+/** @brief Configure a network and wait for the connection outcome.
+ *
+ * Connection failures are recorded in the Wi-Fi context connection details;
+ * only internal errors are returned.
+ *
+ * @param ctrl Control interface connection
+ * @param wifiContext Wi-Fi context
+ * @param configuration Wi-Fi configuration
+ * @param timeoutMs Timeout in milliseconds
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsRaspbianWpaCtrlConnect(FfsRaspbianWpaCtrl_t *ctrl, FfsLinuxWifiContext_t *wifiContext,
+        FfsWifiConfiguration_t *configuration, int32_t timeoutMs);
+
+/** @brief Disconnect and wait for the supplicant to report it.
+ *
+ * @param ctrl Control interface connection
+ * @param timeoutMs Timeout in milliseconds
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsRaspbianWpaCtrlDisconnect(FfsRaspbianWpaCtrl_t *ctrl, int32_t timeoutMs);
+
+/** @brief Get the Wi-Fi connection state from the supplicant status.
+ *
+ * @param ctrl Control interface connection
+ * @param state Destination connection state
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsRaspbianWpaCtrlGetConnectionState(FfsRaspbianWpaCtrl_t *ctrl, FFS_WIFI_CONNECTION_STATE *state);
+
+/** @brief Process a "SCAN_RESULTS" reply into the scan list.
+ *
+ * @param wifiContext Wi-Fi context
+ * @param reply Null-terminated reply; modified in place
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsRaspbianWpaCtrlProcessScanResults(FfsLinuxWifiContext_t *wifiContext, char *reply);
+
+/** @brief Process a "STATUS" reply into a connection state.
+ *
+ * @param reply Null-terminated reply
+ * @param state Destination connection state
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsRaspbianWpaCtrlProcessStatus(const char *reply, FFS_WIFI_CONNECTION_STATE *state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FFS_RASPBIAN_WPA_CTRL_H_ */
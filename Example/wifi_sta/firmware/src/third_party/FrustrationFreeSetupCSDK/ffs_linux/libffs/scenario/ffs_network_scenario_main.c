@@ -0,0 +1,653 @@
+/** @file ffs_network_scenario_main.c
+ *
+ * @brief Provisioning scenario runner for the network impairment profiles.
+ *
+ * Replays the DSS request sequence of a Wi-Fi provisioning against a local
+ * HTTP server through the Linux HTTP client, with each network impairment
+ * profile in turn, and reports the time to provisioned and the failure rate.
+ * The impairment draws are seeded, so changes to the retry and timeout
+ * policy can be compared on the same sequence of faults.
+ *
+ * Usage: network_scenarios [--profile NAME]... [--runs COUNT] [--seed SEED]
+ *                          [--attempts COUNT] [--timeout MILLISECONDS]
+ *                          [--backoff MILLISECONDS] [--time-scale PERCENT]
+ *                          [--output FILE] [--list]
+ *
+ * Exit status: 0 on success and 2 on error (failed provisionings are
+ * results, not errors).
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_check_result.h"
+#include "ffs/common/ffs_http.h"
+#include "ffs/compat/ffs_common_compat.h"
+#include "ffs/compat/ffs_linux_logging.h"
+#include "ffs/compat/ffs_linux_user_context.h"
+#include "ffs/linux/ffs_network_impairment.h"
+
+#include <arpa/inet.h>
+#include <getopt.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SCENARIO_RESULTS_VERSION        (1)
+#define DEFAULT_RUNS                    (10)
+#define DEFAULT_SEED                    (1)
+#define DEFAULT_ATTEMPTS                (3)
+#define DEFAULT_TIMEOUT_MS              (10000)
+#define DEFAULT_BACKOFF_MS              (500)
+#define DEFAULT_TIME_SCALE_PERCENT      (100)
+#define MAXIMUM_PROFILES                (16)
+#define MAXIMUM_RUNS                    (10000)
+#define MAXIMUM_BODY_SIZE               (2048)
+#define MAXIMUM_REQUEST_SIZE            (4096)
+#define SERVER_POLL_MS                  (50)
+#define SERVER_SOCKET_TIMEOUT_S         (5)
+#define SCENARIO_HOST                   "127.0.0.1"
+
+#define EXIT_ERROR                      (2)
+
+/** @brief One DSS exchange of the provisioning sequence.
+ */
+typedef struct {
+    const char *path; //!< Request path (also selects the response size).
+    size_t requestSize; //!< Request body size.
+    size_t responseSize; //!< Response body size.
+} FfsScenarioStep_t;
+
+/** @brief Runner options.
+ */
+typedef struct {
+    const char *profileNames[MAXIMUM_PROFILES]; //!< Profiles to run (all if none).
+    size_t profileCount; //!< Number of profile names.
+    uint32_t runs; //!< Provisionings per profile.
+    uint32_t seed; //!< Impairment seed.
+    uint32_t attempts; //!< Attempts per request.
+    uint32_t timeoutMs; //!< Per-attempt timeout.
+    uint32_t backoffMs; //!< Delay before the first retry (doubled for each further retry).
+    uint32_t timeScalePercent; //!< Scale applied to every profile and policy duration.
+    const char *outputPath; //!< Results file (NULL for no JSON).
+} FfsScenarioOptions_t;
+
+/** @brief Results for one profile.
+ */
+typedef struct {
+    const char *profileName; //!< Profile name.
+    uint32_t runs; //!< Provisionings attempted.
+    uint32_t provisionedCount; //!< Provisionings that completed.
+    uint32_t requestCount; //!< Requests sent.
+    uint32_t retryCount; //!< Retried requests.
+    uint32_t timeoutCount; //!< Requests that timed out.
+    uint32_t errorCount; //!< Requests that failed otherwise.
+    uint32_t dnsFailureCount; //!< Injected DNS failures.
+    uint32_t resetCount; //!< Injected resets.
+    uint32_t stallCount; //!< Injected stalls.
+    uint32_t medianMs; //!< Median time to provisioned.
+    uint32_t p90Ms; //!< 90th percentile time to provisioned.
+    uint32_t maximumMs; //!< Slowest provisioning.
+} FfsScenarioResult_t;
+
+/** @brief Local DSS stand-in.
+ */
+typedef struct {
+    int socketFd; //!< Listening socket.
+    uint16_t port; //!< Bound port.
+    volatile bool isStopping; //!< Set to stop the server thread.
+    pthread_t thread; //!< Server thread.
+} FfsScenarioServer_t;
+
+/** @brief Response callback data.
+ */
+typedef struct {
+    int32_t statusCode; //!< Response status code.
+    size_t bodySize; //!< Response body bytes received.
+} FfsScenarioResponse_t;
+
+/** @brief DSS requests of one provisioning, with typical body sizes.
+ */
+static const FfsScenarioStep_t PROVISIONING_STEPS[] = {
+    { "startProvisioningSession", 350, 420 },
+    { "startPinBasedSetup", 250, 180 },
+    { "computeConfigurationData", 300, 1100 },
+    { "report", 450, 120 },
+    { "postWifiScanData", 1600, 160 },
+    { "getWifiCredentials", 220, 640 },
+    { "report", 450, 120 },
+    { NULL, 0, 0 }
+};
+
+static uint8_t requestBody[MAXIMUM_BODY_SIZE];
+
+// Static function prototypes.
+static FFS_RESULT ffsParseScenarioCommandLine(int argc, char **argv, FfsScenarioOptions_t *options);
+static FFS_RESULT ffsRunScenarioProfile(const FfsScenarioOptions_t *options, const FfsScenarioServer_t *server,
+        const FfsNetworkImpairmentProfile_t *profile, FfsScenarioResult_t *result);
+static FFS_RESULT ffsRunScenarioStep(const FfsScenarioOptions_t *options, const FfsScenarioServer_t *server,
+        FfsUserContext_t *userContext, const FfsScenarioStep_t *step, FfsScenarioResult_t *result,
+        bool *isSuccessful);
+static FFS_RESULT ffsHandleScenarioStatusCode(int32_t statusCode, void *callbackDataPointer);
+static FFS_RESULT ffsHandleScenarioBody(FfsStream_t *bodyStream, void *callbackDataPointer);
+static FFS_RESULT ffsWriteScenarioResults(const FfsScenarioOptions_t *options,
+        const FfsScenarioResult_t *results, size_t resultCount);
+static FFS_RESULT ffsStartScenarioServer(FfsScenarioServer_t *server);
+static void ffsStopScenarioServer(FfsScenarioServer_t *server);
+static void *ffsRunScenarioServer(void *argument);
+static void ffsServeScenarioConnection(int connectionFd);
+static size_t ffsGetScenarioResponseSize(const char *request);
+static uint32_t ffsScaleScenarioDuration(const FfsScenarioOptions_t *options, uint32_t durationMs);
+static uint64_t ffsGetScenarioTimeMs(void);
+static void ffsSleepScenarioMs(uint32_t durationMs);
+static int ffsCompareDurations(const void *left, const void *right);
+
+int main(int argc, char **argv)
+{
+    FfsScenarioOptions_t options = {
+        .runs = DEFAULT_RUNS,
+        .seed = DEFAULT_SEED,
+        .attempts = DEFAULT_ATTEMPTS,
+        .timeoutMs = DEFAULT_TIMEOUT_MS,
+        .backoffMs = DEFAULT_BACKOFF_MS,
+        .timeScalePercent = DEFAULT_TIME_SCALE_PERCENT
+    };
+    if (ffsParseScenarioCommandLine(argc, argv, &options)) {
+        return EXIT_ERROR;
+    }
+
+    // Keep the per-request logging out of the report.
+    ffsSetLogLevel(FFS_LOG_LEVEL_ERROR);
+
+    // Resolve the profiles.
+    const FfsNetworkImpairmentProfile_t *profiles[MAXIMUM_PROFILES];
+    size_t profileCount = 0;
+    if (options.profileCount) {
+        for (size_t i = 0; i < options.profileCount; i++) {
+            if (ffsFindNetworkImpairmentProfile(options.profileNames[i], &profiles[profileCount++])) {
+                fprintf(stderr, "Unknown profile %s (see --list)\n", options.profileNames[i]);
+                return EXIT_ERROR;
+            }
+        }
+    } else {
+        for (const FfsNetworkImpairmentProfile_t *profile = FFS_NETWORK_IMPAIRMENT_PROFILES;
+                profile->name && profileCount < MAXIMUM_PROFILES; profile++) {
+            profiles[profileCount++] = profile;
+        }
+    }
+
+    memset(requestBody, 'x', sizeof(requestBody));
+
+    FfsScenarioServer_t server;
+    if (ffsStartScenarioServer(&server)) {
+        fprintf(stderr, "Unable to start the local server\n");
+        return EXIT_ERROR;
+    }
+
+    printf("%-18s %5s %8s %8s %9s %9s %9s %8s %8s %6s %6s %6s\n", "profile", "runs", "failed%",
+            "requests", "median_ms", "p90_ms", "max_ms", "retries", "timeouts", "dns", "reset", "stall");
+
+    FfsScenarioResult_t results[MAXIMUM_PROFILES];
+    int exitStatus = EXIT_SUCCESS;
+    for (size_t i = 0; i < profileCount; i++) {
+        if (ffsRunScenarioProfile(&options, &server, profiles[i], &results[i])) {
+            fprintf(stderr, "Profile %s failed\n", profiles[i]->name);
+            exitStatus = EXIT_ERROR;
+            break;
+        }
+
+        const FfsScenarioResult_t *result = &results[i];
+        printf("%-18s %5u %7.1f%% %8u %9u %9u %9u %8u %8u %6u %6u %6u\n", result->profileName,
+                result->runs, 100.0 * (result->runs - result->provisionedCount) / result->runs,
+                result->requestCount, result->medianMs, result->p90Ms, result->maximumMs, result->retryCount,
+                result->timeoutCount, result->dnsFailureCount, result->resetCount, result->stallCount);
+    }
+
+    ffsStopScenarioServer(&server);
+
+    if (exitStatus == EXIT_SUCCESS && options.outputPath
+            && ffsWriteScenarioResults(&options, results, profileCount)) {
+        exitStatus = EXIT_ERROR;
+    }
+
+    return exitStatus;
+}
+
+/** @brief Parse the command line.
+ */
+static FFS_RESULT ffsParseScenarioCommandLine(int argc, char **argv, FfsScenarioOptions_t *options)
+{
+    static const struct option LONG_OPTIONS[] = {
+        { "profile", required_argument, NULL, 'p' },
+        { "runs", required_argument, NULL, 'n' },
+        { "seed", required_argument, NULL, 's' },
+        { "attempts", required_argument, NULL, 'a' },
+        { "timeout", required_argument, NULL, 't' },
+        { "backoff", required_argument, NULL, 'b' },
+        { "time-scale", required_argument, NULL, 'x' },
+        { "output", required_argument, NULL, 'o' },
+        { "list", no_argument, NULL, 'l' },
+        { NULL, 0, NULL, 0 }
+    };
+
+    int option;
+    while ((option = getopt_long(argc, argv, "p:n:s:a:t:b:x:o:l", LONG_OPTIONS, NULL)) != -1) {
+        switch (option) {
+            case 'p':
+                if (options->profileCount == MAXIMUM_PROFILES) {
+                    fprintf(stderr, "Too many profiles\n");
+                    FFS_FAIL(FFS_ERROR);
+                }
+                options->profileNames[options->profileCount++] = optarg;
+                break;
+            case 'n':
+                options->runs = (uint32_t) strtoul(optarg, NULL, 10);
+                break;
+            case 's':
+                options->seed = (uint32_t) strtoul(optarg, NULL, 0);
+                break;
+            case 'a':
+                options->attempts = (uint32_t) strtoul(optarg, NULL, 10);
+                break;
+            case 't':
+                options->timeoutMs = (uint32_t) strtoul(optarg, NULL, 10);
+                break;
+            case 'b':
+                options->backoffMs = (uint32_t) strtoul(optarg, NULL, 10);
+                break;
+            case 'x':
+                options->timeScalePercent = (uint32_t) strtoul(optarg, NULL, 10);
+                break;
+            case 'o':
+                options->outputPath = optarg;
+                break;
+            case 'l':
+                for (const FfsNetworkImpairmentProfile_t *profile = FFS_NETWORK_IMPAIRMENT_PROFILES;
+                        profile->name; profile++) {
+                    printf("%-18s %s\n", profile->name, profile->description);
+                }
+                exit(EXIT_SUCCESS);
+            default:
+                fprintf(stderr, "Usage: %s [--profile NAME]... [--runs COUNT] [--seed SEED] "
+                        "[--attempts COUNT] [--timeout MILLISECONDS] [--backoff MILLISECONDS] "
+                        "[--time-scale PERCENT] [--output FILE] [--list]\n", argv[0]);
+                FFS_FAIL(FFS_ERROR);
+        }
+    }
+
+    if (!options->runs || options->runs > MAXIMUM_RUNS || !options->attempts || !options->timeoutMs
+            || !options->timeScalePercent) {
+        fprintf(stderr, "Invalid scenario options\n");
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Run every provisioning of one profile.
+ */
+static FFS_RESULT ffsRunScenarioProfile(const FfsScenarioOptions_t *options, const FfsScenarioServer_t *server,
+        const FfsNetworkImpairmentProfile_t *profile, FfsScenarioResult_t *result)
+{
+    // Scale the profile durations with the policy durations.
+    FfsNetworkImpairmentProfile_t scaledProfile = *profile;
+    scaledProfile.latencyBaseMs = ffsScaleScenarioDuration(options, profile->latencyBaseMs);
+    scaledProfile.latencySpreadMs = ffsScaleScenarioDuration(options, profile->latencySpreadMs);
+    scaledProfile.stallMs = ffsScaleScenarioDuration(options, profile->stallMs);
+
+    FfsNetworkImpairment_t impairment;
+    FFS_CHECK_RESULT(ffsInitializeNetworkImpairment(&impairment, &scaledProfile, options->seed));
+
+    // The HTTP client only needs the impairment (plain HTTP, no DNS cache).
+    FfsUserContext_t userContext;
+    memset(&userContext, 0, sizeof(userContext));
+    userContext.networkImpairment = &impairment;
+
+    uint32_t *durations = (uint32_t *) calloc(options->runs, sizeof(*durations));
+    if (!durations) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    memset(result, 0, sizeof(*result));
+    result->profileName = profile->name;
+    result->runs = options->runs;
+
+    FFS_RESULT runResult = FFS_SUCCESS;
+    for (uint32_t run = 0; run < options->runs && runResult == FFS_SUCCESS; run++) {
+        uint64_t startMs = ffsGetScenarioTimeMs();
+        bool isSuccessful = true;
+
+        for (const FfsScenarioStep_t *step = PROVISIONING_STEPS; step->path && isSuccessful; step++) {
+            runResult = ffsRunScenarioStep(options, server, &userContext, step, result, &isSuccessful);
+            if (runResult != FFS_SUCCESS) {
+                break;
+            }
+        }
+
+        if (isSuccessful && runResult == FFS_SUCCESS) {
+            durations[result->provisionedCount++] = (uint32_t) (ffsGetScenarioTimeMs() - startMs);
+        }
+    }
+
+    result->dnsFailureCount = impairment.dnsFailureCount;
+    result->resetCount = impairment.resetCount;
+    result->stallCount = impairment.stallCount;
+
+    if (result->provisionedCount) {
+        qsort(durations, result->provisionedCount, sizeof(*durations), ffsCompareDurations);
+        result->medianMs = durations[result->provisionedCount / 2];
+        result->p90Ms = durations[(result->provisionedCount * 9) / 10];
+        result->maximumMs = durations[result->provisionedCount - 1];
+    }
+
+    free(durations);
+
+    return runResult;
+}
+
+/** @brief Send one DSS request, retrying with exponential backoff.
+ */
+static FFS_RESULT ffsRunScenarioStep(const FfsScenarioOptions_t *options, const FfsScenarioServer_t *server,
+        FfsUserContext_t *userContext, const FfsScenarioStep_t *step, FfsScenarioResult_t *result,
+        bool *isSuccessful)
+{
+    uint32_t backoffMs = ffsScaleScenarioDuration(options, options->backoffMs);
+    uint32_t timeoutMs = ffsScaleScenarioDuration(options, options->timeoutMs);
+
+    *isSuccessful = false;
+
+    for (uint32_t attempt = 0; attempt < options->attempts; attempt++) {
+        if (attempt) {
+            result->retryCount++;
+            ffsSleepScenarioMs(backoffMs);
+            backoffMs *= 2;
+        }
+
+        FfsScenarioResponse_t response = { 0 };
+        FfsHttpRequest_t request = {
+            .operation = FFS_HTTP_OPERATION_POST,
+            .url = {
+                .scheme = FFS_HTTP_SCHEME_HTTP,
+                .port = server->port,
+                .hostStream = ffsCreateInputStream((uint8_t *) SCENARIO_HOST, strlen(SCENARIO_HOST)),
+                .path = step->path
+            },
+            .bodyStream = ffsCreateInputStream(requestBody, step->requestSize),
+            .callbacks = {
+                .handleStatusCode = ffsHandleScenarioStatusCode,
+                .handleBody = ffsHandleScenarioBody
+            }
+        };
+
+        FfsHttpOperation_t *operation;
+        FFS_CHECK_RESULT(ffsHttpExecuteAsync(userContext, &request, &response, timeoutMs, NULL, &operation));
+        FFS_RESULT requestResult = ffsHttpWait(userContext, operation);
+        result->requestCount++;
+
+        if (requestResult == FFS_TIMEOUT) {
+            result->timeoutCount++;
+        } else if (requestResult != FFS_SUCCESS || response.statusCode != 200
+                || response.bodySize != step->responseSize) {
+            result->errorCount++;
+        } else {
+            *isSuccessful = true;
+            break;
+        }
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Save the response status code.
+ */
+static FFS_RESULT ffsHandleScenarioStatusCode(int32_t statusCode, void *callbackDataPointer)
+{
+    FfsScenarioResponse_t *response = (FfsScenarioResponse_t *) callbackDataPointer;
+
+    response->statusCode = statusCode;
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Count the response body (delivered in pieces on impaired profiles).
+ */
+static FFS_RESULT ffsHandleScenarioBody(FfsStream_t *bodyStream, void *callbackDataPointer)
+{
+    FfsScenarioResponse_t *response = (FfsScenarioResponse_t *) callbackDataPointer;
+
+    response->bodySize += FFS_STREAM_DATA_SIZE(*bodyStream);
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Write the results as JSON.
+ */
+static FFS_RESULT ffsWriteScenarioResults(const FfsScenarioOptions_t *options,
+        const FfsScenarioResult_t *results, size_t resultCount)
+{
+    FILE *file = fopen(options->outputPath, "w");
+    if (!file) {
+        fprintf(stderr, "Unable to open %s\n", options->outputPath);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    fprintf(file, "{\n  \"version\": %d,\n  \"seed\": %u,\n  \"runs\": %u,\n  \"attempts\": %u,\n"
+            "  \"timeoutMs\": %u,\n  \"backoffMs\": %u,\n  \"timeScalePercent\": %u,\n  \"profiles\": [",
+            SCENARIO_RESULTS_VERSION, options->seed, options->runs, options->attempts, options->timeoutMs,
+            options->backoffMs, options->timeScalePercent);
+
+    for (size_t i = 0; i < resultCount; i++) {
+        const FfsScenarioResult_t *result = &results[i];
+
+        fprintf(file, "%s\n    {\"name\": \"%s\", \"runs\": %u, \"provisioned\": %u, "
+                "\"failureRate\": %.4f, \"medianTimeToProvisionedMs\": %u, \"p90TimeToProvisionedMs\": %u, "
+                "\"maximumTimeToProvisionedMs\": %u, \"requests\": %u, \"retries\": %u, \"timeouts\": %u, "
+                "\"errors\": %u, \"dnsFailures\": %u, \"resets\": %u, \"stalls\": %u}",
+                i ? "," : "", result->profileName, result->runs, result->provisionedCount,
+                (double) (result->runs - result->provisionedCount) / result->runs, result->medianMs,
+                result->p90Ms, result->maximumMs, result->requestCount, result->retryCount,
+                result->timeoutCount, result->errorCount, result->dnsFailureCount, result->resetCount,
+                result->stallCount);
+    }
+
+    fprintf(file, "\n  ]\n}\n");
+
+    if (fclose(file)) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Listen on an ephemeral loopback port and start the server thread.
+ */
+static FFS_RESULT ffsStartScenarioServer(FfsScenarioServer_t *server)
+{
+    memset(server, 0, sizeof(*server));
+
+    server->socketFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (server->socketFd < 0) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    struct sockaddr_in address;
+    socklen_t addressSize = sizeof(address);
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(server->socketFd, (struct sockaddr *) &address, sizeof(address))
+            || listen(server->socketFd, 8)
+            || getsockname(server->socketFd, (struct sockaddr *) &address, &addressSize)
+            || pthread_create(&server->thread, NULL, ffsRunScenarioServer, server)) {
+        close(server->socketFd);
+        FFS_FAIL(FFS_ERROR);
+    }
+    server->port = ntohs(address.sin_port);
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Stop the server thread and close the socket.
+ */
+static void ffsStopScenarioServer(FfsScenarioServer_t *server)
+{
+    server->isStopping = true;
+    pthread_join(server->thread, NULL);
+    close(server->socketFd);
+}
+
+/** @brief Server thread: answer one connection at a time.
+ */
+static void *ffsRunScenarioServer(void *argument)
+{
+    FfsScenarioServer_t *server = (FfsScenarioServer_t *) argument;
+
+    while (!server->isStopping) {
+        struct pollfd pollFd = { server->socketFd, POLLIN, 0 };
+        if (poll(&pollFd, 1, SERVER_POLL_MS) <= 0) {
+            continue;
+        }
+
+        int connectionFd = accept(server->socketFd, NULL, NULL);
+        if (connectionFd < 0) {
+            continue;
+        }
+
+        struct timeval timeout = { SERVER_SOCKET_TIMEOUT_S, 0 };
+        setsockopt(connectionFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        ffsServeScenarioConnection(connectionFd);
+        close(connectionFd);
+    }
+
+    return NULL;
+}
+
+/** @brief Read one request and send the response for its path.
+ */
+static void ffsServeScenarioConnection(int connectionFd)
+{
+    char request[MAXIMUM_REQUEST_SIZE];
+    size_t requestSize = 0;
+    char *headerEnd = NULL;
+
+    // Read the headers.
+    while (!headerEnd) {
+        if (requestSize == sizeof(request) - 1) {
+            return;
+        }
+        ssize_t readSize = recv(connectionFd, request + requestSize, sizeof(request) - 1 - requestSize, 0);
+        if (readSize <= 0) {
+            return;
+        }
+        requestSize += (size_t) readSize;
+        request[requestSize] = '\0';
+        headerEnd = strstr(request, "\r\n\r\n");
+    }
+
+    // Read the rest of the body.
+    size_t bodySize = requestSize - (size_t) (headerEnd + 4 - request);
+    const char *contentLength = strstr(request, "Content-Length:");
+    size_t expectedBodySize = contentLength && contentLength < headerEnd
+            ? strtoul(contentLength + strlen("Content-Length:"), NULL, 10) : 0;
+    while (bodySize < expectedBodySize) {
+        char discard[MAXIMUM_REQUEST_SIZE];
+        ssize_t readSize = recv(connectionFd, discard, sizeof(discard), 0);
+        if (readSize <= 0) {
+            return;
+        }
+        bodySize += (size_t) readSize;
+    }
+
+    // Answer with a JSON body of the expected size.
+    size_t responseSize = ffsGetScenarioResponseSize(request);
+    if (responseSize < 2) {
+        const char *notFound = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        send(connectionFd, notFound, strlen(notFound), MSG_NOSIGNAL);
+        return;
+    }
+
+    char response[MAXIMUM_REQUEST_SIZE];
+    int headerSize = snprintf(response, sizeof(response), "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+            "Content-Length: %zu\r\nConnection: close\r\n\r\n", responseSize);
+    if (headerSize < 0 || (size_t) headerSize + responseSize > sizeof(response)) {
+        return;
+    }
+    memset(response + headerSize, ' ', responseSize);
+    response[headerSize] = '{';
+    response[headerSize + responseSize - 1] = '}';
+
+    send(connectionFd, response, (size_t) headerSize + responseSize, MSG_NOSIGNAL);
+}
+
+/** @brief Response body size for the path in a request line (0 if unknown).
+ */
+static size_t ffsGetScenarioResponseSize(const char *request)
+{
+    const char *path = strchr(request, '/');
+    if (!path) {
+        return 0;
+    }
+    path++;
+
+    for (const FfsScenarioStep_t *step = PROVISIONING_STEPS; step->path; step++) {
+        size_t pathLength = strlen(step->path);
+        if (!strncmp(path, step->path, pathLength) && path[pathLength] == ' ') {
+            return step->responseSize;
+        }
+    }
+
+    return 0;
+}
+
+/** @brief Apply the time scale to a duration.
+ */
+static uint32_t ffsScaleScenarioDuration(const FfsScenarioOptions_t *options, uint32_t durationMs)
+{
+    return (uint32_t) (((uint64_t) durationMs * options->timeScalePercent) / 100);
+}
+
+/** @brief Get the current monotonic time in milliseconds.
+ */
+static uint64_t ffsGetScenarioTimeMs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+/** @brief Sleep for a number of milliseconds.
+ */
+static void ffsSleepScenarioMs(uint32_t durationMs)
+{
+    struct timespec duration = { durationMs / 1000, (long) (durationMs % 1000) * 1000000 };
+
+    nanosleep(&duration, NULL);
+}
+
+/** @brief Ascending order for qsort.
+ */
+static int ffsCompareDurations(const void *left, const void *right)
+{
+    uint32_t leftValue = *(const uint32_t *) left;
+    uint32_t rightValue = *(const uint32_t *) right;
+
+    return (leftValue > rightValue) - (leftValue < rightValue);
+}
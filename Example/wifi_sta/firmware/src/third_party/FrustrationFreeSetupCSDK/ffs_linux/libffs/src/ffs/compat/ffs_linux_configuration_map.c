@@ -17,7 +17,7 @@
 #include "ffs/common/ffs_check_result.h"
 #include "ffs/compat/ffs_linux_configuration_map.h"
 #include "ffs/compat/ffs_linux_user_context.h"
-#include "ffs/linux/ffs_linux_crypto_common.h"
+#include "ffs/linux/ffs_linux_crypto_cache.h"
 #include "ffs/linux/ffs_linux_version.h"
 
 #include <stdlib.h>
@@ -212,7 +212,8 @@ FFS_RESULT ffsGetConfigurationMapValue(struct FfsUserContext_s *userContext, con
         if (userContext->devicePublicKey) {
             ffsLogDebug("Device public key is present.");
             configurationValue->type = FFS_MAP_VALUE_TYPE_BYTES;
-            FFS_CHECK_RESULT(ffsGetDerEncodedPublicKeyFromEVPKey(userContext->devicePublicKey, &configurationValue->bytesStream));
+            FFS_CHECK_RESULT(ffsGetCachedDerEncodedPublicKey(&userContext->cryptoCache.devicePublicKeyDer,
+                    userContext->devicePublicKey, &configurationValue->bytesStream));
             return FFS_SUCCESS;
         } else {
             ffsLogError("Device public key not initialized.");
@@ -222,7 +223,8 @@ FFS_RESULT ffsGetConfigurationMapValue(struct FfsUserContext_s *userContext, con
         if (userContext->cloudPublicKey) {
             ffsLogDebug("Cloud public key is present.");
             configurationValue->type = FFS_MAP_VALUE_TYPE_BYTES;
-            FFS_CHECK_RESULT(ffsGetDerEncodedPublicKeyFromEVPKey(userContext->cloudPublicKey, &configurationValue->bytesStream));
+            FFS_CHECK_RESULT(ffsGetCachedDerEncodedPublicKey(&userContext->cryptoCache.cloudPublicKeyDer,
+                    userContext->cloudPublicKey, &configurationValue->bytesStream));
             return FFS_SUCCESS;
         } else {
             ffsLogWarning("Cloud public key not initialized.");
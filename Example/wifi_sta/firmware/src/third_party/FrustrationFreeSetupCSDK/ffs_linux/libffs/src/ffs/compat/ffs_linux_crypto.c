@@ -17,6 +17,7 @@
 #include "ffs/common/ffs_check_result.h"
 #include "ffs/common/ffs_stream.h"
 #include "ffs/compat/ffs_linux_user_context.h"
+#include "ffs/linux/ffs_linux_crypto_cache.h"
 #include "ffs/linux/ffs_linux_crypto_common.h"
 
 #include <openssl/evp.h>
@@ -83,37 +84,16 @@ FFS_RESULT ffsComputeECDHKey(struct FfsUserContext_s *userContext, FfsStream_t *
 {
     int rc;
 
-    /* Initialise */
-    EVP_PKEY_CTX *ctx = EVP_PKEY_CTX_new(userContext->devicePrivateKey, NULL);
-    if (!ctx) {
-        ffsLogError("Failed to initialize ECDH context.");
-        FFS_FAIL(FFS_ERROR);
-    }
-
-    rc = EVP_PKEY_derive_init(ctx);
-    if(rc != OPENSSL_SUCCESS) {
-        ffsLogError("Failed to init EVP_PKEY_derive_init: %d", rc);
-        EVP_PKEY_CTX_free(ctx);
-        FFS_FAIL(FFS_ERROR);
-    }
-
-    /* Provide peer public key */
-    EVP_PKEY *cloudPublicKey = NULL;
-    FFS_CHECK_RESULT(ffsGetEVPKeyFromDerStream(publicKeyStream, &cloudPublicKey));
-    rc = EVP_PKEY_derive_set_peer(ctx, cloudPublicKey);
-    if(rc != OPENSSL_SUCCESS) {
-        ffsLogError("Failed to set peer public key: %d", rc);
-        EVP_PKEY_CTX_free(ctx);
-        FFS_FAIL(FFS_ERROR);
-    }
+    /* Get the context bound to the device private key and the peer public key */
+    EVP_PKEY_CTX *ctx;
+    FFS_CHECK_RESULT(ffsGetCachedDeriveContext(&userContext->cryptoCache, userContext->devicePrivateKey,
+            publicKeyStream, &ctx));
 
     size_t secret_len;
     rc = EVP_PKEY_derive(ctx, NULL, &secret_len);
     /* Determine buffer length for shared secret */
     if(rc != OPENSSL_SUCCESS) {
         ffsLogError("Failed to derive secret length:%d", rc);
-        EVP_PKEY_CTX_free(ctx);
-        EVP_PKEY_free(cloudPublicKey);
         FFS_FAIL(FFS_ERROR);
     }
 
@@ -123,8 +103,6 @@ FFS_RESULT ffsComputeECDHKey(struct FfsUserContext_s *userContext, FfsStream_t *
     rc = EVP_PKEY_derive(ctx, sharedSecret, &secret_len);
     if(rc != OPENSSL_SUCCESS) {
         ffsLogError("Faild to derive shared secret:%d", rc);
-        EVP_PKEY_CTX_free(ctx);
-        EVP_PKEY_free(cloudPublicKey);
         FFS_FAIL(FFS_ERROR);
     }
     
@@ -133,10 +111,6 @@ FFS_RESULT ffsComputeECDHKey(struct FfsUserContext_s *userContext, FfsStream_t *
 
     /* Now sha256 hash the shared secret to generate the ultimate secret key. */
     FFS_CHECK_RESULT(ffsSha256(userContext, &sharedSecretStream, secretKeyStream));
-    
-    /* Free stuff */
-    EVP_PKEY_CTX_free(ctx);
-    EVP_PKEY_free(cloudPublicKey);
 
     return FFS_SUCCESS;
 }
@@ -147,23 +121,14 @@ FFS_RESULT ffsComputeECDHKey(struct FfsUserContext_s *userContext, FfsStream_t *
 FFS_RESULT ffsVerifyCloudSignature(struct FfsUserContext_s *userContext, FfsStream_t *payloadStream,
         FfsStream_t *signatureStream, bool *isVerified)
 {
-    // Create the message digest context.
-    EVP_MD_CTX *messageDigestContext = EVP_MD_CTX_create();
-    if (!messageDigestContext) {
-        FFS_FAIL(FFS_ERROR);
-    }
-
-    // Initialize the digest.
-    if (EVP_DigestVerifyInit(messageDigestContext, NULL, EVP_sha256(), NULL, userContext->cloudPublicKey)
-           != OPENSSL_SUCCESS) {
-        EVP_MD_CTX_destroy(messageDigestContext);
-        FFS_FAIL(FFS_ERROR);
-    }
+    // Get the initialized message digest context.
+    EVP_MD_CTX *messageDigestContext;
+    FFS_CHECK_RESULT(ffsGetCachedVerifyContext(&userContext->cryptoCache, userContext->cloudPublicKey,
+            &messageDigestContext));
 
     // Add the payload.
     if (EVP_DigestVerifyUpdate(messageDigestContext, FFS_STREAM_NEXT_READ(*payloadStream),
            FFS_STREAM_DATA_SIZE(*payloadStream)) != OPENSSL_SUCCESS) {
-        EVP_MD_CTX_destroy(messageDigestContext);
         FFS_FAIL(FFS_ERROR);
     }
 
@@ -171,9 +136,6 @@ FFS_RESULT ffsVerifyCloudSignature(struct FfsUserContext_s *userContext, FfsStre
     *isVerified = EVP_DigestVerifyFinal(messageDigestContext, FFS_STREAM_NEXT_READ(*signatureStream),
            FFS_STREAM_DATA_SIZE(*signatureStream)) == OPENSSL_SUCCESS;
 
-    // Clean up.
-    EVP_MD_CTX_destroy(messageDigestContext);
-
     return FFS_SUCCESS;
 }
 
@@ -183,23 +145,14 @@ FFS_RESULT ffsVerifyCloudSignature(struct FfsUserContext_s *userContext, FfsStre
 FFS_RESULT ffsSignPayload(struct FfsUserContext_s *userContext, FfsStream_t *payloadStream,
         FfsStream_t *destinationSignatureStream) {
 
-    // Create the message digest context.
-    EVP_MD_CTX *messageDigestContext = EVP_MD_CTX_create();
-    if (!messageDigestContext) {
-        FFS_FAIL(FFS_ERROR);
-    }
-
-    // Initialize the digest.
-    if (EVP_DigestSignInit(messageDigestContext, NULL, EVP_sha256(), NULL, userContext->devicePrivateKey)
-           != OPENSSL_SUCCESS) {
-        EVP_MD_CTX_destroy(messageDigestContext);
-        FFS_FAIL(FFS_ERROR);
-    }
+    // Get the initialized message digest context.
+    EVP_MD_CTX *messageDigestContext;
+    FFS_CHECK_RESULT(ffsGetCachedSignContext(&userContext->cryptoCache, userContext->devicePrivateKey,
+            &messageDigestContext));
 
     // Add the payload.
     if(EVP_DigestSignUpdate(messageDigestContext, FFS_STREAM_NEXT_READ(*payloadStream),
            FFS_STREAM_DATA_SIZE(*payloadStream)) != OPENSSL_SUCCESS) {
-        EVP_MD_CTX_destroy(messageDigestContext);
         FFS_FAIL(FFS_ERROR);
     }
 
@@ -208,7 +161,6 @@ FFS_RESULT ffsSignPayload(struct FfsUserContext_s *userContext, FfsStream_t *pay
      * signature. Length is returned in slen */
     size_t signatureLength;
     if (EVP_DigestSignFinal(messageDigestContext, NULL, &signatureLength) != OPENSSL_SUCCESS) {
-        EVP_MD_CTX_destroy(messageDigestContext);
         FFS_FAIL(FFS_ERROR);
     }
 
@@ -219,12 +171,10 @@ FFS_RESULT ffsSignPayload(struct FfsUserContext_s *userContext, FfsStream_t *pay
     /* Obtain the signature */
     if (EVP_DigestSignFinal(messageDigestContext, FFS_STREAM_NEXT_WRITE(*destinationSignatureStream),
           &signatureLength) != OPENSSL_SUCCESS) {
-        EVP_MD_CTX_destroy(messageDigestContext);
         FFS_FAIL(FFS_ERROR);
     }
 
     FFS_CHECK_RESULT(ffsWriteStream(NULL, signatureLength, destinationSignatureStream));
 
-    EVP_MD_CTX_destroy(messageDigestContext);
     return FFS_SUCCESS;
 }
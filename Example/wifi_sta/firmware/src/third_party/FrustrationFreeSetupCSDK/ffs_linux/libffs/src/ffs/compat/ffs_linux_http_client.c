@@ -19,13 +19,21 @@
 #include "ffs/common/ffs_logging.h"
 #include "ffs/compat/ffs_linux_user_context.h"
 #include "ffs/compat/ffs_wifi_provisionee_compat.h"
+#include "ffs/linux/ffs_linux_dns_cache.h"
+#include "ffs/linux/ffs_linux_http_trace.h"
 
 #include <ctype.h>
 #include <curl/curl.h>
+#include <pthread.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <time.h>
 
 #define HEADER_LINE_SEPARATOR   ':'
+#define DEFAULT_HTTP_PORT       (80)
+#define DEFAULT_HTTPS_PORT      (443)
 
 /** @brief Macro to short-circuit curl functions and return a Ffs error.
  *
@@ -40,21 +48,90 @@
         } \
     }
 
-/** @brief Curl callback data.
+#define HTTP_CLIENT_POLL_TIMEOUT_MS (1000)
+
+/** @brief Asynchronous HTTP operation.
  */
-typedef struct {
+struct FfsHttpOperation_s {
+    struct FfsUserContext_s *userContext; //!< User context.
     FfsHttpRequest_t *request; //!< Original request.
     void *callbackDataPointer; //!< Data for the request callbacks.
-} FfsHttpClientCallbackData_t;
+    FfsHttpCompletionCallback_t onComplete; //!< Completion callback (optional).
+    CURL *session; //!< Curl session.
+    struct curl_slist *headerList; //!< Header list.
+    struct curl_slist *resolveList; //!< Pinned DNS answer list.
+    FFS_DNS_CACHE_LOOKUP_RESULT lookupResult; //!< DNS cache lookup result.
+    FfsNetworkImpairmentPlan_t impairment; //!< Emulated network impairment (if enabled).
+    FfsHttpTraceExchange_t *trace; //!< Exchange being recorded (if recording).
+    const FfsHttpTraceExchange_t *replayExchange; //!< Recorded exchange served instead of the transfer (if replaying).
+    uint8_t *replayBody; //!< Replayed response body.
+    size_t replayBodySize; //!< Replayed response body size.
+    char *replaySignature; //!< Replayed response signature (NULL to serve the recorded one).
+    uint64_t submitTimeMs; //!< When the operation was submitted.
+    uint64_t startTimeMs; //!< When the event loop starts (or fails) the transfer.
+    uint64_t deadlineMs; //!< Timeout deadline (0 for none).
+    CURLcode injectedCode; //!< Emulated transfer failure (CURLE_OK for none).
+    size_t bodySize; //!< Response body bytes delivered.
+    bool isStarted; //!< Added to the multi handle?
+    bool isDetached; //!< Release on completion (no handle was returned)?
+    bool isCancelled; //!< Cancelled by the caller?
+    bool isComplete; //!< Completed?
+    FFS_RESULT result; //!< Completion result.
+    struct FfsHttpOperation_s *next; //!< Next operation in the pending or active list.
+};
+
+/** @brief HTTP client event loop.
+ *
+ * One curl multi handle driven by one thread, started on first use. All
+ * transfers, response handlers and completion callbacks run on this thread.
+ */
+typedef struct {
+    pthread_mutex_t mutex; //!< Mutex protecting the lists and the operation flags.
+    pthread_cond_t completeCondition; //!< Signalled when an operation completes.
+    CURLM *multi; //!< Curl multi handle.
+    pthread_t thread; //!< Event thread.
+    FfsHttpOperation_t *pendingOperations; //!< Submitted (or delayed), not yet added to the multi handle.
+    FfsHttpOperation_t *activeOperations; //!< Added to the multi handle.
+    FFS_RESULT startResult; //!< Result of starting the event loop.
+} FfsHttpClientEventLoop_t;
+
+static FfsHttpClientEventLoop_t eventLoop = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .completeCondition = PTHREAD_COND_INITIALIZER
+};
+static pthread_once_t eventLoopOnce = PTHREAD_ONCE_INIT;
 
 // Static function prototypes.
-static FFS_RESULT ffsHttpExecutePreallocated(struct FfsUserContext_s *userContext,
-        FfsHttpRequest_t *request, void *callbackDataPointer, CURL *session, struct curl_slist **headerList);
+static void ffsHttpStartEventLoop(void);
+static void *ffsHttpRunEventLoop(void *argument);
+static void ffsHttpCompleteOperation(FfsHttpOperation_t *operation, CURLcode curlCode);
+static FFS_RESULT ffsHttpFinishOperation(FfsHttpOperation_t *operation, CURLcode transferCode);
+static void ffsHttpFreeOperation(FfsHttpOperation_t *operation);
+static bool ffsHttpIsCancelled(FfsHttpOperation_t *operation);
+static FFS_RESULT ffsHttpPrepareOperation(FfsHttpOperation_t *operation, uint32_t timeoutMs);
+static FFS_RESULT ffsHttpImpairOperation(FfsHttpOperation_t *operation);
+static FFS_RESULT ffsHttpStartTrace(FfsHttpOperation_t *operation);
+static void ffsHttpFinishTrace(FfsHttpOperation_t *operation, FFS_RESULT result);
+static FFS_RESULT ffsHttpReplayOperation(FfsHttpOperation_t *operation);
+static FFS_RESULT ffsHttpFinishReplayedOperation(FfsHttpOperation_t *operation);
+static char *ffsHttpCopyStream(FfsStream_t *stream);
+static void ffsHttpStartOperation(FfsHttpOperation_t *operation, uint64_t nowMs);
+static uint64_t ffsHttpGetTimeMs(void);
+static FFS_RESULT ffsHttpApplyDnsCache(struct FfsUserContext_s *userContext, FfsHttpRequest_t *request,
+        CURL *session, struct curl_slist **resolveList, FFS_DNS_CACHE_LOOKUP_RESULT *lookupResult);
+static FFS_RESULT ffsHttpUpdateDnsCache(struct FfsUserContext_s *userContext, FfsHttpRequest_t *request,
+        CURL *session, CURLcode curlCode, FFS_DNS_CACHE_LOOKUP_RESULT lookupResult);
+static FFS_RESULT ffsHttpRecordDnsOutcome(FfsDnsCache_t *dnsCache, FfsHttpRequest_t *request, CURLcode curlCode,
+        FFS_DNS_CACHE_LOOKUP_RESULT lookupResult, const char *primaryIp, uint32_t resolveDurationMs,
+        FfsStream_t *serializedStream);
 static FFS_RESULT ffsHttpConstructHeaderLine(FfsHttpHeader_t *header, char **headerLine);
+static bool ffsHttpParseResponseHeader(char *buffer, size_t size, FfsStream_t *nameStream,
+        FfsStream_t *valueStream);
 static size_t ffsHttpHandleResponseHeader(char *buffer, size_t itemSize, size_t itemCount,
-        FfsHttpClientCallbackData_t *httpClientCallbackData);
+        FfsHttpOperation_t *operation);
 static size_t ffsHttpHandleResponseBody(char *buffer, size_t itemSize, size_t itemCount,
-        FfsHttpClientCallbackData_t *httpClientCallbackData);
+        FfsHttpOperation_t *operation);
+static FFS_RESULT ffsHttpDeliverResponseBody(FfsHttpOperation_t *operation, char *buffer, size_t size);
 static FFS_RESULT ffsSetUrl(CURL *session, FfsHttpRequest_t *request);
 
 /*
@@ -63,52 +140,415 @@ static FFS_RESULT ffsSetUrl(CURL *session, FfsHttpRequest_t *request);
 FFS_RESULT ffsHttpExecute(struct FfsUserContext_s *userContext,
         FfsHttpRequest_t *request, void *callbackDataPointer)
 {
+    FfsHttpOperation_t *operation;
+    FFS_CHECK_RESULT(ffsHttpExecuteAsync(userContext, request, callbackDataPointer, 0, NULL, &operation));
+    FFS_CHECK_RESULT(ffsHttpWait(userContext, operation));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Start an HTTP operation without waiting for it.
+ */
+FFS_RESULT ffsHttpExecuteAsync(struct FfsUserContext_s *userContext, FfsHttpRequest_t *request,
+        void *callbackDataPointer, uint32_t timeoutMs, FfsHttpCompletionCallback_t onComplete,
+        FfsHttpOperation_t **operation)
+{
+    // Start the event loop on first use.
+    pthread_once(&eventLoopOnce, ffsHttpStartEventLoop);
+    FFS_CHECK_RESULT(eventLoop.startResult);
+
+    FfsHttpOperation_t *newOperation = (FfsHttpOperation_t *) calloc(1, sizeof(FfsHttpOperation_t));
+    if (!newOperation) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    newOperation->userContext = userContext;
+    newOperation->request = request;
+    newOperation->callbackDataPointer = callbackDataPointer;
+    newOperation->onComplete = onComplete;
+    newOperation->isDetached = !operation;
+
     // Start curl.
-    CURL *session = curl_easy_init();
-    if (!session) {
+    newOperation->session = curl_easy_init();
+    if (!newOperation->session) {
+        ffsHttpFreeOperation(newOperation);
         FFS_FAIL(FFS_ERROR);
     }
 
-    curl_easy_setopt(session, CURLOPT_VERBOSE, 1L);
-
-    // Header list.
-    struct curl_slist *headerList = NULL;
+    curl_easy_setopt(newOperation->session, CURLOPT_VERBOSE, 1L);
 
-    // Execute the operation.
-    FFS_RESULT result = ffsHttpExecutePreallocated(userContext, request, callbackDataPointer, session,
-            &headerList);
+    FFS_RESULT result = ffsHttpPrepareOperation(newOperation, timeoutMs);
+    if (result != FFS_SUCCESS) {
+        ffsHttpFreeOperation(newOperation);
+        FFS_FAIL(result);
+    }
 
-    // Clean up curl.
-    curl_easy_cleanup(session);
+    newOperation->submitTimeMs = ffsHttpGetTimeMs();
+    newOperation->startTimeMs = newOperation->submitTimeMs;
+    if (timeoutMs) {
+        newOperation->deadlineMs = newOperation->startTimeMs + timeoutMs;
+    }
 
-    // Clean up the header list.
-    if (headerList) {
-        curl_slist_free_all(headerList);
+    // Hand the operation to the event loop.
+    pthread_mutex_lock(&eventLoop.mutex);
+    if (userContext->httpTraceReplay) {
+        result = ffsHttpReplayOperation(newOperation);
+    } else {
+        if (userContext->httpTraceRecorder) {
+            result = ffsHttpStartTrace(newOperation);
+        }
+        if (result == FFS_SUCCESS && userContext->networkImpairment) {
+            result = ffsHttpImpairOperation(newOperation);
+        }
+    }
+    if (result != FFS_SUCCESS) {
+        pthread_mutex_unlock(&eventLoop.mutex);
+        ffsHttpFreeOperation(newOperation);
+        FFS_FAIL(result);
     }
+    newOperation->next = eventLoop.pendingOperations;
+    eventLoop.pendingOperations = newOperation;
+    if (operation) {
+        *operation = newOperation;
+    }
+    pthread_mutex_unlock(&eventLoop.mutex);
 
-    // Check the result.
-    FFS_CHECK_RESULT(result);
+    curl_multi_wakeup(eventLoop.multi);
 
     return FFS_SUCCESS;
 }
 
 /*
- * Execute an HTTP operation with preallocated curl session and header list.
+ * Wait for an HTTP operation to complete and release it.
+ */
+FFS_RESULT ffsHttpWait(struct FfsUserContext_s *userContext, FfsHttpOperation_t *operation)
+{
+    (void) userContext;
+
+    pthread_mutex_lock(&eventLoop.mutex);
+    while (!operation->isComplete) {
+        pthread_cond_wait(&eventLoop.completeCondition, &eventLoop.mutex);
+    }
+    FFS_RESULT result = operation->result;
+    pthread_mutex_unlock(&eventLoop.mutex);
+
+    free(operation);
+
+    return result;
+}
+
+/*
+ * Cancel an HTTP operation.
+ */
+FFS_RESULT ffsHttpCancel(struct FfsUserContext_s *userContext, FfsHttpOperation_t *operation)
+{
+    (void) userContext;
+
+    pthread_mutex_lock(&eventLoop.mutex);
+    if (!operation->isComplete) {
+        operation->isCancelled = true;
+    }
+    pthread_mutex_unlock(&eventLoop.mutex);
+
+    curl_multi_wakeup(eventLoop.multi);
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Create the multi handle and start the event thread.
+ */
+static void ffsHttpStartEventLoop(void)
+{
+    eventLoop.startResult = FFS_ERROR;
+
+    eventLoop.multi = curl_multi_init();
+    if (!eventLoop.multi) {
+        ffsLogError("Failed to create the curl multi handle");
+        return;
+    }
+
+    if (pthread_create(&eventLoop.thread, NULL, ffsHttpRunEventLoop, NULL)) {
+        ffsLogError("Failed to start the HTTP client thread");
+        curl_multi_cleanup(eventLoop.multi);
+        eventLoop.multi = NULL;
+        return;
+    }
+    pthread_detach(eventLoop.thread);
+
+    eventLoop.startResult = FFS_SUCCESS;
+}
+
+/** @brief Event thread: add submitted operations, drive transfers, complete
+ * finished, failed and cancelled operations.
+ */
+static void *ffsHttpRunEventLoop(void *argument)
+{
+    (void) argument;
+
+    for (;;) {
+        FfsHttpOperation_t *finishedOperations = NULL;
+        long pollTimeoutMs = HTTP_CLIENT_POLL_TIMEOUT_MS;
+        uint64_t nowMs = ffsHttpGetTimeMs();
+
+        pthread_mutex_lock(&eventLoop.mutex);
+
+        // Move due operations to the multi handle, or finish them if they never reach it.
+        for (FfsHttpOperation_t **link = &eventLoop.pendingOperations; *link;) {
+            FfsHttpOperation_t *operation = *link;
+            if (!operation->isCancelled && operation->startTimeMs > nowMs) {
+                if ((long) (operation->startTimeMs - nowMs) < pollTimeoutMs) {
+                    pollTimeoutMs = (long) (operation->startTimeMs - nowMs);
+                }
+                link = &operation->next;
+                continue;
+            }
+
+            *link = operation->next;
+            if (operation->isCancelled || operation->injectedCode != CURLE_OK || operation->replayExchange) {
+                operation->next = finishedOperations;
+                finishedOperations = operation;
+            } else {
+                ffsHttpStartOperation(operation, nowMs);
+            }
+        }
+
+        // Take out the cancelled operations.
+        for (FfsHttpOperation_t **link = &eventLoop.activeOperations; *link;) {
+            FfsHttpOperation_t *operation = *link;
+            if (operation->isCancelled) {
+                *link = operation->next;
+                operation->next = finishedOperations;
+                finishedOperations = operation;
+            } else {
+                link = &operation->next;
+            }
+        }
+
+        pthread_mutex_unlock(&eventLoop.mutex);
+
+        while (finishedOperations) {
+            FfsHttpOperation_t *operation = finishedOperations;
+            finishedOperations = operation->next;
+            ffsHttpCompleteOperation(operation, operation->isCancelled
+                    ? CURLE_ABORTED_BY_CALLBACK : operation->injectedCode);
+        }
+
+        // Drive the transfers.
+        int runningCount;
+        curl_multi_perform(eventLoop.multi, &runningCount);
+
+        // Complete the finished transfers.
+        CURLMsg *message;
+        int messageCount;
+        while ((message = curl_multi_info_read(eventLoop.multi, &messageCount))) {
+            if (message->msg != CURLMSG_DONE) {
+                continue;
+            }
+
+            FfsHttpOperation_t *operation = NULL;
+            curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, (char **) &operation);
+            CURLcode curlCode = message->data.result;
+
+            pthread_mutex_lock(&eventLoop.mutex);
+            for (FfsHttpOperation_t **link = &eventLoop.activeOperations; *link; link = &(*link)->next) {
+                if (*link == operation) {
+                    *link = operation->next;
+                    break;
+                }
+            }
+            pthread_mutex_unlock(&eventLoop.mutex);
+
+            ffsHttpCompleteOperation(operation, curlCode);
+        }
+
+        // Wait for socket activity, a curl timer, a delayed operation or a wakeup.
+        curl_multi_poll(eventLoop.multi, NULL, 0, (int) pollTimeoutMs, NULL);
+    }
+
+    return NULL;
+}
+
+/** @brief Add a due operation to the multi handle (event loop lock held).
+ */
+static void ffsHttpStartOperation(FfsHttpOperation_t *operation, uint64_t nowMs)
+{
+    // Charge any emulated latency against the timeout.
+    if (operation->deadlineMs) {
+        uint64_t remainingMs = operation->deadlineMs > nowMs ? operation->deadlineMs - nowMs : 1;
+        curl_easy_setopt(operation->session, CURLOPT_TIMEOUT_MS, (long) remainingMs);
+    }
+
+    operation->next = eventLoop.activeOperations;
+    eventLoop.activeOperations = operation;
+    operation->isStarted = true;
+    curl_multi_add_handle(eventLoop.multi, operation->session);
+}
+
+/** @brief Complete an operation removed from the active list.
+ */
+static void ffsHttpCompleteOperation(FfsHttpOperation_t *operation, CURLcode curlCode)
+{
+    if (operation->isStarted) {
+        curl_multi_remove_handle(eventLoop.multi, operation->session);
+    }
+
+    FFS_RESULT result = ffsHttpFinishOperation(operation, curlCode);
+
+    if (operation->trace) {
+        ffsHttpFinishTrace(operation, result);
+    }
+
+    // Release the curl and replay resources.
+    curl_easy_cleanup(operation->session);
+    operation->session = NULL;
+    if (operation->headerList) {
+        curl_slist_free_all(operation->headerList);
+        operation->headerList = NULL;
+    }
+    if (operation->resolveList) {
+        curl_slist_free_all(operation->resolveList);
+        operation->resolveList = NULL;
+    }
+    free(operation->replayBody);
+    operation->replayBody = NULL;
+    free(operation->replaySignature);
+    operation->replaySignature = NULL;
+
+    if (operation->onComplete) {
+        operation->onComplete(operation, result, operation->callbackDataPointer);
+    }
+
+    pthread_mutex_lock(&eventLoop.mutex);
+    operation->result = result;
+    operation->isComplete = true;
+    bool isDetached = operation->isDetached;
+    pthread_cond_broadcast(&eventLoop.completeCondition);
+    pthread_mutex_unlock(&eventLoop.mutex);
+
+    if (isDetached) {
+        free(operation);
+    }
+}
+
+/** @brief Map the transfer outcome to a result, running the status code
+ * callback for completed transfers.
+ */
+static FFS_RESULT ffsHttpFinishOperation(FfsHttpOperation_t *operation, CURLcode transferCode)
+{
+    FfsHttpRequest_t *request = operation->request;
+
+    if (ffsHttpIsCancelled(operation)) {
+        ffsLogDebug("HTTP operation cancelled");
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    // Serve a recorded response?
+    if (operation->replayExchange && operation->injectedCode == CURLE_OK) {
+        FFS_CHECK_RESULT(ffsHttpFinishReplayedOperation(operation));
+        return FFS_SUCCESS;
+    }
+
+    // A reset placed past the end of the response still loses the connection.
+    if (operation->impairment.fault == FFS_NETWORK_FAULT_RESET && transferCode == CURLE_OK) {
+        operation->injectedCode = CURLE_RECV_ERROR;
+    }
+
+    // Emulated failures never reach the transport, so there is nothing to learn from them.
+    if (operation->injectedCode != CURLE_OK) {
+        ffsLogWarning("Emulated network failure: %s", curl_easy_strerror(operation->injectedCode));
+        FFS_FAIL(operation->injectedCode == CURLE_OPERATION_TIMEDOUT ? FFS_TIMEOUT : FFS_ERROR);
+    }
+
+    // Learn from the name resolution.
+    FFS_CHECK_RESULT_CONTINUE(ffsHttpUpdateDnsCache(operation->userContext, request, operation->session,
+            transferCode, operation->lookupResult));
+
+    if (transferCode == CURLE_OPERATION_TIMEDOUT) {
+        ffsLogError("HTTP operation timed out");
+        FFS_FAIL(FFS_TIMEOUT);
+    }
+
+    FFS_HTTPCLIENT_CHECK_RESULT(transferCode);
+
+    // Do we need to send the status code?
+    if (request->callbacks.handleStatusCode) {
+
+        // Get the status code.
+        long statusCode;
+        FFS_HTTPCLIENT_CHECK_RESULT(curl_easy_getinfo(operation->session, CURLINFO_RESPONSE_CODE, &statusCode));
+
+        // Run the callback.
+        FFS_CHECK_RESULT(request->callbacks.handleStatusCode((int32_t) statusCode,
+                operation->callbackDataPointer));
+    }
+
+    // Redirect?
+    char *redirectUrl;
+    FFS_HTTPCLIENT_CHECK_RESULT(curl_easy_getinfo(operation->session, CURLINFO_REDIRECT_URL, &redirectUrl));
+    if (redirectUrl) {
+
+        // TODO: add code to break the URL into components and execute the callback.
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Release an operation that never reached the event loop.
  */
-static FFS_RESULT ffsHttpExecutePreallocated(struct FfsUserContext_s *userContext,
-        FfsHttpRequest_t *request, void *callbackDataPointer, CURL *session, struct curl_slist **headerList)
+static void ffsHttpFreeOperation(FfsHttpOperation_t *operation)
 {
+    if (operation->session) {
+        curl_easy_cleanup(operation->session);
+    }
+    if (operation->headerList) {
+        curl_slist_free_all(operation->headerList);
+    }
+    if (operation->resolveList) {
+        curl_slist_free_all(operation->resolveList);
+    }
+    if (operation->trace) {
+        ffsFreeHttpTraceExchange(operation->trace);
+        free(operation->trace);
+    }
+    free(operation->replayBody);
+    free(operation->replaySignature);
+    free(operation);
+}
+
+/** @brief Has the operation been cancelled?
+ */
+static bool ffsHttpIsCancelled(FfsHttpOperation_t *operation)
+{
+    pthread_mutex_lock(&eventLoop.mutex);
+    bool isCancelled = operation->isCancelled;
+    pthread_mutex_unlock(&eventLoop.mutex);
+
+    return isCancelled;
+}
+
+/** @brief Configure the curl session of an operation.
+ */
+static FFS_RESULT ffsHttpPrepareOperation(FfsHttpOperation_t *operation, uint32_t timeoutMs)
+{
+    struct FfsUserContext_s *userContext = operation->userContext;
+    FfsHttpRequest_t *request = operation->request;
+    CURL *session = operation->session;
+
     // Verify that the operation is a GET or a POST.
     if (request->operation != FFS_HTTP_OPERATION_GET &&
             request->operation != FFS_HTTP_OPERATION_POST) {
         FFS_FAIL(FFS_ERROR);
     }
 
-    // Construct the HTTP client callback data.
-    FfsHttpClientCallbackData_t httpClientCallbackData = {
-        .request = request,
-        .callbackDataPointer = callbackDataPointer
-    };
+    // Find the operation from the session.
+    FFS_HTTPCLIENT_CHECK_RESULT(curl_easy_setopt(session, CURLOPT_PRIVATE, operation));
+
+    // Limit the whole operation, if requested.
+    if (timeoutMs) {
+        FFS_HTTPCLIENT_CHECK_RESULT(curl_easy_setopt(session, CURLOPT_TIMEOUT_MS, (long) timeoutMs));
+    }
 
     // Request a POST operation?
     if (request->operation == FFS_HTTP_OPERATION_POST) {
@@ -123,15 +563,19 @@ static FFS_RESULT ffsHttpExecutePreallocated(struct FfsUserContext_s *userContex
         FFS_HTTPCLIENT_CHECK_RESULT(curl_easy_setopt(session, CURLOPT_PORT, request->url.port));
     }
 
+    // Use a cached DNS answer, if any.
+    FFS_CHECK_RESULT(ffsHttpApplyDnsCache(userContext, request, session, &operation->resolveList,
+            &operation->lookupResult));
+
     // Set the write callback.
     FFS_HTTPCLIENT_CHECK_RESULT(curl_easy_setopt(session, CURLOPT_WRITEFUNCTION,
             ffsHttpHandleResponseBody));
-    FFS_HTTPCLIENT_CHECK_RESULT(curl_easy_setopt(session, CURLOPT_WRITEDATA, &httpClientCallbackData));
+    FFS_HTTPCLIENT_CHECK_RESULT(curl_easy_setopt(session, CURLOPT_WRITEDATA, operation));
 
     // Set the header callback.
     FFS_HTTPCLIENT_CHECK_RESULT(curl_easy_setopt(session, CURLOPT_HEADERFUNCTION,
             ffsHttpHandleResponseHeader));
-    FFS_HTTPCLIENT_CHECK_RESULT(curl_easy_setopt(session, CURLOPT_HEADERDATA, &httpClientCallbackData));
+    FFS_HTTPCLIENT_CHECK_RESULT(curl_easy_setopt(session, CURLOPT_HEADERDATA, operation));
 
     // Check if the server CA certificates path is defined.
     if (userContext->serverCaCertificatesPath) {
@@ -171,12 +615,12 @@ static FFS_RESULT ffsHttpExecutePreallocated(struct FfsUserContext_s *userContex
             // Add the header to the list.
             char *headerLine;
             FFS_CHECK_RESULT(ffsHttpConstructHeaderLine(*header, &headerLine));
-            *headerList = curl_slist_append(*headerList, headerLine);
+            operation->headerList = curl_slist_append(operation->headerList, headerLine);
             free(headerLine);
         }
 
         // Set the headers.
-        curl_easy_setopt(session, CURLOPT_HTTPHEADER, *headerList);
+        curl_easy_setopt(session, CURLOPT_HTTPHEADER, operation->headerList);
     }
 
     // Is a POST body defined?
@@ -196,27 +640,383 @@ static FFS_RESULT ffsHttpExecutePreallocated(struct FfsUserContext_s *userContex
                 FFS_STREAM_NEXT_READ(request->bodyStream)));
     }
 
-    // Perform the operation.
-    FFS_HTTPCLIENT_CHECK_RESULT(curl_easy_perform(session));
+    return FFS_SUCCESS;
+}
+
+/** @brief Draw and apply the network impairment for an operation (event loop
+ * lock held).
+ *
+ * Latency postpones the start of the transfer. DNS failures, resets before
+ * the response and stalls are emulated without starting the transfer; a
+ * stall fails only once the connection has been held for the stall time.
+ * Either way the timeout deadline still applies.
+ */
+static FFS_RESULT ffsHttpImpairOperation(FfsHttpOperation_t *operation)
+{
+    FfsNetworkImpairmentPlan_t *plan = &operation->impairment;
+
+    FFS_CHECK_RESULT(ffsPlanNetworkImpairment(operation->userContext->networkImpairment, plan));
+
+    operation->startTimeMs += plan->delayMs;
+
+    switch (plan->fault) {
+    case FFS_NETWORK_FAULT_DNS_FAILURE:
+        operation->injectedCode = CURLE_COULDNT_RESOLVE_HOST;
+        break;
+    case FFS_NETWORK_FAULT_RESET:
+        if (!plan->resetOffset) {
+            operation->injectedCode = CURLE_RECV_ERROR;
+        }
+        break;
+    case FFS_NETWORK_FAULT_STALL:
+        operation->startTimeMs += plan->stallMs;
+        operation->injectedCode = CURLE_RECV_ERROR;
+        break;
+    default:
+        break;
+    }
+
+    // Time out before the transfer would start?
+    if (operation->deadlineMs && operation->startTimeMs >= operation->deadlineMs) {
+        operation->startTimeMs = operation->deadlineMs;
+        operation->injectedCode = CURLE_OPERATION_TIMEDOUT;
+    }
+
+    // Cap the transfer rate.
+    if (plan->bandwidthBytesPerSecond) {
+        FFS_HTTPCLIENT_CHECK_RESULT(curl_easy_setopt(operation->session, CURLOPT_MAX_RECV_SPEED_LARGE,
+                (curl_off_t) plan->bandwidthBytesPerSecond));
+        FFS_HTTPCLIENT_CHECK_RESULT(curl_easy_setopt(operation->session, CURLOPT_MAX_SEND_SPEED_LARGE,
+                (curl_off_t) plan->bandwidthBytesPerSecond));
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Start recording an operation (event loop lock held).
+ */
+static FFS_RESULT ffsHttpStartTrace(FfsHttpOperation_t *operation)
+{
+    FfsHttpTraceRecorder_t *recorder = operation->userContext->httpTraceRecorder;
+    FfsHttpRequest_t *request = operation->request;
+
+    FfsHttpTraceExchange_t *trace = (FfsHttpTraceExchange_t *) calloc(1, sizeof(FfsHttpTraceExchange_t));
+    if (!trace) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+    operation->trace = trace;
+
+    // Client time since the previous exchange completed.
+    if (recorder->lastCompletionMs && operation->submitTimeMs > recorder->lastCompletionMs) {
+        trace->gapMs = (uint32_t) (operation->submitTimeMs - recorder->lastCompletionMs);
+    }
+
+    trace->operation = (uint8_t) request->operation;
+    trace->scheme = (uint8_t) request->url.scheme;
+    trace->port = request->url.port;
+    trace->host = ffsHttpCopyStream(&request->url.hostStream);
+    trace->path = strdup(request->url.path ? request->url.path : "");
+    if (!trace->host || !trace->path) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    for (FfsHttpHeader_t **header = request->headers; header && *header
+            && trace->requestHeaderCount < FFS_HTTP_TRACE_MAXIMUM_HEADER_COUNT; header++) {
+        FfsHttpTraceHeader_t *traceHeader = &trace->requestHeaders[trace->requestHeaderCount++];
+        traceHeader->name = ffsHttpCopyStream(&(*header)->nameStream);
+        traceHeader->value = ffsHttpCopyStream(&(*header)->valueStream);
+        if (!traceHeader->name || !traceHeader->value) {
+            FFS_FAIL(FFS_OVERRUN);
+        }
+    }
+
+    trace->requestBodySize = (uint32_t) FFS_STREAM_DATA_SIZE(request->bodyStream);
+    trace->requestBody = (uint8_t *) ffsHttpCopyStream(&request->bodyStream);
+    if (!trace->requestBody) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Complete and write the recording of an operation (event loop
+ * thread, lock not held).
+ */
+static void ffsHttpFinishTrace(FfsHttpOperation_t *operation, FFS_RESULT result)
+{
+    FfsHttpTraceRecorder_t *recorder = operation->userContext->httpTraceRecorder;
+    FfsHttpTraceExchange_t *trace = operation->trace;
+    uint64_t nowMs = ffsHttpGetTimeMs();
+
+    trace->result = (int8_t) result;
+    trace->durationMs = (uint32_t) (nowMs - operation->submitTimeMs);
+    if (operation->isStarted) {
+        long statusCode = 0;
+        curl_easy_getinfo(operation->session, CURLINFO_RESPONSE_CODE, &statusCode);
+        trace->statusCode = (int32_t) statusCode;
+    }
+
+    // Only the event loop writes the trace, so the file I/O needs no lock.
+    FFS_CHECK_RESULT_CONTINUE(ffsRecordHttpTraceExchange(recorder, trace));
+
+    pthread_mutex_lock(&eventLoop.mutex);
+    recorder->lastCompletionMs = nowMs;
+    pthread_mutex_unlock(&eventLoop.mutex);
+
+    ffsFreeHttpTraceExchange(trace);
+    free(trace);
+    operation->trace = NULL;
+}
+
+/** @brief Match an operation against the next recorded exchange (event loop
+ * lock held).
+ *
+ * The recorded response is prepared up front and served by the event loop
+ * once the recorded duration, scaled by the time warp, has passed.
+ */
+static FFS_RESULT ffsHttpReplayOperation(FfsHttpOperation_t *operation)
+{
+    FfsHttpTraceReplay_t *replay = operation->userContext->httpTraceReplay;
+    FfsHttpRequest_t *request = operation->request;
+
+    if (replay->nextExchange >= replay->exchangeCount) {
+        ffsLogError("HTTP trace exhausted after %u exchanges", replay->exchangeCount);
+        FFS_FAIL(FFS_ERROR);
+    }
+    const FfsHttpTraceExchange_t *exchange = &replay->exchanges[replay->nextExchange++];
+
+    // Compare the request with the recording.
+    const uint8_t *body = FFS_STREAM_NEXT_READ(request->bodyStream);
+    size_t bodySize = FFS_STREAM_DATA_SIZE(request->bodyStream);
+    const char *path = request->url.path ? request->url.path : "";
+    if (exchange->operation != request->operation || strcmp(exchange->path, path)
+            || !ffsHttpTraceBodiesMatch(exchange->requestBody, exchange->requestBodySize, body, bodySize,
+                    replay->volatileKeys)) {
+        ffsLogWarning("HTTP request %u (/%s) does not match the recording (/%s)", replay->nextExchange, path,
+                exchange->path);
+        replay->mismatchCount++;
+        if (replay->isStrict) {
+            FFS_FAIL(FFS_ERROR);
+        }
+    }
+
+    // Client time since the previous exchange completed.
+    if (replay->lastCompletionMs) {
+        replay->recordedGapMs += exchange->gapMs;
+        replay->replayedGapMs += operation->submitTimeMs - replay->lastCompletionMs;
+    }
+
+    FFS_CHECK_RESULT(ffsPrepareHttpTraceResponse(replay, exchange, body, bodySize, &operation->replayBody,
+            &operation->replayBodySize, &operation->replaySignature));
+
+    operation->replayExchange = exchange;
+    operation->startTimeMs += (uint64_t) exchange->durationMs * replay->timeWarpPercent / 100;
+    replay->lastCompletionMs = operation->startTimeMs;
+
+    // Time out before the recorded response would arrive?
+    if (operation->deadlineMs && operation->startTimeMs >= operation->deadlineMs) {
+        operation->startTimeMs = operation->deadlineMs;
+        operation->injectedCode = CURLE_OPERATION_TIMEDOUT;
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Run the response callbacks with a recorded response.
+ */
+static FFS_RESULT ffsHttpFinishReplayedOperation(FfsHttpOperation_t *operation)
+{
+    const FfsHttpTraceExchange_t *exchange = operation->replayExchange;
+    FfsHttpRequest_t *request = operation->request;
+
+    // Reproduce a recorded failure.
+    if (exchange->result != FFS_SUCCESS) {
+        FFS_FAIL((FFS_RESULT) exchange->result);
+    }
+
+    if (request->callbacks.handleHeader) {
+        for (uint8_t i = 0; i < exchange->responseHeaderCount; i++) {
+            const FfsHttpTraceHeader_t *header = &exchange->responseHeaders[i];
+            const char *value = header->value;
+            if (operation->replaySignature && !strcasecmp(header->name, FFS_HTTP_TRACE_SIGNATURE_HEADER)) {
+                value = operation->replaySignature;
+            }
+
+            FfsStream_t nameStream = FFS_STRING_INPUT_STREAM(header->name);
+            FfsStream_t valueStream = FFS_STRING_INPUT_STREAM(value);
+            FFS_CHECK_RESULT(request->callbacks.handleHeader(&nameStream, &valueStream,
+                    operation->callbackDataPointer));
+        }
+    }
+
+    if (operation->replayBodySize) {
+        FFS_CHECK_RESULT(ffsHttpDeliverResponseBody(operation, (char *) operation->replayBody,
+                operation->replayBodySize));
+    }
 
-    // Do we need to send the status code?
     if (request->callbacks.handleStatusCode) {
+        FFS_CHECK_RESULT(request->callbacks.handleStatusCode(exchange->statusCode,
+                operation->callbackDataPointer));
+    }
 
-        // Get the status code.
-        long statusCode;
-        FFS_HTTPCLIENT_CHECK_RESULT(curl_easy_getinfo(session, CURLINFO_RESPONSE_CODE, &statusCode));
+    return FFS_SUCCESS;
+}
 
-        // Run the callback.
-        FFS_CHECK_RESULT(request->callbacks.handleStatusCode((int32_t) statusCode, callbackDataPointer));
+/** @brief Copy the data of a stream into a new, null-terminated buffer.
+ */
+static char *ffsHttpCopyStream(FfsStream_t *stream)
+{
+    size_t size = FFS_STREAM_DATA_SIZE(*stream);
+
+    char *copy = (char *) malloc(size + 1);
+    if (copy) {
+        if (size) {
+            memcpy(copy, FFS_STREAM_NEXT_READ(*stream), size);
+        }
+        copy[size] = '\0';
     }
 
-    // Redirect?
-    char *redirectUrl;
-    FFS_HTTPCLIENT_CHECK_RESULT(curl_easy_getinfo(session, CURLINFO_REDIRECT_URL, &redirectUrl));
-    if (redirectUrl) {
+    return copy;
+}
 
-        // TODO: add code to break the URL into components and execute the callback.
+/** @brief Get the current monotonic time in milliseconds.
+ */
+static uint64_t ffsHttpGetTimeMs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+/** @brief Look up the request host in the DNS cache and pin a cached answer.
+ *
+ * A positive answer is handed to curl through CURLOPT_RESOLVE, so the URL (and
+ * with it SNI and certificate host name verification) is unchanged. A negative
+ * answer fails the request without waiting for the resolver.
+ */
+static FFS_RESULT ffsHttpApplyDnsCache(struct FfsUserContext_s *userContext, FfsHttpRequest_t *request,
+        CURL *session, struct curl_slist **resolveList, FFS_DNS_CACHE_LOOKUP_RESULT *lookupResult)
+{
+    *lookupResult = FFS_DNS_CACHE_MISS;
+
+    // Is the cache enabled?
+    if (!userContext->dnsCache.entries) {
+        return FFS_SUCCESS;
+    }
+
+    // The event loop updates the cache as operations complete.
+    FFS_TEMPORARY_OUTPUT_STREAM(addressStream, FFS_DNS_CACHE_MAXIMUM_ADDRESS_LENGTH);
+    pthread_mutex_lock(&eventLoop.mutex);
+    FFS_RESULT result = ffsDnsCacheLookup(&userContext->dnsCache, &request->url.hostStream,
+            ffsLinuxGetDnsCacheTimeMs(), &addressStream, lookupResult);
+    pthread_mutex_unlock(&eventLoop.mutex);
+    FFS_CHECK_RESULT(result);
+
+    switch (*lookupResult) {
+    case FFS_DNS_CACHE_NEGATIVE_HIT:
+        ffsLogWarning("Host %.*s recently failed to resolve",
+                (int) FFS_STREAM_DATA_SIZE(request->url.hostStream),
+                FFS_STREAM_NEXT_READ(request->url.hostStream));
         FFS_FAIL(FFS_ERROR);
+    case FFS_DNS_CACHE_HIT:
+        break;
+    default:
+        return FFS_SUCCESS;
+    }
+
+    // Construct the "host:port:address" entry.
+    int port = request->url.port;
+    if (!port) {
+        port = request->url.scheme == FFS_HTTP_SCHEME_HTTPS ? DEFAULT_HTTPS_PORT : DEFAULT_HTTP_PORT;
+    }
+    char resolveEntry[FFS_DNS_CACHE_MAXIMUM_HOST_LENGTH + FFS_DNS_CACHE_MAXIMUM_ADDRESS_LENGTH + 16];
+    snprintf(resolveEntry, sizeof(resolveEntry), "%.*s:%d:%.*s",
+            (int) FFS_STREAM_DATA_SIZE(request->url.hostStream), FFS_STREAM_NEXT_READ(request->url.hostStream),
+            port, (int) FFS_STREAM_DATA_SIZE(addressStream), FFS_STREAM_NEXT_READ(addressStream));
+
+    struct curl_slist *updatedResolveList = curl_slist_append(*resolveList, resolveEntry);
+    if (!updatedResolveList) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+    *resolveList = updatedResolveList;
+
+    FFS_HTTPCLIENT_CHECK_RESULT(curl_easy_setopt(session, CURLOPT_RESOLVE, *resolveList));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Update the DNS cache from the outcome of a request (event loop
+ * thread, lock not held).
+ */
+static FFS_RESULT ffsHttpUpdateDnsCache(struct FfsUserContext_s *userContext, FfsHttpRequest_t *request,
+        CURL *session, CURLcode curlCode, FFS_DNS_CACHE_LOOKUP_RESULT lookupResult)
+{
+    // Is the cache enabled?
+    if (!userContext->dnsCache.entries) {
+        return FFS_SUCCESS;
+    }
+
+    // How long did the resolution take, and did we get as far as connecting?
+    double nameLookupTime = 0;
+    FFS_HTTPCLIENT_CHECK_RESULT(curl_easy_getinfo(session, CURLINFO_NAMELOOKUP_TIME, &nameLookupTime));
+    uint32_t resolveDurationMs = (uint32_t) (nameLookupTime * 1000);
+    char *primaryIp = NULL;
+    FFS_HTTPCLIENT_CHECK_RESULT(curl_easy_getinfo(session, CURLINFO_PRIMARY_IP, &primaryIp));
+
+    // The cache is shared with the threads preparing operations.
+    FFS_TEMPORARY_OUTPUT_STREAM(serializedStream, FFS_LINUX_DNS_CACHE_BUFFER_SIZE);
+    pthread_mutex_lock(&eventLoop.mutex);
+    FFS_RESULT result = ffsHttpRecordDnsOutcome(&userContext->dnsCache, request, curlCode, lookupResult,
+            primaryIp, resolveDurationMs, userContext->dnsCachePath ? &serializedStream : NULL);
+    pthread_mutex_unlock(&eventLoop.mutex);
+    FFS_CHECK_RESULT(result);
+
+    // Persist a new answer, outside the lock.
+    if (FFS_STREAM_DATA_SIZE(serializedStream)) {
+        FFS_CHECK_RESULT(ffsLinuxWriteDnsCache(&serializedStream, userContext->dnsCachePath));
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Record the outcome of a request in the DNS cache (event loop lock
+ * held).
+ *
+ * A new answer is serialized to the given stream (if any), to be persisted
+ * once the lock is released.
+ */
+static FFS_RESULT ffsHttpRecordDnsOutcome(FfsDnsCache_t *dnsCache, FfsHttpRequest_t *request, CURLcode curlCode,
+        FFS_DNS_CACHE_LOOKUP_RESULT lookupResult, const char *primaryIp, uint32_t resolveDurationMs,
+        FfsStream_t *serializedStream)
+{
+    uint32_t nowMs = ffsLinuxGetDnsCacheTimeMs();
+
+    if (lookupResult == FFS_DNS_CACHE_HIT) {
+
+        // Drop a cached address that no longer answers.
+        if (curlCode == CURLE_COULDNT_CONNECT) {
+            FFS_CHECK_RESULT(ffsDnsCacheRemove(dnsCache, &request->url.hostStream));
+        }
+        return FFS_SUCCESS;
+    }
+
+    if (curlCode == CURLE_COULDNT_RESOLVE_HOST) {
+        FFS_CHECK_RESULT(ffsDnsCacheInsertNegative(dnsCache, &request->url.hostStream, resolveDurationMs, nowMs));
+        return FFS_SUCCESS;
+    }
+
+    // Did we get as far as connecting?
+    if (curlCode != CURLE_OK || !primaryIp || !*primaryIp) {
+        return FFS_SUCCESS;
+    }
+
+    FFS_CHECK_RESULT(ffsDnsCacheInsert(dnsCache, &request->url.hostStream, primaryIp,
+            FFS_LINUX_DNS_CACHE_TTL_MS, resolveDurationMs, nowMs));
+
+    if (serializedStream) {
+        FFS_CHECK_RESULT(ffsDnsCacheSerialize(dnsCache, nowMs, serializedStream));
     }
 
     return FFS_SUCCESS;
@@ -322,71 +1122,104 @@ static FFS_RESULT ffsHttpConstructHeaderLine(FfsHttpHeader_t *header, char **hea
     return FFS_SUCCESS;
 }
 
+/** @brief Split a response header line into its trimmed name and value.
+ *
+ * @returns False for lines that are not "name: value" headers
+ */
+static bool ffsHttpParseResponseHeader(char *buffer, size_t size, FfsStream_t *nameStream,
+        FfsStream_t *valueStream)
+{
+    char *separator = memchr(buffer, HEADER_LINE_SEPARATOR, size);
+    if (!separator) {
+        return false;
+    }
+
+    char *nameStart = buffer;
+    while (nameStart < separator && isspace(*nameStart)) {
+        nameStart++;
+    }
+    if (nameStart == separator) {
+
+        // No name, whitespace only.
+        return false;
+    }
+
+    char *nameEnd = separator;
+    while (nameEnd > nameStart && isspace(*(nameEnd - 1))) {
+        nameEnd--;
+    }
+
+    // No value is allowed.
+    char *valueStart = separator + 1;
+    char *valueEnd = buffer + size;
+    while (valueStart < valueEnd && isspace(*valueStart)) {
+        valueStart++;
+    }
+    while (valueEnd > valueStart && isspace(*(valueEnd - 1))) {
+        valueEnd--;
+    }
+
+    *nameStream = ffsCreateInputStream((uint8_t *) nameStart, nameEnd - nameStart);
+    *valueStream = ffsCreateInputStream((uint8_t *) valueStart, valueEnd - valueStart);
+
+    return true;
+}
+
 /** @brief Callback to parse a response header.
  *
  * @param buffer Response header buffer.
  * @param itemSize Always 1
  * @param itemCount Size of data
- * @param httpClientCallbackData Callbacks
+ * @param operation HTTP operation
  *
  * @returns Size of the data processed or 0 on failure
  */
 static size_t ffsHttpHandleResponseHeader(char *buffer, size_t itemSize, size_t itemCount,
-        FfsHttpClientCallbackData_t *httpClientCallbackData)
+        FfsHttpOperation_t *operation)
 {
     // Get the total size of the header data.
     size_t totalSize = itemCount * itemSize;
 
-    // Is there a callback?
-    if (httpClientCallbackData->request->callbacks.handleHeader) {
-
-        // Parsing
-        char *separator = memchr(buffer, HEADER_LINE_SEPARATOR, totalSize);
-        if (!separator) {
-
-            // Status line or custom header.
-            return totalSize;
-        }
-
-        char *nameStart = buffer;
-        while (nameStart < separator && isspace(*nameStart)) {
-            nameStart++;
-        }
-        if (nameStart == separator) {
+    // Abort the transfer if cancelled.
+    if (ffsHttpIsCancelled(operation)) {
+        return 0;
+    }
 
-            // No name, whitespace only.
-            return totalSize;
+    // A new status line (\a e.g. after "100 Continue") starts a new set of headers.
+    if (operation->trace && totalSize >= 5 && !memcmp(buffer, "HTTP/", 5)) {
+        FfsHttpTraceExchange_t *trace = operation->trace;
+        for (uint8_t i = 0; i < trace->responseHeaderCount; i++) {
+            free(trace->responseHeaders[i].name);
+            free(trace->responseHeaders[i].value);
         }
+        trace->responseHeaderCount = 0;
+    }
 
-        char *nameEnd = separator - 1;
-        while (nameEnd >= nameStart && isspace(*nameEnd)) {
-            nameEnd--;
-        }
+    FfsStream_t nameStream;
+    FfsStream_t valueStream;
+    if (!ffsHttpParseResponseHeader(buffer, totalSize, &nameStream, &valueStream)) {
 
-        char *valueStart = separator + 1;
-        char *valueEnd = buffer + totalSize - 1;
-        while (valueStart < buffer + totalSize && isspace(*valueStart)) {
-            valueStart++;
-        }
-        if (valueStart == buffer + totalSize) {
+        // Status line, custom header or whitespace only.
+        return totalSize;
+    }
 
-            // No value, but that is allowed.
-            valueEnd = valueStart;
-        } else {
-            while (valueEnd > separator && isspace(*valueEnd)) {
-                valueEnd--;
-            }
+    // Record the header.
+    if (operation->trace && operation->trace->responseHeaderCount < FFS_HTTP_TRACE_MAXIMUM_HEADER_COUNT) {
+        FfsHttpTraceHeader_t *traceHeader =
+                &operation->trace->responseHeaders[operation->trace->responseHeaderCount++];
+        traceHeader->name = ffsHttpCopyStream(&nameStream);
+        traceHeader->value = ffsHttpCopyStream(&valueStream);
+        if (!traceHeader->name || !traceHeader->value) {
+            return 0;
         }
+    }
 
-        FfsStream_t nameStream = ffsCreateInputStream((uint8_t *) nameStart, nameEnd - nameStart + 1);
-        FfsStream_t valueStream;
-        if (valueStart != valueEnd) {
-            valueStream = ffsCreateInputStream((uint8_t *) valueStart, valueEnd - valueStart + 1);
-        }
+    // Is there a callback?
+    if (operation->request->callbacks.handleHeader) {
 
         // Run the callback.
-        FFS_RESULT result = httpClientCallbackData->request->callbacks.handleHeader(&nameStream, &valueStream,
-                httpClientCallbackData->callbackDataPointer);
+        FFS_RESULT result = operation->request->callbacks.handleHeader(&nameStream, &valueStream,
+                operation->callbackDataPointer);
 
         // Error?
         if (result != FFS_SUCCESS) {
@@ -402,34 +1235,83 @@ static size_t ffsHttpHandleResponseHeader(char *buffer, size_t itemSize, size_t
  * @param buffer Response data buffer.
  * @param itemSize Always 1
  * @param itemCount Size of data
- * @param httpClientCallbackData HTTP client callback data
+ * @param operation HTTP operation
  *
  * @returns Size of the data processed or 0 on failure
  */
 static size_t ffsHttpHandleResponseBody(char *buffer, size_t itemSize, size_t itemCount,
-        FfsHttpClientCallbackData_t *httpClientCallbackData)
+        FfsHttpOperation_t *operation)
 {
     // Get the body size.
     size_t totalSize = itemCount * itemSize;
 
+    // Abort the transfer if cancelled.
+    if (ffsHttpIsCancelled(operation)) {
+        return 0;
+    }
+
+    // Does an emulated reset cut this data short?
+    size_t deliverSize = totalSize;
+    bool isReset = false;
+    if (operation->impairment.fault == FFS_NETWORK_FAULT_RESET
+            && operation->bodySize + totalSize > operation->impairment.resetOffset) {
+        deliverSize = operation->impairment.resetOffset - operation->bodySize;
+        isReset = true;
+    }
+
+    if (ffsHttpDeliverResponseBody(operation, buffer, deliverSize)) {
+        return 0;
+    }
+
+    // Record the delivered data.
+    if (operation->trace && deliverSize) {
+        FfsHttpTraceExchange_t *trace = operation->trace;
+        uint8_t *responseBody = (uint8_t *) realloc(trace->responseBody, trace->responseBodySize + deliverSize);
+        if (!responseBody) {
+            return 0;
+        }
+        memcpy(responseBody + trace->responseBodySize, buffer, deliverSize);
+        trace->responseBody = responseBody;
+        trace->responseBodySize += deliverSize;
+    }
+    operation->bodySize += deliverSize;
+
+    if (isReset) {
+        operation->injectedCode = CURLE_RECV_ERROR;
+        return 0;
+    }
+
+    return totalSize;
+}
+
+/** @brief Run the body callback, in chunks no larger than the emulated read size.
+ */
+static FFS_RESULT ffsHttpDeliverResponseBody(FfsHttpOperation_t *operation, char *buffer, size_t size)
+{
     // Is there a callback?
-    if (httpClientCallbackData->request->callbacks.handleBody) {
+    if (!operation->request->callbacks.handleBody) {
+        return FFS_SUCCESS;
+    }
+
+    while (size) {
+        size_t chunkSize = size;
+        if (operation->impairment.maximumReadSize && chunkSize > operation->impairment.maximumReadSize) {
+            chunkSize = operation->impairment.maximumReadSize;
+        }
 
         // Wrap the buffer.
-        FfsStream_t bodyStream = ffsCreateInputStream((uint8_t *) buffer, totalSize);
+        FfsStream_t bodyStream = ffsCreateInputStream((uint8_t *) buffer, chunkSize);
 
         ffsLogStream("POST response body", &bodyStream);
-        ffsLogDebug("%.*s", totalSize, buffer);
+        ffsLogDebug("%.*s", (int) chunkSize, buffer);
 
         // Run the callback.
-        FFS_RESULT result = httpClientCallbackData->request->callbacks.handleBody(&bodyStream,
-                httpClientCallbackData->callbackDataPointer);
+        FFS_CHECK_RESULT(operation->request->callbacks.handleBody(&bodyStream,
+                operation->callbackDataPointer));
 
-        // Error?
-        if (result != FFS_SUCCESS) {
-            return 0;
-        }
+        buffer += chunkSize;
+        size -= chunkSize;
     }
 
-    return totalSize;
+    return FFS_SUCCESS;
 }
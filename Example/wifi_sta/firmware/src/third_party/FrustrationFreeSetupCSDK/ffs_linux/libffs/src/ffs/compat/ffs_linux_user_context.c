@@ -20,8 +20,12 @@
 #include "ffs/compat/ffs_wifi_provisionee_compat.h"
 #include "ffs/linux/ffs_wifi_scan_list.h"
 
+#include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <openssl/x509.h>
+#include <stdio.h>
+#include <unistd.h>
 
 #define FFS_TASK_WIFI_SEMAPHORE                     "/wj_task_wifi_semaphore"
 #define BACKGROUND_WIFI_SCAN_SEMAPHORE_NAME         "/scan_complete_semaphore"
@@ -30,6 +34,8 @@
 #define DSS_SERVER_CA_CERTIFICATES_PATH             "./data/dss_certificates/"
 #define DSS_CLIENT_CERTIFICATE_PATH                 "./data/device_certificate/certificate.pem"
 #define DSS_CLIENT_CERTIFICATE_PRIVATE_KEY_PATH     "./data/device_certificate/private_key.pem"
+#define DNS_CACHE_PATH                              "./data/dns_cache.bin"
+#define PROVISIONEE_CHECKPOINT_PATH                 "./data/provisionee_checkpoint.bin"
 
 #define DSS_HOST_NAME_BUFFER_SIZE                   (256)
 #define DSS_SESSION_ID_BUFFER_SIZE                  (1024)
@@ -43,6 +49,9 @@ static FFS_RESULT ffsInitializeDevicePublicKey(struct FfsUserContext_s *userCont
  * Initialize the Ffs Wi-Fi Linux user context.
  */
 FFS_RESULT ffsInitializeUserContext(FfsUserContext_t *userContext) {
+    // Start with an empty crypto cache.
+    ffsInitializeLinuxCryptoCache(&userContext->cryptoCache);
+
     // Initialize the Wi-Fi context.
     if (ffsInitializeWifiContext(&userContext->wifiContext)) {
         FFS_CHECK_RESULT(ffsDeinitializeUserContext(userContext));
@@ -86,6 +95,13 @@ FFS_RESULT ffsInitializeUserContext(FfsUserContext_t *userContext) {
     userContext->dssPort = 0;
     userContext->hasDssPort = false;
 
+    // Default to an unimpaired network.
+    userContext->networkImpairment = NULL;
+
+    // Default to neither recording nor replaying HTTP exchanges.
+    userContext->httpTraceRecorder = NULL;
+    userContext->httpTraceReplay = NULL;
+
     // Define the DSS certificate paths.
     userContext->serverCaCertificatesPath = DSS_SERVER_CA_CERTIFICATES_PATH;
     userContext->clientCertificatePath = DSS_CLIENT_CERTIFICATE_PATH;
@@ -139,6 +155,19 @@ FFS_RESULT ffsInitializeUserContext(FfsUserContext_t *userContext) {
         FFS_FAIL(FFS_ERROR);
     }
 
+    // Initialize the DNS cache and restore any persisted answers.
+    if (ffsInitializeDnsCache(&userContext->dnsCache, userContext->dnsCacheEntries,
+            FFS_LINUX_DNS_CACHE_ENTRY_COUNT)) {
+        FFS_CHECK_RESULT(ffsDeinitializeUserContext(userContext));
+        FFS_FAIL(FFS_ERROR);
+    }
+    userContext->dnsCachePath = DNS_CACHE_PATH;
+    if (ffsLinuxLoadDnsCache(&userContext->dnsCache, userContext->dnsCachePath)) {
+        ffsLogWarning("Ignoring unreadable DNS cache");
+    }
+
+    userContext->provisioneeCheckpointPath = PROVISIONEE_CHECKPOINT_PATH;
+
     return FFS_SUCCESS;
 }
 
@@ -176,7 +205,11 @@ FFS_RESULT ffsDeinitializeUserContext(FfsUserContext_t *userContext) {
     if (userContext->nonceBuffer) free(userContext->nonceBuffer);
     if (userContext->bodyBuffer) free(userContext->bodyBuffer);
 
-    // Free the EVP_PKEY structures.
+    // Report the DNS cache statistics.
+    if (userContext->dnsCache.entries) ffsDnsCacheLogStatistics(&userContext->dnsCache);
+
+    // Release the cached contexts, then free the EVP_PKEY structures.
+    ffsInvalidateLinuxCryptoCache(&userContext->cryptoCache);
     if (userContext->cloudPublicKey) EVP_PKEY_free(userContext->cloudPublicKey);
     if (userContext->devicePrivateKey) EVP_PKEY_free(userContext->devicePrivateKey);
     if (userContext->devicePublicKey) EVP_PKEY_free(userContext->devicePublicKey);
@@ -403,6 +436,88 @@ FFS_RESULT ffsWifiProvisioneeCanGetWifiCredentials(struct FfsUserContext_s *user
     return FFS_SUCCESS;
 }
 
+/*
+ * Save the provisioning checkpoint.
+ *
+ * The record is written to a temporary file and renamed over the previous
+ * one, so a crash during the write leaves the previous checkpoint.
+ */
+FFS_RESULT ffsSaveWifiProvisioneeCheckpoint(struct FfsUserContext_s *userContext,
+        FfsStream_t *checkpointStream)
+{
+    char temporaryPath[PATH_MAX];
+
+    if (!userContext->provisioneeCheckpointPath) {
+        return FFS_NOT_IMPLEMENTED;
+    }
+
+    if (snprintf(temporaryPath, sizeof(temporaryPath), "%s.tmp", userContext->provisioneeCheckpointPath)
+            >= (int) sizeof(temporaryPath)) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    FILE *file = fopen(temporaryPath, "wb");
+    if (!file) {
+        ffsLogWarning("Unable to open checkpoint file %s", temporaryPath);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    size_t dataSize = FFS_STREAM_DATA_SIZE(*checkpointStream);
+    bool isWritten = fwrite(FFS_STREAM_NEXT_READ(*checkpointStream), 1, dataSize, file) == dataSize
+            && !fflush(file) && !fsync(fileno(file));
+    fclose(file);
+
+    if (!isWritten || rename(temporaryPath, userContext->provisioneeCheckpointPath)) {
+        unlink(temporaryPath);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Load the provisioning checkpoint.
+ */
+FFS_RESULT ffsLoadWifiProvisioneeCheckpoint(struct FfsUserContext_s *userContext,
+        FfsStream_t *checkpointStream)
+{
+    if (!userContext->provisioneeCheckpointPath) {
+        return FFS_NOT_IMPLEMENTED;
+    }
+
+    FILE *file = fopen(userContext->provisioneeCheckpointPath, "rb");
+    if (!file) {
+        if (errno == ENOENT) {
+            return FFS_SUCCESS;
+        }
+        ffsLogWarning("Unable to open checkpoint file %s", userContext->provisioneeCheckpointPath);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    size_t readSize = fread(FFS_STREAM_NEXT_WRITE(*checkpointStream), 1, FFS_STREAM_SPACE_SIZE(*checkpointStream),
+            file);
+    fclose(file);
+    checkpointStream->dataSize += readSize;
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Remove the stored provisioning checkpoint.
+ */
+FFS_RESULT ffsClearWifiProvisioneeCheckpoint(struct FfsUserContext_s *userContext)
+{
+    if (!userContext->provisioneeCheckpointPath) {
+        return FFS_NOT_IMPLEMENTED;
+    }
+
+    if (unlink(userContext->provisioneeCheckpointPath) && errno != ENOENT) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
+
 /*
  * Extracts device public key from a file containing the device certificate or certificate chain.
  */
@@ -112,6 +112,11 @@ FFS_RESULT ffsConnectToWifi(struct FfsUserContext_s *userContext)
     uint16_t port;
     FFS_CHECK_RESULT(ffsDssClientGetDefaultHost(userContext, &dssHostStream, &port));
 
+    // Negative DNS answers from the previous network do not apply to the next one.
+    if (userContext->dnsCache.entries) {
+        FFS_CHECK_RESULT(ffsDnsCacheFlushNegative(&userContext->dnsCache));
+    }
+
     // Start the connection attempts.
     FFS_CHECK_RESULT(ffsWifiManagerConnect(FFS_WIFI_WPA_SUPPLICANT_CONFIGURATION_FILE, &dssHostStream,
             ffsWifiManagerOperationCallback));
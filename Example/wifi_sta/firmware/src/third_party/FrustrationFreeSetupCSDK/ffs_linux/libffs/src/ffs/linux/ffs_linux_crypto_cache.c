@@ -0,0 +1,232 @@
+/** @file ffs_linux_crypto_cache.c
+ *
+ * @brief Per-user-context cache of OpenSSL keys and contexts.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_check_result.h"
+#include "ffs/common/ffs_logging.h"
+#include "ffs/linux/ffs_linux_crypto_cache.h"
+#include "ffs/linux/ffs_linux_crypto_common.h"
+
+#include <openssl/x509.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define OPENSSL_SUCCESS                     (1)
+
+// Static function prototypes.
+static void ffsFreeCachedDigestContext(FfsLinuxCachedDigestContext_t *cachedContext);
+static void ffsFreeCachedDeriveContext(FfsLinuxCachedDeriveContext_t *cachedContext);
+static void ffsFreeCachedDerKey(FfsLinuxCachedDerKey_t *cachedKey);
+static FFS_RESULT ffsGetCachedDigestContext(FfsLinuxCachedDigestContext_t *cachedContext, EVP_PKEY *key,
+        bool isSigning, EVP_MD_CTX **context);
+
+/*
+ * Initialize an empty crypto cache.
+ */
+void ffsInitializeLinuxCryptoCache(FfsLinuxCryptoCache_t *cache)
+{
+    memset(cache, 0, sizeof(*cache));
+}
+
+/*
+ * Empty the crypto cache.
+ */
+void ffsInvalidateLinuxCryptoCache(FfsLinuxCryptoCache_t *cache)
+{
+    ffsFreeCachedDigestContext(&cache->signContext);
+    ffsFreeCachedDigestContext(&cache->verifyContext);
+    ffsFreeCachedDeriveContext(&cache->deriveContext);
+    ffsFreeCachedDerKey(&cache->devicePublicKeyDer);
+    ffsFreeCachedDerKey(&cache->cloudPublicKeyDer);
+}
+
+/*
+ * Get a SHA-256 signing context.
+ */
+FFS_RESULT ffsGetCachedSignContext(FfsLinuxCryptoCache_t *cache, EVP_PKEY *privateKey,
+        EVP_MD_CTX **context)
+{
+    FFS_CHECK_RESULT(ffsGetCachedDigestContext(&cache->signContext, privateKey, true, context));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Get a SHA-256 verification context.
+ */
+FFS_RESULT ffsGetCachedVerifyContext(FfsLinuxCryptoCache_t *cache, EVP_PKEY *publicKey,
+        EVP_MD_CTX **context)
+{
+    FFS_CHECK_RESULT(ffsGetCachedDigestContext(&cache->verifyContext, publicKey, false, context));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Get an ECDH derivation context for a peer public key.
+ */
+FFS_RESULT ffsGetCachedDeriveContext(FfsLinuxCryptoCache_t *cache, EVP_PKEY *privateKey,
+        FfsStream_t *peerDerStream, EVP_PKEY_CTX **context)
+{
+    FfsLinuxCachedDeriveContext_t *cachedContext = &cache->deriveContext;
+    size_t peerDerSize = FFS_STREAM_DATA_SIZE(*peerDerStream);
+
+    if (!privateKey) {
+        ffsLogError("No private key for ECDH");
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    // Hit: same private key and peer key.
+    if (cachedContext->context && cachedContext->privateKey == privateKey
+            && cachedContext->peerDerSize && cachedContext->peerDerSize == peerDerSize
+            && !memcmp(cachedContext->peerDer, FFS_STREAM_NEXT_READ(*peerDerStream), peerDerSize)) {
+        *context = cachedContext->context;
+        return FFS_SUCCESS;
+    }
+
+    ffsFreeCachedDeriveContext(cachedContext);
+
+    // Parse the peer key.
+    EVP_PKEY *peerKey = NULL;
+    FFS_CHECK_RESULT(ffsGetEVPKeyFromDerStream(peerDerStream, &peerKey));
+
+    // Bind a context to both keys (it keeps its own reference to the peer key).
+    EVP_PKEY_CTX *deriveContext = EVP_PKEY_CTX_new(privateKey, NULL);
+    if (!deriveContext || EVP_PKEY_derive_init(deriveContext) != OPENSSL_SUCCESS
+            || EVP_PKEY_derive_set_peer(deriveContext, peerKey) != OPENSSL_SUCCESS
+            || EVP_PKEY_up_ref(privateKey) != OPENSSL_SUCCESS) {
+        ffsLogError("Failed to initialize ECDH context.");
+        EVP_PKEY_CTX_free(deriveContext);
+        EVP_PKEY_free(peerKey);
+        FFS_FAIL(FFS_ERROR);
+    }
+    EVP_PKEY_free(peerKey);
+
+    cachedContext->privateKey = privateKey;
+    cachedContext->context = deriveContext;
+    if (peerDerSize <= sizeof(cachedContext->peerDer)) {
+        memcpy(cachedContext->peerDer, FFS_STREAM_NEXT_READ(*peerDerStream), peerDerSize);
+        cachedContext->peerDerSize = peerDerSize;
+    }
+
+    *context = deriveContext;
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Write the DER encoding of a public key.
+ */
+FFS_RESULT ffsGetCachedDerEncodedPublicKey(FfsLinuxCachedDerKey_t *cachedKey, EVP_PKEY *publicKey,
+        FfsStream_t *derStream)
+{
+    if (!publicKey) {
+        ffsLogError("Unable to read given public key");
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    if (cachedKey->key != publicKey) {
+        ffsFreeCachedDerKey(cachedKey);
+
+        // Keys that do not fit are encoded every time.
+        int derSize = i2d_PUBKEY(publicKey, NULL);
+        if (derSize <= 0 || (size_t) derSize > sizeof(cachedKey->der)) {
+            FFS_CHECK_RESULT(ffsGetDerEncodedPublicKeyFromEVPKey(publicKey, derStream));
+            return FFS_SUCCESS;
+        }
+
+        FfsStream_t cacheStream = ffsCreateOutputStream(cachedKey->der, sizeof(cachedKey->der));
+        FFS_CHECK_RESULT(ffsGetDerEncodedPublicKeyFromEVPKey(publicKey, &cacheStream));
+        if (EVP_PKEY_up_ref(publicKey) != OPENSSL_SUCCESS) {
+            FFS_FAIL(FFS_ERROR);
+        }
+        cachedKey->key = publicKey;
+        cachedKey->derSize = FFS_STREAM_DATA_SIZE(cacheStream);
+    }
+
+    FFS_CHECK_RESULT(ffsWriteStream(cachedKey->der, cachedKey->derSize, derStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Release a cached digest context.
+ */
+static void ffsFreeCachedDigestContext(FfsLinuxCachedDigestContext_t *cachedContext)
+{
+    EVP_MD_CTX_free(cachedContext->initializedContext);
+    EVP_MD_CTX_free(cachedContext->context);
+    EVP_PKEY_free(cachedContext->key);
+    memset(cachedContext, 0, sizeof(*cachedContext));
+}
+
+/** @brief Release a cached derivation context.
+ */
+static void ffsFreeCachedDeriveContext(FfsLinuxCachedDeriveContext_t *cachedContext)
+{
+    EVP_PKEY_CTX_free(cachedContext->context);
+    EVP_PKEY_free(cachedContext->privateKey);
+    memset(cachedContext, 0, sizeof(*cachedContext));
+}
+
+/** @brief Release a cached DER encoding.
+ */
+static void ffsFreeCachedDerKey(FfsLinuxCachedDerKey_t *cachedKey)
+{
+    EVP_PKEY_free(cachedKey->key);
+    memset(cachedKey, 0, sizeof(*cachedKey));
+}
+
+/** @brief Get a working copy of a digest context initialized for a key.
+ *
+ * Copying the initialized context skips the digest and key method lookups of
+ * a fresh initialization.
+ */
+static FFS_RESULT ffsGetCachedDigestContext(FfsLinuxCachedDigestContext_t *cachedContext, EVP_PKEY *key,
+        bool isSigning, EVP_MD_CTX **context)
+{
+    if (!key) {
+        ffsLogError("No key for the signature");
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    if (cachedContext->key != key) {
+        ffsFreeCachedDigestContext(cachedContext);
+
+        EVP_MD_CTX *initializedContext = EVP_MD_CTX_new();
+        EVP_MD_CTX *workingContext = EVP_MD_CTX_new();
+        int rc = initializedContext && workingContext ? OPENSSL_SUCCESS : 0;
+        if (rc == OPENSSL_SUCCESS) {
+            rc = isSigning ? EVP_DigestSignInit(initializedContext, NULL, EVP_sha256(), NULL, key)
+                    : EVP_DigestVerifyInit(initializedContext, NULL, EVP_sha256(), NULL, key);
+        }
+        if (rc != OPENSSL_SUCCESS || EVP_PKEY_up_ref(key) != OPENSSL_SUCCESS) {
+            EVP_MD_CTX_free(initializedContext);
+            EVP_MD_CTX_free(workingContext);
+            FFS_FAIL(FFS_ERROR);
+        }
+
+        cachedContext->key = key;
+        cachedContext->initializedContext = initializedContext;
+        cachedContext->context = workingContext;
+    }
+
+    if (EVP_MD_CTX_copy_ex(cachedContext->context, cachedContext->initializedContext) != OPENSSL_SUCCESS) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    *context = cachedContext->context;
+
+    return FFS_SUCCESS;
+}
@@ -0,0 +1,94 @@
+/** @file ffs_linux_dns_cache.c
+ *
+ * @brief Linux DNS answer cache persistence and clock implementation.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_check_result.h"
+#include "ffs/common/ffs_logging.h"
+#include "ffs/linux/ffs_linux_dns_cache.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * Get the current monotonic time in milliseconds.
+ */
+uint32_t ffsLinuxGetDnsCacheTimeMs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint32_t) ((uint64_t) now.tv_sec * 1000 + now.tv_nsec / 1000000);
+}
+
+/*
+ * Load a serialized DNS cache from a file.
+ */
+FFS_RESULT ffsLinuxLoadDnsCache(FfsDnsCache_t *cache, const char *path)
+{
+    FFS_TEMPORARY_OUTPUT_STREAM(serializedStream, FFS_LINUX_DNS_CACHE_BUFFER_SIZE);
+
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        if (errno == ENOENT) {
+            return FFS_SUCCESS;
+        }
+        ffsLogWarning("Unable to open DNS cache file %s", path);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    size_t readSize = fread(FFS_STREAM_NEXT_WRITE(serializedStream), 1,
+            FFS_STREAM_SPACE_SIZE(serializedStream), file);
+    fclose(file);
+    serializedStream.dataSize += readSize;
+
+    FFS_CHECK_RESULT(ffsDnsCacheDeserialize(cache, ffsLinuxGetDnsCacheTimeMs(), &serializedStream));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Save the DNS cache to a file.
+ */
+FFS_RESULT ffsLinuxSaveDnsCache(FfsDnsCache_t *cache, const char *path)
+{
+    FFS_TEMPORARY_OUTPUT_STREAM(serializedStream, FFS_LINUX_DNS_CACHE_BUFFER_SIZE);
+
+    FFS_CHECK_RESULT(ffsDnsCacheSerialize(cache, ffsLinuxGetDnsCacheTimeMs(), &serializedStream));
+    FFS_CHECK_RESULT(ffsLinuxWriteDnsCache(&serializedStream, path));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Write a serialized DNS cache to a file.
+ */
+FFS_RESULT ffsLinuxWriteDnsCache(FfsStream_t *serializedStream, const char *path)
+{
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        ffsLogWarning("Unable to open DNS cache file %s", path);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    size_t dataSize = FFS_STREAM_DATA_SIZE(*serializedStream);
+    size_t writtenSize = fwrite(FFS_STREAM_NEXT_READ(*serializedStream), 1, dataSize, file);
+    fclose(file);
+
+    if (writtenSize != dataSize) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
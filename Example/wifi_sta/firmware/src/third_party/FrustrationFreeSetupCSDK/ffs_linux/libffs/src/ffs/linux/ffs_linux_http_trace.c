@@ -0,0 +1,766 @@
+/** @file ffs_linux_http_trace.c
+ *
+ * @brief Record and replay of HTTP exchanges.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_base64.h"
+#include "ffs/common/ffs_check_result.h"
+#include "ffs/common/ffs_logging.h"
+#include "ffs/common/ffs_stream.h"
+#include "ffs/linux/ffs_linux_http_trace.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define FFS_HTTP_TRACE_MAGIC_SIZE       (4)
+#define FFS_HTTP_TRACE_MAXIMUM_STRING   (UINT16_MAX)
+
+/*
+ * Keys that differ between otherwise identical provisioning sessions.
+ */
+const char * const FFS_HTTP_TRACE_DEFAULT_VOLATILE_KEYS[] = {
+    "nonce",
+    "rssi",
+    NULL
+};
+
+/** @brief Read cursor over a loaded trace.
+ */
+typedef struct {
+    const uint8_t *data;                //!< Trace data.
+    size_t size;                        //!< Trace size.
+    size_t offset;                      //!< Read offset.
+} FfsHttpTraceCursor_t;
+
+// Static function prototypes.
+static FFS_RESULT ffsHttpTraceWriteInteger(FILE *file, uint32_t value, size_t size);
+static FFS_RESULT ffsHttpTraceWriteString(FILE *file, const char *string);
+static FFS_RESULT ffsHttpTraceWriteBlob(FILE *file, const uint8_t *data, uint32_t size);
+static FFS_RESULT ffsHttpTraceWriteHeaders(FILE *file, const FfsHttpTraceHeader_t *headers, uint8_t count);
+static FFS_RESULT ffsHttpTraceReadInteger(FfsHttpTraceCursor_t *cursor, size_t size, uint32_t *value);
+static FFS_RESULT ffsHttpTraceReadBytes(FfsHttpTraceCursor_t *cursor, size_t lengthSize, uint8_t **data,
+        uint32_t *size);
+static FFS_RESULT ffsHttpTraceReadString(FfsHttpTraceCursor_t *cursor, char **string);
+static FFS_RESULT ffsHttpTraceReadHeaders(FfsHttpTraceCursor_t *cursor, FfsHttpTraceHeader_t *headers,
+        uint8_t *count);
+static FFS_RESULT ffsHttpTraceReadExchange(FfsHttpTraceCursor_t *cursor, FfsHttpTraceExchange_t *exchange);
+static size_t ffsHttpTraceSkipWhitespace(const uint8_t *data, size_t size, size_t offset);
+static size_t ffsHttpTraceSkipString(const uint8_t *data, size_t size, size_t offset);
+static size_t ffsHttpTraceSkipValue(const uint8_t *data, size_t size, size_t offset);
+static bool ffsHttpTraceIsKey(const uint8_t *data, size_t size, size_t keyStart, size_t keyEnd,
+        const char *key);
+static bool ffsHttpTraceIsVolatileKey(const uint8_t *data, size_t size, size_t keyStart, size_t keyEnd,
+        const char * const *volatileKeys);
+static size_t ffsHttpTraceCanonicalize(const uint8_t *data, size_t size, const char * const *volatileKeys,
+        uint8_t *canonical);
+static bool ffsHttpTraceFindStringValue(const uint8_t *data, size_t size, const char *key, size_t *valueStart,
+        size_t *valueSize);
+static FFS_RESULT ffsHttpTraceReplaceAll(uint8_t **body, size_t *bodySize, const uint8_t *from, size_t fromSize,
+        const uint8_t *to, size_t toSize);
+static FFS_RESULT ffsHttpTraceSign(EVP_PKEY *signingKey, const uint8_t *body, size_t bodySize,
+        char **signature);
+
+/*
+ * Open a trace file for recording.
+ */
+FFS_RESULT ffsOpenHttpTraceRecorder(FfsHttpTraceRecorder_t *recorder, const char *path)
+{
+    memset(recorder, 0, sizeof(*recorder));
+
+    recorder->file = fopen(path, "wb");
+    if (!recorder->file) {
+        ffsLogError("Unable to open HTTP trace file %s", path);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    if (fwrite(FFS_HTTP_TRACE_MAGIC, 1, FFS_HTTP_TRACE_MAGIC_SIZE, recorder->file) != FFS_HTTP_TRACE_MAGIC_SIZE) {
+        FFS_CHECK_RESULT(ffsCloseHttpTraceRecorder(recorder));
+        FFS_FAIL(FFS_ERROR);
+    }
+    FFS_CHECK_RESULT(ffsHttpTraceWriteInteger(recorder->file, FFS_HTTP_TRACE_VERSION, 1));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Append an exchange to the trace.
+ */
+FFS_RESULT ffsRecordHttpTraceExchange(FfsHttpTraceRecorder_t *recorder, const FfsHttpTraceExchange_t *exchange)
+{
+    FILE *file = recorder->file;
+
+    if (!file) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    FFS_CHECK_RESULT(ffsHttpTraceWriteInteger(file, exchange->gapMs, 4));
+    FFS_CHECK_RESULT(ffsHttpTraceWriteInteger(file, exchange->durationMs, 4));
+    FFS_CHECK_RESULT(ffsHttpTraceWriteInteger(file, exchange->operation, 1));
+    FFS_CHECK_RESULT(ffsHttpTraceWriteInteger(file, exchange->scheme, 1));
+    FFS_CHECK_RESULT(ffsHttpTraceWriteInteger(file, exchange->port, 2));
+    FFS_CHECK_RESULT(ffsHttpTraceWriteInteger(file, (uint8_t) exchange->result, 1));
+    FFS_CHECK_RESULT(ffsHttpTraceWriteInteger(file, (uint32_t) exchange->statusCode, 4));
+    FFS_CHECK_RESULT(ffsHttpTraceWriteString(file, exchange->host));
+    FFS_CHECK_RESULT(ffsHttpTraceWriteString(file, exchange->path));
+    FFS_CHECK_RESULT(ffsHttpTraceWriteHeaders(file, exchange->requestHeaders, exchange->requestHeaderCount));
+    FFS_CHECK_RESULT(ffsHttpTraceWriteBlob(file, exchange->requestBody, exchange->requestBodySize));
+    FFS_CHECK_RESULT(ffsHttpTraceWriteHeaders(file, exchange->responseHeaders, exchange->responseHeaderCount));
+    FFS_CHECK_RESULT(ffsHttpTraceWriteBlob(file, exchange->responseBody, exchange->responseBodySize));
+
+    // Keep the trace usable if the process dies part way through a session.
+    fflush(file);
+
+    recorder->exchangeCount++;
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Close the trace file.
+ */
+FFS_RESULT ffsCloseHttpTraceRecorder(FfsHttpTraceRecorder_t *recorder)
+{
+    if (!recorder->file) {
+        return FFS_SUCCESS;
+    }
+
+    int closeResult = fclose(recorder->file);
+    recorder->file = NULL;
+
+    if (closeResult) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Load a trace file for replay.
+ */
+FFS_RESULT ffsLoadHttpTrace(FfsHttpTraceReplay_t *replay, const char *path, uint32_t timeWarpPercent,
+        EVP_PKEY *signingKey)
+{
+    memset(replay, 0, sizeof(*replay));
+    replay->timeWarpPercent = timeWarpPercent;
+    replay->signingKey = signingKey;
+    replay->volatileKeys = FFS_HTTP_TRACE_DEFAULT_VOLATILE_KEYS;
+
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        ffsLogError("Unable to open HTTP trace file %s", path);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    // Read the whole trace.
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (fileSize < FFS_HTTP_TRACE_MAGIC_SIZE + 1) {
+        fclose(file);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    uint8_t *data = (uint8_t *) malloc((size_t) fileSize);
+    if (!data) {
+        fclose(file);
+        FFS_FAIL(FFS_OVERRUN);
+    }
+    size_t readSize = fread(data, 1, (size_t) fileSize, file);
+    fclose(file);
+
+    FfsHttpTraceCursor_t cursor = {
+        .data = data,
+        .size = readSize,
+        .offset = FFS_HTTP_TRACE_MAGIC_SIZE + 1
+    };
+
+    // Check the header.
+    if (readSize != (size_t) fileSize || memcmp(data, FFS_HTTP_TRACE_MAGIC, FFS_HTTP_TRACE_MAGIC_SIZE)
+            || data[FFS_HTTP_TRACE_MAGIC_SIZE] != FFS_HTTP_TRACE_VERSION) {
+        ffsLogError("%s is not a version %d HTTP trace", path, FFS_HTTP_TRACE_VERSION);
+        free(data);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    // Parse the exchanges.
+    uint32_t capacity = 0;
+    while (cursor.offset < cursor.size) {
+        if (replay->exchangeCount == capacity) {
+            capacity = capacity ? capacity * 2 : 8;
+            FfsHttpTraceExchange_t *exchanges = (FfsHttpTraceExchange_t *) realloc(replay->exchanges,
+                    capacity * sizeof(FfsHttpTraceExchange_t));
+            if (!exchanges) {
+                free(data);
+                ffsFreeHttpTrace(replay);
+                FFS_FAIL(FFS_OVERRUN);
+            }
+            replay->exchanges = exchanges;
+        }
+
+        FfsHttpTraceExchange_t *exchange = &replay->exchanges[replay->exchangeCount];
+        memset(exchange, 0, sizeof(*exchange));
+        FFS_RESULT result = ffsHttpTraceReadExchange(&cursor, exchange);
+        if (result != FFS_SUCCESS) {
+            ffsLogError("Truncated HTTP trace %s (exchange %u)", path, replay->exchangeCount);
+            ffsFreeHttpTraceExchange(exchange);
+            free(data);
+            ffsFreeHttpTrace(replay);
+            FFS_FAIL(result);
+        }
+        replay->exchangeCount++;
+    }
+
+    free(data);
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Release a loaded trace.
+ */
+void ffsFreeHttpTrace(FfsHttpTraceReplay_t *replay)
+{
+    for (uint32_t i = 0; i < replay->exchangeCount; i++) {
+        ffsFreeHttpTraceExchange(&replay->exchanges[i]);
+    }
+    free(replay->exchanges);
+    replay->exchanges = NULL;
+    replay->exchangeCount = 0;
+    replay->nextExchange = 0;
+}
+
+/*
+ * Release the contents of an exchange.
+ */
+void ffsFreeHttpTraceExchange(FfsHttpTraceExchange_t *exchange)
+{
+    free(exchange->host);
+    free(exchange->path);
+    for (uint8_t i = 0; i < exchange->requestHeaderCount; i++) {
+        free(exchange->requestHeaders[i].name);
+        free(exchange->requestHeaders[i].value);
+    }
+    free(exchange->requestBody);
+    for (uint8_t i = 0; i < exchange->responseHeaderCount; i++) {
+        free(exchange->responseHeaders[i].name);
+        free(exchange->responseHeaders[i].value);
+    }
+    free(exchange->responseBody);
+    memset(exchange, 0, sizeof(*exchange));
+}
+
+/*
+ * Are two request bodies semantically equal?
+ */
+bool ffsHttpTraceBodiesMatch(const uint8_t *recordedBody, size_t recordedBodySize, const uint8_t *body,
+        size_t bodySize, const char * const *volatileKeys)
+{
+    uint8_t *recordedCanonical = (uint8_t *) malloc(recordedBodySize + 1);
+    uint8_t *canonical = (uint8_t *) malloc(bodySize + 1);
+    bool isMatch = false;
+
+    if (recordedCanonical && canonical) {
+        size_t recordedCanonicalSize = ffsHttpTraceCanonicalize(recordedBody, recordedBodySize, volatileKeys,
+                recordedCanonical);
+        size_t canonicalSize = ffsHttpTraceCanonicalize(body, bodySize, volatileKeys, canonical);
+
+        isMatch = recordedCanonicalSize == canonicalSize
+                && !memcmp(recordedCanonical, canonical, canonicalSize);
+    }
+
+    free(recordedCanonical);
+    free(canonical);
+
+    return isMatch;
+}
+
+/*
+ * Build the response to a replayed request.
+ */
+FFS_RESULT ffsPrepareHttpTraceResponse(FfsHttpTraceReplay_t *replay, const FfsHttpTraceExchange_t *exchange,
+        const uint8_t *requestBody, size_t requestBodySize, uint8_t **responseBody, size_t *responseBodySize,
+        char **signature)
+{
+    *signature = NULL;
+    *responseBodySize = exchange->responseBodySize;
+    *responseBody = (uint8_t *) malloc(exchange->responseBodySize + 1);
+    if (!*responseBody) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+    if (exchange->responseBodySize) {
+        memcpy(*responseBody, exchange->responseBody, exchange->responseBodySize);
+    }
+
+    // Carry changed volatile values (\a e.g. the nonce) over into the response.
+    for (const char * const *key = replay->volatileKeys; key && *key; key++) {
+        size_t recordedStart, recordedSize, newStart, newSize;
+        if (!ffsHttpTraceFindStringValue(exchange->requestBody, exchange->requestBodySize, *key,
+                &recordedStart, &recordedSize) || !recordedSize
+                || !ffsHttpTraceFindStringValue(requestBody, requestBodySize, *key, &newStart, &newSize)) {
+            continue;
+        }
+        if (recordedSize == newSize
+                && !memcmp(exchange->requestBody + recordedStart, requestBody + newStart, newSize)) {
+            continue;
+        }
+
+        FFS_RESULT result = ffsHttpTraceReplaceAll(responseBody, responseBodySize,
+                exchange->requestBody + recordedStart, recordedSize, requestBody + newStart, newSize);
+        if (result != FFS_SUCCESS) {
+            free(*responseBody);
+            *responseBody = NULL;
+            FFS_FAIL(result);
+        }
+    }
+
+    // Re-sign a signed response.
+    if (replay->signingKey) {
+        for (uint8_t i = 0; i < exchange->responseHeaderCount; i++) {
+            if (strcasecmp(exchange->responseHeaders[i].name, FFS_HTTP_TRACE_SIGNATURE_HEADER)) {
+                continue;
+            }
+
+            FFS_RESULT result = ffsHttpTraceSign(replay->signingKey, *responseBody, *responseBodySize, signature);
+            if (result != FFS_SUCCESS) {
+                free(*responseBody);
+                *responseBody = NULL;
+                FFS_FAIL(result);
+            }
+            break;
+        }
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Write a little-endian integer of 1, 2 or 4 bytes.
+ */
+static FFS_RESULT ffsHttpTraceWriteInteger(FILE *file, uint32_t value, size_t size)
+{
+    uint8_t bytes[4];
+
+    for (size_t i = 0; i < size; i++) {
+        bytes[i] = (uint8_t) (value >> (8 * i));
+    }
+
+    if (fwrite(bytes, 1, size, file) != size) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Write a length-prefixed string (NULL is written as empty).
+ */
+static FFS_RESULT ffsHttpTraceWriteString(FILE *file, const char *string)
+{
+    size_t length = string ? strlen(string) : 0;
+
+    if (length > FFS_HTTP_TRACE_MAXIMUM_STRING) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    FFS_CHECK_RESULT(ffsHttpTraceWriteInteger(file, (uint32_t) length, 2));
+    if (length && fwrite(string, 1, length, file) != length) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Write a length-prefixed blob.
+ */
+static FFS_RESULT ffsHttpTraceWriteBlob(FILE *file, const uint8_t *data, uint32_t size)
+{
+    FFS_CHECK_RESULT(ffsHttpTraceWriteInteger(file, size, 4));
+    if (size && fwrite(data, 1, size, file) != size) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Write a counted list of headers.
+ */
+static FFS_RESULT ffsHttpTraceWriteHeaders(FILE *file, const FfsHttpTraceHeader_t *headers, uint8_t count)
+{
+    FFS_CHECK_RESULT(ffsHttpTraceWriteInteger(file, count, 1));
+
+    for (uint8_t i = 0; i < count; i++) {
+        FFS_CHECK_RESULT(ffsHttpTraceWriteString(file, headers[i].name));
+        FFS_CHECK_RESULT(ffsHttpTraceWriteString(file, headers[i].value));
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Read a little-endian integer of 1, 2 or 4 bytes.
+ */
+static FFS_RESULT ffsHttpTraceReadInteger(FfsHttpTraceCursor_t *cursor, size_t size, uint32_t *value)
+{
+    if (cursor->size - cursor->offset < size) {
+        FFS_FAIL(FFS_UNDERRUN);
+    }
+
+    *value = 0;
+    for (size_t i = 0; i < size; i++) {
+        *value |= (uint32_t) cursor->data[cursor->offset++] << (8 * i);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Read a length-prefixed byte sequence into a new, null-terminated buffer.
+ */
+static FFS_RESULT ffsHttpTraceReadBytes(FfsHttpTraceCursor_t *cursor, size_t lengthSize, uint8_t **data,
+        uint32_t *size)
+{
+    FFS_CHECK_RESULT(ffsHttpTraceReadInteger(cursor, lengthSize, size));
+    if (cursor->size - cursor->offset < *size) {
+        FFS_FAIL(FFS_UNDERRUN);
+    }
+
+    *data = (uint8_t *) malloc(*size + 1);
+    if (!*data) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+    memcpy(*data, cursor->data + cursor->offset, *size);
+    (*data)[*size] = 0;
+    cursor->offset += *size;
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Read a length-prefixed string.
+ */
+static FFS_RESULT ffsHttpTraceReadString(FfsHttpTraceCursor_t *cursor, char **string)
+{
+    uint32_t length;
+
+    FFS_CHECK_RESULT(ffsHttpTraceReadBytes(cursor, 2, (uint8_t **) string, &length));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Read a counted list of headers.
+ */
+static FFS_RESULT ffsHttpTraceReadHeaders(FfsHttpTraceCursor_t *cursor, FfsHttpTraceHeader_t *headers,
+        uint8_t *count)
+{
+    uint32_t headerCount;
+
+    FFS_CHECK_RESULT(ffsHttpTraceReadInteger(cursor, 1, &headerCount));
+    if (headerCount > FFS_HTTP_TRACE_MAXIMUM_HEADER_COUNT) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    for (*count = 0; *count < headerCount; (*count)++) {
+        FFS_CHECK_RESULT(ffsHttpTraceReadString(cursor, &headers[*count].name));
+        FFS_RESULT result = ffsHttpTraceReadString(cursor, &headers[*count].value);
+        if (result != FFS_SUCCESS) {
+            (*count)++;
+            FFS_FAIL(result);
+        }
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Read one exchange.
+ */
+static FFS_RESULT ffsHttpTraceReadExchange(FfsHttpTraceCursor_t *cursor, FfsHttpTraceExchange_t *exchange)
+{
+    uint32_t value;
+
+    FFS_CHECK_RESULT(ffsHttpTraceReadInteger(cursor, 4, &exchange->gapMs));
+    FFS_CHECK_RESULT(ffsHttpTraceReadInteger(cursor, 4, &exchange->durationMs));
+    FFS_CHECK_RESULT(ffsHttpTraceReadInteger(cursor, 1, &value));
+    exchange->operation = (uint8_t) value;
+    FFS_CHECK_RESULT(ffsHttpTraceReadInteger(cursor, 1, &value));
+    exchange->scheme = (uint8_t) value;
+    FFS_CHECK_RESULT(ffsHttpTraceReadInteger(cursor, 2, &value));
+    exchange->port = (uint16_t) value;
+    FFS_CHECK_RESULT(ffsHttpTraceReadInteger(cursor, 1, &value));
+    exchange->result = (int8_t) value;
+    FFS_CHECK_RESULT(ffsHttpTraceReadInteger(cursor, 4, &value));
+    exchange->statusCode = (int32_t) value;
+    FFS_CHECK_RESULT(ffsHttpTraceReadString(cursor, &exchange->host));
+    FFS_CHECK_RESULT(ffsHttpTraceReadString(cursor, &exchange->path));
+    FFS_CHECK_RESULT(ffsHttpTraceReadHeaders(cursor, exchange->requestHeaders, &exchange->requestHeaderCount));
+    FFS_CHECK_RESULT(ffsHttpTraceReadBytes(cursor, 4, &exchange->requestBody, &exchange->requestBodySize));
+    FFS_CHECK_RESULT(ffsHttpTraceReadHeaders(cursor, exchange->responseHeaders, &exchange->responseHeaderCount));
+    FFS_CHECK_RESULT(ffsHttpTraceReadBytes(cursor, 4, &exchange->responseBody, &exchange->responseBodySize));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Skip JSON whitespace.
+ */
+static size_t ffsHttpTraceSkipWhitespace(const uint8_t *data, size_t size, size_t offset)
+{
+    while (offset < size && isspace(data[offset])) {
+        offset++;
+    }
+
+    return offset;
+}
+
+/** @brief Skip a JSON string starting at its opening quote.
+ */
+static size_t ffsHttpTraceSkipString(const uint8_t *data, size_t size, size_t offset)
+{
+    for (offset++; offset < size; offset++) {
+        if (data[offset] == '\\') {
+            offset++;
+        } else if (data[offset] == '"') {
+            return offset + 1;
+        }
+    }
+
+    return size;
+}
+
+/** @brief Skip a JSON value (string, object, array or primitive).
+ */
+static size_t ffsHttpTraceSkipValue(const uint8_t *data, size_t size, size_t offset)
+{
+    if (offset >= size) {
+        return size;
+    }
+
+    if (data[offset] == '"') {
+        return ffsHttpTraceSkipString(data, size, offset);
+    }
+
+    if (data[offset] == '{' || data[offset] == '[') {
+        size_t depth = 0;
+        while (offset < size) {
+            uint8_t character = data[offset];
+            if (character == '"') {
+                offset = ffsHttpTraceSkipString(data, size, offset);
+                continue;
+            }
+            if (character == '{' || character == '[') {
+                depth++;
+            } else if ((character == '}' || character == ']') && !--depth) {
+                return offset + 1;
+            }
+            offset++;
+        }
+        return size;
+    }
+
+    while (offset < size && data[offset] != ',' && data[offset] != '}' && data[offset] != ']'
+            && !isspace(data[offset])) {
+        offset++;
+    }
+
+    return offset;
+}
+
+/** @brief Is the quoted token at [keyStart, keyEnd) the given key?
+ */
+static bool ffsHttpTraceIsKey(const uint8_t *data, size_t size, size_t keyStart, size_t keyEnd,
+        const char *key)
+{
+    (void) size;
+
+    size_t keyLength = strlen(key);
+
+    return keyEnd - keyStart == keyLength + 2 && !memcmp(data + keyStart + 1, key, keyLength);
+}
+
+/** @brief Is the quoted token at [keyStart, keyEnd) one of the volatile keys?
+ */
+static bool ffsHttpTraceIsVolatileKey(const uint8_t *data, size_t size, size_t keyStart, size_t keyEnd,
+        const char * const *volatileKeys)
+{
+    for (const char * const *key = volatileKeys; key && *key; key++) {
+        if (ffsHttpTraceIsKey(data, size, keyStart, keyEnd, *key)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/** @brief Strip whitespace outside strings and mask volatile values.
+ *
+ * The canonical form is at most one byte longer than the input.
+ */
+static size_t ffsHttpTraceCanonicalize(const uint8_t *data, size_t size, const char * const *volatileKeys,
+        uint8_t *canonical)
+{
+    size_t canonicalSize = 0;
+    size_t offset = 0;
+
+    while (offset < size) {
+        if (isspace(data[offset])) {
+            offset++;
+            continue;
+        }
+
+        if (data[offset] != '"') {
+            canonical[canonicalSize++] = data[offset++];
+            continue;
+        }
+
+        // Copy the string; if it is a volatile key, mask its value.
+        size_t stringEnd = ffsHttpTraceSkipString(data, size, offset);
+        memcpy(canonical + canonicalSize, data + offset, stringEnd - offset);
+        canonicalSize += stringEnd - offset;
+
+        size_t next = ffsHttpTraceSkipWhitespace(data, size, stringEnd);
+        if (next < size && data[next] == ':'
+                && ffsHttpTraceIsVolatileKey(data, size, offset, stringEnd, volatileKeys)) {
+            canonical[canonicalSize++] = ':';
+            canonical[canonicalSize++] = '*';
+            offset = ffsHttpTraceSkipValue(data, size, ffsHttpTraceSkipWhitespace(data, size, next + 1));
+        } else {
+            offset = stringEnd;
+        }
+    }
+
+    return canonicalSize;
+}
+
+/** @brief Find the first string value of a JSON key.
+ */
+static bool ffsHttpTraceFindStringValue(const uint8_t *data, size_t size, const char *key, size_t *valueStart,
+        size_t *valueSize)
+{
+    size_t offset = 0;
+
+    while (offset < size) {
+        if (data[offset] != '"') {
+            offset++;
+            continue;
+        }
+
+        size_t stringEnd = ffsHttpTraceSkipString(data, size, offset);
+        size_t next = ffsHttpTraceSkipWhitespace(data, size, stringEnd);
+        if (next < size && data[next] == ':' && ffsHttpTraceIsKey(data, size, offset, stringEnd, key)) {
+            size_t value = ffsHttpTraceSkipWhitespace(data, size, next + 1);
+            if (value >= size || data[value] != '"') {
+                return false;
+            }
+            size_t valueEnd = ffsHttpTraceSkipString(data, size, value);
+            if (valueEnd - value < 2) {
+                return false;
+            }
+            *valueStart = value + 1;
+            *valueSize = valueEnd - value - 2;
+            return true;
+        }
+        offset = stringEnd;
+    }
+
+    return false;
+}
+
+/** @brief Replace every occurrence of a byte sequence in a heap buffer.
+ */
+static FFS_RESULT ffsHttpTraceReplaceAll(uint8_t **body, size_t *bodySize, const uint8_t *from, size_t fromSize,
+        const uint8_t *to, size_t toSize)
+{
+    // Count the occurrences.
+    size_t count = 0;
+    for (size_t offset = 0; offset + fromSize <= *bodySize;) {
+        if (!memcmp(*body + offset, from, fromSize)) {
+            count++;
+            offset += fromSize;
+        } else {
+            offset++;
+        }
+    }
+    if (!count) {
+        return FFS_SUCCESS;
+    }
+
+    size_t replacedSize = *bodySize - count * fromSize + count * toSize;
+    uint8_t *replaced = (uint8_t *) malloc(replacedSize + 1);
+    if (!replaced) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    size_t replacedOffset = 0;
+    for (size_t offset = 0; offset < *bodySize;) {
+        if (offset + fromSize <= *bodySize && !memcmp(*body + offset, from, fromSize)) {
+            memcpy(replaced + replacedOffset, to, toSize);
+            replacedOffset += toSize;
+            offset += fromSize;
+        } else {
+            replaced[replacedOffset++] = (*body)[offset++];
+        }
+    }
+
+    free(*body);
+    *body = replaced;
+    *bodySize = replacedSize;
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Sign a body (SHA-256) and encode the DER signature as base64.
+ */
+static FFS_RESULT ffsHttpTraceSign(EVP_PKEY *signingKey, const uint8_t *body, size_t bodySize,
+        char **signature)
+{
+    EVP_MD_CTX *messageDigestContext = EVP_MD_CTX_create();
+    if (!messageDigestContext) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    size_t signatureSize = (size_t) EVP_PKEY_size(signingKey);
+    uint8_t *derSignature = (uint8_t *) malloc(signatureSize);
+    if (!derSignature) {
+        EVP_MD_CTX_destroy(messageDigestContext);
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    if (EVP_DigestSignInit(messageDigestContext, NULL, EVP_sha256(), NULL, signingKey) != 1
+            || EVP_DigestSignUpdate(messageDigestContext, body, bodySize) != 1
+            || EVP_DigestSignFinal(messageDigestContext, derSignature, &signatureSize) != 1) {
+        free(derSignature);
+        EVP_MD_CTX_destroy(messageDigestContext);
+        FFS_FAIL(FFS_ERROR);
+    }
+    EVP_MD_CTX_destroy(messageDigestContext);
+
+    // Encode, leaving room for the terminator.
+    size_t base64Size = 4 * ((signatureSize + 2) / 3) + 1;
+    *signature = (char *) malloc(base64Size);
+    if (!*signature) {
+        free(derSignature);
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    FfsStream_t derStream = ffsCreateInputStream(derSignature, signatureSize);
+    FfsStream_t base64Stream = ffsCreateOutputStream((uint8_t *) *signature, base64Size);
+    FFS_RESULT result = ffsEncodeBase64(&derStream, 0, NULL, &base64Stream);
+    if (result == FFS_SUCCESS) {
+        result = ffsWriteByteToStream(0, &base64Stream);
+    }
+    free(derSignature);
+
+    if (result != FFS_SUCCESS) {
+        free(*signature);
+        *signature = NULL;
+        FFS_FAIL(result);
+    }
+
+    return FFS_SUCCESS;
+}
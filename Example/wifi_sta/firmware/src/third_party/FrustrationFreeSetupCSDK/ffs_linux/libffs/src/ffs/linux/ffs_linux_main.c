@@ -21,9 +21,28 @@
 
 #include <getopt.h>
 
+/** Default network impairment seed, so that impaired runs repeat by default. */
+#define DEFAULT_NETWORK_IMPAIRMENT_SEED (1)
+
+/** Default HTTP replay speed (as recorded). */
+#define DEFAULT_HTTP_REPLAY_WARP_PERCENT (100)
+
+/** Emulated network impairment (enabled with --impairment). */
+static FfsNetworkImpairment_t networkImpairment;
+
+/** HTTP exchange recorder (enabled with --http_record). */
+static FfsHttpTraceRecorder_t httpTraceRecorder;
+
+/** HTTP exchange replay (enabled with --http_replay). */
+static FfsHttpTraceReplay_t httpTraceReplay;
+
 /** Static function prototypes.
  */
+static FFS_RESULT ffsRunWifiProvisionee(struct FfsUserContext_s *userContext, int argc, char **argv);
 static FFS_RESULT ffsParseCommandLine(struct FfsUserContext_s *userContext, int argc, char **argv);
+static FFS_RESULT ffsStartHttpReplay(struct FfsUserContext_s *userContext, const char *tracePath,
+        const char *signingKeyPath, uint32_t timeWarpPercent, bool isStrict);
+static void ffsFinishHttpTrace(struct FfsUserContext_s *userContext);
 static void ffsStartWifiScanCallback(struct FfsUserContext_s *userContext, FFS_RESULT result);
 static FFS_RESULT ffsDeinitializeWifiManagerBlocking(struct FfsUserContext_s *userContext);
 static void ffsDeinitializeWifiManagerCallback(struct FfsUserContext_s *userContext,
@@ -37,17 +56,13 @@ int main(int argc, char **argv)
     FFS_CHECK_RESULT(ffsInitializeUserContext(&userContext));
     srand(time(NULL));
 
-    // Parse the command line arguments.
-    FFS_CHECK_RESULT(ffsParseCommandLine(&userContext, argc, argv));
-
-    // Initialize the Wi-Fi manager.
-    FFS_CHECK_RESULT(ffsInitializeWifiManager(&userContext));
+    // Run the Wi-Fi provisionee.
+    FFS_RESULT result = ffsRunWifiProvisionee(&userContext, argc, argv);
 
-    // Start a background Wi-Fi scan.
-    FFS_CHECK_RESULT(ffsWifiManagerStartScan(ffsStartWifiScanCallback));
+    // Close the HTTP trace, whether or not the provisionee succeeded.
+    ffsFinishHttpTrace(&userContext);
 
-    // Execute the Wi-Fi provisionee task.
-    FFS_CHECK_RESULT(ffsWifiProvisioneeTask(&userContext));
+    FFS_CHECK_RESULT(result);
 
     // Deinitialize the Wi-Fi manager.
     FFS_CHECK_RESULT(ffsDeinitializeWifiManagerBlocking(&userContext));
@@ -58,28 +73,62 @@ int main(int argc, char **argv)
     return 0;
 }
 
+/** @brief Parse the command line, then execute the Wi-Fi provisionee task.
+ */
+static FFS_RESULT ffsRunWifiProvisionee(struct FfsUserContext_s *userContext, int argc, char **argv)
+{
+    // Parse the command line arguments.
+    FFS_CHECK_RESULT(ffsParseCommandLine(userContext, argc, argv));
+
+    // Initialize the Wi-Fi manager.
+    FFS_CHECK_RESULT(ffsInitializeWifiManager(userContext));
+
+    // Start a background Wi-Fi scan.
+    FFS_CHECK_RESULT(ffsWifiManagerStartScan(ffsStartWifiScanCallback));
+
+    // Execute the Wi-Fi provisionee task.
+    FFS_CHECK_RESULT(ffsWifiProvisioneeTask(userContext));
+
+    return FFS_SUCCESS;
+}
+
 /** @brief Parse command line arguments.
  */
 static FFS_RESULT ffsParseCommandLine(struct FfsUserContext_s *userContext, int argc, char **argv) {
 
     const char *cloudPublicKeyPath = NULL;
+    const char *impairmentProfileName = NULL;
+    uint32_t impairmentSeed = DEFAULT_NETWORK_IMPAIRMENT_SEED;
+    const char *httpRecordPath = NULL;
+    const char *httpReplayPath = NULL;
+    const char *replayKeyPath = NULL;
+    uint32_t replayWarpPercent = DEFAULT_HTTP_REPLAY_WARP_PERCENT;
+    bool isReplayStrict = false;
 
     for (;;) {
 
         // Command-line options.
         static struct option options[] = {
-            { "ssid", no_argument, 0, 's' },
-            { "key", no_argument, 0, 'k' },
-            { "host", no_argument, 0, 'h' },
-            { "port", no_argument, 0, 'p' },
-            { "cloud_public_key", no_argument, 0, 'c'},
+            { "ssid", required_argument, 0, 's' },
+            { "key", required_argument, 0, 'k' },
+            { "host", required_argument, 0, 'h' },
+            { "port", required_argument, 0, 'p' },
+            { "cloud_public_key", required_argument, 0, 'c'},
+            { "wpa_ctrl", required_argument, 0, 'w'},
+            { "impairment", required_argument, 0, 'i'},
+            { "impairment_seed", required_argument, 0, 'r'},
+            { "http_record", required_argument, 0, 'R'},
+            { "http_replay", required_argument, 0, 'P'},
+            { "replay_key", required_argument, 0, 'K'},
+            { "replay_warp", required_argument, 0, 'W'},
+            { "replay_strict", no_argument, 0, 'S'},
             { NULL, 0, 0, 0 }
         };
 
         // getopt_long stores the option index here.
         int optionIndex = 0;
 
-        int shortOption = getopt_long(argc, argv, "s:k:h:p:c:", options, &optionIndex);
+        int shortOption = getopt_long(argc, argv, "s:k:h:p:c:w:i:r:R:P:K:W:S", options, &optionIndex);
 
         // Done with options?
         if (shortOption < 0) {
@@ -108,6 +157,36 @@ static FFS_RESULT ffsParseCommandLine(struct FfsUserContext_s *userContext, int
             ffsLogDebug("Use custom cloud public key %s", optarg);
             cloudPublicKeyPath = strdup(optarg);
             break;
+        case 'w':
+            ffsLogDebug("Use WPA supplicant control socket %s", optarg);
+            userContext->wifiContext.wpaControlPath = strdup(optarg);
+            break;
+        case 'i':
+            ffsLogDebug("Emulate network impairment profile %s", optarg);
+            impairmentProfileName = optarg;
+            break;
+        case 'r':
+            impairmentSeed = (uint32_t) strtoul(optarg, NULL, 0);
+            break;
+        case 'R':
+            ffsLogDebug("Record HTTP exchanges to %s", optarg);
+            httpRecordPath = optarg;
+            break;
+        case 'P':
+            ffsLogDebug("Replay HTTP exchanges from %s", optarg);
+            httpReplayPath = optarg;
+            break;
+        case 'K':
+            ffsLogDebug("Re-sign replayed responses with %s", optarg);
+            replayKeyPath = optarg;
+            break;
+        case 'W':
+            replayWarpPercent = (uint32_t) strtoul(optarg, NULL, 0);
+            break;
+        case 'S':
+            ffsLogDebug("Fail requests that do not match the HTTP replay");
+            isReplayStrict = true;
+            break;
         default:
             ffsLogError("Unknown option %c", shortOption);
         }
@@ -116,9 +195,91 @@ static FFS_RESULT ffsParseCommandLine(struct FfsUserContext_s *userContext, int
 
     FFS_CHECK_RESULT(ffsInitializePublicKey(userContext, cloudPublicKeyPath));
 
+    // Impair the DSS connection?
+    if (impairmentProfileName) {
+        const FfsNetworkImpairmentProfile_t *profile;
+        if (ffsFindNetworkImpairmentProfile(impairmentProfileName, &profile)) {
+            ffsLogError("Unknown network impairment profile %s", impairmentProfileName);
+            FFS_FAIL(FFS_ERROR);
+        }
+        FFS_CHECK_RESULT(ffsInitializeNetworkImpairment(&networkImpairment, profile, impairmentSeed));
+        userContext->networkImpairment = &networkImpairment;
+    }
+
+    // Record the DSS exchanges?
+    if (httpRecordPath) {
+        FFS_CHECK_RESULT(ffsOpenHttpTraceRecorder(&httpTraceRecorder, httpRecordPath));
+        userContext->httpTraceRecorder = &httpTraceRecorder;
+    }
+
+    // Replay recorded DSS exchanges instead of reaching the network?
+    if (httpReplayPath) {
+        FFS_CHECK_RESULT(ffsStartHttpReplay(userContext, httpReplayPath, replayKeyPath, replayWarpPercent,
+                isReplayStrict));
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Load an HTTP trace for replay.
+ *
+ * With a signing key the replayed responses are re-signed and the key
+ * replaces the cloud public key, so patched responses still verify. In strict
+ * mode, requests that do not match the recording fail.
+ */
+static FFS_RESULT ffsStartHttpReplay(struct FfsUserContext_s *userContext, const char *tracePath,
+        const char *signingKeyPath, uint32_t timeWarpPercent, bool isStrict)
+{
+    EVP_PKEY *signingKey = NULL;
+
+    if (signingKeyPath) {
+        FILE *signingKeyFile = fopen(signingKeyPath, "r");
+        if (!signingKeyFile) {
+            ffsLogError("Unable to read the replay key %s", signingKeyPath);
+            FFS_FAIL(FFS_ERROR);
+        }
+        signingKey = PEM_read_PrivateKey(signingKeyFile, NULL, NULL, NULL);
+        fclose(signingKeyFile);
+        if (!signingKey) {
+            FFS_FAIL(FFS_ERROR);
+        }
+
+        // Trust the replay key instead of the cloud.
+        EVP_PKEY_free(userContext->cloudPublicKey);
+        EVP_PKEY_up_ref(signingKey);
+        userContext->cloudPublicKey = signingKey;
+    }
+
+    FFS_CHECK_RESULT(ffsLoadHttpTrace(&httpTraceReplay, tracePath, timeWarpPercent, signingKey));
+    httpTraceReplay.isStrict = isStrict;
+    userContext->httpTraceReplay = &httpTraceReplay;
+
+    ffsLogInfo("Replaying %u HTTP exchanges at %u%%", httpTraceReplay.exchangeCount, timeWarpPercent);
+
     return FFS_SUCCESS;
 }
 
+/** @brief Close the HTTP recording and report on the replay.
+ */
+static void ffsFinishHttpTrace(struct FfsUserContext_s *userContext)
+{
+    if (userContext->httpTraceRecorder) {
+        ffsLogInfo("Recorded %u HTTP exchanges", userContext->httpTraceRecorder->exchangeCount);
+        FFS_CHECK_RESULT_CONTINUE(ffsCloseHttpTraceRecorder(userContext->httpTraceRecorder));
+        userContext->httpTraceRecorder = NULL;
+    }
+
+    if (userContext->httpTraceReplay) {
+        FfsHttpTraceReplay_t *replay = userContext->httpTraceReplay;
+        ffsLogInfo("Replayed %u of %u HTTP exchanges, %u mismatched; client time %llu ms (recorded %llu ms)",
+                replay->nextExchange, replay->exchangeCount, replay->mismatchCount,
+                (unsigned long long) replay->replayedGapMs, (unsigned long long) replay->recordedGapMs);
+        EVP_PKEY_free(replay->signingKey);
+        ffsFreeHttpTrace(replay);
+        userContext->httpTraceReplay = NULL;
+    }
+}
+
 /** @brief Callback for the start background Wi-Fi scan call.
  */
 static void ffsStartWifiScanCallback(struct FfsUserContext_s *userContext, FFS_RESULT result)
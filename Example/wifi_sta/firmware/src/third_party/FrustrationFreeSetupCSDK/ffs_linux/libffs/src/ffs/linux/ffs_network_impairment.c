@@ -0,0 +1,210 @@
+/** @file ffs_network_impairment.c
+ *
+ * @brief Network impairment profiles and plan generator.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_check_result.h"
+#include "ffs/linux/ffs_network_impairment.h"
+
+#include <math.h>
+#include <string.h>
+
+/** Exponential tails are cut off at this many times their mean. */
+#define EXPONENTIAL_LATENCY_CUTOFF      (10)
+
+/** Probabilities are expressed in parts per thousand. */
+#define PER_MILLE                       (1000)
+
+/*
+ * Built-in profiles.
+ */
+const FfsNetworkImpairmentProfile_t FFS_NETWORK_IMPAIRMENT_PROFILES[] = {
+    {
+        .name = "ideal",
+        .description = "No impairment",
+        .latencyDistribution = FFS_NETWORK_LATENCY_FIXED
+    },
+    {
+        .name = "home-broadband",
+        .description = "Uncongested home network behind a broadband uplink",
+        .latencyDistribution = FFS_NETWORK_LATENCY_UNIFORM,
+        .latencyBaseMs = 20,
+        .latencySpreadMs = 30,
+        .bandwidthBytesPerSecond = 1024 * 1024,
+        .dnsFailurePerMille = 1,
+        .resetPerMille = 2
+    },
+    {
+        .name = "crowded-2.4ghz",
+        .description = "Crowded 2.4 GHz channel with retransmission bursts",
+        .latencyDistribution = FFS_NETWORK_LATENCY_EXPONENTIAL,
+        .latencyBaseMs = 40,
+        .latencySpreadMs = 150,
+        .bandwidthBytesPerSecond = 64 * 1024,
+        .maximumReadSize = 256,
+        .dnsFailurePerMille = 10,
+        .resetPerMille = 30,
+        .stallPerMille = 20,
+        .stallMs = 8000
+    },
+    {
+        .name = "captive-setup-ap",
+        .description = "Captive setup access point relaying through a slow uplink",
+        .latencyDistribution = FFS_NETWORK_LATENCY_UNIFORM,
+        .latencyBaseMs = 100,
+        .latencySpreadMs = 300,
+        .bandwidthBytesPerSecond = 16 * 1024,
+        .maximumReadSize = 128,
+        .dnsFailurePerMille = 150,
+        .resetPerMille = 50,
+        .stallPerMille = 50,
+        .stallMs = 15000
+    },
+    {
+        .name = "weak-signal",
+        .description = "Weak signal at the edge of the access point range",
+        .latencyDistribution = FFS_NETWORK_LATENCY_EXPONENTIAL,
+        .latencyBaseMs = 80,
+        .latencySpreadMs = 400,
+        .bandwidthBytesPerSecond = 8 * 1024,
+        .maximumReadSize = 64,
+        .dnsFailurePerMille = 20,
+        .resetPerMille = 80,
+        .stallPerMille = 30,
+        .stallMs = 10000
+    },
+    { .name = NULL }
+};
+
+// Static function prototypes.
+static uint64_t ffsNetworkImpairmentRandom(FfsNetworkImpairment_t *impairment);
+static uint32_t ffsNetworkImpairmentRandomBelow(FfsNetworkImpairment_t *impairment, uint32_t limit);
+static uint32_t ffsNetworkImpairmentDrawLatency(FfsNetworkImpairment_t *impairment);
+
+/*
+ * Find a built-in profile by name.
+ */
+FFS_RESULT ffsFindNetworkImpairmentProfile(const char *name, const FfsNetworkImpairmentProfile_t **profile)
+{
+    if (!name) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    for (const FfsNetworkImpairmentProfile_t *candidate = FFS_NETWORK_IMPAIRMENT_PROFILES; candidate->name;
+            candidate++) {
+        if (!strcmp(candidate->name, name)) {
+            *profile = candidate;
+            return FFS_SUCCESS;
+        }
+    }
+
+    FFS_FAIL(FFS_ERROR);
+}
+
+/*
+ * Initialize an impairment.
+ */
+FFS_RESULT ffsInitializeNetworkImpairment(FfsNetworkImpairment_t *impairment,
+        const FfsNetworkImpairmentProfile_t *profile, uint32_t seed)
+{
+    if (!profile) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    // The fault probabilities share one roll.
+    if (profile->dnsFailurePerMille + profile->resetPerMille + profile->stallPerMille > PER_MILLE) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    memset(impairment, 0, sizeof(*impairment));
+    impairment->profile = profile;
+    impairment->randomState = seed;
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Draw the impairment for the next request.
+ */
+FFS_RESULT ffsPlanNetworkImpairment(FfsNetworkImpairment_t *impairment, FfsNetworkImpairmentPlan_t *plan)
+{
+    const FfsNetworkImpairmentProfile_t *profile = impairment->profile;
+
+    memset(plan, 0, sizeof(*plan));
+    plan->delayMs = ffsNetworkImpairmentDrawLatency(impairment);
+    plan->bandwidthBytesPerSecond = profile->bandwidthBytesPerSecond;
+    plan->maximumReadSize = profile->maximumReadSize;
+
+    // Roll for a fault.
+    uint32_t roll = ffsNetworkImpairmentRandomBelow(impairment, PER_MILLE);
+    if (roll < profile->dnsFailurePerMille) {
+        plan->fault = FFS_NETWORK_FAULT_DNS_FAILURE;
+        impairment->dnsFailureCount++;
+    } else if ((roll -= profile->dnsFailurePerMille) < profile->resetPerMille) {
+        plan->fault = FFS_NETWORK_FAULT_RESET;
+        plan->resetOffset = ffsNetworkImpairmentRandomBelow(impairment,
+                FFS_NETWORK_IMPAIRMENT_MAXIMUM_RESET_OFFSET + 1);
+        impairment->resetCount++;
+    } else if ((roll -= profile->resetPerMille) < profile->stallPerMille) {
+        plan->fault = FFS_NETWORK_FAULT_STALL;
+        plan->stallMs = profile->stallMs;
+        impairment->stallCount++;
+    }
+
+    impairment->requestCount++;
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Next 64 random bits (SplitMix64).
+ */
+static uint64_t ffsNetworkImpairmentRandom(FfsNetworkImpairment_t *impairment)
+{
+    uint64_t value = (impairment->randomState += 0x9E3779B97F4A7C15ULL);
+
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+
+    return value ^ (value >> 31);
+}
+
+/** @brief Random integer in [0, limit).
+ */
+static uint32_t ffsNetworkImpairmentRandomBelow(FfsNetworkImpairment_t *impairment, uint32_t limit)
+{
+    return (uint32_t) (((ffsNetworkImpairmentRandom(impairment) >> 32) * limit) >> 32);
+}
+
+/** @brief Draw a latency from the profile distribution.
+ */
+static uint32_t ffsNetworkImpairmentDrawLatency(FfsNetworkImpairment_t *impairment)
+{
+    const FfsNetworkImpairmentProfile_t *profile = impairment->profile;
+
+    switch (profile->latencyDistribution) {
+    case FFS_NETWORK_LATENCY_UNIFORM:
+        return profile->latencyBaseMs + ffsNetworkImpairmentRandomBelow(impairment, profile->latencySpreadMs + 1);
+    case FFS_NETWORK_LATENCY_EXPONENTIAL: {
+
+        // Inverse transform of a uniform draw in (0, 1].
+        double uniform = (double) ((ffsNetworkImpairmentRandom(impairment) >> 11) + 1) / (double) (1ULL << 53);
+        double tailMs = -log(uniform) * profile->latencySpreadMs;
+        double cutoffMs = (double) profile->latencySpreadMs * EXPONENTIAL_LATENCY_CUTOFF;
+
+        return profile->latencyBaseMs + (uint32_t) (tailMs < cutoffMs ? tailMs : cutoffMs);
+    }
+    default:
+        return profile->latencyBaseMs;
+    }
+}
@@ -47,6 +47,7 @@ FFS_RESULT ffsInitializeWifiContext(FfsLinuxWifiContext_t *wifiContext)
 
     wifiContext->interface = FFS_WIFI_INTERFACE;
     wifiContext->driver = FFS_WIFI_DRIVER;
+    wifiContext->wpaControlPath = NULL;
     wifiContext->connectionDetails.state = FFS_WIFI_CONNECTION_STATE_DISCONNECTED;
     wifiContext->wifiManagerInitialized = false;
 
@@ -28,6 +28,7 @@
 #include "ffs/raspbian/ffs_raspbian_iwlist.h"
 #include "ffs/raspbian/ffs_raspbian_wifi_manager.h"
 #include "ffs/raspbian/ffs_raspbian_wireless_tools.h"
+#include "ffs/raspbian/ffs_raspbian_wpa_ctrl.h"
 #include "ffs/raspbian/ffs_raspbian_wpa_supplicant.h"
 
 #include <netdb.h>
@@ -71,6 +72,8 @@ typedef struct {
 
 static FfsCircularBuffer_t *wifiManagerCircularBuffer;
 static pthread_t wifiManagerTask;
+static FfsRaspbianWpaCtrl_t wpaCtrl; //!< Control interface, when the context has a control path.
+static bool hasWpaCtrl;
 
 /** Static function prototypes.
  */
@@ -86,6 +89,7 @@ static FFS_RESULT ffsRaspbianWifiManagerTaskConnect(FfsLinuxWifiContext_t *wifiC
 static FFS_RESULT ffsRaspbianWifiManagerTaskDisconnectFromWifi(FfsLinuxWifiContext_t *wifiContext);
 static FFS_RESULT ffsRaspbianWifiManagerTaskWaitForConnectionState(FfsLinuxWifiContext_t *wifiContext, FFS_WIFI_CONNECTION_STATE goalState,
         int32_t timeoutMs);
+static FFS_RESULT ffsRaspbianWifiManagerTaskGetConnectionState(FfsLinuxWifiContext_t *wifiContext, FFS_WIFI_CONNECTION_STATE *state);
 static FFS_RESULT ffsRaspbianWifiManagerTaskWaitToResolveHostName(FfsStream_t *hostNameStream);
 static FFS_RESULT ffsRaspbianWifiManagerTaskResolveHostName(FfsStream_t *hostNameStream, bool *hostNameResolved);
 static void *ffsRaspbianWifiManagerTask(void *userContextPointer);
@@ -240,6 +244,11 @@ static FFS_RESULT ffsRaspbianWifiManagerEnqueueMessage(FfsRaspbianWifiManagerMes
  * @returns Enumerated [result](@ref FFS_RESULT)
  */
 static FFS_RESULT ffsRaspbianWifiManagerTaskStartWifiScan(FfsLinuxWifiContext_t *wifiContext) {
+    if (hasWpaCtrl) {
+        FFS_CHECK_RESULT(ffsRaspbianWpaCtrlScan(&wpaCtrl, wifiContext, NULL));
+        return FFS_SUCCESS;
+    }
+
     FFS_CHECK_RESULT(ffsRaspbianWifiInterfaceUp(wifiContext));
     FFS_CHECK_RESULT(ffsRaspbianPerformBackgroundScan(wifiContext));
     return FFS_SUCCESS;
@@ -254,6 +263,12 @@ static FFS_RESULT ffsRaspbianWifiManagerTaskStartWifiScan(FfsLinuxWifiContext_t
  * @returns Enumerated [result](@ref FFS_RESULT)
  */
 static FFS_RESULT ffsRaspbianWifiManagerTaskStartDirectedScan(FfsLinuxWifiContext_t *wifiContext, FfsWifiConfiguration_t *wifiConfiguration, bool *isFound) {
+    if (hasWpaCtrl) {
+        FFS_CHECK_RESULT(ffsRaspbianWpaCtrlScan(&wpaCtrl, wifiContext, &wifiConfiguration->ssidStream));
+        FFS_CHECK_RESULT(ffsWifiScanListHasNetwork(wifiContext, wifiConfiguration, isFound));
+        return FFS_SUCCESS;
+    }
+
     // Kill the WPA supplicant, as it can cause conflicts with directed scans.
     FFS_CHECK_RESULT(ffsRaspbianKillWpaSupplicant());
 
@@ -343,7 +358,9 @@ static FFS_RESULT ffsRaspbianWifiManagerTaskAttemptConnection(FfsLinuxWifiContex
     }
 
     // Check if 'wpaSupplicantConfigurationFile' is defined; if not, connect to WEP.
-    if (wpaSupplicantConfigurationFile) {
+    if (hasWpaCtrl) {
+        FFS_CHECK_RESULT(ffsRaspbianWpaCtrlConnect(&wpaCtrl, wifiContext, wifiConfiguration, FFS_WIFI_CONNECTION_TIMEOUT_MILLI));
+    } else if (wpaSupplicantConfigurationFile) {
         FFS_CHECK_RESULT(ffsRaspbianConfigureWpaSupplicant(wifiConfiguration, wpaSupplicantConfigurationFile));
         FFS_CHECK_RESULT(ffsRaspbianConnectWithWpaSupplicant(wifiContext, wifiConfiguration, wpaSupplicantConfigurationFile));
     } else {
@@ -429,6 +446,12 @@ static FFS_RESULT ffsRaspbianWifiManagerTaskConnect(FfsLinuxWifiContext_t *wifiC
  * @returns Enumerated [result](@ref FFS_RESULT)
  */
 static FFS_RESULT ffsRaspbianWifiManagerTaskDisconnectFromWifi(FfsLinuxWifiContext_t *wifiContext) {
+    if (hasWpaCtrl) {
+        FFS_CHECK_RESULT(ffsRaspbianWpaCtrlDisconnect(&wpaCtrl, FFS_WIFI_DISCONNECTION_TIMEOUT_MILLI));
+        FFS_CHECK_RESULT(ffsUpdateWifiConnectionState(wifiContext, FFS_WIFI_CONNECTION_STATE_DISCONNECTED));
+        return FFS_SUCCESS;
+    }
+
     FFS_CHECK_RESULT(ffsRaspbianCloseWifiConnection(wifiContext));
     FFS_CHECK_RESULT(ffsRaspbianWifiManagerTaskWaitForConnectionState(wifiContext,
             FFS_WIFI_CONNECTION_STATE_DISCONNECTED, FFS_WIFI_DISCONNECTION_TIMEOUT_MILLI));
@@ -449,7 +472,7 @@ static FFS_RESULT ffsRaspbianWifiManagerTaskWaitForConnectionState(FfsLinuxWifiC
     FFS_WIFI_CONNECTION_STATE wifiConnectionState;
 
     for (int32_t timer = 0; timer < timeoutMs*1000; timer += FFS_WIFI_STATE_TIMER_INCREMENT_MICRO) {
-        FFS_CHECK_RESULT(ffsRaspbianGetWifiConnectionState(wifiContext, &wifiConnectionState));
+        FFS_CHECK_RESULT(ffsRaspbianWifiManagerTaskGetConnectionState(wifiContext, &wifiConnectionState));
 
         if (wifiConnectionState == goalState) {
             const char *stateString;
@@ -465,6 +488,23 @@ static FFS_RESULT ffsRaspbianWifiManagerTaskWaitForConnectionState(FfsLinuxWifiC
     FFS_FAIL(FFS_ERROR);
 }
 
+/** @brief Get the Wi-Fi connection state from the active backend.
+ *
+ * @param wifiContext Wi-Fi context
+ * @param state Destination connection state
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+static FFS_RESULT ffsRaspbianWifiManagerTaskGetConnectionState(FfsLinuxWifiContext_t *wifiContext, FFS_WIFI_CONNECTION_STATE *state) {
+    if (hasWpaCtrl) {
+        FFS_CHECK_RESULT(ffsRaspbianWpaCtrlGetConnectionState(&wpaCtrl, state));
+    } else {
+        FFS_CHECK_RESULT(ffsRaspbianGetWifiConnectionState(wifiContext, state));
+    }
+
+    return FFS_SUCCESS;
+}
+
 /** @brief Block the Wi-Fi manager until the host name can be resolved.
  *
  * @param hostNameStream Host name to resolve
@@ -552,6 +592,16 @@ static void *ffsRaspbianWifiManagerTask(void *userContextPointer) {
     FFS_RESULT rc;
     FfsLinuxWifiContext_t *wifiContext = &userContext->wifiContext;
 
+    // Talk to a running supplicant directly when given its control socket.
+    hasWpaCtrl = false;
+    if (wifiContext->wpaControlPath) {
+        if (ffsRaspbianWpaCtrlOpen(&wpaCtrl, wifiContext->wpaControlPath) == FFS_SUCCESS) {
+            hasWpaCtrl = true;
+        } else {
+            ffsLogWarning("WPA supplicant control interface unavailable; using shell tools");
+        }
+    }
+
     while (1) {
         ffsBlockingCircularBufferReadMessage(wifiManagerCircularBuffer, (uint8_t *)&message);
 
@@ -589,6 +639,11 @@ static void *ffsRaspbianWifiManagerTask(void *userContextPointer) {
     }
 
 exit:
+    if (hasWpaCtrl) {
+        ffsRaspbianWpaCtrlClose(&wpaCtrl);
+        hasWpaCtrl = false;
+    }
+
     ffsDeinitializeCircularBuffer(wifiManagerCircularBuffer);
     wifiContext->wifiManagerInitialized = false;
 
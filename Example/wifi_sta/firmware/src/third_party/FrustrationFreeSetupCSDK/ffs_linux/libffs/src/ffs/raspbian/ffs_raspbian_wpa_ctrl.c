@@ -0,0 +1,975 @@
+/** @file ffs_raspbian_wpa_ctrl.c
+ *
+ * @brief Raspbian Wi-Fi management over the WPA supplicant control socket implementation.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_check_result.h"
+#include "ffs/common/ffs_logging.h"
+#include "ffs/common/ffs_stream.h"
+#include "ffs/linux/ffs_linux_error_details.h"
+#include "ffs/linux/ffs_wifi_scan_list.h"
+#include "ffs/raspbian/ffs_raspbian_wpa_ctrl.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+/** Local socket address format, as used by wpa_cli.
+ */
+#define WPA_CTRL_LOCAL_PATH_FORMAT ("/tmp/ffs_wpa_ctrl_%d-%u")
+
+/** Control interface commands.
+ */
+#define WPA_CTRL_COMMAND_ATTACH         ("ATTACH")
+#define WPA_CTRL_COMMAND_DETACH         ("DETACH")
+#define WPA_CTRL_COMMAND_SCAN           ("SCAN")
+#define WPA_CTRL_COMMAND_SCAN_SSID      ("SCAN ssid %s")
+#define WPA_CTRL_COMMAND_SCAN_RESULTS   ("SCAN_RESULTS")
+#define WPA_CTRL_COMMAND_STATUS         ("STATUS")
+#define WPA_CTRL_COMMAND_DISCONNECT     ("DISCONNECT")
+#define WPA_CTRL_COMMAND_REMOVE_NETWORK ("REMOVE_NETWORK %d")
+#define WPA_CTRL_COMMAND_ADD_NETWORK    ("ADD_NETWORK")
+#define WPA_CTRL_COMMAND_SET_NETWORK    ("SET_NETWORK %d %s %s")
+#define WPA_CTRL_COMMAND_SELECT_NETWORK ("SELECT_NETWORK %d")
+
+/** Control interface replies.
+ */
+#define WPA_CTRL_REPLY_OK        ("OK")
+#define WPA_CTRL_REPLY_FAIL_BUSY ("FAIL-BUSY")
+
+/** Control interface events.
+ */
+#define WPA_CTRL_EVENT_CONNECTED          ("CTRL-EVENT-CONNECTED")
+#define WPA_CTRL_EVENT_DISCONNECTED       ("CTRL-EVENT-DISCONNECTED")
+#define WPA_CTRL_EVENT_SCAN_RESULTS       ("CTRL-EVENT-SCAN-RESULTS")
+#define WPA_CTRL_EVENT_SCAN_FAILED        ("CTRL-EVENT-SCAN-FAILED")
+#define WPA_CTRL_EVENT_NETWORK_NOT_FOUND  ("CTRL-EVENT-NETWORK-NOT-FOUND")
+#define WPA_CTRL_EVENT_SSID_TEMP_DISABLED ("CTRL-EVENT-SSID-TEMP-DISABLED")
+
+#define WPA_CTRL_REASON_WRONG_KEY   ("reason=WRONG_KEY")
+#define WPA_CTRL_REASON_AUTH_FAILED ("reason=AUTH_FAILED")
+
+#define WPA_CTRL_SCAN_RESULTS_HEADER ("bssid / frequency / signal level / flags / ssid")
+#define WPA_CTRL_STATUS_STATE        ("wpa_state=")
+#define WPA_CTRL_STATE_COMPLETED     ("COMPLETED")
+
+#define WPA_CTRL_RAW_PSK_SIZE       (64) //!< Hex PSK length; shorter keys are passphrases.
+#define WPA_CTRL_WEP_40_HEX_SIZE    (10)
+#define WPA_CTRL_WEP_104_HEX_SIZE   (26)
+#define WPA_CTRL_FAILURES_ALLOWED   (3) //!< Same retry budget as the foreground supplicant.
+#define WPA_CTRL_DETACH_TIMEOUT_MILLI (100)
+
+/** @brief Events that end a connection attempt.
+ */
+typedef enum {
+    WPA_CTRL_CONNECT_EVENT_CONNECTED,
+    WPA_CTRL_CONNECT_EVENT_DISCONNECTED,
+    WPA_CTRL_CONNECT_EVENT_NETWORK_NOT_FOUND,
+    WPA_CTRL_CONNECT_EVENT_SSID_TEMP_DISABLED
+} WPA_CTRL_CONNECT_EVENT;
+
+static const char *const connectEvents[] = {
+    [WPA_CTRL_CONNECT_EVENT_CONNECTED] = WPA_CTRL_EVENT_CONNECTED,
+    [WPA_CTRL_CONNECT_EVENT_DISCONNECTED] = WPA_CTRL_EVENT_DISCONNECTED,
+    [WPA_CTRL_CONNECT_EVENT_NETWORK_NOT_FOUND] = WPA_CTRL_EVENT_NETWORK_NOT_FOUND,
+    [WPA_CTRL_CONNECT_EVENT_SSID_TEMP_DISABLED] = WPA_CTRL_EVENT_SSID_TEMP_DISABLED
+};
+
+static const char *const scanEvents[] = {
+    WPA_CTRL_EVENT_SCAN_RESULTS,
+    WPA_CTRL_EVENT_SCAN_FAILED
+};
+
+static const char *const disconnectEvents[] = {
+    WPA_CTRL_EVENT_DISCONNECTED
+};
+
+/*
+ * Static function prototypes.
+ */
+static FFS_RESULT ffsWpaCtrlOpenSocket(const char *controlPath, int *socketFd, char *localPath);
+static void ffsWpaCtrlCloseSocket(int *socketFd, const char *localPath);
+static FFS_RESULT ffsWpaCtrlExchange(int socketFd, const char *command, char *reply, size_t replySize,
+        int32_t timeoutMs);
+static FFS_RESULT ffsWpaCtrlReceive(int socketFd, char *buffer, size_t bufferSize, int32_t timeoutMs);
+static FFS_RESULT ffsWpaCtrlRequestOk(FfsRaspbianWpaCtrl_t *ctrl, const char *command);
+static FFS_RESULT ffsWpaCtrlRemoveNetwork(FfsRaspbianWpaCtrl_t *ctrl);
+static FFS_RESULT ffsWpaCtrlSetNetwork(FfsRaspbianWpaCtrl_t *ctrl, int networkId, const char *name,
+        const char *value);
+static FFS_RESULT ffsWpaCtrlSetNetworkKey(FfsRaspbianWpaCtrl_t *ctrl, int networkId,
+        FfsWifiConfiguration_t *configuration);
+static FFS_RESULT ffsWpaCtrlAwaitConnection(FfsRaspbianWpaCtrl_t *ctrl, FfsLinuxWifiContext_t *wifiContext,
+        int32_t timeoutMs);
+static void ffsWpaCtrlFlushEvents(FfsRaspbianWpaCtrl_t *ctrl);
+static void ffsWpaCtrlSetDeadline(struct timespec *deadline, int32_t timeoutMs);
+static int32_t ffsWpaCtrlGetRemainingTime(const struct timespec *deadline);
+static FFS_RESULT ffsWpaCtrlFormatHex(FfsStream_t *stream, char *destination, size_t destinationSize);
+static FFS_RESULT ffsWpaCtrlProcessScanResultLine(FfsLinuxWifiContext_t *wifiContext, char *line);
+static char *ffsWpaCtrlNextField(char **cursor);
+static FFS_RESULT ffsWpaCtrlDecodeSsid(const char *field, FfsStream_t *ssidStream);
+static FFS_WIFI_SECURITY_PROTOCOL ffsWpaCtrlGetSecurityProtocol(const char *flags);
+
+/*
+ * Open a control interface connection and attach for events.
+ */
+FFS_RESULT ffsRaspbianWpaCtrlOpen(FfsRaspbianWpaCtrl_t *ctrl, const char *controlPath)
+{
+    char reply[16];
+
+    memset(ctrl, 0, sizeof(*ctrl));
+    ctrl->commandSocket = -1;
+    ctrl->monitorSocket = -1;
+    ctrl->networkId = -1;
+
+    ffsLogDebug("Open WPA supplicant control interface %s", controlPath);
+
+    if (ffsWpaCtrlOpenSocket(controlPath, &ctrl->commandSocket, ctrl->commandPath) != FFS_SUCCESS
+            || ffsWpaCtrlOpenSocket(controlPath, &ctrl->monitorSocket, ctrl->monitorPath) != FFS_SUCCESS) {
+        ffsRaspbianWpaCtrlClose(ctrl);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    // Attach the monitor socket so the supplicant sends it unsolicited events.
+    if (ffsWpaCtrlExchange(ctrl->monitorSocket, WPA_CTRL_COMMAND_ATTACH, reply, sizeof(reply),
+            FFS_WPA_CTRL_REQUEST_TIMEOUT_MILLI) != FFS_SUCCESS
+            || strncmp(reply, WPA_CTRL_REPLY_OK, strlen(WPA_CTRL_REPLY_OK))) {
+        ffsLogError("Unable to attach to the WPA supplicant");
+        ffsRaspbianWpaCtrlClose(ctrl);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Close a control interface connection.
+ */
+FFS_RESULT ffsRaspbianWpaCtrlClose(FfsRaspbianWpaCtrl_t *ctrl)
+{
+    char reply[16];
+
+    if (ctrl->monitorSocket >= 0) {
+        // Best effort; the supplicant drops dead monitors on its own.
+        ffsWpaCtrlExchange(ctrl->monitorSocket, WPA_CTRL_COMMAND_DETACH, reply, sizeof(reply),
+                WPA_CTRL_DETACH_TIMEOUT_MILLI);
+    }
+
+    ffsWpaCtrlCloseSocket(&ctrl->monitorSocket, ctrl->monitorPath);
+    ffsWpaCtrlCloseSocket(&ctrl->commandSocket, ctrl->commandPath);
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Send a command and wait for its reply.
+ */
+FFS_RESULT ffsRaspbianWpaCtrlRequest(FfsRaspbianWpaCtrl_t *ctrl, const char *command,
+        char *reply, size_t replySize, int32_t timeoutMs)
+{
+    FFS_RESULT result = ffsWpaCtrlExchange(ctrl->commandSocket, command, reply, replySize, timeoutMs);
+
+    if (result == FFS_TIMEOUT) {
+        ffsLogError("WPA supplicant did not reply in %d ms", (int) timeoutMs);
+    }
+
+    return result;
+}
+
+/*
+ * Wait for one of a set of events.
+ */
+FFS_RESULT ffsRaspbianWpaCtrlWaitForEvent(FfsRaspbianWpaCtrl_t *ctrl, const char *const *events,
+        size_t eventCount, int32_t timeoutMs, size_t *eventIndex, char *event, size_t eventSize)
+{
+    char buffer[512];
+    struct timespec deadline;
+
+    ffsWpaCtrlSetDeadline(&deadline, timeoutMs);
+
+    while (true) {
+        FFS_RESULT result = ffsWpaCtrlReceive(ctrl->monitorSocket, buffer, sizeof(buffer),
+                ffsWpaCtrlGetRemainingTime(&deadline));
+        if (result != FFS_SUCCESS) {
+            return result;
+        }
+
+        // Skip the "<level>" prefix.
+        char *text = buffer;
+        if (text[0] == '<' && strchr(text, '>')) {
+            text = strchr(text, '>') + 1;
+        }
+
+        for (size_t index = 0; index < eventCount; index++) {
+            if (!strncmp(text, events[index], strlen(events[index]))) {
+                if (event) {
+                    snprintf(event, eventSize, "%s", text);
+                }
+                *eventIndex = index;
+                return FFS_SUCCESS;
+            }
+        }
+    }
+}
+
+/*
+ * Scan and replace the scan list with the supplicant's results.
+ */
+FFS_RESULT ffsRaspbianWpaCtrlScan(FfsRaspbianWpaCtrl_t *ctrl, FfsLinuxWifiContext_t *wifiContext,
+        FfsStream_t *ssidStream)
+{
+    char command[sizeof(WPA_CTRL_COMMAND_SCAN_SSID) + FFS_MAXIMUM_SSID_SIZE * 2];
+    char hexSsid[FFS_MAXIMUM_SSID_SIZE * 2 + 1];
+    char reply[32];
+    char results[FFS_WPA_CTRL_MAXIMUM_MESSAGE_SIZE];
+    size_t eventIndex;
+    FFS_RESULT result;
+
+    if (ssidStream) {
+        ffsLogDebug("Start directed Wi-Fi scan");
+        FFS_CHECK_RESULT(ffsWpaCtrlFormatHex(ssidStream, hexSsid, sizeof(hexSsid)));
+        snprintf(command, sizeof(command), WPA_CTRL_COMMAND_SCAN_SSID, hexSsid);
+    } else {
+        ffsLogDebug("Start background Wi-Fi scan");
+        snprintf(command, sizeof(command), "%s", WPA_CTRL_COMMAND_SCAN);
+    }
+
+    ffsWpaCtrlFlushEvents(ctrl);
+
+    FFS_CHECK_RESULT(ffsRaspbianWpaCtrlRequest(ctrl, command, reply, sizeof(reply),
+            FFS_WPA_CTRL_REQUEST_TIMEOUT_MILLI));
+
+    // A scan already in progress delivers results just the same.
+    if (strncmp(reply, WPA_CTRL_REPLY_OK, strlen(WPA_CTRL_REPLY_OK))
+            && strncmp(reply, WPA_CTRL_REPLY_FAIL_BUSY, strlen(WPA_CTRL_REPLY_FAIL_BUSY))) {
+        ffsLogError("WPA supplicant rejected scan: %s", reply);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    result = ffsRaspbianWpaCtrlWaitForEvent(ctrl, scanEvents, sizeof(scanEvents) / sizeof(scanEvents[0]),
+            FFS_WPA_CTRL_SCAN_TIMEOUT_MILLI, &eventIndex, NULL, 0);
+    if (result != FFS_SUCCESS) {
+        ffsLogError("No scan results from the WPA supplicant");
+        FFS_FAIL(result);
+    }
+
+    if (eventIndex != 0) {
+        ffsLogError("WPA supplicant scan failed");
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    FFS_CHECK_RESULT(ffsRaspbianWpaCtrlRequest(ctrl, WPA_CTRL_COMMAND_SCAN_RESULTS, results, sizeof(results),
+            FFS_WPA_CTRL_REQUEST_TIMEOUT_MILLI));
+
+    // Clear the scan list.
+    FFS_CHECK_RESULT(ffsWifiScanListClear(wifiContext));
+    wifiContext->scanListIndex = 0;
+
+    FFS_CHECK_RESULT(ffsRaspbianWpaCtrlProcessScanResults(wifiContext, results));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Configure a network and wait for the connection outcome.
+ */
+FFS_RESULT ffsRaspbianWpaCtrlConnect(FfsRaspbianWpaCtrl_t *ctrl, FfsLinuxWifiContext_t *wifiContext,
+        FfsWifiConfiguration_t *configuration, int32_t timeoutMs)
+{
+    char command[32];
+    char reply[32];
+    char hexSsid[FFS_MAXIMUM_SSID_SIZE * 2 + 1];
+    int networkId;
+
+    ffsLogDebug("Connect with WPA supplicant control interface");
+
+    // Replace the network of the previous attempt; the user's networks are left alone.
+    FFS_CHECK_RESULT(ffsWpaCtrlRemoveNetwork(ctrl));
+
+    FFS_CHECK_RESULT(ffsRaspbianWpaCtrlRequest(ctrl, WPA_CTRL_COMMAND_ADD_NETWORK, reply, sizeof(reply),
+            FFS_WPA_CTRL_REQUEST_TIMEOUT_MILLI));
+    if (sscanf(reply, "%d", &networkId) != 1) {
+        ffsLogError("Unexpected ADD_NETWORK reply: %s", reply);
+        FFS_FAIL(FFS_ERROR);
+    }
+    ctrl->networkId = networkId;
+
+    // Hex SSIDs need no quoting.
+    FFS_CHECK_RESULT(ffsWpaCtrlFormatHex(&configuration->ssidStream, hexSsid, sizeof(hexSsid)));
+    FFS_CHECK_RESULT(ffsWpaCtrlSetNetwork(ctrl, networkId, "ssid", hexSsid));
+    FFS_CHECK_RESULT(ffsWpaCtrlSetNetworkKey(ctrl, networkId, configuration));
+
+    if (configuration->isHiddenNetwork) {
+        FFS_CHECK_RESULT(ffsWpaCtrlSetNetwork(ctrl, networkId, "scan_ssid", "1"));
+    }
+
+    ffsWpaCtrlFlushEvents(ctrl);
+
+    snprintf(command, sizeof(command), WPA_CTRL_COMMAND_SELECT_NETWORK, networkId);
+    FFS_CHECK_RESULT(ffsWpaCtrlRequestOk(ctrl, command));
+
+    FFS_CHECK_RESULT(ffsWpaCtrlAwaitConnection(ctrl, wifiContext, timeoutMs));
+
+    // Stop the supplicant retrying a network that did not work.
+    if (wifiContext->connectionDetails.state == FFS_WIFI_CONNECTION_STATE_FAILED) {
+        FFS_CHECK_RESULT(ffsWpaCtrlRemoveNetwork(ctrl));
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Disconnect and wait for the supplicant to report it.
+ */
+FFS_RESULT ffsRaspbianWpaCtrlDisconnect(FfsRaspbianWpaCtrl_t *ctrl, int32_t timeoutMs)
+{
+    FFS_WIFI_CONNECTION_STATE state;
+    size_t eventIndex;
+
+    FFS_CHECK_RESULT(ffsRaspbianWpaCtrlGetConnectionState(ctrl, &state));
+
+    ffsWpaCtrlFlushEvents(ctrl);
+    FFS_CHECK_RESULT(ffsWpaCtrlRequestOk(ctrl, WPA_CTRL_COMMAND_DISCONNECT));
+
+    // Only an established connection reports the disconnection.
+    if (state != FFS_WIFI_CONNECTION_STATE_ASSOCIATED) {
+        return FFS_SUCCESS;
+    }
+
+    FFS_CHECK_RESULT(ffsRaspbianWpaCtrlWaitForEvent(ctrl, disconnectEvents,
+            sizeof(disconnectEvents) / sizeof(disconnectEvents[0]), timeoutMs, &eventIndex, NULL, 0));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Get the Wi-Fi connection state from the supplicant status.
+ */
+FFS_RESULT ffsRaspbianWpaCtrlGetConnectionState(FfsRaspbianWpaCtrl_t *ctrl, FFS_WIFI_CONNECTION_STATE *state)
+{
+    char reply[1024];
+
+    FFS_CHECK_RESULT(ffsRaspbianWpaCtrlRequest(ctrl, WPA_CTRL_COMMAND_STATUS, reply, sizeof(reply),
+            FFS_WPA_CTRL_REQUEST_TIMEOUT_MILLI));
+    FFS_CHECK_RESULT(ffsRaspbianWpaCtrlProcessStatus(reply, state));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Process a "SCAN_RESULTS" reply into the scan list.
+ */
+FFS_RESULT ffsRaspbianWpaCtrlProcessScanResults(FfsLinuxWifiContext_t *wifiContext, char *reply)
+{
+    char *savePointer;
+    char *line;
+    FFS_RESULT rc;
+
+    // Update the scan timestamp.
+    FFS_CHECK_RESULT(ffsWifiScanListTouch(wifiContext));
+
+    ffsLogDebug("Process WPA supplicant scan results");
+
+    // Skip the header line.
+    line = strtok_r(reply, "\n", &savePointer);
+    if (!line || strncmp(line, WPA_CTRL_SCAN_RESULTS_HEADER, strlen(WPA_CTRL_SCAN_RESULTS_HEADER))) {
+        ffsLogError("Unexpected scan results: %s", line ? line : "");
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    // Process each network.
+    while ((line = strtok_r(NULL, "\n", &savePointer))) {
+        rc = ffsWpaCtrlProcessScanResultLine(wifiContext, line);
+
+        if (rc != FFS_SUCCESS) {
+            ffsLogWarning("Error %d processing line \"%s\" of scan results, continuing", rc, line);
+        }
+    }
+
+    size_t scanListSize;
+    FFS_CHECK_RESULT(ffsWifiScanListGetSize(wifiContext, &scanListSize));
+    ffsLogDebug("Wi-Fi scan list size: %d", (int) scanListSize);
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Process a "STATUS" reply into a connection state.
+ */
+FFS_RESULT ffsRaspbianWpaCtrlProcessStatus(const char *reply, FFS_WIFI_CONNECTION_STATE *state)
+{
+    const char *line = reply;
+
+    // Find the "wpa_state" line.
+    while (strncmp(line, WPA_CTRL_STATUS_STATE, strlen(WPA_CTRL_STATUS_STATE))) {
+        line = strchr(line, '\n');
+        if (!line) {
+            ffsLogError("No wpa_state in supplicant status");
+            FFS_FAIL(FFS_ERROR);
+        }
+        line++;
+    }
+
+    char value[32];
+    const char *valueStart = line + strlen(WPA_CTRL_STATUS_STATE);
+    snprintf(value, sizeof(value), "%.*s", (int) strcspn(valueStart, "\n"), valueStart);
+
+    if (!strcmp(value, WPA_CTRL_STATE_COMPLETED)) {
+        *state = FFS_WIFI_CONNECTION_STATE_ASSOCIATED;
+    } else if (!strcmp(value, "AUTHENTICATING") || !strcmp(value, "ASSOCIATING") || !strcmp(value, "ASSOCIATED")
+            || !strcmp(value, "4WAY_HANDSHAKE") || !strcmp(value, "GROUP_HANDSHAKE")) {
+        // Connection in progress.
+        *state = FFS_WIFI_CONNECTION_STATE_AUTHENTICATED;
+    } else {
+        *state = FFS_WIFI_CONNECTION_STATE_DISCONNECTED;
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Open a datagram socket connected to the supplicant.
+ *
+ * @param controlPath Supplicant control socket
+ * @param socketFd Destination socket
+ * @param localPath Destination local socket address
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+static FFS_RESULT ffsWpaCtrlOpenSocket(const char *controlPath, int *socketFd, char *localPath) {
+    static unsigned int counter = 0;
+    struct sockaddr_un local;
+    struct sockaddr_un remote;
+
+    memset(&local, 0, sizeof(local));
+    memset(&remote, 0, sizeof(remote));
+    local.sun_family = AF_UNIX;
+    remote.sun_family = AF_UNIX;
+
+    if (strlen(controlPath) >= sizeof(remote.sun_path)) {
+        ffsLogError("WPA supplicant control path too long: %s", controlPath);
+        FFS_FAIL(FFS_OVERRUN);
+    }
+    strcpy(remote.sun_path, controlPath);
+
+    // The supplicant replies to our bound address.
+    snprintf(localPath, FFS_WPA_CTRL_MAXIMUM_PATH_SIZE, WPA_CTRL_LOCAL_PATH_FORMAT, (int) getpid(),
+            __sync_fetch_and_add(&counter, 1));
+    strcpy(local.sun_path, localPath);
+    unlink(localPath);
+
+    *socketFd = socket(PF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (*socketFd < 0) {
+        ffsLogError("Unable to create control socket: %s", strerror(errno));
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    if (bind(*socketFd, (struct sockaddr *) &local, sizeof(local))) {
+        ffsLogError("Unable to bind %s: %s", localPath, strerror(errno));
+        ffsWpaCtrlCloseSocket(socketFd, NULL);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    if (connect(*socketFd, (struct sockaddr *) &remote, sizeof(remote))) {
+        ffsLogError("Unable to connect to %s: %s", controlPath, strerror(errno));
+        ffsWpaCtrlCloseSocket(socketFd, localPath);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Close a control socket and remove its local address.
+ *
+ * @param socketFd Socket; set to -1
+ * @param localPath Local socket address, or NULL if not bound
+ */
+static void ffsWpaCtrlCloseSocket(int *socketFd, const char *localPath) {
+    if (*socketFd >= 0) {
+        close(*socketFd);
+        *socketFd = -1;
+
+        if (localPath && localPath[0]) {
+            unlink(localPath);
+        }
+    }
+}
+
+/** @brief Send a command on a socket and wait for the reply.
+ *
+ * @param socketFd Control socket
+ * @param command Null-terminated command
+ * @param reply Destination reply buffer
+ * @param replySize Size of the reply buffer
+ * @param timeoutMs Timeout in milliseconds
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+static FFS_RESULT ffsWpaCtrlExchange(int socketFd, const char *command, char *reply, size_t replySize,
+        int32_t timeoutMs) {
+    struct timespec deadline;
+
+    ffsWpaCtrlSetDeadline(&deadline, timeoutMs);
+
+    if (send(socketFd, command, strlen(command), 0) < 0) {
+        ffsLogError("Unable to send control command: %s", strerror(errno));
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    // Events can arrive ahead of the reply on an attached socket.
+    do {
+        FFS_RESULT result = ffsWpaCtrlReceive(socketFd, reply, replySize, ffsWpaCtrlGetRemainingTime(&deadline));
+        if (result != FFS_SUCCESS) {
+            return result;
+        }
+    } while (reply[0] == '<');
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Receive one null-terminated message.
+ *
+ * @param socketFd Control socket
+ * @param buffer Destination buffer
+ * @param bufferSize Size of the buffer
+ * @param timeoutMs Timeout in milliseconds
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT); @ref FFS_TIMEOUT if nothing arrives
+ */
+static FFS_RESULT ffsWpaCtrlReceive(int socketFd, char *buffer, size_t bufferSize, int32_t timeoutMs) {
+    struct pollfd pollFd = {
+        .fd = socketFd,
+        .events = POLLIN
+    };
+
+    int rc = poll(&pollFd, 1, timeoutMs);
+    if (rc < 0) {
+        ffsLogError("Error waiting on control socket: %s", strerror(errno));
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    if (rc == 0) {
+        return FFS_TIMEOUT;
+    }
+
+    ssize_t size = recv(socketFd, buffer, bufferSize - 1, 0);
+    if (size < 0) {
+        ffsLogError("Error reading control socket: %s", strerror(errno));
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    buffer[size] = '\0';
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Send a command that replies "OK".
+ *
+ * @param ctrl Control interface connection
+ * @param command Null-terminated command
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+static FFS_RESULT ffsWpaCtrlRequestOk(FfsRaspbianWpaCtrl_t *ctrl, const char *command) {
+    char reply[32];
+
+    FFS_CHECK_RESULT(ffsRaspbianWpaCtrlRequest(ctrl, command, reply, sizeof(reply),
+            FFS_WPA_CTRL_REQUEST_TIMEOUT_MILLI));
+
+    if (strncmp(reply, WPA_CTRL_REPLY_OK, strlen(WPA_CTRL_REPLY_OK))) {
+        // The command may hold a key, so only log the reply.
+        ffsLogError("WPA supplicant command failed: %s", reply);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Remove the network added by the last connection, if any.
+ *
+ * @param ctrl Control interface connection
+ */
+static FFS_RESULT ffsWpaCtrlRemoveNetwork(FfsRaspbianWpaCtrl_t *ctrl) {
+    char command[32];
+
+    if (ctrl->networkId < 0) {
+        return FFS_SUCCESS;
+    }
+
+    snprintf(command, sizeof(command), WPA_CTRL_COMMAND_REMOVE_NETWORK, ctrl->networkId);
+    ctrl->networkId = -1;
+
+    FFS_CHECK_RESULT(ffsWpaCtrlRequestOk(ctrl, command));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Set a network variable.
+ *
+ * @param ctrl Control interface connection
+ * @param networkId Network ID
+ * @param name Variable name
+ * @param value Variable value, quoted if a string
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+static FFS_RESULT ffsWpaCtrlSetNetwork(FfsRaspbianWpaCtrl_t *ctrl, int networkId, const char *name,
+        const char *value) {
+    char command[256];
+    FFS_RESULT result;
+
+    int size = snprintf(command, sizeof(command), WPA_CTRL_COMMAND_SET_NETWORK, networkId, name, value);
+
+    // Error (old GCC versions)?
+    if (size < 0) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    // Was the command buffer too small?
+    if (size >= (int) sizeof(command)) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    result = ffsWpaCtrlRequestOk(ctrl, command);
+
+    // Don't leave keys on the stack.
+    memset(command, 0, sizeof(command));
+
+    return result;
+}
+
+/** @brief Set the key management and key for a network.
+ *
+ * @param ctrl Control interface connection
+ * @param networkId Network ID
+ * @param configuration Wi-Fi configuration
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+static FFS_RESULT ffsWpaCtrlSetNetworkKey(FfsRaspbianWpaCtrl_t *ctrl, int networkId,
+        FfsWifiConfiguration_t *configuration) {
+    char key[128];
+    size_t keySize = FFS_STREAM_DATA_SIZE(configuration->keyStream);
+    const char *keyData = (const char *) FFS_STREAM_NEXT_READ(configuration->keyStream);
+    bool isRawKey;
+    FFS_RESULT result;
+
+    if (keySize + 3 > sizeof(key)) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    switch (configuration->securityProtocol) {
+    case FFS_WIFI_SECURITY_PROTOCOL_NONE:
+        return ffsWpaCtrlSetNetwork(ctrl, networkId, "key_mgmt", "NONE");
+    case FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK:
+        FFS_CHECK_RESULT(ffsWpaCtrlSetNetwork(ctrl, networkId, "key_mgmt", "WPA-PSK"));
+        isRawKey = keySize == WPA_CTRL_RAW_PSK_SIZE;
+        break;
+    case FFS_WIFI_SECURITY_PROTOCOL_WEP:
+        FFS_CHECK_RESULT(ffsWpaCtrlSetNetwork(ctrl, networkId, "key_mgmt", "NONE"));
+        FFS_CHECK_RESULT(ffsWpaCtrlSetNetwork(ctrl, networkId, "wep_tx_keyidx", "0"));
+        isRawKey = keySize == WPA_CTRL_WEP_40_HEX_SIZE || keySize == WPA_CTRL_WEP_104_HEX_SIZE;
+        break;
+    default:
+        ffsLogError("Key management type %d not supported by WPA supplicant",
+                (int) configuration->securityProtocol);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    // Hex keys are passed bare, passphrases and ASCII WEP keys quoted.
+    snprintf(key, sizeof(key), isRawKey ? "%.*s" : "\"%.*s\"", (int) keySize, keyData);
+
+    result = ffsWpaCtrlSetNetwork(ctrl, networkId,
+            configuration->securityProtocol == FFS_WIFI_SECURITY_PROTOCOL_WEP ? "wep_key0" : "psk", key);
+
+    memset(key, 0, sizeof(key));
+
+    return result;
+}
+
+/** @brief Wait for the outcome of a connection attempt.
+ *
+ * @param ctrl Control interface connection
+ * @param wifiContext Wi-Fi context
+ * @param timeoutMs Timeout in milliseconds
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+static FFS_RESULT ffsWpaCtrlAwaitConnection(FfsRaspbianWpaCtrl_t *ctrl, FfsLinuxWifiContext_t *wifiContext,
+        int32_t timeoutMs) {
+    char event[256];
+    size_t eventIndex;
+    int32_t notFoundCount = 0;
+    int32_t disconnectedCount = 0;
+    struct timespec deadline;
+
+    ffsWpaCtrlSetDeadline(&deadline, timeoutMs);
+
+    while (true) {
+        FFS_RESULT result = ffsRaspbianWpaCtrlWaitForEvent(ctrl, connectEvents,
+                sizeof(connectEvents) / sizeof(connectEvents[0]), ffsWpaCtrlGetRemainingTime(&deadline),
+                &eventIndex, event, sizeof(event));
+
+        if (result == FFS_TIMEOUT) {
+            ffsLogError("wpa_supplicant: connection timed out");
+            FFS_CHECK_RESULT(ffsUpdateWifiConnectionFailure(wifiContext, &ffsErrorDetailsLimitedConnectivity));
+            return FFS_SUCCESS;
+        }
+        FFS_CHECK_RESULT(result);
+
+        switch ((WPA_CTRL_CONNECT_EVENT) eventIndex) {
+        case WPA_CTRL_CONNECT_EVENT_CONNECTED:
+            ffsLogDebug("wpa_supplicant: connected");
+            return FFS_SUCCESS;
+        case WPA_CTRL_CONNECT_EVENT_SSID_TEMP_DISABLED:
+            if (strstr(event, WPA_CTRL_REASON_WRONG_KEY) || strstr(event, WPA_CTRL_REASON_AUTH_FAILED)) {
+                ffsLogError("wpa_supplicant: authentication failed");
+                FFS_CHECK_RESULT(ffsUpdateWifiConnectionFailure(wifiContext, &ffsErrorDetailsAuthenticationFailed));
+                return FFS_SUCCESS;
+            }
+            ffsLogDebug("%s", event);
+            break;
+        case WPA_CTRL_CONNECT_EVENT_NETWORK_NOT_FOUND:
+            if (++notFoundCount >= WPA_CTRL_FAILURES_ALLOWED) {
+                ffsLogError("wpa_supplicant: AP not found");
+                FFS_CHECK_RESULT(ffsUpdateWifiConnectionFailure(wifiContext, &ffsErrorDetailsApNotFound));
+                return FFS_SUCCESS;
+            }
+            break;
+        case WPA_CTRL_CONNECT_EVENT_DISCONNECTED:
+            ffsLogWarning("wpa_supplicant: %s", event);
+            if (++disconnectedCount >= WPA_CTRL_FAILURES_ALLOWED) {
+                ffsLogError("wpa_supplicant: all retries exhausted");
+                FFS_CHECK_RESULT(ffsUpdateWifiConnectionFailure(wifiContext, &ffsErrorDetailsLimitedConnectivity));
+                return FFS_SUCCESS;
+            }
+            break;
+        }
+    }
+}
+
+/** @brief Drop events queued before a command, so waits only see its outcome.
+ *
+ * @param ctrl Control interface connection
+ */
+static void ffsWpaCtrlFlushEvents(FfsRaspbianWpaCtrl_t *ctrl) {
+    char buffer[512];
+
+    while (recv(ctrl->monitorSocket, buffer, sizeof(buffer), MSG_DONTWAIT) > 0);
+}
+
+/** @brief Compute a deadline from now.
+ *
+ * @param deadline Destination deadline
+ * @param timeoutMs Timeout in milliseconds
+ */
+static void ffsWpaCtrlSetDeadline(struct timespec *deadline, int32_t timeoutMs) {
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+
+    deadline->tv_sec += timeoutMs / 1000;
+    deadline->tv_nsec += (long) (timeoutMs % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
+
+/** @brief Get the time left until a deadline.
+ *
+ * @param deadline Deadline
+ *
+ * @returns Milliseconds left, zero if passed
+ */
+static int32_t ffsWpaCtrlGetRemainingTime(const struct timespec *deadline) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    int64_t remainingMs = (int64_t) (deadline->tv_sec - now.tv_sec) * 1000
+            + (deadline->tv_nsec - now.tv_nsec) / 1000000L;
+
+    return remainingMs > 0 ? (int32_t) remainingMs : 0;
+}
+
+/** @brief Format a stream as a null-terminated hex string.
+ *
+ * @param stream Input stream
+ * @param destination Destination string
+ * @param destinationSize Size of the destination
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+static FFS_RESULT ffsWpaCtrlFormatHex(FfsStream_t *stream, char *destination, size_t destinationSize) {
+    size_t size = FFS_STREAM_DATA_SIZE(*stream);
+    const uint8_t *data = FFS_STREAM_NEXT_READ(*stream);
+
+    if (size * 2 + 1 > destinationSize) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    for (size_t index = 0; index < size; index++) {
+        snprintf(destination + index * 2, 3, "%02x", data[index]);
+    }
+    destination[size * 2] = '\0';
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Process one "bssid \t frequency \t signal \t flags \t ssid" line.
+ *
+ * @param wifiContext Wi-Fi context
+ * @param line Null-terminated line; modified in place
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+static FFS_RESULT ffsWpaCtrlProcessScanResultLine(FfsLinuxWifiContext_t *wifiContext, char *line) {
+    FFS_TEMPORARY_OUTPUT_STREAM(ssidStream, FFS_MAXIMUM_SSID_SIZE);
+    FFS_TEMPORARY_OUTPUT_STREAM(bssidStream, FFS_BSSID_SIZE);
+    FfsWifiScanResult_t scanResult;
+    uint8_t bssid[FFS_BSSID_SIZE];
+    char *cursor = line;
+
+    char *bssidField = ffsWpaCtrlNextField(&cursor);
+    char *frequencyField = ffsWpaCtrlNextField(&cursor);
+    char *signalField = ffsWpaCtrlNextField(&cursor);
+    char *flagsField = ffsWpaCtrlNextField(&cursor);
+    char *ssidField = cursor; //!< The rest of the line; tabs in SSIDs are escaped.
+
+    if (!bssidField || !frequencyField || !signalField || !flagsField || !ssidField) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    if (sscanf(bssidField, "%02" SCNx8 ":%02" SCNx8 ":%02" SCNx8 ":%02" SCNx8 ":%02" SCNx8 ":%02" SCNx8,
+            &bssid[0], &bssid[1], &bssid[2], &bssid[3], &bssid[4], &bssid[5]) < 6) {
+        ffsLogError("failed to parse BSSID: \"%s\"", bssidField);
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    // Hidden networks can't be selected by SSID.
+    if (!ssidField[0]) {
+        return FFS_SUCCESS;
+    }
+
+    memset(&scanResult, 0, sizeof(scanResult));
+    scanResult.ssidStream = ssidStream;
+    scanResult.bssidStream = bssidStream;
+
+    FFS_CHECK_RESULT(ffsWriteStream(bssid, FFS_BSSID_SIZE, &scanResult.bssidStream));
+    FFS_CHECK_RESULT(ffsWpaCtrlDecodeSsid(ssidField, &scanResult.ssidStream));
+    scanResult.frequencyBand = (int32_t) strtol(frequencyField, NULL, 10);
+    scanResult.signalStrength = (int32_t) strtol(signalField, NULL, 10);
+    scanResult.securityProtocol = ffsWpaCtrlGetSecurityProtocol(flagsField);
+
+    FFS_CHECK_RESULT(ffsWifiScanListPush(wifiContext, &scanResult));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Split off the next tab-separated field.
+ *
+ * @param cursor Line position; advanced past the tab
+ *
+ * @returns The null-terminated field, or NULL if there is no tab
+ */
+static char *ffsWpaCtrlNextField(char **cursor) {
+    char *field = *cursor;
+    char *tab = field ? strchr(field, '\t') : NULL;
+
+    if (!tab) {
+        *cursor = NULL;
+        return NULL;
+    }
+
+    *tab = '\0';
+    *cursor = tab + 1;
+
+    return field;
+}
+
+/** @brief Decode a supplicant-escaped SSID.
+ *
+ * @param field Escaped SSID
+ * @param ssidStream Destination SSID stream
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+static FFS_RESULT ffsWpaCtrlDecodeSsid(const char *field, FfsStream_t *ssidStream) {
+    while (*field) {
+        uint8_t byte = (uint8_t) *field++;
+
+        if (byte == '\\') {
+            switch (*field++) {
+            case '\\':
+                byte = '\\';
+                break;
+            case '"':
+                byte = '"';
+                break;
+            case 'e':
+                byte = 0x1b;
+                break;
+            case 'n':
+                byte = '\n';
+                break;
+            case 'r':
+                byte = '\r';
+                break;
+            case 't':
+                byte = '\t';
+                break;
+            case 'x':
+                if (sscanf(field, "%2" SCNx8, &byte) != 1 || !field[0] || !field[1]) {
+                    FFS_FAIL(FFS_ERROR);
+                }
+                field += 2;
+                break;
+            default:
+                FFS_FAIL(FFS_ERROR);
+            }
+        }
+
+        FFS_CHECK_RESULT(ffsWriteByteToStream(byte, ssidStream));
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Map scan result flags to a security protocol.
+ *
+ * @param flags Flags (\a e.g. "[WPA2-PSK-CCMP][ESS]")
+ *
+ * @returns Security protocol
+ */
+static FFS_WIFI_SECURITY_PROTOCOL ffsWpaCtrlGetSecurityProtocol(const char *flags) {
+    if (strstr(flags, "-PSK")) {
+        return FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK;
+    }
+
+    if (strstr(flags, "[WEP")) {
+        return FFS_WIFI_SECURITY_PROTOCOL_WEP;
+    }
+
+    // Enterprise, SAE-only and OWE networks.
+    if (strstr(flags, "[WPA") || strstr(flags, "[RSN") || strstr(flags, "[OSEN")) {
+        return FFS_WIFI_SECURITY_PROTOCOL_OTHER;
+    }
+
+    return FFS_WIFI_SECURITY_PROTOCOL_NONE;
+}
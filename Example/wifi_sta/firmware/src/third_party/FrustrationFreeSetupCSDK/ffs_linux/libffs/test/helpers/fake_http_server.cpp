@@ -0,0 +1,144 @@
+/** @file fake_http_server.cpp
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "fake_http_server.h"
+
+#include <arpa/inet.h>
+#include <chrono>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define FAKE_HTTP_SERVER_POLL_MILLI (20)
+
+FakeHttpServer::FakeHttpServer() : listenFd(-1), port(0), stopping(false), delayMs(0), requestCount(0)
+{
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0 || bind(listenFd, (struct sockaddr *) &address, sizeof(address)) || listen(listenFd, 16)) {
+        perror("fake HTTP server");
+        return;
+    }
+
+    socklen_t addressSize = sizeof(address);
+    getsockname(listenFd, (struct sockaddr *) &address, &addressSize);
+    port = ntohs(address.sin_port);
+
+    thread = std::thread(&FakeHttpServer::run, this);
+}
+
+FakeHttpServer::~FakeHttpServer()
+{
+    stopping = true;
+    if (thread.joinable()) {
+        thread.join();
+    }
+    for (std::thread &client : clients) {
+        client.join();
+    }
+
+    if (listenFd >= 0) {
+        close(listenFd);
+    }
+}
+
+void FakeHttpServer::setResponse(const std::string &newResponse, uint32_t newDelayMs)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    response = newResponse;
+    delayMs = newDelayMs;
+}
+
+size_t FakeHttpServer::getRequestCount()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return requestCount;
+}
+
+void FakeHttpServer::run()
+{
+    while (!stopping) {
+        struct pollfd pollFd = { listenFd, POLLIN, 0 };
+        if (poll(&pollFd, 1, FAKE_HTTP_SERVER_POLL_MILLI) <= 0) {
+            continue;
+        }
+
+        int clientFd = accept(listenFd, NULL, NULL);
+        if (clientFd < 0) {
+            continue;
+        }
+
+        clients.push_back(std::thread(&FakeHttpServer::serve, this, clientFd));
+    }
+}
+
+void FakeHttpServer::serve(int clientFd)
+{
+    std::string request;
+    size_t requestSize = 0;
+    char buffer[1024];
+
+    // Read the headers and the body.
+    while (!stopping && (!requestSize || request.size() < requestSize)) {
+        struct pollfd pollFd = { clientFd, POLLIN, 0 };
+        if (poll(&pollFd, 1, FAKE_HTTP_SERVER_POLL_MILLI) <= 0) {
+            continue;
+        }
+
+        ssize_t size = recv(clientFd, buffer, sizeof(buffer), 0);
+        if (size <= 0) {
+            close(clientFd);
+            return;
+        }
+        request.append(buffer, size);
+
+        size_t headerEnd = request.find("\r\n\r\n");
+        if (!requestSize && headerEnd != std::string::npos) {
+            requestSize = headerEnd + 4;
+            const char *contentLength = strcasestr(request.c_str(), "Content-Length:");
+            if (contentLength && contentLength < request.c_str() + headerEnd) {
+                requestSize += strtoul(contentLength + strlen("Content-Length:"), NULL, 10);
+            }
+        }
+    }
+
+    std::string reply;
+    std::chrono::steady_clock::time_point replyTime;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requestCount++;
+        reply = response;
+        replyTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(delayMs);
+    }
+
+    // Wait for the delay, or forever without a response.
+    while (!stopping && (reply.empty() || std::chrono::steady_clock::now() < replyTime)) {
+        usleep(FAKE_HTTP_SERVER_POLL_MILLI * 1000);
+    }
+
+    if (!reply.empty()) {
+        send(clientFd, reply.data(), reply.size(), MSG_NOSIGNAL);
+    }
+
+    close(clientFd);
+}
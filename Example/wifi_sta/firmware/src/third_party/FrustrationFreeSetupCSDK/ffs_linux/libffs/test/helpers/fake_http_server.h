@@ -0,0 +1,65 @@
+/** @file fake_http_server.h
+ *
+ * @brief Scripted local HTTP server for tests.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#ifndef FAKE_HTTP_SERVER_H_
+#define FAKE_HTTP_SERVER_H_
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** @brief Loopback TCP server answering every request with one canned response.
+ *
+ * Each connection reads one request (headers and any "Content-Length" body),
+ * waits for the configured delay and writes the response. An empty response
+ * holds the connection open without answering, until the server stops.
+ */
+class FakeHttpServer {
+public:
+    FakeHttpServer();
+    ~FakeHttpServer();
+
+    /** @brief Port the server listens on (127.0.0.1).
+     */
+    uint16_t getPort() const { return port; }
+
+    /** @brief Set the raw response (status line, headers and body).
+     */
+    void setResponse(const std::string &response, uint32_t delayMs = 0);
+
+    /** @brief Number of requests received so far.
+     */
+    size_t getRequestCount();
+
+private:
+    void run();
+    void serve(int clientFd);
+
+    int listenFd;
+    uint16_t port;
+    std::atomic<bool> stopping;
+    std::thread thread;
+    std::mutex mutex;
+    std::string response;
+    uint32_t delayMs;
+    size_t requestCount;
+    std::vector<std::thread> clients;
+};
+
+#endif /* FAKE_HTTP_SERVER_H_ */
@@ -0,0 +1,147 @@
+/** @file fake_wpa_supplicant.cpp
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "fake_wpa_supplicant.h"
+
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define FAKE_WPA_SUPPLICANT_POLL_MILLI (20)
+
+FakeWpaSupplicant::FakeWpaSupplicant() : socketFd(-1), stopping(false)
+{
+    static std::atomic<unsigned int> counter(0);
+    char buffer[64];
+
+    snprintf(buffer, sizeof(buffer), "/tmp/ffs_fake_wpa_%d-%u", (int) getpid(), counter++);
+    path = buffer;
+    unlink(path.c_str());
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    socketFd = socket(PF_UNIX, SOCK_DGRAM, 0);
+    if (socketFd < 0 || bind(socketFd, (struct sockaddr *) &address, sizeof(address))) {
+        perror("fake wpa_supplicant");
+        return;
+    }
+
+    thread = std::thread(&FakeWpaSupplicant::run, this);
+}
+
+FakeWpaSupplicant::~FakeWpaSupplicant()
+{
+    stopping = true;
+    if (thread.joinable()) {
+        thread.join();
+    }
+
+    if (socketFd >= 0) {
+        close(socketFd);
+    }
+    unlink(path.c_str());
+}
+
+void FakeWpaSupplicant::setReply(const std::string &command, const std::string &reply)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    replies[command] = reply;
+}
+
+void FakeWpaSupplicant::setEvents(const std::string &command, const std::vector<std::string> &commandEvents)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    events[command] = commandEvents;
+}
+
+std::vector<std::string> FakeWpaSupplicant::getCommands()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return commands;
+}
+
+std::string FakeWpaSupplicant::getKey(const std::string &command)
+{
+    if (replies.count(command) || events.count(command)) {
+        return command;
+    }
+
+    return command.substr(0, command.find(' '));
+}
+
+void FakeWpaSupplicant::run()
+{
+    char buffer[4096];
+
+    while (!stopping) {
+        struct pollfd pollFd = { socketFd, POLLIN, 0 };
+        if (poll(&pollFd, 1, FAKE_WPA_SUPPLICANT_POLL_MILLI) <= 0) {
+            continue;
+        }
+
+        struct sockaddr_un from;
+        socklen_t fromSize = sizeof(from);
+        ssize_t size = recvfrom(socketFd, buffer, sizeof(buffer) - 1, 0, (struct sockaddr *) &from, &fromSize);
+        if (size < 0) {
+            continue;
+        }
+
+        std::string command(buffer, size);
+        std::string reply = "OK\n";
+        std::vector<std::string> commandEvents;
+        std::vector<struct sockaddr_un> attached;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            commands.push_back(command);
+
+            std::string key = getKey(command);
+
+            if (command == "ATTACH") {
+                monitors.push_back(from);
+            } else if (command == "DETACH") {
+                for (auto monitor = monitors.begin(); monitor != monitors.end(); ++monitor) {
+                    if (!strcmp(monitor->sun_path, from.sun_path)) {
+                        monitors.erase(monitor);
+                        break;
+                    }
+                }
+            } else if (replies.count(key)) {
+                reply = replies[key];
+            } else if (key == "ADD_NETWORK") {
+                reply = "0\n";
+            }
+
+            if (events.count(key)) {
+                commandEvents = events[key];
+            }
+            attached = monitors;
+        }
+
+        if (!reply.empty()) {
+            sendto(socketFd, reply.data(), reply.size(), 0, (struct sockaddr *) &from, fromSize);
+        }
+
+        for (const std::string &event : commandEvents) {
+            for (struct sockaddr_un &monitor : attached) {
+                sendto(socketFd, event.data(), event.size(), 0, (struct sockaddr *) &monitor, sizeof(monitor));
+            }
+        }
+    }
+}
@@ -0,0 +1,72 @@
+/** @file fake_wpa_supplicant.h
+ *
+ * @brief Scripted WPA supplicant control socket for tests.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#ifndef FAKE_WPA_SUPPLICANT_H_
+#define FAKE_WPA_SUPPLICANT_H_
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <sys/un.h>
+#include <thread>
+#include <vector>
+
+/** @brief Datagram server speaking the supplicant control protocol.
+ *
+ * Handles ATTACH/DETACH itself and answers every other command from a
+ * table keyed by command name (the first word, or the whole command).
+ * Unscripted commands reply "OK\n", except "ADD_NETWORK" which replies
+ * "0\n". Events scripted against a command are sent to attached clients
+ * right after its reply.
+ */
+class FakeWpaSupplicant {
+public:
+    FakeWpaSupplicant();
+    ~FakeWpaSupplicant();
+
+    /** @brief Control socket path to open.
+     */
+    const char *getPath() const { return path.c_str(); }
+
+    /** @brief Set the reply to a command; an empty reply sends nothing.
+     */
+    void setReply(const std::string &command, const std::string &reply);
+
+    /** @brief Send events (\a e.g. "<3>CTRL-EVENT-CONNECTED") after a command.
+     */
+    void setEvents(const std::string &command, const std::vector<std::string> &events);
+
+    /** @brief Commands received so far, in order.
+     */
+    std::vector<std::string> getCommands();
+
+private:
+    void run();
+    std::string getKey(const std::string &command);
+
+    std::string path;
+    int socketFd;
+    std::atomic<bool> stopping;
+    std::thread thread;
+    std::mutex mutex;
+    std::map<std::string, std::string> replies;
+    std::map<std::string, std::vector<std::string>> events;
+    std::vector<std::string> commands;
+    std::vector<struct sockaddr_un> monitors;
+};
+
+#endif /* FAKE_WPA_SUPPLICANT_H_ */
@@ -0,0 +1,229 @@
+/** @file ffs_linux_crypto_cache_tests.cpp
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/compat/ffs_common_compat.h"
+#include "ffs/compat/ffs_linux_user_context.h"
+#include "ffs/linux/ffs_linux_crypto_cache.h"
+#include "ffs/linux/ffs_linux_crypto_common.h"
+
+#include <gtest/gtest.h>
+#include <openssl/ec.h>
+#include <openssl/sha.h>
+#include <openssl/x509.h>
+#include <vector>
+
+#define ZERO_FILL(variable) memset(&variable, 0, sizeof(variable))
+
+#define TEST_PAYLOAD            ("{\"nonce\":\"0BP1mq2Q7Ov7kWbN9wzRmA\",\"sessionId\":\"6b1f2d6e\"}")
+#define TEST_KEY_COUNT          (3)
+
+class LinuxCryptoCacheTests: public ::testing::Test {
+protected:
+    void SetUp()
+    {
+        ZERO_FILL(userContext);
+
+        for (size_t index = 0; index < TEST_KEY_COUNT; index++) {
+            keys[index] = generateKey();
+            ASSERT_TRUE(keys[index]);
+        }
+    }
+
+    void TearDown()
+    {
+        ffsInvalidateLinuxCryptoCache(&userContext.cryptoCache);
+
+        for (size_t index = 0; index < TEST_KEY_COUNT; index++) {
+            EVP_PKEY_free(keys[index]);
+        }
+    }
+
+    static EVP_PKEY *generateKey()
+    {
+        EVP_PKEY *key = NULL;
+        EVP_PKEY_CTX *keyContext = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, NULL);
+
+        if (keyContext && EVP_PKEY_keygen_init(keyContext) == 1
+                && EVP_PKEY_CTX_set_ec_paramgen_curve_nid(keyContext, NID_X9_62_prime256v1) == 1) {
+            EVP_PKEY_keygen(keyContext, &key);
+        }
+        EVP_PKEY_CTX_free(keyContext);
+
+        return key;
+    }
+
+    static std::vector<uint8_t> encodeKey(EVP_PKEY *key)
+    {
+        std::vector<uint8_t> der(i2d_PUBKEY(key, NULL));
+        uint8_t *writePointer = der.data();
+        i2d_PUBKEY(key, &writePointer);
+
+        return der;
+    }
+
+    /** @brief Uncached reference: SHA-256 of the ECDH shared secret.
+     */
+    static std::vector<uint8_t> computeSecret(EVP_PKEY *privateKey, EVP_PKEY *peerKey)
+    {
+        std::vector<uint8_t> sharedSecret(64);
+        size_t sharedSecretSize = sharedSecret.size();
+        EVP_PKEY_CTX *context = EVP_PKEY_CTX_new(privateKey, NULL);
+        EVP_PKEY_derive_init(context);
+        EVP_PKEY_derive_set_peer(context, peerKey);
+        EVP_PKEY_derive(context, sharedSecret.data(), &sharedSecretSize);
+        EVP_PKEY_CTX_free(context);
+
+        std::vector<uint8_t> secret(SHA256_DIGEST_LENGTH);
+        SHA256(sharedSecret.data(), sharedSecretSize, secret.data());
+
+        return secret;
+    }
+
+    std::vector<uint8_t> computeEcdhKey(EVP_PKEY *peerKey)
+    {
+        std::vector<uint8_t> peerDer = encodeKey(peerKey);
+        FfsStream_t peerDerStream = ffsCreateInputStream(peerDer.data(), peerDer.size());
+        std::vector<uint8_t> secret(SHA256_DIGEST_LENGTH);
+        FfsStream_t secretStream = ffsCreateOutputStream(secret.data(), secret.size());
+
+        EXPECT_EQ(ffsComputeECDHKey(&userContext, &peerDerStream, &secretStream), FFS_SUCCESS);
+        EXPECT_EQ(FFS_STREAM_DATA_SIZE(peerDerStream), peerDer.size());
+
+        return secret;
+    }
+
+    bool signAndVerify(EVP_PKEY *signingKey, EVP_PKEY *verificationKey)
+    {
+        userContext.devicePrivateKey = signingKey;
+        userContext.cloudPublicKey = verificationKey;
+
+        FFS_TEMPORARY_OUTPUT_STREAM(signatureStream, 128);
+        FfsStream_t payloadStream = FFS_STRING_INPUT_STREAM(TEST_PAYLOAD);
+        EXPECT_EQ(ffsSignPayload(&userContext, &payloadStream, &signatureStream), FFS_SUCCESS);
+
+        bool isVerified = false;
+        EXPECT_EQ(ffsVerifyCloudSignature(&userContext, &payloadStream, &signatureStream, &isVerified),
+                FFS_SUCCESS);
+
+        userContext.devicePrivateKey = NULL;
+        userContext.cloudPublicKey = NULL;
+
+        return isVerified;
+    }
+
+    FfsUserContext_t userContext;
+    EVP_PKEY *keys[TEST_KEY_COUNT];
+};
+
+/** @brief Signatures made and verified with the cached contexts are valid, every time.
+ */
+TEST_F(LinuxCryptoCacheTests, SignAndVerify)
+{
+    ASSERT_TRUE(signAndVerify(keys[0], keys[0]));
+
+    EVP_MD_CTX *signContext = userContext.cryptoCache.signContext.initializedContext;
+    EVP_MD_CTX *verifyContext = userContext.cryptoCache.verifyContext.initializedContext;
+    ASSERT_TRUE(signContext);
+    ASSERT_TRUE(verifyContext);
+
+    ASSERT_TRUE(signAndVerify(keys[0], keys[0]));
+    ASSERT_EQ(userContext.cryptoCache.signContext.initializedContext, signContext);
+    ASSERT_EQ(userContext.cryptoCache.verifyContext.initializedContext, verifyContext);
+}
+
+/** @brief Replacing a key rebuilds the contexts made for the old one.
+ */
+TEST_F(LinuxCryptoCacheTests, KeyChange)
+{
+    ASSERT_TRUE(signAndVerify(keys[0], keys[0]));
+    ASSERT_FALSE(signAndVerify(keys[1], keys[0]));
+    ASSERT_FALSE(signAndVerify(keys[0], keys[1]));
+    ASSERT_TRUE(signAndVerify(keys[1], keys[1]));
+}
+
+/** @brief The cached ECDH context gives the same secret as a fresh computation.
+ */
+TEST_F(LinuxCryptoCacheTests, Ecdh)
+{
+    userContext.devicePrivateKey = keys[0];
+
+    ASSERT_EQ(computeEcdhKey(keys[1]), computeSecret(keys[0], keys[1]));
+    EVP_PKEY_CTX *deriveContext = userContext.cryptoCache.deriveContext.context;
+    ASSERT_TRUE(deriveContext);
+
+    ASSERT_EQ(computeEcdhKey(keys[1]), computeSecret(keys[0], keys[1]));
+    ASSERT_EQ(userContext.cryptoCache.deriveContext.context, deriveContext);
+
+    // New peer.
+    ASSERT_EQ(computeEcdhKey(keys[2]), computeSecret(keys[0], keys[2]));
+
+    // New private key.
+    userContext.devicePrivateKey = keys[1];
+    ASSERT_EQ(computeEcdhKey(keys[2]), computeSecret(keys[1], keys[2]));
+
+    userContext.devicePrivateKey = NULL;
+}
+
+/** @brief Without a private key, ECDH fails instead of using a cached context.
+ */
+TEST_F(LinuxCryptoCacheTests, EcdhWithoutPrivateKey)
+{
+    userContext.devicePrivateKey = keys[0];
+    computeEcdhKey(keys[1]);
+
+    userContext.devicePrivateKey = NULL;
+    std::vector<uint8_t> peerDer = encodeKey(keys[1]);
+    FfsStream_t peerDerStream = ffsCreateInputStream(peerDer.data(), peerDer.size());
+    FFS_TEMPORARY_OUTPUT_STREAM(secretStream, SHA256_DIGEST_LENGTH);
+    ASSERT_EQ(ffsComputeECDHKey(&userContext, &peerDerStream, &secretStream), FFS_ERROR);
+}
+
+/** @brief The cached DER encoding follows the key.
+ */
+TEST_F(LinuxCryptoCacheTests, DerEncodedPublicKey)
+{
+    FfsLinuxCachedDerKey_t *cachedKey = &userContext.cryptoCache.devicePublicKeyDer;
+
+    for (size_t index = 0; index < 2 * TEST_KEY_COUNT; index++) {
+        EVP_PKEY *key = keys[index / 2];
+        std::vector<uint8_t> der = encodeKey(key);
+
+        FFS_TEMPORARY_OUTPUT_STREAM(derStream, FFS_LINUX_CRYPTO_CACHE_MAXIMUM_DER_SIZE);
+        ASSERT_EQ(ffsGetCachedDerEncodedPublicKey(cachedKey, key, &derStream), FFS_SUCCESS);
+        ASSERT_EQ(std::vector<uint8_t>(FFS_STREAM_NEXT_READ(derStream),
+                FFS_STREAM_NEXT_READ(derStream) + FFS_STREAM_DATA_SIZE(derStream)), der);
+        ASSERT_EQ(cachedKey->key, key);
+    }
+
+    // Too small a destination.
+    FFS_TEMPORARY_OUTPUT_STREAM(shortStream, 16);
+    ASSERT_EQ(ffsGetCachedDerEncodedPublicKey(cachedKey, keys[0], &shortStream), FFS_OVERRUN);
+}
+
+/** @brief Invalidation releases every entry, and the cache fills up again.
+ */
+TEST_F(LinuxCryptoCacheTests, Invalidate)
+{
+    userContext.devicePrivateKey = keys[0];
+    computeEcdhKey(keys[1]);
+    userContext.devicePrivateKey = NULL;
+    ASSERT_TRUE(signAndVerify(keys[0], keys[0]));
+
+    ffsInvalidateLinuxCryptoCache(&userContext.cryptoCache);
+    ASSERT_FALSE(userContext.cryptoCache.signContext.key);
+    ASSERT_FALSE(userContext.cryptoCache.verifyContext.initializedContext);
+    ASSERT_FALSE(userContext.cryptoCache.deriveContext.context);
+
+    ASSERT_TRUE(signAndVerify(keys[0], keys[0]));
+}
@@ -0,0 +1,285 @@
+/** @file ffs_linux_http_async_tests.cpp
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_http.h"
+#include "ffs/compat/ffs_common_compat.h"
+#include "ffs/compat/ffs_linux_user_context.h"
+#include "fake_http_server.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#define ZERO_FILL(variable) memset(&variable, 0, sizeof(variable))
+
+#define TEST_HOST               ("127.0.0.1")
+#define TEST_PATH               ("test")
+#define TEST_REQUEST_BODY       ("TEST")
+#define TEST_RESPONSE_BODY      ("RESPONSE")
+#define TEST_RESPONSE           ("HTTP/1.1 200 OK\r\nContent-Length: 8\r\nConnection: close\r\n\r\nRESPONSE")
+#define TEST_DELAY_MS           (300)
+#define TEST_TIMEOUT_MS         (200)
+#define TEST_OPERATION_COUNT    (4)
+#define REQUEST_BODY_SZ         (64)
+
+/** @brief Test callback data.
+ */
+typedef struct {
+    int32_t statusCode;
+    std::string body;
+    int completionCount;
+    FFS_RESULT completionResult;
+    std::atomic<bool> isComplete;
+} TestCallbackData_t;
+
+/** @brief Save the status code.
+ */
+static FFS_RESULT handleStatusCode(int32_t statusCode, void *callbackDataPointer)
+{
+    TestCallbackData_t *testCallbackData = (TestCallbackData_t *) callbackDataPointer;
+
+    testCallbackData->statusCode = statusCode;
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Save the response body.
+ */
+static FFS_RESULT handleBody(FfsStream_t *bodyStream, void *callbackDataPointer)
+{
+    TestCallbackData_t *testCallbackData = (TestCallbackData_t *) callbackDataPointer;
+
+    testCallbackData->body.append((const char *) FFS_STREAM_NEXT_READ(*bodyStream),
+            FFS_STREAM_DATA_SIZE(*bodyStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Save the completion result.
+ */
+static void handleCompletion(FfsHttpOperation_t *operation, FFS_RESULT result, void *callbackDataPointer)
+{
+    (void) operation;
+
+    TestCallbackData_t *testCallbackData = (TestCallbackData_t *) callbackDataPointer;
+
+    testCallbackData->completionCount++;
+    testCallbackData->completionResult = result;
+    testCallbackData->isComplete = true;
+}
+
+class HttpAsyncTests: public ::testing::Test {
+protected:
+    void SetUp()
+    {
+        ZERO_FILL(userContext);
+        ZERO_FILL(request);
+
+        request.operation = FFS_HTTP_OPERATION_POST;
+        request.url.scheme = FFS_HTTP_SCHEME_HTTP;
+        request.url.hostStream = FFS_STRING_INPUT_STREAM(TEST_HOST);
+        request.url.port = server.getPort();
+        request.url.path = TEST_PATH;
+        request.bodyStream = ffsCreateOutputStream(requestBody, sizeof(requestBody));
+        ffsWriteStringToStream(TEST_REQUEST_BODY, &request.bodyStream);
+        request.callbacks.handleStatusCode = handleStatusCode;
+        request.callbacks.handleBody = handleBody;
+    }
+
+    void resetCallbackData(TestCallbackData_t *testCallbackData)
+    {
+        testCallbackData->statusCode = 0;
+        testCallbackData->body.clear();
+        testCallbackData->completionCount = 0;
+        testCallbackData->completionResult = FFS_SUCCESS;
+        testCallbackData->isComplete = false;
+    }
+
+    FakeHttpServer server;
+    struct FfsUserContext_s userContext;
+    FfsHttpRequest_t request;
+    uint8_t requestBody[REQUEST_BODY_SZ];
+};
+
+/** @brief The synchronous wrapper returns after the response handlers ran.
+ */
+TEST_F(HttpAsyncTests, Execute)
+{
+    server.setResponse(TEST_RESPONSE);
+
+    TestCallbackData_t testCallbackData;
+    resetCallbackData(&testCallbackData);
+
+    ASSERT_EQ(ffsHttpExecute(&userContext, &request, &testCallbackData), FFS_SUCCESS);
+
+    ASSERT_EQ(testCallbackData.statusCode, 200);
+    ASSERT_EQ(testCallbackData.body, TEST_RESPONSE_BODY);
+    ASSERT_EQ(server.getRequestCount(), 1U);
+}
+
+/** @brief An asynchronous operation completes through the callbacks.
+ */
+TEST_F(HttpAsyncTests, ExecuteAsync)
+{
+    server.setResponse(TEST_RESPONSE);
+
+    TestCallbackData_t testCallbackData;
+    resetCallbackData(&testCallbackData);
+
+    FfsHttpOperation_t *operation;
+    ASSERT_EQ(ffsHttpExecuteAsync(&userContext, &request, &testCallbackData, 0, handleCompletion, &operation),
+            FFS_SUCCESS);
+    ASSERT_EQ(ffsHttpWait(&userContext, operation), FFS_SUCCESS);
+
+    ASSERT_EQ(testCallbackData.completionCount, 1);
+    ASSERT_EQ(testCallbackData.completionResult, FFS_SUCCESS);
+    ASSERT_EQ(testCallbackData.statusCode, 200);
+    ASSERT_EQ(testCallbackData.body, TEST_RESPONSE_BODY);
+}
+
+/** @brief A detached operation releases itself after the completion callback.
+ */
+TEST_F(HttpAsyncTests, ExecuteAsyncDetached)
+{
+    server.setResponse(TEST_RESPONSE);
+
+    TestCallbackData_t testCallbackData;
+    resetCallbackData(&testCallbackData);
+
+    ASSERT_EQ(ffsHttpExecuteAsync(&userContext, &request, &testCallbackData, 0, handleCompletion, NULL),
+            FFS_SUCCESS);
+
+    for (int i = 0; i < 100 && !testCallbackData.isComplete; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    ASSERT_TRUE(testCallbackData.isComplete);
+    ASSERT_EQ(testCallbackData.completionResult, FFS_SUCCESS);
+    ASSERT_EQ(testCallbackData.body, TEST_RESPONSE_BODY);
+}
+
+/** @brief Operations run concurrently on the event thread.
+ */
+TEST_F(HttpAsyncTests, ExecuteAsyncConcurrent)
+{
+    server.setResponse(TEST_RESPONSE, TEST_DELAY_MS);
+
+    TestCallbackData_t testCallbackData[TEST_OPERATION_COUNT];
+    FfsHttpOperation_t *operations[TEST_OPERATION_COUNT];
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < TEST_OPERATION_COUNT; i++) {
+        resetCallbackData(&testCallbackData[i]);
+        ASSERT_EQ(ffsHttpExecuteAsync(&userContext, &request, &testCallbackData[i], 0, handleCompletion,
+                &operations[i]), FFS_SUCCESS);
+    }
+
+    for (int i = 0; i < TEST_OPERATION_COUNT; i++) {
+        ASSERT_EQ(ffsHttpWait(&userContext, operations[i]), FFS_SUCCESS);
+        ASSERT_EQ(testCallbackData[i].body, TEST_RESPONSE_BODY);
+    }
+
+    // Overlapped, not serialized.
+    ASSERT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(TEST_DELAY_MS * (TEST_OPERATION_COUNT - 1)));
+}
+
+/** @brief An operation that outlives its time limit completes with a timeout.
+ */
+TEST_F(HttpAsyncTests, ExecuteAsyncTimeout)
+{
+    // Never answer.
+    server.setResponse("");
+
+    TestCallbackData_t testCallbackData;
+    resetCallbackData(&testCallbackData);
+
+    FfsHttpOperation_t *operation;
+    ASSERT_EQ(ffsHttpExecuteAsync(&userContext, &request, &testCallbackData, TEST_TIMEOUT_MS, handleCompletion,
+            &operation), FFS_SUCCESS);
+    ASSERT_EQ(ffsHttpWait(&userContext, operation), FFS_TIMEOUT);
+
+    ASSERT_EQ(testCallbackData.completionCount, 1);
+    ASSERT_EQ(testCallbackData.completionResult, FFS_TIMEOUT);
+    ASSERT_EQ(testCallbackData.statusCode, 0);
+}
+
+/** @brief A cancelled operation completes with an error and no response.
+ */
+TEST_F(HttpAsyncTests, Cancel)
+{
+    // Never answer.
+    server.setResponse("");
+
+    TestCallbackData_t testCallbackData;
+    resetCallbackData(&testCallbackData);
+
+    FfsHttpOperation_t *operation;
+    ASSERT_EQ(ffsHttpExecuteAsync(&userContext, &request, &testCallbackData, 0, handleCompletion, &operation),
+            FFS_SUCCESS);
+
+    // Let the request reach the server.
+    for (int i = 0; i < 100 && !server.getRequestCount(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    ASSERT_EQ(ffsHttpCancel(&userContext, operation), FFS_SUCCESS);
+    ASSERT_EQ(ffsHttpWait(&userContext, operation), FFS_ERROR);
+
+    ASSERT_EQ(testCallbackData.completionCount, 1);
+    ASSERT_EQ(testCallbackData.completionResult, FFS_ERROR);
+    ASSERT_EQ(testCallbackData.statusCode, 0);
+    ASSERT_TRUE(testCallbackData.body.empty());
+}
+
+/** @brief Cancelling a completed operation leaves its result alone.
+ */
+TEST_F(HttpAsyncTests, CancelCompleted)
+{
+    server.setResponse(TEST_RESPONSE);
+
+    TestCallbackData_t testCallbackData;
+    resetCallbackData(&testCallbackData);
+
+    FfsHttpOperation_t *operation;
+    ASSERT_EQ(ffsHttpExecuteAsync(&userContext, &request, &testCallbackData, 0, handleCompletion, &operation),
+            FFS_SUCCESS);
+
+    for (int i = 0; i < 100 && !testCallbackData.isComplete; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    ASSERT_EQ(ffsHttpCancel(&userContext, operation), FFS_SUCCESS);
+    ASSERT_EQ(ffsHttpWait(&userContext, operation), FFS_SUCCESS);
+    ASSERT_EQ(testCallbackData.completionCount, 1);
+}
+
+/** @brief An invalid request fails without starting.
+ */
+TEST_F(HttpAsyncTests, ExecuteAsyncInvalidOperation)
+{
+    request.operation = FFS_HTTP_OPERATION_UNDEFINED;
+
+    TestCallbackData_t testCallbackData;
+    resetCallbackData(&testCallbackData);
+
+    FfsHttpOperation_t *operation = NULL;
+    ASSERT_EQ(ffsHttpExecuteAsync(&userContext, &request, &testCallbackData, 0, handleCompletion, &operation),
+            FFS_ERROR);
+    ASSERT_EQ(operation, (FfsHttpOperation_t *) NULL);
+    ASSERT_EQ(testCallbackData.completionCount, 0);
+}
@@ -0,0 +1,233 @@
+/** @file ffs_linux_http_impairment_tests.cpp
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_http.h"
+#include "ffs/compat/ffs_common_compat.h"
+#include "ffs/compat/ffs_linux_user_context.h"
+#include "ffs/linux/ffs_network_impairment.h"
+#include "fake_http_server.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#define ZERO_FILL(variable) memset(&variable, 0, sizeof(variable))
+
+#define TEST_HOST               ("127.0.0.1")
+#define TEST_PATH               ("test")
+#define TEST_REQUEST_BODY       ("TEST")
+#define TEST_RESPONSE_BODY      ("RESPONSE")
+#define TEST_RESPONSE           ("HTTP/1.1 200 OK\r\nContent-Length: 8\r\nConnection: close\r\n\r\nRESPONSE")
+#define TEST_LATENCY_MS         (300)
+#define TEST_LONG_LATENCY_MS    (5000)
+#define TEST_STALL_MS           (5000)
+#define TEST_TIMEOUT_MS         (200)
+#define TEST_READ_SIZE          (3)
+#define TEST_SEED               (1)
+#define REQUEST_BODY_SZ         (64)
+
+/** @brief Test callback data.
+ */
+typedef struct {
+    int32_t statusCode;
+    std::string body;
+    int bodyCallbackCount;
+} TestCallbackData_t;
+
+/** @brief Save the status code.
+ */
+static FFS_RESULT handleStatusCode(int32_t statusCode, void *callbackDataPointer)
+{
+    TestCallbackData_t *testCallbackData = (TestCallbackData_t *) callbackDataPointer;
+
+    testCallbackData->statusCode = statusCode;
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Save the response body.
+ */
+static FFS_RESULT handleBody(FfsStream_t *bodyStream, void *callbackDataPointer)
+{
+    TestCallbackData_t *testCallbackData = (TestCallbackData_t *) callbackDataPointer;
+
+    testCallbackData->body.append((const char *) FFS_STREAM_NEXT_READ(*bodyStream),
+            FFS_STREAM_DATA_SIZE(*bodyStream));
+    testCallbackData->bodyCallbackCount++;
+
+    return FFS_SUCCESS;
+}
+
+class HttpImpairmentTests: public ::testing::Test {
+protected:
+    void SetUp()
+    {
+        ZERO_FILL(userContext);
+        ZERO_FILL(request);
+        ZERO_FILL(profile);
+        ZERO_FILL(testCallbackData.statusCode);
+        testCallbackData.bodyCallbackCount = 0;
+
+        request.operation = FFS_HTTP_OPERATION_POST;
+        request.url.scheme = FFS_HTTP_SCHEME_HTTP;
+        request.url.hostStream = FFS_STRING_INPUT_STREAM(TEST_HOST);
+        request.url.port = server.getPort();
+        request.url.path = TEST_PATH;
+        request.bodyStream = ffsCreateOutputStream(requestBody, sizeof(requestBody));
+        ffsWriteStringToStream(TEST_REQUEST_BODY, &request.bodyStream);
+        request.callbacks.handleStatusCode = handleStatusCode;
+        request.callbacks.handleBody = handleBody;
+
+        profile.name = "test";
+        profile.latencyDistribution = FFS_NETWORK_LATENCY_FIXED;
+
+        server.setResponse(TEST_RESPONSE);
+    }
+
+    /** @brief Apply the test profile to the user context.
+     */
+    void impair()
+    {
+        ASSERT_EQ(ffsInitializeNetworkImpairment(&impairment, &profile, TEST_SEED), FFS_SUCCESS);
+        userContext.networkImpairment = &impairment;
+    }
+
+    /** @brief Execute the request with a time limit.
+     */
+    FFS_RESULT execute(uint32_t timeoutMs)
+    {
+        FfsHttpOperation_t *operation;
+        FFS_RESULT result = ffsHttpExecuteAsync(&userContext, &request, &testCallbackData, timeoutMs, NULL,
+                &operation);
+        if (result != FFS_SUCCESS) {
+            return result;
+        }
+
+        return ffsHttpWait(&userContext, operation);
+    }
+
+    FakeHttpServer server;
+    struct FfsUserContext_s userContext;
+    FfsHttpRequest_t request;
+    uint8_t requestBody[REQUEST_BODY_SZ];
+    FfsNetworkImpairmentProfile_t profile;
+    FfsNetworkImpairment_t impairment;
+    TestCallbackData_t testCallbackData;
+};
+
+/** @brief Latency postpones the request.
+ */
+TEST_F(HttpImpairmentTests, Latency)
+{
+    profile.latencyBaseMs = TEST_LATENCY_MS;
+    impair();
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    ASSERT_EQ(execute(0), FFS_SUCCESS);
+
+    ASSERT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(TEST_LATENCY_MS));
+    ASSERT_EQ(testCallbackData.body, TEST_RESPONSE_BODY);
+}
+
+/** @brief Latency counts against the timeout.
+ */
+TEST_F(HttpImpairmentTests, LatencyTimeout)
+{
+    profile.latencyBaseMs = TEST_LONG_LATENCY_MS;
+    impair();
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    ASSERT_EQ(execute(TEST_TIMEOUT_MS), FFS_TIMEOUT);
+
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(TEST_LONG_LATENCY_MS));
+    ASSERT_EQ(server.getRequestCount(), 0U);
+}
+
+/** @brief Partial reads hand the body over in small chunks.
+ */
+TEST_F(HttpImpairmentTests, PartialReads)
+{
+    profile.maximumReadSize = TEST_READ_SIZE;
+    impair();
+
+    ASSERT_EQ(execute(0), FFS_SUCCESS);
+
+    ASSERT_EQ(testCallbackData.statusCode, 200);
+    ASSERT_EQ(testCallbackData.body, TEST_RESPONSE_BODY);
+    ASSERT_GE(testCallbackData.bodyCallbackCount,
+            (int) ((strlen(TEST_RESPONSE_BODY) + TEST_READ_SIZE - 1) / TEST_READ_SIZE));
+}
+
+/** @brief A DNS failure fails the request without reaching the server.
+ */
+TEST_F(HttpImpairmentTests, DnsFailure)
+{
+    profile.dnsFailurePerMille = 1000;
+    impair();
+
+    ASSERT_EQ(execute(0), FFS_ERROR);
+
+    ASSERT_EQ(server.getRequestCount(), 0U);
+    ASSERT_EQ(impairment.dnsFailureCount, 1U);
+}
+
+/** @brief A reset delivers at most part of the response and fails the request.
+ */
+TEST_F(HttpImpairmentTests, Reset)
+{
+    profile.resetPerMille = 1000;
+    impair();
+
+    ASSERT_EQ(execute(0), FFS_ERROR);
+
+    ASSERT_LE(testCallbackData.body.size(), strlen(TEST_RESPONSE_BODY));
+    ASSERT_EQ(impairment.resetCount, 1U);
+}
+
+/** @brief A stalled response ends with the timeout.
+ */
+TEST_F(HttpImpairmentTests, StallTimeout)
+{
+    profile.stallPerMille = 1000;
+    profile.stallMs = TEST_STALL_MS;
+    impair();
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    ASSERT_EQ(execute(TEST_TIMEOUT_MS), FFS_TIMEOUT);
+
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(TEST_STALL_MS));
+    ASSERT_TRUE(testCallbackData.body.empty());
+}
+
+/** @brief A delayed request can be cancelled before it starts.
+ */
+TEST_F(HttpImpairmentTests, CancelDelayed)
+{
+    profile.latencyBaseMs = TEST_LONG_LATENCY_MS;
+    impair();
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    FfsHttpOperation_t *operation;
+    ASSERT_EQ(ffsHttpExecuteAsync(&userContext, &request, &testCallbackData, 0, NULL, &operation), FFS_SUCCESS);
+    ASSERT_EQ(ffsHttpCancel(&userContext, operation), FFS_SUCCESS);
+    ASSERT_EQ(ffsHttpWait(&userContext, operation), FFS_ERROR);
+
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(TEST_LONG_LATENCY_MS));
+    ASSERT_EQ(server.getRequestCount(), 0U);
+}
@@ -0,0 +1,286 @@
+/** @file ffs_linux_http_trace_tests.cpp
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_base64.h"
+#include "ffs/common/ffs_http.h"
+#include "ffs/compat/ffs_common_compat.h"
+#include "ffs/compat/ffs_linux_user_context.h"
+#include "ffs/linux/ffs_linux_http_trace.h"
+#include "fake_http_server.h"
+
+#include <gtest/gtest.h>
+#include <openssl/ec.h>
+#include <chrono>
+#include <map>
+#include <string>
+#include <unistd.h>
+
+#define ZERO_FILL(variable) memset(&variable, 0, sizeof(variable))
+
+#define TEST_HOST               ("127.0.0.1")
+#define TEST_PATH               ("test")
+#define TEST_REQUEST_BODY       ("{\"nonce\":\"AAAA\",\"value\":1}")
+#define TEST_REPLAY_BODY        ("{ \"nonce\" : \"BBBB\", \"value\" : 1 }")
+#define TEST_CHANGED_BODY       ("{\"nonce\":\"AAAA\",\"value\":2}")
+#define TEST_RESPONSE_BODY      ("{\"nonce\":\"AAAA\"}")
+#define TEST_REPLAYED_BODY      ("{\"nonce\":\"BBBB\"}")
+#define TEST_RESPONSE           ("HTTP/1.1 200 OK\r\nContent-Length: 16\r\nx-amzn-dss-signature: c2ln\r\n" \
+                                 "Connection: close\r\n\r\n{\"nonce\":\"AAAA\"}")
+#define TEST_SIGNATURE          ("c2ln")
+#define TEST_DELAY_MS           (300)
+#define TEST_FAST_REPLAY_MS     (100)
+#define REQUEST_BODY_SZ         (64)
+
+/** @brief Test callback data.
+ */
+typedef struct {
+    int32_t statusCode;
+    std::string body;
+    std::map<std::string, std::string> headers;
+} TestCallbackData_t;
+
+/** @brief Save the status code.
+ */
+static FFS_RESULT handleStatusCode(int32_t statusCode, void *callbackDataPointer)
+{
+    TestCallbackData_t *testCallbackData = (TestCallbackData_t *) callbackDataPointer;
+
+    testCallbackData->statusCode = statusCode;
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Save a response header.
+ */
+static FFS_RESULT handleHeader(FfsStream_t *nameStream, FfsStream_t *valueStream, void *callbackDataPointer)
+{
+    TestCallbackData_t *testCallbackData = (TestCallbackData_t *) callbackDataPointer;
+
+    std::string name((const char *) FFS_STREAM_NEXT_READ(*nameStream), FFS_STREAM_DATA_SIZE(*nameStream));
+    testCallbackData->headers[name] = std::string((const char *) FFS_STREAM_NEXT_READ(*valueStream),
+            FFS_STREAM_DATA_SIZE(*valueStream));
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Save the response body.
+ */
+static FFS_RESULT handleBody(FfsStream_t *bodyStream, void *callbackDataPointer)
+{
+    TestCallbackData_t *testCallbackData = (TestCallbackData_t *) callbackDataPointer;
+
+    testCallbackData->body.append((const char *) FFS_STREAM_NEXT_READ(*bodyStream),
+            FFS_STREAM_DATA_SIZE(*bodyStream));
+
+    return FFS_SUCCESS;
+}
+
+class HttpTraceTests: public ::testing::Test {
+protected:
+    void SetUp()
+    {
+        ZERO_FILL(userContext);
+        ZERO_FILL(request);
+        ZERO_FILL(recorder);
+        ZERO_FILL(replay);
+
+        tracePath = "/tmp/ffs_http_trace_" + std::to_string(getpid());
+
+        request.operation = FFS_HTTP_OPERATION_POST;
+        request.url.scheme = FFS_HTTP_SCHEME_HTTP;
+        request.url.hostStream = FFS_STRING_INPUT_STREAM(TEST_HOST);
+        request.url.port = server.getPort();
+        request.url.path = TEST_PATH;
+        request.callbacks.handleStatusCode = handleStatusCode;
+        request.callbacks.handleHeader = handleHeader;
+        request.callbacks.handleBody = handleBody;
+        setRequestBody(TEST_REQUEST_BODY);
+
+        server.setResponse(TEST_RESPONSE);
+    }
+
+    void TearDown()
+    {
+        ffsFreeHttpTrace(&replay);
+        unlink(tracePath.c_str());
+    }
+
+    void setRequestBody(const char *body)
+    {
+        request.bodyStream = ffsCreateOutputStream(requestBody, sizeof(requestBody));
+        ffsWriteStringToStream(body, &request.bodyStream);
+    }
+
+    /** @brief Execute the request against the server and record it.
+     */
+    void record()
+    {
+        ASSERT_EQ(ffsOpenHttpTraceRecorder(&recorder, tracePath.c_str()), FFS_SUCCESS);
+        userContext.httpTraceRecorder = &recorder;
+
+        TestCallbackData_t testCallbackData = {};
+        ASSERT_EQ(ffsHttpExecute(&userContext, &request, &testCallbackData), FFS_SUCCESS);
+        ASSERT_EQ(testCallbackData.body, TEST_RESPONSE_BODY);
+
+        userContext.httpTraceRecorder = NULL;
+        ASSERT_EQ(ffsCloseHttpTraceRecorder(&recorder), FFS_SUCCESS);
+        ASSERT_EQ(recorder.exchangeCount, 1U);
+    }
+
+    /** @brief Load the recording and serve it instead of the server.
+     */
+    void startReplay(uint32_t timeWarpPercent, EVP_PKEY *signingKey)
+    {
+        ASSERT_EQ(ffsLoadHttpTrace(&replay, tracePath.c_str(), timeWarpPercent, signingKey), FFS_SUCCESS);
+        ASSERT_EQ(replay.exchangeCount, 1U);
+        userContext.httpTraceReplay = &replay;
+    }
+
+    /** @brief Generate a P-256 test key.
+     */
+    static EVP_PKEY *generateKey()
+    {
+        EVP_PKEY *key = NULL;
+        EVP_PKEY_CTX *keyContext = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, NULL);
+
+        if (keyContext && EVP_PKEY_keygen_init(keyContext) == 1
+                && EVP_PKEY_CTX_set_ec_paramgen_curve_nid(keyContext, NID_X9_62_prime256v1) == 1) {
+            EVP_PKEY_keygen(keyContext, &key);
+        }
+        EVP_PKEY_CTX_free(keyContext);
+
+        return key;
+    }
+
+    FakeHttpServer server;
+    struct FfsUserContext_s userContext;
+    FfsHttpRequest_t request;
+    uint8_t requestBody[REQUEST_BODY_SZ];
+    FfsHttpTraceRecorder_t recorder;
+    FfsHttpTraceReplay_t replay;
+    std::string tracePath;
+};
+
+/** @brief A recorded exchange is served again without reaching the server.
+ */
+TEST_F(HttpTraceTests, RecordAndReplay)
+{
+    record();
+    startReplay(0, NULL);
+
+    TestCallbackData_t testCallbackData = {};
+    ASSERT_EQ(ffsHttpExecute(&userContext, &request, &testCallbackData), FFS_SUCCESS);
+
+    ASSERT_EQ(server.getRequestCount(), 1U);
+    ASSERT_EQ(testCallbackData.statusCode, 200);
+    ASSERT_EQ(testCallbackData.body, TEST_RESPONSE_BODY);
+    ASSERT_EQ(testCallbackData.headers["x-amzn-dss-signature"], TEST_SIGNATURE);
+    ASSERT_EQ(replay.nextExchange, 1U);
+    ASSERT_EQ(replay.mismatchCount, 0U);
+}
+
+/** @brief A changed request is counted, and failed in strict mode.
+ */
+TEST_F(HttpTraceTests, Mismatch)
+{
+    record();
+    startReplay(0, NULL);
+    setRequestBody(TEST_CHANGED_BODY);
+
+    TestCallbackData_t testCallbackData = {};
+    ASSERT_EQ(ffsHttpExecute(&userContext, &request, &testCallbackData), FFS_SUCCESS);
+    ASSERT_EQ(replay.mismatchCount, 1U);
+
+    replay.nextExchange = 0;
+    replay.isStrict = true;
+    ASSERT_EQ(ffsHttpExecute(&userContext, &request, &testCallbackData), FFS_ERROR);
+    ASSERT_EQ(replay.mismatchCount, 2U);
+}
+
+/** @brief A new nonce is carried into the response, which is re-signed.
+ */
+TEST_F(HttpTraceTests, VolatileValuesResigned)
+{
+    record();
+
+    EVP_PKEY *signingKey = generateKey();
+    ASSERT_TRUE(signingKey);
+    startReplay(0, signingKey);
+    setRequestBody(TEST_REPLAY_BODY);
+
+    TestCallbackData_t testCallbackData = {};
+    ASSERT_EQ(ffsHttpExecute(&userContext, &request, &testCallbackData), FFS_SUCCESS);
+    ASSERT_EQ(replay.mismatchCount, 0U);
+    ASSERT_EQ(testCallbackData.body, TEST_REPLAYED_BODY);
+
+    // The client verifies the patched body against the test key.
+    std::string signature = testCallbackData.headers["x-amzn-dss-signature"];
+    ASSERT_NE(signature, TEST_SIGNATURE);
+    FfsStream_t base64Stream = ffsCreateInputStream((uint8_t *) &signature[0], signature.size());
+    FFS_TEMPORARY_OUTPUT_STREAM(signatureStream, 128);
+    ASSERT_EQ(ffsDecodeBase64(&base64Stream, &signatureStream), FFS_SUCCESS);
+
+    userContext.cloudPublicKey = signingKey;
+    FfsStream_t bodyStream = FFS_STRING_INPUT_STREAM(testCallbackData.body.c_str());
+    bool isVerified = false;
+    ASSERT_EQ(ffsVerifyCloudSignature(&userContext, &bodyStream, &signatureStream, &isVerified), FFS_SUCCESS);
+    ASSERT_TRUE(isVerified);
+
+    ffsInvalidateLinuxCryptoCache(&userContext.cryptoCache);
+    EVP_PKEY_free(signingKey);
+}
+
+/** @brief Recorded durations are replayed at the time warp.
+ */
+TEST_F(HttpTraceTests, TimeWarp)
+{
+    server.setResponse(TEST_RESPONSE, TEST_DELAY_MS);
+    record();
+    startReplay(100, NULL);
+
+    TestCallbackData_t testCallbackData = {};
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    ASSERT_EQ(ffsHttpExecute(&userContext, &request, &testCallbackData), FFS_SUCCESS);
+    ASSERT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(TEST_DELAY_MS));
+
+    replay.nextExchange = 0;
+    replay.timeWarpPercent = 0;
+    start = std::chrono::steady_clock::now();
+    ASSERT_EQ(ffsHttpExecute(&userContext, &request, &testCallbackData), FFS_SUCCESS);
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(TEST_FAST_REPLAY_MS));
+}
+
+/** @brief Requests past the end of the trace fail.
+ */
+TEST_F(HttpTraceTests, Exhausted)
+{
+    record();
+    startReplay(0, NULL);
+
+    TestCallbackData_t testCallbackData = {};
+    ASSERT_EQ(ffsHttpExecute(&userContext, &request, &testCallbackData), FFS_SUCCESS);
+    ASSERT_EQ(ffsHttpExecute(&userContext, &request, &testCallbackData), FFS_ERROR);
+}
+
+/** @brief A file that is not a trace is rejected.
+ */
+TEST_F(HttpTraceTests, InvalidTrace)
+{
+    FILE *file = fopen(tracePath.c_str(), "wb");
+    ASSERT_TRUE(file);
+    fputs("NOT A TRACE", file);
+    fclose(file);
+
+    ASSERT_EQ(ffsLoadHttpTrace(&replay, tracePath.c_str(), 0, NULL), FFS_ERROR);
+}
@@ -0,0 +1,66 @@
+/** @file ffs_linux_http_trace_body_tests.cpp
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/linux/ffs_linux_http_trace.h"
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+/** @brief Compare two bodies with the default volatile keys.
+ */
+static bool bodiesMatch(const char *recordedBody, const char *body)
+{
+    return ffsHttpTraceBodiesMatch((const uint8_t *) recordedBody, strlen(recordedBody), (const uint8_t *) body,
+            strlen(body), FFS_HTTP_TRACE_DEFAULT_VOLATILE_KEYS);
+}
+
+/** @brief Whitespace outside strings does not matter.
+ */
+TEST(HttpTraceBodyTests, Whitespace)
+{
+    ASSERT_TRUE(bodiesMatch("{\"a\":1,\"b\":[1,2]}", " {\n  \"a\" : 1,\n  \"b\" : [ 1, 2 ]\n}\n"));
+    ASSERT_FALSE(bodiesMatch("{\"a\":\"x y\"}", "{\"a\":\"xy\"}"));
+}
+
+/** @brief Values of volatile keys are ignored, wherever they are.
+ */
+TEST(HttpTraceBodyTests, VolatileKeys)
+{
+    ASSERT_TRUE(bodiesMatch("{\"nonce\":\"AAAA\",\"sessionId\":\"1\"}", "{\"nonce\":\"BBBB\",\"sessionId\":\"1\"}"));
+    ASSERT_TRUE(bodiesMatch("{\"list\":[{\"ssid\":\"a\",\"rssi\":-40}]}", "{\"list\":[{\"ssid\":\"a\",\"rssi\":-71}]}"));
+    ASSERT_FALSE(bodiesMatch("{\"nonce\":\"AAAA\",\"sessionId\":\"1\"}", "{\"nonce\":\"AAAA\",\"sessionId\":\"2\"}"));
+}
+
+/** @brief Only keys are volatile, not string values that look like them.
+ */
+TEST(HttpTraceBodyTests, VolatileValueIsNotKey)
+{
+    ASSERT_FALSE(bodiesMatch("{\"a\":\"nonce\",\"b\":1}", "{\"a\":\"nonce\",\"b\":2}"));
+}
+
+/** @brief Escaped quotes do not end a string.
+ */
+TEST(HttpTraceBodyTests, EscapedQuotes)
+{
+    ASSERT_TRUE(bodiesMatch("{\"a\":\"x\\\" y\"}", "{ \"a\" : \"x\\\" y\" }"));
+    ASSERT_FALSE(bodiesMatch("{\"a\":\"x\\\" y\"}", "{\"a\":\"x\\\"y\"}"));
+}
+
+/** @brief Non-JSON bodies are compared byte for byte, minus whitespace.
+ */
+TEST(HttpTraceBodyTests, Empty)
+{
+    ASSERT_TRUE(bodiesMatch("", ""));
+    ASSERT_FALSE(bodiesMatch("", "x"));
+}
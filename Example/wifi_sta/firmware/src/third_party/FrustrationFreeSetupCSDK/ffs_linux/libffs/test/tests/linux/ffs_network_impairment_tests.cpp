@@ -0,0 +1,156 @@
+/** @file ffs_network_impairment_tests.cpp
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/linux/ffs_network_impairment.h"
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#define ZERO_FILL(variable) memset(&variable, 0, sizeof(variable))
+
+#define TEST_SEED               (42)
+#define TEST_DRAW_COUNT         (10000)
+
+/** @brief Every built-in profile can be found and initialized.
+ */
+TEST(NetworkImpairmentTests, FindProfiles)
+{
+    for (const FfsNetworkImpairmentProfile_t *builtIn = FFS_NETWORK_IMPAIRMENT_PROFILES; builtIn->name;
+            builtIn++) {
+        const FfsNetworkImpairmentProfile_t *profile = NULL;
+        ASSERT_EQ(ffsFindNetworkImpairmentProfile(builtIn->name, &profile), FFS_SUCCESS);
+        ASSERT_EQ(profile, builtIn);
+
+        FfsNetworkImpairment_t impairment;
+        ASSERT_EQ(ffsInitializeNetworkImpairment(&impairment, profile, TEST_SEED), FFS_SUCCESS);
+    }
+
+    const FfsNetworkImpairmentProfile_t *profile;
+    ASSERT_EQ(ffsFindNetworkImpairmentProfile("crowded-2.4ghz", &profile), FFS_SUCCESS);
+    ASSERT_EQ(ffsFindNetworkImpairmentProfile("captive-setup-ap", &profile), FFS_SUCCESS);
+    ASSERT_EQ(ffsFindNetworkImpairmentProfile("unknown", &profile), FFS_ERROR);
+    ASSERT_EQ(ffsFindNetworkImpairmentProfile(NULL, &profile), FFS_ERROR);
+}
+
+/** @brief Fault probabilities adding up to more than one are rejected.
+ */
+TEST(NetworkImpairmentTests, InvalidProfile)
+{
+    FfsNetworkImpairmentProfile_t profile;
+    ZERO_FILL(profile);
+    profile.dnsFailurePerMille = 600;
+    profile.resetPerMille = 600;
+
+    FfsNetworkImpairment_t impairment;
+    ASSERT_EQ(ffsInitializeNetworkImpairment(&impairment, &profile, TEST_SEED), FFS_ERROR);
+    ASSERT_EQ(ffsInitializeNetworkImpairment(&impairment, NULL, TEST_SEED), FFS_ERROR);
+}
+
+/** @brief The same seed gives the same plans.
+ */
+TEST(NetworkImpairmentTests, Reproducible)
+{
+    const FfsNetworkImpairmentProfile_t *profile;
+    ASSERT_EQ(ffsFindNetworkImpairmentProfile("weak-signal", &profile), FFS_SUCCESS);
+
+    FfsNetworkImpairment_t first;
+    FfsNetworkImpairment_t second;
+    ASSERT_EQ(ffsInitializeNetworkImpairment(&first, profile, TEST_SEED), FFS_SUCCESS);
+    ASSERT_EQ(ffsInitializeNetworkImpairment(&second, profile, TEST_SEED), FFS_SUCCESS);
+
+    for (int i = 0; i < 100; i++) {
+        FfsNetworkImpairmentPlan_t firstPlan;
+        FfsNetworkImpairmentPlan_t secondPlan;
+        ASSERT_EQ(ffsPlanNetworkImpairment(&first, &firstPlan), FFS_SUCCESS);
+        ASSERT_EQ(ffsPlanNetworkImpairment(&second, &secondPlan), FFS_SUCCESS);
+        ASSERT_EQ(memcmp(&firstPlan, &secondPlan, sizeof(firstPlan)), 0);
+    }
+}
+
+/** @brief The ideal profile never impairs a request.
+ */
+TEST(NetworkImpairmentTests, Ideal)
+{
+    const FfsNetworkImpairmentProfile_t *profile;
+    ASSERT_EQ(ffsFindNetworkImpairmentProfile("ideal", &profile), FFS_SUCCESS);
+
+    FfsNetworkImpairment_t impairment;
+    ASSERT_EQ(ffsInitializeNetworkImpairment(&impairment, profile, TEST_SEED), FFS_SUCCESS);
+
+    for (int i = 0; i < 100; i++) {
+        FfsNetworkImpairmentPlan_t plan;
+        ASSERT_EQ(ffsPlanNetworkImpairment(&impairment, &plan), FFS_SUCCESS);
+        ASSERT_EQ(plan.delayMs, 0U);
+        ASSERT_EQ(plan.fault, FFS_NETWORK_FAULT_NONE);
+        ASSERT_EQ(plan.bandwidthBytesPerSecond, 0U);
+        ASSERT_EQ(plan.maximumReadSize, 0U);
+    }
+}
+
+/** @brief Uniform latencies stay in range and faults occur at about their rates.
+ */
+TEST(NetworkImpairmentTests, Distribution)
+{
+    const FfsNetworkImpairmentProfile_t *profile;
+    ASSERT_EQ(ffsFindNetworkImpairmentProfile("captive-setup-ap", &profile), FFS_SUCCESS);
+
+    FfsNetworkImpairment_t impairment;
+    ASSERT_EQ(ffsInitializeNetworkImpairment(&impairment, profile, TEST_SEED), FFS_SUCCESS);
+
+    for (int i = 0; i < TEST_DRAW_COUNT; i++) {
+        FfsNetworkImpairmentPlan_t plan;
+        ASSERT_EQ(ffsPlanNetworkImpairment(&impairment, &plan), FFS_SUCCESS);
+        ASSERT_GE(plan.delayMs, profile->latencyBaseMs);
+        ASSERT_LE(plan.delayMs, profile->latencyBaseMs + profile->latencySpreadMs);
+        if (plan.fault == FFS_NETWORK_FAULT_RESET) {
+            ASSERT_LE(plan.resetOffset, (uint32_t) FFS_NETWORK_IMPAIRMENT_MAXIMUM_RESET_OFFSET);
+        } else if (plan.fault == FFS_NETWORK_FAULT_STALL) {
+            ASSERT_EQ(plan.stallMs, profile->stallMs);
+        }
+    }
+
+    // Within 20% of the expected counts.
+    ASSERT_EQ(impairment.requestCount, (uint32_t) TEST_DRAW_COUNT);
+    ASSERT_NEAR(impairment.dnsFailureCount, profile->dnsFailurePerMille * TEST_DRAW_COUNT / 1000,
+            profile->dnsFailurePerMille * TEST_DRAW_COUNT / 5000);
+    ASSERT_NEAR(impairment.resetCount, profile->resetPerMille * TEST_DRAW_COUNT / 1000,
+            profile->resetPerMille * TEST_DRAW_COUNT / 5000);
+    ASSERT_NEAR(impairment.stallCount, profile->stallPerMille * TEST_DRAW_COUNT / 1000,
+            profile->stallPerMille * TEST_DRAW_COUNT / 5000);
+}
+
+/** @brief Exponential latencies have about the configured mean and a bounded tail.
+ */
+TEST(NetworkImpairmentTests, ExponentialLatency)
+{
+    FfsNetworkImpairmentProfile_t profile;
+    ZERO_FILL(profile);
+    profile.latencyDistribution = FFS_NETWORK_LATENCY_EXPONENTIAL;
+    profile.latencyBaseMs = 50;
+    profile.latencySpreadMs = 100;
+
+    FfsNetworkImpairment_t impairment;
+    ASSERT_EQ(ffsInitializeNetworkImpairment(&impairment, &profile, TEST_SEED), FFS_SUCCESS);
+
+    uint64_t totalMs = 0;
+    for (int i = 0; i < TEST_DRAW_COUNT; i++) {
+        FfsNetworkImpairmentPlan_t plan;
+        ASSERT_EQ(ffsPlanNetworkImpairment(&impairment, &plan), FFS_SUCCESS);
+        ASSERT_GE(plan.delayMs, profile.latencyBaseMs);
+        ASSERT_LE(plan.delayMs, profile.latencyBaseMs + 10 * profile.latencySpreadMs);
+        totalMs += plan.delayMs;
+    }
+
+    ASSERT_NEAR((double) totalMs / TEST_DRAW_COUNT, profile.latencyBaseMs + profile.latencySpreadMs, 10.0);
+}
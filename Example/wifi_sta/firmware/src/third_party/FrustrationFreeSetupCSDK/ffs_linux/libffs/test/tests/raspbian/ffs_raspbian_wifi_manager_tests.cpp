@@ -35,6 +35,7 @@ TEST(WifiManagerTests, InitAndDeinit)
     ASSERT_EQ(ffsInitializeWifiContext(&userContext.wifiContext), FFS_SUCCESS);
 
     userContext.wifiContext.wifiManagerInitialized = false;
+    wifiManagerDeinitialized = false;
 
     ASSERT_EQ(ffsRaspbianInitializeWifiManager(&userContext), FFS_SUCCESS);
     ASSERT_EQ(ffsRaspbianDeinitializeWifiManager(&userContext, ffsTestDeinitializeCallback), FFS_SUCCESS);
@@ -54,10 +55,20 @@ TEST(WifiManagerTests, MultipleInit)
     ASSERT_EQ(ffsInitializeWifiContext(&userContext.wifiContext), FFS_SUCCESS);
 
     userContext.wifiContext.wifiManagerInitialized = false;
+    wifiManagerDeinitialized = false;
 
     ASSERT_EQ(ffsRaspbianInitializeWifiManager(&userContext), FFS_SUCCESS);
     ASSERT_EQ(ffsRaspbianInitializeWifiManager(&userContext), FFS_SUCCESS);
     ASSERT_EQ(ffsRaspbianInitializeWifiManager(&userContext), FFS_SUCCESS);
+
+    // Stop the task before the context goes out of scope.
+    ASSERT_EQ(ffsRaspbianDeinitializeWifiManager(&userContext, ffsTestDeinitializeCallback), FFS_SUCCESS);
+
+    for (uint32_t timer = 0; timer < SECONDS_TO_MICROSECONDS(2) && !wifiManagerDeinitialized; timer += SECONDS_TO_MICROSECONDS(0.2)) {
+        usleep(SECONDS_TO_MICROSECONDS(0.2));
+    }
+
+    ASSERT_EQ(wifiManagerDeinitialized, true);
 }
 
 TEST(WifiManagerTests, MultipleDeinit)
@@ -68,6 +79,7 @@ TEST(WifiManagerTests, MultipleDeinit)
     ASSERT_EQ(ffsInitializeWifiContext(&userContext.wifiContext), FFS_SUCCESS);
 
     userContext.wifiContext.wifiManagerInitialized = false;
+    wifiManagerDeinitialized = false;
 
     ASSERT_EQ(ffsRaspbianInitializeWifiManager(&userContext), FFS_SUCCESS);
     ASSERT_EQ(ffsRaspbianDeinitializeWifiManager(&userContext, ffsTestDeinitializeCallback), FFS_SUCCESS);
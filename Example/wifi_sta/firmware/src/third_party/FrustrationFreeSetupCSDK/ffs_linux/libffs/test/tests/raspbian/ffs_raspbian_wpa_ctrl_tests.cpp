@@ -0,0 +1,382 @@
+/** @file ffs_raspbian_wpa_ctrl_tests.cpp
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/linux/ffs_linux_error_details.h"
+#include "ffs/linux/ffs_wifi_context.h"
+#include "ffs/linux/ffs_wifi_scan_list.h"
+#include "ffs/raspbian/ffs_raspbian_wpa_ctrl.h"
+#include "fake_wpa_supplicant.h"
+
+#include <gmock/gmock.h>
+#include <algorithm>
+
+#define ZERO_FILL(variable) memset(&variable, 0, sizeof(variable))
+
+#define TEST_CONNECT_TIMEOUT_MILLI (500)
+
+static const char *scanResults =
+        "bssid / frequency / signal level / flags / ssid\n"
+        "11:22:33:44:55:66\t2412\t-56\t[ESS]\tTEST OPEN\n"
+        "77:88:99:00:aa:bb\t5180\t-40\t[WPA2-PSK-CCMP][ESS]\tTEST \\\"WPA2\\\"\n"
+        "aa:bb:cc:dd:ee:ff\t2437\t-70\t[WEP][ESS]\tTEST WEP\n"
+        "12:34:56:78:9a:bc\t2462\t-80\t[WPA2-EAP-CCMP][ESS]\tTEST EAP\n"
+        "de:ad:be:ef:00:01\t2412\t-60\t[WPA2-PSK-CCMP][ESS]\t\n";
+
+static bool hasCommand(FakeWpaSupplicant &supplicant, const std::string &command)
+{
+    std::vector<std::string> commands = supplicant.getCommands();
+    return std::find(commands.begin(), commands.end(), command) != commands.end();
+}
+
+static FfsWifiConfiguration_t createConfiguration(const char *ssid, const char *key,
+        FFS_WIFI_SECURITY_PROTOCOL securityProtocol)
+{
+    FfsWifiConfiguration_t configuration;
+    ZERO_FILL(configuration);
+
+    configuration.ssidStream = ffsCreateInputStream((uint8_t *) ssid, strlen(ssid));
+    configuration.keyStream = ffsCreateInputStream((uint8_t *) key, strlen(key));
+    configuration.securityProtocol = securityProtocol;
+
+    return configuration;
+}
+
+TEST(WpaCtrlTests, ProcessScanResults)
+{
+    FfsLinuxWifiContext_t wifiContext;
+    FfsWifiScanResult_t *scanResult;
+    size_t scanListSize;
+    char reply[1024];
+
+    ASSERT_EQ(ffsInitializeWifiContext(&wifiContext), FFS_SUCCESS);
+
+    snprintf(reply, sizeof(reply), "%s", scanResults);
+    ASSERT_EQ(ffsRaspbianWpaCtrlProcessScanResults(&wifiContext, reply), FFS_SUCCESS);
+
+    // The hidden network is dropped.
+    ASSERT_EQ(ffsWifiScanListGetSize(&wifiContext, &scanListSize), FFS_SUCCESS);
+    ASSERT_EQ(scanListSize, 4);
+
+    ASSERT_EQ(ffsWifiScanListPeekIndex(&wifiContext, 0, &scanResult), FFS_SUCCESS);
+    ASSERT_TRUE(ffsStreamMatchesString(&scanResult->ssidStream, "TEST OPEN"));
+    ASSERT_EQ(scanResult->securityProtocol, FFS_WIFI_SECURITY_PROTOCOL_NONE);
+    ASSERT_EQ(scanResult->frequencyBand, 2412);
+    ASSERT_EQ(scanResult->signalStrength, -56);
+    ASSERT_EQ(FFS_STREAM_DATA_SIZE(scanResult->bssidStream), FFS_BSSID_SIZE);
+    ASSERT_EQ(FFS_STREAM_NEXT_READ(scanResult->bssidStream)[5], 0x66);
+
+    ASSERT_EQ(ffsWifiScanListPeekIndex(&wifiContext, 1, &scanResult), FFS_SUCCESS);
+    ASSERT_TRUE(ffsStreamMatchesString(&scanResult->ssidStream, "TEST \"WPA2\""));
+    ASSERT_EQ(scanResult->securityProtocol, FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK);
+    ASSERT_EQ(scanResult->frequencyBand, 5180);
+
+    ASSERT_EQ(ffsWifiScanListPeekIndex(&wifiContext, 2, &scanResult), FFS_SUCCESS);
+    ASSERT_EQ(scanResult->securityProtocol, FFS_WIFI_SECURITY_PROTOCOL_WEP);
+
+    ASSERT_EQ(ffsWifiScanListPeekIndex(&wifiContext, 3, &scanResult), FFS_SUCCESS);
+    ASSERT_EQ(scanResult->securityProtocol, FFS_WIFI_SECURITY_PROTOCOL_OTHER);
+
+    ASSERT_EQ(ffsDeinitializeWifiContext(&wifiContext), FFS_SUCCESS);
+}
+
+TEST(WpaCtrlTests, ProcessScanResultsInvalidHeader)
+{
+    FfsLinuxWifiContext_t wifiContext;
+    char reply[] = "FAIL\n";
+
+    ASSERT_EQ(ffsInitializeWifiContext(&wifiContext), FFS_SUCCESS);
+    ASSERT_EQ(ffsRaspbianWpaCtrlProcessScanResults(&wifiContext, reply), FFS_ERROR);
+    ASSERT_EQ(ffsDeinitializeWifiContext(&wifiContext), FFS_SUCCESS);
+}
+
+TEST(WpaCtrlTests, ProcessStatus)
+{
+    FFS_WIFI_CONNECTION_STATE state;
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlProcessStatus("bssid=11:22:33:44:55:66\nssid=TEST\nwpa_state=COMPLETED\n", &state),
+            FFS_SUCCESS);
+    ASSERT_EQ(state, FFS_WIFI_CONNECTION_STATE_ASSOCIATED);
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlProcessStatus("wpa_state=4WAY_HANDSHAKE\n", &state), FFS_SUCCESS);
+    ASSERT_EQ(state, FFS_WIFI_CONNECTION_STATE_AUTHENTICATED);
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlProcessStatus("wpa_state=SCANNING\naddress=00:00:00:00:00:00\n", &state),
+            FFS_SUCCESS);
+    ASSERT_EQ(state, FFS_WIFI_CONNECTION_STATE_DISCONNECTED);
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlProcessStatus("address=00:00:00:00:00:00\n", &state), FFS_ERROR);
+}
+
+TEST(WpaCtrlTests, OpenAttachesAndRequests)
+{
+    FakeWpaSupplicant supplicant;
+    FfsRaspbianWpaCtrl_t ctrl;
+    char reply[32];
+
+    supplicant.setReply("PING", "PONG\n");
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlOpen(&ctrl, supplicant.getPath()), FFS_SUCCESS);
+    ASSERT_TRUE(hasCommand(supplicant, "ATTACH"));
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlRequest(&ctrl, "PING", reply, sizeof(reply), 1000), FFS_SUCCESS);
+    ASSERT_STREQ(reply, "PONG\n");
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlClose(&ctrl), FFS_SUCCESS);
+    ASSERT_TRUE(hasCommand(supplicant, "DETACH"));
+}
+
+TEST(WpaCtrlTests, OpenMissingSocket)
+{
+    FfsRaspbianWpaCtrl_t ctrl;
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlOpen(&ctrl, "/tmp/ffs_no_such_supplicant"), FFS_ERROR);
+}
+
+TEST(WpaCtrlTests, RequestTimeout)
+{
+    FakeWpaSupplicant supplicant;
+    FfsRaspbianWpaCtrl_t ctrl;
+    char reply[32];
+
+    supplicant.setReply("STATUS", "");
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlOpen(&ctrl, supplicant.getPath()), FFS_SUCCESS);
+    ASSERT_EQ(ffsRaspbianWpaCtrlRequest(&ctrl, "STATUS", reply, sizeof(reply), 50), FFS_TIMEOUT);
+    ASSERT_EQ(ffsRaspbianWpaCtrlClose(&ctrl), FFS_SUCCESS);
+}
+
+TEST(WpaCtrlTests, ScanWaitsForResults)
+{
+    FakeWpaSupplicant supplicant;
+    FfsRaspbianWpaCtrl_t ctrl;
+    FfsLinuxWifiContext_t wifiContext;
+    size_t scanListSize;
+
+    supplicant.setEvents("SCAN", { "<3>CTRL-EVENT-SCAN-STARTED ", "<3>CTRL-EVENT-SCAN-RESULTS " });
+    supplicant.setReply("SCAN_RESULTS", scanResults);
+
+    ASSERT_EQ(ffsInitializeWifiContext(&wifiContext), FFS_SUCCESS);
+    ASSERT_EQ(ffsRaspbianWpaCtrlOpen(&ctrl, supplicant.getPath()), FFS_SUCCESS);
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlScan(&ctrl, &wifiContext, NULL), FFS_SUCCESS);
+    ASSERT_EQ(ffsWifiScanListGetSize(&wifiContext, &scanListSize), FFS_SUCCESS);
+    ASSERT_EQ(scanListSize, 4);
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlClose(&ctrl), FFS_SUCCESS);
+    ASSERT_EQ(ffsDeinitializeWifiContext(&wifiContext), FFS_SUCCESS);
+}
+
+TEST(WpaCtrlTests, DirectedScanSendsHexSsid)
+{
+    FakeWpaSupplicant supplicant;
+    FfsRaspbianWpaCtrl_t ctrl;
+    FfsLinuxWifiContext_t wifiContext;
+    FfsStream_t ssidStream = ffsCreateInputStream((uint8_t *) "AB", 2);
+
+    supplicant.setEvents("SCAN", { "<3>CTRL-EVENT-SCAN-RESULTS " });
+    supplicant.setReply("SCAN_RESULTS", scanResults);
+
+    ASSERT_EQ(ffsInitializeWifiContext(&wifiContext), FFS_SUCCESS);
+    ASSERT_EQ(ffsRaspbianWpaCtrlOpen(&ctrl, supplicant.getPath()), FFS_SUCCESS);
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlScan(&ctrl, &wifiContext, &ssidStream), FFS_SUCCESS);
+    ASSERT_TRUE(hasCommand(supplicant, "SCAN ssid 4142"));
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlClose(&ctrl), FFS_SUCCESS);
+    ASSERT_EQ(ffsDeinitializeWifiContext(&wifiContext), FFS_SUCCESS);
+}
+
+TEST(WpaCtrlTests, ScanFailed)
+{
+    FakeWpaSupplicant supplicant;
+    FfsRaspbianWpaCtrl_t ctrl;
+    FfsLinuxWifiContext_t wifiContext;
+
+    supplicant.setEvents("SCAN", { "<3>CTRL-EVENT-SCAN-FAILED ret=-16" });
+
+    ASSERT_EQ(ffsInitializeWifiContext(&wifiContext), FFS_SUCCESS);
+    ASSERT_EQ(ffsRaspbianWpaCtrlOpen(&ctrl, supplicant.getPath()), FFS_SUCCESS);
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlScan(&ctrl, &wifiContext, NULL), FFS_ERROR);
+    ASSERT_FALSE(hasCommand(supplicant, "SCAN_RESULTS"));
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlClose(&ctrl), FFS_SUCCESS);
+    ASSERT_EQ(ffsDeinitializeWifiContext(&wifiContext), FFS_SUCCESS);
+}
+
+TEST(WpaCtrlTests, ConnectWpa)
+{
+    FakeWpaSupplicant supplicant;
+    FfsRaspbianWpaCtrl_t ctrl;
+    FfsLinuxWifiContext_t wifiContext;
+    FfsWifiConfiguration_t configuration = createConfiguration("AB", "password", FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK);
+
+    supplicant.setEvents("SELECT_NETWORK", { "<3>CTRL-EVENT-CONNECTED - Connection to 11:22:33:44:55:66 completed" });
+
+    ASSERT_EQ(ffsInitializeWifiContext(&wifiContext), FFS_SUCCESS);
+    ASSERT_EQ(ffsUpdateWifiConnectionDetails(&wifiContext, &configuration), FFS_SUCCESS);
+    ASSERT_EQ(ffsRaspbianWpaCtrlOpen(&ctrl, supplicant.getPath()), FFS_SUCCESS);
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlConnect(&ctrl, &wifiContext, &configuration, TEST_CONNECT_TIMEOUT_MILLI), FFS_SUCCESS);
+    ASSERT_NE(wifiContext.connectionDetails.state, FFS_WIFI_CONNECTION_STATE_FAILED);
+
+    ASSERT_FALSE(hasCommand(supplicant, "REMOVE_NETWORK all"));
+    ASSERT_FALSE(hasCommand(supplicant, "REMOVE_NETWORK 0"));
+    ASSERT_TRUE(hasCommand(supplicant, "SET_NETWORK 0 ssid 4142"));
+    ASSERT_TRUE(hasCommand(supplicant, "SET_NETWORK 0 key_mgmt WPA-PSK"));
+    ASSERT_TRUE(hasCommand(supplicant, "SET_NETWORK 0 psk \"password\""));
+    ASSERT_TRUE(hasCommand(supplicant, "SELECT_NETWORK 0"));
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlClose(&ctrl), FFS_SUCCESS);
+    ASSERT_EQ(ffsDeinitializeWifiContext(&wifiContext), FFS_SUCCESS);
+}
+
+TEST(WpaCtrlTests, ReconnectRemovesOnlyOwnNetwork)
+{
+    FakeWpaSupplicant supplicant;
+    FfsRaspbianWpaCtrl_t ctrl;
+    FfsLinuxWifiContext_t wifiContext;
+    FfsWifiConfiguration_t configuration = createConfiguration("AB", "password", FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK);
+
+    supplicant.setReply("ADD_NETWORK", "3\n");
+    supplicant.setEvents("SELECT_NETWORK", { "<3>CTRL-EVENT-CONNECTED - Connection to 11:22:33:44:55:66 completed" });
+
+    ASSERT_EQ(ffsInitializeWifiContext(&wifiContext), FFS_SUCCESS);
+    ASSERT_EQ(ffsUpdateWifiConnectionDetails(&wifiContext, &configuration), FFS_SUCCESS);
+    ASSERT_EQ(ffsRaspbianWpaCtrlOpen(&ctrl, supplicant.getPath()), FFS_SUCCESS);
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlConnect(&ctrl, &wifiContext, &configuration, TEST_CONNECT_TIMEOUT_MILLI), FFS_SUCCESS);
+    ASSERT_FALSE(hasCommand(supplicant, "REMOVE_NETWORK 3"));
+
+    // The second attempt replaces the network added by the first.
+    ASSERT_EQ(ffsRaspbianWpaCtrlConnect(&ctrl, &wifiContext, &configuration, TEST_CONNECT_TIMEOUT_MILLI), FFS_SUCCESS);
+    ASSERT_TRUE(hasCommand(supplicant, "REMOVE_NETWORK 3"));
+    ASSERT_FALSE(hasCommand(supplicant, "REMOVE_NETWORK all"));
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlClose(&ctrl), FFS_SUCCESS);
+    ASSERT_EQ(ffsDeinitializeWifiContext(&wifiContext), FFS_SUCCESS);
+}
+
+TEST(WpaCtrlTests, ConnectWepHexKey)
+{
+    FakeWpaSupplicant supplicant;
+    FfsRaspbianWpaCtrl_t ctrl;
+    FfsLinuxWifiContext_t wifiContext;
+    FfsWifiConfiguration_t configuration = createConfiguration("AB", "0123456789", FFS_WIFI_SECURITY_PROTOCOL_WEP);
+
+    supplicant.setEvents("SELECT_NETWORK", { "<3>CTRL-EVENT-CONNECTED - Connection to 11:22:33:44:55:66 completed" });
+
+    ASSERT_EQ(ffsInitializeWifiContext(&wifiContext), FFS_SUCCESS);
+    ASSERT_EQ(ffsUpdateWifiConnectionDetails(&wifiContext, &configuration), FFS_SUCCESS);
+    ASSERT_EQ(ffsRaspbianWpaCtrlOpen(&ctrl, supplicant.getPath()), FFS_SUCCESS);
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlConnect(&ctrl, &wifiContext, &configuration, TEST_CONNECT_TIMEOUT_MILLI), FFS_SUCCESS);
+    ASSERT_TRUE(hasCommand(supplicant, "SET_NETWORK 0 key_mgmt NONE"));
+    ASSERT_TRUE(hasCommand(supplicant, "SET_NETWORK 0 wep_key0 0123456789"));
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlClose(&ctrl), FFS_SUCCESS);
+    ASSERT_EQ(ffsDeinitializeWifiContext(&wifiContext), FFS_SUCCESS);
+}
+
+TEST(WpaCtrlTests, ConnectWrongKey)
+{
+    FakeWpaSupplicant supplicant;
+    FfsRaspbianWpaCtrl_t ctrl;
+    FfsLinuxWifiContext_t wifiContext;
+    FfsWifiConfiguration_t configuration = createConfiguration("AB", "password", FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK);
+
+    supplicant.setEvents("SELECT_NETWORK", {
+        "<3>CTRL-EVENT-SSID-TEMP-DISABLED id=0 ssid=\"AB\" auth_failures=1 duration=10 reason=WRONG_KEY"
+    });
+
+    ASSERT_EQ(ffsInitializeWifiContext(&wifiContext), FFS_SUCCESS);
+    ASSERT_EQ(ffsUpdateWifiConnectionDetails(&wifiContext, &configuration), FFS_SUCCESS);
+    ASSERT_EQ(ffsRaspbianWpaCtrlOpen(&ctrl, supplicant.getPath()), FFS_SUCCESS);
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlConnect(&ctrl, &wifiContext, &configuration, TEST_CONNECT_TIMEOUT_MILLI), FFS_SUCCESS);
+    ASSERT_EQ(wifiContext.connectionDetails.state, FFS_WIFI_CONNECTION_STATE_FAILED);
+    ASSERT_STREQ(wifiContext.connectionDetails.errorDetails.cause, ffsErrorDetailsAuthenticationFailed.cause);
+    ASSERT_TRUE(hasCommand(supplicant, "REMOVE_NETWORK 0"));
+    ASSERT_FALSE(hasCommand(supplicant, "REMOVE_NETWORK all"));
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlClose(&ctrl), FFS_SUCCESS);
+    ASSERT_EQ(ffsDeinitializeWifiContext(&wifiContext), FFS_SUCCESS);
+}
+
+TEST(WpaCtrlTests, ConnectNetworkNotFound)
+{
+    FakeWpaSupplicant supplicant;
+    FfsRaspbianWpaCtrl_t ctrl;
+    FfsLinuxWifiContext_t wifiContext;
+    FfsWifiConfiguration_t configuration = createConfiguration("AB", "", FFS_WIFI_SECURITY_PROTOCOL_NONE);
+
+    supplicant.setEvents("SELECT_NETWORK", {
+        "<3>CTRL-EVENT-NETWORK-NOT-FOUND ",
+        "<3>CTRL-EVENT-NETWORK-NOT-FOUND ",
+        "<3>CTRL-EVENT-NETWORK-NOT-FOUND "
+    });
+
+    ASSERT_EQ(ffsInitializeWifiContext(&wifiContext), FFS_SUCCESS);
+    ASSERT_EQ(ffsUpdateWifiConnectionDetails(&wifiContext, &configuration), FFS_SUCCESS);
+    ASSERT_EQ(ffsRaspbianWpaCtrlOpen(&ctrl, supplicant.getPath()), FFS_SUCCESS);
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlConnect(&ctrl, &wifiContext, &configuration, TEST_CONNECT_TIMEOUT_MILLI), FFS_SUCCESS);
+    ASSERT_EQ(wifiContext.connectionDetails.state, FFS_WIFI_CONNECTION_STATE_FAILED);
+    ASSERT_STREQ(wifiContext.connectionDetails.errorDetails.cause, ffsErrorDetailsApNotFound.cause);
+    ASSERT_TRUE(hasCommand(supplicant, "SET_NETWORK 0 key_mgmt NONE"));
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlClose(&ctrl), FFS_SUCCESS);
+    ASSERT_EQ(ffsDeinitializeWifiContext(&wifiContext), FFS_SUCCESS);
+}
+
+TEST(WpaCtrlTests, ConnectTimeout)
+{
+    FakeWpaSupplicant supplicant;
+    FfsRaspbianWpaCtrl_t ctrl;
+    FfsLinuxWifiContext_t wifiContext;
+    FfsWifiConfiguration_t configuration = createConfiguration("AB", "password", FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK);
+
+    ASSERT_EQ(ffsInitializeWifiContext(&wifiContext), FFS_SUCCESS);
+    ASSERT_EQ(ffsUpdateWifiConnectionDetails(&wifiContext, &configuration), FFS_SUCCESS);
+    ASSERT_EQ(ffsRaspbianWpaCtrlOpen(&ctrl, supplicant.getPath()), FFS_SUCCESS);
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlConnect(&ctrl, &wifiContext, &configuration, 100), FFS_SUCCESS);
+    ASSERT_EQ(wifiContext.connectionDetails.state, FFS_WIFI_CONNECTION_STATE_FAILED);
+    ASSERT_STREQ(wifiContext.connectionDetails.errorDetails.cause, ffsErrorDetailsLimitedConnectivity.cause);
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlClose(&ctrl), FFS_SUCCESS);
+    ASSERT_EQ(ffsDeinitializeWifiContext(&wifiContext), FFS_SUCCESS);
+}
+
+TEST(WpaCtrlTests, DisconnectWaitsForEvent)
+{
+    FakeWpaSupplicant supplicant;
+    FfsRaspbianWpaCtrl_t ctrl;
+    FFS_WIFI_CONNECTION_STATE state;
+
+    supplicant.setReply("STATUS", "ssid=AB\nwpa_state=COMPLETED\n");
+    supplicant.setEvents("DISCONNECT", { "<3>CTRL-EVENT-DISCONNECTED bssid=11:22:33:44:55:66 reason=3 locally_generated=1" });
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlOpen(&ctrl, supplicant.getPath()), FFS_SUCCESS);
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlGetConnectionState(&ctrl, &state), FFS_SUCCESS);
+    ASSERT_EQ(state, FFS_WIFI_CONNECTION_STATE_ASSOCIATED);
+    ASSERT_EQ(ffsRaspbianWpaCtrlDisconnect(&ctrl, 1000), FFS_SUCCESS);
+
+    // No event when the supplicant never reports the disconnection.
+    supplicant.setEvents("DISCONNECT", {});
+    ASSERT_EQ(ffsRaspbianWpaCtrlDisconnect(&ctrl, 50), FFS_TIMEOUT);
+
+    ASSERT_EQ(ffsRaspbianWpaCtrlClose(&ctrl), FFS_SUCCESS);
+}
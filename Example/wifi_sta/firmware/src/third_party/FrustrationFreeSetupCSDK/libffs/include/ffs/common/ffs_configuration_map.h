@@ -78,6 +78,7 @@ extern const char *FFS_CONFIGURATION_ENTRY_KEY_PRODUCT_INDEX; //!< Product index
 extern const char *FFS_CONFIGURATION_ENTRY_KEY_SOFTWARE_VERSION_INDEX; //!< Software version index, \a e.g., "00".
 extern const char *FFS_CONFIGURATION_ENTRY_KEY_DEVICE_EC_PUBLIC_KEY_DER; //!< Device public key in raw DER encoded bytes, \a It will be 256bit EC public key. When DER encoded it becomes 91 bytes.
 extern const char *FFS_CONFIGURATION_ENTRY_KEY_CLOUD_EC_PUBLIC_KEY_DER; //!< Cloud service public key in raw DER encoded bytes, \a It will be 256bit EC public key. When DER encoded it becomes 91 bytes.
+extern const char *FFS_CONFIGURATION_ENTRY_KEY_ENCODED_SETUP_NETWORK_CACHE; //!< Cached nonce-independent part of the encoded setup network, in bytes.
 
 #define FFS_MAXIMUM_ISO8601_STRING_LENGTH (40) //!< Maximum ISO8601 time string length (sub-picosecond resolution).
 
@@ -0,0 +1,244 @@
+/** @file ffs_dns_cache.h
+ *
+ * @brief DNS answer cache.
+ *
+ * A small, fixed-capacity cache of resolved host names shared by the HTTP
+ * compatibility layers. Each record carries its own time-to-live. Failed
+ * resolutions can be cached as "negative" records so that a host known to be
+ * unresolvable on the current network fails fast instead of waiting for
+ * another resolver timeout.
+ *
+ * The cache does not own a clock. Every time-dependent call takes the current
+ * time in milliseconds from a monotonic source chosen by the caller (\a e.g.,
+ * the FreeRTOS tick count or CLOCK_MONOTONIC). Unsigned wrap-around is
+ * handled.
+ *
+ * The cache can be serialized to a compact binary record so that a client can
+ * persist it (to a file or NVM) and restore it after a network switch or a
+ * reboot. Only unexpired positive records are serialized; the remaining
+ * time-to-live is stored rather than an absolute expiry time, so a restored
+ * record never outlives its original answer by more than the time the device
+ * spent powered off.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#ifndef FFS_DNS_CACHE_H_
+#define FFS_DNS_CACHE_H_
+
+#include "ffs/common/ffs_http.h"
+#include "ffs/common/ffs_result.h"
+#include "ffs/common/ffs_stream.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if !defined(FFS_DNS_CACHE_MAXIMUM_HOST_LENGTH)
+
+/** @brief Default maximum cached host name length (not including the null terminator).
+ */
+#define FFS_DNS_CACHE_MAXIMUM_HOST_LENGTH       FFS_MAXIMUM_URL_HOST_LENGTH
+
+#endif
+
+/** @brief Maximum cached address string length (not including the null terminator).
+ *
+ * Large enough for a textual IPv6 address.
+ */
+#define FFS_DNS_CACHE_MAXIMUM_ADDRESS_LENGTH    (45)
+
+/** @brief Default time-to-live of a negative record.
+ */
+#define FFS_DNS_CACHE_DEFAULT_NEGATIVE_TTL_MS   (5 * 1000)
+
+/** @brief Default lower bound applied to positive record time-to-live values.
+ */
+#define FFS_DNS_CACHE_DEFAULT_MINIMUM_TTL_MS    (30 * 1000)
+
+/** @brief Default upper bound applied to positive record time-to-live values.
+ */
+#define FFS_DNS_CACHE_DEFAULT_MAXIMUM_TTL_MS    (24 * 60 * 60 * 1000UL)
+
+/** @brief Serialized cache format version.
+ */
+#define FFS_DNS_CACHE_SERIALIZED_VERSION        (1)
+
+/** @brief Result of a cache lookup.
+ */
+typedef enum {
+    FFS_DNS_CACHE_MISS = 0, //!< No usable record; the caller must resolve the host.
+    FFS_DNS_CACHE_HIT, //!< A positive record was found.
+    FFS_DNS_CACHE_NEGATIVE_HIT //!< A negative record was found; the host recently failed to resolve.
+} FFS_DNS_CACHE_LOOKUP_RESULT;
+
+/** @brief Cache record.
+ */
+typedef struct {
+    char host[FFS_DNS_CACHE_MAXIMUM_HOST_LENGTH + 1]; //!< Null-terminated host name (empty if the record is unused).
+    char address[FFS_DNS_CACHE_MAXIMUM_ADDRESS_LENGTH + 1]; //!< Null-terminated textual address (empty for a negative record).
+    bool isNegative; //!< Is this a negative record?
+    uint32_t expiryTimeMs; //!< Time at which the record expires.
+    uint32_t lastUsedTimeMs; //!< Time of the last insertion or hit (used for eviction).
+    uint32_t resolveDurationMs; //!< Time the resolution that produced this record took.
+} FfsDnsCacheEntry_t;
+
+/** @brief Cache instrumentation.
+ */
+typedef struct {
+    uint32_t hits; //!< Positive hits.
+    uint32_t negativeHits; //!< Negative hits.
+    uint32_t misses; //!< Misses (including expired records).
+    uint32_t expirations; //!< Records discarded because their time-to-live elapsed.
+    uint32_t insertions; //!< Records inserted or refreshed.
+    uint32_t evictions; //!< Live records evicted to make room.
+    uint32_t resolveCount; //!< Resolutions reported on insertion.
+    uint64_t resolveTimeMs; //!< Total time spent in the reported resolutions.
+    uint64_t timeSavedMs; //!< Estimated resolver time saved by positive hits.
+} FfsDnsCacheStatistics_t;
+
+/** @brief DNS cache.
+ */
+typedef struct {
+    FfsDnsCacheEntry_t *entries; //!< Client-allocated record storage.
+    size_t entryCount; //!< Number of records in the storage.
+    uint32_t negativeTtlMs; //!< Time-to-live given to negative records.
+    uint32_t minimumTtlMs; //!< Lower bound for positive record time-to-live values.
+    uint32_t maximumTtlMs; //!< Upper bound for positive record time-to-live values.
+    FfsDnsCacheStatistics_t statistics; //!< Instrumentation.
+} FfsDnsCache_t;
+
+/** @brief Initialize a DNS cache over client-allocated storage.
+ *
+ * The time-to-live bounds are set to their defaults and can be changed
+ * directly in the structure afterwards.
+ *
+ * @param cache Cache to initialize
+ * @param entries Record storage
+ * @param entryCount Number of records in the storage
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsInitializeDnsCache(FfsDnsCache_t *cache, FfsDnsCacheEntry_t *entries, size_t entryCount);
+
+/** @brief Look up a host.
+ *
+ * Expired records are discarded as a side effect. On a positive hit the
+ * address is written to the given stream (without a null terminator).
+ *
+ * @param cache Cache
+ * @param hostStream Host name (not modified)
+ * @param nowMs Current time in milliseconds
+ * @param addressStream Destination for the cached address; may be NULL
+ * @param lookupResult Lookup result
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDnsCacheLookup(FfsDnsCache_t *cache, FfsStream_t *hostStream, uint32_t nowMs,
+        FfsStream_t *addressStream, FFS_DNS_CACHE_LOOKUP_RESULT *lookupResult);
+
+/** @brief Insert or refresh a positive record.
+ *
+ * The time-to-live is clamped to the cache bounds. When the cache is full the
+ * least recently used record is evicted.
+ *
+ * @param cache Cache
+ * @param hostStream Host name (not modified)
+ * @param address Null-terminated textual address
+ * @param ttlMs Time-to-live reported by the resolver
+ * @param resolveDurationMs How long the resolution took
+ * @param nowMs Current time in milliseconds
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDnsCacheInsert(FfsDnsCache_t *cache, FfsStream_t *hostStream, const char *address,
+        uint32_t ttlMs, uint32_t resolveDurationMs, uint32_t nowMs);
+
+/** @brief Insert or refresh a negative record.
+ *
+ * @param cache Cache
+ * @param hostStream Host name (not modified)
+ * @param resolveDurationMs How long the failed resolution took
+ * @param nowMs Current time in milliseconds
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDnsCacheInsertNegative(FfsDnsCache_t *cache, FfsStream_t *hostStream,
+        uint32_t resolveDurationMs, uint32_t nowMs);
+
+/** @brief Remove the record for a host, if any.
+ *
+ * Used when a cached address turns out to be unreachable.
+ *
+ * @param cache Cache
+ * @param hostStream Host name (not modified)
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDnsCacheRemove(FfsDnsCache_t *cache, FfsStream_t *hostStream);
+
+/** @brief Remove all negative records.
+ *
+ * Negative answers are only meaningful on the network that produced them and
+ * should be dropped on a network switch. Positive records are kept.
+ *
+ * @param cache Cache
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDnsCacheFlushNegative(FfsDnsCache_t *cache);
+
+/** @brief Remove all records. The statistics are kept.
+ *
+ * @param cache Cache
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDnsCacheClear(FfsDnsCache_t *cache);
+
+/** @brief Serialize the unexpired positive records.
+ *
+ * @param cache Cache
+ * @param nowMs Current time in milliseconds
+ * @param outputStream Destination stream
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDnsCacheSerialize(FfsDnsCache_t *cache, uint32_t nowMs, FfsStream_t *outputStream);
+
+/** @brief Restore records from a serialized cache.
+ *
+ * Restored records are merged into the cache as if they had just been
+ * inserted with their remaining time-to-live. A malformed or unknown-version
+ * input is rejected without modifying the cache.
+ *
+ * @param cache Cache
+ * @param nowMs Current time in milliseconds
+ * @param inputStream Serialized cache
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDnsCacheDeserialize(FfsDnsCache_t *cache, uint32_t nowMs, FfsStream_t *inputStream);
+
+/** @brief Log the cache statistics.
+ *
+ * @param cache Cache
+ */
+void ffsDnsCacheLogStatistics(FfsDnsCache_t *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FFS_DNS_CACHE_H_ */
@@ -153,6 +153,22 @@ FFS_RESULT ffsParseJsonValue(FfsJsonValue_t *sourceValue, FfsJsonValue_t *destin
  */
 FFS_RESULT ffsReadJsonStringCharacter(FfsJsonValue_t *sourceValue, uint32_t *nextCharacter, bool *isEscaped, bool *isDone);
 
+/** @brief Count the plain bytes at the start of a JSON string.
+ *
+ * Find the first quote ("), backslash (\), control character or non-ASCII
+ * byte. The bytes before it read and encode as themselves, so the string
+ * functions copy them as one block and only decode or escape from there.
+ *
+ * The scan uses SSE2 or NEON when the compiler targets them, unless
+ * FFS_JSON_NO_SIMD is defined, and word-at-a-time comparisons otherwise.
+ *
+ * @param data source bytes
+ * @param dataSize number of source bytes
+ *
+ * @returns the number of plain bytes (dataSize if all of them are)
+ */
+size_t ffsScanJsonPlainBytes(const uint8_t *data, size_t dataSize);
+
 /** @brief Read a JSON string as UTF-8.
  *
  * Read a JSON string, writing each of the resultant sequence of unicode
@@ -187,6 +187,9 @@ FFS_RESULT ffsVerifyCloudSignature(struct FfsUserContext_s *userContext, FfsStre
         FfsStream_t *signatureStream, bool *isVerified);
 
 /** @brief Execute an HTTP operation.
+ *
+ * Blocks until the operation completes; equivalent to @ref ffsHttpExecuteAsync
+ * without a timeout followed by @ref ffsHttpWait.
  *
  * @param userContext User context
  * @param request HTTP request
@@ -197,6 +200,69 @@ FFS_RESULT ffsVerifyCloudSignature(struct FfsUserContext_s *userContext, FfsStre
 FFS_RESULT ffsHttpExecute(struct FfsUserContext_s *userContext, FfsHttpRequest_t *request,
         void *callbackDataPointer);
 
+/** @brief In-flight HTTP operation (opaque, owned by the compatibility layer).
+ */
+typedef struct FfsHttpOperation_s FfsHttpOperation_t;
+
+/** @brief HTTP operation completion callback.
+ *
+ * Called once per submitted operation, after the last response handler.
+ *
+ * @param operation Completed operation
+ * @param result @ref FFS_SUCCESS, @ref FFS_TIMEOUT if the operation timed out,
+ *        or @ref FFS_ERROR if it failed or was cancelled
+ * @param callbackDataPointer Data pointer given with the request
+ */
+typedef void (*FfsHttpCompletionCallback_t)(FfsHttpOperation_t *operation, FFS_RESULT result,
+        void *callbackDataPointer);
+
+/** @brief Start an HTTP operation without waiting for it.
+ *
+ * The response handlers in the request and the completion callback run on the
+ * compatibility layer's HTTP context. The request (and everything it points
+ * to) must stay valid until the operation completes.
+ *
+ * If an operation handle is requested, it must be released with
+ * @ref ffsHttpWait; otherwise the operation is released on completion.
+ *
+ * @param userContext User context
+ * @param request HTTP request
+ * @param callbackDataPointer Data pointer to pass to the response handlers
+ * @param timeoutMs Time limit for the whole operation, or 0 for none
+ * @param onComplete Completion callback (optional)
+ * @param operation Destination operation handle (optional)
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT); on failure the operation was
+ *          not started and no callbacks will run
+ */
+FFS_RESULT ffsHttpExecuteAsync(struct FfsUserContext_s *userContext, FfsHttpRequest_t *request,
+        void *callbackDataPointer, uint32_t timeoutMs, FfsHttpCompletionCallback_t onComplete,
+        FfsHttpOperation_t **operation);
+
+/** @brief Wait for an HTTP operation to complete and release it.
+ *
+ * Must not be called from a response handler or completion callback.
+ *
+ * @param userContext User context
+ * @param operation Operation handle from @ref ffsHttpExecuteAsync
+ *
+ * @returns The operation [result](@ref FFS_RESULT), as given to the completion callback
+ */
+FFS_RESULT ffsHttpWait(struct FfsUserContext_s *userContext, FfsHttpOperation_t *operation);
+
+/** @brief Cancel an HTTP operation.
+ *
+ * No response handler starts after this returns; the operation completes with
+ * @ref FFS_ERROR unless it had already finished. The handle must still be
+ * released with @ref ffsHttpWait.
+ *
+ * @param userContext User context
+ * @param operation Operation handle from @ref ffsHttpExecuteAsync
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsHttpCancel(struct FfsUserContext_s *userContext, FfsHttpOperation_t *operation);
+
 /** @brief Get the next Wi-Fi scan result.
  *
  * Get the next Wi-Fi scan result. The given scan result object is initialized
@@ -242,10 +308,11 @@ FFS_RESULT ffsRemoveWifiConfiguration(struct FfsUserContext_s *userContext, FfsS
  *
  * Start a connection attempt to the stored Wi-Fi network(s), starting with
  * the highest priority network. To store Wi-Fi networks, first call
- * @ref ffsAddWifiNetwork. This function will wait until the connection
- * attempt(s) complete. If multiple credentials have been provided, it will wait
- * until a successful connection is established or until all stored credentials
- * have been tried.
+ * @ref ffsAddWifiNetwork. This function may return while the attempt is still
+ * running; @ref ffsGetWifiConnectionDetails then reports
+ * @ref FFS_WIFI_CONNECTION_STATE_UNAUTHENTICATED or
+ * @ref FFS_WIFI_CONNECTION_STATE_AUTHENTICATED until a connection is
+ * established or all stored credentials have been tried.
  *
  * @param userContext User context
  *
@@ -107,6 +107,43 @@ FFS_RESULT ffsWifiProvisioneeCanPostWifiScanData(struct FfsUserContext_s *userCo
 FFS_RESULT ffsWifiProvisioneeCanGetWifiCredentials(struct FfsUserContext_s *userContext,
         uint32_t sequenceNumber, bool allCredentialsReturned, bool *canGetWifiCredentials);
 
+/** @brief Save the provisioning checkpoint.
+ *
+ * Replace the stored checkpoint record with the given one. The record should
+ * be written to persistent storage that survives a reset. The record carries
+ * its own CRC, so a torn write is detected when it is loaded.
+ *
+ * @param userContext User context
+ * @param checkpointStream Checkpoint record (up to
+ *        @ref FFS_WIFI_PROVISIONEE_CHECKPOINT_MAXIMUM_SIZE bytes)
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsSaveWifiProvisioneeCheckpoint(struct FfsUserContext_s *userContext,
+        FfsStream_t *checkpointStream);
+
+/** @brief Load the provisioning checkpoint.
+ *
+ * Write the stored checkpoint record to the given stream, or leave the stream
+ * empty if there is none. Clients without persistent storage should return
+ * \ref FFS_NOT_IMPLEMENTED, which disables checkpoints.
+ *
+ * @param userContext User context
+ * @param checkpointStream Destination stream
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsLoadWifiProvisioneeCheckpoint(struct FfsUserContext_s *userContext,
+        FfsStream_t *checkpointStream);
+
+/** @brief Remove the stored provisioning checkpoint.
+ *
+ * @param userContext User context
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsClearWifiProvisioneeCheckpoint(struct FfsUserContext_s *userContext);
+
 #ifdef __cplusplus
 }
 #endif
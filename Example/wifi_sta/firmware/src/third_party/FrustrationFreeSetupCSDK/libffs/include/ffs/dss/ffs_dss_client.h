@@ -15,8 +15,10 @@
 #ifndef FFS_DSS_CLIENT_H_
 #define FFS_DSS_CLIENT_H_
 
+#include "ffs/common/ffs_crypto.h"
 #include "ffs/common/ffs_http.h"
 #include "ffs/common/ffs_result.h"
+#include "ffs/compat/ffs_common_compat.h"
 #include "ffs/compat/ffs_user_context.h"
 #include "ffs/dss/ffs_dss_operation.h"
 
@@ -30,6 +32,46 @@ extern "C" {
 #define FFS_DSS_MAX_REDIRECTS (3) //!< Maximum number of redirects in a call.
 #endif
 
+#if !defined(FFS_DSS_REQUEST_TIMEOUT_MS)
+#define FFS_DSS_REQUEST_TIMEOUT_MS (30000) //!< Time limit of each HTTP request of a call.
+#endif
+
+struct FfsDssClientContext_s;
+
+/** @brief DSS HTTP callback data.
+ */
+typedef struct {
+    struct FfsDssClientContext_s *dssClientContext; //!< Pointer to the DSS client context.
+    bool hasStatusCode; //!< Do we have a status code?
+    int32_t statusCode; //!< HTTP response status code.
+    bool hasSignature; //!< Do we have the signature?
+    FfsStream_t *signatureStream; //!< Deserialized signature header value.
+    bool hasBody; //!< Do we have the body?
+    bool signatureIsVerified; //!< The signature was verified.
+    bool hasRedirect; //!< Do we have a redirect?
+    FfsUrl_t *redirectUrl; //!< Pointer to the destination redirect URL object.
+    void *operationCallbackDataPointer; //!< Pointer to callback data provided by calling operation.
+    FFS_RESULT result; //!< Summary error result.
+} FfsDssHttpCallbackData_t;
+
+/** @brief DSS request in flight.
+ *
+ * Everything the HTTP operation points to, kept until the request completes.
+ */
+typedef struct {
+    FfsHttpOperation_t *operation; //!< HTTP operation of the current attempt (NULL if none).
+    volatile bool isComplete; //!< The HTTP operation of the current attempt completed.
+    int redirectCount; //!< Number of redirects followed.
+    FfsHttpHeader_t contentTypeHeader; //!< "Content-Type" header.
+    FfsHttpHeader_t *headers[2]; //!< Null-terminated header list.
+    FfsHttpRequest_t httpRequest; //!< HTTP request (its URL follows the redirects).
+    FfsHttpRequest_t httpRequestCopy; //!< HTTP request of the current attempt.
+    FfsDssHttpCallbackData_t dssResponse; //!< DSS response.
+    FfsDssHttpCallbackData_t dssResponseCopy; //!< DSS response of the current attempt.
+    FfsStream_t signatureStream; //!< Deserialized signature header value.
+    uint8_t signatureBuffer[FFS_MAXIMUM_DER_SIGNATURE_SIZE]; //!< Signature buffer.
+} FfsDssClientRequest_t;
+
 /** @brief DSS client context.
  *
  * The host stream and the session ID stream \a must be mutable and should have
@@ -37,7 +79,7 @@ extern "C" {
  * bytes (@ref FFS_MAXIMUM_SESSION_ID_LENGTH), respectively, to
  * eliminate the possibility of overruns.
  */
-typedef struct {
+typedef struct FfsDssClientContext_s {
     struct FfsUserContext_s *userContext; //!< Pointer to the user context.
     FfsStream_t hostStream; //!< "Host" part of the URL (maximum of 253 characters).
     FfsStream_t sessionIdStream; //!< Session ID (maximum of 255 characters + 1 for null).
@@ -46,24 +88,9 @@ typedef struct {
     uint16_t port; //!< HTTP port.
     int32_t sequenceNumber; //!< Call sequence number.
     bool connectedToSocksNetwork; //!< Flag to indicate if we are connected to socks enabled network.
+    FfsDssClientRequest_t request; //!< Request in flight.
 } FfsDssClientContext_t;
 
-/** @brief DSS HTTP callback data.
- */
-typedef struct {
-    FfsDssClientContext_t *dssClientContext; //!< Pointer to the DSS client context.
-    bool hasStatusCode; //!< Do we have a status code?
-    int32_t statusCode; //!< HTTP response status code.
-    bool hasSignature; //!< Do we have the signature?
-    FfsStream_t *signatureStream; //!< Deserialized signature header value.
-    bool hasBody; //!< Do we have the body?
-    bool signatureIsVerified; //!< The signature was verified.
-    bool hasRedirect; //!< Do we have a redirect?
-    FfsUrl_t *redirectUrl; //!< Pointer to the destination redirect URL object.
-    void *operationCallbackDataPointer; //!< Pointer to callback data provided by calling operation.
-    FFS_RESULT result; //!< Summary error result.
-} FfsDssHttpCallbackData_t;
-
 /** @brief Initialize the Device Setup Service client.
  *
  * @param userContext User context
@@ -87,6 +114,54 @@ FFS_RESULT ffsDssClientExecute(FfsDssClientContext_t *dssClientContext,
         const FfsDssOperationData_t *dssOperation, FfsStream_t *bodyStream,
         void *callbackDataPointer);
 
+/** @brief Start a request to the Device Setup Service without waiting for it.
+ *
+ * Complete the request with @ref ffsDssClientPoll or @ref ffsDssClientWait.
+ * The response handlers run on the HTTP context of the compatibility layer,
+ * so the callback data must stay valid until the request completes. Only one
+ * request is in flight at a time.
+ *
+ * @param dssClientContext DSS client context
+ * @param dssOperation DSS operation to execute
+ * @param bodyStream HTTP POST body
+ * @param callbackDataPointer Callback data provided by calling operation
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDssClientExecuteAsync(FfsDssClientContext_t *dssClientContext,
+        const FfsDssOperationData_t *dssOperation, FfsStream_t *bodyStream,
+        void *callbackDataPointer);
+
+/** @brief Check whether the request in flight completed, without waiting.
+ *
+ * Redirects are followed here, so a redirected request stays in flight.
+ *
+ * @param dssClientContext DSS client context
+ * @param isComplete Set to true once the request completed
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT); the result of the request
+ *          once it completed
+ */
+FFS_RESULT ffsDssClientPoll(FfsDssClientContext_t *dssClientContext, bool *isComplete);
+
+/** @brief Wait for the request in flight to complete.
+ *
+ * @param dssClientContext DSS client context
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT) of the request
+ */
+FFS_RESULT ffsDssClientWait(FfsDssClientContext_t *dssClientContext);
+
+/** @brief Cancel the request in flight, if any.
+ *
+ * No response handler runs once this returns.
+ *
+ * @param dssClientContext DSS client context
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDssClientCancel(FfsDssClientContext_t *dssClientContext);
+
 /** @brief Handle a status code.
  *
  * @param statusCode Response status code
@@ -43,6 +43,13 @@ typedef FFS_RESULT (*FfsDssSaveRegistrationDetailsCallback_t)(
 typedef FFS_RESULT (*FfsDssSaveConfigurationCallback_t)(struct FfsUserContext_s *userContext,
         const char *key, FfsMapValue_t *value);
 
+/** @brief "Save response data" callbacks object.
+ */
+typedef struct {
+    FfsDssSaveRegistrationDetailsCallback_t saveRegistrationDetailsCallback; //!< Registration details callback.
+    FfsDssSaveConfigurationCallback_t saveConfigurationCallback; //!< Configuration entry callback.
+} FfsDssComputeConfigurationDataReponseCallbacks_t;
+
 /** @brief Execute a "compute configuration data" operation.
  *
  * @param dssClientContext DSS client context
@@ -55,6 +62,23 @@ FFS_RESULT ffsDssComputeConfigurationData(FfsDssClientContext_t *dssClientContex
         FfsDssSaveRegistrationDetailsCallback_t saveRegistrationTokenCallback,
         FfsDssSaveConfigurationCallback_t saveConfigurationCallback);
 
+/** @brief Start a "compute configuration data" operation.
+ *
+ * Complete it with @ref ffsDssClientPoll or @ref ffsDssClientWait. The
+ * callbacks object must stay valid until then.
+ *
+ * @param dssClientContext DSS client context
+ * @param saveRegistrationDetailsCallback Callback to save the registration details
+ * @param saveConfigurationCallback Callback to save the configuration entries
+ * @param responseCallbacks Callbacks object of the request
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDssComputeConfigurationDataAsync(FfsDssClientContext_t *dssClientContext,
+        FfsDssSaveRegistrationDetailsCallback_t saveRegistrationDetailsCallback,
+        FfsDssSaveConfigurationCallback_t saveConfigurationCallback,
+        FfsDssComputeConfigurationDataReponseCallbacks_t *responseCallbacks);
+
 #ifdef __cplusplus
 }
 #endif
@@ -32,6 +32,14 @@ extern "C" {
 typedef FFS_RESULT (*FfsDssSaveWifiCredentialsCallback_t)(struct FfsUserContext_s *userContext,
         FfsDssWifiCredentials_t *wifiCredentials);
 
+/** @brief Data structure for response body callback.
+ */
+typedef struct {
+    bool *canProceed; //!< Destination "can proceed" flag.
+    FfsDssSaveWifiCredentialsCallback_t saveCredentialsCallback; //!< Callback to store Wi-Fi credentials.
+    bool *allCredentialsReturned; //!< Destination "all credentials returned" flag.
+} FfsDssGetWifiCredentialsOperationData_t;
+
 /** @brief Execute a "get Wi-Fi credentials" operation.
  *
  * @param dssClientContext DSS client context
@@ -48,6 +56,27 @@ FFS_RESULT ffsDssGetWifiCredentials(FfsDssClientContext_t *dssClientContext,
         FfsDssSaveWifiCredentialsCallback_t saveCredentialsCallback,
         bool *allCredentialsReturned);
 
+/** @brief Start a "get Wi-Fi credentials" operation.
+ *
+ * Complete it with @ref ffsDssClientPoll or @ref ffsDssClientWait. The
+ * destinations and the operation data must stay valid until then.
+ *
+ * @param dssClientContext DSS client context
+ * @param canProceed Can proceed flag
+ * @param sequenceNumber Sequence number of this call
+ * @param saveCredentialsCallback Callback to store Wi-Fi credentials
+ * @param allCredentialsReturned Boolean indicating the cloud has returned all credentials
+ * @param operationData Operation data of the request
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDssGetWifiCredentialsAsync(FfsDssClientContext_t *dssClientContext,
+        bool *canProceed,
+        uint32_t sequenceNumber,
+        FfsDssSaveWifiCredentialsCallback_t saveCredentialsCallback,
+        bool *allCredentialsReturned,
+        FfsDssGetWifiCredentialsOperationData_t *operationData);
+
 #ifdef __cplusplus
 }
 #endif
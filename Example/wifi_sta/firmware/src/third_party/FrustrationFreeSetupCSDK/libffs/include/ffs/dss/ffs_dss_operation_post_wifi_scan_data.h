@@ -22,6 +22,10 @@
 extern "C" {
 #endif
 
+/** @brief Incomplete Wi-Fi provisionee scan list structure.
+ */
+struct FfsWifiProvisioneeScanList_s;
+
 /** @brief Callback to get Wi-Fi scan results.
  *
  * To add a scan result, call the function
@@ -29,13 +33,21 @@ extern "C" {
  * \ref callbackDataPointer and the scan result to add.
  *
  * @param userContext User context
- * @param wifiScanResult Destination scan result object for the callback
+ * @param scanList Scan list to post the scan results from
  * @param callbackDataPointer Pointer to "get Wi-Fi scan results" data
  *
  * @returns Enumerated [result](@ref FFS_RESULT)
  */
 typedef FFS_RESULT (*FfsDssGetWifiScanResultsCallback_t)(struct FfsUserContext_s *userContext,
-        FfsDssWifiScanResult_t *wifiScanResult, void *callbackDataPointer);
+        struct FfsWifiProvisioneeScanList_s *scanList, void *callbackDataPointer);
+
+/** @brief Data structure for response body callback.
+ */
+typedef struct {
+    bool *canProceed; //!< Destination "can proceed" flag.
+    uint32_t *totalCredentialsFound; //!< Destination running total of credentials found.
+    bool *allCredentialsFound; //!< Destination "all credentials found" flag.
+} FfsDssPostWifiScanDataOperationData_t;
 
 /** @brief Execute a "post Wi-Fi scan data" operation.
  *
@@ -43,7 +55,7 @@ typedef FFS_RESULT (*FfsDssGetWifiScanResultsCallback_t)(struct FfsUserContext_s
  * @param canProceed Can proceed flag
  * @param sequenceNumber Sequence number of this call
  * @param getScanResultsCallback Callback to retrieve the Wi-Fi scan results
- * @param wifiScanResult Destination scan result object for the callback
+ * @param scanList Scan list passed to the callback
  * @param totalCredentialsFound Running total of credentials found across all calls
  * @param allCredentialsFound Boolean indicating all credentials have been found in the cloud
  *
@@ -53,10 +65,35 @@ FFS_RESULT ffsDssPostWifiScanData(FfsDssClientContext_t *dssClientContext,
         bool *canProceed,
         uint32_t sequenceNumber,
         FfsDssGetWifiScanResultsCallback_t getScanResultsCallback,
-        FfsDssWifiScanResult_t *wifiScanResult,
+        struct FfsWifiProvisioneeScanList_s *scanList,
         uint32_t *totalCredentialsFound,
         bool *allCredentialsFound);
 
+/** @brief Start a "post Wi-Fi scan data" operation.
+ *
+ * Complete it with @ref ffsDssClientPoll or @ref ffsDssClientWait. The
+ * destinations and the operation data must stay valid until then.
+ *
+ * @param dssClientContext DSS client context
+ * @param canProceed Can proceed flag
+ * @param sequenceNumber Sequence number of this call
+ * @param getScanResultsCallback Callback to retrieve the Wi-Fi scan results
+ * @param scanList Scan list passed to the callback
+ * @param totalCredentialsFound Running total of credentials found across all calls
+ * @param allCredentialsFound Boolean indicating all credentials have been found in the cloud
+ * @param operationData Operation data of the request
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDssPostWifiScanDataAsync(FfsDssClientContext_t *dssClientContext,
+        bool *canProceed,
+        uint32_t sequenceNumber,
+        FfsDssGetWifiScanResultsCallback_t getScanResultsCallback,
+        struct FfsWifiProvisioneeScanList_s *scanList,
+        uint32_t *totalCredentialsFound,
+        bool *allCredentialsFound,
+        FfsDssPostWifiScanDataOperationData_t *operationData);
+
 /** @brief Add a Wi-Fi scan result to a "post Wi-Fi scan data" call.
  *
  * If this function returns \ref FFS_OVERRUN, the request has reached
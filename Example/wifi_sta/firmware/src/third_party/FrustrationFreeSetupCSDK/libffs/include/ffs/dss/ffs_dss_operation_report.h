@@ -42,6 +42,13 @@ extern "C" {
 typedef FFS_RESULT (*FfsDssGetConnectionAttemptsCallback_t)(struct FfsUserContext_s *userContext,
         FfsDssWifiConnectionAttempt_t *dssWifiConnectionAttempt, void *callbackDataPointer);
 
+/** @brief "Report" operation data.
+ */
+typedef struct {
+    bool *canProceed; //!< Destination "can proceed" flag.
+    FFS_DSS_WIFI_PROVISIONEE_STATE *nextProvisioneeState; //!< Destination next provisionee state.
+} FfsDssReportOperationData_t;
+
 /** @brief Execute a "report" operation.
  *
  * @param dssClientContext DSS client context
@@ -64,6 +71,34 @@ FFS_RESULT ffsDssReport(FfsDssClientContext_t *dssClientContext,
         FfsDssGetConnectionAttemptsCallback_t getConnectionAttemptsCallback,
         FfsDssWifiConnectionAttempt_t *wifiConnectionAttempt);
 
+/** @brief Start a "report" operation.
+ *
+ * Complete it with @ref ffsDssClientPoll or @ref ffsDssClientWait. The
+ * destinations and the operation data must stay valid until then.
+ *
+ * @param dssClientContext DSS client context
+ * @param provisioneeState Provisionee state
+ * @param stateTransitionResult State transition result
+ * @param registrationState Registration state
+ * @param canProceed Can proceed flag
+ * @param nextProvisioneeState Destination next provisionee state pointer
+ * @param getConnectionAttemptsCallback Callback to retrieve the connection attempts
+ *        to report
+ * @param wifiConnectionAttempt Destination connection attempt object for the callback
+ * @param operationData Operation data of the request
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDssReportAsync(FfsDssClientContext_t *dssClientContext,
+        FFS_DSS_WIFI_PROVISIONEE_STATE provisioneeState,
+        FFS_DSS_REPORT_RESULT stateTransitionResult,
+        FFS_DSS_REGISTRATION_STATE registrationState,
+        bool *canProceed,
+        FFS_DSS_WIFI_PROVISIONEE_STATE *nextProvisioneeState,
+        FfsDssGetConnectionAttemptsCallback_t getConnectionAttemptsCallback,
+        FfsDssWifiConnectionAttempt_t *wifiConnectionAttempt,
+        FfsDssReportOperationData_t *operationData);
+
 /** @brief Add a connection attempt to a report.
  *
  * If this function returns \ref FFS_OVERRUN, the report has reached
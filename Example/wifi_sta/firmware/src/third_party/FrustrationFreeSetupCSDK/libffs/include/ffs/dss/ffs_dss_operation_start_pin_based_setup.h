@@ -32,6 +32,20 @@ extern "C" {
 FFS_RESULT ffsDssStartPinBasedSetup(FfsDssClientContext_t *dssClientContext,
         bool *canProceed, FfsStream_t saltStream);
 
+/** @brief Start a "start PIN-based setup" operation.
+ *
+ * Complete it with @ref ffsDssClientPoll or @ref ffsDssClientWait. The
+ * "can proceed" flag must stay valid until then.
+ *
+ * @param dssClientContext DSS client context
+ * @param canProceed Can proceed flag
+ * @param saltStream Salt stream
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDssStartPinBasedSetupAsync(FfsDssClientContext_t *dssClientContext,
+        bool *canProceed, FfsStream_t saltStream);
+
 #ifdef __cplusplus
 }
 #endif
@@ -26,6 +26,13 @@
 extern "C" {
 #endif
 
+/** @brief DSS "start provisioning session" operation data structure.
+ */
+typedef struct {
+    bool *canProceed; //!< Destination "can proceed" flag.
+    FfsStream_t *saltStream; //!< Destination stream for the salt.
+} FfsStartProvisioningSessionOperationData_t;
+
 /** @brief Execute a "start provisioning session" operation.
  *
  * @param dssClientContext DSS client context
@@ -37,6 +44,22 @@ extern "C" {
 FFS_RESULT ffsDssStartProvisioningSession(FfsDssClientContext_t *dssClientContext,
         bool *canProceed, FfsStream_t *saltStream);
 
+/** @brief Start a "start provisioning session" operation.
+ *
+ * Complete it with @ref ffsDssClientPoll or @ref ffsDssClientWait. The
+ * destinations and the operation data must stay valid until then.
+ *
+ * @param dssClientContext DSS client context
+ * @param canProceed Can proceed flag
+ * @param saltStream Destination stream for the salt
+ * @param operationData Operation data of the request
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDssStartProvisioningSessionAsync(FfsDssClientContext_t *dssClientContext,
+        bool *canProceed, FfsStream_t *saltStream,
+        FfsStartProvisioningSessionOperationData_t *operationData);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,171 @@
+/** @file ffs_dss_model_codec.h
+ *
+ * @brief Table-driven DSS model serialization/deserialization.
+ *
+ * Each DSS model type is described by a field descriptor table generated
+ * from libffs/tools/ffs_dss_model_schema.json (see
+ * ffs_dss_model_tables.h). One serializer and one deserializer walk those
+ * tables instead of every model carrying its own field-by-field code.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#ifndef FFS_DSS_MODEL_CODEC_H_
+#define FFS_DSS_MODEL_CODEC_H_
+
+#include "ffs/common/ffs_json.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Largest number of fields in a model.
+ */
+#define FFS_DSS_MODEL_MAXIMUM_FIELD_COUNT   (32)
+
+/** @brief "No presence flag" offset.
+ */
+#define FFS_DSS_MODEL_NO_PRESENCE_FLAG      (0xFFFF)
+
+/** @brief Field flag: deserialize the field even if it is absent and always
+ * serialize it (otherwise "empty" optional fields are omitted).
+ */
+#define FFS_DSS_MODEL_FIELD_REQUIRED        (1 << 0)
+
+/** @brief Field flag: fail deserialization if the boolean is false.
+ */
+#define FFS_DSS_MODEL_FIELD_FAIL_IF_FALSE   (1 << 1)
+
+/** @brief Field types.
+ */
+typedef enum {
+    FFS_DSS_MODEL_FIELD_STRING, //!< Null-terminated string (const char *).
+    FFS_DSS_MODEL_FIELD_STREAM, //!< Stream serialized as a raw JSON string (FfsStream_t).
+    FFS_DSS_MODEL_FIELD_QUOTED_STREAM, //!< Stream serialized as an escaped JSON string (FfsStream_t).
+    FFS_DSS_MODEL_FIELD_BSSID, //!< 6-byte stream serialized as "XX:XX:XX:XX:XX:XX" (FfsStream_t).
+    FFS_DSS_MODEL_FIELD_BOOLEAN, //!< Boolean (bool).
+    FFS_DSS_MODEL_FIELD_INT32, //!< Signed 32-bit integer (int32_t).
+    FFS_DSS_MODEL_FIELD_UINT32, //!< Unsigned 32-bit integer (uint32_t).
+    FFS_DSS_MODEL_FIELD_INT64, //!< Signed 64-bit integer (int64_t).
+    FFS_DSS_MODEL_FIELD_ENUM, //!< Enumeration serialized as a string.
+    FFS_DSS_MODEL_FIELD_OBJECT, //!< Nested model.
+    FFS_DSS_MODEL_FIELD_CUSTOM, //!< Field serialized by a hand-written field serializer.
+    FFS_DSS_MODEL_FIELD_JSON_VALUE //!< Raw JSON value handed back to the caller.
+} FFS_DSS_MODEL_FIELD_TYPE;
+
+struct FfsDssModelDescriptor_s;
+
+/** @brief Enumeration adapter.
+ */
+typedef struct {
+    FFS_RESULT (*parse)(const char *string, void *value); //!< Parse a string (NULL if not supported).
+    FFS_RESULT (*format)(const void *value, const char **string); //!< Format a value (NULL if not supported).
+} FfsDssModelEnumAdapter_t;
+
+/** @brief Hand-written field serializer.
+ *
+ * Serializes the separator, the key and the value of a field, or nothing at
+ * all if the field is empty.
+ */
+typedef FFS_RESULT (*FfsDssModelFieldSerializer_t)(const void *member, FfsStream_t *outputStream);
+
+/** @brief Type-specific field information.
+ */
+typedef union {
+    const struct FfsDssModelDescriptor_s *model; //!< Nested model (@ref FFS_DSS_MODEL_FIELD_OBJECT).
+    const FfsDssModelEnumAdapter_t *enumAdapter; //!< Enumeration adapter (@ref FFS_DSS_MODEL_FIELD_ENUM).
+    FfsDssModelFieldSerializer_t serializeField; //!< Field serializer (@ref FFS_DSS_MODEL_FIELD_CUSTOM).
+} FfsDssModelFieldExtension_t;
+
+/** @brief Field descriptor.
+ */
+typedef struct {
+    const char *key; //!< JSON key.
+    uint8_t keySize; //!< JSON key length.
+    uint8_t type; //!< @ref FFS_DSS_MODEL_FIELD_TYPE.
+    uint8_t jsonType; //!< Expected @ref FFS_JSON_TYPE.
+    uint8_t flags; //!< FFS_DSS_MODEL_FIELD_* flags.
+    uint16_t offset; //!< Member offset (captured value index for @ref FFS_DSS_MODEL_FIELD_JSON_VALUE).
+    uint16_t presenceOffset; //!< Offset of the "has field" flag (or @ref FFS_DSS_MODEL_NO_PRESENCE_FLAG).
+    FfsDssModelFieldExtension_t extension; //!< Type-specific information.
+} FfsDssModelField_t;
+
+/** @brief Model descriptor.
+ *
+ * The fields are in serialization order. The lookup table lists the field
+ * indices sorted by key length and then by key; the entries for keys of
+ * length \a n are lookup[lookupIndex[n]] up to lookup[lookupIndex[n + 1]].
+ */
+typedef struct FfsDssModelDescriptor_s {
+    const FfsDssModelField_t *fields; //!< Fields.
+    uint8_t fieldCount; //!< Field count.
+    uint8_t maximumKeySize; //!< Longest key length.
+    uint16_t objectSize; //!< Size of the model structure.
+    const uint8_t *lookup; //!< Field indices sorted by key.
+    const uint8_t *lookupIndex; //!< Lookup start for each key length (maximumKeySize + 2 entries).
+} FfsDssModelDescriptor_t;
+
+/** @brief Serialize a model object.
+ *
+ * @param model Model descriptor
+ * @param object Source object
+ * @param isEmpty Destination for "no field was serialized" (NULL to ignore)
+ * @param outputStream Output stream
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDssSerializeModel(const FfsDssModelDescriptor_t *model, const void *object, bool *isEmpty,
+        FfsStream_t *outputStream);
+
+/** @brief Start serializing a model object.
+ *
+ * Serialize the object start and the fields, leaving the object open so that
+ * the caller can append further fields.
+ *
+ * @param model Model descriptor
+ * @param object Source object
+ * @param outputStream Output stream
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDssStartSerializingModel(const FfsDssModelDescriptor_t *model, const void *object,
+        FfsStream_t *outputStream);
+
+/** @brief Deserialize a model object.
+ *
+ * The object is zeroed and the JSON object is parsed in a single pass.
+ * Unknown keys are ignored; duplicate keys and values of the wrong type fail.
+ *
+ * @param model Model descriptor
+ * @param objectValue Input JSON object value
+ * @param object Destination object
+ * @param capturedValues Destination for the @ref FFS_DSS_MODEL_FIELD_JSON_VALUE fields (NULL if none)
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDssDeserializeModel(const FfsDssModelDescriptor_t *model, FfsJsonValue_t *objectValue,
+        void *object, FfsJsonValue_t *capturedValues);
+
+/** @brief Find a field by key.
+ *
+ * @param model Model descriptor
+ * @param key Null-terminated key
+ *
+ * @returns Field descriptor (NULL if the key is unknown)
+ */
+const FfsDssModelField_t *ffsDssFindModelField(const FfsDssModelDescriptor_t *model, const char *key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FFS_DSS_MODEL_CODEC_H_ */
@@ -0,0 +1,100 @@
+/** @file ffs_dss_model_tables.h
+ *
+ * @brief DSS model field descriptor tables.
+ *
+ * Generated by libffs/tools/ffs_dss_model_generator.py from
+ * libffs/tools/ffs_dss_model_schema.json. Do not edit; change the schema and
+ * rebuild (or run the generator) instead.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#ifndef FFS_DSS_MODEL_TABLES_H_
+#define FFS_DSS_MODEL_TABLES_H_
+
+#include "ffs/dss/model/ffs_dss_model_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief ErrorDetails (@ref FfsDssErrorDetails_t) descriptor.
+ */
+extern const FfsDssModelDescriptor_t ffsDssErrorDetailsModel;
+
+/** @brief RegistrationDetails (@ref FfsDssRegistrationDetails_t) descriptor.
+ */
+extern const FfsDssModelDescriptor_t ffsDssRegistrationDetailsModel;
+
+/** @brief StartProvisioningSessionRequest (@ref FfsDssStartProvisioningSessionRequest_t) descriptor.
+ */
+extern const FfsDssModelDescriptor_t ffsDssStartProvisioningSessionRequestModel;
+
+/** @brief StartProvisioningSessionResponse (@ref FfsDssStartProvisioningSessionResponse_t) descriptor.
+ */
+extern const FfsDssModelDescriptor_t ffsDssStartProvisioningSessionResponseModel;
+
+/** @brief StartPinBasedSetupRequest (@ref FfsDssStartPinBasedSetupRequest_t) descriptor.
+ */
+extern const FfsDssModelDescriptor_t ffsDssStartPinBasedSetupRequestModel;
+
+/** @brief StartPinBasedSetupResponse (@ref FfsDssStartPinBasedSetupResponse_t) descriptor.
+ */
+extern const FfsDssModelDescriptor_t ffsDssStartPinBasedSetupResponseModel;
+
+/** @brief ComputeConfigurationDataRequest (@ref FfsDssComputeConfigurationDataRequest_t) descriptor.
+ */
+extern const FfsDssModelDescriptor_t ffsDssComputeConfigurationDataRequestModel;
+
+/** @brief ComputeConfigurationDataResponse (@ref FfsDssComputeConfigurationDataResponse_t) descriptor.
+ */
+extern const FfsDssModelDescriptor_t ffsDssComputeConfigurationDataResponseModel;
+
+/** @brief PostWifiScanDataRequest (@ref FfsDssPostWifiScanDataRequest_t) descriptor.
+ */
+extern const FfsDssModelDescriptor_t ffsDssPostWifiScanDataRequestModel;
+
+/** @brief PostWifiScanDataResponse (@ref FfsDssPostWifiScanDataResponse_t) descriptor.
+ */
+extern const FfsDssModelDescriptor_t ffsDssPostWifiScanDataResponseModel;
+
+/** @brief GetWifiCredentialsRequest (@ref FfsDssGetWifiCredentialsRequest_t) descriptor.
+ */
+extern const FfsDssModelDescriptor_t ffsDssGetWifiCredentialsRequestModel;
+
+/** @brief GetWifiCredentialsResponse (@ref FfsDssGetWifiCredentialsResponse_t) descriptor.
+ */
+extern const FfsDssModelDescriptor_t ffsDssGetWifiCredentialsResponseModel;
+
+/** @brief ReportRequest (@ref FfsDssReportRequest_t) descriptor.
+ */
+extern const FfsDssModelDescriptor_t ffsDssReportRequestModel;
+
+/** @brief ReportResponse (@ref FfsDssReportResponse_t) descriptor.
+ */
+extern const FfsDssModelDescriptor_t ffsDssReportResponseModel;
+
+/** @brief WifiScanResult (@ref FfsDssWifiScanResult_t) descriptor.
+ */
+extern const FfsDssModelDescriptor_t ffsDssWifiScanResultModel;
+
+/** @brief WifiConnectionAttempt (@ref FfsDssWifiConnectionAttempt_t) descriptor.
+ */
+extern const FfsDssModelDescriptor_t ffsDssWifiConnectionAttemptModel;
+
+/** @brief WifiConnectionDetails (@ref FfsDssWifiConnectionDetails_t) descriptor.
+ */
+extern const FfsDssModelDescriptor_t ffsDssWifiConnectionDetailsModel;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FFS_DSS_MODEL_TABLES_H_ */
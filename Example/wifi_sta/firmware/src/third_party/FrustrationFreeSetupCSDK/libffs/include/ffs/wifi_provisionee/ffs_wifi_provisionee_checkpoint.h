@@ -0,0 +1,205 @@
+/** @file ffs_wifi_provisionee_checkpoint.h
+ *
+ * @brief Wi-Fi provisionee checkpoint record.
+ *
+ * The Wi-Fi provisionee task saves a small checkpoint record through the
+ * client compatibility layer every time it moves to a state it can resume
+ * from. After a reset, the task reads the record back and continues the same
+ * DSS session from that state instead of starting a new one.
+ *
+ * The record holds the provisionee state, the DSS session ID and sequence
+ * number, the PIN salt, whether the setup network was the SOCKS network, and
+ * a log of the items received from the cloud so far (registration token,
+ * configuration values and Wi-Fi credentials), which is replayed through the
+ * compatibility layer on resume. The record ends with a CRC-32 of its content
+ * so that a torn or corrupted write is discarded rather than resumed.
+ *
+ * Record format (multi-byte values big-endian):
+ *
+ *     magic (4 bytes), version (1 byte), state (1 byte), resume count (1 byte),
+ *     flags (1 byte), DSS sequence number (4 bytes),
+ *     session ID length (2 bytes), session ID,
+ *     salt length (1 byte), salt,
+ *     item log length (2 bytes), item log,
+ *     CRC-32 of all the preceding bytes (4 bytes).
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#ifndef FFS_WIFI_PROVISIONEE_CHECKPOINT_H_
+#define FFS_WIFI_PROVISIONEE_CHECKPOINT_H_
+
+#include "ffs/common/ffs_configuration_map.h"
+#include "ffs/common/ffs_registration.h"
+#include "ffs/common/ffs_result.h"
+#include "ffs/common/ffs_stream.h"
+#include "ffs/common/ffs_wifi.h"
+#include "ffs/compat/ffs_user_context.h"
+#include "ffs/dss/ffs_dss_client.h"
+#include "ffs/dss/ffs_dss_operation_start_provisioning_session.h"
+#include "ffs/wifi_provisionee/ffs_wifi_provisionee_state.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if !defined(FFS_WIFI_PROVISIONEE_CHECKPOINT_ITEMS_SIZE)
+
+/** @brief Default size of the received item log.
+ *
+ * Enough for a registration token, the usual configuration values and a few
+ * Wi-Fi credentials. Checkpoints stop for the rest of the session if the log
+ * overflows.
+ */
+#define FFS_WIFI_PROVISIONEE_CHECKPOINT_ITEMS_SIZE          (640)
+
+#endif
+
+#if !defined(FFS_WIFI_PROVISIONEE_CHECKPOINT_MAXIMUM_RESUMES)
+
+/** @brief Default number of times a session is resumed before starting over.
+ *
+ * Bounds the reset loop of a device that crashes in the same state.
+ */
+#define FFS_WIFI_PROVISIONEE_CHECKPOINT_MAXIMUM_RESUMES     (3)
+
+#endif
+
+#if !defined(FFS_WIFI_PROVISIONEE_CHECKPOINT_SEQUENCE_GAP)
+
+/** @brief Default DSS sequence numbers skipped on resume.
+ *
+ * The record is saved on state transitions, so requests made after the last
+ * save may have reached the cloud. Skipping ahead keeps the resumed requests
+ * from reusing their sequence numbers.
+ */
+#define FFS_WIFI_PROVISIONEE_CHECKPOINT_SEQUENCE_GAP        (32)
+
+#endif
+
+/** @brief Record format version.
+ */
+#define FFS_WIFI_PROVISIONEE_CHECKPOINT_VERSION             (1)
+
+/** @brief Maximum configuration key length in the item log (not including the null terminator).
+ */
+#define FFS_WIFI_PROVISIONEE_CHECKPOINT_MAXIMUM_KEY_LENGTH  (63)
+
+/** @brief Maximum encoded record size.
+ */
+#define FFS_WIFI_PROVISIONEE_CHECKPOINT_MAXIMUM_SIZE        (12 + 2 + FFS_MAXIMUM_SESSION_ID_LENGTH + 1 \
+        + FFS_SALT_SIZE + 2 + FFS_WIFI_PROVISIONEE_CHECKPOINT_ITEMS_SIZE + 4)
+
+/** @brief Wi-Fi provisionee checkpoint.
+ *
+ * The streams are not consumed by @ref ffsEncodeWifiProvisioneeCheckpoint.
+ * @ref ffsDecodeWifiProvisioneeCheckpoint sets them to input streams over the
+ * record data.
+ */
+typedef struct {
+    FFS_WIFI_PROVISIONEE_STATE state; //!< Provisionee state to resume.
+    uint8_t resumeCount; //!< Number of times the session was resumed.
+    bool connectedToSocksNetwork; //!< Was the setup network the SOCKS network?
+    int32_t sequenceNumber; //!< DSS sequence number.
+    FfsStream_t sessionIdStream; //!< DSS session ID (no null terminator).
+    FfsStream_t saltStream; //!< PIN salt.
+    FfsStream_t itemsStream; //!< Log of the items received from the cloud.
+} FfsWifiProvisioneeCheckpoint_t;
+
+/** @brief Get the state to resume a checkpointed state from.
+ *
+ * Only states with an open DSS session can be resumed. A device that reset
+ * after joining the user network has to join it again, so
+ * "connected to user network" resumes from "connecting to user network".
+ *
+ * @param state Checkpointed state
+ * @param resumeState Destination state
+ *
+ * @returns true if the state can be resumed
+ */
+bool ffsGetWifiProvisioneeCheckpointResumeState(FFS_WIFI_PROVISIONEE_STATE state,
+        FFS_WIFI_PROVISIONEE_STATE *resumeState);
+
+/** @brief Append received Wi-Fi credentials to the item log.
+ *
+ * @param itemsStream Item log output stream
+ * @param wifiConfiguration Wi-Fi configuration
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsWifiProvisioneeCheckpointAddWifiConfiguration(FfsStream_t *itemsStream,
+        FfsWifiConfiguration_t *wifiConfiguration);
+
+/** @brief Append a received configuration value to the item log.
+ *
+ * @param itemsStream Item log output stream
+ * @param key Configuration key
+ * @param value Configuration value
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsWifiProvisioneeCheckpointAddConfigurationValue(FfsStream_t *itemsStream, const char *key,
+        FfsMapValue_t *value);
+
+/** @brief Append a received registration token to the item log.
+ *
+ * @param itemsStream Item log output stream
+ * @param registrationRequest Registration request
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsWifiProvisioneeCheckpointAddRegistrationToken(FfsStream_t *itemsStream,
+        FfsRegistrationRequest_t *registrationRequest);
+
+/** @brief Replay an item log through the compatibility layer.
+ *
+ * Calls @ref ffsSetRegistrationToken, @ref ffsSetConfigurationValue and
+ * @ref ffsAddWifiConfiguration for the logged items, in order.
+ *
+ * @param userContext User context
+ * @param itemsStream Item log (not consumed)
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsReplayWifiProvisioneeCheckpointItems(struct FfsUserContext_s *userContext,
+        FfsStream_t *itemsStream);
+
+/** @brief Encode a checkpoint record.
+ *
+ * @param checkpoint Checkpoint
+ * @param outputStream Destination stream
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsEncodeWifiProvisioneeCheckpoint(const FfsWifiProvisioneeCheckpoint_t *checkpoint,
+        FfsStream_t *outputStream);
+
+/** @brief Decode and validate a checkpoint record.
+ *
+ * Fails with @ref FFS_ERROR if the magic, the version, the CRC or any field
+ * is invalid. The checkpoint streams point into the record data.
+ *
+ * @param inputStream Record stream
+ * @param checkpoint Destination checkpoint
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsDecodeWifiProvisioneeCheckpoint(FfsStream_t *inputStream,
+        FfsWifiProvisioneeCheckpoint_t *checkpoint);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FFS_WIFI_PROVISIONEE_CHECKPOINT_H_ */
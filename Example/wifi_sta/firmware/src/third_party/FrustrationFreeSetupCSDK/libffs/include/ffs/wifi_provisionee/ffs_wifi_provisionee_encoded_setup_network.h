@@ -18,10 +18,38 @@
 #include "ffs/common/ffs_result.h"
 #include "ffs/compat/ffs_user_context.h"
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define FFS_ENCODED_SETUP_NETWORK_CACHE_VERSION             (1) //!< Version of the serialized cache.
+#define FFS_ENCODED_SETUP_NETWORK_FINGERPRINT_SIZE          (8) //!< Key material fingerprint size.
+#define FFS_ENCODED_SETUP_NETWORK_AUTH_MATERIAL_INDEX_SIZE  (9) //!< Auth material index size.
+#define FFS_ENCODED_SETUP_NETWORK_SHARED_SECRET_SIZE        (32) //!< ECDH shared secret size.
+
+/** @brief Size of the serialized cache (version, fingerprint, index, secret).
+ */
+#define FFS_ENCODED_SETUP_NETWORK_CACHE_SIZE (1 \
+        + FFS_ENCODED_SETUP_NETWORK_FINGERPRINT_SIZE \
+        + FFS_ENCODED_SETUP_NETWORK_AUTH_MATERIAL_INDEX_SIZE \
+        + FFS_ENCODED_SETUP_NETWORK_SHARED_SECRET_SIZE)
+
+/** @brief Nonce-independent part of the encoded setup network.
+ *
+ * The auth material index (from the device public key hash) and the ECDH
+ * shared secret (from the cloud public key) never change for a device. They
+ * are cached under @ref FFS_CONFIGURATION_ENTRY_KEY_ENCODED_SETUP_NETWORK_CACHE
+ * together with a fingerprint of both public keys, which invalidates the
+ * cache when the key material changes.
+ */
+typedef struct {
+    uint8_t fingerprint[FFS_ENCODED_SETUP_NETWORK_FINGERPRINT_SIZE]; //!< Fingerprint of the public keys.
+    uint8_t authMaterialIndex[FFS_ENCODED_SETUP_NETWORK_AUTH_MATERIAL_INDEX_SIZE]; //!< Auth material index.
+    uint8_t sharedSecret[FFS_ENCODED_SETUP_NETWORK_SHARED_SECRET_SIZE]; //!< ECDH shared secret.
+} FfsEncodedSetupNetworkCache_t;
+
 /** @brief Compute the Amazon custom encoded setup network.
  *
  * This function may return ERROR in which case caller should choose different
@@ -35,6 +63,49 @@ extern "C" {
 FFS_RESULT ffsComputeAmazonCustomEncodedNetworkConfiguration(struct FfsUserContext_s *userContext,
         FfsWifiConfiguration_t *setupNetworkConfiguration);
 
+/** @brief Prepare the nonce-independent part of the encoded setup network.
+ *
+ * Reads the stored cache and checks its fingerprint against the current public
+ * keys. On a miss, hashes the device public key and runs the ECDH with the
+ * cloud public key, then stores the result. A client that does not store the
+ * cache entry only loses the caching. Can be called ahead of the provisionee
+ * task, \a e.g., while the Wi-Fi stack comes up.
+ *
+ * @param userContext User context
+ * @param cache Destination cache
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsPrepareAmazonCustomEncodedNetworkCache(struct FfsUserContext_s *userContext,
+        FfsEncodedSetupNetworkCache_t *cache);
+
+/** @brief Serialize a prepared cache.
+ *
+ * Writes the @ref FFS_ENCODED_SETUP_NETWORK_CACHE_SIZE bytes stored under
+ * @ref FFS_CONFIGURATION_ENTRY_KEY_ENCODED_SETUP_NETWORK_CACHE, \a e.g., to
+ * provision the cache on the factory line.
+ *
+ * @param cache Cache from @ref ffsPrepareAmazonCustomEncodedNetworkCache
+ * @param outputStream Destination stream
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsEncodeAmazonCustomEncodedNetworkCache(const FfsEncodedSetupNetworkCache_t *cache,
+        FfsStream_t *outputStream);
+
+/** @brief Compute the Amazon custom encoded setup network from a prepared cache.
+ *
+ * Only draws the nonce and computes the nonce-dependent HMAC and encodings.
+ *
+ * @param userContext User context
+ * @param cache Cache from @ref ffsPrepareAmazonCustomEncodedNetworkCache
+ * @param setupNetworkConfiguration A place to write The Wi-Fi Configuration.
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsComputeAmazonCustomEncodedNetworkConfigurationFromCache(struct FfsUserContext_s *userContext,
+        const FfsEncodedSetupNetworkCache_t *cache, FfsWifiConfiguration_t *setupNetworkConfiguration);
+
 #ifdef __cplusplus
 }
 #endif
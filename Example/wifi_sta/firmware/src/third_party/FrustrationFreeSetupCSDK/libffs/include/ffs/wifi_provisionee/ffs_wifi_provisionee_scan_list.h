@@ -0,0 +1,146 @@
+/** @file ffs_wifi_provisionee_scan_list.h
+ *
+ * @brief Deduplicated, ranked Wi-Fi scan result list.
+ *
+ * Scan results are buffered before they are posted to the cloud. Access
+ * points that advertise the same SSID with the same security protocol are
+ * merged into a single entry that keeps the strongest BSSID (and its
+ * frequency band). The entries are then ranked so that the networks most
+ * likely to have a saved cloud credential are posted in the first
+ * "post Wi-Fi scan data" pages.
+ *
+ * The whole scan set is collected and ranked before the first page is
+ * posted, so the capacity should be at least the number of scan results the
+ * client reports (FFS_WIFI_MAX_APS_SUPPORTED on Amazon FreeRTOS).
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#ifndef FFS_WIFI_PROVISIONEE_SCAN_LIST_H_
+#define FFS_WIFI_PROVISIONEE_SCAN_LIST_H_
+
+#include "ffs/common/ffs_result.h"
+#include "ffs/common/ffs_wifi.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if !defined(FFS_WIFI_PROVISIONEE_SCAN_LIST_CAPACITY)
+
+/** @brief Default number of distinct networks buffered before posting.
+ */
+#define FFS_WIFI_PROVISIONEE_SCAN_LIST_CAPACITY         (40)
+
+#endif
+
+#if !defined(FFS_WIFI_PROVISIONEE_SCAN_LIST_SECURED_BONUS)
+
+/** @brief Ranking bonus (in dB) given to WPA/PSK and WEP networks.
+ *
+ * Saved cloud credentials are almost always for secured home networks, while
+ * open networks are mostly public hotspots, so a secured network is ranked
+ * above a somewhat stronger open one.
+ */
+#define FFS_WIFI_PROVISIONEE_SCAN_LIST_SECURED_BONUS    (10)
+
+#endif
+
+/** @brief Scan list entry.
+ */
+typedef struct {
+    uint8_t ssid[FFS_MAXIMUM_SSID_SIZE]; //!< SSID.
+    size_t ssidSize; //!< SSID size.
+    uint8_t bssid[FFS_BSSID_SIZE]; //!< BSSID of the strongest access point.
+    FFS_WIFI_SECURITY_PROTOCOL securityProtocol; //!< Network security type.
+    int32_t frequencyBand; //!< Frequency band of the strongest access point.
+    int32_t signalStrength; //!< Strongest signal strength in dB.
+    uint32_t bssidCount; //!< Number of scan results merged into this entry.
+} FfsWifiProvisioneeScanListEntry_t;
+
+/** @brief Scan list.
+ */
+typedef struct FfsWifiProvisioneeScanList_s {
+    FfsWifiProvisioneeScanListEntry_t *entries; //!< Client-allocated entry storage.
+    size_t capacity; //!< Number of entries in the storage.
+    size_t count; //!< Number of entries in use.
+    size_t nextIndex; //!< Index of the next entry to post.
+    uint32_t duplicateCount; //!< Scan results merged into an existing entry.
+    uint32_t droppedCount; //!< Networks dropped because the list was full.
+} FfsWifiProvisioneeScanList_t;
+
+/** @brief Initialize a scan list over client-allocated storage.
+ *
+ * @param scanList Scan list to initialize
+ * @param entries Entry storage
+ * @param capacity Number of entries in the storage
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsInitializeWifiProvisioneeScanList(FfsWifiProvisioneeScanList_t *scanList,
+        FfsWifiProvisioneeScanListEntry_t *entries, size_t capacity);
+
+/** @brief Add a scan result.
+ *
+ * A result with the SSID and security protocol of an existing entry is merged
+ * into it. When the list is full, the lowest-ranked entry is replaced if the
+ * new result ranks above it; otherwise the new result is dropped.
+ *
+ * @param scanList Scan list
+ * @param wifiScanResult Scan result to add (streams are not modified)
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsWifiProvisioneeScanListAdd(FfsWifiProvisioneeScanList_t *scanList,
+        FfsWifiScanResult_t *wifiScanResult);
+
+/** @brief Sort the entries by rank and restart iteration.
+ *
+ * Entries are ordered by signal strength plus
+ * \ref FFS_WIFI_PROVISIONEE_SCAN_LIST_SECURED_BONUS for secured networks.
+ * Ties keep scan order.
+ *
+ * @param scanList Scan list
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsWifiProvisioneeScanListRank(FfsWifiProvisioneeScanList_t *scanList);
+
+/** @brief Get the next entry to post without consuming it.
+ *
+ * The SSID and BSSID streams of the result are input streams over the entry
+ * storage.
+ *
+ * @param scanList Scan list
+ * @param wifiScanResult Destination scan result
+ * @param isUnderrun Set to true when every entry has been consumed
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsWifiProvisioneeScanListPeek(FfsWifiProvisioneeScanList_t *scanList,
+        FfsWifiScanResult_t *wifiScanResult, bool *isUnderrun);
+
+/** @brief Consume the entry returned by \ref ffsWifiProvisioneeScanListPeek.
+ *
+ * @param scanList Scan list
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsWifiProvisioneeScanListAdvance(FfsWifiProvisioneeScanList_t *scanList);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FFS_WIFI_PROVISIONEE_SCAN_LIST_H_ */
@@ -22,14 +22,16 @@
 extern "C" {
 #endif
 
-/** @brief Connect to the Wi-Fi FFS setup network.
+/** @brief Start connecting to the Wi-Fi FFS setup network.
+ *
+ * Follow the attempt with @ref ffsGetWifiConnectionDetails.
  *
  * @param userContext User context
  * @param setupWifiConfiguration The wifi configuration to use.
  *
  * @returns Enumerated [result](@ref FFS_RESULT)
  */
-FFS_RESULT ffsConnectToSetupNetwork(struct FfsUserContext_s *userContext, FfsWifiConfiguration_t *setupWifiConfiguration);
+FFS_RESULT ffsStartConnectingToSetupNetwork(struct FfsUserContext_s *userContext, FfsWifiConfiguration_t *setupWifiConfiguration);
 
 /** @brief Disconnect from the Wi-Fi FFS setup network.
  *
@@ -17,14 +17,41 @@
 
 #include "ffs/common/ffs_result.h"
 #include "ffs/compat/ffs_user_context.h"
-#include "ffs/dss/ffs_dss_client.h"
-#include "ffs/wifi_provisionee/ffs_wifi_provisionee_state.h"
+
+#include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** @brief Wi-Fi provisionee state machine context (opaque).
+ *
+ * The library owns the context and all of its buffers; only one state
+ * machine runs at a time.
+ */
+typedef struct FfsWifiProvisioneeContext_s FfsWifiProvisioneeContext_t;
+
+/** @brief Events the Wi-Fi provisionee state machine waits for.
+ */
+typedef enum {
+    FFS_WIFI_PROVISIONEE_EVENT_NONE = 0, //!< No event; step again right away.
+    FFS_WIFI_PROVISIONEE_EVENT_HTTP, //!< An HTTP operation completed.
+    FFS_WIFI_PROVISIONEE_EVENT_WIFI //!< The Wi-Fi connection state changed.
+} FFS_WIFI_PROVISIONEE_EVENT;
+
+/** @brief Status of the Wi-Fi provisionee state machine after a step.
+ */
+typedef struct {
+    bool isDone; //!< The state machine stopped; there are no more steps.
+    FFS_WIFI_PROVISIONEE_EVENT awaitedEvent; //!< Event to step on next, or none to step again right away.
+    uint32_t deadlineMs; //!< Time to step by if the awaited event does not come, in the caller's clock.
+} FfsWifiProvisioneeStepStatus_t;
+
 /** @brief The Ffs Wi-Fi provisionee task.
+ *
+ * Runs the state machine to the end, waiting for each network operation in
+ * turn.
  *
  * @param userContext User context
  *
@@ -32,6 +59,46 @@ extern "C" {
  */
 FFS_RESULT ffsWifiProvisioneeTask(struct FfsUserContext_s *userContext);
 
+/** @brief Initialize the Wi-Fi provisionee state machine.
+ *
+ * Fails if a state machine is already running.
+ *
+ * @param userContext User context
+ * @param context Destination state machine context
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsWifiProvisioneeInit(struct FfsUserContext_s *userContext, FfsWifiProvisioneeContext_t **context);
+
+/** @brief Release the Wi-Fi provisionee state machine.
+ *
+ * Cancels the DSS request in flight, if any.
+ *
+ * @param context State machine context
+ */
+void ffsWifiProvisioneeDeinit(FfsWifiProvisioneeContext_t *context);
+
+/** @brief Advance the Wi-Fi provisionee state machine.
+ *
+ * The first steps resume the session of the last checkpoint, if any; the
+ * following ones execute the provisionee states. A step never waits on the
+ * network: it starts the Wi-Fi connection or DSS request its state needs and
+ * returns the event to wait for and a deadline. Step again when that event
+ * comes or once the deadline has passed, whichever is first; an operation
+ * still running at its deadline fails with @ref FFS_TIMEOUT. A step on any
+ * other event only checks the deadline. Once the state machine is done, or a
+ * step failed, the following steps only report that it is done.
+ *
+ * @param context State machine context
+ * @param event Event that occurred, or @ref FFS_WIFI_PROVISIONEE_EVENT_NONE
+ * @param nowMs Current time in milliseconds, from any free-running clock
+ * @param status Destination status
+ *
+ * @returns Enumerated [result](@ref FFS_RESULT)
+ */
+FFS_RESULT ffsWifiProvisioneeStep(FfsWifiProvisioneeContext_t *context, FFS_WIFI_PROVISIONEE_EVENT event,
+        uint32_t nowMs, FfsWifiProvisioneeStepStatus_t *status);
+
 #ifdef __cplusplus
 }
 #endif
@@ -22,13 +22,15 @@
 extern "C" {
 #endif
 
-/** @brief Connect to the list of user networks.
+/** @brief Start connecting to the list of user networks.
+ *
+ * Follow the attempts with @ref ffsGetWifiConnectionDetails.
  *
  * @param userContext User context
  *
  * @returns Enumerated [result](@ref FFS_RESULT)
  */
-FFS_RESULT ffsConnectToUserNetworks(struct FfsUserContext_s *userContext);
+FFS_RESULT ffsStartConnectingToUserNetworks(struct FfsUserContext_s *userContext);
 
 #ifdef __cplusplus
 }
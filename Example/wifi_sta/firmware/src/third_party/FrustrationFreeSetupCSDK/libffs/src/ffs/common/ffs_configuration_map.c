@@ -40,3 +40,4 @@ const char *FFS_CONFIGURATION_ENTRY_KEY_PRODUCT_INDEX =                "DeviceIn
 const char *FFS_CONFIGURATION_ENTRY_KEY_SOFTWARE_VERSION_INDEX =       "DeviceInformation.SoftwareVersionIndex"; //!< Software version index, \a e.g., "00".
 const char *FFS_CONFIGURATION_ENTRY_KEY_DEVICE_EC_PUBLIC_KEY_DER =        "DeviceInformation.PublicKey"; //!< Device public key in raw DER encoded bytes, \a It will be 256bit EC public key. When DER encoded it becomes 91 bytes.
 const char *FFS_CONFIGURATION_ENTRY_KEY_CLOUD_EC_PUBLIC_KEY_DER =         "DSS.PublicKey"; //!< Cloud service public key in raw DER encoded bytes, \a It will be 256bit EC public key. When DER encoded it becomes 91 bytes.
+const char *FFS_CONFIGURATION_ENTRY_KEY_ENCODED_SETUP_NETWORK_CACHE =    "FFS.EncodedSetupNetworkCache"; //!< Cached nonce-independent part of the encoded setup network, in bytes.
@@ -0,0 +1,450 @@
+/** @file ffs_dns_cache.c
+ *
+ * @brief DNS answer cache implementation.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_check_result.h"
+#include "ffs/common/ffs_dns_cache.h"
+#include "ffs/common/ffs_logging.h"
+
+#include <ctype.h>
+#include <string.h>
+
+/** Is the given time at or after the reference time (wrap-safe)? */
+#define FFS_DNS_CACHE_TIME_REACHED(nowMs, referenceMs) ((int32_t) ((uint32_t) (nowMs) - (uint32_t) (referenceMs)) >= 0)
+
+/* Static function prototypes. */
+static FfsDnsCacheEntry_t *ffsDnsCacheFindEntry(FfsDnsCache_t *cache, FfsStream_t *hostStream);
+static FfsDnsCacheEntry_t *ffsDnsCacheAllocateEntry(FfsDnsCache_t *cache, uint32_t nowMs);
+static FFS_RESULT ffsDnsCacheStoreEntry(FfsDnsCache_t *cache, FfsStream_t *hostStream, const char *address,
+        bool isNegative, uint32_t ttlMs, uint32_t resolveDurationMs, uint32_t nowMs);
+static bool ffsDnsCacheEntryIsExpired(FfsDnsCacheEntry_t *entry, uint32_t nowMs);
+static void ffsDnsCacheClearEntry(FfsDnsCacheEntry_t *entry);
+static FFS_RESULT ffsDnsCacheWriteUint32(uint32_t value, FfsStream_t *outputStream);
+static FFS_RESULT ffsDnsCacheReadUint32(FfsStream_t *inputStream, uint32_t *value);
+static FFS_RESULT ffsDnsCacheReadString(FfsStream_t *inputStream, size_t maximumLength, FfsStream_t *stringStream);
+
+/*
+ * Initialize a DNS cache over client-allocated storage.
+ */
+FFS_RESULT ffsInitializeDnsCache(FfsDnsCache_t *cache, FfsDnsCacheEntry_t *entries, size_t entryCount)
+{
+    if (!cache || !entries || !entryCount) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    memset(cache, 0, sizeof(*cache));
+    memset(entries, 0, sizeof(*entries) * entryCount);
+
+    cache->entries = entries;
+    cache->entryCount = entryCount;
+    cache->negativeTtlMs = FFS_DNS_CACHE_DEFAULT_NEGATIVE_TTL_MS;
+    cache->minimumTtlMs = FFS_DNS_CACHE_DEFAULT_MINIMUM_TTL_MS;
+    cache->maximumTtlMs = FFS_DNS_CACHE_DEFAULT_MAXIMUM_TTL_MS;
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Look up a host.
+ */
+FFS_RESULT ffsDnsCacheLookup(FfsDnsCache_t *cache, FfsStream_t *hostStream, uint32_t nowMs,
+        FfsStream_t *addressStream, FFS_DNS_CACHE_LOOKUP_RESULT *lookupResult)
+{
+    FfsDnsCacheEntry_t *entry = ffsDnsCacheFindEntry(cache, hostStream);
+
+    *lookupResult = FFS_DNS_CACHE_MISS;
+
+    if (entry && ffsDnsCacheEntryIsExpired(entry, nowMs)) {
+        ffsDnsCacheClearEntry(entry);
+        cache->statistics.expirations++;
+        entry = NULL;
+    }
+
+    if (!entry) {
+        cache->statistics.misses++;
+        return FFS_SUCCESS;
+    }
+
+    entry->lastUsedTimeMs = nowMs;
+
+    if (entry->isNegative) {
+        cache->statistics.negativeHits++;
+        *lookupResult = FFS_DNS_CACHE_NEGATIVE_HIT;
+        return FFS_SUCCESS;
+    }
+
+    if (addressStream) {
+        FFS_CHECK_RESULT(ffsWriteStringToStream(entry->address, addressStream));
+    }
+
+    cache->statistics.hits++;
+    cache->statistics.timeSavedMs += entry->resolveDurationMs;
+    *lookupResult = FFS_DNS_CACHE_HIT;
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Insert or refresh a positive record.
+ */
+FFS_RESULT ffsDnsCacheInsert(FfsDnsCache_t *cache, FfsStream_t *hostStream, const char *address,
+        uint32_t ttlMs, uint32_t resolveDurationMs, uint32_t nowMs)
+{
+    if (!address || !*address || strlen(address) > FFS_DNS_CACHE_MAXIMUM_ADDRESS_LENGTH) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    if (ttlMs < cache->minimumTtlMs) {
+        ttlMs = cache->minimumTtlMs;
+    }
+    if (ttlMs > cache->maximumTtlMs) {
+        ttlMs = cache->maximumTtlMs;
+    }
+
+    cache->statistics.resolveCount++;
+    cache->statistics.resolveTimeMs += resolveDurationMs;
+
+    return ffsDnsCacheStoreEntry(cache, hostStream, address, false, ttlMs, resolveDurationMs, nowMs);
+}
+
+/*
+ * Insert or refresh a negative record.
+ */
+FFS_RESULT ffsDnsCacheInsertNegative(FfsDnsCache_t *cache, FfsStream_t *hostStream,
+        uint32_t resolveDurationMs, uint32_t nowMs)
+{
+    cache->statistics.resolveCount++;
+    cache->statistics.resolveTimeMs += resolveDurationMs;
+
+    return ffsDnsCacheStoreEntry(cache, hostStream, "", true, cache->negativeTtlMs, resolveDurationMs, nowMs);
+}
+
+/*
+ * Remove the record for a host, if any.
+ */
+FFS_RESULT ffsDnsCacheRemove(FfsDnsCache_t *cache, FfsStream_t *hostStream)
+{
+    FfsDnsCacheEntry_t *entry = ffsDnsCacheFindEntry(cache, hostStream);
+
+    if (entry) {
+        ffsDnsCacheClearEntry(entry);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Remove all negative records.
+ */
+FFS_RESULT ffsDnsCacheFlushNegative(FfsDnsCache_t *cache)
+{
+    for (size_t i = 0; i < cache->entryCount; i++) {
+        if (cache->entries[i].host[0] && cache->entries[i].isNegative) {
+            ffsDnsCacheClearEntry(&cache->entries[i]);
+        }
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Remove all records.
+ */
+FFS_RESULT ffsDnsCacheClear(FfsDnsCache_t *cache)
+{
+    for (size_t i = 0; i < cache->entryCount; i++) {
+        ffsDnsCacheClearEntry(&cache->entries[i]);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Serialize the unexpired positive records.
+ *
+ * Format: version (1 byte), record count (1 byte), then for each record the
+ * host length (1 byte), host, address length (1 byte), address, remaining
+ * time-to-live in milliseconds (4 bytes, big-endian) and resolve duration in
+ * milliseconds (4 bytes, big-endian).
+ */
+FFS_RESULT ffsDnsCacheSerialize(FfsDnsCache_t *cache, uint32_t nowMs, FfsStream_t *outputStream)
+{
+    size_t recordCount = 0;
+
+    for (size_t i = 0; i < cache->entryCount; i++) {
+        FfsDnsCacheEntry_t *entry = &cache->entries[i];
+        if (entry->host[0] && !entry->isNegative && !ffsDnsCacheEntryIsExpired(entry, nowMs)) {
+            recordCount++;
+        }
+    }
+
+    if (recordCount > UINT8_MAX) {
+        recordCount = UINT8_MAX;
+    }
+
+    FFS_CHECK_RESULT(ffsWriteByteToStream(FFS_DNS_CACHE_SERIALIZED_VERSION, outputStream));
+    FFS_CHECK_RESULT(ffsWriteByteToStream((uint8_t) recordCount, outputStream));
+
+    for (size_t i = 0; i < cache->entryCount && recordCount; i++) {
+        FfsDnsCacheEntry_t *entry = &cache->entries[i];
+        if (!entry->host[0] || entry->isNegative || ffsDnsCacheEntryIsExpired(entry, nowMs)) {
+            continue;
+        }
+
+        size_t hostLength = strlen(entry->host);
+        size_t addressLength = strlen(entry->address);
+
+        FFS_CHECK_RESULT(ffsWriteByteToStream((uint8_t) hostLength, outputStream));
+        FFS_CHECK_RESULT(ffsWriteStream((const uint8_t *) entry->host, hostLength, outputStream));
+        FFS_CHECK_RESULT(ffsWriteByteToStream((uint8_t) addressLength, outputStream));
+        FFS_CHECK_RESULT(ffsWriteStream((const uint8_t *) entry->address, addressLength, outputStream));
+        FFS_CHECK_RESULT(ffsDnsCacheWriteUint32(entry->expiryTimeMs - nowMs, outputStream));
+        FFS_CHECK_RESULT(ffsDnsCacheWriteUint32(entry->resolveDurationMs, outputStream));
+
+        recordCount--;
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Restore records from a serialized cache.
+ */
+FFS_RESULT ffsDnsCacheDeserialize(FfsDnsCache_t *cache, uint32_t nowMs, FfsStream_t *inputStream)
+{
+    // Validate the whole input before touching the cache.
+    FfsStream_t validationStream = *inputStream;
+    uint8_t *version;
+    uint8_t *recordCount;
+
+    FFS_CHECK_RESULT(ffsReadStream(&validationStream, 1, &version));
+    if (*version != FFS_DNS_CACHE_SERIALIZED_VERSION) {
+        ffsLogWarning("Unsupported DNS cache version %u", *version);
+        FFS_FAIL(FFS_ERROR);
+    }
+    FFS_CHECK_RESULT(ffsReadStream(&validationStream, 1, &recordCount));
+
+    for (size_t i = 0; i < *recordCount; i++) {
+        FfsStream_t stringStream;
+        uint32_t value;
+
+        FFS_CHECK_RESULT(ffsDnsCacheReadString(&validationStream, FFS_DNS_CACHE_MAXIMUM_HOST_LENGTH, &stringStream));
+        FFS_CHECK_RESULT(ffsDnsCacheReadString(&validationStream, FFS_DNS_CACHE_MAXIMUM_ADDRESS_LENGTH, &stringStream));
+        FFS_CHECK_RESULT(ffsDnsCacheReadUint32(&validationStream, &value));
+        FFS_CHECK_RESULT(ffsDnsCacheReadUint32(&validationStream, &value));
+    }
+
+    // Apply the records.
+    FFS_CHECK_RESULT(ffsReadStream(inputStream, 2, &version));
+
+    for (size_t i = 0; i < *recordCount; i++) {
+        FfsStream_t hostStream;
+        FfsStream_t addressStream;
+        char address[FFS_DNS_CACHE_MAXIMUM_ADDRESS_LENGTH + 1];
+        uint32_t ttlMs;
+        uint32_t resolveDurationMs;
+
+        FFS_CHECK_RESULT(ffsDnsCacheReadString(inputStream, FFS_DNS_CACHE_MAXIMUM_HOST_LENGTH, &hostStream));
+        FFS_CHECK_RESULT(ffsDnsCacheReadString(inputStream, FFS_DNS_CACHE_MAXIMUM_ADDRESS_LENGTH, &addressStream));
+        FFS_CHECK_RESULT(ffsDnsCacheReadUint32(inputStream, &ttlMs));
+        FFS_CHECK_RESULT(ffsDnsCacheReadUint32(inputStream, &resolveDurationMs));
+
+        if (!FFS_STREAM_DATA_SIZE(hostStream) || !FFS_STREAM_DATA_SIZE(addressStream) || !ttlMs) {
+            continue;
+        }
+
+        memcpy(address, FFS_STREAM_NEXT_READ(addressStream), FFS_STREAM_DATA_SIZE(addressStream));
+        address[FFS_STREAM_DATA_SIZE(addressStream)] = '\0';
+
+        // Restored records keep their remaining time-to-live (no clamping).
+        FFS_CHECK_RESULT(ffsDnsCacheStoreEntry(cache, &hostStream, address, false, ttlMs, resolveDurationMs,
+                nowMs));
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Log the cache statistics.
+ */
+void ffsDnsCacheLogStatistics(FfsDnsCache_t *cache)
+{
+    FfsDnsCacheStatistics_t *statistics = &cache->statistics;
+
+    ffsLogInfo("DNS cache: %u hits, %u negative hits, %u misses, %u expirations, %u evictions",
+            (unsigned int) statistics->hits, (unsigned int) statistics->negativeHits,
+            (unsigned int) statistics->misses, (unsigned int) statistics->expirations,
+            (unsigned int) statistics->evictions);
+    ffsLogInfo("DNS cache: %u resolutions took %lu ms, hits saved ~%lu ms",
+            (unsigned int) statistics->resolveCount, (unsigned long) statistics->resolveTimeMs,
+            (unsigned long) statistics->timeSavedMs);
+}
+
+/*
+ * Find the record for a host (case-insensitive).
+ */
+static FfsDnsCacheEntry_t *ffsDnsCacheFindEntry(FfsDnsCache_t *cache, FfsStream_t *hostStream)
+{
+    size_t hostLength = FFS_STREAM_DATA_SIZE(*hostStream);
+    const char *host = (const char *) FFS_STREAM_NEXT_READ(*hostStream);
+
+    if (!hostLength || hostLength > FFS_DNS_CACHE_MAXIMUM_HOST_LENGTH) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < cache->entryCount; i++) {
+        FfsDnsCacheEntry_t *entry = &cache->entries[i];
+        size_t j;
+
+        if (strlen(entry->host) != hostLength) {
+            continue;
+        }
+
+        for (j = 0; j < hostLength; j++) {
+            if (tolower((unsigned char) entry->host[j]) != tolower((unsigned char) host[j])) {
+                break;
+            }
+        }
+
+        if (j == hostLength) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Find a free record, reclaiming an expired one or evicting the least recently
+ * used one if necessary.
+ */
+static FfsDnsCacheEntry_t *ffsDnsCacheAllocateEntry(FfsDnsCache_t *cache, uint32_t nowMs)
+{
+    FfsDnsCacheEntry_t *leastRecentlyUsed = NULL;
+
+    for (size_t i = 0; i < cache->entryCount; i++) {
+        FfsDnsCacheEntry_t *entry = &cache->entries[i];
+
+        if (!entry->host[0]) {
+            return entry;
+        }
+
+        if (ffsDnsCacheEntryIsExpired(entry, nowMs)) {
+            ffsDnsCacheClearEntry(entry);
+            cache->statistics.expirations++;
+            return entry;
+        }
+
+        if (!leastRecentlyUsed
+                || (int32_t) (entry->lastUsedTimeMs - leastRecentlyUsed->lastUsedTimeMs) < 0) {
+            leastRecentlyUsed = entry;
+        }
+    }
+
+    ffsDnsCacheClearEntry(leastRecentlyUsed);
+    cache->statistics.evictions++;
+
+    return leastRecentlyUsed;
+}
+
+/*
+ * Insert or refresh a record.
+ */
+static FFS_RESULT ffsDnsCacheStoreEntry(FfsDnsCache_t *cache, FfsStream_t *hostStream, const char *address,
+        bool isNegative, uint32_t ttlMs, uint32_t resolveDurationMs, uint32_t nowMs)
+{
+    size_t hostLength = FFS_STREAM_DATA_SIZE(*hostStream);
+
+    if (!hostLength || hostLength > FFS_DNS_CACHE_MAXIMUM_HOST_LENGTH) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    FfsDnsCacheEntry_t *entry = ffsDnsCacheFindEntry(cache, hostStream);
+    if (!entry) {
+        entry = ffsDnsCacheAllocateEntry(cache, nowMs);
+        memcpy(entry->host, FFS_STREAM_NEXT_READ(*hostStream), hostLength);
+        entry->host[hostLength] = '\0';
+    }
+
+    strcpy(entry->address, address);
+    entry->isNegative = isNegative;
+    entry->expiryTimeMs = nowMs + ttlMs;
+    entry->lastUsedTimeMs = nowMs;
+    entry->resolveDurationMs = resolveDurationMs;
+
+    cache->statistics.insertions++;
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Has this record's time-to-live elapsed?
+ */
+static bool ffsDnsCacheEntryIsExpired(FfsDnsCacheEntry_t *entry, uint32_t nowMs)
+{
+    return FFS_DNS_CACHE_TIME_REACHED(nowMs, entry->expiryTimeMs);
+}
+
+/*
+ * Mark a record as unused.
+ */
+static void ffsDnsCacheClearEntry(FfsDnsCacheEntry_t *entry)
+{
+    memset(entry, 0, sizeof(*entry));
+}
+
+/*
+ * Write a big-endian 32-bit value.
+ */
+static FFS_RESULT ffsDnsCacheWriteUint32(uint32_t value, FfsStream_t *outputStream)
+{
+    FFS_CHECK_RESULT(ffsWriteByteToStream((uint8_t) (value >> 24), outputStream));
+    FFS_CHECK_RESULT(ffsWriteByteToStream((uint8_t) (value >> 16), outputStream));
+    FFS_CHECK_RESULT(ffsWriteByteToStream((uint8_t) (value >> 8), outputStream));
+    FFS_CHECK_RESULT(ffsWriteByteToStream((uint8_t) value, outputStream));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Read a big-endian 32-bit value.
+ */
+static FFS_RESULT ffsDnsCacheReadUint32(FfsStream_t *inputStream, uint32_t *value)
+{
+    uint8_t *data;
+
+    FFS_CHECK_RESULT(ffsReadStream(inputStream, 4, &data));
+
+    *value = ((uint32_t) data[0] << 24) | ((uint32_t) data[1] << 16) | ((uint32_t) data[2] << 8) | data[3];
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Read a length-prefixed string into an input stream over the source data.
+ */
+static FFS_RESULT ffsDnsCacheReadString(FfsStream_t *inputStream, size_t maximumLength, FfsStream_t *stringStream)
+{
+    uint8_t *length;
+    uint8_t *data;
+
+    FFS_CHECK_RESULT(ffsReadStream(inputStream, 1, &length));
+    if (*length > maximumLength) {
+        FFS_FAIL(FFS_ERROR);
+    }
+    FFS_CHECK_RESULT(ffsReadStream(inputStream, *length, &data));
+
+    *stringStream = ffsCreateInputStream(data, *length);
+
+    return FFS_SUCCESS;
+}
@@ -23,6 +23,21 @@
 #include <stdio.h>
 #include <string.h>
 
+#if !defined(FFS_JSON_NO_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+#define FFS_JSON_SCAN_SSE2
+#elif !defined(FFS_JSON_NO_SIMD) && defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define FFS_JSON_SCAN_NEON
+#endif
+
+/** @brief Machine word for the word-at-a-time string scan.
+ */
+typedef uintptr_t FfsJsonWord_t;
+
+#define FFS_JSON_WORD_ONES      ((FfsJsonWord_t) -1 / 0xff) //!< 0x01 in every byte.
+#define FFS_JSON_WORD_HIGHS     (FFS_JSON_WORD_ONES * 0x80) //!< 0x80 in every byte.
+
 /*
  * Static function prototypes.
  */
@@ -40,6 +55,9 @@ static FFS_RESULT ffsParseJsonArrayValue(FfsJsonValue_t *sourceValue, FfsJsonVal
 static FFS_RESULT ffsParseJsonLiteral(FfsJsonValue_t *sourceValue, FfsStream_t *destinationStream);
 static bool ffsIsJsonWhitespace(uint8_t character);
 static FFS_RESULT ffsEncodeJsonUnicodeCharacter(uint8_t byte, FfsStream_t *destinationStream);
+static FFS_RESULT ffsReadJsonPlainBytes(FfsStream_t *sourceStream, uint8_t **plainBytes, size_t *plainBytesSize);
+static bool ffsJsonWordHasSpecialByte(FfsJsonWord_t word);
+static bool ffsIsJsonSpecialByte(uint8_t byte);
 
 #define FFS_JSON_NULL_STRING "null"
 
@@ -371,6 +389,70 @@ FFS_RESULT ffsReadJsonStringCharacter(FfsJsonValue_t *sourceValue, uint32_t *nex
     return FFS_SUCCESS;
 }
 
+/*
+ * Count the plain bytes at the start of a JSON string.
+ */
+size_t ffsScanJsonPlainBytes(const uint8_t *data, size_t dataSize)
+{
+    size_t index = 0;
+
+    // Escapes often come in runs; do not set up a block scan for them.
+    if (!dataSize || ffsIsJsonSpecialByte(data[0])) {
+        return 0;
+    }
+
+    // 16 bytes at a time, up to the block holding the first special byte.
+#if defined(FFS_JSON_SCAN_SSE2)
+    const __m128i quotes = _mm_set1_epi8('"');
+    const __m128i backslashes = _mm_set1_epi8('\\');
+    const __m128i spaces = _mm_set1_epi8(' ');
+
+    for (; index + sizeof(__m128i) <= dataSize; index += sizeof(__m128i)) {
+        __m128i bytes = _mm_loadu_si128((const __m128i *) (data + index));
+
+        // Signed comparison: non-ASCII bytes are negative, so "less than a space" too.
+        __m128i special = _mm_or_si128(_mm_cmplt_epi8(bytes, spaces),
+                _mm_or_si128(_mm_cmpeq_epi8(bytes, quotes), _mm_cmpeq_epi8(bytes, backslashes)));
+        if (_mm_movemask_epi8(special)) {
+            break;
+        }
+    }
+#elif defined(FFS_JSON_SCAN_NEON)
+    const int8x16_t quotes = vdupq_n_s8('"');
+    const int8x16_t backslashes = vdupq_n_s8('\\');
+    const int8x16_t spaces = vdupq_n_s8(' ');
+
+    for (; index + sizeof(int8x16_t) <= dataSize; index += sizeof(int8x16_t)) {
+        int8x16_t bytes = vld1q_s8((const int8_t *) (data + index));
+
+        // Signed comparison: non-ASCII bytes are negative, so "less than a space" too.
+        uint8x16_t special = vorrq_u8(vcltq_s8(bytes, spaces),
+                vorrq_u8(vceqq_s8(bytes, quotes), vceqq_s8(bytes, backslashes)));
+        if (vmaxvq_u8(special)) {
+            break;
+        }
+    }
+#endif
+
+    // A word at a time.
+    for (; index + sizeof(FfsJsonWord_t) <= dataSize; index += sizeof(FfsJsonWord_t)) {
+        FfsJsonWord_t word;
+        memcpy(&word, data + index, sizeof(word));
+        if (ffsJsonWordHasSpecialByte(word)) {
+            break;
+        }
+    }
+
+    // Locate the special byte in the last word, or scan the tail.
+    for (; index < dataSize; index++) {
+        if (ffsIsJsonSpecialByte(data[index])) {
+            break;
+        }
+    }
+
+    return index;
+}
+
 /*
  * Read a JSON string as UTF-8.
  */
@@ -378,9 +460,15 @@ FFS_RESULT ffsReadJsonStringAsUtf8(FfsJsonValue_t *sourceValue, FfsStream_t *des
 {
     uint32_t nextCharacter;
     bool isDone;
+    uint8_t *plainBytes;
+    size_t plainBytesSize;
 
     for (;;) {
 
+        // Copy plain ASCII as it is.
+        FFS_CHECK_RESULT(ffsReadJsonPlainBytes(&sourceValue->valueStream, &plainBytes, &plainBytesSize));
+        FFS_CHECK_RESULT(ffsWriteStream(plainBytes, plainBytesSize, destinationStream));
+
         // Read the next code-point.
         FFS_CHECK_RESULT(ffsReadJsonStringCharacter(sourceValue, &nextCharacter, NULL, &isDone));
         if (isDone) {
@@ -792,9 +880,20 @@ FFS_RESULT ffsEncodeJsonStringValue(const char *valueString, FfsStream_t *destin
 FFS_RESULT ffsEncodeJsonString(FfsStream_t *sourceStream, FfsStream_t *destinationStream)
 {
     uint8_t *nextCharacter;
+    uint8_t *plainBytes;
+    size_t plainBytesSize;
 
     while(!ffsStreamIsEmpty(sourceStream)) {
 
+        // Copy the characters that need no escaping in one block.
+        FFS_CHECK_RESULT(ffsReadJsonPlainBytes(sourceStream, &plainBytes, &plainBytesSize));
+        if (plainBytesSize) {
+            FFS_CHECK_RESULT(ffsWriteStream(plainBytes, plainBytesSize, destinationStream));
+            if (ffsStreamIsEmpty(sourceStream)) {
+                break;
+            }
+        }
+
         // Read the next character.
         FFS_CHECK_RESULT(ffsReadStream(sourceStream, 1, &nextCharacter));
 
@@ -878,6 +977,7 @@ static FFS_RESULT ffsParseJsonStringValue(FfsJsonValue_t *sourceValue, FfsJsonVa
 
     // Iterate to the final quote.
     do {
+        FFS_CHECK_RESULT(ffsReadJsonPlainBytes(&sourceValue->valueStream, NULL, NULL));
         end = FFS_STREAM_NEXT_READ(sourceValue->valueStream);
         FFS_CHECK_RESULT(ffsReadJsonStringCharacter(sourceValue, &nextCharacter, &isEscaped, &isDone));
         if (isDone) {
@@ -965,6 +1065,10 @@ static FFS_RESULT ffsParseJsonObjectValue(FfsJsonValue_t *sourceValue, FfsJsonVa
 
     // Iterate to the final bracket.
     do {
+        // Skip the plain characters of strings.
+        if (isString) {
+            FFS_CHECK_RESULT(ffsReadJsonPlainBytes(&sourceValue->valueStream, NULL, NULL));
+        }
         end = FFS_STREAM_NEXT_READ(sourceValue->valueStream);
         FFS_CHECK_RESULT(ffsReadJsonStringCharacter(sourceValue, &nextCharacter, &isEscaped, &isDone));
         if (isDone) {
@@ -1011,6 +1115,10 @@ static FFS_RESULT ffsParseJsonArrayValue(FfsJsonValue_t *sourceValue, FfsJsonVal
 
     // Iterate to the final bracket.
     do {
+        // Skip the plain characters of strings.
+        if (isString) {
+            FFS_CHECK_RESULT(ffsReadJsonPlainBytes(&sourceValue->valueStream, NULL, NULL));
+        }
         end = FFS_STREAM_NEXT_READ(sourceValue->valueStream);
         FFS_CHECK_RESULT(ffsReadJsonStringCharacter(sourceValue, &nextCharacter, &isEscaped, &isDone));
         if (isDone) {
@@ -1135,3 +1243,40 @@ static FFS_RESULT ffsEncodeJsonUnicodeCharacter(uint8_t byte, FfsStream_t *desti
 
     return FFS_SUCCESS;
 }
+
+/** @brief Read the plain bytes at the start of a stream (see @ref ffsScanJsonPlainBytes).
+ */
+static FFS_RESULT ffsReadJsonPlainBytes(FfsStream_t *sourceStream, uint8_t **plainBytes, size_t *plainBytesSize)
+{
+    size_t size = ffsScanJsonPlainBytes(FFS_STREAM_NEXT_READ(*sourceStream), FFS_STREAM_DATA_SIZE(*sourceStream));
+
+    FFS_CHECK_RESULT(ffsReadStream(sourceStream, size, plainBytes));
+    if (plainBytesSize) {
+        *plainBytesSize = size;
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Does a word hold a quote, a backslash, a control character or a non-ASCII byte?
+ *
+ * Subtracting n from every byte borrows into the high bit of the bytes below
+ * n (for bytes below 0x80; the others have it set already), and a borrow only
+ * reaches the next byte from a byte that matches, so the test is exact.
+ */
+static bool ffsJsonWordHasSpecialByte(FfsJsonWord_t word)
+{
+    FfsJsonWord_t quotes = word ^ (FFS_JSON_WORD_ONES * '"');
+    FfsJsonWord_t backslashes = word ^ (FFS_JSON_WORD_ONES * '\\');
+    FfsJsonWord_t belowSpaces = word - FFS_JSON_WORD_ONES * ' ';
+    FfsJsonWord_t zeroes = (quotes - FFS_JSON_WORD_ONES) | (backslashes - FFS_JSON_WORD_ONES);
+
+    return (((belowSpaces | zeroes) & ~word) | word) & FFS_JSON_WORD_HIGHS;
+}
+
+/** @brief Is a byte a quote, a backslash, a control character or non-ASCII?
+ */
+static bool ffsIsJsonSpecialByte(uint8_t byte)
+{
+    return byte == (uint8_t) '"' || byte == (uint8_t) '\\' || byte < 0x20 || byte >= 0x80;
+}
@@ -39,8 +39,13 @@
 #define HTTPS_URL_PREFIX                        "https://"
 
 // Static function prototypes.
-static FFS_RESULT ffsDssClientHttpExecute(FfsDssClientContext_t *dssClientContext,
-        FfsHttpRequest_t *httpRequest, FfsDssHttpCallbackData_t *dssResponse);
+static FFS_RESULT ffsDssClientSendRequest(FfsDssClientContext_t *dssClientContext);
+static FFS_RESULT ffsDssClientCollectResponse(FfsDssClientContext_t *dssClientContext,
+        bool *isComplete);
+static FFS_RESULT ffsDssClientCheckResponse(FfsDssClientContext_t *dssClientContext,
+        FfsDssHttpCallbackData_t *dssResponse);
+static void ffsDssClientHandleCompletion(FfsHttpOperation_t *operation, FFS_RESULT result,
+        void *dssResponsePointer);
 static FFS_RESULT ffsDssClientSetDefaultHost(struct FfsUserContext_s *userContext,
         FfsStream_t *hostStream);
 static FFS_RESULT ffsExtractHostString(FfsStream_t *redirectUrlStream, FfsUrl_t *redirectUrl);
@@ -85,21 +90,37 @@ FFS_RESULT ffsDssClientExecute(FfsDssClientContext_t *dssClientContext,
         const FfsDssOperationData_t *dssOperation, FfsStream_t *bodyStream,
         void *callbackDataPointer)
 {
-    FFS_TEMPORARY_OUTPUT_STREAM(signatureStream, FFS_MAXIMUM_DER_SIGNATURE_SIZE);
+    FFS_CHECK_RESULT(ffsDssClientExecuteAsync(dssClientContext, dssOperation, bodyStream,
+            callbackDataPointer));
+    FFS_CHECK_RESULT(ffsDssClientWait(dssClientContext));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Start a request to the Device Setup Service without waiting for it.
+ */
+FFS_RESULT ffsDssClientExecuteAsync(FfsDssClientContext_t *dssClientContext,
+        const FfsDssOperationData_t *dssOperation, FfsStream_t *bodyStream,
+        void *callbackDataPointer)
+{
+    FfsDssClientRequest_t *request = &dssClientContext->request;
+
+    // One request at a time.
+    if (request->operation) {
+        ffsLogError("A DSS request is already in flight");
+        FFS_FAIL(FFS_ERROR);
+    }
 
     // Bump the sequence number.
     dssClientContext->sequenceNumber++;
 
     // Construct the HTTP request.
-    FfsHttpHeader_t contentTypeHeader = {
-        .nameStream = FFS_STRING_INPUT_STREAM(FFS_HTTP_HEADER_CONTENT_TYPE_NAME),
-        .valueStream = FFS_STRING_INPUT_STREAM(FFS_HTTP_HEADER_CONTENT_TYPE_VALUE)
-    };
-    FfsHttpHeader_t *headers[] = {
-        &contentTypeHeader,
-        NULL
-    };
-    FfsHttpRequest_t httpRequest = {
+    request->contentTypeHeader.nameStream = FFS_STRING_INPUT_STREAM(FFS_HTTP_HEADER_CONTENT_TYPE_NAME);
+    request->contentTypeHeader.valueStream = FFS_STRING_INPUT_STREAM(FFS_HTTP_HEADER_CONTENT_TYPE_VALUE);
+    request->headers[0] = &request->contentTypeHeader;
+    request->headers[1] = NULL;
+    request->httpRequest = (FfsHttpRequest_t) {
         .operation = FFS_HTTP_OPERATION_POST,
         .url = {
             .scheme = FFS_HTTP_SCHEME_HTTPS,
@@ -107,55 +128,93 @@ FFS_RESULT ffsDssClientExecute(FfsDssClientContext_t *dssClientContext,
             .hostStream = dssClientContext->hostStream,
             .path = dssOperation->path
         },
-        .headers = headers,
+        .headers = request->headers,
         .bodyStream = *bodyStream,
         .callbacks = dssOperation->httpCallbacks
     };
 
     // Initialize the response.
-    FfsDssHttpCallbackData_t dssResponse = {
+    request->signatureStream = ffsCreateOutputStream(request->signatureBuffer,
+            sizeof(request->signatureBuffer));
+    request->dssResponse = (FfsDssHttpCallbackData_t) {
         .dssClientContext = dssClientContext,
         .hasStatusCode = false,
         .hasSignature = false,
-        .signatureStream = &signatureStream,
+        .signatureStream = &request->signatureStream,
         .hasBody = false,
         .signatureIsVerified = false,
         .hasRedirect = false,
-        .redirectUrl = &httpRequest.url,
+        .redirectUrl = &request->httpRequest.url,
         .operationCallbackDataPointer = callbackDataPointer,
         .result = FFS_SUCCESS
     };
+    request->redirectCount = 0;
 
-    // Execute the request.
-    FFS_CHECK_RESULT(ffsDssClientHttpExecute(dssClientContext, &httpRequest, &dssResponse));
+    // Send the request.
+    FFS_CHECK_RESULT(ffsDssClientSendRequest(dssClientContext));
 
-    // Did a handler fail?
-    FFS_CHECK_RESULT(dssResponse.result);
+    return FFS_SUCCESS;
+}
 
-    // Did we fail to get a status code?
-    if (!dssResponse.hasStatusCode) {
-        ffsLogError("Failed to get a status code");
+/*
+ * Check whether the request in flight completed, without waiting.
+ */
+FFS_RESULT ffsDssClientPoll(FfsDssClientContext_t *dssClientContext, bool *isComplete)
+{
+    *isComplete = false;
+
+    // Nothing in flight?
+    if (!dssClientContext->request.operation) {
+        *isComplete = true;
+        ffsLogError("No DSS request in flight");
         FFS_FAIL(FFS_ERROR);
     }
 
-    // Redirect?
-    if (dssResponse.hasRedirect) {
+    // Still waiting for the response?
+    if (!dssClientContext->request.isComplete) {
+        return FFS_SUCCESS;
+    }
 
-        // Permanent redirect?
-        if (dssResponse.statusCode == HTTP_STATUS_CODE_PERMANENT_REDIRECT) {
+    FFS_CHECK_RESULT(ffsDssClientCollectResponse(dssClientContext, isComplete));
 
-            // Save the host string.
-            FFS_CHECK_RESULT(ffsDssClientSetDefaultHost(dssClientContext->userContext,
-                    &dssClientContext->hostStream));
-        }
-    } else {
+    return FFS_SUCCESS;
+}
 
-        // Did we get all the way through the state machine?
-        if (!dssResponse.signatureIsVerified) {
-            ffsLogError("Failed to verify signature");
+/*
+ * Wait for the request in flight to complete.
+ */
+FFS_RESULT ffsDssClientWait(FfsDssClientContext_t *dssClientContext)
+{
+    for (bool isComplete = false; !isComplete;) {
+
+        // Nothing in flight?
+        if (!dssClientContext->request.operation) {
+            ffsLogError("No DSS request in flight");
             FFS_FAIL(FFS_ERROR);
         }
+
+        FFS_CHECK_RESULT(ffsDssClientCollectResponse(dssClientContext, &isComplete));
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Cancel the request in flight, if any.
+ */
+FFS_RESULT ffsDssClientCancel(FfsDssClientContext_t *dssClientContext)
+{
+    FfsHttpOperation_t *operation = dssClientContext->request.operation;
+
+    if (!operation) {
+        return FFS_SUCCESS;
     }
+    dssClientContext->request.operation = NULL;
+
+    // The handle is released even if the cancellation failed.
+    FFS_RESULT result = ffsHttpCancel(dssClientContext->userContext, operation);
+    (void) ffsHttpWait(dssClientContext->userContext, operation);
+    FFS_CHECK_RESULT(result);
 
     return FFS_SUCCESS;
 }
@@ -508,55 +567,132 @@ FFS_RESULT ffsDssClientGetDefaultHost(struct FfsUserContext_s *userContext,
 }
 
 /*
- * Execute an HTTP request with redirects.
+ * Send an attempt of the request, on a copy of the request and response to allow retries on redirect.
+ */
+static FFS_RESULT ffsDssClientSendRequest(FfsDssClientContext_t *dssClientContext)
+{
+    FfsDssClientRequest_t *request = &dssClientContext->request;
+
+    // Log the request URL.
+    ffsLogDebug("DSS client sending request to: https://%.*s:%d%s",
+            FFS_STREAM_DATA_SIZE(request->httpRequest.url.hostStream),
+            FFS_STREAM_NEXT_READ(request->httpRequest.url.hostStream),
+            request->httpRequest.url.port,
+            request->httpRequest.url.path);
+
+    request->httpRequestCopy = request->httpRequest;
+    request->dssResponseCopy = request->dssResponse;
+    request->isComplete = false;
+
+    // Start the request.
+    FFS_CHECK_RESULT(ffsHttpExecuteAsync(dssClientContext->userContext, &request->httpRequestCopy,
+            &request->dssResponseCopy, FFS_DSS_REQUEST_TIMEOUT_MS, ffsDssClientHandleCompletion,
+            &request->operation));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Wait for the current attempt and release it, then follow a redirect or check the response.
  */
-static FFS_RESULT ffsDssClientHttpExecute(FfsDssClientContext_t *dssClientContext,
-        FfsHttpRequest_t *httpRequest, FfsDssHttpCallbackData_t *dssResponse)
+static FFS_RESULT ffsDssClientCollectResponse(FfsDssClientContext_t *dssClientContext,
+        bool *isComplete)
 {
-    for (int redirectCount = 0; redirectCount <= FFS_DSS_MAX_REDIRECTS; redirectCount++) {
+    FfsDssClientRequest_t *request = &dssClientContext->request;
+    FfsHttpOperation_t *operation = request->operation;
 
-        // Log the request URL.
-        ffsLogDebug("DSS client sending request to: https://%.*s:%d%s",
-                FFS_STREAM_DATA_SIZE(httpRequest->url.hostStream),
-                FFS_STREAM_NEXT_READ(httpRequest->url.hostStream),
-                httpRequest->url.port,
-                httpRequest->url.path);
+    *isComplete = true;
+    request->operation = NULL;
 
-        // Use copies of the request and response to allow retries on redirect.
-        FfsHttpRequest_t httpRequestCopy = *httpRequest;
-        FfsDssHttpCallbackData_t dssResponseCopy = *dssResponse;
+    // Get the result of the attempt.
+    FFS_RESULT result = ffsHttpWait(dssClientContext->userContext, operation);
 
-        // Execute the request.
-        FFS_RESULT result = ffsHttpExecute(dssClientContext->userContext,
-                &httpRequestCopy, &dssResponseCopy);
+    // Log the returned status code.
+    ffsLogDebug("DSS client received HTTP status code: %" PRId32, request->dssResponseCopy.statusCode);
 
-        // Log the returned status code.
-        ffsLogDebug("DSS client received HTTP status code: %" PRId32, dssResponseCopy.statusCode);
+    // Check the result.
+    FFS_CHECK_RESULT(result);
 
-        // Check the result.
-        FFS_CHECK_RESULT(result);
+    // Redirected?
+    if (request->dssResponseCopy.hasRedirect) {
+
+        // Log the redirect.
+        ffsLogDebug("DSS client was redirected to: https://%.*s:%d%s",
+                FFS_STREAM_DATA_SIZE(request->dssResponseCopy.redirectUrl->hostStream),
+                FFS_STREAM_NEXT_READ(request->dssResponseCopy.redirectUrl->hostStream),
+                request->dssResponseCopy.redirectUrl->port,
+                request->dssResponseCopy.redirectUrl->path);
+
+        // Too many redirects.
+        if (++request->redirectCount > FFS_DSS_MAX_REDIRECTS) {
+            return FFS_ERROR;
+        }
 
-        // Redirected?
-        if (dssResponseCopy.hasRedirect) {
+        // Try again.
+        FFS_CHECK_RESULT(ffsDssClientSendRequest(dssClientContext));
+        *isComplete = false;
 
-            // Log the redirect.
-            ffsLogDebug("DSS client was redirected to: https://%.*s:%d%s",
-                    FFS_STREAM_DATA_SIZE(dssResponseCopy.redirectUrl->hostStream),
-                    FFS_STREAM_NEXT_READ(dssResponseCopy.redirectUrl->hostStream),
-                    dssResponseCopy.redirectUrl->port,
-                    dssResponseCopy.redirectUrl->path);
-        } else {
+        return FFS_SUCCESS;
+    }
+
+    // Update the request and response.
+    request->httpRequest = request->httpRequestCopy;
+    request->dssResponse = request->dssResponseCopy;
 
-            // Update the request and response.
-            *httpRequest = httpRequestCopy;
-            *dssResponse = dssResponseCopy;
+    FFS_CHECK_RESULT(ffsDssClientCheckResponse(dssClientContext, &request->dssResponse));
 
-            return FFS_SUCCESS;
+    return FFS_SUCCESS;
+}
+
+/*
+ * Check the response of a completed request.
+ */
+static FFS_RESULT ffsDssClientCheckResponse(FfsDssClientContext_t *dssClientContext,
+        FfsDssHttpCallbackData_t *dssResponse)
+{
+    // Did a handler fail?
+    FFS_CHECK_RESULT(dssResponse->result);
+
+    // Did we fail to get a status code?
+    if (!dssResponse->hasStatusCode) {
+        ffsLogError("Failed to get a status code");
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    // Redirect?
+    if (dssResponse->hasRedirect) {
+
+        // Permanent redirect?
+        if (dssResponse->statusCode == HTTP_STATUS_CODE_PERMANENT_REDIRECT) {
+
+            // Save the host string.
+            FFS_CHECK_RESULT(ffsDssClientSetDefaultHost(dssClientContext->userContext,
+                    &dssClientContext->hostStream));
+        }
+    } else {
+
+        // Did we get all the way through the state machine?
+        if (!dssResponse->signatureIsVerified) {
+            ffsLogError("Failed to verify signature");
+            FFS_FAIL(FFS_ERROR);
         }
     }
 
-    // Too many redirects.
-    return FFS_ERROR;
+    return FFS_SUCCESS;
+}
+
+/*
+ * Flag the current attempt as complete (called on the HTTP context).
+ */
+static void ffsDssClientHandleCompletion(FfsHttpOperation_t *operation, FFS_RESULT result,
+        void *dssResponsePointer)
+{
+    FfsDssHttpCallbackData_t *dssResponse = (FfsDssHttpCallbackData_t *) dssResponsePointer;
+
+    (void) operation;
+    (void) result;
+
+    dssResponse->dssClientContext->request.isComplete = true;
 }
 
 /** @brief Extract the "host" component from a redirect target URL.
@@ -52,19 +52,29 @@ static const FfsDssOperationData_t FFS_DSS_OPERATION_DATA_COMPUTE_CONFIGURATION_
     }
 };
 
-/** @brief "Save response data" callbacks object.
- */
-typedef struct {
-    FfsDssSaveRegistrationDetailsCallback_t saveRegistrationDetailsCallback;
-    FfsDssSaveConfigurationCallback_t saveConfigurationCallback;
-} FfsDssComputeConfigurationDataReponseCallbacks_t;
-
 /*
  * Execute a "compute configuration data" operation.
  */
 FFS_RESULT ffsDssComputeConfigurationData(FfsDssClientContext_t *dssClientContext,
         FfsDssSaveRegistrationDetailsCallback_t saveRegistrationDetailsCallback,
         FfsDssSaveConfigurationCallback_t saveConfigurationCallback)
+{
+    FfsDssComputeConfigurationDataReponseCallbacks_t responseCallbacks;
+
+    FFS_CHECK_RESULT(ffsDssComputeConfigurationDataAsync(dssClientContext,
+            saveRegistrationDetailsCallback, saveConfigurationCallback, &responseCallbacks));
+    FFS_CHECK_RESULT(ffsDssClientWait(dssClientContext));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Start a "compute configuration data" operation.
+ */
+FFS_RESULT ffsDssComputeConfigurationDataAsync(FfsDssClientContext_t *dssClientContext,
+        FfsDssSaveRegistrationDetailsCallback_t saveRegistrationDetailsCallback,
+        FfsDssSaveConfigurationCallback_t saveConfigurationCallback,
+        FfsDssComputeConfigurationDataReponseCallbacks_t *responseCallbacks)
 {
     // Generate a new nonce.
     FFS_CHECK_RESULT(ffsDssClientRefreshNonce(dssClientContext));
@@ -76,13 +86,11 @@ FFS_RESULT ffsDssComputeConfigurationData(FfsDssClientContext_t *dssClientContex
     FFS_CHECK_RESULT(ffsConstructComputeConfigurationDataHttpRequestBody(dssClientContext,
             &bodyStream));
 
-    // Send the request and process the response.
-    FfsDssComputeConfigurationDataReponseCallbacks_t responseCallbacks = {
-        .saveRegistrationDetailsCallback = saveRegistrationDetailsCallback,
-        .saveConfigurationCallback = saveConfigurationCallback
-    };
-    FFS_CHECK_RESULT(ffsDssClientExecute(dssClientContext,
-            &FFS_DSS_OPERATION_DATA_COMPUTE_CONFIGURATION_DATA, &bodyStream, &responseCallbacks));
+    // Send the request.
+    responseCallbacks->saveRegistrationDetailsCallback = saveRegistrationDetailsCallback;
+    responseCallbacks->saveConfigurationCallback = saveConfigurationCallback;
+    FFS_CHECK_RESULT(ffsDssClientExecuteAsync(dssClientContext,
+            &FFS_DSS_OPERATION_DATA_COMPUTE_CONFIGURATION_DATA, &bodyStream, responseCallbacks));
 
     return FFS_SUCCESS;
 }
@@ -50,14 +50,6 @@ static const FfsDssOperationData_t FFS_DSS_OPERATION_DATA_GET_WIFI_CREDENTIALS =
     }
 };
 
-/** @brief Data structure for response body callback.
- */
-typedef struct {
-    bool *canProceed;
-    FfsDssSaveWifiCredentialsCallback_t saveCredentialsCallback;
-    bool *allCredentialsReturned;
-} FfsDssGetWifiCredentialsOperationData_t;
-
 /*
  * Execute the "get Wi-Fi credentials" operation.
  */
@@ -66,6 +58,25 @@ FFS_RESULT ffsDssGetWifiCredentials(FfsDssClientContext_t *dssClientContext,
         uint32_t sequenceNumber,
         FfsDssSaveWifiCredentialsCallback_t saveCredentialsCallback,
         bool *allCredentialsReturned)
+{
+    FfsDssGetWifiCredentialsOperationData_t operationData;
+
+    FFS_CHECK_RESULT(ffsDssGetWifiCredentialsAsync(dssClientContext, canProceed, sequenceNumber,
+            saveCredentialsCallback, allCredentialsReturned, &operationData));
+    FFS_CHECK_RESULT(ffsDssClientWait(dssClientContext));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Start the "get Wi-Fi credentials" operation.
+ */
+FFS_RESULT ffsDssGetWifiCredentialsAsync(FfsDssClientContext_t *dssClientContext,
+        bool *canProceed,
+        uint32_t sequenceNumber,
+        FfsDssSaveWifiCredentialsCallback_t saveCredentialsCallback,
+        bool *allCredentialsReturned,
+        FfsDssGetWifiCredentialsOperationData_t *operationData)
 {
     // Generate a new nonce.
     FFS_CHECK_RESULT(ffsDssClientRefreshNonce(dssClientContext));
@@ -77,16 +88,14 @@ FFS_RESULT ffsDssGetWifiCredentials(FfsDssClientContext_t *dssClientContext,
     FFS_CHECK_RESULT(ffsConstructGetWifiCredentialsHttpRequestBody(dssClientContext,
             sequenceNumber, &bodyStream));
 
-    // Create the operation data structure.
-    FfsDssGetWifiCredentialsOperationData_t operationData = {
-        .canProceed = canProceed,
-        .saveCredentialsCallback = saveCredentialsCallback,
-        .allCredentialsReturned = allCredentialsReturned
-    };
+    // Fill in the operation data structure.
+    operationData->canProceed = canProceed;
+    operationData->saveCredentialsCallback = saveCredentialsCallback;
+    operationData->allCredentialsReturned = allCredentialsReturned;
 
-    // Send the request and process the response.
-    FFS_CHECK_RESULT(ffsDssClientExecute(dssClientContext,
-            &FFS_DSS_OPERATION_DATA_GET_WIFI_CREDENTIALS, &bodyStream, &operationData));
+    // Send the request.
+    FFS_CHECK_RESULT(ffsDssClientExecuteAsync(dssClientContext,
+            &FFS_DSS_OPERATION_DATA_GET_WIFI_CREDENTIALS, &bodyStream, operationData));
 
     return FFS_SUCCESS;
 }
@@ -24,7 +24,7 @@
 static FFS_RESULT ffsConstructPostWifiScanDataHttpRequestBody(FfsDssClientContext_t *dssClientContext,
         uint32_t sequenceNumber,
         FfsDssGetWifiScanResultsCallback_t getScanResultsCallback,
-        FfsDssWifiScanResult_t *wifiScanResult,
+        struct FfsWifiProvisioneeScanList_s *scanList,
         FfsStream_t *bodyStream);
 static FFS_RESULT ffsHandlePostWifiScanDataHttpResponseBody(FfsStream_t *bodyStream,
         void *callbackDataPointer);
@@ -44,14 +44,6 @@ static const FfsDssOperationData_t FFS_DSS_OPERATION_DATA_POST_WIFI_SCAN_DATA =
     }
 };
 
-/** @brief Data structure for response body callback.
- */
-typedef struct {
-    bool *canProceed;
-    uint32_t *totalCredentialsFound;
-    bool *allCredentialsFound;
-} FfsDssPostWifiScanDataOperationData_t;
-
 /*
  * Execute the "post Wi-Fi scan data" operation.
  */
@@ -59,9 +51,31 @@ FFS_RESULT ffsDssPostWifiScanData(FfsDssClientContext_t *dssClientContext,
         bool *canProceed,
         uint32_t sequenceNumber,
         FfsDssGetWifiScanResultsCallback_t getScanResultsCallback,
-        FfsDssWifiScanResult_t *wifiScanResult,
+        struct FfsWifiProvisioneeScanList_s *scanList,
         uint32_t *totalCredentialsFound,
         bool *allCredentialsFound)
+{
+    FfsDssPostWifiScanDataOperationData_t operationData;
+
+    FFS_CHECK_RESULT(ffsDssPostWifiScanDataAsync(dssClientContext, canProceed, sequenceNumber,
+            getScanResultsCallback, scanList, totalCredentialsFound, allCredentialsFound,
+            &operationData));
+    FFS_CHECK_RESULT(ffsDssClientWait(dssClientContext));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Start the "post Wi-Fi scan data" operation.
+ */
+FFS_RESULT ffsDssPostWifiScanDataAsync(FfsDssClientContext_t *dssClientContext,
+        bool *canProceed,
+        uint32_t sequenceNumber,
+        FfsDssGetWifiScanResultsCallback_t getScanResultsCallback,
+        struct FfsWifiProvisioneeScanList_s *scanList,
+        uint32_t *totalCredentialsFound,
+        bool *allCredentialsFound,
+        FfsDssPostWifiScanDataOperationData_t *operationData)
 {
     // Generate a new nonce.
     FFS_CHECK_RESULT(ffsDssClientRefreshNonce(dssClientContext));
@@ -71,18 +85,16 @@ FFS_RESULT ffsDssPostWifiScanData(FfsDssClientContext_t *dssClientContext,
 
     // Fill in the request body.
     FFS_CHECK_RESULT(ffsConstructPostWifiScanDataHttpRequestBody(dssClientContext,
-            sequenceNumber, getScanResultsCallback, wifiScanResult, &bodyStream));
+            sequenceNumber, getScanResultsCallback, scanList, &bodyStream));
 
-    // Create the operation data structure.
-    FfsDssPostWifiScanDataOperationData_t operationData = {
-        .canProceed = canProceed,
-        .totalCredentialsFound = totalCredentialsFound,
-        .allCredentialsFound = allCredentialsFound
-    };
+    // Fill in the operation data structure.
+    operationData->canProceed = canProceed;
+    operationData->totalCredentialsFound = totalCredentialsFound;
+    operationData->allCredentialsFound = allCredentialsFound;
 
-    // Send the request and process the response.
-    FFS_CHECK_RESULT(ffsDssClientExecute(dssClientContext,
-            &FFS_DSS_OPERATION_DATA_POST_WIFI_SCAN_DATA, &bodyStream, &operationData));
+    // Send the request.
+    FFS_CHECK_RESULT(ffsDssClientExecuteAsync(dssClientContext,
+            &FFS_DSS_OPERATION_DATA_POST_WIFI_SCAN_DATA, &bodyStream, operationData));
 
     return FFS_SUCCESS;
 }
@@ -112,7 +124,7 @@ static FFS_RESULT ffsConstructPostWifiScanDataHttpRequestBody(
         FfsDssClientContext_t *dssClientContext,
         uint32_t sequenceNumber,
         FfsDssGetWifiScanResultsCallback_t getScanResultsCallback,
-        FfsDssWifiScanResult_t *wifiScanResult,
+        struct FfsWifiProvisioneeScanList_s *scanList,
         FfsStream_t *bodyStream)
 {
     // Start the request.
@@ -130,7 +142,7 @@ static FFS_RESULT ffsConstructPostWifiScanDataHttpRequestBody(
 
     // Are there Wi-Fi scan results to report?
     if (getScanResultsCallback) {
-        FFS_CHECK_RESULT(getScanResultsCallback(dssClientContext->userContext, wifiScanResult, bodyStream));
+        FFS_CHECK_RESULT(getScanResultsCallback(dssClientContext->userContext, scanList, bodyStream));
     }
 
     // End the request.
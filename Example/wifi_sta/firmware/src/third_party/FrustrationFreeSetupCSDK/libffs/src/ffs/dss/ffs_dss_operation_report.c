@@ -52,13 +52,6 @@ static const FfsDssOperationData_t FFS_DSS_OPERATION_DATA_REPORT = {
     }
 };
 
-/** @brief Report operation data structure.
- */
-typedef struct {
-    bool *canProceed;
-    FFS_DSS_WIFI_PROVISIONEE_STATE *nextProvisioneeState;
-} FfsDssReportOperationData_t;
-
 /*
  * Execute the "report" operation.
  */
@@ -70,6 +63,29 @@ FFS_RESULT ffsDssReport(FfsDssClientContext_t *dssClientContext,
         FFS_DSS_WIFI_PROVISIONEE_STATE *nextProvisioneeState,
         FfsDssGetConnectionAttemptsCallback_t getConnectionAttemptsCallback,
         FfsDssWifiConnectionAttempt_t *wifiConnectionAttempt)
+{
+    FfsDssReportOperationData_t operationData;
+
+    FFS_CHECK_RESULT(ffsDssReportAsync(dssClientContext, provisioneeState, stateTransitionResult,
+            registrationState, canProceed, nextProvisioneeState, getConnectionAttemptsCallback,
+            wifiConnectionAttempt, &operationData));
+    FFS_CHECK_RESULT(ffsDssClientWait(dssClientContext));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Start the "report" operation.
+ */
+FFS_RESULT ffsDssReportAsync(FfsDssClientContext_t *dssClientContext,
+        FFS_DSS_WIFI_PROVISIONEE_STATE provisioneeState,
+        FFS_DSS_REPORT_RESULT stateTransitionResult,
+        FFS_DSS_REGISTRATION_STATE registrationState,
+        bool *canProceed,
+        FFS_DSS_WIFI_PROVISIONEE_STATE *nextProvisioneeState,
+        FfsDssGetConnectionAttemptsCallback_t getConnectionAttemptsCallback,
+        FfsDssWifiConnectionAttempt_t *wifiConnectionAttempt,
+        FfsDssReportOperationData_t *operationData)
 {
     // Increment the sequence number.
     dssClientContext->sequenceNumber++;
@@ -84,15 +100,13 @@ FFS_RESULT ffsDssReport(FfsDssClientContext_t *dssClientContext,
     FFS_CHECK_RESULT(ffsConstructReportHttpRequestBody(dssClientContext, provisioneeState,
             stateTransitionResult, registrationState, getConnectionAttemptsCallback, wifiConnectionAttempt, &bodyStream));
 
-    // Create the operation data structure.
-    FfsDssReportOperationData_t operationData = {
-        .canProceed = canProceed,
-        .nextProvisioneeState = nextProvisioneeState
-    };
+    // Fill in the operation data structure.
+    operationData->canProceed = canProceed;
+    operationData->nextProvisioneeState = nextProvisioneeState;
 
-    // Send the request and process the response.
-    FFS_CHECK_RESULT(ffsDssClientExecute(dssClientContext,
-            &FFS_DSS_OPERATION_DATA_REPORT, &bodyStream, &operationData));
+    // Send the request.
+    FFS_CHECK_RESULT(ffsDssClientExecuteAsync(dssClientContext,
+            &FFS_DSS_OPERATION_DATA_REPORT, &bodyStream, operationData));
 
     return FFS_SUCCESS;
 }
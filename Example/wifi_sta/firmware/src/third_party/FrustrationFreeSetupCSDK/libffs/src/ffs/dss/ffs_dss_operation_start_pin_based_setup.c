@@ -50,6 +50,18 @@ static const FfsDssOperationData_t FFS_DSS_OPERATION_DATA_START_PIN_BASED_SETUP
  */
 FFS_RESULT ffsDssStartPinBasedSetup(FfsDssClientContext_t *dssClientContext,
         bool *canProceed, FfsStream_t saltStream)
+{
+    FFS_CHECK_RESULT(ffsDssStartPinBasedSetupAsync(dssClientContext, canProceed, saltStream));
+    FFS_CHECK_RESULT(ffsDssClientWait(dssClientContext));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Start the "start PIN-based setup" operation.
+ */
+FFS_RESULT ffsDssStartPinBasedSetupAsync(FfsDssClientContext_t *dssClientContext,
+        bool *canProceed, FfsStream_t saltStream)
 {
     // Generate a new nonce.
     FFS_CHECK_RESULT(ffsDssClientRefreshNonce(dssClientContext));
@@ -61,8 +73,8 @@ FFS_RESULT ffsDssStartPinBasedSetup(FfsDssClientContext_t *dssClientContext,
     FFS_CHECK_RESULT(ffsConstructStartPinBasedSetupHttpRequestBody(dssClientContext,
             &bodyStream, saltStream));
 
-    // Send the request and process the response.
-    FFS_CHECK_RESULT(ffsDssClientExecute(dssClientContext,
+    // Send the request.
+    FFS_CHECK_RESULT(ffsDssClientExecuteAsync(dssClientContext,
             &FFS_DSS_OPERATION_DATA_START_PIN_BASED_SETUP, &bodyStream, canProceed));
 
     return FFS_SUCCESS;
@@ -20,7 +20,7 @@
 #include "ffs/dss/model/ffs_dss_start_provisioning_session_response.h"
 #include "ffs/dss/ffs_dss_client.h"
 #include "ffs/dss/ffs_dss_operation.h"
-#include "ffs/dss/ffs_dss_operation_compute_configuration_data.h"
+#include "ffs/dss/ffs_dss_operation_start_provisioning_session.h"
 
 // Static function prototypes.
 static FFS_RESULT ffsConstructStartProvisioningSessionHttpRequestBody(FfsDssClientContext_t *dssClientContext,
@@ -43,18 +43,27 @@ static const FfsDssOperationData_t FFS_DSS_OPERATION_DATA_START_PROVISIONING_SES
     }
 };
 
-/** @brief DSS "start provisioning session" operation data structure.
- */
-typedef struct {
-    bool *canProceed;
-    FfsStream_t *saltStream;
-} FfsStartProvisioningSessionOperationData_t;
-
 /*
  * Execute the "start provisioning session" operation.
  */
 FFS_RESULT ffsDssStartProvisioningSession(FfsDssClientContext_t *dssClientContext,
         bool *canProceed, FfsStream_t *saltStream)
+{
+    FfsStartProvisioningSessionOperationData_t operationData;
+
+    FFS_CHECK_RESULT(ffsDssStartProvisioningSessionAsync(dssClientContext, canProceed, saltStream,
+            &operationData));
+    FFS_CHECK_RESULT(ffsDssClientWait(dssClientContext));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Start the "start provisioning session" operation.
+ */
+FFS_RESULT ffsDssStartProvisioningSessionAsync(FfsDssClientContext_t *dssClientContext,
+        bool *canProceed, FfsStream_t *saltStream,
+        FfsStartProvisioningSessionOperationData_t *operationData)
 {
     // Generate a new nonce.
     FFS_CHECK_RESULT(ffsDssClientRefreshNonce(dssClientContext));
@@ -66,15 +75,13 @@ FFS_RESULT ffsDssStartProvisioningSession(FfsDssClientContext_t *dssClientContex
     FFS_CHECK_RESULT(ffsConstructStartProvisioningSessionHttpRequestBody(dssClientContext,
             &bodyStream));
 
-    // Create the operation data structure.
-    FfsStartProvisioningSessionOperationData_t operationData = {
-        .canProceed = canProceed,
-        .saltStream = saltStream
-    };
+    // Fill in the operation data structure.
+    operationData->canProceed = canProceed;
+    operationData->saltStream = saltStream;
 
-    // Send the request and process the response.
-    FFS_CHECK_RESULT(ffsDssClientExecute(dssClientContext,
-            &FFS_DSS_OPERATION_DATA_START_PROVISIONING_SESSION, &bodyStream, &operationData));
+    // Send the request.
+    FFS_CHECK_RESULT(ffsDssClientExecuteAsync(dssClientContext,
+            &FFS_DSS_OPERATION_DATA_START_PROVISIONING_SESSION, &bodyStream, operationData));
 
     return FFS_SUCCESS;
 }
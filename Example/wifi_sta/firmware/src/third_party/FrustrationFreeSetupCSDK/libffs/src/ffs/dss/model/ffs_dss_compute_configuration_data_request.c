@@ -14,12 +14,10 @@
 
 #include "ffs/common/ffs_check_result.h"
 #include "ffs/dss/model/ffs_dss_compute_configuration_data_request.h"
+#include "ffs/dss/model/ffs_dss_model_tables.h"
 
 #include <string.h>
 
-#define JSON_KEY_NONCE              "nonce"
-#define JSON_KEY_SESSION_ID         "sessionId"
-
 /*
  * Serialize a DSS "compute configuration data" request.
  */
@@ -27,24 +25,9 @@ FFS_RESULT ffsDssSerializeComputeConfigurationDataRequest(
         FfsDssComputeConfigurationDataRequest_t *computeConfigurationDataRequest,
         FfsStream_t *outputStream)
 {
-    // Start the "compute configuration data" request object.
-    FFS_CHECK_RESULT(ffsEncodeJsonObjectStart(outputStream));
-
-    // Serialize the nonce field.
-    FFS_CHECK_RESULT(ffsEncodeJsonStringField(JSON_KEY_NONCE, computeConfigurationDataRequest->nonce,
-            outputStream));
-
-    // Serialize the session ID field.
-    FFS_CHECK_RESULT(ffsEncodeJsonSeparator(outputStream));
-    FFS_CHECK_RESULT(ffsEncodeJsonStringField(JSON_KEY_SESSION_ID,
-            computeConfigurationDataRequest->sessionId, outputStream));
-
-    // Serialize the "device details" field.
-    FFS_CHECK_RESULT(ffsDssSerializeDeviceDetailsField(&computeConfigurationDataRequest->deviceDetails,
-            outputStream));
-
-    // End the "compute configuration data" request object.
-    FFS_CHECK_RESULT(ffsEncodeJsonObjectEnd(outputStream));
+    // Serialize {"nonce":"...","sessionId":"...","deviceDetails":{...}}.
+    FFS_CHECK_RESULT(ffsDssSerializeModel(&ffsDssComputeConfigurationDataRequestModel,
+            computeConfigurationDataRequest, NULL, outputStream));
 
     return FFS_SUCCESS;
 }
@@ -15,10 +15,7 @@
 #include "ffs/common/ffs_check_result.h"
 #include "ffs/conversion/ffs_convert_json_value.h"
 #include "ffs/dss/model/ffs_dss_compute_configuration_data_response.h"
-
-#define JSON_KEY_NONCE                      "nonce"
-#define JSON_KEY_CONFIGURATION              "configuration"
-#define JSON_KEY_REGISTRATION_DETAILS       "registrationDetails"
+#include "ffs/dss/model/ffs_dss_model_tables.h"
 
 /*
  * Serialize a DSS "compute configuration data" response.
@@ -43,35 +40,11 @@ FFS_RESULT ffsDssDeserializeComputeConfigurationDataResponse(
         FfsDssComputeConfigurationDataResponse_t *computeConfigurationDataResponse,
         FfsJsonValue_t *configurationObjectValue)
 {
-    // Zero out the "compute configuration data" response.
-    memset(computeConfigurationDataResponse, 0, sizeof(*computeConfigurationDataResponse));
-
-    // Parse {"nonce":"...","configuration":{...},"registrationDetails":{...}}.
-    FfsJsonField_t nonceField = ffsCreateJsonField(JSON_KEY_NONCE, FFS_JSON_STRING);
-    FfsJsonField_t configurationField = ffsCreateJsonField(JSON_KEY_CONFIGURATION,
-            FFS_JSON_OBJECT);
-    FfsJsonField_t registrationDetailsField = ffsCreateJsonField(JSON_KEY_REGISTRATION_DETAILS,
-            FFS_JSON_OBJECT);
-    FfsJsonField_t *computeConfigurationDataResponseExpectedFields[] = { &nonceField, &configurationField,
-            &registrationDetailsField, NULL };
-
-    FFS_CHECK_RESULT(ffsParseJsonObject(computeConfigurationDataResponseValue,
-            computeConfigurationDataResponseExpectedFields));
-
-    // Parse the nonce.
-    FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8String(&nonceField.value,
-            &computeConfigurationDataResponse->nonce));
-
-    // Copy the configuration list JSON value (which may be empty).
-    *configurationObjectValue = configurationField.value;
-
-    // Is there a "registration details" object?
-    if (!ffsJsonFieldIsEmpty(&registrationDetailsField)) {
-
-        // Parse the registration details.
-        FFS_CHECK_RESULT(ffsDssDeserializeRegistrationDetails(&registrationDetailsField.value,
-                &computeConfigurationDataResponse->registrationDetails));
-    }
+    // Parse {"nonce":"...","configuration":{...},"registrationDetails":{...}}; the configuration
+    // object value (which may be empty) is handed back to the caller.
+    FFS_CHECK_RESULT(ffsDssDeserializeModel(&ffsDssComputeConfigurationDataResponseModel,
+            computeConfigurationDataResponseValue, computeConfigurationDataResponse,
+            configurationObjectValue));
 
     return FFS_SUCCESS;
 }
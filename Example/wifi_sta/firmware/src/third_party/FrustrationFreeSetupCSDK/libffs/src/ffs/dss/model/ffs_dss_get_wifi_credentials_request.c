@@ -15,43 +15,19 @@
 #include "ffs/common/ffs_check_result.h"
 #include "ffs/dss/model/ffs_dss_device_details.h"
 #include "ffs/dss/model/ffs_dss_get_wifi_credentials_request.h"
+#include "ffs/dss/model/ffs_dss_model_tables.h"
 
 #include <stdbool.h>
 
-#define JSON_KEY_NONCE                  "nonce"
-#define JSON_KEY_SESSION_ID             "sessionId"
-#define JSON_KEY_SEQUENCE_NUMBER        "sequenceNumber"
-#define JSON_KEY_WIFI_SCAN_DATA_LIST    "wifiScanDataList"
-
 /*
  * Start serializing a DSS "get Wi-Fi credentials" request.
  */
 FFS_RESULT ffsDssSerializeGetWifiCredentialsRequest(
         FfsDssGetWifiCredentialsRequest_t *getWifiCredentialsRequest, FfsStream_t *outputStream)
 {
-    // Start the "get Wi-Fi credentials" request object.
-    FFS_CHECK_RESULT(ffsEncodeJsonObjectStart(outputStream));
-
-    // Serialize the nonce field.
-    FFS_CHECK_RESULT(ffsEncodeJsonStringField(JSON_KEY_NONCE, getWifiCredentialsRequest->nonce,
-            outputStream));
-
-    // Serialize the session ID field.
-    FFS_CHECK_RESULT(ffsEncodeJsonSeparator(outputStream));
-    FFS_CHECK_RESULT(ffsEncodeJsonStringField(JSON_KEY_SESSION_ID, getWifiCredentialsRequest->sessionId,
-            outputStream));
-
-    // Serialize the device details field.
-    FFS_CHECK_RESULT(ffsDssSerializeDeviceDetailsField(&getWifiCredentialsRequest->deviceDetails,
-            outputStream));
-
-    // Serialize the sequence number.
-    FFS_CHECK_RESULT(ffsEncodeJsonSeparator(outputStream));
-    FFS_CHECK_RESULT(ffsEncodeJsonUint32Field(JSON_KEY_SEQUENCE_NUMBER, getWifiCredentialsRequest->sequenceNumber,
-            outputStream));
-
-    // Finish the "get Wi-Fi credentials" request object.
-    FFS_CHECK_RESULT(ffsEncodeJsonObjectEnd(outputStream));
+    // Serialize {"nonce":"...","sessionId":"...","deviceDetails":{...},"sequenceNumber":...}.
+    FFS_CHECK_RESULT(ffsDssSerializeModel(&ffsDssGetWifiCredentialsRequestModel, getWifiCredentialsRequest,
+            NULL, outputStream));
 
     return FFS_SUCCESS;
 }
@@ -14,13 +14,7 @@
 
 #include "ffs/common/ffs_check_result.h"
 #include "ffs/dss/model/ffs_dss_get_wifi_credentials_response.h"
-
-#define JSON_KEY_NONCE                      "nonce"
-#define JSON_KEY_SESSION_ID                 "sessionId"
-#define JSON_KEY_CAN_PROCEED                "canProceed"
-#define JSON_KEY_SEQUENCE_NUMBER            "sequenceNumber"
-#define JSON_KEY_ALL_CREDENTIALS_RETURNED   "allCredentialsReturned"
-#define JSON_KEY_WIFI_CREDENTIALS_LIST      "wifiCredentialsList"
+#include "ffs/dss/model/ffs_dss_model_tables.h"
 
 /*
  * Start serializing a DSS "get Wi-Fi credentials" response.
@@ -65,50 +59,11 @@ FFS_RESULT ffsDssDeserializeGetWifiCredentialsResponse(
         FfsDssGetWifiCredentialsResponse_t *getWifiCredentialsResponse,
         FfsJsonValue_t *wifiCredentialsListValue)
 {
-    // Zero out the "get Wi-Fi credentials" response.
-    memset(getWifiCredentialsResponse, 0, sizeof(*getWifiCredentialsResponse));
-
-    /* Parse {"nonce":"...",
-            "canProceed":"...",
-            "sequenceNumber":...,
-            "allCredentialsReturned":"...",
-            "wifiCredentialsList":[...]} */
-    FfsJsonField_t nonceField = ffsCreateJsonField(JSON_KEY_NONCE, FFS_JSON_STRING);
-    FfsJsonField_t canProceedField = ffsCreateJsonField(JSON_KEY_CAN_PROCEED, FFS_JSON_BOOLEAN);
-    FfsJsonField_t sequenceNumberField = ffsCreateJsonField(JSON_KEY_SEQUENCE_NUMBER, FFS_JSON_NUMBER);
-    FfsJsonField_t allCredentialsReturnedField = ffsCreateJsonField(JSON_KEY_ALL_CREDENTIALS_RETURNED, FFS_JSON_BOOLEAN);
-    FfsJsonField_t wifiCredentialsListField = ffsCreateJsonField(JSON_KEY_WIFI_CREDENTIALS_LIST, FFS_JSON_ARRAY);
-
-    FfsJsonField_t *getWifiCredentialsResponseExpectedFields[] = {
-            &nonceField,
-            &canProceedField,
-            &sequenceNumberField,
-            &allCredentialsReturnedField,
-            &wifiCredentialsListField,
-            NULL };
-
-    FFS_CHECK_RESULT(ffsParseJsonObject(getWifiCredentialsResponseValue,
-            getWifiCredentialsResponseExpectedFields));
-
-    // Parse the 'canProceed' value.
-    FFS_CHECK_RESULT(ffsParseJsonBoolean(&canProceedField.value, &getWifiCredentialsResponse->canProceed));
-
-    // Short-circuit if the 'canProceed' value is false.
-    if (!getWifiCredentialsResponse->canProceed) {
-        FFS_FAIL(FFS_ERROR);
-    }
-
-    // Parse the nonce.
-    FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8String(&nonceField.value, &getWifiCredentialsResponse->nonce));
-
-    // Parse the 'sequenceNumber' value.
-    FFS_CHECK_RESULT(ffsParseJsonUint32(&sequenceNumberField.value, &getWifiCredentialsResponse->sequenceNumber));
-
-    // Parse the 'allCredentialsReturned' value.
-    FFS_CHECK_RESULT(ffsParseJsonBoolean(&allCredentialsReturnedField.value, &getWifiCredentialsResponse->allCredentialsReturned));
-
-    // Copy the credentials list JSON value (which may be empty).
-    *wifiCredentialsListValue = wifiCredentialsListField.value;
+    // Parse {"nonce":"...","canProceed":...,"sequenceNumber":...,"allCredentialsReturned":...,
+    // "wifiCredentialsList":[...]}, failing if "canProceed" is false. The credentials list value
+    // (which may be empty) is handed back to the caller.
+    FFS_CHECK_RESULT(ffsDssDeserializeModel(&ffsDssGetWifiCredentialsResponseModel,
+            getWifiCredentialsResponseValue, getWifiCredentialsResponse, wifiCredentialsListValue));
 
     return FFS_SUCCESS;
 }
@@ -0,0 +1,373 @@
+/** @file ffs_dss_model_codec.c
+ *
+ * @brief Table-driven DSS model serialization/deserialization implementation.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_check_result.h"
+#include "ffs/dss/model/ffs_dss_model_codec.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define BSSID_SIZE                      (6)
+#define BSSID_STRING_SIZE               (3 * BSSID_SIZE)
+#define BSSID_STRING_FORMAT             "%02X:%02X:%02X:%02X:%02X:%02X"
+
+/** @brief Member of an object at a descriptor offset.
+ */
+#define FFS_DSS_MODEL_MEMBER(object, offset)    ((void *) ((uint8_t *) (object) + (offset)))
+
+// Static functions.
+static FFS_RESULT ffsDssSerializeModelFields(const FfsDssModelDescriptor_t *model, const void *object,
+        bool *isEmpty, FfsStream_t *outputStream);
+static FFS_RESULT ffsDssSerializeModelField(const FfsDssModelField_t *field, const void *member,
+        bool isFirst, bool *isSerialized, FfsStream_t *outputStream);
+static bool ffsDssModelFieldIsEmpty(const FfsDssModelField_t *field, const void *member);
+static FFS_RESULT ffsDssDeserializeModelField(const FfsDssModelField_t *field, FfsJsonValue_t *value,
+        void *object, FfsJsonValue_t *capturedValues);
+
+/*
+ * Serialize a model object.
+ */
+FFS_RESULT ffsDssSerializeModel(const FfsDssModelDescriptor_t *model, const void *object, bool *isEmpty,
+        FfsStream_t *outputStream)
+{
+    // Serialize the object start and the fields.
+    FFS_CHECK_RESULT(ffsDssSerializeModelFields(model, object, isEmpty, outputStream));
+
+    // End the object.
+    FFS_CHECK_RESULT(ffsEncodeJsonObjectEnd(outputStream));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Start serializing a model object.
+ */
+FFS_RESULT ffsDssStartSerializingModel(const FfsDssModelDescriptor_t *model, const void *object,
+        FfsStream_t *outputStream)
+{
+    FFS_CHECK_RESULT(ffsDssSerializeModelFields(model, object, NULL, outputStream));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Deserialize a model object.
+ */
+FFS_RESULT ffsDssDeserializeModel(const FfsDssModelDescriptor_t *model, FfsJsonValue_t *objectValue,
+        void *object, FfsJsonValue_t *capturedValues)
+{
+    uint32_t parsedFields = 0;
+
+    // Zero out the object.
+    memset(object, 0, model->objectSize);
+
+    // Captured values default to empty values of the expected type.
+    for (uint8_t index = 0; index < model->fieldCount; index++) {
+        const FfsDssModelField_t *field = &model->fields[index];
+        if (field->type == FFS_DSS_MODEL_FIELD_JSON_VALUE) {
+            FfsJsonValue_t emptyValue = {
+                .type = (FFS_JSON_TYPE) field->jsonType,
+                .valueStream = FFS_NULL_STREAM
+            };
+            capturedValues[field->offset] = emptyValue;
+        }
+    }
+
+    // Parse each key/value pair as it comes.
+    while (true) {
+
+        // Get the next pair.
+        FfsJsonField_t keyValuePair;
+        bool isDone;
+        FFS_CHECK_RESULT(ffsParseJsonKeyValuePair(objectValue, &keyValuePair, &isDone));
+
+        // Done?
+        if (isDone) {
+            break;
+        }
+
+        // Ignore unknown keys.
+        const FfsDssModelField_t *field = ffsDssFindModelField(model, keyValuePair.key);
+        if (!field) {
+            continue;
+        }
+
+        // Is the value type correct?
+        if (keyValuePair.value.type != (FFS_JSON_TYPE) field->jsonType) {
+            FFS_FAIL(FFS_ERROR);
+        }
+
+        // Is the value already set?
+        uint32_t fieldBit = (uint32_t) 1 << (field - model->fields);
+        if (parsedFields & fieldBit) {
+            FFS_FAIL(FFS_OVERRUN);
+        }
+        parsedFields |= fieldBit;
+
+        FFS_CHECK_RESULT(ffsDssDeserializeModelField(field, &keyValuePair.value, object, capturedValues));
+
+        // Flag the field as present?
+        if (field->presenceOffset != FFS_DSS_MODEL_NO_PRESENCE_FLAG) {
+            *(bool *) FFS_DSS_MODEL_MEMBER(object, field->presenceOffset) = true;
+        }
+    }
+
+    // Required fields that were absent are parsed from an empty value, so
+    // they fail (or default) exactly like an explicit empty field would.
+    for (uint8_t index = 0; index < model->fieldCount; index++) {
+        const FfsDssModelField_t *field = &model->fields[index];
+        if ((field->flags & FFS_DSS_MODEL_FIELD_REQUIRED) && !(parsedFields & ((uint32_t) 1 << index))) {
+            FfsJsonValue_t emptyValue = {
+                .type = (FFS_JSON_TYPE) field->jsonType,
+                .valueStream = FFS_NULL_STREAM
+            };
+            FFS_CHECK_RESULT(ffsDssDeserializeModelField(field, &emptyValue, object, capturedValues));
+        }
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Find a field by key.
+ */
+const FfsDssModelField_t *ffsDssFindModelField(const FfsDssModelDescriptor_t *model, const char *key)
+{
+    size_t keySize = strlen(key);
+
+    // No field has a key this long?
+    if (keySize > model->maximumKeySize) {
+        return NULL;
+    }
+
+    // Compare only the keys of the same length.
+    for (uint8_t index = model->lookupIndex[keySize]; index < model->lookupIndex[keySize + 1]; index++) {
+        const FfsDssModelField_t *field = &model->fields[model->lookup[index]];
+        if (!memcmp(field->key, key, keySize)) {
+            return field;
+        }
+    }
+
+    return NULL;
+}
+
+/** @brief Serialize the object start and the fields of a model object.
+ */
+static FFS_RESULT ffsDssSerializeModelFields(const FfsDssModelDescriptor_t *model, const void *object,
+        bool *isEmpty, FfsStream_t *outputStream)
+{
+    bool isFirst = true;
+
+    // Start the object.
+    FFS_CHECK_RESULT(ffsEncodeJsonObjectStart(outputStream));
+
+    // Serialize each field.
+    for (uint8_t index = 0; index < model->fieldCount; index++) {
+        const FfsDssModelField_t *field = &model->fields[index];
+        const void *member = FFS_DSS_MODEL_MEMBER(object, field->offset);
+
+        // Is the field absent?
+        if (field->presenceOffset != FFS_DSS_MODEL_NO_PRESENCE_FLAG
+                && !*(const bool *) FFS_DSS_MODEL_MEMBER(object, field->presenceOffset)) {
+            continue;
+        }
+
+        // Omit an empty optional field?
+        if (!(field->flags & FFS_DSS_MODEL_FIELD_REQUIRED) && ffsDssModelFieldIsEmpty(field, member)) {
+            continue;
+        }
+
+        bool isSerialized;
+        FFS_CHECK_RESULT(ffsDssSerializeModelField(field, member, isFirst, &isSerialized, outputStream));
+        if (isSerialized) {
+            isFirst = false;
+        }
+    }
+
+    // Is the object empty?
+    if (isEmpty) {
+        *isEmpty = isFirst;
+    }
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Serialize one field (with a separator unless it is the first).
+ */
+static FFS_RESULT ffsDssSerializeModelField(const FfsDssModelField_t *field, const void *member,
+        bool isFirst, bool *isSerialized, FfsStream_t *outputStream)
+{
+    *isSerialized = true;
+
+    // Custom fields serialize their own separator and may serialize nothing.
+    if (field->type == FFS_DSS_MODEL_FIELD_CUSTOM) {
+        size_t dataSize = FFS_STREAM_DATA_SIZE(*outputStream);
+        FFS_CHECK_RESULT(field->extension.serializeField(member, outputStream));
+        *isSerialized = FFS_STREAM_DATA_SIZE(*outputStream) != dataSize;
+        return FFS_SUCCESS;
+    }
+
+    // Work with a copy of the output stream in case a nested object is empty.
+    FfsStream_t outputStreamCopy = *outputStream;
+
+    // Add a separator?
+    if (!isFirst) {
+        FFS_CHECK_RESULT(ffsEncodeJsonSeparator(&outputStreamCopy));
+    }
+
+    switch (field->type) {
+    case FFS_DSS_MODEL_FIELD_STRING:
+        FFS_CHECK_RESULT(ffsEncodeJsonStringField(field->key, *(const char * const *) member,
+                &outputStreamCopy));
+        break;
+    case FFS_DSS_MODEL_FIELD_STREAM: {
+        FfsStream_t valueStream = *(const FfsStream_t *) member;
+        FFS_CHECK_RESULT(ffsEncodeJsonStreamField(field->key, &valueStream, &outputStreamCopy));
+        break;
+    }
+    case FFS_DSS_MODEL_FIELD_QUOTED_STREAM: {
+        FfsStream_t valueStream = *(const FfsStream_t *) member;
+        FFS_CHECK_RESULT(ffsEncodeJsonQuotedStreamField(field->key, &valueStream, &outputStreamCopy));
+        break;
+    }
+    case FFS_DSS_MODEL_FIELD_BSSID: {
+        // Read the BSSID bytes (from a copy, leaving the source intact).
+        FfsStream_t bssidStream = *(const FfsStream_t *) member;
+        uint8_t *bssidData;
+        FFS_CHECK_RESULT(ffsReadStream(&bssidStream, BSSID_SIZE, &bssidData));
+
+        // Convert it to a string.
+        char bssidString[BSSID_STRING_SIZE];
+        snprintf(bssidString, sizeof(bssidString), BSSID_STRING_FORMAT,
+                bssidData[0], bssidData[1], bssidData[2], bssidData[3], bssidData[4], bssidData[5]);
+
+        FFS_CHECK_RESULT(ffsEncodeJsonStringField(field->key, bssidString, &outputStreamCopy));
+        break;
+    }
+    case FFS_DSS_MODEL_FIELD_BOOLEAN:
+        FFS_CHECK_RESULT(ffsEncodeJsonBooleanField(field->key, *(const bool *) member, &outputStreamCopy));
+        break;
+    case FFS_DSS_MODEL_FIELD_INT32:
+        FFS_CHECK_RESULT(ffsEncodeJsonInt32Field(field->key, *(const int32_t *) member, &outputStreamCopy));
+        break;
+    case FFS_DSS_MODEL_FIELD_UINT32:
+        FFS_CHECK_RESULT(ffsEncodeJsonUint32Field(field->key, *(const uint32_t *) member, &outputStreamCopy));
+        break;
+    case FFS_DSS_MODEL_FIELD_ENUM: {
+        const char *valueString;
+        if (!field->extension.enumAdapter->format) {
+            FFS_FAIL(FFS_NOT_IMPLEMENTED);
+        }
+        FFS_CHECK_RESULT(field->extension.enumAdapter->format(member, &valueString));
+        FFS_CHECK_RESULT(ffsEncodeJsonStringField(field->key, valueString, &outputStreamCopy));
+        break;
+    }
+    case FFS_DSS_MODEL_FIELD_OBJECT: {
+        bool isEmpty;
+        FFS_CHECK_RESULT(ffsEncodeJsonStringKey(field->key, &outputStreamCopy));
+        FFS_CHECK_RESULT(ffsDssSerializeModel(field->extension.model, member, &isEmpty, &outputStreamCopy));
+
+        // Omit an empty optional object.
+        if (isEmpty && !(field->flags & FFS_DSS_MODEL_FIELD_REQUIRED)) {
+            *isSerialized = false;
+            return FFS_SUCCESS;
+        }
+        break;
+    }
+    default:
+        // 64-bit integers and raw JSON values are only ever deserialized.
+        FFS_FAIL(FFS_NOT_IMPLEMENTED);
+    }
+
+    // Update the output stream.
+    *outputStream = outputStreamCopy;
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Is an optional field empty (and therefore omitted)?
+ */
+static bool ffsDssModelFieldIsEmpty(const FfsDssModelField_t *field, const void *member)
+{
+    switch (field->type) {
+    case FFS_DSS_MODEL_FIELD_STRING:
+        return !*(const char * const *) member;
+    case FFS_DSS_MODEL_FIELD_STREAM:
+    case FFS_DSS_MODEL_FIELD_QUOTED_STREAM:
+    case FFS_DSS_MODEL_FIELD_BSSID: {
+        FfsStream_t valueStream = *(const FfsStream_t *) member;
+        return ffsStreamIsEmpty(&valueStream);
+    }
+    case FFS_DSS_MODEL_FIELD_BOOLEAN:
+        return !*(const bool *) member;
+    case FFS_DSS_MODEL_FIELD_INT32:
+        return !*(const int32_t *) member;
+    case FFS_DSS_MODEL_FIELD_UINT32:
+        return !*(const uint32_t *) member;
+    default:
+        // Enumerations always have a value; objects and custom fields decide for themselves.
+        return false;
+    }
+}
+
+/** @brief Deserialize one field value.
+ */
+static FFS_RESULT ffsDssDeserializeModelField(const FfsDssModelField_t *field, FfsJsonValue_t *value,
+        void *object, FfsJsonValue_t *capturedValues)
+{
+    void *member = FFS_DSS_MODEL_MEMBER(object, field->offset);
+
+    switch (field->type) {
+    case FFS_DSS_MODEL_FIELD_STRING:
+        FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8String(value, (const char **) member));
+        break;
+    case FFS_DSS_MODEL_FIELD_BOOLEAN:
+        FFS_CHECK_RESULT(ffsParseJsonBoolean(value, (bool *) member));
+
+        // Short-circuit on a false "gate" flag (\a e.g., "canProceed").
+        if ((field->flags & FFS_DSS_MODEL_FIELD_FAIL_IF_FALSE) && !*(bool *) member) {
+            FFS_FAIL(FFS_ERROR);
+        }
+        break;
+    case FFS_DSS_MODEL_FIELD_INT32:
+        FFS_CHECK_RESULT(ffsParseJsonInt32(value, (int32_t *) member));
+        break;
+    case FFS_DSS_MODEL_FIELD_UINT32:
+        FFS_CHECK_RESULT(ffsParseJsonUint32(value, (uint32_t *) member));
+        break;
+    case FFS_DSS_MODEL_FIELD_INT64:
+        FFS_CHECK_RESULT(ffsParseJsonInt64(value, (int64_t *) member));
+        break;
+    case FFS_DSS_MODEL_FIELD_ENUM: {
+        const char *valueString;
+        if (!field->extension.enumAdapter->parse) {
+            FFS_FAIL(FFS_NOT_IMPLEMENTED);
+        }
+        FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8String(value, &valueString));
+        FFS_CHECK_RESULT(field->extension.enumAdapter->parse(valueString, member));
+        break;
+    }
+    case FFS_DSS_MODEL_FIELD_OBJECT:
+        FFS_CHECK_RESULT(ffsDssDeserializeModel(field->extension.model, value, member, NULL));
+        break;
+    case FFS_DSS_MODEL_FIELD_JSON_VALUE:
+        capturedValues[field->offset] = *value;
+        break;
+    default:
+        // Streams and custom fields are only ever serialized.
+        FFS_FAIL(FFS_NOT_IMPLEMENTED);
+    }
+
+    return FFS_SUCCESS;
+}
@@ -0,0 +1,1079 @@
+/** @file ffs_dss_model_tables.c
+ *
+ * @brief DSS model field descriptor tables.
+ *
+ * Generated by libffs/tools/ffs_dss_model_generator.py from
+ * libffs/tools/ffs_dss_model_schema.json. Do not edit; change the schema and
+ * rebuild (or run the generator) instead.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_check_result.h"
+#include "ffs/dss/model/ffs_dss_compute_configuration_data_request.h"
+#include "ffs/dss/model/ffs_dss_compute_configuration_data_response.h"
+#include "ffs/dss/model/ffs_dss_device_details.h"
+#include "ffs/dss/model/ffs_dss_error_details.h"
+#include "ffs/dss/model/ffs_dss_get_wifi_credentials_request.h"
+#include "ffs/dss/model/ffs_dss_get_wifi_credentials_response.h"
+#include "ffs/dss/model/ffs_dss_model_tables.h"
+#include "ffs/dss/model/ffs_dss_post_wifi_scan_data_request.h"
+#include "ffs/dss/model/ffs_dss_post_wifi_scan_data_response.h"
+#include "ffs/dss/model/ffs_dss_registration_details.h"
+#include "ffs/dss/model/ffs_dss_registration_state.h"
+#include "ffs/dss/model/ffs_dss_report_request.h"
+#include "ffs/dss/model/ffs_dss_report_response.h"
+#include "ffs/dss/model/ffs_dss_report_result.h"
+#include "ffs/dss/model/ffs_dss_start_pin_based_setup_request.h"
+#include "ffs/dss/model/ffs_dss_start_pin_based_setup_response.h"
+#include "ffs/dss/model/ffs_dss_start_provisioning_session_request.h"
+#include "ffs/dss/model/ffs_dss_start_provisioning_session_response.h"
+#include "ffs/dss/model/ffs_dss_wifi_connection_attempt.h"
+#include "ffs/dss/model/ffs_dss_wifi_connection_details.h"
+#include "ffs/dss/model/ffs_dss_wifi_connection_state.h"
+#include "ffs/dss/model/ffs_dss_wifi_provisionee_state.h"
+#include "ffs/dss/model/ffs_dss_wifi_scan_result.h"
+#include "ffs/dss/model/ffs_dss_wifi_security_protocol.h"
+
+#include <stddef.h>
+
+/** @brief Parse a WifiProvisioneeState string.
+ */
+static FFS_RESULT ffsDssParseWifiProvisioneeStateValue(const char *string, void *value)
+{
+    return ffsDssParseWifiProvisioneeState(string, (FFS_DSS_WIFI_PROVISIONEE_STATE *) value);
+}
+
+/** @brief Format a WifiProvisioneeState value.
+ */
+static FFS_RESULT ffsDssFormatWifiProvisioneeStateValue(const void *value, const char **string)
+{
+    return ffsDssGetWifiProvisioneeStateString(*(const FFS_DSS_WIFI_PROVISIONEE_STATE *) value, string);
+}
+
+static const FfsDssModelEnumAdapter_t ffsDssWifiProvisioneeStateAdapter = {
+    .parse = ffsDssParseWifiProvisioneeStateValue,
+    .format = ffsDssFormatWifiProvisioneeStateValue
+};
+
+/** @brief Parse a RegistrationState string.
+ */
+static FFS_RESULT ffsDssParseRegistrationStateValue(const char *string, void *value)
+{
+    return ffsDssParseRegistrationState(string, (FFS_DSS_REGISTRATION_STATE *) value);
+}
+
+/** @brief Format a RegistrationState value.
+ */
+static FFS_RESULT ffsDssFormatRegistrationStateValue(const void *value, const char **string)
+{
+    return ffsDssGetRegistrationStateString(*(const FFS_DSS_REGISTRATION_STATE *) value, string);
+}
+
+static const FfsDssModelEnumAdapter_t ffsDssRegistrationStateAdapter = {
+    .parse = ffsDssParseRegistrationStateValue,
+    .format = ffsDssFormatRegistrationStateValue
+};
+
+/** @brief Parse a ReportResult string.
+ */
+static FFS_RESULT ffsDssParseReportResultValue(const char *string, void *value)
+{
+    return ffsDssParseReportResult(string, (FFS_DSS_REPORT_RESULT *) value);
+}
+
+/** @brief Format a ReportResult value.
+ */
+static FFS_RESULT ffsDssFormatReportResultValue(const void *value, const char **string)
+{
+    return ffsDssGetReportResultString(*(const FFS_DSS_REPORT_RESULT *) value, string);
+}
+
+static const FfsDssModelEnumAdapter_t ffsDssReportResultAdapter = {
+    .parse = ffsDssParseReportResultValue,
+    .format = ffsDssFormatReportResultValue
+};
+
+/** @brief Parse a WifiSecurityProtocol string.
+ */
+static FFS_RESULT ffsDssParseWifiSecurityProtocolValue(const char *string, void *value)
+{
+    return ffsDssParseWifiSecurityProtocol(string, (FFS_DSS_WIFI_SECURITY_PROTOCOL *) value);
+}
+
+/** @brief Format a WifiSecurityProtocol value.
+ */
+static FFS_RESULT ffsDssFormatWifiSecurityProtocolValue(const void *value, const char **string)
+{
+    return ffsDssGetWifiSecurityProtocolString(*(const FFS_DSS_WIFI_SECURITY_PROTOCOL *) value, string);
+}
+
+static const FfsDssModelEnumAdapter_t ffsDssWifiSecurityProtocolAdapter = {
+    .parse = ffsDssParseWifiSecurityProtocolValue,
+    .format = ffsDssFormatWifiSecurityProtocolValue
+};
+
+/** @brief Parse a WifiConnectionState string.
+ */
+static FFS_RESULT ffsDssParseWifiConnectionStateValue(const char *string, void *value)
+{
+    return ffsDssParseWifiConnectionState(string, (FFS_DSS_WIFI_CONNECTION_STATE *) value);
+}
+
+/** @brief Format a WifiConnectionState value.
+ */
+static FFS_RESULT ffsDssFormatWifiConnectionStateValue(const void *value, const char **string)
+{
+    return ffsDssGetWifiConnectionStateString(*(const FFS_DSS_WIFI_CONNECTION_STATE *) value, string);
+}
+
+static const FfsDssModelEnumAdapter_t ffsDssWifiConnectionStateAdapter = {
+    .parse = ffsDssParseWifiConnectionStateValue,
+    .format = ffsDssFormatWifiConnectionStateValue
+};
+
+/** @brief Serialize a DeviceDetails field.
+ */
+static FFS_RESULT ffsDssSerializeDeviceDetailsFieldValue(const void *member, FfsStream_t *outputStream)
+{
+    return ffsDssSerializeDeviceDetailsField((FfsDssDeviceDetails_t *) member, outputStream);
+}
+
+static const FfsDssModelField_t ffsDssErrorDetailsFields[] = {
+    {
+        .key = "operation",
+        .keySize = 9,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = 0,
+        .offset = offsetof(FfsDssErrorDetails_t, operation),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "cause",
+        .keySize = 5,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = 0,
+        .offset = offsetof(FfsDssErrorDetails_t, cause),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "details",
+        .keySize = 7,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = 0,
+        .offset = offsetof(FfsDssErrorDetails_t, details),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "code",
+        .keySize = 4,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = 0,
+        .offset = offsetof(FfsDssErrorDetails_t, code),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    }
+};
+
+static const uint8_t ffsDssErrorDetailsLookup[] = { 3, 1, 2, 0 };
+
+static const uint8_t ffsDssErrorDetailsLookupIndex[] = { 0, 0, 0, 0, 0, 1, 2, 2, 3, 3, 4 };
+
+const FfsDssModelDescriptor_t ffsDssErrorDetailsModel = {
+    .fields = ffsDssErrorDetailsFields,
+    .fieldCount = 4,
+    .maximumKeySize = 9,
+    .objectSize = sizeof(FfsDssErrorDetails_t),
+    .lookup = ffsDssErrorDetailsLookup,
+    .lookupIndex = ffsDssErrorDetailsLookupIndex
+};
+
+static const FfsDssModelField_t ffsDssRegistrationDetailsFields[] = {
+    {
+        .key = "registrationToken",
+        .keySize = 17,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = 0,
+        .offset = offsetof(FfsDssRegistrationDetails_t, registrationToken),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "expiresAt",
+        .keySize = 9,
+        .type = FFS_DSS_MODEL_FIELD_INT64,
+        .jsonType = FFS_JSON_NUMBER,
+        .flags = 0,
+        .offset = offsetof(FfsDssRegistrationDetails_t, expiresAt),
+        .presenceOffset = offsetof(FfsDssRegistrationDetails_t, hasExpiresAt),
+        .extension = { .model = NULL }
+    }
+};
+
+static const uint8_t ffsDssRegistrationDetailsLookup[] = { 1, 0 };
+
+static const uint8_t ffsDssRegistrationDetailsLookupIndex[] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2 };
+
+const FfsDssModelDescriptor_t ffsDssRegistrationDetailsModel = {
+    .fields = ffsDssRegistrationDetailsFields,
+    .fieldCount = 2,
+    .maximumKeySize = 17,
+    .objectSize = sizeof(FfsDssRegistrationDetails_t),
+    .lookup = ffsDssRegistrationDetailsLookup,
+    .lookupIndex = ffsDssRegistrationDetailsLookupIndex
+};
+
+static const FfsDssModelField_t ffsDssStartProvisioningSessionRequestFields[] = {
+    {
+        .key = "nonce",
+        .keySize = 5,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssStartProvisioningSessionRequest_t, nonce),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    }
+};
+
+static const uint8_t ffsDssStartProvisioningSessionRequestLookup[] = { 0 };
+
+static const uint8_t ffsDssStartProvisioningSessionRequestLookupIndex[] = { 0, 0, 0, 0, 0, 0, 1 };
+
+const FfsDssModelDescriptor_t ffsDssStartProvisioningSessionRequestModel = {
+    .fields = ffsDssStartProvisioningSessionRequestFields,
+    .fieldCount = 1,
+    .maximumKeySize = 5,
+    .objectSize = sizeof(FfsDssStartProvisioningSessionRequest_t),
+    .lookup = ffsDssStartProvisioningSessionRequestLookup,
+    .lookupIndex = ffsDssStartProvisioningSessionRequestLookupIndex
+};
+
+static const FfsDssModelField_t ffsDssStartProvisioningSessionResponseFields[] = {
+    {
+        .key = "nonce",
+        .keySize = 5,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssStartProvisioningSessionResponse_t, nonce),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "sessionId",
+        .keySize = 9,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssStartProvisioningSessionResponse_t, sessionId),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "canProceed",
+        .keySize = 10,
+        .type = FFS_DSS_MODEL_FIELD_BOOLEAN,
+        .jsonType = FFS_JSON_BOOLEAN,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssStartProvisioningSessionResponse_t, canProceed),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "salt",
+        .keySize = 4,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssStartProvisioningSessionResponse_t, salt),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    }
+};
+
+static const uint8_t ffsDssStartProvisioningSessionResponseLookup[] = { 3, 0, 1, 2 };
+
+static const uint8_t ffsDssStartProvisioningSessionResponseLookupIndex[] = { 0, 0, 0, 0, 0, 1, 2, 2, 2, 2, 3, 4 };
+
+const FfsDssModelDescriptor_t ffsDssStartProvisioningSessionResponseModel = {
+    .fields = ffsDssStartProvisioningSessionResponseFields,
+    .fieldCount = 4,
+    .maximumKeySize = 10,
+    .objectSize = sizeof(FfsDssStartProvisioningSessionResponse_t),
+    .lookup = ffsDssStartProvisioningSessionResponseLookup,
+    .lookupIndex = ffsDssStartProvisioningSessionResponseLookupIndex
+};
+
+static const FfsDssModelField_t ffsDssStartPinBasedSetupRequestFields[] = {
+    {
+        .key = "nonce",
+        .keySize = 5,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssStartPinBasedSetupRequest_t, nonce),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "sessionId",
+        .keySize = 9,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssStartPinBasedSetupRequest_t, sessionId),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "deviceDetails",
+        .keySize = 13,
+        .type = FFS_DSS_MODEL_FIELD_CUSTOM,
+        .jsonType = FFS_JSON_OBJECT,
+        .flags = 0,
+        .offset = offsetof(FfsDssStartPinBasedSetupRequest_t, deviceDetails),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .serializeField = ffsDssSerializeDeviceDetailsFieldValue }
+    }
+};
+
+static const uint8_t ffsDssStartPinBasedSetupRequestLookup[] = { 0, 1, 2 };
+
+static const uint8_t ffsDssStartPinBasedSetupRequestLookupIndex[] = { 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3 };
+
+const FfsDssModelDescriptor_t ffsDssStartPinBasedSetupRequestModel = {
+    .fields = ffsDssStartPinBasedSetupRequestFields,
+    .fieldCount = 3,
+    .maximumKeySize = 13,
+    .objectSize = sizeof(FfsDssStartPinBasedSetupRequest_t),
+    .lookup = ffsDssStartPinBasedSetupRequestLookup,
+    .lookupIndex = ffsDssStartPinBasedSetupRequestLookupIndex
+};
+
+static const FfsDssModelField_t ffsDssStartPinBasedSetupResponseFields[] = {
+    {
+        .key = "nonce",
+        .keySize = 5,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssStartPinBasedSetupResponse_t, nonce),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "canProceed",
+        .keySize = 10,
+        .type = FFS_DSS_MODEL_FIELD_BOOLEAN,
+        .jsonType = FFS_JSON_BOOLEAN,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssStartPinBasedSetupResponse_t, canProceed),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    }
+};
+
+static const uint8_t ffsDssStartPinBasedSetupResponseLookup[] = { 0, 1 };
+
+static const uint8_t ffsDssStartPinBasedSetupResponseLookupIndex[] = { 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 2 };
+
+const FfsDssModelDescriptor_t ffsDssStartPinBasedSetupResponseModel = {
+    .fields = ffsDssStartPinBasedSetupResponseFields,
+    .fieldCount = 2,
+    .maximumKeySize = 10,
+    .objectSize = sizeof(FfsDssStartPinBasedSetupResponse_t),
+    .lookup = ffsDssStartPinBasedSetupResponseLookup,
+    .lookupIndex = ffsDssStartPinBasedSetupResponseLookupIndex
+};
+
+static const FfsDssModelField_t ffsDssComputeConfigurationDataRequestFields[] = {
+    {
+        .key = "nonce",
+        .keySize = 5,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssComputeConfigurationDataRequest_t, nonce),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "sessionId",
+        .keySize = 9,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssComputeConfigurationDataRequest_t, sessionId),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "deviceDetails",
+        .keySize = 13,
+        .type = FFS_DSS_MODEL_FIELD_CUSTOM,
+        .jsonType = FFS_JSON_OBJECT,
+        .flags = 0,
+        .offset = offsetof(FfsDssComputeConfigurationDataRequest_t, deviceDetails),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .serializeField = ffsDssSerializeDeviceDetailsFieldValue }
+    }
+};
+
+static const uint8_t ffsDssComputeConfigurationDataRequestLookup[] = { 0, 1, 2 };
+
+static const uint8_t ffsDssComputeConfigurationDataRequestLookupIndex[] = { 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3 };
+
+const FfsDssModelDescriptor_t ffsDssComputeConfigurationDataRequestModel = {
+    .fields = ffsDssComputeConfigurationDataRequestFields,
+    .fieldCount = 3,
+    .maximumKeySize = 13,
+    .objectSize = sizeof(FfsDssComputeConfigurationDataRequest_t),
+    .lookup = ffsDssComputeConfigurationDataRequestLookup,
+    .lookupIndex = ffsDssComputeConfigurationDataRequestLookupIndex
+};
+
+static const FfsDssModelField_t ffsDssComputeConfigurationDataResponseFields[] = {
+    {
+        .key = "nonce",
+        .keySize = 5,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssComputeConfigurationDataResponse_t, nonce),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "configuration",
+        .keySize = 13,
+        .type = FFS_DSS_MODEL_FIELD_JSON_VALUE,
+        .jsonType = FFS_JSON_OBJECT,
+        .flags = 0,
+        .offset = 0,
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "registrationDetails",
+        .keySize = 19,
+        .type = FFS_DSS_MODEL_FIELD_OBJECT,
+        .jsonType = FFS_JSON_OBJECT,
+        .flags = 0,
+        .offset = offsetof(FfsDssComputeConfigurationDataResponse_t, registrationDetails),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = &ffsDssRegistrationDetailsModel }
+    }
+};
+
+static const uint8_t ffsDssComputeConfigurationDataResponseLookup[] = { 0, 1, 2 };
+
+static const uint8_t ffsDssComputeConfigurationDataResponseLookupIndex[] = { 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 3 };
+
+const FfsDssModelDescriptor_t ffsDssComputeConfigurationDataResponseModel = {
+    .fields = ffsDssComputeConfigurationDataResponseFields,
+    .fieldCount = 3,
+    .maximumKeySize = 19,
+    .objectSize = sizeof(FfsDssComputeConfigurationDataResponse_t),
+    .lookup = ffsDssComputeConfigurationDataResponseLookup,
+    .lookupIndex = ffsDssComputeConfigurationDataResponseLookupIndex
+};
+
+static const FfsDssModelField_t ffsDssPostWifiScanDataRequestFields[] = {
+    {
+        .key = "nonce",
+        .keySize = 5,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssPostWifiScanDataRequest_t, nonce),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "sessionId",
+        .keySize = 9,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssPostWifiScanDataRequest_t, sessionId),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "deviceDetails",
+        .keySize = 13,
+        .type = FFS_DSS_MODEL_FIELD_CUSTOM,
+        .jsonType = FFS_JSON_OBJECT,
+        .flags = 0,
+        .offset = offsetof(FfsDssPostWifiScanDataRequest_t, deviceDetails),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .serializeField = ffsDssSerializeDeviceDetailsFieldValue }
+    },
+    {
+        .key = "sequenceNumber",
+        .keySize = 14,
+        .type = FFS_DSS_MODEL_FIELD_UINT32,
+        .jsonType = FFS_JSON_NUMBER,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssPostWifiScanDataRequest_t, sequenceNumber),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    }
+};
+
+static const uint8_t ffsDssPostWifiScanDataRequestLookup[] = { 0, 1, 2, 3 };
+
+static const uint8_t ffsDssPostWifiScanDataRequestLookupIndex[] = { 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 4 };
+
+const FfsDssModelDescriptor_t ffsDssPostWifiScanDataRequestModel = {
+    .fields = ffsDssPostWifiScanDataRequestFields,
+    .fieldCount = 4,
+    .maximumKeySize = 14,
+    .objectSize = sizeof(FfsDssPostWifiScanDataRequest_t),
+    .lookup = ffsDssPostWifiScanDataRequestLookup,
+    .lookupIndex = ffsDssPostWifiScanDataRequestLookupIndex
+};
+
+static const FfsDssModelField_t ffsDssPostWifiScanDataResponseFields[] = {
+    {
+        .key = "canProceed",
+        .keySize = 10,
+        .type = FFS_DSS_MODEL_FIELD_BOOLEAN,
+        .jsonType = FFS_JSON_BOOLEAN,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED | FFS_DSS_MODEL_FIELD_FAIL_IF_FALSE,
+        .offset = offsetof(FfsDssPostWifiScanDataResponse_t, canProceed),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "nonce",
+        .keySize = 5,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssPostWifiScanDataResponse_t, nonce),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "sessionId",
+        .keySize = 9,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssPostWifiScanDataResponse_t, sessionId),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "sequenceNumber",
+        .keySize = 14,
+        .type = FFS_DSS_MODEL_FIELD_UINT32,
+        .jsonType = FFS_JSON_NUMBER,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssPostWifiScanDataResponse_t, sequenceNumber),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "totalCredentialsFound",
+        .keySize = 21,
+        .type = FFS_DSS_MODEL_FIELD_UINT32,
+        .jsonType = FFS_JSON_NUMBER,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssPostWifiScanDataResponse_t, totalCredentialsFound),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "allCredentialsFound",
+        .keySize = 19,
+        .type = FFS_DSS_MODEL_FIELD_BOOLEAN,
+        .jsonType = FFS_JSON_BOOLEAN,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssPostWifiScanDataResponse_t, allCredentialsFound),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    }
+};
+
+static const uint8_t ffsDssPostWifiScanDataResponseLookup[] = { 1, 2, 0, 3, 5, 4 };
+
+static const uint8_t ffsDssPostWifiScanDataResponseLookupIndex[] = { 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 3, 3, 3, 3, 4, 4, 4, 4, 4, 5, 5, 6 };
+
+const FfsDssModelDescriptor_t ffsDssPostWifiScanDataResponseModel = {
+    .fields = ffsDssPostWifiScanDataResponseFields,
+    .fieldCount = 6,
+    .maximumKeySize = 21,
+    .objectSize = sizeof(FfsDssPostWifiScanDataResponse_t),
+    .lookup = ffsDssPostWifiScanDataResponseLookup,
+    .lookupIndex = ffsDssPostWifiScanDataResponseLookupIndex
+};
+
+static const FfsDssModelField_t ffsDssGetWifiCredentialsRequestFields[] = {
+    {
+        .key = "nonce",
+        .keySize = 5,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssGetWifiCredentialsRequest_t, nonce),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "sessionId",
+        .keySize = 9,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssGetWifiCredentialsRequest_t, sessionId),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "deviceDetails",
+        .keySize = 13,
+        .type = FFS_DSS_MODEL_FIELD_CUSTOM,
+        .jsonType = FFS_JSON_OBJECT,
+        .flags = 0,
+        .offset = offsetof(FfsDssGetWifiCredentialsRequest_t, deviceDetails),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .serializeField = ffsDssSerializeDeviceDetailsFieldValue }
+    },
+    {
+        .key = "sequenceNumber",
+        .keySize = 14,
+        .type = FFS_DSS_MODEL_FIELD_UINT32,
+        .jsonType = FFS_JSON_NUMBER,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssGetWifiCredentialsRequest_t, sequenceNumber),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    }
+};
+
+static const uint8_t ffsDssGetWifiCredentialsRequestLookup[] = { 0, 1, 2, 3 };
+
+static const uint8_t ffsDssGetWifiCredentialsRequestLookupIndex[] = { 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 4 };
+
+const FfsDssModelDescriptor_t ffsDssGetWifiCredentialsRequestModel = {
+    .fields = ffsDssGetWifiCredentialsRequestFields,
+    .fieldCount = 4,
+    .maximumKeySize = 14,
+    .objectSize = sizeof(FfsDssGetWifiCredentialsRequest_t),
+    .lookup = ffsDssGetWifiCredentialsRequestLookup,
+    .lookupIndex = ffsDssGetWifiCredentialsRequestLookupIndex
+};
+
+static const FfsDssModelField_t ffsDssGetWifiCredentialsResponseFields[] = {
+    {
+        .key = "canProceed",
+        .keySize = 10,
+        .type = FFS_DSS_MODEL_FIELD_BOOLEAN,
+        .jsonType = FFS_JSON_BOOLEAN,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED | FFS_DSS_MODEL_FIELD_FAIL_IF_FALSE,
+        .offset = offsetof(FfsDssGetWifiCredentialsResponse_t, canProceed),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "nonce",
+        .keySize = 5,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssGetWifiCredentialsResponse_t, nonce),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "sequenceNumber",
+        .keySize = 14,
+        .type = FFS_DSS_MODEL_FIELD_UINT32,
+        .jsonType = FFS_JSON_NUMBER,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssGetWifiCredentialsResponse_t, sequenceNumber),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "allCredentialsReturned",
+        .keySize = 22,
+        .type = FFS_DSS_MODEL_FIELD_BOOLEAN,
+        .jsonType = FFS_JSON_BOOLEAN,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssGetWifiCredentialsResponse_t, allCredentialsReturned),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "wifiCredentialsList",
+        .keySize = 19,
+        .type = FFS_DSS_MODEL_FIELD_JSON_VALUE,
+        .jsonType = FFS_JSON_ARRAY,
+        .flags = 0,
+        .offset = 0,
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    }
+};
+
+static const uint8_t ffsDssGetWifiCredentialsResponseLookup[] = { 1, 0, 2, 4, 3 };
+
+static const uint8_t ffsDssGetWifiCredentialsResponseLookupIndex[] = { 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 4, 4, 4, 5 };
+
+const FfsDssModelDescriptor_t ffsDssGetWifiCredentialsResponseModel = {
+    .fields = ffsDssGetWifiCredentialsResponseFields,
+    .fieldCount = 5,
+    .maximumKeySize = 22,
+    .objectSize = sizeof(FfsDssGetWifiCredentialsResponse_t),
+    .lookup = ffsDssGetWifiCredentialsResponseLookup,
+    .lookupIndex = ffsDssGetWifiCredentialsResponseLookupIndex
+};
+
+static const FfsDssModelField_t ffsDssReportRequestFields[] = {
+    {
+        .key = "nonce",
+        .keySize = 5,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssReportRequest_t, nonce),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "sessionId",
+        .keySize = 9,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssReportRequest_t, sessionId),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "deviceDetails",
+        .keySize = 13,
+        .type = FFS_DSS_MODEL_FIELD_CUSTOM,
+        .jsonType = FFS_JSON_OBJECT,
+        .flags = 0,
+        .offset = offsetof(FfsDssReportRequest_t, deviceDetails),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .serializeField = ffsDssSerializeDeviceDetailsFieldValue }
+    },
+    {
+        .key = "sequenceNumber",
+        .keySize = 14,
+        .type = FFS_DSS_MODEL_FIELD_INT32,
+        .jsonType = FFS_JSON_NUMBER,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssReportRequest_t, sequenceNumber),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "currentProvisioningState",
+        .keySize = 24,
+        .type = FFS_DSS_MODEL_FIELD_ENUM,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssReportRequest_t, provisioneeState),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .enumAdapter = &ffsDssWifiProvisioneeStateAdapter }
+    },
+    {
+        .key = "registrationState",
+        .keySize = 17,
+        .type = FFS_DSS_MODEL_FIELD_ENUM,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssReportRequest_t, registrationState),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .enumAdapter = &ffsDssRegistrationStateAdapter }
+    },
+    {
+        .key = "stateTransitionResult",
+        .keySize = 21,
+        .type = FFS_DSS_MODEL_FIELD_ENUM,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssReportRequest_t, stateTransitionResult),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .enumAdapter = &ffsDssReportResultAdapter }
+    }
+};
+
+static const uint8_t ffsDssReportRequestLookup[] = { 0, 1, 2, 3, 5, 6, 4 };
+
+static const uint8_t ffsDssReportRequestLookupIndex[] = { 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 7 };
+
+const FfsDssModelDescriptor_t ffsDssReportRequestModel = {
+    .fields = ffsDssReportRequestFields,
+    .fieldCount = 7,
+    .maximumKeySize = 24,
+    .objectSize = sizeof(FfsDssReportRequest_t),
+    .lookup = ffsDssReportRequestLookup,
+    .lookupIndex = ffsDssReportRequestLookupIndex
+};
+
+static const FfsDssModelField_t ffsDssReportResponseFields[] = {
+    {
+        .key = "nonce",
+        .keySize = 5,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssReportResponse_t, nonce),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "canProceed",
+        .keySize = 10,
+        .type = FFS_DSS_MODEL_FIELD_BOOLEAN,
+        .jsonType = FFS_JSON_BOOLEAN,
+        .flags = 0,
+        .offset = offsetof(FfsDssReportResponse_t, canProceed),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "nextProvisioningState",
+        .keySize = 21,
+        .type = FFS_DSS_MODEL_FIELD_ENUM,
+        .jsonType = FFS_JSON_STRING,
+        .flags = 0,
+        .offset = offsetof(FfsDssReportResponse_t, nextProvisioningState),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .enumAdapter = &ffsDssWifiProvisioneeStateAdapter }
+    },
+    {
+        .key = "waitTime",
+        .keySize = 8,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = 0,
+        .offset = offsetof(FfsDssReportResponse_t, waitTime),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "reason",
+        .keySize = 6,
+        .type = FFS_DSS_MODEL_FIELD_STRING,
+        .jsonType = FFS_JSON_STRING,
+        .flags = 0,
+        .offset = offsetof(FfsDssReportResponse_t, reason),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    }
+};
+
+static const uint8_t ffsDssReportResponseLookup[] = { 0, 4, 3, 1, 2 };
+
+static const uint8_t ffsDssReportResponseLookupIndex[] = { 0, 0, 0, 0, 0, 0, 1, 2, 2, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 5 };
+
+const FfsDssModelDescriptor_t ffsDssReportResponseModel = {
+    .fields = ffsDssReportResponseFields,
+    .fieldCount = 5,
+    .maximumKeySize = 21,
+    .objectSize = sizeof(FfsDssReportResponse_t),
+    .lookup = ffsDssReportResponseLookup,
+    .lookupIndex = ffsDssReportResponseLookupIndex
+};
+
+static const FfsDssModelField_t ffsDssWifiScanResultFields[] = {
+    {
+        .key = "ssid",
+        .keySize = 4,
+        .type = FFS_DSS_MODEL_FIELD_QUOTED_STREAM,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssWifiScanResult_t, ssidStream),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "bssid",
+        .keySize = 5,
+        .type = FFS_DSS_MODEL_FIELD_BSSID,
+        .jsonType = FFS_JSON_STRING,
+        .flags = 0,
+        .offset = offsetof(FfsDssWifiScanResult_t, bssidStream),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "securityProtocol",
+        .keySize = 16,
+        .type = FFS_DSS_MODEL_FIELD_ENUM,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssWifiScanResult_t, securityProtocol),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .enumAdapter = &ffsDssWifiSecurityProtocolAdapter }
+    },
+    {
+        .key = "rssi",
+        .keySize = 4,
+        .type = FFS_DSS_MODEL_FIELD_INT32,
+        .jsonType = FFS_JSON_NUMBER,
+        .flags = 0,
+        .offset = offsetof(FfsDssWifiScanResult_t, signalStrength),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "frequency",
+        .keySize = 9,
+        .type = FFS_DSS_MODEL_FIELD_INT32,
+        .jsonType = FFS_JSON_NUMBER,
+        .flags = 0,
+        .offset = offsetof(FfsDssWifiScanResult_t, frequencyBand),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    }
+};
+
+static const uint8_t ffsDssWifiScanResultLookup[] = { 3, 0, 1, 4, 2 };
+
+static const uint8_t ffsDssWifiScanResultLookupIndex[] = { 0, 0, 0, 0, 0, 2, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 5 };
+
+const FfsDssModelDescriptor_t ffsDssWifiScanResultModel = {
+    .fields = ffsDssWifiScanResultFields,
+    .fieldCount = 5,
+    .maximumKeySize = 16,
+    .objectSize = sizeof(FfsDssWifiScanResult_t),
+    .lookup = ffsDssWifiScanResultLookup,
+    .lookupIndex = ffsDssWifiScanResultLookupIndex
+};
+
+static const FfsDssModelField_t ffsDssWifiConnectionAttemptFields[] = {
+    {
+        .key = "ssid",
+        .keySize = 4,
+        .type = FFS_DSS_MODEL_FIELD_STREAM,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssWifiConnectionAttempt_t, ssidStream),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "securityProtocol",
+        .keySize = 16,
+        .type = FFS_DSS_MODEL_FIELD_ENUM,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssWifiConnectionAttempt_t, securityProtocol),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .enumAdapter = &ffsDssWifiSecurityProtocolAdapter }
+    },
+    {
+        .key = "wifiConnectionState",
+        .keySize = 19,
+        .type = FFS_DSS_MODEL_FIELD_ENUM,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssWifiConnectionAttempt_t, state),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .enumAdapter = &ffsDssWifiConnectionStateAdapter }
+    },
+    {
+        .key = "errorDetails",
+        .keySize = 12,
+        .type = FFS_DSS_MODEL_FIELD_OBJECT,
+        .jsonType = FFS_JSON_OBJECT,
+        .flags = 0,
+        .offset = offsetof(FfsDssWifiConnectionAttempt_t, errorDetails),
+        .presenceOffset = offsetof(FfsDssWifiConnectionAttempt_t, hasErrorDetails),
+        .extension = { .model = &ffsDssErrorDetailsModel }
+    }
+};
+
+static const uint8_t ffsDssWifiConnectionAttemptLookup[] = { 0, 3, 1, 2 };
+
+static const uint8_t ffsDssWifiConnectionAttemptLookupIndex[] = { 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 4 };
+
+const FfsDssModelDescriptor_t ffsDssWifiConnectionAttemptModel = {
+    .fields = ffsDssWifiConnectionAttemptFields,
+    .fieldCount = 4,
+    .maximumKeySize = 19,
+    .objectSize = sizeof(FfsDssWifiConnectionAttempt_t),
+    .lookup = ffsDssWifiConnectionAttemptLookup,
+    .lookupIndex = ffsDssWifiConnectionAttemptLookupIndex
+};
+
+static const FfsDssModelField_t ffsDssWifiConnectionDetailsFields[] = {
+    {
+        .key = "ssid",
+        .keySize = 4,
+        .type = FFS_DSS_MODEL_FIELD_QUOTED_STREAM,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssWifiConnectionDetails_t, ssidStream),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .model = NULL }
+    },
+    {
+        .key = "securityProtocol",
+        .keySize = 16,
+        .type = FFS_DSS_MODEL_FIELD_ENUM,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssWifiConnectionDetails_t, securityProtocol),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .enumAdapter = &ffsDssWifiSecurityProtocolAdapter }
+    },
+    {
+        .key = "wifiConnectionState",
+        .keySize = 19,
+        .type = FFS_DSS_MODEL_FIELD_ENUM,
+        .jsonType = FFS_JSON_STRING,
+        .flags = FFS_DSS_MODEL_FIELD_REQUIRED,
+        .offset = offsetof(FfsDssWifiConnectionDetails_t, state),
+        .presenceOffset = FFS_DSS_MODEL_NO_PRESENCE_FLAG,
+        .extension = { .enumAdapter = &ffsDssWifiConnectionStateAdapter }
+    },
+    {
+        .key = "errorDetails",
+        .keySize = 12,
+        .type = FFS_DSS_MODEL_FIELD_OBJECT,
+        .jsonType = FFS_JSON_OBJECT,
+        .flags = 0,
+        .offset = offsetof(FfsDssWifiConnectionDetails_t, errorDetails),
+        .presenceOffset = offsetof(FfsDssWifiConnectionDetails_t, hasErrorDetails),
+        .extension = { .model = &ffsDssErrorDetailsModel }
+    }
+};
+
+static const uint8_t ffsDssWifiConnectionDetailsLookup[] = { 0, 3, 1, 2 };
+
+static const uint8_t ffsDssWifiConnectionDetailsLookupIndex[] = { 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 4 };
+
+const FfsDssModelDescriptor_t ffsDssWifiConnectionDetailsModel = {
+    .fields = ffsDssWifiConnectionDetailsFields,
+    .fieldCount = 4,
+    .maximumKeySize = 19,
+    .objectSize = sizeof(FfsDssWifiConnectionDetails_t),
+    .lookup = ffsDssWifiConnectionDetailsLookup,
+    .lookupIndex = ffsDssWifiConnectionDetailsLookupIndex
+};
@@ -14,13 +14,11 @@
 
 #include "ffs/common/ffs_check_result.h"
 #include "ffs/dss/model/ffs_dss_device_details.h"
+#include "ffs/dss/model/ffs_dss_model_tables.h"
 #include "ffs/dss/model/ffs_dss_post_wifi_scan_data_request.h"
 
 #include <stdbool.h>
 
-#define JSON_KEY_NONCE                    "nonce"
-#define JSON_KEY_SESSION_ID               "sessionId"
-#define JSON_KEY_SEQUENCE_NUMBER          "sequenceNumber"
 #define JSON_KEY_WIFI_SCAN_DATA_LIST      "wifiScanDataList"
 
 /*
@@ -29,25 +27,8 @@
 FFS_RESULT ffsDssStartSerializingPostWifiScanDataRequest(
         FfsDssPostWifiScanDataRequest_t *postWifiScanDataRequest, FfsStream_t *outputStream)
 {
-    // Start the "post Wi-Fi scan data" request object.
-    FFS_CHECK_RESULT(ffsEncodeJsonObjectStart(outputStream));
-
-    // Serialize the nonce field.
-    FFS_CHECK_RESULT(ffsEncodeJsonStringField(JSON_KEY_NONCE, postWifiScanDataRequest->nonce,
-            outputStream));
-
-    // Serialize the session ID field.
-    FFS_CHECK_RESULT(ffsEncodeJsonSeparator(outputStream));
-    FFS_CHECK_RESULT(ffsEncodeJsonStringField(JSON_KEY_SESSION_ID, postWifiScanDataRequest->sessionId,
-            outputStream));
-
-    // Serialize the device details field.
-    FFS_CHECK_RESULT(ffsDssSerializeDeviceDetailsField(&postWifiScanDataRequest->deviceDetails,
-            outputStream));
-
-    // Serialize the sequence number.
-    FFS_CHECK_RESULT(ffsEncodeJsonSeparator(outputStream));
-    FFS_CHECK_RESULT(ffsEncodeJsonUint32Field(JSON_KEY_SEQUENCE_NUMBER, postWifiScanDataRequest->sequenceNumber,
+    // Serialize {"nonce":"...","sessionId":"...","deviceDetails":{...},"sequenceNumber":...
+    FFS_CHECK_RESULT(ffsDssStartSerializingModel(&ffsDssPostWifiScanDataRequestModel, postWifiScanDataRequest,
             outputStream));
 
     // Start the Wi-Fi scan result list.
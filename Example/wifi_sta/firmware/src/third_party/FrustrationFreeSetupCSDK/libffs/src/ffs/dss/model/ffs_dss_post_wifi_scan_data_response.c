@@ -13,15 +13,9 @@
  */
 
 #include "ffs/common/ffs_check_result.h"
+#include "ffs/dss/model/ffs_dss_model_tables.h"
 #include "ffs/dss/model/ffs_dss_post_wifi_scan_data_response.h"
 
-#define JSON_KEY_NONCE                      "nonce"
-#define JSON_KEY_SESSION_ID                 "sessionId"
-#define JSON_KEY_CAN_PROCEED                "canProceed"
-#define JSON_KEY_SEQUENCE_NUMBER            "sequenceNumber"
-#define JSON_KEY_TOTAL_CREDENTIALS_FOUND    "totalCredentialsFound"
-#define JSON_KEY_ALL_CREDENTIALS_FOUND      "allCredentialsFound"
-
 /*
  * Serialize a DSS "post Wi-Fi scan data" response.
  */
@@ -42,56 +36,10 @@ FFS_RESULT ffsDssDeserializePostWifiScanDataResponse(
         FfsJsonValue_t *postWifiScanDataResponseValue,
         FfsDssPostWifiScanDataResponse_t *postWifiScanDataResponse)
 {
-    // Zero out the "post Wi-Fi scan data" response.
-    memset(postWifiScanDataResponse, 0, sizeof(*postWifiScanDataResponse));
-
-    /* Parse { "nonce":"...",
-            "sessionId":"...",
-            "canProceed":"...",
-            "sequenceNumber":...,
-            "totalCredentialsFound":...,
-            "allCredentialsFound":"..." } */
-    FfsJsonField_t nonceField = ffsCreateJsonField(JSON_KEY_NONCE, FFS_JSON_STRING);
-    FfsJsonField_t sessionIdField = ffsCreateJsonField(JSON_KEY_SESSION_ID, FFS_JSON_STRING);
-    FfsJsonField_t canProceedField = ffsCreateJsonField(JSON_KEY_CAN_PROCEED, FFS_JSON_BOOLEAN);
-    FfsJsonField_t sequenceNumberField = ffsCreateJsonField(JSON_KEY_SEQUENCE_NUMBER, FFS_JSON_NUMBER);
-    FfsJsonField_t totalCredentialsFoundField = ffsCreateJsonField(JSON_KEY_TOTAL_CREDENTIALS_FOUND, FFS_JSON_NUMBER);
-    FfsJsonField_t allCredentialsFoundField = ffsCreateJsonField(JSON_KEY_ALL_CREDENTIALS_FOUND, FFS_JSON_BOOLEAN);
-
-    FfsJsonField_t *postWifiScanDataResponseExpectedFields[] = {
-            &nonceField,
-            &sessionIdField,
-            &canProceedField,
-            &sequenceNumberField,
-            &totalCredentialsFoundField,
-            &allCredentialsFoundField,
-            NULL };
-
-    FFS_CHECK_RESULT(ffsParseJsonObject(postWifiScanDataResponseValue,
-            postWifiScanDataResponseExpectedFields));
-
-    // Parse the 'canProceed' value.
-    FFS_CHECK_RESULT(ffsParseJsonBoolean(&canProceedField.value, &postWifiScanDataResponse->canProceed));
-
-    // Short-circuit if the 'canProceed' value is false.
-    if (!postWifiScanDataResponse->canProceed) {
-        FFS_FAIL(FFS_ERROR);
-    }
-
-    // Parse the nonce.
-    FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8String(&nonceField.value, &postWifiScanDataResponse->nonce));
-
-    // Parse the session ID.
-    FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8String(&sessionIdField.value, &postWifiScanDataResponse->sessionId));
-
-    // Parse the 'sequenceNumber' value.
-    FFS_CHECK_RESULT(ffsParseJsonUint32(&sequenceNumberField.value, &postWifiScanDataResponse->sequenceNumber));
-
-    // Parse the 'totalCredentialsFound' value.
-    FFS_CHECK_RESULT(ffsParseJsonUint32(&totalCredentialsFoundField.value, &postWifiScanDataResponse->totalCredentialsFound));
-
-    // Parse the 'allCredentialsFound' value.
-    FFS_CHECK_RESULT(ffsParseJsonBoolean(&allCredentialsFoundField.value, &postWifiScanDataResponse->allCredentialsFound));
+    // Parse {"nonce":"...","sessionId":"...","canProceed":...,"sequenceNumber":...,
+    // "totalCredentialsFound":...,"allCredentialsFound":...}, failing if "canProceed" is false.
+    FFS_CHECK_RESULT(ffsDssDeserializeModel(&ffsDssPostWifiScanDataResponseModel,
+            postWifiScanDataResponseValue, postWifiScanDataResponse, NULL));
 
     return FFS_SUCCESS;
 }
@@ -13,11 +13,9 @@
  */
 
 #include "ffs/common/ffs_check_result.h"
+#include "ffs/dss/model/ffs_dss_model_tables.h"
 #include "ffs/dss/model/ffs_dss_registration_details.h"
 
-#define JSON_KEY_REGISTRATION_TOKEN     "registrationToken"
-#define JSON_KEY_EXPIRES_AT             "expiresAt"
-
 /*
  * Serialize DSS registration details.
  */
@@ -36,32 +34,9 @@ FFS_RESULT ffsDssSerializeRegistrationDetails(FfsDssRegistrationDetails_t *regis
 FFS_RESULT ffsDssDeserializeRegistrationDetails(FfsJsonValue_t *registrationDetailsValue,
         FfsDssRegistrationDetails_t *registrationDetails)
 {
-    // Zero out the registration details object.
-    memset(registrationDetails, 0, sizeof(*registrationDetails));
-
     // Parse {"registrationToken":"...","expiresAt":...}.
-    FfsJsonField_t registrationTokenField = ffsCreateJsonField(JSON_KEY_REGISTRATION_TOKEN,
-            FFS_JSON_STRING);
-    FfsJsonField_t expiresAtField = ffsCreateJsonField(JSON_KEY_EXPIRES_AT, FFS_JSON_NUMBER);
-    FfsJsonField_t *registrationDetailsExpectedFields[] = { &registrationTokenField, &expiresAtField, NULL };
-
-    FFS_CHECK_RESULT(ffsParseJsonObject(registrationDetailsValue, registrationDetailsExpectedFields));
-
-    // Is there a registration token field?
-    if (!ffsJsonFieldIsEmpty(&registrationTokenField)) {
-
-        // Parse the registration token field.
-        FFS_CHECK_RESULT(ffsConvertJsonFieldToUtf8String(&registrationTokenField,
-                &registrationDetails->registrationToken));
-    }
-
-    // Is there an "expires at" field?
-    if (!ffsJsonFieldIsEmpty(&expiresAtField)) {
-
-        // Parse the "expires at" time.
-        FFS_CHECK_RESULT(ffsParseJsonInt64(&expiresAtField.value, &registrationDetails->expiresAt));
-        registrationDetails->hasExpiresAt = true;
-    }
+    FFS_CHECK_RESULT(ffsDssDeserializeModel(&ffsDssRegistrationDetailsModel, registrationDetailsValue,
+            registrationDetails, NULL));
 
     return FFS_SUCCESS;
 }
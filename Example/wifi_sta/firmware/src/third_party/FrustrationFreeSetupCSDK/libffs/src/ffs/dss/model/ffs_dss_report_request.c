@@ -13,15 +13,9 @@
  */
 
 #include "ffs/common/ffs_check_result.h"
+#include "ffs/dss/model/ffs_dss_model_tables.h"
 #include "ffs/dss/model/ffs_dss_report_request.h"
 
-#define JSON_KEY_NONCE                          "nonce"
-#define JSON_KEY_SESSION_ID                     "sessionId"
-#define JSON_KEY_DEVICE_DETAILS                 "deviceDetails"
-#define JSON_KEY_SEQUENCE_NUMBER                "sequenceNumber"
-#define JSON_KEY_CURRENT_PROVISIONEE_STATE      "currentProvisioningState"
-#define JSON_KEY_REGISTRATION_STATE             "registrationState"
-#define JSON_KEY_STATE_TRANSITION_RESULT        "stateTransitionResult"
 #define JSON_KEY_WIFI_NETWORK_INFO_LIST         "wifiNetworkInfoList"
 
 /*
@@ -30,44 +24,8 @@
 FFS_RESULT ffsDssStartSerializingReportRequest(FfsDssReportRequest_t *reportRequest,
         FfsStream_t *outputStream)
 {
-    const char *tempString;
-
-    // Start the "report" request object.
-    FFS_CHECK_RESULT(ffsEncodeJsonObjectStart(outputStream));
-
-    // Serialize the nonce field.
-    FFS_CHECK_RESULT(ffsEncodeJsonStringField(JSON_KEY_NONCE, reportRequest->nonce,
-            outputStream));
-
-    // Serialize the session ID field.
-    FFS_CHECK_RESULT(ffsEncodeJsonSeparator(outputStream));
-    FFS_CHECK_RESULT(ffsEncodeJsonStringField(JSON_KEY_SESSION_ID, reportRequest->sessionId,
-            outputStream));
-
-    // Serialize the device details field.
-    FFS_CHECK_RESULT(ffsDssSerializeDeviceDetailsField(&reportRequest->deviceDetails, outputStream));
-
-    // Serialize the sequence number.
-    FFS_CHECK_RESULT(ffsEncodeJsonSeparator(outputStream));
-    FFS_CHECK_RESULT(ffsEncodeJsonInt32Field(JSON_KEY_SEQUENCE_NUMBER, reportRequest->sequenceNumber,
-            outputStream));
-
-    // Serialize the current provisionee state.
-    FFS_CHECK_RESULT(ffsEncodeJsonSeparator(outputStream));
-    FFS_CHECK_RESULT(ffsDssGetWifiProvisioneeStateString(reportRequest->provisioneeState, &tempString));
-    FFS_CHECK_RESULT(ffsEncodeJsonStringField(JSON_KEY_CURRENT_PROVISIONEE_STATE, tempString,
-            outputStream));
-
-    // Serialize the current registration state.
-    FFS_CHECK_RESULT(ffsEncodeJsonSeparator(outputStream));
-    FFS_CHECK_RESULT(ffsDssGetRegistrationStateString(reportRequest->registrationState, &tempString));
-    FFS_CHECK_RESULT(ffsEncodeJsonStringField(JSON_KEY_REGISTRATION_STATE, tempString, outputStream));
-
-    // Serialize the state transition result.
-    FFS_CHECK_RESULT(ffsEncodeJsonSeparator(outputStream));
-    FFS_CHECK_RESULT(ffsDssGetReportResultString(reportRequest->stateTransitionResult, &tempString));
-    FFS_CHECK_RESULT(ffsEncodeJsonStringField(JSON_KEY_STATE_TRANSITION_RESULT, tempString,
-            outputStream));
+    // Serialize the "report" request fields, leaving the object open for the connection attempts.
+    FFS_CHECK_RESULT(ffsDssStartSerializingModel(&ffsDssReportRequestModel, reportRequest, outputStream));
 
     return FFS_SUCCESS;
 }
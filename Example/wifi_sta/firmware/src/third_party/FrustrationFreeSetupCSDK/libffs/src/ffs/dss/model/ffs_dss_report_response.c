@@ -13,14 +13,9 @@
  */
 
 #include "ffs/common/ffs_check_result.h"
+#include "ffs/dss/model/ffs_dss_model_tables.h"
 #include "ffs/dss/model/ffs_dss_report_response.h"
 
-#define JSON_KEY_NONCE                          "nonce"
-#define JSON_KEY_NEXT_PROVISIONING_STATE        "nextProvisioningState"
-#define JSON_KEY_CAN_PROCEED                    "canProceed"
-#define JSON_KEY_WAIT_TIME                      "waitTime"
-#define JSON_KEY_REASON                         "reason"
-
 /*
  * Serialize a DSS "report" response.
  */
@@ -39,50 +34,9 @@ FFS_RESULT ffsDssSerializeReportResponse(FfsDssReportResponse_t *reportResponse,
 FFS_RESULT ffsDssDeserializeReportResponse(FfsJsonValue_t *reportResponseValue,
         FfsDssReportResponse_t *reportResponse)
 {
-    // Zero out the "report" response.
-    memset(reportResponse, 0, sizeof(*reportResponse));
-
     // Parse {"nonce":"...","canProceed":...,"nextProvisioningState":"...","waitTime":"...","reason":"..."}.
-    FfsJsonField_t nonceField = ffsCreateJsonField(JSON_KEY_NONCE, FFS_JSON_STRING);
-    FfsJsonField_t canProceedField = ffsCreateJsonField(JSON_KEY_CAN_PROCEED,
-            FFS_JSON_BOOLEAN);
-    FfsJsonField_t nextProvisioneeStateField = ffsCreateJsonField(JSON_KEY_NEXT_PROVISIONING_STATE,
-            FFS_JSON_STRING);
-    FfsJsonField_t waitTimeField = ffsCreateJsonField(JSON_KEY_WAIT_TIME, FFS_JSON_STRING);
-    FfsJsonField_t reasonField = ffsCreateJsonField(JSON_KEY_REASON, FFS_JSON_STRING);
-    FfsJsonField_t *reportResponseExpectedFields[] = { &nonceField, &canProceedField,
-            &nextProvisioneeStateField, &waitTimeField, &reasonField, NULL };
-
-    FFS_CHECK_RESULT(ffsParseJsonObject(reportResponseValue, reportResponseExpectedFields));
-
-    // Parse the nonce.
-    FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8String(&nonceField.value, &reportResponse->nonce));
-
-    // Parse the "can proceed" flag?
-    if (!ffsJsonFieldIsEmpty(&canProceedField)) {
-        FFS_CHECK_RESULT(ffsParseJsonBoolean(&canProceedField.value, &reportResponse->canProceed));
-    }
-
-    // Parse the next provisioning state?
-    if (!ffsJsonFieldIsEmpty(&nextProvisioneeStateField)) {
-        const char *stateString;
-        FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8String(&nextProvisioneeStateField.value,
-                &stateString));
-        FFS_CHECK_RESULT(ffsDssParseWifiProvisioneeState(stateString,
-                &reportResponse->nextProvisioningState));
-    }
-
-    // Parse the wait time?
-    if (!ffsJsonFieldIsEmpty(&waitTimeField)) {
-        FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8String(&waitTimeField.value,
-                &reportResponse->waitTime));
-    }
-
-    // Parse the reason?
-    if (!ffsJsonFieldIsEmpty(&reasonField)) {
-        FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8String(&reasonField.value,
-                &reportResponse->reason));
-    }
+    FFS_CHECK_RESULT(ffsDssDeserializeModel(&ffsDssReportResponseModel, reportResponseValue, reportResponse,
+            NULL));
 
     return FFS_SUCCESS;
 }
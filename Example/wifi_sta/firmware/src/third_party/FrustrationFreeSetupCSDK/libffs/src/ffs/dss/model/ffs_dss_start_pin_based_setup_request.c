@@ -13,10 +13,9 @@
  */
 
 #include "ffs/common/ffs_check_result.h"
+#include "ffs/dss/model/ffs_dss_model_tables.h"
 #include "ffs/dss/model/ffs_dss_start_pin_based_setup_request.h"
 
-#define JSON_KEY_NONCE              "nonce"
-#define JSON_KEY_SESSION_ID         "sessionId"
 #define JSON_KEY_HASHED_PIN         "hashedPin"
 
 /*
@@ -26,21 +25,9 @@ FFS_RESULT ffsDssSerializeStartPinBasedSetupRequest(
         FfsDssStartPinBasedSetupRequest_t *startPinBasedSetupRequest,
         FfsStream_t *outputStream)
 {
-    // Start the "start PIN-based setup" request object.
-    FFS_CHECK_RESULT(ffsEncodeJsonObjectStart(outputStream));
-
-    // Serialize the nonce field.
-    FFS_CHECK_RESULT(ffsEncodeJsonStringField(JSON_KEY_NONCE, startPinBasedSetupRequest->nonce,
-            outputStream));
-
-    // Serialize the session ID field.
-    FFS_CHECK_RESULT(ffsEncodeJsonSeparator(outputStream));
-    FFS_CHECK_RESULT(ffsEncodeJsonStringField(JSON_KEY_SESSION_ID, startPinBasedSetupRequest->sessionId,
-            outputStream));
-
-    // Serialize the "device details" field.
-    FFS_CHECK_RESULT(ffsDssSerializeDeviceDetailsField(&startPinBasedSetupRequest->deviceDetails,
-            outputStream));
+    // Serialize {"nonce":"...","sessionId":"...","deviceDetails":{...} (left open for the hashed PIN).
+    FFS_CHECK_RESULT(ffsDssStartSerializingModel(&ffsDssStartPinBasedSetupRequestModel,
+            startPinBasedSetupRequest, outputStream));
 
     return FFS_SUCCESS;
 }
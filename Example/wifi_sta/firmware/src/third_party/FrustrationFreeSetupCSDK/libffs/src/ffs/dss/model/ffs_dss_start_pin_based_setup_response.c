@@ -14,12 +14,9 @@
 
 #include "ffs/common/ffs_check_result.h"
 #include "ffs/common/ffs_json.h"
+#include "ffs/dss/model/ffs_dss_model_tables.h"
 #include "ffs/dss/model/ffs_dss_start_pin_based_setup_response.h"
 
-#define JSON_KEY_NONCE              "nonce"
-#define JSON_KEY_SESSION_ID         "sessionId"
-#define JSON_KEY_CAN_PROCEED        "canProceed"
-
 /*
  * Serialize a DSS "start PIN-based setup" response.
  */
@@ -40,22 +37,9 @@ FFS_RESULT ffsDssDeserializeStartPinBasedSetupResponse(
         FfsJsonValue_t *startPinBasedSetupResponseValue,
         FfsDssStartPinBasedSetupResponse_t *startPinBasedSetupResponse)
 {
-    // Zero out the "start PIN-based setup" response.
-    memset(startPinBasedSetupResponse, 0, sizeof(*startPinBasedSetupResponse));
-
     // Parse {"nonce":"...","canProceed":"..."}.
-    FfsJsonField_t nonceField = ffsCreateJsonField(JSON_KEY_NONCE, FFS_JSON_STRING);
-    FfsJsonField_t canProceedField = ffsCreateJsonField(JSON_KEY_CAN_PROCEED, FFS_JSON_BOOLEAN);
-    FfsJsonField_t *rootExpectedFields[] = { &nonceField, &canProceedField, NULL };
-
-    FFS_CHECK_RESULT(ffsParseJsonObject(startPinBasedSetupResponseValue, rootExpectedFields));
-
-    // Parse the nonce.
-    FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8String(&nonceField.value,
-            &startPinBasedSetupResponse->nonce));
-
-    // Parse the 'canProceed' value.
-    FFS_CHECK_RESULT(ffsParseJsonBoolean(&canProceedField.value, &startPinBasedSetupResponse->canProceed));
+    FFS_CHECK_RESULT(ffsDssDeserializeModel(&ffsDssStartPinBasedSetupResponseModel,
+            startPinBasedSetupResponseValue, startPinBasedSetupResponse, NULL));
 
     return FFS_SUCCESS;
 }
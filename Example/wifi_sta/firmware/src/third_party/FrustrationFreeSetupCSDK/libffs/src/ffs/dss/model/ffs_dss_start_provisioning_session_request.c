@@ -13,10 +13,9 @@
  */
 
 #include "ffs/common/ffs_check_result.h"
+#include "ffs/dss/model/ffs_dss_model_tables.h"
 #include "ffs/dss/model/ffs_dss_start_provisioning_session_request.h"
 
-#define JSON_KEY_NONCE      "nonce"
-
 /*
  * Serialize a DSS "start provisioning session" request.
  */
@@ -24,15 +23,9 @@ FFS_RESULT ffsDssSerializeStartProvisioningSessionRequest(
         FfsDssStartProvisioningSessionRequest_t *startProvisioningSessionRequest,
         FfsStream_t *outputStream)
 {
-    // Start the "start provisioning session" request object.
-    FFS_CHECK_RESULT(ffsEncodeJsonObjectStart(outputStream));
-
-    // Serialize the nonce field.
-    FFS_CHECK_RESULT(ffsEncodeJsonStringField(JSON_KEY_NONCE, startProvisioningSessionRequest->nonce,
-            outputStream));
-
-    // End the "start provisioning session" request object.
-    FFS_CHECK_RESULT(ffsEncodeJsonObjectEnd(outputStream));
+    // Serialize {"nonce":"..."}.
+    FFS_CHECK_RESULT(ffsDssSerializeModel(&ffsDssStartProvisioningSessionRequestModel,
+            startProvisioningSessionRequest, NULL, outputStream));
 
     return FFS_SUCCESS;
 }
@@ -13,13 +13,9 @@
  */
 
 #include "ffs/common/ffs_check_result.h"
+#include "ffs/dss/model/ffs_dss_model_tables.h"
 #include "ffs/dss/model/ffs_dss_start_provisioning_session_response.h"
 
-#define JSON_KEY_NONCE          "nonce"
-#define JSON_KEY_SESSION_ID     "sessionId"
-#define JSON_KEY_CAN_PROCEED    "canProceed"
-#define JSON_KEY_PIN_SALT       "salt"
-
 /*
  * Serialize a DSS "start provisioning session" response.
  */
@@ -40,32 +36,9 @@ FFS_RESULT ffsDssDeserializeStartProvisioningSessionResponse(
         FfsJsonValue_t *startProvisioningSessionResponseValue,
         FfsDssStartProvisioningSessionResponse_t *startProvisioningSessionResponse)
 {
-    // Zero out the "start provisioning session" response.
-    memset(startProvisioningSessionResponse, 0, sizeof(*startProvisioningSessionResponse));
-
     // Parse {"nonce":"...","sessionId":"...","canProceed":"...","salt":"..."}.
-    FfsJsonField_t nonceField = ffsCreateJsonField(JSON_KEY_NONCE, FFS_JSON_STRING);
-    FfsJsonField_t sessionIdField = ffsCreateJsonField(JSON_KEY_SESSION_ID, FFS_JSON_STRING);
-    FfsJsonField_t canProceedField = ffsCreateJsonField(JSON_KEY_CAN_PROCEED, FFS_JSON_BOOLEAN);
-    FfsJsonField_t saltField = ffsCreateJsonField(JSON_KEY_PIN_SALT, FFS_JSON_STRING);
-    FfsJsonField_t *rootExpectedFields[] = { &nonceField, &sessionIdField, &canProceedField, &saltField, NULL };
-
-    FFS_CHECK_RESULT(ffsParseJsonObject(startProvisioningSessionResponseValue, rootExpectedFields));
-
-    // Parse the nonce.
-    FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8String(&nonceField.value,
-            &startProvisioningSessionResponse->nonce));
-
-    // Parse the session ID.
-    FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8String(&sessionIdField.value,
-            &startProvisioningSessionResponse->sessionId));
-
-    // Parse the 'canProceed' value.
-    FFS_CHECK_RESULT(ffsParseJsonBoolean(&canProceedField.value, &startProvisioningSessionResponse->canProceed));
-
-    // Parse the salt.
-    FFS_CHECK_RESULT(ffsConvertJsonValueToUtf8String(&saltField.value,
-            &startProvisioningSessionResponse->salt));
+    FFS_CHECK_RESULT(ffsDssDeserializeModel(&ffsDssStartProvisioningSessionResponseModel,
+            startProvisioningSessionResponseValue, startProvisioningSessionResponse, NULL));
 
     return FFS_SUCCESS;
 }
@@ -0,0 +1,470 @@
+/** @file ffs_wifi_provisionee_checkpoint.c
+ *
+ * @brief Wi-Fi provisionee checkpoint record implementation.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_check_result.h"
+#include "ffs/common/ffs_logging.h"
+#include "ffs/compat/ffs_common_compat.h"
+#include "ffs/wifi_provisionee/ffs_wifi_provisionee_checkpoint.h"
+
+#include <string.h>
+
+#define FFS_CHECKPOINT_MAGIC                    "FFSC"
+#define FFS_CHECKPOINT_MAGIC_SIZE               (4)
+#define FFS_CHECKPOINT_CRC_SIZE                 (4)
+#define FFS_CHECKPOINT_FLAG_SOCKS_NETWORK       (1 << 0)
+
+/** Item log entry types. */
+#define FFS_CHECKPOINT_ITEM_WIFI_CONFIGURATION  (1)
+#define FFS_CHECKPOINT_ITEM_CONFIGURATION_VALUE (2)
+#define FFS_CHECKPOINT_ITEM_REGISTRATION_TOKEN  (3)
+
+/*
+ * Parsed item log entry. The streams point into the item log.
+ */
+typedef struct {
+    uint8_t type;
+    FfsWifiConfiguration_t wifiConfiguration;
+    char key[FFS_WIFI_PROVISIONEE_CHECKPOINT_MAXIMUM_KEY_LENGTH + 1];
+    FfsMapValue_t value;
+    FfsRegistrationRequest_t registrationRequest;
+} FfsCheckpointItem_t;
+
+/* Static function prototypes. */
+static FFS_RESULT ffsCheckpointWriteItem(FfsStream_t *itemsStream, FfsStream_t *itemStream);
+static FFS_RESULT ffsCheckpointReadItem(FfsStream_t *itemsStream, FfsCheckpointItem_t *item);
+static FFS_RESULT ffsCheckpointWriteBlock(FfsStream_t *blockStream, size_t lengthSize, size_t maximumLength,
+        FfsStream_t *outputStream);
+static FFS_RESULT ffsCheckpointReadBlock(FfsStream_t *inputStream, size_t lengthSize, size_t maximumLength,
+        FfsStream_t *blockStream);
+static FFS_RESULT ffsCheckpointWriteUint(uint32_t value, size_t size, FfsStream_t *outputStream);
+static FFS_RESULT ffsCheckpointReadUint(FfsStream_t *inputStream, size_t size, uint32_t *value);
+static uint32_t ffsCheckpointCrc32(const uint8_t *data, size_t dataSize);
+
+/*
+ * Get the state to resume a checkpointed state from.
+ */
+bool ffsGetWifiProvisioneeCheckpointResumeState(FFS_WIFI_PROVISIONEE_STATE state,
+        FFS_WIFI_PROVISIONEE_STATE *resumeState)
+{
+    switch (state) {
+        case FFS_WIFI_PROVISIONEE_STATE_START_PIN_BASED_SETUP:
+        case FFS_WIFI_PROVISIONEE_STATE_COMPUTE_CONFIGURATION:
+        case FFS_WIFI_PROVISIONEE_STATE_POST_WIFI_SCAN_DATA:
+        case FFS_WIFI_PROVISIONEE_STATE_GET_WIFI_LIST:
+        case FFS_WIFI_PROVISIONEE_STATE_CONNECTING_TO_USER_NETWORK:
+            *resumeState = state;
+            return true;
+        case FFS_WIFI_PROVISIONEE_STATE_CONNECTED_TO_USER_NETWORK:
+            *resumeState = FFS_WIFI_PROVISIONEE_STATE_CONNECTING_TO_USER_NETWORK;
+            return true;
+        default:
+            // No session yet, or a terminal state.
+            return false;
+    }
+}
+
+/*
+ * Append received Wi-Fi credentials to the item log.
+ *
+ * Format: type, security protocol (1 byte), hidden flag (1 byte), SSID length
+ * (1 byte), SSID, key length (1 byte), key.
+ */
+FFS_RESULT ffsWifiProvisioneeCheckpointAddWifiConfiguration(FfsStream_t *itemsStream,
+        FfsWifiConfiguration_t *wifiConfiguration)
+{
+    FFS_TEMPORARY_OUTPUT_STREAM(itemStream, 5 + FFS_MAXIMUM_SSID_SIZE + FFS_MAXIMUM_WIFI_KEY_SIZE);
+
+    FFS_CHECK_RESULT(ffsWriteByteToStream(FFS_CHECKPOINT_ITEM_WIFI_CONFIGURATION, &itemStream));
+    FFS_CHECK_RESULT(ffsWriteByteToStream((uint8_t) wifiConfiguration->securityProtocol, &itemStream));
+    FFS_CHECK_RESULT(ffsWriteByteToStream(wifiConfiguration->isHiddenNetwork ? 1 : 0, &itemStream));
+    FFS_CHECK_RESULT(ffsCheckpointWriteBlock(&wifiConfiguration->ssidStream, 1, FFS_MAXIMUM_SSID_SIZE,
+            &itemStream));
+    FFS_CHECK_RESULT(ffsCheckpointWriteBlock(&wifiConfiguration->keyStream, 1, FFS_MAXIMUM_WIFI_KEY_SIZE,
+            &itemStream));
+
+    FFS_CHECK_RESULT(ffsCheckpointWriteItem(itemsStream, &itemStream));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Append a received configuration value to the item log.
+ *
+ * Format: type, key length (1 byte), key, value type (1 byte), then the value:
+ * length (2 bytes) and data for bytes and strings, 4 bytes for integers and
+ * 1 byte for booleans.
+ */
+FFS_RESULT ffsWifiProvisioneeCheckpointAddConfigurationValue(FfsStream_t *itemsStream, const char *key,
+        FfsMapValue_t *value)
+{
+    FFS_TEMPORARY_OUTPUT_STREAM(itemStream, FFS_WIFI_PROVISIONEE_CHECKPOINT_ITEMS_SIZE);
+    FfsStream_t keyStream = ffsCreateInputStream((uint8_t *) key, strlen(key));
+
+    FFS_CHECK_RESULT(ffsWriteByteToStream(FFS_CHECKPOINT_ITEM_CONFIGURATION_VALUE, &itemStream));
+    FFS_CHECK_RESULT(ffsCheckpointWriteBlock(&keyStream, 1, FFS_WIFI_PROVISIONEE_CHECKPOINT_MAXIMUM_KEY_LENGTH,
+            &itemStream));
+    FFS_CHECK_RESULT(ffsWriteByteToStream((uint8_t) value->type, &itemStream));
+
+    switch (value->type) {
+        case FFS_MAP_VALUE_TYPE_BYTES:
+            FFS_CHECK_RESULT(ffsCheckpointWriteBlock(&value->bytesStream, 2,
+                    FFS_WIFI_PROVISIONEE_CHECKPOINT_ITEMS_SIZE, &itemStream));
+            break;
+        case FFS_MAP_VALUE_TYPE_STRING:
+            FFS_CHECK_RESULT(ffsCheckpointWriteBlock(&value->stringStream, 2,
+                    FFS_WIFI_PROVISIONEE_CHECKPOINT_ITEMS_SIZE, &itemStream));
+            break;
+        case FFS_MAP_VALUE_TYPE_INTEGER:
+            FFS_CHECK_RESULT(ffsCheckpointWriteUint((uint32_t) value->integerValue, 4, &itemStream));
+            break;
+        case FFS_MAP_VALUE_TYPE_BOOLEAN:
+            FFS_CHECK_RESULT(ffsWriteByteToStream(value->booleanValue ? 1 : 0, &itemStream));
+            break;
+        default:
+            FFS_FAIL(FFS_ERROR);
+    }
+
+    FFS_CHECK_RESULT(ffsCheckpointWriteItem(itemsStream, &itemStream));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Append a received registration token to the item log.
+ *
+ * Format: type, expiration in milliseconds (8 bytes), token length (2 bytes),
+ * token.
+ */
+FFS_RESULT ffsWifiProvisioneeCheckpointAddRegistrationToken(FfsStream_t *itemsStream,
+        FfsRegistrationRequest_t *registrationRequest)
+{
+    FFS_TEMPORARY_OUTPUT_STREAM(itemStream, FFS_WIFI_PROVISIONEE_CHECKPOINT_ITEMS_SIZE);
+    const uint64_t expiration = (uint64_t) registrationRequest->expiration;
+
+    FFS_CHECK_RESULT(ffsWriteByteToStream(FFS_CHECKPOINT_ITEM_REGISTRATION_TOKEN, &itemStream));
+    FFS_CHECK_RESULT(ffsCheckpointWriteUint((uint32_t) (expiration >> 32), 4, &itemStream));
+    FFS_CHECK_RESULT(ffsCheckpointWriteUint((uint32_t) expiration, 4, &itemStream));
+    FFS_CHECK_RESULT(ffsCheckpointWriteBlock(&registrationRequest->tokenStream, 2,
+            FFS_WIFI_PROVISIONEE_CHECKPOINT_ITEMS_SIZE, &itemStream));
+
+    FFS_CHECK_RESULT(ffsCheckpointWriteItem(itemsStream, &itemStream));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Replay an item log through the compatibility layer.
+ */
+FFS_RESULT ffsReplayWifiProvisioneeCheckpointItems(struct FfsUserContext_s *userContext,
+        FfsStream_t *itemsStream)
+{
+    FfsStream_t replayStream = *itemsStream;
+
+    while (!ffsStreamIsEmpty(&replayStream)) {
+        FfsCheckpointItem_t item;
+
+        FFS_CHECK_RESULT(ffsCheckpointReadItem(&replayStream, &item));
+
+        switch (item.type) {
+            case FFS_CHECKPOINT_ITEM_WIFI_CONFIGURATION:
+                FFS_CHECK_RESULT(ffsAddWifiConfiguration(userContext, &item.wifiConfiguration));
+                break;
+            case FFS_CHECKPOINT_ITEM_CONFIGURATION_VALUE:
+                FFS_CHECK_RESULT(ffsSetConfigurationValue(userContext, item.key, &item.value));
+                break;
+            case FFS_CHECKPOINT_ITEM_REGISTRATION_TOKEN:
+                FFS_CHECK_RESULT(ffsSetRegistrationToken(userContext, &item.registrationRequest));
+                break;
+            default:
+                FFS_FAIL(FFS_ERROR);
+        }
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Encode a checkpoint record.
+ */
+FFS_RESULT ffsEncodeWifiProvisioneeCheckpoint(const FfsWifiProvisioneeCheckpoint_t *checkpoint,
+        FfsStream_t *outputStream)
+{
+    // The CRC covers everything written from here.
+    uint8_t *record = FFS_STREAM_NEXT_WRITE(*outputStream);
+    const size_t startSize = outputStream->dataSize;
+    FfsStream_t sessionIdStream = checkpoint->sessionIdStream;
+    FfsStream_t saltStream = checkpoint->saltStream;
+    FfsStream_t itemsStream = checkpoint->itemsStream;
+
+    if (checkpoint->state > FFS_WIFI_PROVISIONEE_STATE_TERMINATED) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    FFS_CHECK_RESULT(ffsWriteStream((const uint8_t *) FFS_CHECKPOINT_MAGIC, FFS_CHECKPOINT_MAGIC_SIZE,
+            outputStream));
+    FFS_CHECK_RESULT(ffsWriteByteToStream(FFS_WIFI_PROVISIONEE_CHECKPOINT_VERSION, outputStream));
+    FFS_CHECK_RESULT(ffsWriteByteToStream((uint8_t) checkpoint->state, outputStream));
+    FFS_CHECK_RESULT(ffsWriteByteToStream(checkpoint->resumeCount, outputStream));
+    FFS_CHECK_RESULT(ffsWriteByteToStream(checkpoint->connectedToSocksNetwork
+            ? FFS_CHECKPOINT_FLAG_SOCKS_NETWORK : 0, outputStream));
+    FFS_CHECK_RESULT(ffsCheckpointWriteUint((uint32_t) checkpoint->sequenceNumber, 4, outputStream));
+    FFS_CHECK_RESULT(ffsCheckpointWriteBlock(&sessionIdStream, 2, FFS_MAXIMUM_SESSION_ID_LENGTH - 1,
+            outputStream));
+    FFS_CHECK_RESULT(ffsCheckpointWriteBlock(&saltStream, 1, FFS_SALT_SIZE, outputStream));
+    FFS_CHECK_RESULT(ffsCheckpointWriteBlock(&itemsStream, 2, FFS_WIFI_PROVISIONEE_CHECKPOINT_ITEMS_SIZE,
+            outputStream));
+
+    const uint32_t crc = ffsCheckpointCrc32(record, outputStream->dataSize - startSize);
+    FFS_CHECK_RESULT(ffsCheckpointWriteUint(crc, FFS_CHECKPOINT_CRC_SIZE, outputStream));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Decode and validate a checkpoint record.
+ */
+FFS_RESULT ffsDecodeWifiProvisioneeCheckpoint(FfsStream_t *inputStream,
+        FfsWifiProvisioneeCheckpoint_t *checkpoint)
+{
+    const size_t recordSize = FFS_STREAM_DATA_SIZE(*inputStream);
+    uint8_t *record = FFS_STREAM_NEXT_READ(*inputStream);
+    uint8_t *header;
+    uint32_t value;
+
+    if (recordSize < FFS_CHECKPOINT_MAGIC_SIZE + FFS_CHECKPOINT_CRC_SIZE) {
+        ffsLogWarning("Provisionee checkpoint too short");
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    // Check the CRC before looking at any field.
+    FfsStream_t crcStream = ffsCreateInputStream(record + recordSize - FFS_CHECKPOINT_CRC_SIZE,
+            FFS_CHECKPOINT_CRC_SIZE);
+    FFS_CHECK_RESULT(ffsCheckpointReadUint(&crcStream, FFS_CHECKPOINT_CRC_SIZE, &value));
+    if (value != ffsCheckpointCrc32(record, recordSize - FFS_CHECKPOINT_CRC_SIZE)) {
+        ffsLogWarning("Provisionee checkpoint CRC mismatch");
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    FfsStream_t recordStream = ffsCreateInputStream(record, recordSize - FFS_CHECKPOINT_CRC_SIZE);
+
+    FFS_CHECK_RESULT(ffsReadStream(&recordStream, FFS_CHECKPOINT_MAGIC_SIZE + 4, &header));
+    if (memcmp(header, FFS_CHECKPOINT_MAGIC, FFS_CHECKPOINT_MAGIC_SIZE)) {
+        ffsLogWarning("Not a provisionee checkpoint");
+        FFS_FAIL(FFS_ERROR);
+    }
+    if (header[4] != FFS_WIFI_PROVISIONEE_CHECKPOINT_VERSION) {
+        ffsLogWarning("Unsupported provisionee checkpoint version %u", header[4]);
+        FFS_FAIL(FFS_ERROR);
+    }
+    if (header[5] > FFS_WIFI_PROVISIONEE_STATE_TERMINATED) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    checkpoint->state = (FFS_WIFI_PROVISIONEE_STATE) header[5];
+    checkpoint->resumeCount = header[6];
+    checkpoint->connectedToSocksNetwork = (header[7] & FFS_CHECKPOINT_FLAG_SOCKS_NETWORK) != 0;
+
+    FFS_CHECK_RESULT(ffsCheckpointReadUint(&recordStream, 4, &value));
+    checkpoint->sequenceNumber = (int32_t) value;
+
+    FFS_CHECK_RESULT(ffsCheckpointReadBlock(&recordStream, 2, FFS_MAXIMUM_SESSION_ID_LENGTH - 1,
+            &checkpoint->sessionIdStream));
+    FFS_CHECK_RESULT(ffsCheckpointReadBlock(&recordStream, 1, FFS_SALT_SIZE, &checkpoint->saltStream));
+    FFS_CHECK_RESULT(ffsCheckpointReadBlock(&recordStream, 2, FFS_WIFI_PROVISIONEE_CHECKPOINT_ITEMS_SIZE,
+            &checkpoint->itemsStream));
+
+    if (!ffsStreamIsEmpty(&recordStream)) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    // Validate the whole item log before anything is replayed.
+    FfsStream_t validationStream = checkpoint->itemsStream;
+    while (!ffsStreamIsEmpty(&validationStream)) {
+        FfsCheckpointItem_t item;
+        FFS_CHECK_RESULT(ffsCheckpointReadItem(&validationStream, &item));
+    }
+
+    FFS_CHECK_RESULT(ffsReadStream(inputStream, recordSize, &header));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Append a complete item to the item log.
+ */
+static FFS_RESULT ffsCheckpointWriteItem(FfsStream_t *itemsStream, FfsStream_t *itemStream)
+{
+    if (FFS_STREAM_SPACE_SIZE(*itemsStream) < FFS_STREAM_DATA_SIZE(*itemStream)) {
+        ffsLogWarning("Provisionee checkpoint item log full");
+        return FFS_OVERRUN;
+    }
+
+    FFS_CHECK_RESULT(ffsWriteStream(FFS_STREAM_NEXT_READ(*itemStream), FFS_STREAM_DATA_SIZE(*itemStream),
+            itemsStream));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Read and validate the next item of an item log.
+ */
+static FFS_RESULT ffsCheckpointReadItem(FfsStream_t *itemsStream, FfsCheckpointItem_t *item)
+{
+    FfsStream_t keyStream;
+    uint8_t *data;
+    uint32_t value;
+    uint32_t expirationLow;
+
+    memset(item, 0, sizeof(*item));
+
+    FFS_CHECK_RESULT(ffsReadStream(itemsStream, 1, &data));
+    item->type = *data;
+
+    switch (item->type) {
+        case FFS_CHECKPOINT_ITEM_WIFI_CONFIGURATION:
+            FFS_CHECK_RESULT(ffsReadStream(itemsStream, 2, &data));
+            item->wifiConfiguration.securityProtocol = (FFS_WIFI_SECURITY_PROTOCOL) data[0];
+            item->wifiConfiguration.isHiddenNetwork = data[1] != 0;
+            FFS_CHECK_RESULT(ffsCheckpointReadBlock(itemsStream, 1, FFS_MAXIMUM_SSID_SIZE,
+                    &item->wifiConfiguration.ssidStream));
+            FFS_CHECK_RESULT(ffsCheckpointReadBlock(itemsStream, 1, FFS_MAXIMUM_WIFI_KEY_SIZE,
+                    &item->wifiConfiguration.keyStream));
+            break;
+        case FFS_CHECKPOINT_ITEM_CONFIGURATION_VALUE:
+            FFS_CHECK_RESULT(ffsCheckpointReadBlock(itemsStream, 1, FFS_WIFI_PROVISIONEE_CHECKPOINT_MAXIMUM_KEY_LENGTH,
+                    &keyStream));
+            memcpy(item->key, FFS_STREAM_NEXT_READ(keyStream), FFS_STREAM_DATA_SIZE(keyStream));
+            item->key[FFS_STREAM_DATA_SIZE(keyStream)] = '\0';
+
+            FFS_CHECK_RESULT(ffsReadStream(itemsStream, 1, &data));
+            item->value.type = (FFS_MAP_VALUE_TYPE) *data;
+            switch (item->value.type) {
+                case FFS_MAP_VALUE_TYPE_BYTES:
+                    FFS_CHECK_RESULT(ffsCheckpointReadBlock(itemsStream, 2,
+                            FFS_WIFI_PROVISIONEE_CHECKPOINT_ITEMS_SIZE, &item->value.bytesStream));
+                    break;
+                case FFS_MAP_VALUE_TYPE_STRING:
+                    FFS_CHECK_RESULT(ffsCheckpointReadBlock(itemsStream, 2,
+                            FFS_WIFI_PROVISIONEE_CHECKPOINT_ITEMS_SIZE, &item->value.stringStream));
+                    break;
+                case FFS_MAP_VALUE_TYPE_INTEGER:
+                    FFS_CHECK_RESULT(ffsCheckpointReadUint(itemsStream, 4, &value));
+                    item->value.integerValue = (int32_t) value;
+                    break;
+                case FFS_MAP_VALUE_TYPE_BOOLEAN:
+                    FFS_CHECK_RESULT(ffsReadStream(itemsStream, 1, &data));
+                    item->value.booleanValue = *data != 0;
+                    break;
+                default:
+                    FFS_FAIL(FFS_ERROR);
+            }
+            break;
+        case FFS_CHECKPOINT_ITEM_REGISTRATION_TOKEN:
+            FFS_CHECK_RESULT(ffsCheckpointReadUint(itemsStream, 4, &value));
+            FFS_CHECK_RESULT(ffsCheckpointReadUint(itemsStream, 4, &expirationLow));
+            item->registrationRequest.expiration = (int64_t) (((uint64_t) value << 32) | expirationLow);
+            FFS_CHECK_RESULT(ffsCheckpointReadBlock(itemsStream, 2, FFS_WIFI_PROVISIONEE_CHECKPOINT_ITEMS_SIZE,
+                    &item->registrationRequest.tokenStream));
+            break;
+        default:
+            ffsLogWarning("Unknown provisionee checkpoint item type %u", item->type);
+            FFS_FAIL(FFS_ERROR);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Write a length-prefixed block without consuming the source stream.
+ */
+static FFS_RESULT ffsCheckpointWriteBlock(FfsStream_t *blockStream, size_t lengthSize, size_t maximumLength,
+        FfsStream_t *outputStream)
+{
+    const size_t length = FFS_STREAM_DATA_SIZE(*blockStream);
+
+    if (length > maximumLength) {
+        FFS_FAIL(FFS_OVERRUN);
+    }
+
+    FFS_CHECK_RESULT(ffsCheckpointWriteUint((uint32_t) length, lengthSize, outputStream));
+    FFS_CHECK_RESULT(ffsWriteStream(FFS_STREAM_NEXT_READ(*blockStream), length, outputStream));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Read a length-prefixed block into an input stream over the source data.
+ */
+static FFS_RESULT ffsCheckpointReadBlock(FfsStream_t *inputStream, size_t lengthSize, size_t maximumLength,
+        FfsStream_t *blockStream)
+{
+    uint32_t length;
+    uint8_t *data;
+
+    FFS_CHECK_RESULT(ffsCheckpointReadUint(inputStream, lengthSize, &length));
+    if (length > maximumLength) {
+        FFS_FAIL(FFS_ERROR);
+    }
+    FFS_CHECK_RESULT(ffsReadStream(inputStream, length, &data));
+
+    *blockStream = ffsCreateInputStream(data, length);
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Write a big-endian value of 1 to 4 bytes.
+ */
+static FFS_RESULT ffsCheckpointWriteUint(uint32_t value, size_t size, FfsStream_t *outputStream)
+{
+    for (size_t i = size; i > 0; i--) {
+        FFS_CHECK_RESULT(ffsWriteByteToStream((uint8_t) (value >> (8 * (i - 1))), outputStream));
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Read a big-endian value of 1 to 4 bytes.
+ */
+static FFS_RESULT ffsCheckpointReadUint(FfsStream_t *inputStream, size_t size, uint32_t *value)
+{
+    uint8_t *data;
+
+    FFS_CHECK_RESULT(ffsReadStream(inputStream, size, &data));
+
+    *value = 0;
+    for (size_t i = 0; i < size; i++) {
+        *value = (*value << 8) | data[i];
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * CRC-32 (IEEE 802.3, reflected, as used by zlib).
+ */
+static uint32_t ffsCheckpointCrc32(const uint8_t *data, size_t dataSize)
+{
+    uint32_t crc = 0xFFFFFFFF;
+
+    for (size_t i = 0; i < dataSize; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+
+    return ~crc;
+}
@@ -21,6 +21,8 @@
 #include "ffs/compat/ffs_wifi_provisionee_compat.h"
 #include "ffs/wifi_provisionee/ffs_wifi_provisionee_encoded_setup_network.h"
 
+#include <string.h>
+
 /**
  * The constant control byte shifted to MSB
  */
@@ -30,18 +32,29 @@
 #define PRODUCT_INDEX_SIZE 4
 #define CLIENT_NONCE_SIZE 12
 #define HASH_SIZE 32 //sha256 size
-#define AUTH_MATERIAL_INDEX_SIZE 9
+#define AUTH_MATERIAL_INDEX_SIZE FFS_ENCODED_SETUP_NETWORK_AUTH_MATERIAL_INDEX_SIZE
 #define BASE_85_SOURCE_SIZE ((AUTH_MATERIAL_INDEX_SIZE - 1) + PRODUCT_INDEX_SIZE + CLIENT_NONCE_SIZE)
 #define BASE_85_ENCODED_SIZE ((BASE_85_SOURCE_SIZE / 4) * 5)
 #define BASE_64_SOURCE_SIZE 2
 #define BASE_64_ENCODED_SIZE 4
-#define SHARED_SECRET_KEY_SIZE 32 //256bit key
+#define SHARED_SECRET_KEY_SIZE FFS_ENCODED_SETUP_NETWORK_SHARED_SECRET_SIZE //256bit key
 
-static FFS_RESULT ffsComputeAuthMaterialIndex(struct FfsUserContext_s *userContext, FfsStream_t *authMaterialIndexStream);
-static FFS_RESULT ffsComputeAmazonSSID(struct FfsUserContext_s *userContext, FfsStream_t *nonceStream, FfsStream_t *ssidStream);
+/**
+ * 64-bit FNV-1a parameters for the key material fingerprint.
+ */
+#define FINGERPRINT_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FINGERPRINT_PRIME 0x00000100000001b3ULL
+
+static FFS_RESULT ffsComputeAmazonCustomEncodedNetworkConfigurationWithNonce(struct FfsUserContext_s *userContext,
+        const FfsEncodedSetupNetworkCache_t *cache, FfsStream_t *nonceStream, FfsWifiConfiguration_t *setupNetworkConfiguration);
+static uint64_t ffsUpdateFingerprint(uint64_t fingerprint, FfsStream_t *stream);
+static FFS_RESULT ffsReadEncodedSetupNetworkCache(struct FfsUserContext_s *userContext, FfsEncodedSetupNetworkCache_t *cache);
+static FFS_RESULT ffsWriteEncodedSetupNetworkCache(struct FfsUserContext_s *userContext, const FfsEncodedSetupNetworkCache_t *cache);
+static FFS_RESULT ffsComputeAuthMaterialIndex(struct FfsUserContext_s *userContext, FfsStream_t *devicePublicKeyStream, FfsStream_t *authMaterialIndexStream);
+static FFS_RESULT ffsComputeAmazonSSID(struct FfsUserContext_s *userContext, FfsStream_t *authMaterialIndexStream, FfsStream_t *nonceStream, FfsStream_t *ssidStream);
 static FFS_RESULT ffsComputeFirst2CharactersOfSSID(uint8_t *firstAuthMaterialbyte, FfsStream_t *ssidStream);
 static FFS_RESULT ffsComputeLast30CharactersOfSSID(FfsStream_t *authMaterialIndexStream, FfsStream_t *productIndexStream, FfsStream_t *nonceStream, FfsStream_t *ssidStream);
-static FFS_RESULT ffsComputeAmazonPassphrase(struct FfsUserContext_s *userContext, FfsStream_t *nonceStream, FfsStream_t *passphraseStream);
+static FFS_RESULT ffsComputeAmazonPassphrase(struct FfsUserContext_s *userContext, FfsStream_t *ecdhSharedSecretStream, FfsStream_t *nonceStream, FfsStream_t *passphraseStream);
 
 /*
  * This function is to compute the Amazon Custom network configuration.
@@ -55,12 +68,101 @@ FFS_RESULT ffsComputeAmazonCustomEncodedNetworkConfiguration(struct FfsUserConte
     // TODO: https://issues.amazon.com/issues/FFS-5876 , Here and other places.
     ffsLogStream("Nonce:", &nonceStream);
 
-    // Compute the SSID:  
-    FFS_CHECK_RESULT(ffsComputeAmazonSSID(userContext, &nonceStream, &setupNetworkConfiguration->ssidStream));
+    // Get the nonce-independent part, from the stored cache if it is still valid.
+    FfsEncodedSetupNetworkCache_t cache;
+    FFS_CHECK_RESULT(ffsPrepareAmazonCustomEncodedNetworkCache(userContext, &cache));
+
+    return ffsComputeAmazonCustomEncodedNetworkConfigurationWithNonce(userContext, &cache, &nonceStream,
+            setupNetworkConfiguration);
+}
+
+/*
+ * This function is to compute the Amazon Custom network configuration from a prepared cache.
+ *
+ */
+FFS_RESULT ffsComputeAmazonCustomEncodedNetworkConfigurationFromCache(struct FfsUserContext_s *userContext,
+        const FfsEncodedSetupNetworkCache_t *cache, FfsWifiConfiguration_t *setupNetworkConfiguration) {
+    // Get 12 byte nonce
+    FFS_TEMPORARY_OUTPUT_STREAM(nonceStream, CLIENT_NONCE_SIZE);
+    FFS_CHECK_RESULT(ffsRandomBytes(userContext, &nonceStream));
+    ffsLogStream("Nonce:", &nonceStream);
+
+    return ffsComputeAmazonCustomEncodedNetworkConfigurationWithNonce(userContext, cache, &nonceStream,
+            setupNetworkConfiguration);
+}
+
+/*
+ * This function is to compute the nonce-independent part of the Amazon Custom network configuration.
+ *
+ */
+FFS_RESULT ffsPrepareAmazonCustomEncodedNetworkCache(struct FfsUserContext_s *userContext,
+        FfsEncodedSetupNetworkCache_t *cache) {
+    // Get the device public key.
+    FFS_TEMPORARY_OUTPUT_STREAM(devicePublicKeyStream, DER_PUBLIC_KEY_SIZE);
+    FfsMapValue_t devicePublicKeyValue = {
+        .type = FFS_MAP_VALUE_TYPE_BYTES,
+        .bytesStream = devicePublicKeyStream
+    };
+    FFS_CHECK_RESULT(ffsGetConfigurationValue(userContext, FFS_CONFIGURATION_ENTRY_KEY_DEVICE_EC_PUBLIC_KEY_DER, &devicePublicKeyValue));
+    ffsLogStream("Device Public key DER bytes:", &devicePublicKeyValue.bytesStream);
+
+    // Get the cloud public key.
+    FFS_TEMPORARY_OUTPUT_STREAM(cloudPublicKeyStream, DER_PUBLIC_KEY_SIZE);
+    FfsMapValue_t cloudPublicKeyValue = {
+        .type = FFS_MAP_VALUE_TYPE_BYTES,
+        .bytesStream = cloudPublicKeyStream
+    };
+    FFS_CHECK_RESULT(ffsGetConfigurationValue(userContext, FFS_CONFIGURATION_ENTRY_KEY_CLOUD_EC_PUBLIC_KEY_DER, &cloudPublicKeyValue));
+    ffsLogStream("Cloud pub key bytes:", &cloudPublicKeyValue.bytesStream);
+
+    // Fingerprint both keys; a cache made for other key material is stale.
+    uint64_t fingerprint = FINGERPRINT_OFFSET_BASIS;
+    fingerprint = ffsUpdateFingerprint(fingerprint, &devicePublicKeyValue.bytesStream);
+    fingerprint = ffsUpdateFingerprint(fingerprint, &cloudPublicKeyValue.bytesStream);
+
+    uint8_t expectedFingerprint[FFS_ENCODED_SETUP_NETWORK_FINGERPRINT_SIZE];
+    for (size_t i = 0; i < FFS_ENCODED_SETUP_NETWORK_FINGERPRINT_SIZE; i++) {
+        expectedFingerprint[i] = (uint8_t) (fingerprint >> (8 * (FFS_ENCODED_SETUP_NETWORK_FINGERPRINT_SIZE - 1 - i)));
+    }
+
+    if (ffsReadEncodedSetupNetworkCache(userContext, cache) == FFS_SUCCESS
+            && !memcmp(cache->fingerprint, expectedFingerprint, FFS_ENCODED_SETUP_NETWORK_FINGERPRINT_SIZE)) {
+        ffsLogDebug("Using the cached encoded setup network key material");
+        return FFS_SUCCESS;
+    }
+
+    memcpy(cache->fingerprint, expectedFingerprint, FFS_ENCODED_SETUP_NETWORK_FINGERPRINT_SIZE);
+
+    // Compute the auth material index.
+    FfsStream_t authMaterialIndexStream = ffsCreateOutputStream(cache->authMaterialIndex, AUTH_MATERIAL_INDEX_SIZE);
+    FFS_CHECK_RESULT(ffsComputeAuthMaterialIndex(userContext, &devicePublicKeyValue.bytesStream, &authMaterialIndexStream));
+    ffsLogStream("Device auth material index", &authMaterialIndexStream);
+
+    // Call compat function to compute ECDH shared secret key using (cloud pubkey)
+    FfsStream_t ecdhSharedSecretStream = ffsCreateOutputStream(cache->sharedSecret, SHARED_SECRET_KEY_SIZE);
+    FFS_CHECK_RESULT(ffsComputeECDHKey(userContext, &cloudPublicKeyValue.bytesStream, &ecdhSharedSecretStream));
+    ffsLogStream("Ecdh shared secret bytes:", &ecdhSharedSecretStream);
+
+    // Failing to store the cache only costs the recomputation next time.
+    FFS_CHECK_RESULT_CONTINUE(ffsWriteEncodedSetupNetworkCache(userContext, cache));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * This function computes the nonce-dependent part of the Amazon Custom network configuration.
+ *
+ */
+static FFS_RESULT ffsComputeAmazonCustomEncodedNetworkConfigurationWithNonce(struct FfsUserContext_s *userContext,
+        const FfsEncodedSetupNetworkCache_t *cache, FfsStream_t *nonceStream, FfsWifiConfiguration_t *setupNetworkConfiguration) {
+    // Compute the SSID:
+    FfsStream_t authMaterialIndexStream = ffsCreateInputStream((uint8_t *) cache->authMaterialIndex, AUTH_MATERIAL_INDEX_SIZE);
+    FFS_CHECK_RESULT(ffsComputeAmazonSSID(userContext, &authMaterialIndexStream, nonceStream, &setupNetworkConfiguration->ssidStream));
     ffsLogStream("Calculated SSID:", &setupNetworkConfiguration->ssidStream);
     // Compute passphrase:
-    FFS_CHECK_RESULT(ffsRewindStream(&nonceStream));
-    FFS_CHECK_RESULT(ffsComputeAmazonPassphrase(userContext, &nonceStream, &setupNetworkConfiguration->keyStream));
+    FFS_CHECK_RESULT(ffsRewindStream(nonceStream));
+    FfsStream_t ecdhSharedSecretStream = ffsCreateInputStream((uint8_t *) cache->sharedSecret, SHARED_SECRET_KEY_SIZE);
+    FFS_CHECK_RESULT(ffsComputeAmazonPassphrase(userContext, &ecdhSharedSecretStream, nonceStream, &setupNetworkConfiguration->keyStream));
     ffsLogStream("Calculated passphrase:", &setupNetworkConfiguration->keyStream);
 
     setupNetworkConfiguration->isHiddenNetwork = true;
@@ -70,24 +172,95 @@ FFS_RESULT ffsComputeAmazonCustomEncodedNetworkConfiguration(struct FfsUserConte
 }
 
 /*
- * This function is to compute the Amazon Custom SSID.
+ * This function folds the unread bytes of a stream into a 64-bit FNV-1a fingerprint.
  *
  */
-static FFS_RESULT ffsComputeAmazonSSID(struct FfsUserContext_s *userContext, FfsStream_t *nonceStream, FfsStream_t *ssidStream) {
-    // Step 1: Compute AuthMaterialIndex
-    FFS_TEMPORARY_OUTPUT_STREAM(authMaterialIndexStream, AUTH_MATERIAL_INDEX_SIZE);
-    FFS_CHECK_RESULT(ffsComputeAuthMaterialIndex(userContext, &authMaterialIndexStream));
+static uint64_t ffsUpdateFingerprint(uint64_t fingerprint, FfsStream_t *stream) {
+    const uint8_t *data = FFS_STREAM_NEXT_READ(*stream);
+    for (size_t i = 0; i < FFS_STREAM_DATA_SIZE(*stream); i++) {
+        fingerprint ^= data[i];
+        fingerprint *= FINGERPRINT_PRIME;
+    }
+    return fingerprint;
+}
 
-    ffsLogStream("Device auth material index", &authMaterialIndexStream);
+/*
+ * This function reads and validates the stored cache.
+ *
+ */
+static FFS_RESULT ffsReadEncodedSetupNetworkCache(struct FfsUserContext_s *userContext, FfsEncodedSetupNetworkCache_t *cache) {
+    FFS_TEMPORARY_OUTPUT_STREAM(cacheStream, FFS_ENCODED_SETUP_NETWORK_CACHE_SIZE);
+    FfsMapValue_t cacheValue = {
+        .type = FFS_MAP_VALUE_TYPE_BYTES,
+        .bytesStream = cacheStream
+    };
+
+    FFS_RESULT result = ffsGetConfigurationValue(userContext, FFS_CONFIGURATION_ENTRY_KEY_ENCODED_SETUP_NETWORK_CACHE, &cacheValue);
+    if (result != FFS_SUCCESS) {
+        return result;
+    }
+
+    if (cacheValue.type != FFS_MAP_VALUE_TYPE_BYTES
+            || FFS_STREAM_DATA_SIZE(cacheValue.bytesStream) != FFS_ENCODED_SETUP_NETWORK_CACHE_SIZE
+            || FFS_STREAM_NEXT_READ(cacheValue.bytesStream)[0] != FFS_ENCODED_SETUP_NETWORK_CACHE_VERSION) {
+        ffsLogWarning("Ignoring an invalid encoded setup network cache");
+        return FFS_ERROR;
+    }
+
+    // Skip the version byte; the size check covers the rest.
+    const uint8_t *data = FFS_STREAM_NEXT_READ(cacheValue.bytesStream) + 1;
+    memcpy(cache->fingerprint, data, FFS_ENCODED_SETUP_NETWORK_FINGERPRINT_SIZE);
+    data += FFS_ENCODED_SETUP_NETWORK_FINGERPRINT_SIZE;
+    memcpy(cache->authMaterialIndex, data, AUTH_MATERIAL_INDEX_SIZE);
+    data += AUTH_MATERIAL_INDEX_SIZE;
+    memcpy(cache->sharedSecret, data, SHARED_SECRET_KEY_SIZE);
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * This function stores the cache.
+ *
+ */
+static FFS_RESULT ffsWriteEncodedSetupNetworkCache(struct FfsUserContext_s *userContext, const FfsEncodedSetupNetworkCache_t *cache) {
+    FFS_TEMPORARY_OUTPUT_STREAM(cacheStream, FFS_ENCODED_SETUP_NETWORK_CACHE_SIZE);
+    FFS_CHECK_RESULT(ffsEncodeAmazonCustomEncodedNetworkCache(cache, &cacheStream));
 
-    // Step 2: Compute the first 2 characters of resulting SSID.
+    FfsMapValue_t cacheValue = {
+        .type = FFS_MAP_VALUE_TYPE_BYTES,
+        .bytesStream = cacheStream
+    };
+
+    return ffsSetConfigurationValue(userContext, FFS_CONFIGURATION_ENTRY_KEY_ENCODED_SETUP_NETWORK_CACHE, &cacheValue);
+}
+
+/*
+ * This function serializes the cache.
+ *
+ */
+FFS_RESULT ffsEncodeAmazonCustomEncodedNetworkCache(const FfsEncodedSetupNetworkCache_t *cache,
+        FfsStream_t *outputStream) {
+    FFS_CHECK_RESULT(ffsWriteByteToStream(FFS_ENCODED_SETUP_NETWORK_CACHE_VERSION, outputStream));
+    FFS_CHECK_RESULT(ffsWriteStream(cache->fingerprint, FFS_ENCODED_SETUP_NETWORK_FINGERPRINT_SIZE, outputStream));
+    FFS_CHECK_RESULT(ffsWriteStream(cache->authMaterialIndex, AUTH_MATERIAL_INDEX_SIZE, outputStream));
+    FFS_CHECK_RESULT(ffsWriteStream(cache->sharedSecret, SHARED_SECRET_KEY_SIZE, outputStream));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * This function is to compute the Amazon Custom SSID.
+ *
+ */
+static FFS_RESULT ffsComputeAmazonSSID(struct FfsUserContext_s *userContext, FfsStream_t *authMaterialIndexStream, FfsStream_t *nonceStream, FfsStream_t *ssidStream) {
+    // Step 1: Compute the first 2 characters of resulting SSID.
     uint8_t *firstAuthMaterialbyte;
-    FFS_CHECK_RESULT(ffsReadStream(&authMaterialIndexStream, 1, &firstAuthMaterialbyte));
+    FFS_CHECK_RESULT(ffsReadStream(authMaterialIndexStream, 1, &firstAuthMaterialbyte));
     FFS_CHECK_RESULT(ffsComputeFirst2CharactersOfSSID(firstAuthMaterialbyte, ssidStream));
     ffsLogStream("First 2 characters of SSID", ssidStream);
 
-    // Step 3: Compute the last 30 characters of resulting SSID.
-    // Step 3.1: Get product Index:
+    // Step 2: Compute the last 30 characters of resulting SSID.
+    // Step 2.1: Get product Index:
     FFS_TEMPORARY_OUTPUT_STREAM(productIndexStream, PRODUCT_INDEX_SIZE);
     FfsMapValue_t productIndexKeyValue = {
         .type = FFS_MAP_VALUE_TYPE_BYTES,
@@ -96,8 +269,8 @@ static FFS_RESULT ffsComputeAmazonSSID(struct FfsUserContext_s *userContext, Ffs
     FFS_CHECK_RESULT(ffsGetConfigurationValue(userContext, FFS_CONFIGURATION_ENTRY_KEY_PRODUCT_INDEX, &productIndexKeyValue));
     ffsLogStream("Product index", &productIndexKeyValue.stringStream);
 
-    // Step 3.2: Call function to compute the 30 characters of SSID
-    FFS_CHECK_RESULT(ffsComputeLast30CharactersOfSSID(&authMaterialIndexStream, &productIndexKeyValue.stringStream, nonceStream, ssidStream));
+    // Step 2.2: Call function to compute the 30 characters of SSID
+    FFS_CHECK_RESULT(ffsComputeLast30CharactersOfSSID(authMaterialIndexStream, &productIndexKeyValue.stringStream, nonceStream, ssidStream));
     ffsLogStream("SSID", ssidStream);
     return FFS_SUCCESS;
 }
@@ -107,26 +280,10 @@ static FFS_RESULT ffsComputeAmazonSSID(struct FfsUserContext_s *userContext, Ffs
  * This function computes the passphrase for the 1P Amazon SSID.
  *
  */
-static FFS_RESULT ffsComputeAmazonPassphrase(struct FfsUserContext_s *userContext, FfsStream_t *nonceStream, FfsStream_t *passphraseStream) {
-    // Calculate passphrase:
-    FFS_TEMPORARY_OUTPUT_STREAM(cloudPublicKeyStream, DER_PUBLIC_KEY_SIZE);
-    FfsMapValue_t cloudPublicKeyValue = {
-        .type = FFS_MAP_VALUE_TYPE_BYTES,
-        .bytesStream = cloudPublicKeyStream
-    };
-
-    // Call getConfigMap to get cloud public key. 
-    FFS_CHECK_RESULT(ffsGetConfigurationValue(userContext, FFS_CONFIGURATION_ENTRY_KEY_CLOUD_EC_PUBLIC_KEY_DER, &cloudPublicKeyValue));
-    ffsLogStream("Cloud pub key bytes:", &cloudPublicKeyValue.bytesStream);
-
-    // Call compat function to compute ECDH shared secret key using (cloud pubkey)
-    FFS_TEMPORARY_OUTPUT_STREAM(ecdhSharedSecretStream, SHARED_SECRET_KEY_SIZE);
-    FFS_CHECK_RESULT(ffsComputeECDHKey(userContext, &cloudPublicKeyValue.bytesStream, &ecdhSharedSecretStream));
-    ffsLogStream("Ecdh shared secret bytes:", &ecdhSharedSecretStream);
-
+static FFS_RESULT ffsComputeAmazonPassphrase(struct FfsUserContext_s *userContext, FfsStream_t *ecdhSharedSecretStream, FfsStream_t *nonceStream, FfsStream_t *passphraseStream) {
     // Call compat HMAC function with (secret, nonce)
     FFS_TEMPORARY_OUTPUT_STREAM(hmacSha256Stream, SHARED_SECRET_KEY_SIZE);
-    FFS_CHECK_RESULT(ffsComputeHMACSHA256(userContext, &ecdhSharedSecretStream, nonceStream, &hmacSha256Stream));
+    FFS_CHECK_RESULT(ffsComputeHMACSHA256(userContext, ecdhSharedSecretStream, nonceStream, &hmacSha256Stream));
     ffsLogStream("HMAC bytes:", &hmacSha256Stream);
 
     // Encode_base64 the whole HMAC to get the passphrase
@@ -165,20 +322,10 @@ static FFS_RESULT ffsComputeFirst2CharactersOfSSID(uint8_t *firstAuthMaterialbyt
  * The authMaterialIndexStream should have enough space to hold the authMaterialIndex which is of size AUTH_MATERIAL_INDEX_SIZE
  *
  */
-static FFS_RESULT ffsComputeAuthMaterialIndex(struct FfsUserContext_s *userContext, FfsStream_t *authMaterialIndexStream) {
-
-    FFS_TEMPORARY_OUTPUT_STREAM(devicePublicKeyStream, DER_PUBLIC_KEY_SIZE);
-    FfsMapValue_t devicePublicKeyValue = {
-        .type = FFS_MAP_VALUE_TYPE_BYTES,
-        .bytesStream = devicePublicKeyStream
-    };
-
-    FFS_CHECK_RESULT(ffsGetConfigurationValue(userContext, FFS_CONFIGURATION_ENTRY_KEY_DEVICE_EC_PUBLIC_KEY_DER, &devicePublicKeyValue));
-
-    ffsLogStream("Device Public key DER bytes:", &devicePublicKeyValue.bytesStream);
+static FFS_RESULT ffsComputeAuthMaterialIndex(struct FfsUserContext_s *userContext, FfsStream_t *devicePublicKeyStream, FfsStream_t *authMaterialIndexStream) {
 
     FFS_TEMPORARY_OUTPUT_STREAM(hashStream, HASH_SIZE);
-    FFS_CHECK_RESULT(ffsSha256(userContext, &devicePublicKeyValue.bytesStream, &hashStream));
+    FFS_CHECK_RESULT(ffsSha256(userContext, devicePublicKeyStream, &hashStream));
     
     ffsLogStream("Device Public key sha-256 hash:", &hashStream);
     
@@ -0,0 +1,231 @@
+/** @file ffs_wifi_provisionee_scan_list.c
+ *
+ * @brief Deduplicated, ranked Wi-Fi scan result list implementation.
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_check_result.h"
+#include "ffs/common/ffs_logging.h"
+#include "ffs/wifi_provisionee/ffs_wifi_provisionee_scan_list.h"
+
+#include <string.h>
+
+// Static function prototypes.
+static int32_t ffsGetScanListScore(FFS_WIFI_SECURITY_PROTOCOL securityProtocol, int32_t signalStrength);
+static FfsWifiProvisioneeScanListEntry_t *ffsFindScanListEntry(FfsWifiProvisioneeScanList_t *scanList,
+        const uint8_t *ssid, size_t ssidSize, FFS_WIFI_SECURITY_PROTOCOL securityProtocol);
+static FfsWifiProvisioneeScanListEntry_t *ffsFindLowestScanListEntry(FfsWifiProvisioneeScanList_t *scanList);
+static void ffsSetScanListAccessPoint(FfsWifiProvisioneeScanListEntry_t *entry,
+        FfsWifiScanResult_t *wifiScanResult);
+
+/*
+ * Initialize a scan list.
+ */
+FFS_RESULT ffsInitializeWifiProvisioneeScanList(FfsWifiProvisioneeScanList_t *scanList,
+        FfsWifiProvisioneeScanListEntry_t *entries, size_t capacity)
+{
+    if (!scanList || !entries || !capacity) {
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    memset(scanList, 0, sizeof(*scanList));
+    scanList->entries = entries;
+    scanList->capacity = capacity;
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Add a scan result.
+ */
+FFS_RESULT ffsWifiProvisioneeScanListAdd(FfsWifiProvisioneeScanList_t *scanList,
+        FfsWifiScanResult_t *wifiScanResult)
+{
+    const uint8_t *ssid = FFS_STREAM_NEXT_READ(wifiScanResult->ssidStream);
+    size_t ssidSize = FFS_STREAM_DATA_SIZE(wifiScanResult->ssidStream);
+
+    if (ssidSize > FFS_MAXIMUM_SSID_SIZE) {
+        ffsLogWarning("Ignoring Wi-Fi scan result with an oversized SSID.");
+        return FFS_SUCCESS;
+    }
+
+    // Merge with an existing entry for the same network.
+    FfsWifiProvisioneeScanListEntry_t *entry = ffsFindScanListEntry(scanList, ssid,
+            ssidSize, wifiScanResult->securityProtocol);
+    if (entry) {
+        entry->bssidCount++;
+        scanList->duplicateCount++;
+
+        // Keep the strongest access point.
+        if (wifiScanResult->signalStrength > entry->signalStrength) {
+            ffsSetScanListAccessPoint(entry, wifiScanResult);
+        }
+
+        return FFS_SUCCESS;
+    }
+
+    if (scanList->count < scanList->capacity) {
+        entry = &scanList->entries[scanList->count++];
+    } else {
+
+        // Full; replace the lowest-ranked entry if the new network ranks above it.
+        entry = ffsFindLowestScanListEntry(scanList);
+        scanList->droppedCount++;
+        if (ffsGetScanListScore(wifiScanResult->securityProtocol, wifiScanResult->signalStrength)
+                <= ffsGetScanListScore(entry->securityProtocol, entry->signalStrength)) {
+            return FFS_SUCCESS;
+        }
+    }
+
+    memset(entry, 0, sizeof(*entry));
+    memcpy(entry->ssid, ssid, ssidSize);
+    entry->ssidSize = ssidSize;
+    entry->securityProtocol = wifiScanResult->securityProtocol;
+    entry->bssidCount = 1;
+    ffsSetScanListAccessPoint(entry, wifiScanResult);
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Sort the entries by rank.
+ */
+FFS_RESULT ffsWifiProvisioneeScanListRank(FfsWifiProvisioneeScanList_t *scanList)
+{
+    // Insertion sort: the list is small and the sort must be stable.
+    for (size_t i = 1; i < scanList->count; i++) {
+        FfsWifiProvisioneeScanListEntry_t entry = scanList->entries[i];
+        int32_t score = ffsGetScanListScore(entry.securityProtocol, entry.signalStrength);
+        size_t j = i;
+
+        while (j > 0 && ffsGetScanListScore(scanList->entries[j - 1].securityProtocol,
+                scanList->entries[j - 1].signalStrength) < score) {
+            scanList->entries[j] = scanList->entries[j - 1];
+            j--;
+        }
+
+        scanList->entries[j] = entry;
+    }
+
+    scanList->nextIndex = 0;
+
+    ffsLogDebug("Ranked %d Wi-Fi networks (%d duplicate access points merged)",
+            (int) scanList->count, (int) scanList->duplicateCount);
+
+    if (scanList->droppedCount) {
+        ffsLogWarning("Scan list full: %d lower-ranked Wi-Fi networks not posted",
+                (int) scanList->droppedCount);
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Get the next entry to post.
+ */
+FFS_RESULT ffsWifiProvisioneeScanListPeek(FfsWifiProvisioneeScanList_t *scanList,
+        FfsWifiScanResult_t *wifiScanResult, bool *isUnderrun)
+{
+    if (scanList->nextIndex >= scanList->count) {
+        *isUnderrun = true;
+        return FFS_SUCCESS;
+    }
+
+    FfsWifiProvisioneeScanListEntry_t *entry = &scanList->entries[scanList->nextIndex];
+
+    wifiScanResult->ssidStream = ffsCreateInputStream(entry->ssid, entry->ssidSize);
+    wifiScanResult->bssidStream = ffsCreateInputStream(entry->bssid, FFS_BSSID_SIZE);
+    wifiScanResult->securityProtocol = entry->securityProtocol;
+    wifiScanResult->frequencyBand = entry->frequencyBand;
+    wifiScanResult->signalStrength = entry->signalStrength;
+    *isUnderrun = false;
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Consume the next entry.
+ */
+FFS_RESULT ffsWifiProvisioneeScanListAdvance(FfsWifiProvisioneeScanList_t *scanList)
+{
+    if (scanList->nextIndex >= scanList->count) {
+        FFS_FAIL(FFS_UNDERRUN);
+    }
+
+    scanList->nextIndex++;
+
+    return FFS_SUCCESS;
+}
+
+/** @brief Get the ranking score of a network.
+ */
+static int32_t ffsGetScanListScore(FFS_WIFI_SECURITY_PROTOCOL securityProtocol, int32_t signalStrength)
+{
+    if (securityProtocol == FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK
+            || securityProtocol == FFS_WIFI_SECURITY_PROTOCOL_WEP) {
+        return signalStrength + FFS_WIFI_PROVISIONEE_SCAN_LIST_SECURED_BONUS;
+    }
+
+    return signalStrength;
+}
+
+/** @brief Find the entry for a network.
+ */
+static FfsWifiProvisioneeScanListEntry_t *ffsFindScanListEntry(FfsWifiProvisioneeScanList_t *scanList,
+        const uint8_t *ssid, size_t ssidSize, FFS_WIFI_SECURITY_PROTOCOL securityProtocol)
+{
+    for (size_t i = 0; i < scanList->count; i++) {
+        FfsWifiProvisioneeScanListEntry_t *entry = &scanList->entries[i];
+
+        if (entry->securityProtocol == securityProtocol
+                && entry->ssidSize == ssidSize
+                && !memcmp(entry->ssid, ssid, ssidSize)) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/** @brief Find the lowest-ranked entry (the last one in scan order on a tie).
+ */
+static FfsWifiProvisioneeScanListEntry_t *ffsFindLowestScanListEntry(FfsWifiProvisioneeScanList_t *scanList)
+{
+    FfsWifiProvisioneeScanListEntry_t *lowestEntry = &scanList->entries[0];
+
+    for (size_t i = 1; i < scanList->count; i++) {
+        FfsWifiProvisioneeScanListEntry_t *entry = &scanList->entries[i];
+
+        if (ffsGetScanListScore(entry->securityProtocol, entry->signalStrength)
+                <= ffsGetScanListScore(lowestEntry->securityProtocol, lowestEntry->signalStrength)) {
+            lowestEntry = entry;
+        }
+    }
+
+    return lowestEntry;
+}
+
+/** @brief Record the access point details of a scan result in an entry.
+ */
+static void ffsSetScanListAccessPoint(FfsWifiProvisioneeScanListEntry_t *entry,
+        FfsWifiScanResult_t *wifiScanResult)
+{
+    size_t bssidSize = FFS_STREAM_DATA_SIZE(wifiScanResult->bssidStream);
+
+    if (bssidSize > FFS_BSSID_SIZE) {
+        bssidSize = FFS_BSSID_SIZE;
+    }
+
+    memset(entry->bssid, 0, sizeof(entry->bssid));
+    memcpy(entry->bssid, FFS_STREAM_NEXT_READ(wifiScanResult->bssidStream), bssidSize);
+    entry->frequencyBand = wifiScanResult->frequencyBand;
+    entry->signalStrength = wifiScanResult->signalStrength;
+}
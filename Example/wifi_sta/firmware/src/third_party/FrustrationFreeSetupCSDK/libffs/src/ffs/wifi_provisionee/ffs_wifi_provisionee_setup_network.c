@@ -23,9 +23,9 @@
 #define FFS_WIFI_SETUP_NETWORK_WIFI_SECURITY_PROTOCOL   FFS_WIFI_SECURITY_PROTOCOL_NONE
 
 /*
- *  Connect to the Wi-Fi FFS setup network.
+ *  Start connecting to the Wi-Fi FFS setup network.
  */
-FFS_RESULT ffsConnectToSetupNetwork(struct FfsUserContext_s *userContext, FfsWifiConfiguration_t *setupWifiConfiguration)
+FFS_RESULT ffsStartConnectingToSetupNetwork(struct FfsUserContext_s *userContext, FfsWifiConfiguration_t *setupWifiConfiguration)
 {
     if (!setupWifiConfiguration
             || ffsStreamIsEmpty(&setupWifiConfiguration->ssidStream)) {
@@ -39,28 +39,12 @@ FFS_RESULT ffsConnectToSetupNetwork(struct FfsUserContext_s *userContext, FfsWif
         return FFS_ERROR;
     }
 
-    FFS_TEMPORARY_OUTPUT_STREAM(ssidStream, FFS_MAXIMUM_SSID_SIZE);
-    FfsWifiConnectionDetails_t connectionDetails = {
-        .ssidStream = ssidStream
-    };
-
     // Store the setup network configuration.
     FFS_CHECK_RESULT(ffsAddWifiConfiguration(userContext, setupWifiConfiguration));
 
     // Start the connection attempt.
     FFS_CHECK_RESULT(ffsConnectToWifi(userContext));
 
-    // Get the connection state.
-    FFS_CHECK_RESULT(ffsGetWifiConnectionDetails(userContext, &connectionDetails));
-
-    // Fail if we are not connected to Wi-Fi.
-    if (connectionDetails.state != FFS_WIFI_CONNECTION_STATE_ASSOCIATED) {
-        ffsLogError("Failed to connect to setup network with final state %d", connectionDetails.state);
-        FFS_FAIL(FFS_ERROR);
-    }
-    
-    ffsLogDebug("Connected to setup network");
-
     return FFS_SUCCESS;
 }
 
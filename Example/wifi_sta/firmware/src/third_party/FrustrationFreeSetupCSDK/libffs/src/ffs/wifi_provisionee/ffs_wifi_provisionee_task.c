@@ -24,17 +24,24 @@
 #include "ffs/conversion/ffs_convert_wifi_scan_result.h"
 #include "ffs/compat/ffs_common_compat.h"
 #include "ffs/compat/ffs_wifi_provisionee_compat.h"
+#include "ffs/dss/ffs_dss_client.h"
 #include "ffs/dss/ffs_dss_operation_compute_configuration_data.h"
 #include "ffs/dss/ffs_dss_operation_get_wifi_credentials.h"
 #include "ffs/dss/ffs_dss_operation_post_wifi_scan_data.h"
 #include "ffs/dss/ffs_dss_operation_report.h"
 #include "ffs/dss/ffs_dss_operation_start_pin_based_setup.h"
 #include "ffs/dss/ffs_dss_operation_start_provisioning_session.h"
+#include "ffs/dss/model/ffs_dss_wifi_connection_attempt.h"
+#include "ffs/wifi_provisionee/ffs_wifi_provisionee_checkpoint.h"
 #include "ffs/wifi_provisionee/ffs_wifi_provisionee_encoded_setup_network.h"
+#include "ffs/wifi_provisionee/ffs_wifi_provisionee_scan_list.h"
 #include "ffs/wifi_provisionee/ffs_wifi_provisionee_setup_network.h"
+#include "ffs/wifi_provisionee/ffs_wifi_provisionee_state.h"
 #include "ffs/wifi_provisionee/ffs_wifi_provisionee_task.h"
 #include "ffs/wifi_provisionee/ffs_wifi_provisionee_user_network.h"
 
+#include <string.h>
+
 /*
  * Macro to short-circuit the task if the cloud returns a false 'canProceed' value.
  */
@@ -46,37 +53,146 @@
     }
 
 /*
- * Task context structure.
+ * Time limit of a Wi-Fi connection, over all of the networks tried.
+ */
+#if !defined(FFS_WIFI_PROVISIONEE_CONNECTION_TIMEOUT_MS)
+#define FFS_WIFI_PROVISIONEE_CONNECTION_TIMEOUT_MS  (60000)
+#endif
+
+/*
+ * Time limit of a DSS call, including its redirects.
+ */
+#define FFS_WIFI_PROVISIONEE_DSS_CALL_TIMEOUT_MS    ((FFS_DSS_MAX_REDIRECTS + 1) * FFS_DSS_REQUEST_TIMEOUT_MS)
+
+/*
+ * Progress of the provisionee state being executed.
  */
-typedef struct {
+typedef enum {
+    FFS_WIFI_PROVISIONEE_TASK_STAGE_START = 0, //!< The state has not started.
+    FFS_WIFI_PROVISIONEE_TASK_STAGE_OPERATION, //!< The Wi-Fi connection or DSS request of the state is running.
+    FFS_WIFI_PROVISIONEE_TASK_STAGE_FALLBACK, //!< The setup network connection after a failed one is running.
+    FFS_WIFI_PROVISIONEE_TASK_STAGE_REPORT //!< The report of the state is running.
+} FFS_WIFI_PROVISIONEE_TASK_STAGE;
+
+/*
+ * Wi-Fi provisionee state machine context, with all of its buffers.
+ */
+struct FfsWifiProvisioneeContext_s {
     struct FfsUserContext_s *userContext;
-    FfsDssClientContext_t *dssClientContext;
+    FfsDssClientContext_t dssClientContext;
     bool cloudCanProceed;
     FfsStream_t saltStream;
-    FfsDssWifiScanResult_t wifiScanResult;
+    FfsWifiProvisioneeScanList_t wifiScanList;
     FfsDssWifiConnectionAttempt_t wifiConnectionAttempt;
     FfsWifiConfiguration_t setupWifiConfiguration;
-} FfsTaskContext_t;
+    bool checkpointEnabled;
+    bool isResuming;
+    uint8_t resumeCount;
+    FFS_WIFI_PROVISIONEE_STATE resumeState;
+    FfsStream_t checkpointItemsStream;
+    bool isInUse;
+    bool isStarted;
+    bool isDone;
+
+    // Progress of the current state.
+    FFS_WIFI_PROVISIONEE_STATE state;
+    FFS_WIFI_PROVISIONEE_TASK_STAGE stage;
+    FFS_WIFI_PROVISIONEE_EVENT awaitedEvent;
+    uint32_t deadlineMs;
+    FFS_RESULT pendingResult;
+    uint32_t pageSequenceNumber;
+    uint32_t totalCredentialsFound;
+    bool allCredentialsFound;
+    bool allCredentialsReturned;
+    bool postedWifiScanData;
+    bool setupNetworkIsSocks;
+    FFS_DSS_WIFI_PROVISIONEE_STATE nextDssProvisioneeState;
+
+    // Data of the DSS request in flight.
+    union {
+        FfsDssReportOperationData_t report;
+        FfsStartProvisioningSessionOperationData_t startProvisioningSession;
+        FfsDssComputeConfigurationDataReponseCallbacks_t computeConfigurationData;
+        FfsDssPostWifiScanDataOperationData_t postWifiScanData;
+        FfsDssGetWifiCredentialsOperationData_t getWifiCredentials;
+    } operationData;
+
+    uint8_t saltBuffer[FFS_SALT_SIZE];
+    uint8_t checkpointItemsBuffer[FFS_WIFI_PROVISIONEE_CHECKPOINT_ITEMS_SIZE];
+    FfsWifiProvisioneeScanListEntry_t wifiScanListEntries[FFS_WIFI_PROVISIONEE_SCAN_LIST_CAPACITY];
+    uint8_t connectionAttemptSsidBuffer[FFS_MAXIMUM_SSID_SIZE];
+    uint8_t setupSsidBuffer[FFS_MAXIMUM_SSID_SIZE];
+    uint8_t setupKeyBuffer[FFS_MAXIMUM_WIFI_KEY_SIZE];
+};
+
+/*
+ * Task context structure.
+ */
+typedef FfsWifiProvisioneeContext_t FfsTaskContext_t;
+
+/*
+ * The only Wi-Fi provisionee state machine.
+ */
+static FfsTaskContext_t sTaskContext;
+
+/*
+ * Context of the running state machine, for the DSS callbacks that log the
+ * items received from the cloud in the checkpoint. The callbacks run on the
+ * HTTP context, so it stays set from init to deinit.
+ */
+static FfsTaskContext_t *sCheckpointTaskContext = NULL;
 
 /*
  * Static function prototypes.
  */
-static FFS_RESULT ffsWifiProvisioneeTaskExecuteState(FfsTaskContext_t *taskContext, FFS_WIFI_PROVISIONEE_STATE state);
+static FFS_RESULT ffsWifiProvisioneeTaskRun(FfsTaskContext_t *taskContext, FFS_WIFI_PROVISIONEE_EVENT event,
+        uint32_t nowMs, bool canBlock, FfsWifiProvisioneeStepStatus_t *status);
+static FFS_RESULT ffsWifiProvisioneeTaskStep(FfsTaskContext_t *taskContext, FFS_WIFI_PROVISIONEE_EVENT event,
+        uint32_t nowMs, bool canBlock);
+static FFS_RESULT ffsWifiProvisioneeTaskPoll(FfsTaskContext_t *taskContext, FFS_WIFI_PROVISIONEE_EVENT event,
+        uint32_t nowMs, bool canBlock, bool *isComplete);
+static void ffsWifiProvisioneeTaskAwait(FfsTaskContext_t *taskContext, FFS_WIFI_PROVISIONEE_EVENT event,
+        uint32_t nowMs, uint32_t timeoutMs);
+static FFS_RESULT ffsWifiProvisioneeTaskResume(FfsTaskContext_t *taskContext, uint32_t nowMs);
+static FFS_RESULT ffsWifiProvisioneeTaskLoadCheckpoint(FfsTaskContext_t *taskContext, bool *isResumable);
+static FFS_RESULT ffsWifiProvisioneeTaskRestart(FfsTaskContext_t *taskContext);
+static FFS_RESULT ffsWifiProvisioneeTaskSaveCheckpoint(FfsTaskContext_t *taskContext,
+        FFS_WIFI_PROVISIONEE_STATE state);
+static void ffsWifiProvisioneeTaskClearCheckpoint(FfsTaskContext_t *taskContext);
+static void ffsWifiProvisioneeTaskCheckpointItemLogged(FFS_RESULT result);
+static FFS_RESULT ffsWifiProvisioneeTaskStartSetupNetwork(FfsTaskContext_t *taskContext, uint32_t nowMs);
+static FFS_RESULT ffsWifiProvisioneeTaskStartFallbackSetupNetwork(FfsTaskContext_t *taskContext, uint32_t nowMs);
+static FFS_RESULT ffsWifiProvisioneeTaskSetupNetworkConnected(FfsTaskContext_t *taskContext, uint32_t nowMs,
+        bool *isConnected);
+static FFS_RESULT ffsWifiProvisioneeTaskStartReport(FfsTaskContext_t *taskContext,
+        FFS_DSS_WIFI_PROVISIONEE_STATE dssProvisioneeState, FFS_RESULT result, bool reportConnectionAttempts,
+        uint32_t nowMs);
+static FFS_RESULT ffsWifiProvisioneeTaskFinishReport(FfsTaskContext_t *taskContext);
+static FFS_RESULT ffsWifiProvisioneeTaskExecuteState(FfsTaskContext_t *taskContext, uint32_t nowMs);
 static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateNotProvisioned(FfsTaskContext_t *taskContext);
-static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateConnectingToSetupNetwork(FfsTaskContext_t *taskContext);
-static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateStartProvisioning(FfsTaskContext_t *taskContext);
-static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateStartPinBasedSetup(FfsTaskContext_t *taskContext);
-static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateComputeConfiguration(FfsTaskContext_t *taskContext);
-static FFS_RESULT ffsWifiProvisioneeTaskExecuteStatePostWifiScanData(FfsTaskContext_t *taskContext);
-static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateGetWifiList(FfsTaskContext_t *taskContext);
-static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateConnectingToUserNetwork(FfsTaskContext_t *taskContext);
-static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateConnectedToUserNetwork(FfsTaskContext_t *taskContext);
+static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateConnectingToSetupNetwork(FfsTaskContext_t *taskContext,
+        uint32_t nowMs);
+static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateStartProvisioning(FfsTaskContext_t *taskContext, uint32_t nowMs);
+static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateStartPinBasedSetup(FfsTaskContext_t *taskContext, uint32_t nowMs);
+static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateComputeConfiguration(FfsTaskContext_t *taskContext,
+        uint32_t nowMs);
+static FFS_RESULT ffsWifiProvisioneeTaskExecuteStatePostWifiScanData(FfsTaskContext_t *taskContext, uint32_t nowMs);
+static FFS_RESULT ffsWifiProvisioneeTaskPostNextWifiScanData(FfsTaskContext_t *taskContext, uint32_t nowMs);
+static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateGetWifiList(FfsTaskContext_t *taskContext, uint32_t nowMs);
+static FFS_RESULT ffsWifiProvisioneeTaskGetNextWifiCredentials(FfsTaskContext_t *taskContext, uint32_t nowMs);
+static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateConnectingToUserNetwork(FfsTaskContext_t *taskContext,
+        uint32_t nowMs);
+static FFS_RESULT ffsWifiProvisioneeTaskReconnectToSetupNetwork(FfsTaskContext_t *taskContext, uint32_t nowMs);
+static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateConnectedToUserNetwork(FfsTaskContext_t *taskContext,
+        uint32_t nowMs);
 static FFS_RESULT ffsGetDssRegistrationState(FfsTaskContext_t *taskContext,
         FFS_DSS_REGISTRATION_STATE *dssRegistrationState);
 static FFS_RESULT ffsWifiGetDssConnectionAttemptsCallback(struct FfsUserContext_s *userContext,
         FfsDssWifiConnectionAttempt_t *dssWifiConnectionAttempt, void *callbackDataPointer);
 static FFS_RESULT ffsWifiGetDssScanResultsCallback(struct FfsUserContext_s *userContext,
-        FfsDssWifiScanResult_t *dssWifiScanResult, void *callbackDataPointer);
+        struct FfsWifiProvisioneeScanList_s *scanList, void *callbackDataPointer);
+static FFS_RESULT ffsWifiPopulateScanList(struct FfsUserContext_s *userContext,
+        FfsWifiProvisioneeScanList_t *wifiScanList);
 static FFS_RESULT ffsWifiSaveDssCredentialsCallback(struct FfsUserContext_s *userContext,
         FfsDssWifiCredentials_t *dssWifiCredentials);
 static FFS_RESULT FfsWifiSaveDssRegistrationDetailsCallback(
@@ -89,105 +205,636 @@ static FFS_RESULT ffsWifiSaveConfigurationCallback(struct FfsUserContext_s *user
  */
 FFS_RESULT ffsWifiProvisioneeTask(struct FfsUserContext_s *userContext)
 {
-    // Initialize the contexts.
-    FfsDssClientContext_t dssClientContext;
-    FfsTaskContext_t taskContext = {
-        .userContext = userContext,
-        .dssClientContext = &dssClientContext,
-        .cloudCanProceed = true
-    };
-    FFS_WIFI_PROVISIONEE_STATE state;
+    FfsWifiProvisioneeContext_t *context;
+    FfsWifiProvisioneeStepStatus_t status = { .isDone = false, .awaitedEvent = FFS_WIFI_PROVISIONEE_EVENT_NONE };
+    FFS_RESULT result = FFS_SUCCESS;
+
+    FFS_CHECK_RESULT(ffsWifiProvisioneeInit(userContext, &context));
+
+    // Run the state machine to the end, waiting for each operation in turn.
+    while (result == FFS_SUCCESS && !status.isDone) {
+        result = ffsWifiProvisioneeTaskRun(context, status.awaitedEvent, 0, true, &status);
+    }
+
+    ffsWifiProvisioneeDeinit(context);
+    FFS_CHECK_RESULT(result);
+
+    ffsLogDebug("End Ffs Wi-Fi provisionee task\n\r");
+    return FFS_SUCCESS;
+}
+
+/*
+ * Initialize the Ffs Wi-Fi provisionee state machine.
+ */
+FFS_RESULT ffsWifiProvisioneeInit(struct FfsUserContext_s *userContext, FfsWifiProvisioneeContext_t **context)
+{
+    FfsTaskContext_t *taskContext = &sTaskContext;
+
+    if (taskContext->isInUse) {
+        ffsLogError("Ffs Wi-Fi provisionee state machine already running");
+        FFS_FAIL(FFS_ERROR);
+    }
+
+    // Initialize the context.
+    memset(taskContext, 0, sizeof(*taskContext));
+    taskContext->userContext = userContext;
+    taskContext->cloudCanProceed = true;
+    taskContext->checkpointEnabled = true;
 
     // Create the persistent salt stream.
-    FFS_TEMPORARY_OUTPUT_STREAM(saltStream, FFS_SALT_SIZE);
-    taskContext.saltStream = saltStream;
+    taskContext->saltStream = ffsCreateOutputStream(taskContext->saltBuffer, sizeof(taskContext->saltBuffer));
 
-    // Create the persistent scan result and connection attempt objects.
-    FFS_TEMPORARY_OUTPUT_STREAM(ssidStream, FFS_MAXIMUM_SSID_SIZE);
-    FFS_TEMPORARY_OUTPUT_STREAM(bssidStream, FFS_BSSID_SIZE);
-    taskContext.wifiScanResult.ssidStream = ssidStream;
-    taskContext.wifiScanResult.bssidStream = bssidStream;
-    taskContext.wifiConnectionAttempt.ssidStream = ssidStream;
+    // Create the log of the items received from the cloud, saved with each checkpoint.
+    taskContext->checkpointItemsStream = ffsCreateOutputStream(taskContext->checkpointItemsBuffer,
+            sizeof(taskContext->checkpointItemsBuffer));
+
+    // Create the persistent scan list and connection attempt objects.
+    FFS_CHECK_RESULT(ffsInitializeWifiProvisioneeScanList(&taskContext->wifiScanList,
+            taskContext->wifiScanListEntries, FFS_WIFI_PROVISIONEE_SCAN_LIST_CAPACITY));
+    taskContext->wifiConnectionAttempt.ssidStream = ffsCreateOutputStream(taskContext->connectionAttemptSsidBuffer,
+            sizeof(taskContext->connectionAttemptSsidBuffer));
 
     ffsLogDebug("Start Ffs Wi-Fi provisionee task");
 
     // Initialize the DSS client context.
-    FFS_CHECK_RESULT(ffsDssClientInit(userContext, &dssClientContext));
+    FFS_CHECK_RESULT(ffsDssClientInit(userContext, &taskContext->dssClientContext));
 
     // Set the initial provisionee state.
-    FFS_CHECK_RESULT(ffsSetWifiProvisioneeState(userContext, FFS_WIFI_PROVISIONEE_STATE_NOT_PROVISIONED));
+    FFS_CHECK_RESULT(ffsSetWifiProvisioneeState(taskContext->userContext, FFS_WIFI_PROVISIONEE_STATE_NOT_PROVISIONED));
 
     // Set the encoded setup network if possible.
-    FFS_TEMPORARY_OUTPUT_STREAM(encodedSsidStream, FFS_MAXIMUM_SSID_SIZE);
-    FFS_TEMPORARY_OUTPUT_STREAM(keyStream, FFS_MAXIMUM_WIFI_KEY_SIZE);
-    taskContext.setupWifiConfiguration.ssidStream = encodedSsidStream;
-    taskContext.setupWifiConfiguration.keyStream = keyStream;
-    
-    FFS_RESULT result = ffsComputeAmazonCustomEncodedNetworkConfiguration(taskContext.userContext, &taskContext.setupWifiConfiguration);
+    taskContext->setupWifiConfiguration.ssidStream = ffsCreateOutputStream(taskContext->setupSsidBuffer,
+            sizeof(taskContext->setupSsidBuffer));
+    taskContext->setupWifiConfiguration.keyStream = ffsCreateOutputStream(taskContext->setupKeyBuffer,
+            sizeof(taskContext->setupKeyBuffer));
+
+    FFS_RESULT result = ffsComputeAmazonCustomEncodedNetworkConfiguration(taskContext->userContext,
+            &taskContext->setupWifiConfiguration);
     if (result == FFS_SUCCESS) {
         ffsLogDebug("Successfully generated encoded setup network");
     }
 
-    // Start the main task.
-    for (;;) {
+    taskContext->isInUse = true;
+    sCheckpointTaskContext = taskContext;
+    *context = taskContext;
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Release the Ffs Wi-Fi provisionee state machine.
+ */
+void ffsWifiProvisioneeDeinit(FfsWifiProvisioneeContext_t *context)
+{
+    if (context->awaitedEvent == FFS_WIFI_PROVISIONEE_EVENT_HTTP) {
+        (void) ffsDssClientCancel(&context->dssClientContext);
+    }
+
+    context->awaitedEvent = FFS_WIFI_PROVISIONEE_EVENT_NONE;
+    context->isInUse = false;
+    sCheckpointTaskContext = NULL;
+}
+
+/*
+ * Advance the Ffs Wi-Fi provisionee state machine.
+ */
+FFS_RESULT ffsWifiProvisioneeStep(FfsWifiProvisioneeContext_t *context, FFS_WIFI_PROVISIONEE_EVENT event,
+        uint32_t nowMs, FfsWifiProvisioneeStepStatus_t *status)
+{
+    FFS_CHECK_RESULT(ffsWifiProvisioneeTaskRun(context, event, nowMs, false, status));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Run one step and report the status.
+ */
+static FFS_RESULT ffsWifiProvisioneeTaskRun(FfsTaskContext_t *taskContext, FFS_WIFI_PROVISIONEE_EVENT event,
+        uint32_t nowMs, bool canBlock, FfsWifiProvisioneeStepStatus_t *status) {
+
+    FFS_RESULT result = FFS_SUCCESS;
+
+    if (!taskContext->isDone) {
+        result = ffsWifiProvisioneeTaskStep(taskContext, event, nowMs, canBlock);
+
+        // A failed state machine does not run again.
+        if (result != FFS_SUCCESS) {
+            taskContext->isDone = true;
+            taskContext->awaitedEvent = FFS_WIFI_PROVISIONEE_EVENT_NONE;
+        }
+    }
+
+    status->isDone = taskContext->isDone;
+    status->awaitedEvent = taskContext->awaitedEvent;
+    status->deadlineMs = taskContext->deadlineMs;
+    FFS_CHECK_RESULT(result);
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Run one step of the Ffs Wi-Fi provisionee state machine.
+ *
+ * A step collects the operation the last one waited for, then runs the
+ * current state until it starts the next operation or completes; a completed
+ * state ends the step, so each step makes at most one transition.
+ */
+static FFS_RESULT ffsWifiProvisioneeTaskStep(FfsTaskContext_t *taskContext, FFS_WIFI_PROVISIONEE_EVENT event,
+        uint32_t nowMs, bool canBlock) {
+
+    // Collect the awaited operation.
+    if (taskContext->awaitedEvent != FFS_WIFI_PROVISIONEE_EVENT_NONE) {
+        bool isComplete = false;
+        FFS_CHECK_RESULT(ffsWifiProvisioneeTaskPoll(taskContext, event, nowMs, canBlock, &isComplete));
+        if (!isComplete) {
+            return FFS_SUCCESS;
+        }
+    }
+
+    // Resume the session of the last checkpoint, if any.
+    if (!taskContext->isStarted) {
+        FFS_CHECK_RESULT(ffsWifiProvisioneeTaskResume(taskContext, nowMs));
+        return FFS_SUCCESS;
+    }
+
+    // Start the next state.
+    if (taskContext->stage == FFS_WIFI_PROVISIONEE_TASK_STAGE_START) {
         bool clientCanProceed = true;
-        FFS_CHECK_RESULT(ffsWifiProvisioneeCanProceed(userContext, &clientCanProceed));
+        FFS_CHECK_RESULT(ffsWifiProvisioneeCanProceed(taskContext->userContext, &clientCanProceed));
         if (!clientCanProceed) {
             ffsLogDebug("Ffs Wi-Fi provisionee task stopped by client.");
-            break;
+            taskContext->isDone = true;
+            return FFS_SUCCESS;
         }
 
-        FFS_CHECK_RESULT(ffsGetWifiProvisioneeState(userContext, &state));
-        if (ffsWifiProvisioneeStateIsTerminal(state)) {
+        FFS_CHECK_RESULT(ffsGetWifiProvisioneeState(taskContext->userContext, &taskContext->state));
+        if (ffsWifiProvisioneeStateIsTerminal(taskContext->state)) {
             ffsLogDebug("Ffs Wi-Fi provisionee task reached terminal state");
-            break;
+            ffsWifiProvisioneeTaskClearCheckpoint(taskContext);
+            taskContext->isDone = true;
+            return FFS_SUCCESS;
         }
 
-        FFS_CHECK_RESULT(ffsWifiProvisioneeTaskExecuteState(&taskContext, state));
-        if (!taskContext.cloudCanProceed) {
+        // Checkpoint every state the session can be resumed from.
+        FFS_CHECK_RESULT(ffsWifiProvisioneeTaskSaveCheckpoint(taskContext, taskContext->state));
+
+        const char *stateString;
+        FFS_CHECK_RESULT(ffsGetWifiProvisioneeStateString(taskContext->state, &stateString));
+        ffsLogDebug("Execute Wi-Fi provisionee state %s", stateString);
+    }
+
+    FFS_RESULT result = ffsWifiProvisioneeTaskExecuteState(taskContext, nowMs);
+
+    // Wait for the operation the state started.
+    if (result == FFS_SUCCESS && taskContext->awaitedEvent != FFS_WIFI_PROVISIONEE_EVENT_NONE) {
+        return FFS_SUCCESS;
+    }
+    taskContext->stage = FFS_WIFI_PROVISIONEE_TASK_STAGE_START;
+
+    // The cloud may no longer accept a resumed session (e.g., it expired).
+    if (taskContext->isResuming) {
+        taskContext->isResuming = false;
+        if (result != FFS_SUCCESS || !taskContext->cloudCanProceed) {
+            ffsLogWarning("Resumed provisioning session failed, starting a new session");
+            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskRestart(taskContext));
+            return FFS_SUCCESS;
+        }
+    }
+
+    FFS_CHECK_RESULT(result);
+    if (!taskContext->cloudCanProceed) {
+        ffsWifiProvisioneeTaskClearCheckpoint(taskContext);
+        taskContext->isDone = true;
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Check whether the awaited operation completed, and store its result.
+ *
+ * An operation still running at its deadline fails with a timeout. A step on
+ * another event only checks the deadline. A blocking caller waits for DSS
+ * requests here instead.
+ */
+static FFS_RESULT ffsWifiProvisioneeTaskPoll(FfsTaskContext_t *taskContext, FFS_WIFI_PROVISIONEE_EVENT event,
+        uint32_t nowMs, bool canBlock, bool *isComplete) {
+
+    bool isExpired = !canBlock && (int32_t) (nowMs - taskContext->deadlineMs) >= 0;
+
+    *isComplete = false;
+
+    if (event != FFS_WIFI_PROVISIONEE_EVENT_NONE && event != taskContext->awaitedEvent && !isExpired) {
+        return FFS_SUCCESS;
+    }
+
+    switch (taskContext->awaitedEvent) {
+        case FFS_WIFI_PROVISIONEE_EVENT_HTTP:
+            if (canBlock) {
+                taskContext->pendingResult = ffsDssClientWait(&taskContext->dssClientContext);
+                *isComplete = true;
+                break;
+            }
+
+            taskContext->pendingResult = ffsDssClientPoll(&taskContext->dssClientContext, isComplete);
+            if (!*isComplete && isExpired) {
+                ffsLogError("DSS request timed out");
+                (void) ffsDssClientCancel(&taskContext->dssClientContext);
+                taskContext->pendingResult = FFS_TIMEOUT;
+                *isComplete = true;
+            }
+            break;
+
+        case FFS_WIFI_PROVISIONEE_EVENT_WIFI: {
+            FFS_TEMPORARY_OUTPUT_STREAM(ssidStream, FFS_MAXIMUM_SSID_SIZE);
+            FfsWifiConnectionDetails_t connectionDetails = {
+                .ssidStream = ssidStream
+            };
+
+            // Get the connection state.
+            FFS_CHECK_RESULT(ffsGetWifiConnectionDetails(taskContext->userContext, &connectionDetails));
+
+            switch (connectionDetails.state) {
+                case FFS_WIFI_CONNECTION_STATE_ASSOCIATED:
+                    taskContext->pendingResult = FFS_SUCCESS;
+                    *isComplete = true;
+                    break;
+                case FFS_WIFI_CONNECTION_STATE_UNAUTHENTICATED:
+                case FFS_WIFI_CONNECTION_STATE_AUTHENTICATED:
+                    if (isExpired) {
+                        ffsLogError("Wi-Fi connection timed out");
+                        taskContext->pendingResult = FFS_TIMEOUT;
+                        *isComplete = true;
+                    }
+                    break;
+                default:
+                    ffsLogError("Wi-Fi connection failed with final state %d", connectionDetails.state);
+                    taskContext->pendingResult = FFS_ERROR;
+                    *isComplete = true;
+                    break;
+            }
             break;
         }
+
+        default:
+            FFS_FAIL(FFS_ERROR);
+    }
+
+    if (*isComplete) {
+        taskContext->awaitedEvent = FFS_WIFI_PROVISIONEE_EVENT_NONE;
     }
 
-    ffsLogDebug("End Ffs Wi-Fi provisionee task\n\r");
     return FFS_SUCCESS;
 }
 
 /*
- * Execute a Ffs provisionee state.
+ * Wait for an event before the next step.
  */
-static FFS_RESULT ffsWifiProvisioneeTaskExecuteState(FfsTaskContext_t *taskContext, FFS_WIFI_PROVISIONEE_STATE state) {
+static void ffsWifiProvisioneeTaskAwait(FfsTaskContext_t *taskContext, FFS_WIFI_PROVISIONEE_EVENT event,
+        uint32_t nowMs, uint32_t timeoutMs) {
+
+    taskContext->awaitedEvent = event;
+    taskContext->deadlineMs = nowMs + timeoutMs;
+}
+
+/*
+ * Resume the session of the last checkpoint, if it is still resumable.
+ *
+ * The first step restores the DSS session and starts rejoining the setup
+ * network the DSS requests go through; the step that sees the connection
+ * replays the received items.
+ */
+static FFS_RESULT ffsWifiProvisioneeTaskResume(FfsTaskContext_t *taskContext, uint32_t nowMs) {
+
+    if (taskContext->stage == FFS_WIFI_PROVISIONEE_TASK_STAGE_START) {
+        bool isResumable = false;
+        FFS_CHECK_RESULT(ffsWifiProvisioneeTaskLoadCheckpoint(taskContext, &isResumable));
+        if (!isResumable) {
+            taskContext->isStarted = true;
+            return FFS_SUCCESS;
+        }
+
+        FFS_CHECK_RESULT(ffsWifiProvisioneeTaskStartSetupNetwork(taskContext, nowMs));
+        return FFS_SUCCESS;
+    }
+
+    bool isConnected = false;
+    FFS_CHECK_RESULT(ffsWifiProvisioneeTaskSetupNetworkConnected(taskContext, nowMs, &isConnected));
+    if (!isConnected) {
+        return FFS_SUCCESS;
+    }
+    taskContext->stage = FFS_WIFI_PROVISIONEE_TASK_STAGE_START;
+
+    // Hand the received items back to the client. The user networks are added after the setup
+    // network, as they are in a session that is not resumed, so a client with a single network
+    // slot keeps them.
+    FfsStream_t itemsStream = taskContext->checkpointItemsStream;
+    FFS_CHECK_RESULT(ffsReplayWifiProvisioneeCheckpointItems(taskContext->userContext, &itemsStream));
+
+    FFS_CHECK_RESULT(ffsSetWifiProvisioneeState(taskContext->userContext, taskContext->resumeState));
+    taskContext->isResuming = true;
+    taskContext->isStarted = true;
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Load the last checkpoint and restore its DSS session, if it is still resumable.
+ */
+static FFS_RESULT ffsWifiProvisioneeTaskLoadCheckpoint(FfsTaskContext_t *taskContext, bool *isResumable) {
+
+    FFS_TEMPORARY_OUTPUT_STREAM(checkpointStream, FFS_WIFI_PROVISIONEE_CHECKPOINT_MAXIMUM_SIZE);
+    FfsWifiProvisioneeCheckpoint_t checkpoint;
+
+    *isResumable = false;
+
+    // Load the last checkpoint.
+    FFS_RESULT result = ffsLoadWifiProvisioneeCheckpoint(taskContext->userContext, &checkpointStream);
+    if (result == FFS_NOT_IMPLEMENTED) {
+        ffsLogDebug("Provisioning checkpoints not supported by client");
+        taskContext->checkpointEnabled = false;
+        return FFS_SUCCESS;
+    }
+    if (result != FFS_SUCCESS) {
+        ffsLogWarning("Unable to load the provisioning checkpoint");
+        ffsWifiProvisioneeTaskClearCheckpoint(taskContext);
+        return FFS_SUCCESS;
+    }
+    if (ffsStreamIsEmpty(&checkpointStream)) {
+        return FFS_SUCCESS;
+    }
+
+    // Check that the session can be resumed.
+    if (ffsDecodeWifiProvisioneeCheckpoint(&checkpointStream, &checkpoint) != FFS_SUCCESS
+            || !ffsGetWifiProvisioneeCheckpointResumeState(checkpoint.state, &taskContext->resumeState)
+            || ffsStreamIsEmpty(&checkpoint.sessionIdStream)) {
+        ffsLogWarning("Discarding invalid provisioning checkpoint");
+        ffsWifiProvisioneeTaskClearCheckpoint(taskContext);
+        return FFS_SUCCESS;
+    }
+    if (checkpoint.resumeCount >= FFS_WIFI_PROVISIONEE_CHECKPOINT_MAXIMUM_RESUMES) {
+        ffsLogWarning("Provisioning session resumed %d times, starting a new session", checkpoint.resumeCount);
+        ffsWifiProvisioneeTaskClearCheckpoint(taskContext);
+        return FFS_SUCCESS;
+    }
+
     const char *stateString;
-    FFS_CHECK_RESULT(ffsGetWifiProvisioneeStateString(state, &stateString));
-    ffsLogDebug("Execute Wi-Fi provisionee state %s", stateString);
+    FFS_CHECK_RESULT(ffsGetWifiProvisioneeStateString(taskContext->resumeState, &stateString));
+    ffsLogInfo("Resume provisioning session in state %s", stateString);
+
+    // Restore the DSS session. Skip the sequence numbers of requests that may have been sent after the checkpoint.
+    char sessionId[FFS_MAXIMUM_SESSION_ID_LENGTH];
+    memcpy(sessionId, FFS_STREAM_NEXT_READ(checkpoint.sessionIdStream), FFS_STREAM_DATA_SIZE(checkpoint.sessionIdStream));
+    sessionId[FFS_STREAM_DATA_SIZE(checkpoint.sessionIdStream)] = '\0';
+    FFS_CHECK_RESULT(ffsDssClientSetSessionId(&taskContext->dssClientContext, sessionId));
+    taskContext->dssClientContext.sequenceNumber = checkpoint.sequenceNumber
+            + FFS_WIFI_PROVISIONEE_CHECKPOINT_SEQUENCE_GAP;
+
+    FFS_CHECK_RESULT(ffsFlushStream(&taskContext->saltStream));
+    FFS_CHECK_RESULT(ffsAppendStream(&checkpoint.saltStream, &taskContext->saltStream));
+
+    // Keep the received items for the replay and the next checkpoints.
+    FFS_CHECK_RESULT(ffsFlushStream(&taskContext->checkpointItemsStream));
+    FFS_CHECK_RESULT(ffsAppendStream(&checkpoint.itemsStream, &taskContext->checkpointItemsStream));
+
+    taskContext->resumeCount = checkpoint.resumeCount + 1;
+    *isResumable = true;
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Drop a resumed session and start a new one.
+ */
+static FFS_RESULT ffsWifiProvisioneeTaskRestart(FfsTaskContext_t *taskContext) {
+
+    ffsWifiProvisioneeTaskClearCheckpoint(taskContext);
+
+    FFS_CHECK_RESULT(ffsDssClientInit(taskContext->userContext, &taskContext->dssClientContext));
+    FFS_CHECK_RESULT(ffsFlushStream(&taskContext->saltStream));
+    FFS_CHECK_RESULT(ffsFlushStream(&taskContext->checkpointItemsStream));
+    taskContext->resumeCount = 0;
+    taskContext->cloudCanProceed = true;
+
+    FFS_CHECK_RESULT(ffsSetWifiProvisioneeState(taskContext->userContext,
+            FFS_WIFI_PROVISIONEE_STATE_NOT_PROVISIONED));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Save a checkpoint of the state about to be executed, if it can be resumed.
+ *
+ * The checkpoint of a resumed session carries the incremented resume count,
+ * so a device that keeps resetting in the same state eventually starts over.
+ */
+static FFS_RESULT ffsWifiProvisioneeTaskSaveCheckpoint(FfsTaskContext_t *taskContext,
+        FFS_WIFI_PROVISIONEE_STATE state) {
+
+    FFS_WIFI_PROVISIONEE_STATE resumeState;
+    const char *sessionId;
+
+    if (!taskContext->checkpointEnabled) {
+        return FFS_SUCCESS;
+    }
+
+    FFS_CHECK_RESULT(ffsDssClientGetSessionId(&taskContext->dssClientContext, &sessionId));
+    if (!sessionId || !ffsGetWifiProvisioneeCheckpointResumeState(state, &resumeState)) {
+        return FFS_SUCCESS;
+    }
+
+    FfsWifiProvisioneeCheckpoint_t checkpoint = {
+        .state = state,
+        .resumeCount = taskContext->resumeCount,
+        .connectedToSocksNetwork = taskContext->dssClientContext.connectedToSocksNetwork,
+        .sequenceNumber = taskContext->dssClientContext.sequenceNumber,
+        .sessionIdStream = ffsCreateInputStream((uint8_t *) sessionId, strlen(sessionId)),
+        .saltStream = taskContext->saltStream,
+        .itemsStream = taskContext->checkpointItemsStream
+    };
+
+    FFS_TEMPORARY_OUTPUT_STREAM(checkpointStream, FFS_WIFI_PROVISIONEE_CHECKPOINT_MAXIMUM_SIZE);
+    FFS_CHECK_RESULT(ffsEncodeWifiProvisioneeCheckpoint(&checkpoint, &checkpointStream));
+
+    // A storage failure costs the ability to resume, not the session.
+    FFS_RESULT result = ffsSaveWifiProvisioneeCheckpoint(taskContext->userContext, &checkpointStream);
+    if (result == FFS_NOT_IMPLEMENTED) {
+        taskContext->checkpointEnabled = false;
+    } else if (result != FFS_SUCCESS) {
+        ffsLogWarning("Unable to save the provisioning checkpoint");
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Remove the stored checkpoint.
+ */
+static void ffsWifiProvisioneeTaskClearCheckpoint(FfsTaskContext_t *taskContext) {
+
+    if (taskContext->checkpointEnabled
+            && ffsClearWifiProvisioneeCheckpoint(taskContext->userContext) != FFS_SUCCESS) {
+        ffsLogWarning("Unable to clear the provisioning checkpoint");
+    }
+}
+
+/*
+ * Handle the result of logging a received item.
+ *
+ * A checkpoint missing an item cannot be resumed, so checkpoints stop for
+ * the rest of the session if the item log is full.
+ */
+static void ffsWifiProvisioneeTaskCheckpointItemLogged(FFS_RESULT result) {
+
+    if (result != FFS_SUCCESS) {
+        ffsLogWarning("Unable to log a received item, provisioning checkpoints disabled");
+        ffsWifiProvisioneeTaskClearCheckpoint(sCheckpointTaskContext);
+        sCheckpointTaskContext->checkpointEnabled = false;
+    }
+}
+
+/*
+ * Start connecting to the encoded setup network, or to the fallback setup network.
+ */
+static FFS_RESULT ffsWifiProvisioneeTaskStartSetupNetwork(FfsTaskContext_t *taskContext, uint32_t nowMs) {
+
+    if (ffsStartConnectingToSetupNetwork(taskContext->userContext, &taskContext->setupWifiConfiguration)
+            != FFS_SUCCESS) {
+        FFS_CHECK_RESULT(ffsWifiProvisioneeTaskStartFallbackSetupNetwork(taskContext, nowMs));
+        return FFS_SUCCESS;
+    }
+
+    taskContext->stage = FFS_WIFI_PROVISIONEE_TASK_STAGE_OPERATION;
+    ffsWifiProvisioneeTaskAwait(taskContext, FFS_WIFI_PROVISIONEE_EVENT_WIFI, nowMs,
+            FFS_WIFI_PROVISIONEE_CONNECTION_TIMEOUT_MS);
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Start connecting to the fallback (open) setup network.
+ */
+static FFS_RESULT ffsWifiProvisioneeTaskStartFallbackSetupNetwork(FfsTaskContext_t *taskContext, uint32_t nowMs) {
+
+    FFS_CHECK_RESULT(ffsFlushStream(&taskContext->setupWifiConfiguration.ssidStream));
+    FFS_CHECK_RESULT(ffsFlushStream(&taskContext->setupWifiConfiguration.keyStream));
+
+    FFS_CHECK_RESULT(ffsGetFallbackSetupNetwork(taskContext->userContext, &taskContext->setupWifiConfiguration));
+    FFS_CHECK_RESULT(ffsStartConnectingToSetupNetwork(taskContext->userContext, &taskContext->setupWifiConfiguration));
+
+    taskContext->stage = FFS_WIFI_PROVISIONEE_TASK_STAGE_FALLBACK;
+    ffsWifiProvisioneeTaskAwait(taskContext, FFS_WIFI_PROVISIONEE_EVENT_WIFI, nowMs,
+            FFS_WIFI_PROVISIONEE_CONNECTION_TIMEOUT_MS);
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Handle the end of a setup network connection attempt.
+ *
+ * A failed encoded setup network falls back to the open one. Once connected,
+ * the DSS client tracks if it is the SOCKS network.
+ */
+static FFS_RESULT ffsWifiProvisioneeTaskSetupNetworkConnected(FfsTaskContext_t *taskContext, uint32_t nowMs,
+        bool *isConnected) {
+
+    *isConnected = false;
+
+    if (taskContext->pendingResult != FFS_SUCCESS) {
+        ffsLogError("Failed to connect to setup network");
+        if (taskContext->stage == FFS_WIFI_PROVISIONEE_TASK_STAGE_FALLBACK) {
+            FFS_FAIL(taskContext->pendingResult);
+        }
+
+        FFS_CHECK_RESULT(ffsWifiProvisioneeTaskStartFallbackSetupNetwork(taskContext, nowMs));
+        return FFS_SUCCESS;
+    }
+
+    ffsLogDebug("Connected to setup network");
+    taskContext->dssClientContext.connectedToSocksNetwork =
+            (taskContext->stage == FFS_WIFI_PROVISIONEE_TASK_STAGE_OPERATION);
+    *isConnected = true;
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Start the success/failure report of a state.
+ */
+static FFS_RESULT ffsWifiProvisioneeTaskStartReport(FfsTaskContext_t *taskContext,
+        FFS_DSS_WIFI_PROVISIONEE_STATE dssProvisioneeState, FFS_RESULT result, bool reportConnectionAttempts,
+        uint32_t nowMs) {
+
+    // Get the DSS registration state.
+    FFS_DSS_REGISTRATION_STATE dssRegistrationState;
+    FFS_CHECK_RESULT(ffsGetDssRegistrationState(taskContext, &dssRegistrationState));
+
+    FFS_CHECK_RESULT(ffsDssReportAsync(&taskContext->dssClientContext,
+            dssProvisioneeState,
+            (result == FFS_SUCCESS ? FFS_DSS_REPORT_RESULT_SUCCESS
+                    : FFS_DSS_REPORT_RESULT_FAILURE),
+            dssRegistrationState, &taskContext->cloudCanProceed, &taskContext->nextDssProvisioneeState,
+            reportConnectionAttempts ? ffsWifiGetDssConnectionAttemptsCallback : NULL,
+            reportConnectionAttempts ? &taskContext->wifiConnectionAttempt : NULL,
+            &taskContext->operationData.report));
+
+    taskContext->stage = FFS_WIFI_PROVISIONEE_TASK_STAGE_REPORT;
+    ffsWifiProvisioneeTaskAwait(taskContext, FFS_WIFI_PROVISIONEE_EVENT_HTTP, nowMs,
+            FFS_WIFI_PROVISIONEE_DSS_CALL_TIMEOUT_MS);
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Complete a state with the next state returned by its report.
+ */
+static FFS_RESULT ffsWifiProvisioneeTaskFinishReport(FfsTaskContext_t *taskContext) {
+
+    FFS_CHECK_RESULT(taskContext->pendingResult);
+
+    FFS_CHECK_CAN_PROCEED(taskContext->cloudCanProceed);
+
+    // Set the provisionee state.
+    FFS_WIFI_PROVISIONEE_STATE nextProvisioneeState;
+    FFS_CHECK_RESULT(ffsConvertDssWifiProvisioneeStateToApi(taskContext->nextDssProvisioneeState,
+            &nextProvisioneeState));
+    FFS_CHECK_RESULT(ffsSetWifiProvisioneeState(taskContext->userContext, nextProvisioneeState));
+
+    return FFS_SUCCESS;
+}
 
-    switch (state) {
+/*
+ * Execute a Ffs provisionee state, up to its next operation.
+ */
+static FFS_RESULT ffsWifiProvisioneeTaskExecuteState(FfsTaskContext_t *taskContext, uint32_t nowMs) {
+
+    switch (taskContext->state) {
         case FFS_WIFI_PROVISIONEE_STATE_NOT_PROVISIONED:
             FFS_CHECK_RESULT(ffsWifiProvisioneeTaskExecuteStateNotProvisioned(taskContext));
             break;
         case FFS_WIFI_PROVISIONEE_STATE_CONNECTING_TO_SETUP_NETWORK:
-            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskExecuteStateConnectingToSetupNetwork(taskContext));
+            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskExecuteStateConnectingToSetupNetwork(taskContext, nowMs));
             break;
         case FFS_WIFI_PROVISIONEE_STATE_START_PROVISIONING:
-            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskExecuteStateStartProvisioning(taskContext));
+            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskExecuteStateStartProvisioning(taskContext, nowMs));
             break;
         case FFS_WIFI_PROVISIONEE_STATE_START_PIN_BASED_SETUP:
-            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskExecuteStateStartPinBasedSetup(taskContext));
+            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskExecuteStateStartPinBasedSetup(taskContext, nowMs));
             break;
         case FFS_WIFI_PROVISIONEE_STATE_COMPUTE_CONFIGURATION:
-            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskExecuteStateComputeConfiguration(taskContext));
+            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskExecuteStateComputeConfiguration(taskContext, nowMs));
             break;
         case FFS_WIFI_PROVISIONEE_STATE_POST_WIFI_SCAN_DATA:
-            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskExecuteStatePostWifiScanData(taskContext));
+            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskExecuteStatePostWifiScanData(taskContext, nowMs));
             break;
         case FFS_WIFI_PROVISIONEE_STATE_GET_WIFI_LIST:
-            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskExecuteStateGetWifiList(taskContext));
+            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskExecuteStateGetWifiList(taskContext, nowMs));
             break;
         case FFS_WIFI_PROVISIONEE_STATE_CONNECTING_TO_USER_NETWORK:
-            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskExecuteStateConnectingToUserNetwork(taskContext));
+            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskExecuteStateConnectingToUserNetwork(taskContext, nowMs));
             break;
         case FFS_WIFI_PROVISIONEE_STATE_CONNECTED_TO_USER_NETWORK:
-            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskExecuteStateConnectedToUserNetwork(taskContext));
+            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskExecuteStateConnectedToUserNetwork(taskContext, nowMs));
             break;
         default:
             FFS_FAIL(FFS_ERROR);
@@ -211,28 +858,23 @@ static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateNotProvisioned(FfsTaskContex
 /*
  * Execute an FFS "connecting to setup network" state.
  */
-static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateConnectingToSetupNetwork(FfsTaskContext_t *taskContext) {
-
-    bool connectedToSocksNetwork = true;
+static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateConnectingToSetupNetwork(FfsTaskContext_t *taskContext,
+        uint32_t nowMs) {
 
-    FFS_RESULT result = ffsConnectToSetupNetwork(taskContext->userContext, &taskContext->setupWifiConfiguration);
-
-    if (result != FFS_SUCCESS) {
-
-        // Fall back to open setup network.
-        FFS_CHECK_RESULT(ffsFlushStream(&taskContext->setupWifiConfiguration.ssidStream));
-        FFS_CHECK_RESULT(ffsFlushStream(&taskContext->setupWifiConfiguration.keyStream));
+    if (taskContext->stage == FFS_WIFI_PROVISIONEE_TASK_STAGE_START) {
+        FFS_CHECK_RESULT(ffsWifiProvisioneeTaskStartSetupNetwork(taskContext, nowMs));
+        return FFS_SUCCESS;
+    }
 
-        FFS_CHECK_RESULT(ffsGetFallbackSetupNetwork(taskContext->userContext, &taskContext->setupWifiConfiguration));
-        FFS_CHECK_RESULT(ffsConnectToSetupNetwork(taskContext->userContext, &taskContext->setupWifiConfiguration));
-        connectedToSocksNetwork = false;  
+    bool isConnected = false;
+    FFS_CHECK_RESULT(ffsWifiProvisioneeTaskSetupNetworkConnected(taskContext, nowMs, &isConnected));
+    if (!isConnected) {
+        return FFS_SUCCESS;
     }
 
     FFS_CHECK_RESULT(ffsSetWifiProvisioneeState(taskContext->userContext,
             FFS_WIFI_PROVISIONEE_STATE_START_PROVISIONING));
 
-    // Have the DSS client track if we are connected to the SOCKS network.
-    taskContext->dssClientContext->connectedToSocksNetwork = connectedToSocksNetwork;
     taskContext->cloudCanProceed = true;
     return FFS_SUCCESS;
 }
@@ -240,36 +882,43 @@ static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateConnectingToSetupNetwork(Ffs
 /*
  * Execute an FFS "start provisioning session" state.
  */
-static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateStartProvisioning(FfsTaskContext_t *taskContext) {
+static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateStartProvisioning(FfsTaskContext_t *taskContext, uint32_t nowMs) {
 
-    // Try to start the session.
-    FFS_RESULT result = ffsDssStartProvisioningSession(taskContext->dssClientContext, &taskContext->cloudCanProceed,
-            &taskContext->saltStream);
+    FFS_RESULT result;
 
-    if (result == FFS_SUCCESS) {
-        FFS_CHECK_CAN_PROCEED(taskContext->cloudCanProceed);
-    }
+    switch (taskContext->stage) {
+        case FFS_WIFI_PROVISIONEE_TASK_STAGE_START:
+
+            // Try to start the session.
+            result = ffsDssStartProvisioningSessionAsync(&taskContext->dssClientContext,
+                    &taskContext->cloudCanProceed, &taskContext->saltStream,
+                    &taskContext->operationData.startProvisioningSession);
+            if (result == FFS_SUCCESS) {
+                taskContext->stage = FFS_WIFI_PROVISIONEE_TASK_STAGE_OPERATION;
+                ffsWifiProvisioneeTaskAwait(taskContext, FFS_WIFI_PROVISIONEE_EVENT_HTTP, nowMs,
+                        FFS_WIFI_PROVISIONEE_DSS_CALL_TIMEOUT_MS);
+                return FFS_SUCCESS;
+            }
+            break;
 
-    // Get the DSS registration state.
-    FFS_DSS_REGISTRATION_STATE dssRegistrationState;
-    FFS_CHECK_RESULT(ffsGetDssRegistrationState(taskContext, &dssRegistrationState));
+        case FFS_WIFI_PROVISIONEE_TASK_STAGE_OPERATION:
+            result = taskContext->pendingResult;
+            if (result == FFS_SUCCESS) {
+                FFS_CHECK_CAN_PROCEED(taskContext->cloudCanProceed);
+            }
+            break;
 
-    // Send the "start provisioning" success/failure report.
-    FFS_DSS_WIFI_PROVISIONEE_STATE nextDssProvisioneeState;
-    FFS_CHECK_RESULT(ffsDssReport(taskContext->dssClientContext,
-            FFS_DSS_WIFI_PROVISIONEE_STATE_START_PROVISIONING,
-            (result == FFS_SUCCESS ? FFS_DSS_REPORT_RESULT_SUCCESS :
-                    FFS_DSS_REPORT_RESULT_FAILURE),
-            dssRegistrationState, &taskContext->cloudCanProceed, &nextDssProvisioneeState,
-            ffsWifiGetDssConnectionAttemptsCallback, &taskContext->wifiConnectionAttempt));
+        case FFS_WIFI_PROVISIONEE_TASK_STAGE_REPORT:
+            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskFinishReport(taskContext));
+            return FFS_SUCCESS;
 
-    FFS_CHECK_CAN_PROCEED(taskContext->cloudCanProceed);
+        default:
+            FFS_FAIL(FFS_ERROR);
+    }
 
-    // Set the provisionee state.
-    FFS_WIFI_PROVISIONEE_STATE nextProvisioneeState;
-    FFS_CHECK_RESULT(ffsConvertDssWifiProvisioneeStateToApi(nextDssProvisioneeState,
-            &nextProvisioneeState));
-    FFS_CHECK_RESULT(ffsSetWifiProvisioneeState(taskContext->userContext, nextProvisioneeState));
+    // Send the "start provisioning" success/failure report.
+    FFS_CHECK_RESULT(ffsWifiProvisioneeTaskStartReport(taskContext,
+            FFS_DSS_WIFI_PROVISIONEE_STATE_START_PROVISIONING, result, true, nowMs));
 
     return FFS_SUCCESS;
 }
@@ -277,35 +926,42 @@ static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateStartProvisioning(FfsTaskCon
 /*
  * Execute a Ffs 'start PIN-based setup' state.
  */
-static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateStartPinBasedSetup(FfsTaskContext_t *taskContext) {
+static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateStartPinBasedSetup(FfsTaskContext_t *taskContext, uint32_t nowMs) {
 
-    // Try to start PIN-based setup.
-    FFS_RESULT result = ffsDssStartPinBasedSetup(taskContext->dssClientContext, &taskContext->cloudCanProceed,
-            taskContext->saltStream);
+    FFS_RESULT result;
 
-    if (result == FFS_SUCCESS) {
-        FFS_CHECK_CAN_PROCEED(taskContext->cloudCanProceed);
-    }
+    switch (taskContext->stage) {
+        case FFS_WIFI_PROVISIONEE_TASK_STAGE_START:
+
+            // Try to start PIN-based setup.
+            result = ffsDssStartPinBasedSetupAsync(&taskContext->dssClientContext, &taskContext->cloudCanProceed,
+                    taskContext->saltStream);
+            if (result == FFS_SUCCESS) {
+                taskContext->stage = FFS_WIFI_PROVISIONEE_TASK_STAGE_OPERATION;
+                ffsWifiProvisioneeTaskAwait(taskContext, FFS_WIFI_PROVISIONEE_EVENT_HTTP, nowMs,
+                        FFS_WIFI_PROVISIONEE_DSS_CALL_TIMEOUT_MS);
+                return FFS_SUCCESS;
+            }
+            break;
 
-    // Get the DSS registration state.
-    FFS_DSS_REGISTRATION_STATE dssRegistrationState;
-    FFS_CHECK_RESULT(ffsGetDssRegistrationState(taskContext, &dssRegistrationState));
+        case FFS_WIFI_PROVISIONEE_TASK_STAGE_OPERATION:
+            result = taskContext->pendingResult;
+            if (result == FFS_SUCCESS) {
+                FFS_CHECK_CAN_PROCEED(taskContext->cloudCanProceed);
+            }
+            break;
 
-    // Send the "start PIN-based setup" success/failure report.
-    FFS_DSS_WIFI_PROVISIONEE_STATE nextDssProvisioneeState;
-    FFS_CHECK_RESULT(ffsDssReport(taskContext->dssClientContext,
-            FFS_DSS_WIFI_PROVISIONEE_STATE_START_PIN_BASED_SETUP,
-            (result == FFS_SUCCESS ? FFS_DSS_REPORT_RESULT_SUCCESS
-                    : FFS_DSS_REPORT_RESULT_FAILURE),
-            dssRegistrationState, &taskContext->cloudCanProceed, &nextDssProvisioneeState, NULL, NULL));
+        case FFS_WIFI_PROVISIONEE_TASK_STAGE_REPORT:
+            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskFinishReport(taskContext));
+            return FFS_SUCCESS;
 
-    FFS_CHECK_CAN_PROCEED(taskContext->cloudCanProceed);
+        default:
+            FFS_FAIL(FFS_ERROR);
+    }
 
-    // Set the provisionee state.
-    FFS_WIFI_PROVISIONEE_STATE nextProvisioneeState;
-    FFS_CHECK_RESULT(ffsConvertDssWifiProvisioneeStateToApi(nextDssProvisioneeState,
-            &nextProvisioneeState));
-    FFS_CHECK_RESULT(ffsSetWifiProvisioneeState(taskContext->userContext, nextProvisioneeState));
+    // Send the "start PIN-based setup" success/failure report.
+    FFS_CHECK_RESULT(ffsWifiProvisioneeTaskStartReport(taskContext,
+            FFS_DSS_WIFI_PROVISIONEE_STATE_START_PIN_BASED_SETUP, result, false, nowMs));
 
     return FFS_SUCCESS;
 }
@@ -313,32 +969,42 @@ static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateStartPinBasedSetup(FfsTaskCo
 /*
  * Execute an FFS "compute configuration" state.
  */
-static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateComputeConfiguration(FfsTaskContext_t *taskContext) {
+static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateComputeConfiguration(FfsTaskContext_t *taskContext,
+        uint32_t nowMs) {
 
-    // Make the call.
-    FFS_RESULT result = ffsDssComputeConfigurationData(taskContext->dssClientContext,
-            FfsWifiSaveDssRegistrationDetailsCallback,
-            ffsWifiSaveConfigurationCallback);
+    FFS_RESULT result;
 
-    // Get the DSS registration state.
-    FFS_DSS_REGISTRATION_STATE dssRegistrationState;
-    FFS_CHECK_RESULT(ffsGetDssRegistrationState(taskContext, &dssRegistrationState))
+    switch (taskContext->stage) {
+        case FFS_WIFI_PROVISIONEE_TASK_STAGE_START:
+
+            // Make the call.
+            result = ffsDssComputeConfigurationDataAsync(&taskContext->dssClientContext,
+                    FfsWifiSaveDssRegistrationDetailsCallback,
+                    ffsWifiSaveConfigurationCallback,
+                    &taskContext->operationData.computeConfigurationData);
+            if (result == FFS_SUCCESS) {
+                taskContext->stage = FFS_WIFI_PROVISIONEE_TASK_STAGE_OPERATION;
+                ffsWifiProvisioneeTaskAwait(taskContext, FFS_WIFI_PROVISIONEE_EVENT_HTTP, nowMs,
+                        FFS_WIFI_PROVISIONEE_DSS_CALL_TIMEOUT_MS);
+                return FFS_SUCCESS;
+            }
+            break;
 
-    // Send the "compute configuration" success/failure report.
-    FFS_DSS_WIFI_PROVISIONEE_STATE nextDssProvisioneeState;
-    FFS_CHECK_RESULT(ffsDssReport(taskContext->dssClientContext,
-            FFS_DSS_WIFI_PROVISIONEE_STATE_COMPUTE_CONFIGURATION,
-            (result == FFS_SUCCESS ? FFS_DSS_REPORT_RESULT_SUCCESS
-                    : FFS_DSS_REPORT_RESULT_FAILURE),
-            dssRegistrationState, &taskContext->cloudCanProceed, &nextDssProvisioneeState, NULL, NULL));
+        case FFS_WIFI_PROVISIONEE_TASK_STAGE_OPERATION:
+            result = taskContext->pendingResult;
+            break;
 
-    FFS_CHECK_CAN_PROCEED(taskContext->cloudCanProceed);
+        case FFS_WIFI_PROVISIONEE_TASK_STAGE_REPORT:
+            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskFinishReport(taskContext));
+            return FFS_SUCCESS;
 
-    // Set the provisionee state.
-    FFS_WIFI_PROVISIONEE_STATE nextProvisioneeState;
-    FFS_CHECK_RESULT(ffsConvertDssWifiProvisioneeStateToApi(nextDssProvisioneeState,
-            &nextProvisioneeState));
-    FFS_CHECK_RESULT(ffsSetWifiProvisioneeState(taskContext->userContext, nextProvisioneeState));
+        default:
+            FFS_FAIL(FFS_ERROR);
+    }
+
+    // Send the "compute configuration" success/failure report.
+    FFS_CHECK_RESULT(ffsWifiProvisioneeTaskStartReport(taskContext,
+            FFS_DSS_WIFI_PROVISIONEE_STATE_COMPUTE_CONFIGURATION, result, false, nowMs));
 
     return FFS_SUCCESS;
 }
@@ -346,132 +1012,174 @@ static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateComputeConfiguration(FfsTask
 /*
  * Execute an FFS "post Wi-Fi scan data" state.
  */
-static FFS_RESULT ffsWifiProvisioneeTaskExecuteStatePostWifiScanData(FfsTaskContext_t *taskContext) {
+static FFS_RESULT ffsWifiProvisioneeTaskExecuteStatePostWifiScanData(FfsTaskContext_t *taskContext, uint32_t nowMs) {
+
+    switch (taskContext->stage) {
+        case FFS_WIFI_PROVISIONEE_TASK_STAGE_START:
+            taskContext->pageSequenceNumber = 0;
+            taskContext->totalCredentialsFound = 0;
+            taskContext->allCredentialsFound = false;
+            taskContext->postedWifiScanData = false;
+
+            // Collect and rank the whole scan set before the first page.
+            FFS_CHECK_RESULT(ffsInitializeWifiProvisioneeScanList(&taskContext->wifiScanList,
+                    taskContext->wifiScanList.entries, taskContext->wifiScanList.capacity));
+            FFS_CHECK_RESULT(ffsWifiPopulateScanList(taskContext->userContext, &taskContext->wifiScanList));
+            break;
 
-    bool canPostWifiScanData = false;
-    uint32_t totalCredentialsFound = 0;
-    bool allCredentialsFound = false;
-    bool postedWifiScanData = false;
-    FFS_RESULT result;
+        case FFS_WIFI_PROVISIONEE_TASK_STAGE_OPERATION:
+            if (taskContext->pendingResult != FFS_SUCCESS) {
+                FFS_CHECK_RESULT(ffsWifiProvisioneeTaskStartReport(taskContext,
+                        FFS_DSS_WIFI_PROVISIONEE_STATE_POST_WIFI_SCAN_DATA, taskContext->pendingResult, false,
+                        nowMs));
+                return FFS_SUCCESS;
+            }
+
+            FFS_CHECK_CAN_PROCEED(taskContext->cloudCanProceed);
 
-    // Post Wi-Fi scan data until the client tells us to stop, or the cloud tells us we've found all credentials.
-    for (uint32_t sequenceNumber = 1;; ++sequenceNumber) {
-        FFS_CHECK_RESULT(ffsWifiProvisioneeCanPostWifiScanData(taskContext->userContext, sequenceNumber,
-                totalCredentialsFound, allCredentialsFound, &canPostWifiScanData));
+            ffsLogDebug("Total credentials found: %d", taskContext->totalCredentialsFound);
 
-        if (!canPostWifiScanData) {
-            ffsLogDebug("Stop posting Wi-Fi scan data");
+            if (taskContext->allCredentialsFound) {
+                ffsLogDebug("All credentials found in cloud");
+            }
             break;
-        }
-        postedWifiScanData = true;
+
+        case FFS_WIFI_PROVISIONEE_TASK_STAGE_REPORT:
+            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskFinishReport(taskContext));
+            return FFS_SUCCESS;
+
+        default:
+            FFS_FAIL(FFS_ERROR);
+    }
+
+    FFS_CHECK_RESULT(ffsWifiProvisioneeTaskPostNextWifiScanData(taskContext, nowMs));
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Post the next page of Wi-Fi scan data, or report once the client tells us
+ * to stop or the cloud tells us we've found all credentials.
+ */
+static FFS_RESULT ffsWifiProvisioneeTaskPostNextWifiScanData(FfsTaskContext_t *taskContext, uint32_t nowMs) {
+
+    bool canPostWifiScanData = false;
+    FFS_RESULT result = FFS_SUCCESS;
+    uint32_t sequenceNumber = ++taskContext->pageSequenceNumber;
+
+    FFS_CHECK_RESULT(ffsWifiProvisioneeCanPostWifiScanData(taskContext->userContext, sequenceNumber,
+            taskContext->totalCredentialsFound, taskContext->allCredentialsFound, &canPostWifiScanData));
+
+    if (canPostWifiScanData) {
+        taskContext->postedWifiScanData = true;
 
         // Make the call.
-        result = ffsDssPostWifiScanData(
-                taskContext->dssClientContext,
+        result = ffsDssPostWifiScanDataAsync(
+                &taskContext->dssClientContext,
                 &taskContext->cloudCanProceed,
                 sequenceNumber,
                 ffsWifiGetDssScanResultsCallback,
-                &taskContext->wifiScanResult,
-                &totalCredentialsFound,
-                &allCredentialsFound);
+                &taskContext->wifiScanList,
+                &taskContext->totalCredentialsFound,
+                &taskContext->allCredentialsFound,
+                &taskContext->operationData.postWifiScanData);
 
         if (result == FFS_SUCCESS) {
-            FFS_CHECK_CAN_PROCEED(taskContext->cloudCanProceed);
-        } else {
-            break;
-        }
-
-        ffsLogDebug("Total credentials found: %d", totalCredentialsFound);
-
-        if (allCredentialsFound) {
-            ffsLogDebug("All credentials found in cloud");
+            taskContext->stage = FFS_WIFI_PROVISIONEE_TASK_STAGE_OPERATION;
+            ffsWifiProvisioneeTaskAwait(taskContext, FFS_WIFI_PROVISIONEE_EVENT_HTTP, nowMs,
+                    FFS_WIFI_PROVISIONEE_DSS_CALL_TIMEOUT_MS);
+            return FFS_SUCCESS;
         }
+    } else {
+        ffsLogDebug("Stop posting Wi-Fi scan data");
     }
 
-    if (!postedWifiScanData) {
+    if (!taskContext->postedWifiScanData) {
         ffsLogError("No scan data posted");
         result = FFS_ERROR;
     }
 
-    // Get the DSS registration state.
-    FFS_DSS_REGISTRATION_STATE dssRegistrationState;
-    FFS_CHECK_RESULT(ffsGetDssRegistrationState(taskContext, &dssRegistrationState))
-
     // Send the "post Wi-Fi scan data" success/failure report.
-    FFS_DSS_WIFI_PROVISIONEE_STATE nextDssProvisioneeState;
-    FFS_CHECK_RESULT(ffsDssReport(taskContext->dssClientContext,
-            FFS_DSS_WIFI_PROVISIONEE_STATE_POST_WIFI_SCAN_DATA,
-            (result == FFS_SUCCESS ? FFS_DSS_REPORT_RESULT_SUCCESS
-                    : FFS_DSS_REPORT_RESULT_FAILURE),
-            dssRegistrationState, &taskContext->cloudCanProceed, &nextDssProvisioneeState, NULL, NULL));
+    FFS_CHECK_RESULT(ffsWifiProvisioneeTaskStartReport(taskContext,
+            FFS_DSS_WIFI_PROVISIONEE_STATE_POST_WIFI_SCAN_DATA, result, false, nowMs));
 
-    FFS_CHECK_CAN_PROCEED(taskContext->cloudCanProceed);
+    return FFS_SUCCESS;
+}
 
-    // Set the provisionee state.
-    FFS_WIFI_PROVISIONEE_STATE nextProvisioneeState;
-    FFS_CHECK_RESULT(ffsConvertDssWifiProvisioneeStateToApi(nextDssProvisioneeState,
-            &nextProvisioneeState));
-    FFS_CHECK_RESULT(ffsSetWifiProvisioneeState(taskContext->userContext, nextProvisioneeState));
+/*
+ * Execute an FFS "get Wi-Fi credentials" state.
+ */
+static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateGetWifiList(FfsTaskContext_t *taskContext, uint32_t nowMs) {
+
+    switch (taskContext->stage) {
+        case FFS_WIFI_PROVISIONEE_TASK_STAGE_START:
+            taskContext->pageSequenceNumber = 0;
+            taskContext->allCredentialsReturned = false;
+            break;
+
+        case FFS_WIFI_PROVISIONEE_TASK_STAGE_OPERATION:
+            if (taskContext->pendingResult != FFS_SUCCESS) {
+                FFS_CHECK_RESULT(ffsWifiProvisioneeTaskStartReport(taskContext,
+                        FFS_DSS_WIFI_PROVISIONEE_STATE_GET_WIFI_LIST, taskContext->pendingResult, false, nowMs));
+                return FFS_SUCCESS;
+            }
+
+            FFS_CHECK_CAN_PROCEED(taskContext->cloudCanProceed);
+
+            if (taskContext->allCredentialsReturned) {
+                ffsLogDebug("All credentials returned by cloud");
+            }
+            break;
+
+        case FFS_WIFI_PROVISIONEE_TASK_STAGE_REPORT:
+            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskFinishReport(taskContext));
+            return FFS_SUCCESS;
+
+        default:
+            FFS_FAIL(FFS_ERROR);
+    }
+
+    FFS_CHECK_RESULT(ffsWifiProvisioneeTaskGetNextWifiCredentials(taskContext, nowMs));
 
     return FFS_SUCCESS;
 }
 
 /*
- * Execute an FFS "get Wi-Fi credentials" state.
+ * Get the next page of Wi-Fi credentials, or report once the client tells us
+ * to stop.
  */
-static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateGetWifiList(FfsTaskContext_t *taskContext) {
+static FFS_RESULT ffsWifiProvisioneeTaskGetNextWifiCredentials(FfsTaskContext_t *taskContext, uint32_t nowMs) {
 
     bool canGetWifiCredentials = false;
-    bool allCredentialsReturned = false;
-    FFS_RESULT result;
+    FFS_RESULT result = FFS_SUCCESS;
+    uint32_t sequenceNumber = ++taskContext->pageSequenceNumber;
 
-    // Get credentials until the cloud tells us to stop.
-    for (uint32_t sequenceNumber = 1;; ++sequenceNumber) {
-        FFS_CHECK_RESULT(ffsWifiProvisioneeCanGetWifiCredentials(taskContext->userContext, sequenceNumber,
-                allCredentialsReturned, &canGetWifiCredentials));
+    FFS_CHECK_RESULT(ffsWifiProvisioneeCanGetWifiCredentials(taskContext->userContext, sequenceNumber,
+            taskContext->allCredentialsReturned, &canGetWifiCredentials));
 
-        if (!canGetWifiCredentials) {
-            ffsLogDebug("Stop getting Wi-Fi credentials");
-            break;
-        }
+    if (canGetWifiCredentials) {
 
         // Make the call.
-        result = ffsDssGetWifiCredentials(taskContext->dssClientContext,
+        result = ffsDssGetWifiCredentialsAsync(&taskContext->dssClientContext,
                 &taskContext->cloudCanProceed,
                 sequenceNumber,
                 ffsWifiSaveDssCredentialsCallback,
-                &allCredentialsReturned);
+                &taskContext->allCredentialsReturned,
+                &taskContext->operationData.getWifiCredentials);
 
         if (result == FFS_SUCCESS) {
-            FFS_CHECK_CAN_PROCEED(taskContext->cloudCanProceed);
-        } else {
-            break;
-        }
-
-        if (allCredentialsReturned) {
-            ffsLogDebug("All credentials returned by cloud");
+            taskContext->stage = FFS_WIFI_PROVISIONEE_TASK_STAGE_OPERATION;
+            ffsWifiProvisioneeTaskAwait(taskContext, FFS_WIFI_PROVISIONEE_EVENT_HTTP, nowMs,
+                    FFS_WIFI_PROVISIONEE_DSS_CALL_TIMEOUT_MS);
+            return FFS_SUCCESS;
         }
+    } else {
+        ffsLogDebug("Stop getting Wi-Fi credentials");
     }
 
-    // Get the DSS registration state.
-    FFS_DSS_REGISTRATION_STATE dssRegistrationState;
-    FFS_CHECK_RESULT(ffsGetDssRegistrationState(taskContext, &dssRegistrationState))
-
     // Send the "get Wi-Fi credentials" success/failure report.
-    FFS_DSS_WIFI_PROVISIONEE_STATE nextDssProvisioneeState;
-    FFS_CHECK_RESULT(ffsDssReport(taskContext->dssClientContext,
-            FFS_DSS_WIFI_PROVISIONEE_STATE_GET_WIFI_LIST,
-            (result == FFS_SUCCESS ? FFS_DSS_REPORT_RESULT_SUCCESS
-                    : FFS_DSS_REPORT_RESULT_FAILURE),
-            dssRegistrationState, &taskContext->cloudCanProceed, &nextDssProvisioneeState, NULL, NULL));
-
-    FFS_CHECK_CAN_PROCEED(taskContext->cloudCanProceed);
-
-    // Set the provisionee state.
-    FFS_WIFI_PROVISIONEE_STATE nextProvisioneeState;
-    FFS_CHECK_RESULT(ffsConvertDssWifiProvisioneeStateToApi(nextDssProvisioneeState,
-            &nextProvisioneeState));
-    FFS_CHECK_RESULT(ffsSetWifiProvisioneeState(taskContext->userContext, nextProvisioneeState));
+    FFS_CHECK_RESULT(ffsWifiProvisioneeTaskStartReport(taskContext,
+            FFS_DSS_WIFI_PROVISIONEE_STATE_GET_WIFI_LIST, result, false, nowMs));
 
     return FFS_SUCCESS;
 }
@@ -479,46 +1187,80 @@ static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateGetWifiList(FfsTaskContext_t
 /*
  * Execute an FFS "connecting to user network" state.
  */
-static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateConnectingToUserNetwork(FfsTaskContext_t *taskContext) {
+static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateConnectingToUserNetwork(FfsTaskContext_t *taskContext,
+        uint32_t nowMs) {
+
+    FFS_RESULT result;
 
-    // Disconnect from the setup network which was previously used.
-    FFS_CHECK_RESULT(ffsDisconnectFromSetupNetwork(taskContext->userContext, &taskContext->setupWifiConfiguration));
-    
-    // Reset the DSS port.
-    bool connectedToSocksNetwork = taskContext->dssClientContext->connectedToSocksNetwork;
-    taskContext->dssClientContext->connectedToSocksNetwork = false;
-    
-    // Make the call.
-    FFS_RESULT result = ffsConnectToUserNetworks(taskContext->userContext);
+    switch (taskContext->stage) {
+        case FFS_WIFI_PROVISIONEE_TASK_STAGE_START:
 
-    // Failed?
-    if (result != FFS_SUCCESS) {
-        // Reconnect to the setup network which was previously used.
-        ffsLogError("Failed to connect to a user network, reconnecting to setup network");
-        FFS_CHECK_RESULT(ffsConnectToSetupNetwork(taskContext->userContext, &taskContext->setupWifiConfiguration));
-        taskContext->dssClientContext->connectedToSocksNetwork = connectedToSocksNetwork;
-    }
+            // Disconnect from the setup network which was previously used.
+            FFS_CHECK_RESULT(ffsDisconnectFromSetupNetwork(taskContext->userContext,
+                    &taskContext->setupWifiConfiguration));
 
-    // Get the DSS registration state.
-    FFS_DSS_REGISTRATION_STATE dssRegistrationState;
-    FFS_CHECK_RESULT(ffsGetDssRegistrationState(taskContext, &dssRegistrationState))
+            // Reset the DSS port.
+            taskContext->setupNetworkIsSocks = taskContext->dssClientContext.connectedToSocksNetwork;
+            taskContext->dssClientContext.connectedToSocksNetwork = false;
+
+            // Make the call.
+            result = ffsStartConnectingToUserNetworks(taskContext->userContext);
+            if (result != FFS_SUCCESS) {
+                FFS_CHECK_RESULT(ffsWifiProvisioneeTaskReconnectToSetupNetwork(taskContext, nowMs));
+                return FFS_SUCCESS;
+            }
+
+            taskContext->stage = FFS_WIFI_PROVISIONEE_TASK_STAGE_OPERATION;
+            ffsWifiProvisioneeTaskAwait(taskContext, FFS_WIFI_PROVISIONEE_EVENT_WIFI, nowMs,
+                    FFS_WIFI_PROVISIONEE_CONNECTION_TIMEOUT_MS);
+            return FFS_SUCCESS;
+
+        case FFS_WIFI_PROVISIONEE_TASK_STAGE_OPERATION:
+            if (taskContext->pendingResult != FFS_SUCCESS) {
+                FFS_CHECK_RESULT(ffsWifiProvisioneeTaskReconnectToSetupNetwork(taskContext, nowMs));
+                return FFS_SUCCESS;
+            }
+
+            ffsLogDebug("Connected to user network");
+            result = FFS_SUCCESS;
+            break;
+
+        case FFS_WIFI_PROVISIONEE_TASK_STAGE_FALLBACK:
+            if (taskContext->pendingResult != FFS_SUCCESS) {
+                ffsLogError("Failed to reconnect to setup network");
+                FFS_FAIL(taskContext->pendingResult);
+            }
+
+            taskContext->dssClientContext.connectedToSocksNetwork = taskContext->setupNetworkIsSocks;
+            result = FFS_ERROR;
+            break;
+
+        case FFS_WIFI_PROVISIONEE_TASK_STAGE_REPORT:
+            FFS_CHECK_RESULT(ffsWifiProvisioneeTaskFinishReport(taskContext));
+            return FFS_SUCCESS;
+
+        default:
+            FFS_FAIL(FFS_ERROR);
+    }
 
     // Send the "connecting to user network" success/failure report.
-    FFS_DSS_WIFI_PROVISIONEE_STATE nextDssProvisioneeState;
-    FFS_CHECK_RESULT(ffsDssReport(taskContext->dssClientContext,
-            FFS_DSS_WIFI_PROVISIONEE_STATE_CONNECTING_TO_USER_NETWORK,
-            (result == FFS_SUCCESS ? FFS_DSS_REPORT_RESULT_SUCCESS
-                    : FFS_DSS_REPORT_RESULT_FAILURE),
-            dssRegistrationState, &taskContext->cloudCanProceed, &nextDssProvisioneeState,
-            ffsWifiGetDssConnectionAttemptsCallback, &taskContext->wifiConnectionAttempt));
+    FFS_CHECK_RESULT(ffsWifiProvisioneeTaskStartReport(taskContext,
+            FFS_DSS_WIFI_PROVISIONEE_STATE_CONNECTING_TO_USER_NETWORK, result, true, nowMs));
 
-    FFS_CHECK_CAN_PROCEED(taskContext->cloudCanProceed);
+    return FFS_SUCCESS;
+}
 
-    // Set the provisionee state.
-    FFS_WIFI_PROVISIONEE_STATE nextProvisioneeState;
-    FFS_CHECK_RESULT(ffsConvertDssWifiProvisioneeStateToApi(nextDssProvisioneeState,
-            &nextProvisioneeState));
-    FFS_CHECK_RESULT(ffsSetWifiProvisioneeState(taskContext->userContext, nextProvisioneeState));
+/*
+ * Start reconnecting to the setup network which was previously used.
+ */
+static FFS_RESULT ffsWifiProvisioneeTaskReconnectToSetupNetwork(FfsTaskContext_t *taskContext, uint32_t nowMs) {
+
+    ffsLogError("Failed to connect to a user network, reconnecting to setup network");
+    FFS_CHECK_RESULT(ffsStartConnectingToSetupNetwork(taskContext->userContext, &taskContext->setupWifiConfiguration));
+
+    taskContext->stage = FFS_WIFI_PROVISIONEE_TASK_STAGE_FALLBACK;
+    ffsWifiProvisioneeTaskAwait(taskContext, FFS_WIFI_PROVISIONEE_EVENT_WIFI, nowMs,
+            FFS_WIFI_PROVISIONEE_CONNECTION_TIMEOUT_MS);
 
     return FFS_SUCCESS;
 }
@@ -526,26 +1268,17 @@ static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateConnectingToUserNetwork(FfsT
 /*
  * Execute an FFS "connected to user network" state.
  */
-static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateConnectedToUserNetwork(FfsTaskContext_t *taskContext) {
+static FFS_RESULT ffsWifiProvisioneeTaskExecuteStateConnectedToUserNetwork(FfsTaskContext_t *taskContext,
+        uint32_t nowMs) {
 
-    // Get the DSS registration state.
-    FFS_DSS_REGISTRATION_STATE dssRegistrationState;
-    FFS_CHECK_RESULT(ffsGetDssRegistrationState(taskContext, &dssRegistrationState))
+    if (taskContext->stage == FFS_WIFI_PROVISIONEE_TASK_STAGE_REPORT) {
+        FFS_CHECK_RESULT(ffsWifiProvisioneeTaskFinishReport(taskContext));
+        return FFS_SUCCESS;
+    }
 
     // Send the "connected to user network" success report.
-    FFS_DSS_WIFI_PROVISIONEE_STATE nextDssProvisioneeState;
-    FFS_CHECK_RESULT(ffsDssReport(taskContext->dssClientContext,
-            FFS_DSS_WIFI_PROVISIONEE_STATE_CONNECTED_TO_USER_NETWORK,
-            FFS_DSS_REPORT_RESULT_SUCCESS,
-            dssRegistrationState, &taskContext->cloudCanProceed, &nextDssProvisioneeState, NULL, NULL));
-
-    FFS_CHECK_CAN_PROCEED(taskContext->cloudCanProceed);
-
-    // Set the provisionee state.
-    FFS_WIFI_PROVISIONEE_STATE nextProvisioneeState;
-    FFS_CHECK_RESULT(ffsConvertDssWifiProvisioneeStateToApi(nextDssProvisioneeState,
-            &nextProvisioneeState));
-    FFS_CHECK_RESULT(ffsSetWifiProvisioneeState(taskContext->userContext, nextProvisioneeState));
+    FFS_CHECK_RESULT(ffsWifiProvisioneeTaskStartReport(taskContext,
+            FFS_DSS_WIFI_PROVISIONEE_STATE_CONNECTED_TO_USER_NETWORK, FFS_SUCCESS, false, nowMs));
 
     return FFS_SUCCESS;
 }
@@ -558,7 +1291,7 @@ static FFS_RESULT ffsGetDssRegistrationState(FfsTaskContext_t *taskContext,
 
     // Get the (API) registration state.
     FfsRegistrationDetails_t registrationDetails;
-    FFS_CHECK_RESULT(ffsGetRegistrationDetails(taskContext->dssClientContext->userContext,
+    FFS_CHECK_RESULT(ffsGetRegistrationDetails(taskContext->dssClientContext.userContext,
             &registrationDetails));
 
     // Convert it to the DSS registration state.
@@ -618,61 +1351,91 @@ static FFS_RESULT ffsWifiGetDssConnectionAttemptsCallback(struct FfsUserContext_
 
 /*
  * Get the (DSS) Wi-Fi scan results to report.
+ *
+ * Scan results are posted from a deduplicated list ranked by signal strength
+ * and security, so the networks most likely to have a cloud credential fill
+ * the first pages. Each page continues where the previous one stopped.
  */
 static FFS_RESULT ffsWifiGetDssScanResultsCallback(struct FfsUserContext_s *userContext,
-        FfsDssWifiScanResult_t *dssWifiScanResult, void *callbackDataPointer) {
+        FfsWifiProvisioneeScanList_t *wifiScanList, void *callbackDataPointer) {
 
-    for (;;) {
-
-        // Check that we don't already have a scan result.
-        if (ffsStreamIsEmpty(&dssWifiScanResult->ssidStream)) {
+    (void) userContext;
 
-            // Get the next scan result.
-            FfsWifiScanResult_t wifiScanResult = {
-                .ssidStream = dssWifiScanResult->ssidStream,
-                .bssidStream = dssWifiScanResult->bssidStream
-            };
-            bool isUnderrun = false;
-            FFS_CHECK_RESULT(ffsGetWifiScanResult(userContext, &wifiScanResult, &isUnderrun));
-
-            // No more scan results.
-            if (isUnderrun) {
-                break;
-            }
+    for (;;) {
 
-            // Skip hidden networks.
-            if (ffsStreamIsEmpty(&wifiScanResult.ssidStream)) {
-                ffsLogWarning("Ignoring Wi-Fi scan result with an empty SSID.");
-                continue;
-            }
+        // Get the next scan result.
+        FfsWifiScanResult_t wifiScanResult;
+        bool isUnderrun = false;
+        FFS_CHECK_RESULT(ffsWifiProvisioneeScanListPeek(wifiScanList, &wifiScanResult, &isUnderrun));
 
-            // Convert it to DSS.
-            FFS_CHECK_RESULT(ffsConvertApiWifiScanResultToDss(&wifiScanResult,
-                    dssWifiScanResult));
+        // No more scan results.
+        if (isUnderrun) {
+            break;
         }
 
+        // Convert it to DSS.
+        FfsDssWifiScanResult_t dssWifiScanResult;
+        FFS_CHECK_RESULT(ffsConvertApiWifiScanResultToDss(&wifiScanResult, &dssWifiScanResult));
+
         // Add it.
         FFS_RESULT result = ffsDssPostWifiScanDataAddScanResult(callbackDataPointer,
-                dssWifiScanResult);
+                &dssWifiScanResult);
 
-        // Run out of space? Break and persist scan result.
+        // Run out of space? Break and send this scan result in the next page.
         if (result == FFS_OVERRUN) {
-            FFS_CHECK_RESULT(ffsRewindStream(&dssWifiScanResult->ssidStream));
-            FFS_CHECK_RESULT(ffsRewindStream(&dssWifiScanResult->bssidStream));
             break;
         }
 
         // Error?
         FFS_CHECK_RESULT(result);
 
-        // Clear the persistent scan result.
-        FFS_CHECK_RESULT(ffsFlushStream(&dssWifiScanResult->ssidStream));
-        FFS_CHECK_RESULT(ffsFlushStream(&dssWifiScanResult->bssidStream));
+        // Consume the scan result.
+        FFS_CHECK_RESULT(ffsWifiProvisioneeScanListAdvance(wifiScanList));
     }
 
     return FFS_SUCCESS;
 }
 
+/*
+ * Read every scan result from the client into the scan list, and rank them.
+ */
+static FFS_RESULT ffsWifiPopulateScanList(struct FfsUserContext_s *userContext,
+        FfsWifiProvisioneeScanList_t *wifiScanList) {
+
+    FFS_TEMPORARY_OUTPUT_STREAM(ssidStream, FFS_MAXIMUM_SSID_SIZE);
+    FFS_TEMPORARY_OUTPUT_STREAM(bssidStream, FFS_BSSID_SIZE);
+
+    for (;;) {
+
+        // Get the next scan result.
+        FFS_CHECK_RESULT(ffsFlushStream(&ssidStream));
+        FFS_CHECK_RESULT(ffsFlushStream(&bssidStream));
+        FfsWifiScanResult_t wifiScanResult = {
+            .ssidStream = ssidStream,
+            .bssidStream = bssidStream
+        };
+        bool isUnderrun = false;
+        FFS_CHECK_RESULT(ffsGetWifiScanResult(userContext, &wifiScanResult, &isUnderrun));
+
+        // No more scan results.
+        if (isUnderrun) {
+            break;
+        }
+
+        // Skip hidden networks.
+        if (ffsStreamIsEmpty(&wifiScanResult.ssidStream)) {
+            ffsLogWarning("Ignoring Wi-Fi scan result with an empty SSID.");
+            continue;
+        }
+
+        FFS_CHECK_RESULT(ffsWifiProvisioneeScanListAdd(wifiScanList, &wifiScanResult));
+    }
+
+    FFS_CHECK_RESULT(ffsWifiProvisioneeScanListRank(wifiScanList));
+
+    return FFS_SUCCESS;
+}
+
 /*
  * "Get (DSS) Wi-Fi scan results" callback.
  *
@@ -688,6 +1451,12 @@ static FFS_RESULT ffsWifiSaveDssCredentialsCallback(struct FfsUserContext_s *use
     FfsWifiConfiguration_t apiWifiConfiguration;
     FFS_CHECK_RESULT(ffsConvertDssWifiCredentialsToApi(dssWifiCredentials, &apiWifiConfiguration));
 
+    // Log it for a resume.
+    if (sCheckpointTaskContext && sCheckpointTaskContext->checkpointEnabled) {
+        ffsWifiProvisioneeTaskCheckpointItemLogged(ffsWifiProvisioneeCheckpointAddWifiConfiguration(
+                &sCheckpointTaskContext->checkpointItemsStream, &apiWifiConfiguration));
+    }
+
     // Add it.
     FFS_CHECK_RESULT(ffsAddWifiConfiguration(userContext, &apiWifiConfiguration));
 
@@ -710,6 +1479,12 @@ static FFS_RESULT FfsWifiSaveDssRegistrationDetailsCallback(
     FFS_CHECK_RESULT(ffsConvertDssRegistrationDetailsToApi(dssRegistrationDetails,
             &apiRegistrationRequest));
 
+    // Log it for a resume.
+    if (sCheckpointTaskContext && sCheckpointTaskContext->checkpointEnabled) {
+        ffsWifiProvisioneeTaskCheckpointItemLogged(ffsWifiProvisioneeCheckpointAddRegistrationToken(
+                &sCheckpointTaskContext->checkpointItemsStream, &apiRegistrationRequest));
+    }
+
     // Save it.
     FFS_CHECK_RESULT(ffsSetRegistrationToken(userContext, &apiRegistrationRequest));
 
@@ -728,6 +1503,12 @@ static FFS_RESULT FfsWifiSaveDssRegistrationDetailsCallback(
 static FFS_RESULT ffsWifiSaveConfigurationCallback(struct FfsUserContext_s *userContext,
         const char *key, FfsMapValue_t *value) {
 
+    // Log it for a resume.
+    if (sCheckpointTaskContext && sCheckpointTaskContext->checkpointEnabled) {
+        ffsWifiProvisioneeTaskCheckpointItemLogged(ffsWifiProvisioneeCheckpointAddConfigurationValue(
+                &sCheckpointTaskContext->checkpointItemsStream, key, value));
+    }
+
     // Save it.
     FFS_CHECK_RESULT(ffsSetConfigurationValue(userContext, key, value));
 
@@ -18,30 +18,15 @@
 #include "ffs/wifi_provisionee/ffs_wifi_provisionee_user_network.h"
 
 /*
- *  Connect to the list of user networks.
+ *  Start connecting to the list of user networks.
  */
-FFS_RESULT ffsConnectToUserNetworks(struct FfsUserContext_s *userContext)
+FFS_RESULT ffsStartConnectingToUserNetworks(struct FfsUserContext_s *userContext)
 {
-    FFS_TEMPORARY_OUTPUT_STREAM(connectionDetailsSsidStream, FFS_MAXIMUM_SSID_SIZE);
-    FfsWifiConnectionDetails_t wifiConnectionDetails = {
-        .ssidStream = connectionDetailsSsidStream
-    };
-
     ffsLogDebug("Start connecting to user networks");
 
     // Start the connection attempts.
     FFS_CHECK_RESULT(ffsConnectToWifi(userContext));
 
-    // Get the connection state.
-    FFS_CHECK_RESULT(ffsGetWifiConnectionDetails(userContext, &wifiConnectionDetails));
-
-    if (wifiConnectionDetails.state != FFS_WIFI_CONNECTION_STATE_ASSOCIATED) {
-        ffsLogError("Failed to connect to a user network");
-        FFS_FAIL(FFS_ERROR);
-    }
-
-    ffsLogDebug("Connected to user network");
-
     return FFS_SUCCESS;
 }
 
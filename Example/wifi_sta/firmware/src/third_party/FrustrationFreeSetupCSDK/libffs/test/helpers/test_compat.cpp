@@ -206,6 +206,63 @@ FFS_RESULT ffsHttpExecute(struct FfsUserContext_s *userContext,
     return userContext->compat.ffsHttpExecute(userContext, request, callbackDataPointer);
 }
 
+/*
+ * In-flight HTTP operation; the mock completes every request before
+ * ffsHttpExecuteAsync returns.
+ */
+struct FfsHttpOperation_s {
+    FFS_RESULT result;
+};
+
+/*
+ * Start an HTTP operation.
+ */
+FFS_RESULT ffsHttpExecuteAsync(struct FfsUserContext_s *userContext, FfsHttpRequest_t *request,
+        void *callbackDataPointer, uint32_t timeoutMs, FfsHttpCompletionCallback_t onComplete,
+        FfsHttpOperation_t **operation)
+{
+    (void) timeoutMs;
+
+    FfsHttpOperation_t *newOperation = new FfsHttpOperation_t;
+    newOperation->result = userContext->compat.ffsHttpExecute(userContext, request, callbackDataPointer);
+
+    if (onComplete) {
+        onComplete(newOperation, newOperation->result, callbackDataPointer);
+    }
+
+    if (operation) {
+        *operation = newOperation;
+    } else {
+        delete newOperation;
+    }
+
+    return FFS_SUCCESS;
+}
+
+/*
+ * Wait for an HTTP operation and release it.
+ */
+FFS_RESULT ffsHttpWait(struct FfsUserContext_s *userContext, FfsHttpOperation_t *operation)
+{
+    (void) userContext;
+
+    FFS_RESULT result = operation->result;
+    delete operation;
+
+    return result;
+}
+
+/*
+ * Cancel an HTTP operation.
+ */
+FFS_RESULT ffsHttpCancel(struct FfsUserContext_s *userContext, FfsHttpOperation_t *operation)
+{
+    (void) userContext;
+    (void) operation;
+
+    return FFS_SUCCESS;
+}
+
 /*
  * Get the next Wi-Fi scan result.
  */
@@ -334,4 +391,30 @@ FFS_RESULT ffsWifiProvisioneeCanGetWifiCredentials(struct FfsUserContext_s *user
             allCredentialsReturned, canGetWifiCredentials);
 }
 
+/*
+ * Save the provisioning checkpoint.
+ */
+FFS_RESULT ffsSaveWifiProvisioneeCheckpoint(struct FfsUserContext_s *userContext,
+        FfsStream_t *checkpointStream)
+{
+    return userContext->compat.ffsSaveWifiProvisioneeCheckpoint(userContext, checkpointStream);
+}
+
+/*
+ * Load the provisioning checkpoint.
+ */
+FFS_RESULT ffsLoadWifiProvisioneeCheckpoint(struct FfsUserContext_s *userContext,
+        FfsStream_t *checkpointStream)
+{
+    return userContext->compat.ffsLoadWifiProvisioneeCheckpoint(userContext, checkpointStream);
+}
+
+/*
+ * Remove the stored provisioning checkpoint.
+ */
+FFS_RESULT ffsClearWifiProvisioneeCheckpoint(struct FfsUserContext_s *userContext)
+{
+    return userContext->compat.ffsClearWifiProvisioneeCheckpoint(userContext);
+}
+
 }
@@ -85,6 +85,11 @@ public:
             uint32_t sequenceNumber, uint32_t totalCredentialsFound, bool allCredentialsFound, bool *canPostWifiScanData) = 0;
     virtual FFS_RESULT ffsWifiProvisioneeCanGetWifiCredentials(struct FfsUserContext_s *userContext,
             uint32_t sequenceNumber, bool allCredentialsReturned, bool *canGetWifiCredentials) = 0;
+    virtual FFS_RESULT ffsSaveWifiProvisioneeCheckpoint(struct FfsUserContext_s *userContext,
+            FfsStream_t *checkpointStream) = 0;
+    virtual FFS_RESULT ffsLoadWifiProvisioneeCheckpoint(struct FfsUserContext_s *userContext,
+            FfsStream_t *checkpointStream) = 0;
+    virtual FFS_RESULT ffsClearWifiProvisioneeCheckpoint(struct FfsUserContext_s *userContext) = 0;
 
 };
 
@@ -149,6 +154,11 @@ public:
             uint32_t sequenceNumber, uint32_t totalCredentialsFound, bool allCredentialsFound, bool *canPostWifiScanData));
     MOCK_METHOD4(ffsWifiProvisioneeCanGetWifiCredentials, FFS_RESULT(struct FfsUserContext_s *userContext,
             uint32_t sequenceNumber, bool allCredentialsReturned, bool *canGetWifiCredentials));
+    MOCK_METHOD2(ffsSaveWifiProvisioneeCheckpoint, FFS_RESULT(struct FfsUserContext_s *userContext,
+            FfsStream_t *checkpointStream));
+    MOCK_METHOD2(ffsLoadWifiProvisioneeCheckpoint, FFS_RESULT(struct FfsUserContext_s *userContext,
+            FfsStream_t *checkpointStream));
+    MOCK_METHOD1(ffsClearWifiProvisioneeCheckpoint, FFS_RESULT(struct FfsUserContext_s *userContext));
 
 };
 
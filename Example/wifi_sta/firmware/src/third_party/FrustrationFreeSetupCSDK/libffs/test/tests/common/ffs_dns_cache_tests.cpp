@@ -0,0 +1,225 @@
+/** @file ffs_dns_cache_tests.cpp
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/common/ffs_dns_cache.h"
+#include "helpers/test_utilities.h"
+
+#define TEST_HOST           "dp-sps-na.amazon.com"
+#define TEST_ADDRESS        "192.0.2.10"
+#define TEST_OTHER_HOST     "api.amazon.com"
+#define TEST_OTHER_ADDRESS  "192.0.2.20"
+
+/* @brief Test a miss, an insertion, a hit and expiry
+ */
+TEST(DnsCacheTests, InsertLookupExpire)
+{
+    FfsDnsCacheEntry_t entries[4];
+    FfsDnsCache_t cache;
+    FfsStream_t hostStream = FFS_STRING_INPUT_STREAM(TEST_HOST);
+    FFS_TEMPORARY_OUTPUT_STREAM(addressStream, FFS_DNS_CACHE_MAXIMUM_ADDRESS_LENGTH);
+    FFS_DNS_CACHE_LOOKUP_RESULT lookupResult;
+
+    ASSERT_SUCCESS(ffsInitializeDnsCache(&cache, entries, 4));
+
+    ASSERT_SUCCESS(ffsDnsCacheLookup(&cache, &hostStream, 1000, &addressStream, &lookupResult));
+    ASSERT_EQ(lookupResult, FFS_DNS_CACHE_MISS);
+
+    ASSERT_SUCCESS(ffsDnsCacheInsert(&cache, &hostStream, TEST_ADDRESS, 60 * 1000, 250, 1000));
+
+    ASSERT_SUCCESS(ffsDnsCacheLookup(&cache, &hostStream, 2000, &addressStream, &lookupResult));
+    ASSERT_EQ(lookupResult, FFS_DNS_CACHE_HIT);
+    ASSERT_STREAM_EQ_STRING(addressStream, TEST_ADDRESS);
+
+    // Host names are case-insensitive.
+    FfsStream_t upperCaseHostStream = FFS_STRING_INPUT_STREAM("DP-SPS-NA.AMAZON.COM");
+    ASSERT_SUCCESS(ffsDnsCacheLookup(&cache, &upperCaseHostStream, 2000, NULL, &lookupResult));
+    ASSERT_EQ(lookupResult, FFS_DNS_CACHE_HIT);
+
+    ASSERT_SUCCESS(ffsDnsCacheLookup(&cache, &hostStream, 61 * 1000, NULL, &lookupResult));
+    ASSERT_EQ(lookupResult, FFS_DNS_CACHE_MISS);
+
+    ASSERT_EQ(cache.statistics.hits, 2u);
+    ASSERT_EQ(cache.statistics.misses, 2u);
+    ASSERT_EQ(cache.statistics.expirations, 1u);
+    ASSERT_EQ(cache.statistics.timeSavedMs, 500u);
+}
+
+/* @brief Test time-to-live clamping
+ */
+TEST(DnsCacheTests, TtlIsClamped)
+{
+    FfsDnsCacheEntry_t entries[1];
+    FfsDnsCache_t cache;
+    FfsStream_t hostStream = FFS_STRING_INPUT_STREAM(TEST_HOST);
+    FFS_DNS_CACHE_LOOKUP_RESULT lookupResult;
+
+    ASSERT_SUCCESS(ffsInitializeDnsCache(&cache, entries, 1));
+    cache.minimumTtlMs = 10 * 1000;
+    cache.maximumTtlMs = 20 * 1000;
+
+    // A zero TTL is raised to the minimum.
+    ASSERT_SUCCESS(ffsDnsCacheInsert(&cache, &hostStream, TEST_ADDRESS, 0, 0, 0));
+    ASSERT_SUCCESS(ffsDnsCacheLookup(&cache, &hostStream, 9999, NULL, &lookupResult));
+    ASSERT_EQ(lookupResult, FFS_DNS_CACHE_HIT);
+
+    // A long TTL is lowered to the maximum.
+    ASSERT_SUCCESS(ffsDnsCacheInsert(&cache, &hostStream, TEST_ADDRESS, 3600 * 1000, 0, 0));
+    ASSERT_SUCCESS(ffsDnsCacheLookup(&cache, &hostStream, 20 * 1000, NULL, &lookupResult));
+    ASSERT_EQ(lookupResult, FFS_DNS_CACHE_MISS);
+}
+
+/* @brief Test that expiry works across a clock wrap
+ */
+TEST(DnsCacheTests, ClockWrap)
+{
+    FfsDnsCacheEntry_t entries[1];
+    FfsDnsCache_t cache;
+    FfsStream_t hostStream = FFS_STRING_INPUT_STREAM(TEST_HOST);
+    FFS_DNS_CACHE_LOOKUP_RESULT lookupResult;
+    const uint32_t nowMs = UINT32_MAX - 1000;
+
+    ASSERT_SUCCESS(ffsInitializeDnsCache(&cache, entries, 1));
+
+    ASSERT_SUCCESS(ffsDnsCacheInsert(&cache, &hostStream, TEST_ADDRESS, 60 * 1000, 0, nowMs));
+    ASSERT_SUCCESS(ffsDnsCacheLookup(&cache, &hostStream, nowMs + 30 * 1000, NULL, &lookupResult));
+    ASSERT_EQ(lookupResult, FFS_DNS_CACHE_HIT);
+    ASSERT_SUCCESS(ffsDnsCacheLookup(&cache, &hostStream, nowMs + 60 * 1000, NULL, &lookupResult));
+    ASSERT_EQ(lookupResult, FFS_DNS_CACHE_MISS);
+}
+
+/* @brief Test negative records and flushing them
+ */
+TEST(DnsCacheTests, NegativeRecords)
+{
+    FfsDnsCacheEntry_t entries[2];
+    FfsDnsCache_t cache;
+    FfsStream_t hostStream = FFS_STRING_INPUT_STREAM(TEST_HOST);
+    FfsStream_t otherHostStream = FFS_STRING_INPUT_STREAM(TEST_OTHER_HOST);
+    FFS_DNS_CACHE_LOOKUP_RESULT lookupResult;
+
+    ASSERT_SUCCESS(ffsInitializeDnsCache(&cache, entries, 2));
+
+    ASSERT_SUCCESS(ffsDnsCacheInsertNegative(&cache, &hostStream, 5000, 0));
+    ASSERT_SUCCESS(ffsDnsCacheInsert(&cache, &otherHostStream, TEST_OTHER_ADDRESS, 60 * 1000, 0, 0));
+
+    ASSERT_SUCCESS(ffsDnsCacheLookup(&cache, &hostStream, 1000, NULL, &lookupResult));
+    ASSERT_EQ(lookupResult, FFS_DNS_CACHE_NEGATIVE_HIT);
+
+    // Negative records use the (short) negative TTL.
+    ASSERT_SUCCESS(ffsDnsCacheLookup(&cache, &hostStream, FFS_DNS_CACHE_DEFAULT_NEGATIVE_TTL_MS, NULL,
+            &lookupResult));
+    ASSERT_EQ(lookupResult, FFS_DNS_CACHE_MISS);
+
+    ASSERT_SUCCESS(ffsDnsCacheInsertNegative(&cache, &hostStream, 5000, 0));
+    ASSERT_SUCCESS(ffsDnsCacheFlushNegative(&cache));
+
+    ASSERT_SUCCESS(ffsDnsCacheLookup(&cache, &hostStream, 1000, NULL, &lookupResult));
+    ASSERT_EQ(lookupResult, FFS_DNS_CACHE_MISS);
+    ASSERT_SUCCESS(ffsDnsCacheLookup(&cache, &otherHostStream, 1000, NULL, &lookupResult));
+    ASSERT_EQ(lookupResult, FFS_DNS_CACHE_HIT);
+}
+
+/* @brief Test least-recently-used eviction
+ */
+TEST(DnsCacheTests, EvictsLeastRecentlyUsed)
+{
+    FfsDnsCacheEntry_t entries[2];
+    FfsDnsCache_t cache;
+    FfsStream_t hostStream = FFS_STRING_INPUT_STREAM(TEST_HOST);
+    FfsStream_t otherHostStream = FFS_STRING_INPUT_STREAM(TEST_OTHER_HOST);
+    FfsStream_t thirdHostStream = FFS_STRING_INPUT_STREAM("example.com");
+    FFS_DNS_CACHE_LOOKUP_RESULT lookupResult;
+
+    ASSERT_SUCCESS(ffsInitializeDnsCache(&cache, entries, 2));
+
+    ASSERT_SUCCESS(ffsDnsCacheInsert(&cache, &hostStream, TEST_ADDRESS, 60 * 1000, 0, 0));
+    ASSERT_SUCCESS(ffsDnsCacheInsert(&cache, &otherHostStream, TEST_OTHER_ADDRESS, 60 * 1000, 0, 100));
+
+    // Touch the first host so the second one becomes the eviction candidate.
+    ASSERT_SUCCESS(ffsDnsCacheLookup(&cache, &hostStream, 200, NULL, &lookupResult));
+    ASSERT_SUCCESS(ffsDnsCacheInsert(&cache, &thirdHostStream, "192.0.2.30", 60 * 1000, 0, 300));
+
+    ASSERT_EQ(cache.statistics.evictions, 1u);
+    ASSERT_SUCCESS(ffsDnsCacheLookup(&cache, &hostStream, 400, NULL, &lookupResult));
+    ASSERT_EQ(lookupResult, FFS_DNS_CACHE_HIT);
+    ASSERT_SUCCESS(ffsDnsCacheLookup(&cache, &otherHostStream, 400, NULL, &lookupResult));
+    ASSERT_EQ(lookupResult, FFS_DNS_CACHE_MISS);
+}
+
+/* @brief Test serializing and restoring a cache
+ */
+TEST(DnsCacheTests, SerializeDeserialize)
+{
+    FfsDnsCacheEntry_t entries[4];
+    FfsDnsCache_t cache;
+    FfsStream_t hostStream = FFS_STRING_INPUT_STREAM(TEST_HOST);
+    FfsStream_t otherHostStream = FFS_STRING_INPUT_STREAM(TEST_OTHER_HOST);
+    FfsStream_t negativeHostStream = FFS_STRING_INPUT_STREAM("example.com");
+    FFS_TEMPORARY_OUTPUT_STREAM(serializedStream, 256);
+    FFS_TEMPORARY_OUTPUT_STREAM(addressStream, FFS_DNS_CACHE_MAXIMUM_ADDRESS_LENGTH);
+    FFS_DNS_CACHE_LOOKUP_RESULT lookupResult;
+
+    ASSERT_SUCCESS(ffsInitializeDnsCache(&cache, entries, 4));
+    ASSERT_SUCCESS(ffsDnsCacheInsert(&cache, &hostStream, TEST_ADDRESS, 60 * 1000, 120, 0));
+    ASSERT_SUCCESS(ffsDnsCacheInsert(&cache, &otherHostStream, TEST_OTHER_ADDRESS, 30 * 1000, 80, 0));
+    ASSERT_SUCCESS(ffsDnsCacheInsertNegative(&cache, &negativeHostStream, 5000, 0));
+
+    // Serialize at t = 40 s; only the first host is still live.
+    ASSERT_SUCCESS(ffsDnsCacheSerialize(&cache, 40 * 1000, &serializedStream));
+
+    FfsDnsCacheEntry_t restoredEntries[4];
+    FfsDnsCache_t restoredCache;
+    ASSERT_SUCCESS(ffsInitializeDnsCache(&restoredCache, restoredEntries, 4));
+
+    // Restore on a fresh clock; 20 s of the original TTL remain.
+    ASSERT_SUCCESS(ffsDnsCacheDeserialize(&restoredCache, 0, &serializedStream));
+    ASSERT_EQ(FFS_STREAM_DATA_SIZE(serializedStream), 0u);
+
+    ASSERT_SUCCESS(ffsDnsCacheLookup(&restoredCache, &hostStream, 19 * 1000, &addressStream, &lookupResult));
+    ASSERT_EQ(lookupResult, FFS_DNS_CACHE_HIT);
+    ASSERT_STREAM_EQ_STRING(addressStream, TEST_ADDRESS);
+    ASSERT_EQ(restoredCache.statistics.timeSavedMs, 120u);
+
+    ASSERT_SUCCESS(ffsDnsCacheLookup(&restoredCache, &otherHostStream, 0, NULL, &lookupResult));
+    ASSERT_EQ(lookupResult, FFS_DNS_CACHE_MISS);
+    ASSERT_SUCCESS(ffsDnsCacheLookup(&restoredCache, &negativeHostStream, 0, NULL, &lookupResult));
+    ASSERT_EQ(lookupResult, FFS_DNS_CACHE_MISS);
+    ASSERT_SUCCESS(ffsDnsCacheLookup(&restoredCache, &hostStream, 20 * 1000, NULL, &lookupResult));
+    ASSERT_EQ(lookupResult, FFS_DNS_CACHE_MISS);
+}
+
+/* @brief Test that malformed input is rejected without modifying the cache
+ */
+TEST(DnsCacheTests, DeserializeMalformed)
+{
+    FfsDnsCacheEntry_t entries[2];
+    FfsDnsCache_t cache;
+    FfsStream_t hostStream = FFS_STRING_INPUT_STREAM("a");
+    FFS_DNS_CACHE_LOOKUP_RESULT lookupResult;
+
+    ASSERT_SUCCESS(ffsInitializeDnsCache(&cache, entries, 2));
+
+    // Wrong version.
+    FFS_LITERAL_INPUT_STREAM(wrongVersionStream, { 0x7F, 0x00 });
+    ASSERT_FAILURE(ffsDnsCacheDeserialize(&cache, 0, &wrongVersionStream));
+
+    // Two records announced, only one present.
+    FFS_LITERAL_INPUT_STREAM(truncatedStream, { FFS_DNS_CACHE_SERIALIZED_VERSION, 0x02,
+            0x01, 'a', 0x07, '1', '.', '2', '.', '3', '.', '4',
+            0x00, 0x00, 0xEA, 0x60, 0x00, 0x00, 0x00, 0x00 });
+    ASSERT_FAILURE(ffsDnsCacheDeserialize(&cache, 0, &truncatedStream));
+
+    ASSERT_SUCCESS(ffsDnsCacheLookup(&cache, &hostStream, 0, NULL, &lookupResult));
+    ASSERT_EQ(lookupResult, FFS_DNS_CACHE_MISS);
+}
@@ -181,3 +181,93 @@ TEST(JsonTests, ParseNegativeUint32)
 
     ASSERT_FAILURE(ffsParseJsonUint32(&sourceJsonValue, NULL));
 }
+
+/** Test finding the first byte that is not plain ASCII, at every position and alignment.
+ */
+TEST(JsonTests, ScanPlainBytes)
+{
+    const uint8_t SPECIAL_BYTES[] = { '"', '\\', 0x00, 0x0a, 0x1f, 0x80, 0xc3, 0xff };
+    const uint8_t PLAIN_BYTES[] = { ' ', '!', '#', '[', ']', '{', 'A', 'z', 0x7f };
+    uint8_t buffer[80];
+
+    for (size_t offset = 0; offset < 16; offset++) {
+        for (size_t size = 0; size + offset <= 64; size++) {
+            for (size_t plainIndex = 0; plainIndex < sizeof(PLAIN_BYTES); plainIndex++) {
+                memset(buffer, PLAIN_BYTES[plainIndex], sizeof(buffer));
+                ASSERT_EQ(ffsScanJsonPlainBytes(buffer + offset, size), size);
+            }
+
+            memset(buffer, 'A', sizeof(buffer));
+            for (size_t position = 0; position < size; position++) {
+                for (size_t specialIndex = 0; specialIndex < sizeof(SPECIAL_BYTES); specialIndex++) {
+                    buffer[offset + position] = SPECIAL_BYTES[specialIndex];
+
+                    // A second special byte further on does not matter.
+                    buffer[offset + size - 1] = (position + 1 < size) ? 0x01 : buffer[offset + position];
+                    ASSERT_EQ(ffsScanJsonPlainBytes(buffer + offset, size), position);
+                    buffer[offset + size - 1] = 'A';
+                }
+                buffer[offset + position] = 'A';
+            }
+        }
+    }
+}
+
+/** Test encoding and parsing back long strings with escapes between runs of plain bytes.
+ */
+TEST(JsonTests, EncodeAndParseLongStrings)
+{
+    for (uint8_t escaped = 0; escaped < 0x80; escaped++) {
+        for (size_t runSize = 0; runSize < 40; runSize += 13) {
+            std::string original = std::string(runSize, 'x') + (char) escaped + std::string(runSize + 17, 'y')
+                    + "\xc3\xa9" + std::string(runSize, 'z');
+
+            // Encode.
+            FFS_TEMPORARY_OUTPUT_STREAM(jsonStream, 512);
+            FfsStream_t sourceStream = ffsCreateInputStream((uint8_t *) &original[0], original.size());
+            ASSERT_SUCCESS(ffsWriteStringToStream("{\"key\":\"", &jsonStream));
+            ASSERT_SUCCESS(ffsEncodeJsonString(&sourceStream, &jsonStream));
+            ASSERT_SUCCESS(ffsWriteStringToStream("\",\"next\":[\"", &jsonStream));
+            sourceStream = ffsCreateInputStream((uint8_t *) &original[0], original.size());
+            ASSERT_SUCCESS(ffsEncodeJsonString(&sourceStream, &jsonStream));
+            ASSERT_SUCCESS(ffsWriteStringToStream("\"]}", &jsonStream));
+
+            // Parse.
+            FfsJsonValue_t jsonRoot;
+            FfsJsonField_t keyField = ffsCreateJsonField("key", FFS_JSON_STRING);
+            FfsJsonField_t nextField = ffsCreateJsonField("next", FFS_JSON_ARRAY);
+            FfsJsonField_t *expectedFields[] = { &keyField, &nextField, NULL };
+            ASSERT_SUCCESS(ffsInitializeJsonObject(&jsonStream, &jsonRoot));
+            ASSERT_SUCCESS(ffsParseJsonObject(&jsonRoot, expectedFields));
+
+            FfsJsonValue_t elementValue;
+            bool isDone;
+            ASSERT_SUCCESS(ffsParseJsonValue(&nextField.value, &elementValue, &isDone));
+            ASSERT_FALSE(isDone);
+
+            FfsStream_t keyStream;
+            FfsStream_t elementStream;
+            ASSERT_SUCCESS(ffsConvertJsonValueToUtf8(&keyField.value, &keyStream));
+            ASSERT_SUCCESS(ffsConvertJsonValueToUtf8(&elementValue, &elementStream));
+            ASSERT_EQ(std::string((const char *) FFS_STREAM_NEXT_READ(keyStream), FFS_STREAM_DATA_SIZE(keyStream)),
+                    original);
+            ASSERT_EQ(std::string((const char *) FFS_STREAM_NEXT_READ(elementStream),
+                    FFS_STREAM_DATA_SIZE(elementStream)), original);
+        }
+    }
+}
+
+/** Test that a string without its closing quote is still an underrun.
+ */
+TEST(JsonTests, ParseUnterminatedLongString)
+{
+    const char JSON_STRING[] = "{\"key\":\"0123456789abcdef0123456789abcdef0123456789abcdef}";
+    FFS_TEMPORARY_OUTPUT_STREAM(jsonStream, sizeof(JSON_STRING));
+    ASSERT_SUCCESS(ffsWriteStringToStream(JSON_STRING, &jsonStream));
+
+    FfsJsonValue_t jsonRoot;
+    FfsJsonField_t keyField = ffsCreateJsonField("key", FFS_JSON_STRING);
+    FfsJsonField_t *expectedFields[] = { &keyField, NULL };
+    ASSERT_SUCCESS(ffsInitializeJsonObject(&jsonStream, &jsonRoot));
+    ASSERT_EQ(ffsParseJsonObject(&jsonRoot, expectedFields), FFS_UNDERRUN);
+}
@@ -0,0 +1,216 @@
+/** @file ffs_dss_model_codec_tests.cpp
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "helpers/test_utilities.h"
+#include "ffs/common/ffs_json.h"
+#include "ffs/common/ffs_stream.h"
+#include "ffs/dss/model/ffs_dss_compute_configuration_data_response.h"
+#include "ffs/dss/model/ffs_dss_error_details.h"
+#include "ffs/dss/model/ffs_dss_model_tables.h"
+#include "ffs/dss/model/ffs_dss_post_wifi_scan_data_response.h"
+#include "ffs/dss/model/ffs_dss_report_response.h"
+#include "ffs/dss/model/ffs_dss_start_pin_based_setup_response.h"
+#include "ffs/dss/model/ffs_dss_wifi_scan_result.h"
+
+#define TEST_JSON_BUFFER_SIZE   512
+
+/** @brief Parse a JSON text into an object value backed by a test buffer.
+ */
+static void initializeJsonObject(const char *jsonString, uint8_t *buffer, FfsJsonValue_t *objectValue)
+{
+    FfsStream_t jsonStream = ffsCreateOutputStream(buffer, TEST_JSON_BUFFER_SIZE);
+    ASSERT_SUCCESS(ffsWriteStringToStream(jsonString, &jsonStream));
+    ASSERT_SUCCESS(ffsInitializeJsonObject(&jsonStream, objectValue));
+}
+
+/** @brief Does a stream hold exactly a string?
+ */
+static bool streamMatches(FfsStream_t *stream, const char *expected)
+{
+    return arraysAreEqual(FFS_STREAM_NEXT_READ(*stream), FFS_STREAM_DATA_SIZE(*stream),
+            (uint8_t *) expected, strlen(expected));
+}
+
+TEST(DssModelCodecTests, LookupFindsEveryKey)
+{
+    const FfsDssModelDescriptor_t *models[] = {
+        &ffsDssErrorDetailsModel,
+        &ffsDssReportRequestModel,
+        &ffsDssReportResponseModel,
+        &ffsDssPostWifiScanDataResponseModel,
+        &ffsDssWifiScanResultModel,
+        &ffsDssComputeConfigurationDataResponseModel
+    };
+
+    for (size_t modelIndex = 0; modelIndex < sizeof(models) / sizeof(models[0]); modelIndex++) {
+        const FfsDssModelDescriptor_t *model = models[modelIndex];
+        for (uint8_t index = 0; index < model->fieldCount; index++) {
+            const FfsDssModelField_t *field = &model->fields[index];
+            ASSERT_EQ(strlen(field->key), field->keySize);
+            ASSERT_EQ(field, ffsDssFindModelField(model, field->key));
+        }
+        ASSERT_EQ(NULL, ffsDssFindModelField(model, "unknownKey"));
+        ASSERT_EQ(NULL, ffsDssFindModelField(model, ""));
+    }
+
+    // Same length as "nonce", different key.
+    ASSERT_EQ(NULL, ffsDssFindModelField(&ffsDssReportResponseModel, "nonsE"));
+}
+
+TEST(DssModelCodecTests, DeserializeRequiredAndOptionalFields)
+{
+    uint8_t buffer[TEST_JSON_BUFFER_SIZE];
+    FfsJsonValue_t objectValue;
+    initializeJsonObject("{\"reason\":\"BUSY\",\"unknown\":[1,2],\"nonce\":\"abc\","
+            "\"nextProvisioningState\":\"GET_WIFI_LIST\"}", buffer, &objectValue);
+
+    FfsDssReportResponse_t reportResponse;
+    ASSERT_SUCCESS(ffsDssDeserializeReportResponse(&objectValue, &reportResponse));
+
+    ASSERT_STREQ("abc", reportResponse.nonce);
+    ASSERT_STREQ("BUSY", reportResponse.reason);
+    ASSERT_EQ(NULL, reportResponse.waitTime);
+    ASSERT_FALSE(reportResponse.canProceed);
+    ASSERT_EQ(FFS_DSS_WIFI_PROVISIONEE_STATE_GET_WIFI_LIST, reportResponse.nextProvisioningState);
+}
+
+TEST(DssModelCodecTests, DeserializeMissingRequiredField)
+{
+    uint8_t buffer[TEST_JSON_BUFFER_SIZE];
+    FfsJsonValue_t objectValue;
+
+    // A missing required string fails.
+    initializeJsonObject("{\"canProceed\":true}", buffer, &objectValue);
+    FfsDssStartPinBasedSetupResponse_t startPinBasedSetupResponse;
+    ASSERT_FAILURE(ffsDssDeserializeStartPinBasedSetupResponse(&objectValue, &startPinBasedSetupResponse));
+
+    // A missing required boolean is false.
+    initializeJsonObject("{\"nonce\":\"abc\"}", buffer, &objectValue);
+    ASSERT_SUCCESS(ffsDssDeserializeStartPinBasedSetupResponse(&objectValue, &startPinBasedSetupResponse));
+    ASSERT_STREQ("abc", startPinBasedSetupResponse.nonce);
+    ASSERT_FALSE(startPinBasedSetupResponse.canProceed);
+}
+
+TEST(DssModelCodecTests, DeserializeInvalidObjects)
+{
+    uint8_t buffer[TEST_JSON_BUFFER_SIZE];
+    FfsJsonValue_t objectValue;
+    FfsDssReportResponse_t reportResponse;
+
+    // Duplicate key.
+    initializeJsonObject("{\"nonce\":\"abc\",\"nonce\":\"def\"}", buffer, &objectValue);
+    ASSERT_EQ(FFS_OVERRUN, ffsDssDeserializeReportResponse(&objectValue, &reportResponse));
+
+    // Wrong value type.
+    initializeJsonObject("{\"nonce\":\"abc\",\"canProceed\":\"true\"}", buffer, &objectValue);
+    ASSERT_EQ(FFS_ERROR, ffsDssDeserializeReportResponse(&objectValue, &reportResponse));
+
+    // Unknown enumeration value.
+    initializeJsonObject("{\"nonce\":\"abc\",\"nextProvisioningState\":\"SLEEPING\"}", buffer, &objectValue);
+    ASSERT_FAILURE(ffsDssDeserializeReportResponse(&objectValue, &reportResponse));
+}
+
+TEST(DssModelCodecTests, DeserializeCanProceedFalse)
+{
+    uint8_t buffer[TEST_JSON_BUFFER_SIZE];
+    FfsJsonValue_t objectValue;
+    FfsDssPostWifiScanDataResponse_t postWifiScanDataResponse;
+
+    initializeJsonObject("{\"nonce\":\"abc\",\"sessionId\":\"session\",\"canProceed\":false,"
+            "\"sequenceNumber\":1,\"totalCredentialsFound\":2,\"allCredentialsFound\":true}", buffer, &objectValue);
+    ASSERT_EQ(FFS_ERROR, ffsDssDeserializePostWifiScanDataResponse(&objectValue, &postWifiScanDataResponse));
+
+    initializeJsonObject("{\"nonce\":\"abc\",\"sessionId\":\"session\",\"canProceed\":true,"
+            "\"sequenceNumber\":1,\"totalCredentialsFound\":2,\"allCredentialsFound\":true}", buffer, &objectValue);
+    ASSERT_SUCCESS(ffsDssDeserializePostWifiScanDataResponse(&objectValue, &postWifiScanDataResponse));
+    ASSERT_STREQ("session", postWifiScanDataResponse.sessionId);
+    ASSERT_EQ(1u, postWifiScanDataResponse.sequenceNumber);
+    ASSERT_EQ(2u, postWifiScanDataResponse.totalCredentialsFound);
+    ASSERT_TRUE(postWifiScanDataResponse.allCredentialsFound);
+}
+
+TEST(DssModelCodecTests, DeserializeNestedAndCapturedValues)
+{
+    uint8_t buffer[TEST_JSON_BUFFER_SIZE];
+    FfsJsonValue_t objectValue;
+    FfsDssComputeConfigurationDataResponse_t computeConfigurationDataResponse;
+    FfsJsonValue_t configurationValue;
+
+    initializeJsonObject("{\"nonce\":\"abc\",\"configuration\":{\"key\":\"value\"},"
+            "\"registrationDetails\":{\"registrationToken\":\"token\",\"expiresAt\":1600000000123}}",
+            buffer, &objectValue);
+    ASSERT_SUCCESS(ffsDssDeserializeComputeConfigurationDataResponse(&objectValue,
+            &computeConfigurationDataResponse, &configurationValue));
+    ASSERT_STREQ("abc", computeConfigurationDataResponse.nonce);
+    ASSERT_STREQ("token", computeConfigurationDataResponse.registrationDetails.registrationToken);
+    ASSERT_TRUE(computeConfigurationDataResponse.registrationDetails.hasExpiresAt);
+    ASSERT_EQ(1600000000123ll, computeConfigurationDataResponse.registrationDetails.expiresAt);
+    ASSERT_EQ(FFS_JSON_OBJECT, configurationValue.type);
+    ASSERT_FALSE(ffsJsonValueIsEmpty(&configurationValue));
+
+    // Absent optional object and captured value.
+    initializeJsonObject("{\"nonce\":\"abc\"}", buffer, &objectValue);
+    ASSERT_SUCCESS(ffsDssDeserializeComputeConfigurationDataResponse(&objectValue,
+            &computeConfigurationDataResponse, &configurationValue));
+    ASSERT_FALSE(computeConfigurationDataResponse.registrationDetails.hasExpiresAt);
+    ASSERT_EQ(FFS_JSON_OBJECT, configurationValue.type);
+    ASSERT_TRUE(ffsJsonValueIsEmpty(&configurationValue));
+}
+
+TEST(DssModelCodecTests, SerializeOptionalFields)
+{
+    FFS_TEMPORARY_OUTPUT_STREAM(outputStream, TEST_JSON_BUFFER_SIZE);
+    bool isEmpty;
+
+    // Only some of the optional fields are set.
+    FfsDssErrorDetails_t errorDetails;
+    memset(&errorDetails, 0, sizeof(errorDetails));
+    errorDetails.cause = "cause";
+    errorDetails.code = "1.2.3";
+    ASSERT_SUCCESS(ffsDssSerializeErrorDetails(&errorDetails, &isEmpty, &outputStream));
+    ASSERT_FALSE(isEmpty);
+    ASSERT_TRUE(streamMatches(&outputStream, "{\"cause\":\"cause\",\"code\":\"1.2.3\"}"));
+
+    // No field is set.
+    ffsFlushStream(&outputStream);
+    memset(&errorDetails, 0, sizeof(errorDetails));
+    ASSERT_SUCCESS(ffsDssSerializeErrorDetails(&errorDetails, &isEmpty, &outputStream));
+    ASSERT_TRUE(isEmpty);
+    ASSERT_TRUE(streamMatches(&outputStream, "{}"));
+}
+
+TEST(DssModelCodecTests, SerializeScanResult)
+{
+    FFS_TEMPORARY_OUTPUT_STREAM(outputStream, TEST_JSON_BUFFER_SIZE);
+    const uint8_t BSSID[] = { 0x00, 0x11, 0x22, 0xaa, 0xbb, 0xcc };
+
+    FfsDssWifiScanResult_t scanResult;
+    memset(&scanResult, 0, sizeof(scanResult));
+    scanResult.ssidStream = FFS_STRING_INPUT_STREAM("ssid");
+    scanResult.bssidStream = ffsCreateInputStream((uint8_t *) BSSID, sizeof(BSSID));
+    scanResult.securityProtocol = FFS_DSS_WIFI_SECURITY_PROTOCOL_WPA_PSK;
+    scanResult.frequencyBand = 2412;
+
+    ASSERT_SUCCESS(ffsDssSerializeWifiScanResult(&scanResult, &outputStream));
+    ASSERT_TRUE(streamMatches(&outputStream, "{\"ssid\":\"\\\"ssid\\\"\",\"bssid\":\"00:11:22:AA:BB:CC\","
+            "\"securityProtocol\":\"WPA_PSK\",\"frequency\":2412}"));
+
+    // The source streams are left intact.
+    ASSERT_EQ(sizeof(BSSID), FFS_STREAM_DATA_SIZE(scanResult.bssidStream));
+    ASSERT_FALSE(ffsStreamIsEmpty(&scanResult.ssidStream));
+
+    // An undersized buffer fails.
+    FFS_TEMPORARY_OUTPUT_STREAM(smallStream, 16);
+    ASSERT_FAILURE(ffsDssSerializeWifiScanResult(&scanResult, &smallStream));
+}
@@ -24,7 +24,7 @@ extern "C" {
 
 // Static functions.
 static FFS_RESULT getWifiScanResultsCallback(struct FfsUserContext_s *userContext,
-        FfsDssWifiScanResult_t *dssWifiScanResult, void *callbackDataPointer);
+        struct FfsWifiProvisioneeScanList_s *scanList, void *callbackDataPointer);
 
 }
 
@@ -238,10 +238,10 @@ TEST_F(DssPostWifiScanDataTests, PostWifiScanData)
  * @returns Enumerated [result](@ref FFS_RESULT)
  */
 static FFS_RESULT getWifiScanResultsCallback(struct FfsUserContext_s *userContext,
-        FfsDssWifiScanResult_t *dssWifiScanResult, void *callbackDataPointer)
+        struct FfsWifiProvisioneeScanList_s *scanList, void *callbackDataPointer)
 {
     (void) userContext;
-    (void) dssWifiScanResult;
+    (void) scanList;
 
     FfsDssWifiScanResult_t scanResult;
     memset(&scanResult, 0, sizeof(scanResult));
@@ -0,0 +1,227 @@
+/** @file ffs_wifi_provisionee_checkpoint_tests.cpp
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/wifi_provisionee/ffs_wifi_provisionee_checkpoint.h"
+#include "helpers/test_utilities.h"
+
+#define TEST_CHECKPOINT_SESSION_ID      "7b0b5f1e-6f0a-4a7e-9d1c-2c5b3c1d9e8f"
+#define TEST_CHECKPOINT_SALT            "SALTSALT"
+#define TEST_CHECKPOINT_SSID            "HomeNetwork"
+#define TEST_CHECKPOINT_KEY             "password"
+#define TEST_CHECKPOINT_TOKEN           "registration-token"
+#define TEST_CHECKPOINT_CONFIG_KEY      "Locale"
+#define TEST_CHECKPOINT_CONFIG_VALUE    "en-US"
+#define TEST_CHECKPOINT_EXPIRATION      (1600000000000LL)
+
+/** @brief "Wi-Fi configuration matches" matcher.
+ */
+MATCHER(CheckpointWifiConfigurationMatches, "Wi-Fi configuration matches")
+{
+    return arg->securityProtocol == FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK
+            && !arg->isHiddenNetwork
+            && arraysAreEqual(FFS_STREAM_NEXT_READ(arg->ssidStream), FFS_STREAM_DATA_SIZE(arg->ssidStream),
+                    (const uint8_t *) TEST_CHECKPOINT_SSID, strlen(TEST_CHECKPOINT_SSID))
+            && arraysAreEqual(FFS_STREAM_NEXT_READ(arg->keyStream), FFS_STREAM_DATA_SIZE(arg->keyStream),
+                    (const uint8_t *) TEST_CHECKPOINT_KEY, strlen(TEST_CHECKPOINT_KEY));
+}
+
+/** @brief "Configuration value matches" matcher.
+ */
+MATCHER(CheckpointConfigurationValueMatches, "Configuration value matches")
+{
+    return arg->type == FFS_MAP_VALUE_TYPE_STRING
+            && arraysAreEqual(FFS_STREAM_NEXT_READ(arg->stringStream), FFS_STREAM_DATA_SIZE(arg->stringStream),
+                    (const uint8_t *) TEST_CHECKPOINT_CONFIG_VALUE, strlen(TEST_CHECKPOINT_CONFIG_VALUE));
+}
+
+/** @brief "Registration token matches" matcher.
+ */
+MATCHER(CheckpointRegistrationTokenMatches, "Registration token matches")
+{
+    return arg->expiration == TEST_CHECKPOINT_EXPIRATION
+            && arraysAreEqual(FFS_STREAM_NEXT_READ(arg->tokenStream), FFS_STREAM_DATA_SIZE(arg->tokenStream),
+                    (const uint8_t *) TEST_CHECKPOINT_TOKEN, strlen(TEST_CHECKPOINT_TOKEN));
+}
+
+class WifiProvisioneeCheckpointTests: public TestContextFixture {
+protected:
+    uint8_t itemsBuffer[FFS_WIFI_PROVISIONEE_CHECKPOINT_ITEMS_SIZE];
+    uint8_t recordBuffer[FFS_WIFI_PROVISIONEE_CHECKPOINT_MAXIMUM_SIZE];
+    FfsStream_t itemsStream;
+    FfsStream_t recordStream;
+
+    void SetUp() override
+    {
+        TestContextFixture::SetUp();
+        itemsStream = ffsCreateOutputStream(itemsBuffer, sizeof(itemsBuffer));
+        recordStream = ffsCreateOutputStream(recordBuffer, sizeof(recordBuffer));
+    }
+
+    /** @brief Log one item of each type.
+     */
+    void addItems()
+    {
+        FfsRegistrationRequest_t registrationRequest;
+        registrationRequest.tokenStream = FFS_STRING_INPUT_STREAM(TEST_CHECKPOINT_TOKEN);
+        registrationRequest.expiration = TEST_CHECKPOINT_EXPIRATION;
+        ASSERT_SUCCESS(ffsWifiProvisioneeCheckpointAddRegistrationToken(&itemsStream, &registrationRequest));
+
+        FfsMapValue_t value;
+        value.type = FFS_MAP_VALUE_TYPE_STRING;
+        value.stringStream = FFS_STRING_INPUT_STREAM(TEST_CHECKPOINT_CONFIG_VALUE);
+        ASSERT_SUCCESS(ffsWifiProvisioneeCheckpointAddConfigurationValue(&itemsStream, TEST_CHECKPOINT_CONFIG_KEY,
+                &value));
+
+        FfsWifiConfiguration_t wifiConfiguration;
+        wifiConfiguration.ssidStream = FFS_STRING_INPUT_STREAM(TEST_CHECKPOINT_SSID);
+        wifiConfiguration.keyStream = FFS_STRING_INPUT_STREAM(TEST_CHECKPOINT_KEY);
+        wifiConfiguration.securityProtocol = FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK;
+        wifiConfiguration.isHiddenNetwork = false;
+        wifiConfiguration.networkPriority = 0;
+        ASSERT_SUCCESS(ffsWifiProvisioneeCheckpointAddWifiConfiguration(&itemsStream, &wifiConfiguration));
+    }
+
+    /** @brief Encode a checkpoint with the logged items.
+     */
+    void encodeCheckpoint()
+    {
+        FfsWifiProvisioneeCheckpoint_t checkpoint;
+        checkpoint.state = FFS_WIFI_PROVISIONEE_STATE_GET_WIFI_LIST;
+        checkpoint.resumeCount = 1;
+        checkpoint.connectedToSocksNetwork = true;
+        checkpoint.sequenceNumber = 7;
+        checkpoint.sessionIdStream = FFS_STRING_INPUT_STREAM(TEST_CHECKPOINT_SESSION_ID);
+        checkpoint.saltStream = FFS_STRING_INPUT_STREAM(TEST_CHECKPOINT_SALT);
+        checkpoint.itemsStream = itemsStream;
+        ASSERT_SUCCESS(ffsEncodeWifiProvisioneeCheckpoint(&checkpoint, &recordStream));
+    }
+};
+
+/* @brief Test that a checkpoint survives an encode/decode round trip
+ */
+TEST_F(WifiProvisioneeCheckpointTests, RoundTrip)
+{
+    addItems();
+    encodeCheckpoint();
+
+    FfsWifiProvisioneeCheckpoint_t checkpoint;
+    ASSERT_SUCCESS(ffsDecodeWifiProvisioneeCheckpoint(&recordStream, &checkpoint));
+
+    ASSERT_TRUE(ffsStreamIsEmpty(&recordStream));
+    ASSERT_EQ(FFS_WIFI_PROVISIONEE_STATE_GET_WIFI_LIST, checkpoint.state);
+    ASSERT_EQ(1, checkpoint.resumeCount);
+    ASSERT_TRUE(checkpoint.connectedToSocksNetwork);
+    ASSERT_EQ(7, checkpoint.sequenceNumber);
+    ASSERT_STREAM_EQ_STRING(checkpoint.sessionIdStream, TEST_CHECKPOINT_SESSION_ID);
+    ASSERT_STREAM_EQ_STRING(checkpoint.saltStream, TEST_CHECKPOINT_SALT);
+    ASSERT_STREAM_EQ(checkpoint.itemsStream, itemsStream);
+}
+
+/* @brief Test that a corrupted record is rejected
+ */
+TEST_F(WifiProvisioneeCheckpointTests, CorruptedRecordIsRejected)
+{
+    addItems();
+    encodeCheckpoint();
+
+    FfsWifiProvisioneeCheckpoint_t checkpoint;
+    for (size_t index = 0; index < FFS_STREAM_DATA_SIZE(recordStream); index++) {
+        FfsStream_t corruptedStream = recordStream;
+        recordBuffer[index] ^= 0x20;
+        ASSERT_FAILURE(ffsDecodeWifiProvisioneeCheckpoint(&corruptedStream, &checkpoint)) << "byte " << index;
+        recordBuffer[index] ^= 0x20;
+    }
+
+    // The stream is left untouched.
+    ASSERT_SUCCESS(ffsDecodeWifiProvisioneeCheckpoint(&recordStream, &checkpoint));
+}
+
+/* @brief Test that a torn (truncated) record is rejected
+ */
+TEST_F(WifiProvisioneeCheckpointTests, TruncatedRecordIsRejected)
+{
+    addItems();
+    encodeCheckpoint();
+
+    FfsWifiProvisioneeCheckpoint_t checkpoint;
+    for (size_t size = 0; size < FFS_STREAM_DATA_SIZE(recordStream); size++) {
+        FfsStream_t truncatedStream = ffsCreateInputStream(recordBuffer, size);
+        ASSERT_FAILURE(ffsDecodeWifiProvisioneeCheckpoint(&truncatedStream, &checkpoint)) << "size " << size;
+    }
+}
+
+/* @brief Test the states a session is resumed from
+ */
+TEST_F(WifiProvisioneeCheckpointTests, ResumeStates)
+{
+    FFS_WIFI_PROVISIONEE_STATE resumeState;
+
+    ASSERT_FALSE(ffsGetWifiProvisioneeCheckpointResumeState(FFS_WIFI_PROVISIONEE_STATE_NOT_PROVISIONED,
+            &resumeState));
+    ASSERT_FALSE(ffsGetWifiProvisioneeCheckpointResumeState(FFS_WIFI_PROVISIONEE_STATE_START_PROVISIONING,
+            &resumeState));
+    ASSERT_FALSE(ffsGetWifiProvisioneeCheckpointResumeState(FFS_WIFI_PROVISIONEE_STATE_DONE, &resumeState));
+
+    ASSERT_TRUE(ffsGetWifiProvisioneeCheckpointResumeState(FFS_WIFI_PROVISIONEE_STATE_POST_WIFI_SCAN_DATA,
+            &resumeState));
+    ASSERT_EQ(FFS_WIFI_PROVISIONEE_STATE_POST_WIFI_SCAN_DATA, resumeState);
+
+    ASSERT_TRUE(ffsGetWifiProvisioneeCheckpointResumeState(FFS_WIFI_PROVISIONEE_STATE_CONNECTED_TO_USER_NETWORK,
+            &resumeState));
+    ASSERT_EQ(FFS_WIFI_PROVISIONEE_STATE_CONNECTING_TO_USER_NETWORK, resumeState);
+}
+
+/* @brief Test that the logged items are replayed in order
+ */
+TEST_F(WifiProvisioneeCheckpointTests, ReplayItems)
+{
+    addItems();
+
+    InSequence sequence;
+    EXPECT_COMPAT_CALL(ffsSetRegistrationToken(getUserContext(), CheckpointRegistrationTokenMatches()))
+            .WillOnce(Return(FFS_SUCCESS));
+    EXPECT_COMPAT_CALL(ffsSetConfigurationValue(getUserContext(), StrEq(TEST_CHECKPOINT_CONFIG_KEY),
+            CheckpointConfigurationValueMatches()))
+            .WillOnce(Return(FFS_SUCCESS));
+    EXPECT_COMPAT_CALL(ffsAddWifiConfiguration(getUserContext(), CheckpointWifiConfigurationMatches()))
+            .WillOnce(Return(FFS_SUCCESS));
+
+    const size_t itemsSize = FFS_STREAM_DATA_SIZE(itemsStream);
+    ASSERT_SUCCESS(ffsReplayWifiProvisioneeCheckpointItems(getUserContext(), &itemsStream));
+    ASSERT_EQ(itemsSize, FFS_STREAM_DATA_SIZE(itemsStream));
+}
+
+/* @brief Test that a full item log is not partially written
+ */
+TEST_F(WifiProvisioneeCheckpointTests, ItemLogOverrun)
+{
+    FfsMapValue_t value;
+    value.type = FFS_MAP_VALUE_TYPE_STRING;
+    value.stringStream = FFS_STRING_INPUT_STREAM(TEST_CHECKPOINT_CONFIG_VALUE);
+
+    FFS_RESULT result;
+    size_t itemsSize;
+    do {
+        itemsSize = FFS_STREAM_DATA_SIZE(itemsStream);
+        result = ffsWifiProvisioneeCheckpointAddConfigurationValue(&itemsStream, TEST_CHECKPOINT_CONFIG_KEY, &value);
+    } while (result == FFS_SUCCESS);
+
+    ASSERT_EQ(FFS_OVERRUN, result);
+    ASSERT_EQ(itemsSize, FFS_STREAM_DATA_SIZE(itemsStream));
+
+    // The log still decodes.
+    encodeCheckpoint();
+    FfsWifiProvisioneeCheckpoint_t checkpoint;
+    ASSERT_SUCCESS(ffsDecodeWifiProvisioneeCheckpoint(&recordStream, &checkpoint));
+}
@@ -0,0 +1,252 @@
+/** @file ffs_wifi_provisionee_encoded_setup_network_tests.cpp
+ *
+ * @copyright 2020 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "constants/test_constants.h"
+#include "helpers/test_utilities.h"
+#include "ffs/wifi_provisionee/ffs_wifi_provisionee_encoded_setup_network.h"
+
+#include <vector>
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Invoke;
+using ::testing::Return;
+using ::testing::StrEq;
+
+#define TEST_SSID_BUFFER_SIZE           (33)
+#define TEST_PASSPHRASE_BUFFER_SIZE     (64)
+
+/** @brief Stored cache bytes, written by the mocked configuration map.
+ */
+static std::vector<uint8_t> storedCache;
+
+/** @brief Store the cache value set by the library.
+ */
+static FFS_RESULT storeCache(struct FfsUserContext_s *userContext, const char *key, FfsMapValue_t *value)
+{
+    (void) userContext;
+    (void) key;
+    storedCache.assign(FFS_STREAM_NEXT_READ(value->bytesStream),
+            FFS_STREAM_NEXT_READ(value->bytesStream) + FFS_STREAM_DATA_SIZE(value->bytesStream));
+    return FFS_SUCCESS;
+}
+
+/** @brief Return the stored cache value.
+ */
+static FFS_RESULT loadCache(struct FfsUserContext_s *userContext, const char *key, FfsMapValue_t *value)
+{
+    (void) userContext;
+    (void) key;
+    value->type = FFS_MAP_VALUE_TYPE_BYTES;
+    return ffsWriteStream(storedCache.data(), storedCache.size(), &value->bytesStream);
+}
+
+class EncodedSetupNetworkTests: public TestContextFixture {
+public:
+    void SetUp()
+    {
+        TestContextFixture::SetUp();
+        storedCache.clear();
+    }
+
+    /** @brief Expect the device and cloud public key reads.
+     */
+    void expectPublicKeys(FfsStream_t devicePublicKeyStream, FfsStream_t cloudPublicKeyStream)
+    {
+        EXPECT_COMPAT_CALL(ffsGetConfigurationValue(getUserContext(),
+                StrEq(FFS_CONFIGURATION_ENTRY_KEY_DEVICE_EC_PUBLIC_KEY_DER), _))
+                .WillOnce(DoAll(WriteByteStreamToMapValueArgPointee<2>(devicePublicKeyStream), Return(FFS_SUCCESS)));
+        EXPECT_COMPAT_CALL(ffsGetConfigurationValue(getUserContext(),
+                StrEq(FFS_CONFIGURATION_ENTRY_KEY_CLOUD_EC_PUBLIC_KEY_DER), _))
+                .WillOnce(DoAll(WriteByteStreamToMapValueArgPointee<2>(cloudPublicKeyStream), Return(FFS_SUCCESS)));
+    }
+
+    /** @brief Expect the hash and ECDH computations.
+     */
+    void expectComputation(FfsStream_t hashStream, FfsStream_t sharedSecretStream)
+    {
+        EXPECT_COMPAT_CALL(ffsSha256(getUserContext(), _, _))
+                .WillOnce(DoAll(WriteStreamToArgPointee<2>(hashStream), Return(FFS_SUCCESS)));
+        EXPECT_COMPAT_CALL(ffsComputeECDHKey(getUserContext(), _, _))
+                .WillOnce(DoAll(WriteStreamToArgPointee<2>(sharedSecretStream), Return(FFS_SUCCESS)));
+    }
+};
+
+/** @brief Test that a cache miss computes the key material and stores it.
+ */
+TEST_F(EncodedSetupNetworkTests, CacheMissComputesAndStores)
+{
+    FFS_LITERAL_INPUT_STREAM(publicKeyStream, TEST_PUBLIC_KEY_DER_BYTES);
+    FFS_LITERAL_INPUT_STREAM(hashStream, TEST_HASH_BYTES);
+    FFS_LITERAL_INPUT_STREAM(sharedSecretStream, TEST_HASH_BYTES);
+
+    expectPublicKeys(publicKeyStream, publicKeyStream);
+    EXPECT_COMPAT_CALL(ffsGetConfigurationValue(getUserContext(),
+            StrEq(FFS_CONFIGURATION_ENTRY_KEY_ENCODED_SETUP_NETWORK_CACHE), _))
+            .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+    expectComputation(hashStream, sharedSecretStream);
+    EXPECT_COMPAT_CALL(ffsSetConfigurationValue(getUserContext(),
+            StrEq(FFS_CONFIGURATION_ENTRY_KEY_ENCODED_SETUP_NETWORK_CACHE), _))
+            .WillOnce(Invoke(storeCache));
+
+    FfsEncodedSetupNetworkCache_t cache;
+    ASSERT_SUCCESS(ffsPrepareAmazonCustomEncodedNetworkCache(getUserContext(), &cache));
+
+    // The auth material index is the last 9 bytes of the hash.
+    const uint8_t hash[] = TEST_HASH_BYTES;
+    ASSERT_TRUE(arraysAreEqual(cache.authMaterialIndex, sizeof(cache.authMaterialIndex),
+            hash + sizeof(hash) - sizeof(cache.authMaterialIndex), sizeof(cache.authMaterialIndex)));
+    ASSERT_TRUE(arraysAreEqual(cache.sharedSecret, sizeof(cache.sharedSecret), hash, sizeof(hash)));
+
+    ASSERT_EQ(storedCache.size(), (size_t) FFS_ENCODED_SETUP_NETWORK_CACHE_SIZE);
+    ASSERT_EQ(storedCache[0], FFS_ENCODED_SETUP_NETWORK_CACHE_VERSION);
+    ASSERT_TRUE(arraysAreEqual(&storedCache[1], sizeof(cache.fingerprint),
+            cache.fingerprint, sizeof(cache.fingerprint)));
+
+    // A cache serialized off the device matches the stored one.
+    FFS_TEMPORARY_OUTPUT_STREAM(encodedCacheStream, FFS_ENCODED_SETUP_NETWORK_CACHE_SIZE);
+    ASSERT_SUCCESS(ffsEncodeAmazonCustomEncodedNetworkCache(&cache, &encodedCacheStream));
+    ASSERT_TRUE(arraysAreEqual(FFS_STREAM_NEXT_READ(encodedCacheStream), FFS_STREAM_DATA_SIZE(encodedCacheStream),
+            storedCache.data(), storedCache.size()));
+}
+
+/** @brief Test that a valid cache skips the hash and ECDH computations.
+ */
+TEST_F(EncodedSetupNetworkTests, CacheHitSkipsComputation)
+{
+    FFS_LITERAL_INPUT_STREAM(publicKeyStream, TEST_PUBLIC_KEY_DER_BYTES);
+    FFS_LITERAL_INPUT_STREAM(hashStream, TEST_HASH_BYTES);
+    FFS_LITERAL_INPUT_STREAM(sharedSecretStream, TEST_HASH_BYTES);
+
+    // Populate the cache.
+    expectPublicKeys(publicKeyStream, publicKeyStream);
+    EXPECT_COMPAT_CALL(ffsGetConfigurationValue(getUserContext(),
+            StrEq(FFS_CONFIGURATION_ENTRY_KEY_ENCODED_SETUP_NETWORK_CACHE), _))
+            .WillOnce(Return(FFS_NOT_IMPLEMENTED))
+            .WillOnce(Invoke(loadCache));
+    expectComputation(hashStream, sharedSecretStream);
+    EXPECT_COMPAT_CALL(ffsSetConfigurationValue(getUserContext(),
+            StrEq(FFS_CONFIGURATION_ENTRY_KEY_ENCODED_SETUP_NETWORK_CACHE), _))
+            .WillOnce(Invoke(storeCache));
+
+    FfsEncodedSetupNetworkCache_t computedCache;
+    ASSERT_SUCCESS(ffsPrepareAmazonCustomEncodedNetworkCache(getUserContext(), &computedCache));
+
+    // The strict mock fails on a second hash or ECDH.
+    expectPublicKeys(publicKeyStream, publicKeyStream);
+    FfsEncodedSetupNetworkCache_t cachedCache;
+    ASSERT_SUCCESS(ffsPrepareAmazonCustomEncodedNetworkCache(getUserContext(), &cachedCache));
+    ASSERT_EQ(memcmp(&computedCache, &cachedCache, sizeof(computedCache)), 0);
+}
+
+/** @brief Test that a cache made for other key material is recomputed.
+ */
+TEST_F(EncodedSetupNetworkTests, FingerprintMismatchRecomputes)
+{
+    FFS_LITERAL_INPUT_STREAM(publicKeyStream, TEST_PUBLIC_KEY_DER_BYTES);
+    FFS_LITERAL_INPUT_STREAM(otherPublicKeyStream, TEST_HASH_BYTES);
+    FFS_LITERAL_INPUT_STREAM(hashStream, TEST_HASH_BYTES);
+    FFS_LITERAL_INPUT_STREAM(sharedSecretStream, TEST_HASH_BYTES);
+    FFS_LITERAL_INPUT_STREAM(otherHashStream, TEST_HASH_BYTES);
+    FFS_LITERAL_INPUT_STREAM(otherSharedSecretStream, TEST_HASH_BYTES);
+
+    // Cache made with another cloud public key.
+    expectPublicKeys(publicKeyStream, otherPublicKeyStream);
+    EXPECT_COMPAT_CALL(ffsGetConfigurationValue(getUserContext(),
+            StrEq(FFS_CONFIGURATION_ENTRY_KEY_ENCODED_SETUP_NETWORK_CACHE), _))
+            .WillOnce(Return(FFS_NOT_IMPLEMENTED))
+            .WillOnce(Invoke(loadCache));
+    EXPECT_COMPAT_CALL(ffsSha256(getUserContext(), _, _))
+            .WillOnce(DoAll(WriteStreamToArgPointee<2>(hashStream), Return(FFS_SUCCESS)))
+            .WillOnce(DoAll(WriteStreamToArgPointee<2>(otherHashStream), Return(FFS_SUCCESS)));
+    EXPECT_COMPAT_CALL(ffsComputeECDHKey(getUserContext(), _, _))
+            .WillOnce(DoAll(WriteStreamToArgPointee<2>(sharedSecretStream), Return(FFS_SUCCESS)))
+            .WillOnce(DoAll(WriteStreamToArgPointee<2>(otherSharedSecretStream), Return(FFS_SUCCESS)));
+    EXPECT_COMPAT_CALL(ffsSetConfigurationValue(getUserContext(),
+            StrEq(FFS_CONFIGURATION_ENTRY_KEY_ENCODED_SETUP_NETWORK_CACHE), _))
+            .Times(2)
+            .WillRepeatedly(Invoke(storeCache));
+
+    FfsEncodedSetupNetworkCache_t staleCache;
+    ASSERT_SUCCESS(ffsPrepareAmazonCustomEncodedNetworkCache(getUserContext(), &staleCache));
+
+    expectPublicKeys(publicKeyStream, publicKeyStream);
+    FfsEncodedSetupNetworkCache_t cache;
+    ASSERT_SUCCESS(ffsPrepareAmazonCustomEncodedNetworkCache(getUserContext(), &cache));
+    ASSERT_NE(memcmp(staleCache.fingerprint, cache.fingerprint, sizeof(cache.fingerprint)), 0);
+    ASSERT_TRUE(arraysAreEqual(&storedCache[1], sizeof(cache.fingerprint),
+            cache.fingerprint, sizeof(cache.fingerprint)));
+}
+
+/** @brief Test that an invalid stored cache is recomputed.
+ */
+TEST_F(EncodedSetupNetworkTests, InvalidCacheRecomputes)
+{
+    FFS_LITERAL_INPUT_STREAM(publicKeyStream, TEST_PUBLIC_KEY_DER_BYTES);
+    FFS_LITERAL_INPUT_STREAM(hashStream, TEST_HASH_BYTES);
+    FFS_LITERAL_INPUT_STREAM(sharedSecretStream, TEST_HASH_BYTES);
+
+    // Truncated cache.
+    storedCache.assign(FFS_ENCODED_SETUP_NETWORK_CACHE_SIZE - 1, 0);
+    storedCache[0] = FFS_ENCODED_SETUP_NETWORK_CACHE_VERSION;
+
+    expectPublicKeys(publicKeyStream, publicKeyStream);
+    EXPECT_COMPAT_CALL(ffsGetConfigurationValue(getUserContext(),
+            StrEq(FFS_CONFIGURATION_ENTRY_KEY_ENCODED_SETUP_NETWORK_CACHE), _))
+            .WillOnce(Invoke(loadCache));
+    expectComputation(hashStream, sharedSecretStream);
+    EXPECT_COMPAT_CALL(ffsSetConfigurationValue(getUserContext(),
+            StrEq(FFS_CONFIGURATION_ENTRY_KEY_ENCODED_SETUP_NETWORK_CACHE), _))
+            .WillOnce(Invoke(storeCache));
+
+    FfsEncodedSetupNetworkCache_t cache;
+    ASSERT_SUCCESS(ffsPrepareAmazonCustomEncodedNetworkCache(getUserContext(), &cache));
+    ASSERT_EQ(storedCache.size(), (size_t) FFS_ENCODED_SETUP_NETWORK_CACHE_SIZE);
+}
+
+/** @brief Test that the configuration from a cache only computes the nonce-dependent part.
+ */
+TEST_F(EncodedSetupNetworkTests, ConfigurationFromCache)
+{
+    FFS_LITERAL_INPUT_STREAM(nonceStream, TEST_12_BYTE_NONCE);
+    FFS_LITERAL_INPUT_STREAM(hmacStream, TEST_HASH_BYTES);
+    FFS_LITERAL_INPUT_STREAM(productIndexStream, { 0x11, 0x22, 0x33, 0x44 });
+
+    FfsEncodedSetupNetworkCache_t cache;
+    memset(&cache, 0x5a, sizeof(cache));
+    FfsStream_t sharedSecretStream = ffsCreateInputStream(cache.sharedSecret, sizeof(cache.sharedSecret));
+
+    EXPECT_COMPAT_CALL(ffsRandomBytes(getUserContext(), PointeeSpaceIsSizeOf(nonceStream)))
+            .WillOnce(DoAll(WriteStreamToArgPointee<1>(nonceStream), Return(FFS_SUCCESS)));
+    EXPECT_COMPAT_CALL(ffsGetConfigurationValue(getUserContext(),
+            StrEq(FFS_CONFIGURATION_ENTRY_KEY_PRODUCT_INDEX), _))
+            .WillOnce(DoAll(WriteStringStreamToMapValueArgPointee<2>(productIndexStream), Return(FFS_SUCCESS)));
+    EXPECT_COMPAT_CALL(ffsComputeHMACSHA256(getUserContext(), PointeeStreamEq(sharedSecretStream),
+            PointeeStreamEq(nonceStream), _))
+            .WillOnce(DoAll(WriteStreamToArgPointee<3>(hmacStream), Return(FFS_SUCCESS)));
+
+    FFS_TEMPORARY_OUTPUT_STREAM(ssidStream, TEST_SSID_BUFFER_SIZE);
+    FFS_TEMPORARY_OUTPUT_STREAM(keyStream, TEST_PASSPHRASE_BUFFER_SIZE);
+    FfsWifiConfiguration_t configuration;
+    configuration.ssidStream = ssidStream;
+    configuration.keyStream = keyStream;
+    ASSERT_SUCCESS(ffsComputeAmazonCustomEncodedNetworkConfigurationFromCache(getUserContext(), &cache,
+            &configuration));
+
+    // 2 base64 characters and 30 base85 characters.
+    ASSERT_EQ(FFS_STREAM_DATA_SIZE(configuration.ssidStream), (size_t) 32);
+    ASSERT_EQ(FFS_STREAM_DATA_SIZE(configuration.keyStream), (size_t) 44);
+    ASSERT_TRUE(configuration.isHiddenNetwork);
+    ASSERT_EQ(configuration.securityProtocol, FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK);
+}
@@ -0,0 +1,181 @@
+/** @file ffs_wifi_provisionee_scan_list_tests.cpp
+ *
+ * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * This file is a Modifiable File, as defined in the accompanying LICENSE.TXT
+ * file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */
+
+#include "ffs/wifi_provisionee/ffs_wifi_provisionee_scan_list.h"
+#include "helpers/test_utilities.h"
+
+/** @brief Add a scan result with a single-byte BSSID pattern.
+ */
+static FFS_RESULT addScanResult(FfsWifiProvisioneeScanList_t *scanList, const char *ssid,
+        FFS_WIFI_SECURITY_PROTOCOL securityProtocol, uint8_t bssidByte, int32_t frequencyBand,
+        int32_t signalStrength)
+{
+    uint8_t bssid[FFS_BSSID_SIZE];
+    memset(bssid, bssidByte, sizeof(bssid));
+
+    FfsWifiScanResult_t wifiScanResult;
+    wifiScanResult.ssidStream = ffsCreateInputStream((uint8_t *) ssid, strlen(ssid));
+    wifiScanResult.bssidStream = FFS_STATIC_INPUT_STREAM(bssid);
+    wifiScanResult.securityProtocol = securityProtocol;
+    wifiScanResult.frequencyBand = frequencyBand;
+    wifiScanResult.signalStrength = signalStrength;
+
+    return ffsWifiProvisioneeScanListAdd(scanList, &wifiScanResult);
+}
+
+/* @brief Test that access points of the same network are merged
+ */
+TEST(WifiProvisioneeScanListTests, DuplicatesAreMerged)
+{
+    FfsWifiProvisioneeScanListEntry_t entries[4];
+    FfsWifiProvisioneeScanList_t scanList;
+    ASSERT_SUCCESS(ffsInitializeWifiProvisioneeScanList(&scanList, entries, 4));
+
+    ASSERT_SUCCESS(addScanResult(&scanList, "HOME", FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK, 0x11, 2412, -70));
+    ASSERT_SUCCESS(addScanResult(&scanList, "HOME", FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK, 0x22, 5180, -50));
+    ASSERT_SUCCESS(addScanResult(&scanList, "HOME", FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK, 0x33, 2437, -80));
+
+    // Same SSID with a different security protocol is a different network.
+    ASSERT_SUCCESS(addScanResult(&scanList, "HOME", FFS_WIFI_SECURITY_PROTOCOL_NONE, 0x44, 2412, -60));
+
+    ASSERT_SUCCESS(ffsWifiProvisioneeScanListRank(&scanList));
+    ASSERT_EQ(scanList.count, (size_t) 2);
+    ASSERT_EQ(scanList.duplicateCount, 2u);
+
+    FfsWifiScanResult_t wifiScanResult;
+    bool isUnderrun = true;
+    ASSERT_SUCCESS(ffsWifiProvisioneeScanListPeek(&scanList, &wifiScanResult, &isUnderrun));
+    ASSERT_FALSE(isUnderrun);
+    ASSERT_STREAM_EQ_STRING(wifiScanResult.ssidStream, "HOME");
+    ASSERT_EQ(wifiScanResult.securityProtocol, FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK);
+    ASSERT_EQ(wifiScanResult.signalStrength, -50);
+    ASSERT_EQ(wifiScanResult.frequencyBand, 5180);
+    ASSERT_EQ(FFS_STREAM_NEXT_READ(wifiScanResult.bssidStream)[0], 0x22);
+    ASSERT_EQ(entries[0].bssidCount, 3u);
+}
+
+/* @brief Test ranking by signal strength with a bonus for secured networks
+ */
+TEST(WifiProvisioneeScanListTests, RankBySignalAndSecurity)
+{
+    FfsWifiProvisioneeScanListEntry_t entries[8];
+    FfsWifiProvisioneeScanList_t scanList;
+    ASSERT_SUCCESS(ffsInitializeWifiProvisioneeScanList(&scanList, entries, 8));
+
+    ASSERT_SUCCESS(addScanResult(&scanList, "WEAK_WPA", FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK, 0x01, 1, -85));
+    ASSERT_SUCCESS(addScanResult(&scanList, "OPEN", FFS_WIFI_SECURITY_PROTOCOL_NONE, 0x02, 1, -55));
+    ASSERT_SUCCESS(addScanResult(&scanList, "WPA", FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK, 0x03, 1, -60));
+    ASSERT_SUCCESS(addScanResult(&scanList, "WEP", FFS_WIFI_SECURITY_PROTOCOL_WEP, 0x04, 1, -70));
+
+    ASSERT_SUCCESS(ffsWifiProvisioneeScanListRank(&scanList));
+
+    const char *EXPECTED_ORDER[] = { "WPA", "OPEN", "WEP", "WEAK_WPA" };
+    for (size_t i = 0; i < sizeof(EXPECTED_ORDER) / sizeof(EXPECTED_ORDER[0]); i++) {
+        FfsWifiScanResult_t wifiScanResult;
+        bool isUnderrun = true;
+        ASSERT_SUCCESS(ffsWifiProvisioneeScanListPeek(&scanList, &wifiScanResult, &isUnderrun));
+        ASSERT_FALSE(isUnderrun);
+        ASSERT_STREAM_EQ_STRING(wifiScanResult.ssidStream, EXPECTED_ORDER[i]);
+        ASSERT_SUCCESS(ffsWifiProvisioneeScanListAdvance(&scanList));
+    }
+
+    FfsWifiScanResult_t wifiScanResult;
+    bool isUnderrun = false;
+    ASSERT_SUCCESS(ffsWifiProvisioneeScanListPeek(&scanList, &wifiScanResult, &isUnderrun));
+    ASSERT_TRUE(isUnderrun);
+    ASSERT_EQ(ffsWifiProvisioneeScanListAdvance(&scanList), FFS_UNDERRUN);
+}
+
+/* @brief Test that the whole scan set is deduplicated and ranked before the first page
+ */
+TEST(WifiProvisioneeScanListTests, WholeScanSetIsRanked)
+{
+    FfsWifiProvisioneeScanListEntry_t entries[FFS_WIFI_PROVISIONEE_SCAN_LIST_CAPACITY];
+    FfsWifiProvisioneeScanList_t scanList;
+    ASSERT_SUCCESS(ffsInitializeWifiProvisioneeScanList(&scanList, entries,
+            FFS_WIFI_PROVISIONEE_SCAN_LIST_CAPACITY));
+
+    // Twenty weak networks, with the home network seen at both ends of the scan.
+    ASSERT_SUCCESS(addScanResult(&scanList, "HOME", FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK, 0x01, 1, -75));
+    for (int i = 0; i < 20; i++) {
+        char ssid[8];
+        snprintf(ssid, sizeof(ssid), "NET%d", i);
+        ASSERT_SUCCESS(addScanResult(&scanList, ssid, FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK, 0x02, 1, -90 + i));
+    }
+    ASSERT_SUCCESS(addScanResult(&scanList, "HOME", FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK, 0x03, 1, -40));
+    ASSERT_SUCCESS(addScanResult(&scanList, "STRONG", FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK, 0x04, 1, -45));
+
+    ASSERT_SUCCESS(ffsWifiProvisioneeScanListRank(&scanList));
+    ASSERT_EQ(scanList.count, (size_t) 22);
+    ASSERT_EQ(scanList.duplicateCount, 1u);
+    ASSERT_EQ(scanList.droppedCount, 0u);
+
+    // The strongest networks come first, however late they were scanned.
+    FfsWifiScanResult_t wifiScanResult;
+    bool isUnderrun = true;
+    ASSERT_SUCCESS(ffsWifiProvisioneeScanListPeek(&scanList, &wifiScanResult, &isUnderrun));
+    ASSERT_FALSE(isUnderrun);
+    ASSERT_STREAM_EQ_STRING(wifiScanResult.ssidStream, "HOME");
+    ASSERT_EQ(wifiScanResult.signalStrength, -40);
+    ASSERT_SUCCESS(ffsWifiProvisioneeScanListAdvance(&scanList));
+    ASSERT_SUCCESS(ffsWifiProvisioneeScanListPeek(&scanList, &wifiScanResult, &isUnderrun));
+    ASSERT_STREAM_EQ_STRING(wifiScanResult.ssidStream, "STRONG");
+
+    // Every network is posted once.
+    size_t postedCount = 1;
+    for (;;) {
+        ASSERT_SUCCESS(ffsWifiProvisioneeScanListPeek(&scanList, &wifiScanResult, &isUnderrun));
+        if (isUnderrun) {
+            break;
+        }
+        ASSERT_FALSE(ffsStreamMatchesString(&wifiScanResult.ssidStream, "HOME"));
+        ASSERT_SUCCESS(ffsWifiProvisioneeScanListAdvance(&scanList));
+        postedCount++;
+    }
+    ASSERT_EQ(postedCount, (size_t) 22);
+}
+
+/* @brief Test that a full list keeps the highest-ranked networks
+ */
+TEST(WifiProvisioneeScanListTests, FullListDropsLowestRanked)
+{
+    FfsWifiProvisioneeScanListEntry_t entries[2];
+    FfsWifiProvisioneeScanList_t scanList;
+    ASSERT_SUCCESS(ffsInitializeWifiProvisioneeScanList(&scanList, entries, 2));
+
+    ASSERT_SUCCESS(addScanResult(&scanList, "A", FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK, 0x01, 1, -80));
+    ASSERT_SUCCESS(addScanResult(&scanList, "B", FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK, 0x02, 1, -60));
+
+    // A weaker network is dropped; a stronger one replaces the weakest entry.
+    ASSERT_SUCCESS(addScanResult(&scanList, "C", FFS_WIFI_SECURITY_PROTOCOL_NONE, 0x03, 1, -85));
+    ASSERT_SUCCESS(addScanResult(&scanList, "D", FFS_WIFI_SECURITY_PROTOCOL_OTHER, 0x04, 1, -45));
+
+    // Duplicates are still merged into a full list.
+    ASSERT_SUCCESS(addScanResult(&scanList, "B", FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK, 0x05, 1, -70));
+
+    ASSERT_SUCCESS(ffsWifiProvisioneeScanListRank(&scanList));
+    ASSERT_EQ(scanList.count, (size_t) 2);
+    ASSERT_EQ(scanList.droppedCount, 2u);
+    ASSERT_EQ(scanList.duplicateCount, 1u);
+
+    FfsWifiScanResult_t wifiScanResult;
+    bool isUnderrun = true;
+    ASSERT_SUCCESS(ffsWifiProvisioneeScanListPeek(&scanList, &wifiScanResult, &isUnderrun));
+    ASSERT_STREAM_EQ_STRING(wifiScanResult.ssidStream, "D");
+    ASSERT_EQ(wifiScanResult.securityProtocol, FFS_WIFI_SECURITY_PROTOCOL_OTHER);
+    ASSERT_SUCCESS(ffsWifiProvisioneeScanListAdvance(&scanList));
+    ASSERT_SUCCESS(ffsWifiProvisioneeScanListPeek(&scanList, &wifiScanResult, &isUnderrun));
+    ASSERT_STREAM_EQ_STRING(wifiScanResult.ssidStream, "B");
+    ASSERT_EQ(wifiScanResult.signalStrength, -60);
+}
@@ -14,8 +14,11 @@
 
 #include "constants/test_constants.h"
 #include "helpers/test_utilities.h"
+#include "ffs/wifi_provisionee/ffs_wifi_provisionee_checkpoint.h"
 #include "ffs/wifi_provisionee/ffs_wifi_provisionee_task.h"
 
+#include <vector>
+
 /** @brief "Public key matches" matcher.
  */
 MATCHER_P(PublicKeyMatches, sourcePublicKey, "Salted PIN matches")
@@ -246,6 +249,43 @@ static void sendConnectedToUserNetworkReportBody(struct FfsUserContext_s *userCo
     callbacks.handleBody(&bodyStream, callbackDataPointer);
 }
 
+/** @brief SSID stored in the single network slot of the Wi-Fi mock.
+ */
+static std::string sWifiSlotSsid;
+
+/** @brief SSIDs of the connection attempts of the Wi-Fi mock.
+ */
+static std::vector<std::string> sConnectedSsids;
+
+/** @brief Store a network in the single slot, replacing the stored one.
+ */
+static FFS_RESULT addWifiConfigurationToSingleSlot(struct FfsUserContext_s *userContext,
+        FfsWifiConfiguration_t *wifiConfiguration) {
+    (void) userContext;
+    sWifiSlotSsid.assign((const char *) FFS_STREAM_NEXT_READ(wifiConfiguration->ssidStream),
+            FFS_STREAM_DATA_SIZE(wifiConfiguration->ssidStream));
+    return FFS_SUCCESS;
+}
+
+/** @brief Clear the single slot if it holds the network.
+ */
+static FFS_RESULT removeWifiConfigurationFromSingleSlot(struct FfsUserContext_s *userContext,
+        FfsStream_t ssidStream) {
+    (void) userContext;
+    if (ffsStreamMatchesString(&ssidStream, sWifiSlotSsid.c_str())) {
+        sWifiSlotSsid.clear();
+    }
+    return FFS_SUCCESS;
+}
+
+/** @brief Connect to the network in the single slot.
+ */
+static FFS_RESULT connectToSingleSlotWifi(struct FfsUserContext_s *userContext) {
+    (void) userContext;
+    sConnectedSsids.push_back(sWifiSlotSsid);
+    return FFS_SUCCESS;
+}
+
 TEST_F(TaskTests, TaskSuccessWithEncodedSSID)
 {
     // Provisionee state.
@@ -259,6 +299,15 @@ TEST_F(TaskTests, TaskSuccessWithEncodedSSID)
             .Times(10) //!< Expect to handle 10 states.
             .WillRepeatedly(DoAll(SetArgPointee<1>(true), Return(FFS_SUCCESS)));
 
+    // No checkpoint to resume; checkpoint the states after the session starts, clear it when done.
+    EXPECT_COMPAT_CALL(ffsLoadWifiProvisioneeCheckpoint(getUserContext(), _))
+            .WillOnce(Return(FFS_SUCCESS));
+    EXPECT_COMPAT_CALL(ffsSaveWifiProvisioneeCheckpoint(getUserContext(), _))
+            .Times(6) //!< 'START_PIN_BASED_SETUP' through 'CONNECTED_TO_USER_NETWORK'.
+            .WillRepeatedly(Return(FFS_SUCCESS));
+    EXPECT_COMPAT_CALL(ffsClearWifiProvisioneeCheckpoint(getUserContext()))
+            .WillOnce(Return(FFS_SUCCESS));
+
     // Mock 'ffsDssClientGetBuffers'.
     FFS_TEMPORARY_OUTPUT_STREAM(hostStream, DSS_HOST_BUFFER_SIZE);
     FFS_TEMPORARY_OUTPUT_STREAM(sessionIdStream, DSS_SESSION_ID_BUFFER_SIZE);
@@ -305,6 +354,14 @@ TEST_F(TaskTests, TaskSuccessWithEncodedSSID)
             StrEq(FFS_CONFIGURATION_ENTRY_KEY_CLOUD_EC_PUBLIC_KEY_DER), _))
             .WillOnce(DoAll(WriteByteStreamToMapValueArgPointee<2>(testPublicKeyStream), Return(FFS_SUCCESS)));
 
+    // No stored encoded setup network cache.
+    EXPECT_COMPAT_CALL(ffsGetConfigurationValue(getUserContext(),
+            StrEq(FFS_CONFIGURATION_ENTRY_KEY_ENCODED_SETUP_NETWORK_CACHE), _))
+            .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+    EXPECT_COMPAT_CALL(ffsSetConfigurationValue(getUserContext(),
+            StrEq(FFS_CONFIGURATION_ENTRY_KEY_ENCODED_SETUP_NETWORK_CACHE), _))
+            .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+
     // Mock ECDH shared secret.
     EXPECT_COMPAT_CALL(ffsComputeECDHKey(getUserContext(), PointeeStreamEq(testPublicKeyStream), PointeeSpaceIsSizeOf(testHashedPublicKeyStream)))
             .WillOnce(DoAll(WriteStreamToArgPointee<2>(testHashedPublicKeyStream), Return(FFS_SUCCESS)));
@@ -520,6 +577,10 @@ TEST_F(TaskTests, TaskCloudCannotProceed)
             .Times(3) //!< Expect to handle 3 states.
             .WillRepeatedly(DoAll(SetArgPointee<1>(true), Return(FFS_SUCCESS)));
 
+    // Checkpoints not supported.
+    EXPECT_COMPAT_CALL(ffsLoadWifiProvisioneeCheckpoint(getUserContext(), _))
+            .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+
     // Mock 'ffsDssClientGetBuffers'.
     FFS_TEMPORARY_OUTPUT_STREAM(hostStream, DSS_HOST_BUFFER_SIZE);
     FFS_TEMPORARY_OUTPUT_STREAM(sessionIdStream, DSS_SESSION_ID_BUFFER_SIZE);
@@ -596,6 +657,10 @@ TEST_F(TaskTests, TaskClientCannotProceed)
             .WillOnce(DoAll(SetArgPointee<1>(true), Return(FFS_SUCCESS))) // !< Execute one states.
             .WillOnce(DoAll(SetArgPointee<1>(false), Return(FFS_SUCCESS)));
 
+    // Checkpoints not supported.
+    EXPECT_COMPAT_CALL(ffsLoadWifiProvisioneeCheckpoint(getUserContext(), _))
+            .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+
     // Mock 'ffsDssClientGetBuffers'.
     FFS_TEMPORARY_OUTPUT_STREAM(hostStream, DSS_HOST_BUFFER_SIZE);
     FFS_TEMPORARY_OUTPUT_STREAM(sessionIdStream, DSS_SESSION_ID_BUFFER_SIZE);
@@ -636,6 +701,220 @@ TEST_F(TaskTests, TaskClientCannotProceed)
     ASSERT_SUCCESS(ffsWifiProvisioneeTask(getUserContext()));
 }
 
+TEST_F(TaskTests, StepOneTransitionAtATime)
+{
+    // Provisionee state.
+    FFS_WIFI_PROVISIONEE_STATE state;
+    EXPECT_COMPAT_CALL(ffsGetWifiProvisioneeState(getUserContext(), _))
+            .Times(3) //!< Expect to handle 3 states.
+            .WillRepeatedly(DoAll(SetArgPointee<1>(ByRef(state)), Return(FFS_SUCCESS)));
+
+    // Mock 'ffsWifiProvisioneeCanProceed'.
+    EXPECT_COMPAT_CALL(ffsWifiProvisioneeCanProceed(getUserContext(), _))
+            .Times(3) //!< Expect to handle 3 states.
+            .WillRepeatedly(DoAll(SetArgPointee<1>(true), Return(FFS_SUCCESS)));
+
+    // Checkpoints not supported.
+    EXPECT_COMPAT_CALL(ffsLoadWifiProvisioneeCheckpoint(getUserContext(), _))
+            .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+
+    // Mock 'ffsDssClientGetBuffers'.
+    FFS_TEMPORARY_OUTPUT_STREAM(hostStream, DSS_HOST_BUFFER_SIZE);
+    FFS_TEMPORARY_OUTPUT_STREAM(sessionIdStream, DSS_SESSION_ID_BUFFER_SIZE);
+    FFS_TEMPORARY_OUTPUT_STREAM(nonceStream, DSS_NONCE_BUFFER_SIZE);
+    FFS_TEMPORARY_OUTPUT_STREAM(bodyStream, DSS_BODY_BUFFER_SIZE);
+    EXPECT_COMPAT_CALL(ffsDssClientGetBuffers(getUserContext(), _, _, _, _)).WillOnce(DoAll(
+            SetArgPointee<1>(hostStream),
+            SetArgPointee<2>(sessionIdStream),
+            SetArgPointee<3>(nonceStream),
+            SetArgPointee<4>(bodyStream),
+            Return(FFS_SUCCESS)));
+    EXPECT_COMPAT_CALL(ffsGetConfigurationValue(getUserContext(), FFS_CONFIGURATION_ENTRY_KEY_DSS_HOST, _))
+            .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+    EXPECT_COMPAT_CALL(ffsGetConfigurationValue(getUserContext(), FFS_CONFIGURATION_ENTRY_KEY_DSS_PORT, _))
+            .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+    EXPECT_COMPAT_CALL(ffsVerifyCloudSignature(_, _, _, _))
+            .WillRepeatedly(DoAll(SetArgPointee<3>(true),
+                    Return(FFS_SUCCESS)));
+
+    // Mock 'ffsHttpExecute'.
+    EXPECT_COMPAT_CALL(ffsHttpExecute(getUserContext(), _, _))
+            // 'START_PROVISIONING'.
+            .WillOnce(DoAll(Invoke(sendSignatureResponse),
+                    Invoke(sendStartProvisioningSessionBodyCannotProceed),
+                    Return(FFS_SUCCESS)));
+
+    // Mock 'ffsGetRandomBytes'.
+    EXPECT_COMPAT_CALL(ffsRandomBytes(_, PointeeSpaceIs(strlen(TEST_RANDOM))))
+            .WillRepeatedly(DoAll(WriteStringToArgPointee<1>(TEST_RANDOM), Return(FFS_SUCCESS)));
+
+    // Do not involve encoded SSID for this test.
+    // Make the first call not return a success reponse to bypass the calculation.
+    EXPECT_COMPAT_CALL(ffsRandomBytes(getUserContext(), PointeeSpaceIs(ENCODED_SSID_NONCE_SIZE)))
+        .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+
+    // Mock 'ffsGetSetupNetworkConfiguration'.
+    EXPECT_COMPAT_CALL(ffsGetSetupNetworkConfiguration(getUserContext(), _))
+            .WillOnce(Return(FFS_NOT_IMPLEMENTED)); 
+
+    // Mock 'ffsWifiManagerGetConnectionDetails'.
+    FfsWifiConnectionDetails_t wifiConnectionDetails = FfsWifiConnectionDetails_t();
+    wifiConnectionDetails.state = FFS_WIFI_CONNECTION_STATE_ASSOCIATED;
+    EXPECT_COMPAT_CALL(ffsGetWifiConnectionDetails(getUserContext(), _))
+            .WillOnce(DoAll(SetArgPointee<1>(wifiConnectionDetails), Return(FFS_SUCCESS)));
+
+    // Initialize the state machine.
+    EXPECT_COMPAT_CALL(ffsSetWifiProvisioneeState(getUserContext(), FFS_WIFI_PROVISIONEE_STATE_NOT_PROVISIONED))
+            .WillOnce(DoAll(SaveArg<1>(&state), Return(FFS_SUCCESS)));
+
+    // Execute 'NOT_PROVISIONED'.
+    EXPECT_COMPAT_CALL(ffsSetWifiProvisioneeState(getUserContext(), FFS_WIFI_PROVISIONEE_STATE_CONNECTING_TO_SETUP_NETWORK))
+            .WillOnce(DoAll(SaveArg<1>(&state), Return(FFS_SUCCESS)));
+
+    // Execute 'CONNECTING_TO_SETUP_NETWORK'.
+    EXPECT_COMPAT_CALL(ffsAddWifiConfiguration(getUserContext(), _))
+            .WillOnce(Return(FFS_SUCCESS));
+    EXPECT_COMPAT_CALL(ffsConnectToWifi(getUserContext())).WillOnce(Return(FFS_SUCCESS));
+    EXPECT_COMPAT_CALL(ffsSetWifiProvisioneeState(getUserContext(), FFS_WIFI_PROVISIONEE_STATE_START_PROVISIONING))
+            .WillOnce(DoAll(SaveArg<1>(&state), Return(FFS_SUCCESS)));
+
+    FfsWifiProvisioneeContext_t *context;
+    FfsWifiProvisioneeStepStatus_t status;
+    ASSERT_SUCCESS(ffsWifiProvisioneeInit(getUserContext(), &context));
+
+    // Only one state machine runs at a time.
+    FfsWifiProvisioneeContext_t *otherContext;
+    ASSERT_EQ(FFS_ERROR, ffsWifiProvisioneeInit(getUserContext(), &otherContext));
+
+    // Resume (nothing to resume).
+    ASSERT_SUCCESS(ffsWifiProvisioneeStep(context, FFS_WIFI_PROVISIONEE_EVENT_NONE, 1000, &status));
+    ASSERT_FALSE(status.isDone);
+    ASSERT_EQ(FFS_WIFI_PROVISIONEE_EVENT_NONE, status.awaitedEvent);
+
+    // Execute 'NOT_PROVISIONED'.
+    ASSERT_SUCCESS(ffsWifiProvisioneeStep(context, FFS_WIFI_PROVISIONEE_EVENT_NONE, 1000, &status));
+    ASSERT_FALSE(status.isDone);
+    ASSERT_EQ(FFS_WIFI_PROVISIONEE_STATE_CONNECTING_TO_SETUP_NETWORK, state);
+
+    // Start 'CONNECTING_TO_SETUP_NETWORK'; the step returns while the connection runs.
+    ASSERT_SUCCESS(ffsWifiProvisioneeStep(context, FFS_WIFI_PROVISIONEE_EVENT_NONE, 1000, &status));
+    ASSERT_FALSE(status.isDone);
+    ASSERT_EQ(FFS_WIFI_PROVISIONEE_EVENT_WIFI, status.awaitedEvent);
+    ASSERT_LT(1000u, status.deadlineMs);
+    ASSERT_EQ(FFS_WIFI_PROVISIONEE_STATE_CONNECTING_TO_SETUP_NETWORK, state);
+
+    // Another event before the deadline leaves the connection alone.
+    ASSERT_SUCCESS(ffsWifiProvisioneeStep(context, FFS_WIFI_PROVISIONEE_EVENT_HTTP, 2000, &status));
+    ASSERT_EQ(FFS_WIFI_PROVISIONEE_EVENT_WIFI, status.awaitedEvent);
+
+    // Finish 'CONNECTING_TO_SETUP_NETWORK'.
+    ASSERT_SUCCESS(ffsWifiProvisioneeStep(context, FFS_WIFI_PROVISIONEE_EVENT_WIFI, 3000, &status));
+    ASSERT_FALSE(status.isDone);
+    ASSERT_EQ(FFS_WIFI_PROVISIONEE_EVENT_NONE, status.awaitedEvent);
+    ASSERT_EQ(FFS_WIFI_PROVISIONEE_STATE_START_PROVISIONING, state);
+
+    // Start 'START_PROVISIONING'; the step returns while the request runs.
+    ASSERT_SUCCESS(ffsWifiProvisioneeStep(context, FFS_WIFI_PROVISIONEE_EVENT_NONE, 3000, &status));
+    ASSERT_FALSE(status.isDone);
+    ASSERT_EQ(FFS_WIFI_PROVISIONEE_EVENT_HTTP, status.awaitedEvent);
+
+    // Finish 'START_PROVISIONING'; the cloud stops the state machine.
+    ASSERT_SUCCESS(ffsWifiProvisioneeStep(context, FFS_WIFI_PROVISIONEE_EVENT_HTTP, 4000, &status));
+    ASSERT_TRUE(status.isDone);
+
+    // Nothing left to do.
+    ASSERT_SUCCESS(ffsWifiProvisioneeStep(context, FFS_WIFI_PROVISIONEE_EVENT_NONE, 4000, &status));
+    ASSERT_TRUE(status.isDone);
+
+    ffsWifiProvisioneeDeinit(context);
+}
+
+TEST_F(TaskTests, StepTimesOutWifiConnection)
+{
+    // Provisionee state.
+    FFS_WIFI_PROVISIONEE_STATE state;
+    EXPECT_COMPAT_CALL(ffsGetWifiProvisioneeState(getUserContext(), _))
+            .Times(2) //!< Expect to handle 2 states.
+            .WillRepeatedly(DoAll(SetArgPointee<1>(ByRef(state)), Return(FFS_SUCCESS)));
+
+    // Mock 'ffsWifiProvisioneeCanProceed'.
+    EXPECT_COMPAT_CALL(ffsWifiProvisioneeCanProceed(getUserContext(), _))
+            .Times(2) //!< Expect to handle 2 states.
+            .WillRepeatedly(DoAll(SetArgPointee<1>(true), Return(FFS_SUCCESS)));
+
+    // Checkpoints not supported.
+    EXPECT_COMPAT_CALL(ffsLoadWifiProvisioneeCheckpoint(getUserContext(), _))
+            .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+
+    // Mock 'ffsDssClientGetBuffers'.
+    FFS_TEMPORARY_OUTPUT_STREAM(hostStream, DSS_HOST_BUFFER_SIZE);
+    FFS_TEMPORARY_OUTPUT_STREAM(sessionIdStream, DSS_SESSION_ID_BUFFER_SIZE);
+    FFS_TEMPORARY_OUTPUT_STREAM(nonceStream, DSS_NONCE_BUFFER_SIZE);
+    FFS_TEMPORARY_OUTPUT_STREAM(bodyStream, DSS_BODY_BUFFER_SIZE);
+    EXPECT_COMPAT_CALL(ffsDssClientGetBuffers(getUserContext(), _, _, _, _)).WillOnce(DoAll(
+            SetArgPointee<1>(hostStream),
+            SetArgPointee<2>(sessionIdStream),
+            SetArgPointee<3>(nonceStream),
+            SetArgPointee<4>(bodyStream),
+            Return(FFS_SUCCESS)));
+    EXPECT_COMPAT_CALL(ffsGetConfigurationValue(getUserContext(), FFS_CONFIGURATION_ENTRY_KEY_DSS_HOST, _))
+            .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+    EXPECT_COMPAT_CALL(ffsGetConfigurationValue(getUserContext(), FFS_CONFIGURATION_ENTRY_KEY_DSS_PORT, _))
+            .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+
+    // Do not involve encoded SSID for this test.
+    EXPECT_COMPAT_CALL(ffsRandomBytes(getUserContext(), PointeeSpaceIs(ENCODED_SSID_NONCE_SIZE)))
+        .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+
+    // Mock 'ffsGetSetupNetworkConfiguration'.
+    EXPECT_COMPAT_CALL(ffsGetSetupNetworkConfiguration(getUserContext(), _))
+            .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+
+    // The connection never completes.
+    FfsWifiConnectionDetails_t wifiConnectionDetails = FfsWifiConnectionDetails_t();
+    wifiConnectionDetails.state = FFS_WIFI_CONNECTION_STATE_UNAUTHENTICATED;
+    EXPECT_COMPAT_CALL(ffsGetWifiConnectionDetails(getUserContext(), _))
+            .Times(2)
+            .WillRepeatedly(DoAll(SetArgPointee<1>(wifiConnectionDetails), Return(FFS_SUCCESS)));
+
+    // Initialize the state machine.
+    EXPECT_COMPAT_CALL(ffsSetWifiProvisioneeState(getUserContext(), FFS_WIFI_PROVISIONEE_STATE_NOT_PROVISIONED))
+            .WillOnce(DoAll(SaveArg<1>(&state), Return(FFS_SUCCESS)));
+
+    // Execute 'NOT_PROVISIONED'.
+    EXPECT_COMPAT_CALL(ffsSetWifiProvisioneeState(getUserContext(), FFS_WIFI_PROVISIONEE_STATE_CONNECTING_TO_SETUP_NETWORK))
+            .WillOnce(DoAll(SaveArg<1>(&state), Return(FFS_SUCCESS)));
+
+    // Start 'CONNECTING_TO_SETUP_NETWORK'.
+    EXPECT_COMPAT_CALL(ffsAddWifiConfiguration(getUserContext(), _))
+            .WillOnce(Return(FFS_SUCCESS));
+    EXPECT_COMPAT_CALL(ffsConnectToWifi(getUserContext())).WillOnce(Return(FFS_SUCCESS));
+
+    FfsWifiProvisioneeContext_t *context;
+    FfsWifiProvisioneeStepStatus_t status;
+    ASSERT_SUCCESS(ffsWifiProvisioneeInit(getUserContext(), &context));
+
+    // Resume (nothing to resume), execute 'NOT_PROVISIONED' and start 'CONNECTING_TO_SETUP_NETWORK'.
+    uint32_t nowMs = UINT32_MAX - 1000; //!< Close to the wrap of the clock.
+    ASSERT_SUCCESS(ffsWifiProvisioneeStep(context, FFS_WIFI_PROVISIONEE_EVENT_NONE, nowMs, &status));
+    ASSERT_SUCCESS(ffsWifiProvisioneeStep(context, FFS_WIFI_PROVISIONEE_EVENT_NONE, nowMs, &status));
+    ASSERT_SUCCESS(ffsWifiProvisioneeStep(context, FFS_WIFI_PROVISIONEE_EVENT_NONE, nowMs, &status));
+    ASSERT_EQ(FFS_WIFI_PROVISIONEE_EVENT_WIFI, status.awaitedEvent);
+
+    // Still connecting before the deadline.
+    ASSERT_SUCCESS(ffsWifiProvisioneeStep(context, FFS_WIFI_PROVISIONEE_EVENT_WIFI, status.deadlineMs - 1, &status));
+    ASSERT_FALSE(status.isDone);
+    ASSERT_EQ(FFS_WIFI_PROVISIONEE_EVENT_WIFI, status.awaitedEvent);
+
+    // Still connecting at the deadline; the fallback setup network failed.
+    ASSERT_EQ(FFS_TIMEOUT, ffsWifiProvisioneeStep(context, FFS_WIFI_PROVISIONEE_EVENT_NONE, status.deadlineMs,
+            &status));
+    ASSERT_TRUE(status.isDone);
+    ASSERT_EQ(FFS_WIFI_PROVISIONEE_EVENT_NONE, status.awaitedEvent);
+
+    ffsWifiProvisioneeDeinit(context);
+}
+
 TEST_F(TaskTests, TaskCannotFindEncodedNetworkWithCloudCannotProceed)
 {
     // Provisionee state.
@@ -649,6 +928,10 @@ TEST_F(TaskTests, TaskCannotFindEncodedNetworkWithCloudCannotProceed)
             .Times(3) //!< Expect to handle 3 states.
             .WillRepeatedly(DoAll(SetArgPointee<1>(true), Return(FFS_SUCCESS)));
 
+    // Checkpoints not supported.
+    EXPECT_COMPAT_CALL(ffsLoadWifiProvisioneeCheckpoint(getUserContext(), _))
+            .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+
     // Mock 'ffsDssClientGetBuffers'.
     FFS_TEMPORARY_OUTPUT_STREAM(hostStream, DSS_HOST_BUFFER_SIZE);
     FFS_TEMPORARY_OUTPUT_STREAM(sessionIdStream, DSS_SESSION_ID_BUFFER_SIZE);
@@ -704,6 +987,14 @@ TEST_F(TaskTests, TaskCannotFindEncodedNetworkWithCloudCannotProceed)
             StrEq(FFS_CONFIGURATION_ENTRY_KEY_CLOUD_EC_PUBLIC_KEY_DER), _))
             .WillOnce(DoAll(WriteByteStreamToMapValueArgPointee<2>(testPublicKeyStream), Return(FFS_SUCCESS)));
 
+    // No stored encoded setup network cache.
+    EXPECT_COMPAT_CALL(ffsGetConfigurationValue(getUserContext(),
+            StrEq(FFS_CONFIGURATION_ENTRY_KEY_ENCODED_SETUP_NETWORK_CACHE), _))
+            .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+    EXPECT_COMPAT_CALL(ffsSetConfigurationValue(getUserContext(),
+            StrEq(FFS_CONFIGURATION_ENTRY_KEY_ENCODED_SETUP_NETWORK_CACHE), _))
+            .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+
     // Mock ECDH shared secret.
     EXPECT_COMPAT_CALL(ffsComputeECDHKey(getUserContext(), PointeeStreamEq(testPublicKeyStream), PointeeSpaceIsSizeOf(testHashedPublicKeyStream)))
             .WillOnce(DoAll(WriteStreamToArgPointee<2>(testHashedPublicKeyStream), Return(FFS_SUCCESS)));
@@ -748,3 +1039,215 @@ TEST_F(TaskTests, TaskCannotFindEncodedNetworkWithCloudCannotProceed)
     // Run the task.
     ASSERT_SUCCESS(ffsWifiProvisioneeTask(getUserContext()));
 }
+
+TEST_F(TaskTests, TaskResumeRejectedByCloud)
+{
+    // Provisionee state.
+    FFS_WIFI_PROVISIONEE_STATE state;
+    EXPECT_COMPAT_CALL(ffsGetWifiProvisioneeState(getUserContext(), _))
+            .WillOnce(DoAll(SetArgPointee<1>(ByRef(state)), Return(FFS_SUCCESS)));
+
+    // Mock 'ffsWifiProvisioneeCanProceed'; stop after the resumed state.
+    EXPECT_COMPAT_CALL(ffsWifiProvisioneeCanProceed(getUserContext(), _))
+            .WillOnce(DoAll(SetArgPointee<1>(true), Return(FFS_SUCCESS)))
+            .WillOnce(DoAll(SetArgPointee<1>(false), Return(FFS_SUCCESS)));
+
+    // Checkpoint of a session interrupted in 'START_PIN_BASED_SETUP'.
+    FFS_TEMPORARY_OUTPUT_STREAM(checkpointStream, FFS_WIFI_PROVISIONEE_CHECKPOINT_MAXIMUM_SIZE);
+    FfsWifiProvisioneeCheckpoint_t checkpoint = FfsWifiProvisioneeCheckpoint_t();
+    checkpoint.state = FFS_WIFI_PROVISIONEE_STATE_START_PIN_BASED_SETUP;
+    checkpoint.sequenceNumber = 5;
+    checkpoint.sessionIdStream = FFS_STRING_INPUT_STREAM(TEST_SESSION_ID);
+    checkpoint.saltStream = FFS_STRING_INPUT_STREAM(TEST_RANDOM);
+    ASSERT_SUCCESS(ffsEncodeWifiProvisioneeCheckpoint(&checkpoint, &checkpointStream));
+    EXPECT_COMPAT_CALL(ffsLoadWifiProvisioneeCheckpoint(getUserContext(), _))
+            .WillOnce(DoAll(WriteStreamToArgPointee<1>(checkpointStream), Return(FFS_SUCCESS)));
+
+    // The resumed state is checkpointed again, then the rejected session is cleared.
+    FFS_TEMPORARY_OUTPUT_STREAM(savedCheckpointStream, FFS_WIFI_PROVISIONEE_CHECKPOINT_MAXIMUM_SIZE);
+    EXPECT_COMPAT_CALL(ffsSaveWifiProvisioneeCheckpoint(getUserContext(), _))
+            .WillOnce(DoAll(WriteArgPointeeToStream<1>(&savedCheckpointStream), Return(FFS_SUCCESS)));
+    EXPECT_COMPAT_CALL(ffsClearWifiProvisioneeCheckpoint(getUserContext()))
+            .WillOnce(Return(FFS_SUCCESS));
+
+    // No device details.
+    EXPECT_COMPAT_CALL(ffsGetConfigurationValue(getUserContext(), _, _))
+            .WillRepeatedly(Return(FFS_NOT_IMPLEMENTED));
+
+    // Mock 'ffsDssClientGetBuffers'; once at start, once for the new session.
+    FFS_TEMPORARY_OUTPUT_STREAM(hostStream, DSS_HOST_BUFFER_SIZE);
+    FFS_TEMPORARY_OUTPUT_STREAM(sessionIdStream, DSS_SESSION_ID_BUFFER_SIZE);
+    FFS_TEMPORARY_OUTPUT_STREAM(nonceStream, DSS_NONCE_BUFFER_SIZE);
+    FFS_TEMPORARY_OUTPUT_STREAM(bodyStream, DSS_BODY_BUFFER_SIZE);
+    EXPECT_COMPAT_CALL(ffsDssClientGetBuffers(getUserContext(), _, _, _, _))
+            .Times(2)
+            .WillRepeatedly(DoAll(
+                    SetArgPointee<1>(hostStream),
+                    SetArgPointee<2>(sessionIdStream),
+                    SetArgPointee<3>(nonceStream),
+                    SetArgPointee<4>(bodyStream),
+                    Return(FFS_SUCCESS)));
+    EXPECT_COMPAT_CALL(ffsGetConfigurationValue(getUserContext(), FFS_CONFIGURATION_ENTRY_KEY_DSS_HOST, _))
+            .Times(2)
+            .WillRepeatedly(Return(FFS_NOT_IMPLEMENTED));
+    EXPECT_COMPAT_CALL(ffsGetConfigurationValue(getUserContext(), FFS_CONFIGURATION_ENTRY_KEY_DSS_PORT, _))
+            .Times(2)
+            .WillRepeatedly(Return(FFS_NOT_IMPLEMENTED));
+
+    // The cloud no longer knows the session.
+    EXPECT_COMPAT_CALL(ffsHttpExecute(getUserContext(), _, _))
+            .WillRepeatedly(Return(FFS_ERROR));
+    EXPECT_COMPAT_CALL(ffsGetRegistrationDetails(getUserContext(), _))
+            .WillRepeatedly(Return(FFS_NOT_IMPLEMENTED));
+
+    // Mock 'ffsGetRandomBytes'.
+    EXPECT_COMPAT_CALL(ffsRandomBytes(_, PointeeSpaceIs(strlen(TEST_RANDOM))))
+            .WillRepeatedly(DoAll(WriteStringToArgPointee<1>(TEST_RANDOM), Return(FFS_SUCCESS)));
+
+    // Do not involve encoded SSID for this test.
+    EXPECT_COMPAT_CALL(ffsRandomBytes(getUserContext(), PointeeSpaceIs(ENCODED_SSID_NONCE_SIZE)))
+        .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+
+    // Mock 'ffsGetSetupNetworkConfiguration'.
+    EXPECT_COMPAT_CALL(ffsGetSetupNetworkConfiguration(getUserContext(), _))
+            .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+
+    // Start the task.
+    EXPECT_COMPAT_CALL(ffsSetWifiProvisioneeState(getUserContext(), FFS_WIFI_PROVISIONEE_STATE_NOT_PROVISIONED))
+            .Times(2) //!< Once at start, once for the new session.
+            .WillRepeatedly(DoAll(SaveArg<1>(&state), Return(FFS_SUCCESS)));
+
+    // Resume: rejoin the setup network.
+    FfsWifiConnectionDetails_t wifiConnectionDetails = FfsWifiConnectionDetails_t();
+    wifiConnectionDetails.state = FFS_WIFI_CONNECTION_STATE_ASSOCIATED;
+    EXPECT_COMPAT_CALL(ffsAddWifiConfiguration(getUserContext(), _))
+            .WillOnce(Return(FFS_SUCCESS));
+    EXPECT_COMPAT_CALL(ffsConnectToWifi(getUserContext())).WillOnce(Return(FFS_SUCCESS));
+    EXPECT_COMPAT_CALL(ffsGetWifiConnectionDetails(getUserContext(), _))
+            .WillOnce(DoAll(SetArgPointee<1>(wifiConnectionDetails), Return(FFS_SUCCESS)));
+    EXPECT_COMPAT_CALL(ffsSetWifiProvisioneeState(getUserContext(), FFS_WIFI_PROVISIONEE_STATE_START_PIN_BASED_SETUP))
+            .WillOnce(DoAll(SaveArg<1>(&state), Return(FFS_SUCCESS)));
+
+    // Run the task.
+    ASSERT_SUCCESS(ffsWifiProvisioneeTask(getUserContext()));
+    ASSERT_EQ(FFS_WIFI_PROVISIONEE_STATE_NOT_PROVISIONED, state);
+
+    // The resumed session was checkpointed with the resume counted and the sequence numbers skipped.
+    FfsWifiProvisioneeCheckpoint_t savedCheckpoint;
+    ASSERT_SUCCESS(ffsDecodeWifiProvisioneeCheckpoint(&savedCheckpointStream, &savedCheckpoint));
+    ASSERT_EQ(FFS_WIFI_PROVISIONEE_STATE_START_PIN_BASED_SETUP, savedCheckpoint.state);
+    ASSERT_EQ(1, savedCheckpoint.resumeCount);
+    ASSERT_EQ(5 + FFS_WIFI_PROVISIONEE_CHECKPOINT_SEQUENCE_GAP, savedCheckpoint.sequenceNumber);
+    ASSERT_STREAM_EQ_STRING(savedCheckpoint.sessionIdStream, TEST_SESSION_ID);
+    ASSERT_STREAM_EQ_STRING(savedCheckpoint.saltStream, TEST_RANDOM);
+}
+
+TEST_F(TaskTests, TaskResumeKeepsUserNetworkInSingleSlot)
+{
+    sWifiSlotSsid.clear();
+    sConnectedSsids.clear();
+
+    // Provisionee state.
+    FFS_WIFI_PROVISIONEE_STATE state;
+    EXPECT_COMPAT_CALL(ffsGetWifiProvisioneeState(getUserContext(), _))
+            .WillOnce(DoAll(SetArgPointee<1>(ByRef(state)), Return(FFS_SUCCESS)));
+
+    // Mock 'ffsWifiProvisioneeCanProceed'; stop after the resumed state.
+    EXPECT_COMPAT_CALL(ffsWifiProvisioneeCanProceed(getUserContext(), _))
+            .WillOnce(DoAll(SetArgPointee<1>(true), Return(FFS_SUCCESS)))
+            .WillOnce(DoAll(SetArgPointee<1>(false), Return(FFS_SUCCESS)));
+
+    // Checkpoint of a session interrupted in 'CONNECTING_TO_USER_NETWORK', with the user network received.
+    FFS_TEMPORARY_OUTPUT_STREAM(itemsStream, FFS_WIFI_PROVISIONEE_CHECKPOINT_ITEMS_SIZE);
+    FfsWifiConfiguration_t userWifiConfiguration = FfsWifiConfiguration_t();
+    userWifiConfiguration.ssidStream = FFS_STRING_INPUT_STREAM("USER_NETWORK");
+    userWifiConfiguration.keyStream = FFS_STRING_INPUT_STREAM("password");
+    userWifiConfiguration.securityProtocol = FFS_WIFI_SECURITY_PROTOCOL_WPA_PSK;
+    ASSERT_SUCCESS(ffsWifiProvisioneeCheckpointAddWifiConfiguration(&itemsStream, &userWifiConfiguration));
+
+    FFS_TEMPORARY_OUTPUT_STREAM(checkpointStream, FFS_WIFI_PROVISIONEE_CHECKPOINT_MAXIMUM_SIZE);
+    FfsWifiProvisioneeCheckpoint_t checkpoint = FfsWifiProvisioneeCheckpoint_t();
+    checkpoint.state = FFS_WIFI_PROVISIONEE_STATE_CONNECTING_TO_USER_NETWORK;
+    checkpoint.sequenceNumber = 5;
+    checkpoint.sessionIdStream = FFS_STRING_INPUT_STREAM(TEST_SESSION_ID);
+    checkpoint.saltStream = FFS_STRING_INPUT_STREAM(TEST_RANDOM);
+    checkpoint.itemsStream = itemsStream;
+    ASSERT_SUCCESS(ffsEncodeWifiProvisioneeCheckpoint(&checkpoint, &checkpointStream));
+    EXPECT_COMPAT_CALL(ffsLoadWifiProvisioneeCheckpoint(getUserContext(), _))
+            .WillOnce(DoAll(WriteStreamToArgPointee<1>(checkpointStream), Return(FFS_SUCCESS)));
+
+    // The resumed state is checkpointed again, then the failed session is cleared.
+    EXPECT_COMPAT_CALL(ffsSaveWifiProvisioneeCheckpoint(getUserContext(), _))
+            .WillOnce(Return(FFS_SUCCESS));
+    EXPECT_COMPAT_CALL(ffsClearWifiProvisioneeCheckpoint(getUserContext()))
+            .WillOnce(Return(FFS_SUCCESS));
+
+    // No device details.
+    EXPECT_COMPAT_CALL(ffsGetConfigurationValue(getUserContext(), _, _))
+            .WillRepeatedly(Return(FFS_NOT_IMPLEMENTED));
+
+    // Mock 'ffsDssClientGetBuffers'; once at start, once for the new session.
+    FFS_TEMPORARY_OUTPUT_STREAM(hostStream, DSS_HOST_BUFFER_SIZE);
+    FFS_TEMPORARY_OUTPUT_STREAM(sessionIdStream, DSS_SESSION_ID_BUFFER_SIZE);
+    FFS_TEMPORARY_OUTPUT_STREAM(nonceStream, DSS_NONCE_BUFFER_SIZE);
+    FFS_TEMPORARY_OUTPUT_STREAM(bodyStream, DSS_BODY_BUFFER_SIZE);
+    EXPECT_COMPAT_CALL(ffsDssClientGetBuffers(getUserContext(), _, _, _, _))
+            .Times(2)
+            .WillRepeatedly(DoAll(
+                    SetArgPointee<1>(hostStream),
+                    SetArgPointee<2>(sessionIdStream),
+                    SetArgPointee<3>(nonceStream),
+                    SetArgPointee<4>(bodyStream),
+                    Return(FFS_SUCCESS)));
+    EXPECT_COMPAT_CALL(ffsGetConfigurationValue(getUserContext(), FFS_CONFIGURATION_ENTRY_KEY_DSS_HOST, _))
+            .Times(2)
+            .WillRepeatedly(Return(FFS_NOT_IMPLEMENTED));
+    EXPECT_COMPAT_CALL(ffsGetConfigurationValue(getUserContext(), FFS_CONFIGURATION_ENTRY_KEY_DSS_PORT, _))
+            .Times(2)
+            .WillRepeatedly(Return(FFS_NOT_IMPLEMENTED));
+
+    // End the session after the connection attempt.
+    EXPECT_COMPAT_CALL(ffsHttpExecute(getUserContext(), _, _))
+            .WillRepeatedly(Return(FFS_ERROR));
+    EXPECT_COMPAT_CALL(ffsGetRegistrationDetails(getUserContext(), _))
+            .WillRepeatedly(Return(FFS_NOT_IMPLEMENTED));
+
+    // Mock 'ffsGetRandomBytes'.
+    EXPECT_COMPAT_CALL(ffsRandomBytes(_, PointeeSpaceIs(strlen(TEST_RANDOM))))
+            .WillRepeatedly(DoAll(WriteStringToArgPointee<1>(TEST_RANDOM), Return(FFS_SUCCESS)));
+
+    // Do not involve encoded SSID for this test.
+    EXPECT_COMPAT_CALL(ffsRandomBytes(getUserContext(), PointeeSpaceIs(ENCODED_SSID_NONCE_SIZE)))
+        .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+
+    // Mock 'ffsGetSetupNetworkConfiguration'.
+    EXPECT_COMPAT_CALL(ffsGetSetupNetworkConfiguration(getUserContext(), _))
+            .WillOnce(Return(FFS_NOT_IMPLEMENTED));
+
+    // Start the task.
+    EXPECT_COMPAT_CALL(ffsSetWifiProvisioneeState(getUserContext(), FFS_WIFI_PROVISIONEE_STATE_NOT_PROVISIONED))
+            .Times(2) //!< Once at start, once for the new session.
+            .WillRepeatedly(DoAll(SaveArg<1>(&state), Return(FFS_SUCCESS)));
+
+    // Wi-Fi client with a single network slot.
+    FfsWifiConnectionDetails_t wifiConnectionDetails = FfsWifiConnectionDetails_t();
+    wifiConnectionDetails.state = FFS_WIFI_CONNECTION_STATE_ASSOCIATED;
+    EXPECT_COMPAT_CALL(ffsAddWifiConfiguration(getUserContext(), _))
+            .WillRepeatedly(Invoke(addWifiConfigurationToSingleSlot));
+    EXPECT_COMPAT_CALL(ffsRemoveWifiConfiguration(getUserContext(), _))
+            .WillRepeatedly(Invoke(removeWifiConfigurationFromSingleSlot));
+    EXPECT_COMPAT_CALL(ffsConnectToWifi(getUserContext()))
+            .WillRepeatedly(Invoke(connectToSingleSlotWifi));
+    EXPECT_COMPAT_CALL(ffsGetWifiConnectionDetails(getUserContext(), _))
+            .WillRepeatedly(DoAll(SetArgPointee<1>(wifiConnectionDetails), Return(FFS_SUCCESS)));
+    EXPECT_COMPAT_CALL(ffsSetWifiProvisioneeState(getUserContext(), FFS_WIFI_PROVISIONEE_STATE_CONNECTING_TO_USER_NETWORK))
+            .WillOnce(DoAll(SaveArg<1>(&state), Return(FFS_SUCCESS)));
+
+    // Run the task.
+    ASSERT_SUCCESS(ffsWifiProvisioneeTask(getUserContext()));
+
+    // The setup network was rejoined, then the user network was still stored when it was joined.
+    ASSERT_EQ((size_t) 2, sConnectedSsids.size());
+    ASSERT_EQ("simple_setup", sConnectedSsids[0]);
+    ASSERT_EQ("USER_NETWORK", sConnectedSsids[1]);
+}
@@ -0,0 +1,318 @@
+import sys, getopt, json, os
+
+# Generates the DSS model field descriptor tables (ffs_dss_model_tables.c/.h)
+# from ffs_dss_model_schema.json. The generated files are checked in so that
+# builds without Python (MPLAB X, Amazon FreeRTOS) use them as they are.
+
+USAGE = 'ffs_dss_model_generator.py -s <schema> -c <source output> -i <header output> [-k]'
+
+MAXIMUM_FIELD_COUNT = 32
+
+FIELD_TYPES = {
+	'string': ('FFS_DSS_MODEL_FIELD_STRING', 'FFS_JSON_STRING'),
+	'stream': ('FFS_DSS_MODEL_FIELD_STREAM', 'FFS_JSON_STRING'),
+	'quotedStream': ('FFS_DSS_MODEL_FIELD_QUOTED_STREAM', 'FFS_JSON_STRING'),
+	'bssid': ('FFS_DSS_MODEL_FIELD_BSSID', 'FFS_JSON_STRING'),
+	'boolean': ('FFS_DSS_MODEL_FIELD_BOOLEAN', 'FFS_JSON_BOOLEAN'),
+	'int32': ('FFS_DSS_MODEL_FIELD_INT32', 'FFS_JSON_NUMBER'),
+	'uint32': ('FFS_DSS_MODEL_FIELD_UINT32', 'FFS_JSON_NUMBER'),
+	'int64': ('FFS_DSS_MODEL_FIELD_INT64', 'FFS_JSON_NUMBER'),
+	'enum': ('FFS_DSS_MODEL_FIELD_ENUM', 'FFS_JSON_STRING'),
+	'object': ('FFS_DSS_MODEL_FIELD_OBJECT', 'FFS_JSON_OBJECT'),
+	'custom': ('FFS_DSS_MODEL_FIELD_CUSTOM', 'FFS_JSON_OBJECT'),
+	'json': ('FFS_DSS_MODEL_FIELD_JSON_VALUE', None),
+}
+
+JSON_VALUE_TYPES = {
+	'object': 'FFS_JSON_OBJECT',
+	'array': 'FFS_JSON_ARRAY',
+}
+
+COPYRIGHT = ''' * @copyright 2019 Amazon.com, Inc. or its affiliates.  All rights reserved.
+ * AMAZON PROPRIETARY/CONFIDENTIAL
+ * You may not use this file except in compliance with the terms and
+ * conditions set forth in the accompanying LICENSE.TXT file.
+ * THESE MATERIALS ARE PROVIDED ON AN "AS IS" BASIS. AMAZON SPECIFICALLY
+ * DISCLAIMS, WITH RESPECT TO THESE MATERIALS, ALL WARRANTIES, EXPRESS,
+ * IMPLIED, OR STATUTORY, INCLUDING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+ */'''
+
+GENERATED_NOTE = ''' * Generated by libffs/tools/ffs_dss_model_generator.py from
+ * libffs/tools/ffs_dss_model_schema.json. Do not edit; change the schema and
+ * rebuild (or run the generator) instead.'''
+
+def fail(message):
+	raise ValueError(message)
+
+def splitType(typeName):
+	if ':' in typeName:
+		return typeName.split(':', 1)
+	return (typeName, None)
+
+def validateModel(schema, modelName, model):
+	fields = model['fields']
+	if len(fields) == 0 or len(fields) > MAXIMUM_FIELD_COUNT:
+		fail('%s: %d fields (1 to %d supported)' % (modelName, len(fields), MAXIMUM_FIELD_COUNT))
+	keys = set()
+	captures = set()
+	for index, field in enumerate(fields):
+		key = field['key']
+		if key in keys:
+			fail('%s: duplicate key "%s"' % (modelName, key))
+		keys.add(key)
+		if len(key) == 0 or len(key) > 255:
+			fail('%s: key "%s" has an unsupported length' % (modelName, key))
+		(baseType, argument) = splitType(field['type'])
+		if baseType not in FIELD_TYPES:
+			fail('%s.%s: unknown type "%s"' % (modelName, key, field['type']))
+		if baseType == 'enum' and argument not in schema['enums']:
+			fail('%s.%s: unknown enumeration "%s"' % (modelName, key, argument))
+		if baseType == 'object' and argument not in schema['models']:
+			fail('%s.%s: unknown model "%s"' % (modelName, key, argument))
+		if baseType == 'custom':
+			if argument not in schema['fieldSerializers']:
+				fail('%s.%s: unknown field serializer "%s"' % (modelName, key, argument))
+			# Field serializers always write a leading separator.
+			if index == 0:
+				fail('%s.%s: a custom field cannot be the first field' % (modelName, key))
+		if baseType == 'json':
+			if argument not in JSON_VALUE_TYPES:
+				fail('%s.%s: unknown JSON value type "%s"' % (modelName, key, argument))
+			if field.get('capture') is None or field['capture'] in captures:
+				fail('%s.%s: missing or duplicate capture index' % (modelName, key))
+			captures.add(field['capture'])
+		if field.get('failIfFalse') and baseType != 'boolean':
+			fail('%s.%s: "failIfFalse" needs a boolean' % (modelName, key))
+
+def usedTypes(schema, baseTypeName):
+	used = []
+	for model in schema['models'].values():
+		for field in model['fields']:
+			(baseType, argument) = splitType(field['type'])
+			if baseType == baseTypeName and argument not in used:
+				used.append(argument)
+	return used
+
+def modelSymbol(modelName):
+	return 'ffsDss%sModel' % modelName
+
+def fieldInitializer(schema, model, field):
+	(baseType, argument) = splitType(field['type'])
+	(fieldType, jsonType) = FIELD_TYPES[baseType]
+	if baseType == 'json':
+		jsonType = JSON_VALUE_TYPES[argument]
+	flags = []
+	if field.get('required'):
+		flags.append('FFS_DSS_MODEL_FIELD_REQUIRED')
+	if field.get('failIfFalse'):
+		flags.append('FFS_DSS_MODEL_FIELD_FAIL_IF_FALSE')
+	if baseType == 'json':
+		offset = '%d' % field['capture']
+	else:
+		offset = 'offsetof(%s, %s)' % (model['type'], field.get('member', field['key']))
+	if field.get('presence'):
+		presenceOffset = 'offsetof(%s, %s)' % (model['type'], field['presence'])
+	else:
+		presenceOffset = 'FFS_DSS_MODEL_NO_PRESENCE_FLAG'
+	lines = [
+		'    {',
+		'        .key = "%s",' % field['key'],
+		'        .keySize = %d,' % len(field['key']),
+		'        .type = %s,' % fieldType,
+		'        .jsonType = %s,' % jsonType,
+		'        .flags = %s,' % (' | '.join(flags) if flags else '0'),
+		'        .offset = %s,' % offset,
+		'        .presenceOffset = %s,' % presenceOffset,
+	]
+	if baseType == 'enum':
+		lines.append('        .extension = { .enumAdapter = &ffsDss%sAdapter }' % argument)
+	elif baseType == 'object':
+		lines.append('        .extension = { .model = &%s }' % modelSymbol(argument))
+	elif baseType == 'custom':
+		lines.append('        .extension = { .serializeField = ffsDssSerialize%sFieldValue }' % argument)
+	else:
+		lines.append('        .extension = { .model = NULL }')
+	lines.append('    }')
+	return '\n'.join(lines)
+
+def generateSource(schema):
+	out = []
+	out.append('/** @file ffs_dss_model_tables.c')
+	out.append(' *')
+	out.append(' * @brief DSS model field descriptor tables.')
+	out.append(' *')
+	out.append(GENERATED_NOTE)
+	out.append(' *')
+	out.append(COPYRIGHT)
+	out.append('')
+	out.append('#include "ffs/common/ffs_check_result.h"')
+	headers = set()
+	for model in schema['models'].values():
+		headers.add(model['header'])
+	for name in usedTypes(schema, 'enum'):
+		headers.add(schema['enums'][name]['header'])
+	for name in usedTypes(schema, 'custom'):
+		headers.add(schema['fieldSerializers'][name]['header'])
+	headers.add('ffs/dss/model/ffs_dss_model_tables.h')
+	for header in sorted(headers):
+		out.append('#include "%s"' % header)
+	out.append('')
+	out.append('#include <stddef.h>')
+	out.append('')
+
+	# Enumeration adapters.
+	for name in usedTypes(schema, 'enum'):
+		enum = schema['enums'][name]
+		out.append('/** @brief Parse a %s string.' % name)
+		out.append(' */')
+		out.append('static FFS_RESULT ffsDssParse%sValue(const char *string, void *value)' % name)
+		out.append('{')
+		out.append('    return %s(string, (%s *) value);' % (enum['parse'], enum['type']))
+		out.append('}')
+		out.append('')
+		out.append('/** @brief Format a %s value.' % name)
+		out.append(' */')
+		out.append('static FFS_RESULT ffsDssFormat%sValue(const void *value, const char **string)' % name)
+		out.append('{')
+		out.append('    return %s(*(const %s *) value, string);' % (enum['format'], enum['type']))
+		out.append('}')
+		out.append('')
+		out.append('static const FfsDssModelEnumAdapter_t ffsDss%sAdapter = {' % name)
+		out.append('    .parse = ffsDssParse%sValue,' % name)
+		out.append('    .format = ffsDssFormat%sValue' % name)
+		out.append('};')
+		out.append('')
+
+	# Field serializers.
+	for name in usedTypes(schema, 'custom'):
+		serializer = schema['fieldSerializers'][name]
+		out.append('/** @brief Serialize a %s field.' % name)
+		out.append(' */')
+		out.append('static FFS_RESULT ffsDssSerialize%sFieldValue(const void *member, FfsStream_t *outputStream)'
+				% name)
+		out.append('{')
+		out.append('    return %s((%s *) member, outputStream);' % (serializer['function'], serializer['type']))
+		out.append('}')
+		out.append('')
+
+	# Models.
+	for modelName, model in schema['models'].items():
+		fields = model['fields']
+		keys = sorted(range(len(fields)), key = lambda index: (len(fields[index]['key']), fields[index]['key']))
+		maximumKeySize = max(len(field['key']) for field in fields)
+		lookupIndex = []
+		for keySize in range(maximumKeySize + 2):
+			lookupIndex.append(len([index for index in keys if len(fields[index]['key']) < keySize]))
+
+		out.append('static const FfsDssModelField_t ffsDss%sFields[] = {' % modelName)
+		out.append(',\n'.join(fieldInitializer(schema, model, field) for field in fields))
+		out.append('};')
+		out.append('')
+		out.append('static const uint8_t ffsDss%sLookup[] = { %s };' % (modelName,
+				', '.join('%d' % index for index in keys)))
+		out.append('')
+		out.append('static const uint8_t ffsDss%sLookupIndex[] = { %s };' % (modelName,
+				', '.join('%d' % index for index in lookupIndex)))
+		out.append('')
+		out.append('const FfsDssModelDescriptor_t %s = {' % modelSymbol(modelName))
+		out.append('    .fields = ffsDss%sFields,' % modelName)
+		out.append('    .fieldCount = %d,' % len(fields))
+		out.append('    .maximumKeySize = %d,' % maximumKeySize)
+		out.append('    .objectSize = sizeof(%s),' % model['type'])
+		out.append('    .lookup = ffsDss%sLookup,' % modelName)
+		out.append('    .lookupIndex = ffsDss%sLookupIndex' % modelName)
+		out.append('};')
+		out.append('')
+
+	return '\n'.join(out)
+
+def generateHeader(schema):
+	out = []
+	out.append('/** @file ffs_dss_model_tables.h')
+	out.append(' *')
+	out.append(' * @brief DSS model field descriptor tables.')
+	out.append(' *')
+	out.append(GENERATED_NOTE)
+	out.append(' *')
+	out.append(COPYRIGHT)
+	out.append('')
+	out.append('#ifndef FFS_DSS_MODEL_TABLES_H_')
+	out.append('#define FFS_DSS_MODEL_TABLES_H_')
+	out.append('')
+	out.append('#include "ffs/dss/model/ffs_dss_model_codec.h"')
+	out.append('')
+	out.append('#ifdef __cplusplus')
+	out.append('extern "C" {')
+	out.append('#endif')
+	out.append('')
+	for modelName, model in schema['models'].items():
+		out.append('/** @brief %s (@ref %s) descriptor.' % (modelName, model['type']))
+		out.append(' */')
+		out.append('extern const FfsDssModelDescriptor_t %s;' % modelSymbol(modelName))
+		out.append('')
+	out.append('#ifdef __cplusplus')
+	out.append('}')
+	out.append('#endif')
+	out.append('')
+	out.append('#endif /* FFS_DSS_MODEL_TABLES_H_ */')
+	out.append('')
+	return '\n'.join(out)
+
+def updateFile(fileName, content, checkOnly):
+	current = None
+	if os.path.exists(fileName):
+		with open(fileName, 'r') as fHdl:
+			current = fHdl.read()
+	if current == content:
+		return True
+	if checkOnly:
+		print('%s is out of date' % fileName)
+		return False
+	# Only rewrite changed files so that unchanged tables do not trigger rebuilds.
+	with open(fileName, 'w') as fHdl:
+		fHdl.write(content)
+	return True
+
+def main(argv):
+	schemaFile = None
+	sourceFile = None
+	headerFile = None
+	checkOnly = False
+	try:
+		opts, args = getopt.getopt(argv, 'hs:c:i:k', ['schema=', 'source=', 'header=', 'check'])
+	except getopt.GetoptError:
+		print(USAGE)
+		sys.exit(2)
+	for opt, arg in opts:
+		if opt == '-h':
+			print(USAGE)
+			sys.exit()
+		elif opt in ('-s', '--schema'):
+			schemaFile = arg
+		elif opt in ('-c', '--source'):
+			sourceFile = arg
+		elif opt in ('-i', '--header'):
+			headerFile = arg
+		elif opt in ('-k', '--check'):
+			checkOnly = True
+	if schemaFile is None or sourceFile is None or headerFile is None:
+		print(USAGE)
+		sys.exit(2)
+
+	with open(schemaFile, 'r') as fHdl:
+		schema = json.load(fHdl)
+	try:
+		for modelName, model in schema['models'].items():
+			validateModel(schema, modelName, model)
+	except ValueError as e:
+		print('%s: %s' % (schemaFile, e))
+		sys.exit(1)
+
+	isCurrent = updateFile(sourceFile, generateSource(schema), checkOnly)
+	isCurrent = updateFile(headerFile, generateHeader(schema), checkOnly) and isCurrent
+	if not isCurrent:
+		sys.exit(1)
+
+if __name__ == '__main__':
+	main(sys.argv[1:])
@@ -49,6 +49,11 @@ task.h is included from an application file. */
 
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
 
+#ifdef SYS_MEMTRACK_ENABLED
+	/* Account the allocations to the caller of pvPortMalloc(). */
+	#include "system/memtrack/sys_memtrack.h"
+#endif
+
 #if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
 	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
 #endif
@@ -61,7 +66,11 @@ void *pvReturn;
 
 	vTaskSuspendAll();
 	{
-		pvReturn = malloc( xWantedSize );
+		#ifdef SYS_MEMTRACK_ENABLED
+			pvReturn = SYS_MEMTRACK_AllocFrom( xWantedSize, SYS_MEMTRACK_TAG_RTOS, __builtin_return_address( 0 ) );
+		#else
+			pvReturn = malloc( xWantedSize );
+		#endif
 		traceMALLOC( pvReturn, xWantedSize );
 	}
 	( void ) xTaskResumeAll();
@@ -86,7 +95,11 @@ void vPortFree( void *pv )
 	{
 		vTaskSuspendAll();
 		{
-			free( pv );
+			#ifdef SYS_MEMTRACK_ENABLED
+				SYS_MEMTRACK_Free( pv );
+			#else
+				free( pv );
+			#endif
 			traceFREE( pv, 0 );
 		}
 		( void ) xTaskResumeAll();
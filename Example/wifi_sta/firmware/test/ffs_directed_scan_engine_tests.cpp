@@ -0,0 +1,260 @@
+/** @file ffs_directed_scan_engine_tests.cpp
+ *
+ * @brief PIC32MZW1 directed-scan engine tests.
+ */
+
+extern "C" {
+#include "ffs/amazon_freertos/ffs_amazon_freertos_directed_scan_engine.h"
+}
+
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#define TEST_SSID                   "HomeNetwork"
+#define TEST_CHANNEL_SWITCH_MS      (5)     // Radio retune and probe request overhead
+#define TEST_ALL_2_4G_CHANNELS      (0x07FF) // Channels 1 through 11
+#define TEST_BASELINE_DWELL_MS      (100)   // Fixed dwell of a full-band scan
+#define TEST_BASELINE_PASS_GAP_MS   (100)   // Wait between two full-band scans
+
+/* Simulated radio: a single AP that starts answering probe requests at a
+ * given time, and only if the dwell time covers its response latency. */
+struct SimulatedRadio {
+    uint8_t apChannel = 6;
+    uint32_t apVisibleAtMs = 0;
+    uint16_t apResponseMs = 10;
+    uint32_t nowMs = 0;
+    FFS_RESULT failWith = FFS_SUCCESS;
+    std::vector<uint8_t> probedChannels;
+    std::vector<uint16_t> dwellTimes;
+
+    /* Time the probe response arrives at, if the radio listens from now on */
+    uint32_t answerMs() const {
+        return (nowMs > apVisibleAtMs ? nowMs : apVisibleAtMs) + apResponseMs;
+    }
+
+    bool answers(uint8_t channel, uint16_t dwellMs) const {
+        return channel == apChannel && answerMs() <= nowMs + dwellMs;
+    }
+
+    static FFS_RESULT probe(void *radio, uint8_t channel, uint16_t dwellMs, const char *ssid, bool *found) {
+        SimulatedRadio *simulated = (SimulatedRadio *) radio;
+
+        if (simulated->failWith != FFS_SUCCESS) {
+            return simulated->failWith;
+        }
+
+        EXPECT_STREQ(TEST_SSID, ssid);
+        simulated->probedChannels.push_back(channel);
+        simulated->dwellTimes.push_back(dwellMs);
+        simulated->nowMs += TEST_CHANNEL_SWITCH_MS;
+        *found = simulated->answers(channel, dwellMs);
+        simulated->nowMs = *found ? simulated->answerMs() : simulated->nowMs + dwellMs;
+        return FFS_SUCCESS;
+    }
+};
+
+class FfsDirectedScanEngineTests : public ::testing::Test {
+protected:
+    SimulatedRadio radio;
+    FfsDirectedScanEngine_t engine;
+
+    void SetUp() override {
+        ffsDirectedScanEngineInit(&engine, SimulatedRadio::probe, &radio, TEST_ALL_2_4G_CHANNELS);
+    }
+
+    /* Time-to-discovery of a fixed-dwell, full-band scan of the same radio */
+    static uint32_t baselineDiscoveryMs(SimulatedRadio radio) {
+        for (int pass = 0; pass < FFS_MAX_RETRY_DIRECTED_SCAN; pass++) {
+            for (uint8_t channel = 1; channel <= 11; channel++) {
+                radio.nowMs += TEST_CHANNEL_SWITCH_MS;
+                if (radio.answers(channel, TEST_BASELINE_DWELL_MS)) {
+                    // The results of a full-band scan are only reported at the end.
+                    radio.nowMs += (11 - channel + 1) * (TEST_BASELINE_DWELL_MS + TEST_CHANNEL_SWITCH_MS)
+                            - TEST_CHANNEL_SWITCH_MS;
+                    return radio.nowMs;
+                }
+                radio.nowMs += TEST_BASELINE_DWELL_MS;
+            }
+            radio.nowMs += TEST_BASELINE_PASS_GAP_MS;
+        }
+        return UINT32_MAX;
+    }
+};
+
+TEST_F(FfsDirectedScanEngineTests, OrdersLastSeenThenSocialChannels)
+{
+    uint8_t channels[FFS_DIRECTED_SCAN_MAX_CHANNEL];
+
+    ASSERT_EQ(11, ffsDirectedScanEngineGetChannelOrder(&engine, channels));
+    const uint8_t expected[] = { 1, 6, 11, 2, 3, 4, 5, 7, 8, 9, 10 };
+    ASSERT_EQ(0, memcmp(expected, channels, sizeof(expected)));
+
+    engine.lastChannel = 9;
+    ASSERT_EQ(11, ffsDirectedScanEngineGetChannelOrder(&engine, channels));
+    const uint8_t expectedWithLast[] = { 9, 1, 6, 11, 2, 3, 4, 5, 7, 8, 10 };
+    ASSERT_EQ(0, memcmp(expectedWithLast, channels, sizeof(expectedWithLast)));
+
+    // Disabled channels are skipped, whatever their priority.
+    engine.channelMask = (1 << (6 - 1)) | (1 << (9 - 1)) | (1 << (12 - 1));
+    ASSERT_EQ(3, ffsDirectedScanEngineGetChannelOrder(&engine, channels));
+    const uint8_t expectedMasked[] = { 9, 6, 12 };
+    ASSERT_EQ(0, memcmp(expectedMasked, channels, sizeof(expectedMasked)));
+}
+
+TEST_F(FfsDirectedScanEngineTests, StopsOnFirstMatch)
+{
+    bool found = false;
+    uint8_t channel = 0;
+
+    radio.apChannel = 6;
+    ASSERT_EQ(FFS_SUCCESS, ffsDirectedScanEngineRun(&engine, TEST_SSID, FFS_MAX_RETRY_DIRECTED_SCAN,
+            FFS_DIRECTED_SCAN_MAX_TIME_MS, &found,
+            &channel));
+
+    ASSERT_TRUE(found);
+    ASSERT_EQ(6, channel);
+    ASSERT_EQ(6, engine.lastChannel);
+    ASSERT_EQ((std::vector<uint8_t> { 1, 6 }), radio.probedChannels);
+}
+
+TEST_F(FfsDirectedScanEngineTests, ProbesLastSeenChannelFirst)
+{
+    bool found = false;
+    uint8_t channel = 0;
+
+    radio.apChannel = 8;
+    ASSERT_EQ(FFS_SUCCESS, ffsDirectedScanEngineRun(&engine, TEST_SSID, FFS_MAX_RETRY_DIRECTED_SCAN,
+            FFS_DIRECTED_SCAN_MAX_TIME_MS, &found,
+            &channel));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(8, channel);
+
+    // The next search (e.g. after a reboot into the same network) finds it on the first probe.
+    radio.probedChannels.clear();
+    radio.dwellTimes.clear();
+    ASSERT_EQ(FFS_SUCCESS, ffsDirectedScanEngineRun(&engine, TEST_SSID, FFS_MAX_RETRY_DIRECTED_SCAN,
+            FFS_DIRECTED_SCAN_MAX_TIME_MS, &found,
+            &channel));
+    ASSERT_TRUE(found);
+    ASSERT_EQ((std::vector<uint8_t> { 8 }), radio.probedChannels);
+    ASSERT_EQ(2 * FFS_DIRECTED_SCAN_MIN_DWELL_MS, radio.dwellTimes[0]);
+}
+
+TEST_F(FfsDirectedScanEngineTests, AdaptsDwellToSlowAccessPoint)
+{
+    bool found = false;
+    uint8_t channel = 0;
+
+    // Answers slower than the first dwell time.
+    radio.apChannel = 3;
+    radio.apResponseMs = 70;
+    ASSERT_EQ(FFS_SUCCESS, ffsDirectedScanEngineRun(&engine, TEST_SSID, FFS_MAX_RETRY_DIRECTED_SCAN,
+            FFS_DIRECTED_SCAN_MAX_TIME_MS, &found,
+            &channel));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(3, channel);
+
+    // 20 ms, then 80 ms on the second pass.
+    std::vector<uint16_t> channelDwellTimes;
+    for (size_t index = 0; index < radio.probedChannels.size(); index++) {
+        if (radio.probedChannels[index] == 3) {
+            channelDwellTimes.push_back(radio.dwellTimes[index]);
+        }
+    }
+    ASSERT_EQ((std::vector<uint16_t> { 20, 80 }), channelDwellTimes);
+
+    // The dwell time never goes past the maximum.
+    for (uint16_t dwellMs : radio.dwellTimes) {
+        ASSERT_LE(dwellMs, FFS_DIRECTED_SCAN_MAX_DWELL_MS);
+    }
+}
+
+TEST_F(FfsDirectedScanEngineTests, CapsDwellWhenNotFound)
+{
+    bool found = true;
+    uint8_t channel = 0;
+
+    radio.apChannel = 0;
+    ASSERT_EQ(FFS_SUCCESS, ffsDirectedScanEngineRun(&engine, TEST_SSID, FFS_MAX_RETRY_DIRECTED_SCAN,
+            FFS_DIRECTED_SCAN_MAX_TIME_MS, &found,
+            &channel));
+    ASSERT_FALSE(found);
+    ASSERT_EQ(0, channel);
+    ASSERT_EQ(0, engine.lastChannel);
+    ASSERT_EQ(FFS_DIRECTED_SCAN_MAX_DWELL_MS, radio.dwellTimes.back());
+}
+
+TEST_F(FfsDirectedScanEngineTests, StopsAtMaximumTime)
+{
+    bool found = true;
+    uint32_t totalDwellMs = 0;
+
+    // Absent network: the search gives up well before all the passes.
+    radio.apChannel = 0;
+    ASSERT_EQ(FFS_SUCCESS, ffsDirectedScanEngineRun(&engine, TEST_SSID, FFS_MAX_RETRY_DIRECTED_SCAN,
+            FFS_DIRECTED_SCAN_MAX_TIME_MS, &found, nullptr));
+    ASSERT_FALSE(found);
+    for (uint16_t dwellMs : radio.dwellTimes) {
+        totalDwellMs += dwellMs;
+    }
+    ASSERT_LE(totalDwellMs, FFS_DIRECTED_SCAN_MAX_TIME_MS);
+    ASSERT_GT(totalDwellMs + FFS_DIRECTED_SCAN_MAX_DWELL_MS, FFS_DIRECTED_SCAN_MAX_TIME_MS);
+    ASSERT_LT(radio.probedChannels.size(), 11u * FFS_MAX_RETRY_DIRECTED_SCAN);
+
+    // A budget shorter than the first dwell time probes nothing.
+    radio.probedChannels.clear();
+    ASSERT_EQ(FFS_SUCCESS, ffsDirectedScanEngineRun(&engine, TEST_SSID, FFS_MAX_RETRY_DIRECTED_SCAN,
+            FFS_DIRECTED_SCAN_MIN_DWELL_MS - 1, &found, nullptr));
+    ASSERT_FALSE(found);
+    ASSERT_TRUE(radio.probedChannels.empty());
+}
+
+TEST_F(FfsDirectedScanEngineTests, PropagatesProbeErrors)
+{
+    bool found = true;
+
+    radio.failWith = FFS_ERROR;
+    ASSERT_EQ(FFS_ERROR, ffsDirectedScanEngineRun(&engine, TEST_SSID, FFS_MAX_RETRY_DIRECTED_SCAN,
+            FFS_DIRECTED_SCAN_MAX_TIME_MS, &found,
+            nullptr));
+    ASSERT_FALSE(found);
+}
+
+TEST_F(FfsDirectedScanEngineTests, DiscoversSooner)
+{
+    struct Scenario {
+        const char *name;
+        uint8_t apChannel;
+        uint32_t apVisibleAtMs;
+        uint16_t apResponseMs;
+    };
+    const Scenario scenarios[] = {
+        { "social channel, up", 6, 0, 10 },
+        { "social channel, booting", 11, 1500, 10 },
+        { "other channel, up", 4, 0, 10 },
+        // An AP slower than the first dwell time costs one short pass.
+        { "other channel, slow", 9, 0, 60 },
+    };
+
+    for (const Scenario &scenario : scenarios) {
+        bool found = false;
+
+        SetUp();
+        radio = SimulatedRadio();
+        radio.apChannel = scenario.apChannel;
+        radio.apVisibleAtMs = scenario.apVisibleAtMs;
+        radio.apResponseMs = scenario.apResponseMs;
+
+        const uint32_t baselineMs = baselineDiscoveryMs(radio);
+        ASSERT_EQ(FFS_SUCCESS, ffsDirectedScanEngineRun(&engine, TEST_SSID, FFS_MAX_RETRY_DIRECTED_SCAN,
+            FFS_DIRECTED_SCAN_MAX_TIME_MS, &found,
+                nullptr));
+        ASSERT_TRUE(found) << scenario.name;
+
+        printf("Time to discovery (%s): %u ms, full-band scan: %u ms\n", scenario.name, radio.nowMs, baselineMs);
+        ASSERT_LT(radio.nowMs, baselineMs) << scenario.name;
+    }
+}
@@ -0,0 +1,248 @@
+/** @file sys_memtrack_tests.cpp
+ *
+ * @brief Memory tracking system service tests.
+ */
+
+extern "C" {
+#include "configuration.h"
+#include "system/memtrack/sys_memtrack.h"
+}
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+/* Dump record sizes */
+#define DUMP_HEADER_SIZE    32
+#define DUMP_TAG_SIZE       24
+#define DUMP_SITE_SIZE      12
+#define DUMP_EVENT_SIZE     20
+
+static uint32_t get32(const std::vector<uint8_t> &dump, size_t offset)
+{
+    return dump[offset] | (dump[offset + 1] << 8) | (dump[offset + 2] << 16) | ((uint32_t) dump[offset + 3] << 24);
+}
+
+static uint16_t get16(const std::vector<uint8_t> &dump, size_t offset)
+{
+    return (uint16_t) (dump[offset] | (dump[offset + 1] << 8));
+}
+
+static void appendDump(const uint8_t *data, size_t size, void *param)
+{
+    std::vector<uint8_t> *dump = (std::vector<uint8_t> *) param;
+    dump->insert(dump->end(), data, data + size);
+}
+
+/* Distinct call sites */
+static __attribute__((noinline)) void *allocateFirst(size_t size)
+{
+    return SYS_MEMTRACK_Malloc(size, SYS_MEMTRACK_TAG_FFS);
+}
+
+static __attribute__((noinline)) void *allocateSecond(size_t size)
+{
+    return SYS_MEMTRACK_Malloc(size, SYS_MEMTRACK_TAG_FFS);
+}
+
+class SysMemTrackTests : public ::testing::Test {
+protected:
+    uint32_t mark = 0;
+
+    void SetUp() override {
+        /* Other tests may have left nothing live, but the peaks are global */
+        SYS_MEMTRACK_Reset();
+        mark = SYS_MEMTRACK_Mark();
+    }
+
+    void TearDown() override {
+        ASSERT_EQ(SYS_MEMTRACK_Leaks(SYS_MEMTRACK_TAG_ANY, mark, nullptr, 0), 0u);
+    }
+
+    SYS_MEMTRACK_TAG_STATS stats(SYS_MEMTRACK_TAG tag) {
+        SYS_MEMTRACK_TAG_STATS tagStats;
+        EXPECT_TRUE(SYS_MEMTRACK_TagStats(tag, &tagStats));
+        return tagStats;
+    }
+};
+
+TEST_F(SysMemTrackTests, AccountsLiveAndPeakBytesPerTag)
+{
+    SYS_MEMTRACK_TAG_STATS before = stats(SYS_MEMTRACK_TAG_TLS);
+    uint32_t liveBefore = SYS_MEMTRACK_LiveBytes();
+
+    void *first = SYS_MEMTRACK_Malloc(100, SYS_MEMTRACK_TAG_TLS);
+    void *second = SYS_MEMTRACK_Calloc(4, 50, SYS_MEMTRACK_TAG_TLS);
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    ASSERT_EQ((uintptr_t) first % 8, 0u);
+    ASSERT_EQ(((uint8_t *) second)[199], 0);
+
+    SYS_MEMTRACK_TAG_STATS during = stats(SYS_MEMTRACK_TAG_TLS);
+    ASSERT_EQ(during.liveBytes, before.liveBytes + 300);
+    ASSERT_EQ(during.liveBlocks, before.liveBlocks + 2);
+    ASSERT_EQ(during.allocs, before.allocs + 2);
+    ASSERT_EQ(SYS_MEMTRACK_LiveBytes(), liveBefore + 300);
+
+    SYS_MEMTRACK_Free(first);
+    SYS_MEMTRACK_Free(second);
+
+    SYS_MEMTRACK_TAG_STATS after = stats(SYS_MEMTRACK_TAG_TLS);
+    ASSERT_EQ(after.liveBytes, before.liveBytes);
+    ASSERT_EQ(after.peakBytes, before.liveBytes + 300);
+    ASSERT_EQ(after.frees, before.frees + 2);
+    ASSERT_GE(SYS_MEMTRACK_PeakBytes(), liveBefore + 300);
+
+    SYS_MEMTRACK_Reset();
+    ASSERT_EQ(stats(SYS_MEMTRACK_TAG_TLS).peakBytes, after.liveBytes);
+    ASSERT_FALSE(SYS_MEMTRACK_TagStats(SYS_MEMTRACK_TAG_COUNT, &after));
+    ASSERT_STREQ(SYS_MEMTRACK_TagName(SYS_MEMTRACK_TAG_TLS), "tls");
+    ASSERT_STREQ(SYS_MEMTRACK_TagName(SYS_MEMTRACK_TAG_ANY), "?");
+}
+
+TEST_F(SysMemTrackTests, ReportsLeaksSinceMark)
+{
+    void *early = SYS_MEMTRACK_Malloc(16, SYS_MEMTRACK_TAG_FFS);
+    uint32_t leakMark = SYS_MEMTRACK_Mark();
+    void *leaked = SYS_MEMTRACK_Malloc(24, SYS_MEMTRACK_TAG_FFS);
+    void *freed = SYS_MEMTRACK_Malloc(32, SYS_MEMTRACK_TAG_FFS);
+    void *other = SYS_MEMTRACK_Malloc(40, SYS_MEMTRACK_TAG_OSAL);
+    SYS_MEMTRACK_Free(freed);
+
+    SYS_MEMTRACK_BLOCK_INFO leaks[1];
+    ASSERT_EQ(SYS_MEMTRACK_Leaks(SYS_MEMTRACK_TAG_FFS, leakMark, leaks, 1), 1u);
+    ASSERT_EQ(leaks[0].ptr, leaked);
+    ASSERT_EQ(leaks[0].size, 24u);
+    ASSERT_EQ(leaks[0].tag, SYS_MEMTRACK_TAG_FFS);
+    ASSERT_NE(leaks[0].caller, nullptr);
+
+    /* Counted beyond the array */
+    ASSERT_EQ(SYS_MEMTRACK_Leaks(SYS_MEMTRACK_TAG_ANY, leakMark, leaks, 1), 2u);
+    ASSERT_EQ(SYS_MEMTRACK_Leaks(SYS_MEMTRACK_TAG_ANY, mark, nullptr, 0), 3u);
+
+    SYS_MEMTRACK_Free(early);
+    SYS_MEMTRACK_Free(leaked);
+    SYS_MEMTRACK_Free(other);
+}
+
+TEST_F(SysMemTrackTests, AggregatesCallSites)
+{
+    void *first[3];
+    for (void *&block : first) {
+        block = allocateFirst(10);
+    }
+    void *second = allocateSecond(100);
+
+    SYS_MEMTRACK_SITE sites[2];
+    ASSERT_EQ(SYS_MEMTRACK_Sites(sites, 2), 2u);
+    ASSERT_EQ(sites[0].bytes, 100u);
+    ASSERT_EQ(sites[0].blocks, 1);
+    ASSERT_EQ(sites[1].bytes, 30u);
+    ASSERT_EQ(sites[1].blocks, 3);
+    ASSERT_EQ(sites[1].tag, SYS_MEMTRACK_TAG_FFS);
+    ASSERT_NE(sites[0].caller, sites[1].caller);
+
+    ASSERT_EQ(SYS_MEMTRACK_Sites(sites, 1), 1u);
+    ASSERT_EQ(sites[0].bytes, 100u);
+
+    for (void *block : first) {
+        SYS_MEMTRACK_Free(block);
+    }
+    SYS_MEMTRACK_Free(second);
+    ASSERT_EQ(SYS_MEMTRACK_Sites(sites, 2), 0u);
+}
+
+TEST_F(SysMemTrackTests, HandsForeignBlocksToLibc)
+{
+    SYS_MEMTRACK_TAG_STATS before = stats(SYS_MEMTRACK_TAG_OTHER);
+    std::vector<uint8_t> dump;
+    SYS_MEMTRACK_Dump(appendDump, &dump);
+    uint32_t foreignFrees = get32(dump, 28);
+
+    /* Allocated by the C library */
+    SYS_MEMTRACK_Free(malloc(64));
+    SYS_MEMTRACK_Free(nullptr);
+
+    SYS_MEMTRACK_TAG_STATS after = stats(SYS_MEMTRACK_TAG_OTHER);
+    ASSERT_EQ(after.frees, before.frees);
+    ASSERT_EQ(after.liveBlocks, before.liveBlocks);
+    dump.clear();
+    SYS_MEMTRACK_Dump(appendDump, &dump);
+    ASSERT_EQ(get32(dump, 28), foreignFrees + 1);
+}
+
+TEST_F(SysMemTrackTests, CountsFailures)
+{
+    SYS_MEMTRACK_TAG_STATS before = stats(SYS_MEMTRACK_TAG_OTHER);
+
+    ASSERT_EQ(SYS_MEMTRACK_Calloc(SIZE_MAX / 2, 4, SYS_MEMTRACK_TAG_OTHER), nullptr);
+    ASSERT_EQ(SYS_MEMTRACK_Malloc(SIZE_MAX - 8, SYS_MEMTRACK_TAG_OTHER), nullptr);
+
+    ASSERT_EQ(stats(SYS_MEMTRACK_TAG_OTHER).failures, before.failures + 2);
+    ASSERT_EQ(stats(SYS_MEMTRACK_TAG_OTHER).liveBlocks, before.liveBlocks);
+}
+
+TEST_F(SysMemTrackTests, DumpsStatisticsSitesAndTimeline)
+{
+    void *block = allocateFirst(48);
+    void *freed = SYS_MEMTRACK_Malloc(16, SYS_MEMTRACK_TAG_TCPIP);
+    SYS_MEMTRACK_Free(freed);
+
+    std::vector<uint8_t> dump;
+    size_t written = SYS_MEMTRACK_Dump(appendDump, &dump);
+    ASSERT_EQ(written, dump.size());
+
+    ASSERT_EQ(get32(dump, 0), SYS_MEMTRACK_DUMP_MAGIC);
+    ASSERT_EQ(get16(dump, 4), SYS_MEMTRACK_DUMP_VERSION);
+    ASSERT_EQ(get16(dump, 6), SYS_MEMTRACK_TAG_COUNT);
+    uint16_t siteCount = get16(dump, 8);
+    uint16_t eventCount = get16(dump, 10);
+    ASSERT_EQ(siteCount, 1);
+    ASSERT_EQ(eventCount, 3);
+    ASSERT_EQ(get32(dump, 12), (uint32_t) SYS_MEMTRACK_TICK_RATE);
+    ASSERT_EQ(get32(dump, 16), (uint32_t) SYS_MEMTRACK_HEAP_SIZE);
+    ASSERT_EQ(written, (size_t) (DUMP_HEADER_SIZE + SYS_MEMTRACK_TAG_COUNT * DUMP_TAG_SIZE
+            + siteCount * DUMP_SITE_SIZE + eventCount * DUMP_EVENT_SIZE));
+
+    size_t tags = DUMP_HEADER_SIZE;
+    ASSERT_EQ(get32(dump, tags + SYS_MEMTRACK_TAG_FFS * DUMP_TAG_SIZE), stats(SYS_MEMTRACK_TAG_FFS).liveBytes);
+    ASSERT_EQ(get32(dump, tags + SYS_MEMTRACK_TAG_TCPIP * DUMP_TAG_SIZE + 4), stats(SYS_MEMTRACK_TAG_TCPIP).peakBytes);
+
+    size_t sites = tags + SYS_MEMTRACK_TAG_COUNT * DUMP_TAG_SIZE;
+    ASSERT_EQ(get32(dump, sites + 4), 48u);
+    ASSERT_EQ(dump[sites + 10], SYS_MEMTRACK_TAG_FFS);
+
+    /* Oldest event first */
+    size_t events = sites + siteCount * DUMP_SITE_SIZE;
+    ASSERT_EQ(get32(dump, events + 8), 48u);
+    ASSERT_EQ(dump[events + 16], SYS_MEMTRACK_TAG_FFS);
+    ASSERT_EQ(dump[events + 17], SYS_MEMTRACK_EVENT_ALLOC);
+    size_t last = events + 2 * DUMP_EVENT_SIZE;
+    ASSERT_EQ(get32(dump, last + 8), 16u);
+    ASSERT_EQ(get32(dump, last + 12), stats(SYS_MEMTRACK_TAG_TCPIP).liveBytes);
+    ASSERT_EQ(dump[last + 16], SYS_MEMTRACK_TAG_TCPIP);
+    ASSERT_EQ(dump[last + 17], SYS_MEMTRACK_EVENT_FREE);
+
+    SYS_MEMTRACK_Free(block);
+}
+
+TEST_F(SysMemTrackTests, TimelineKeepsNewestEvents)
+{
+    for (size_t index = 0; index < SYS_MEMTRACK_EVENT_LOG_SIZE; index++) {
+        SYS_MEMTRACK_Free(SYS_MEMTRACK_Malloc(index + 1, SYS_MEMTRACK_TAG_OSAL));
+    }
+
+    std::vector<uint8_t> dump;
+    SYS_MEMTRACK_Dump(appendDump, &dump);
+
+    ASSERT_EQ(get16(dump, 10), SYS_MEMTRACK_EVENT_LOG_SIZE);
+    ASSERT_EQ(get32(dump, 24), (uint32_t) SYS_MEMTRACK_EVENT_LOG_SIZE);
+
+    /* The first half of the allocations was overwritten */
+    size_t events = DUMP_HEADER_SIZE + SYS_MEMTRACK_TAG_COUNT * DUMP_TAG_SIZE + get16(dump, 8) * DUMP_SITE_SIZE;
+    ASSERT_EQ(get32(dump, events + 8), (uint32_t) (SYS_MEMTRACK_EVENT_LOG_SIZE / 2 + 1));
+    ASSERT_EQ(dump[events + 17], SYS_MEMTRACK_EVENT_ALLOC);
+    size_t last = events + (SYS_MEMTRACK_EVENT_LOG_SIZE - 1) * DUMP_EVENT_SIZE;
+    ASSERT_EQ(get32(dump, last + 8), (uint32_t) SYS_MEMTRACK_EVENT_LOG_SIZE);
+    ASSERT_EQ(dump[last + 17], SYS_MEMTRACK_EVENT_FREE);
+}
@@ -0,0 +1,343 @@
+/** @file sys_scancache_tests.cpp
+ *
+ * @brief Wi-Fi scan cache system service tests.
+ */
+
+extern "C" {
+#include "configuration.h"
+#include "system/scancache/sys_scancache.h"
+
+uint32_t sysScanCacheHostTick;
+}
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+struct Notification {
+    SYS_SCANCACHE_EVENT event;
+    uint8_t lastBssidByte;
+    uint32_t generation;
+};
+
+class SysScanCacheTests : public ::testing::Test {
+protected:
+    int scans = 0;
+    bool scanStarts = true;
+    std::vector<Notification> notifications;
+
+    static bool scan(void *param) {
+        SysScanCacheTests *test = (SysScanCacheTests *) param;
+        test->scans++;
+        return test->scanStarts;
+    }
+
+    static void notify(SYS_SCANCACHE_EVENT event, const SYS_SCANCACHE_ENTRY *pEntry, uint32_t generation, void *cookie) {
+        SysScanCacheTests *test = (SysScanCacheTests *) cookie;
+        test->notifications.push_back({ event, pEntry ? pEntry->bssInfo.ctx.bssid.addr[5] : (uint8_t) 0, generation });
+    }
+
+    void SetUp() override {
+        sysScanCacheHostTick = 0;
+        SYS_SCANCACHE_Initialize();
+        SYS_SCANCACHE_SetScanner(scan, this);
+        ASSERT_NE(SYS_SCANCACHE_Subscribe(notify, this), SYS_SCANCACHE_CLIENT_INVALID);
+    }
+
+    static WDRV_PIC32MZW_BSS_INFO bss(uint8_t id, int8_t rssi) {
+        WDRV_PIC32MZW_BSS_INFO info;
+        memset(&info, 0, sizeof(info));
+        info.ctx.bssid.addr[5] = id;
+        info.ctx.bssid.valid = true;
+        info.ctx.ssid.length = (uint8_t) snprintf((char *) info.ctx.ssid.name, sizeof(info.ctx.ssid.name), "AP%d", id);
+        info.ctx.channel = 6;
+        info.rssi = rssi;
+        return info;
+    }
+
+    static WDRV_PIC32MZW_BSS_INFO bss(uint8_t id, int8_t rssi, const char *ssid) {
+        WDRV_PIC32MZW_BSS_INFO info = bss(id, rssi);
+        memset(info.ctx.ssid.name, 0, sizeof(info.ctx.ssid.name));
+        info.ctx.ssid.length = (uint8_t) strlen(ssid);
+        memcpy(info.ctx.ssid.name, ssid, info.ctx.ssid.length);
+        info.ctx.cloaked = info.ctx.ssid.length == 0;
+        return info;
+    }
+
+    static std::string ssid(uint8_t index) {
+        SYS_SCANCACHE_ENTRY entry;
+        if (!SYS_SCANCACHE_Get(index, &entry)) {
+            return "<none>";
+        }
+        return std::string((const char *) entry.bssInfo.ctx.ssid.name, entry.bssInfo.ctx.ssid.length);
+    }
+
+    /* Delivers the results of a scan as the driver does */
+    void deliver(std::vector<WDRV_PIC32MZW_BSS_INFO> results) {
+        if (results.empty()) {
+            ASSERT_TRUE(SYS_SCANCACHE_ScanHandler(0, 0, 0, nullptr));
+            return;
+        }
+        for (size_t index = 0; index < results.size(); index++) {
+            ASSERT_TRUE(SYS_SCANCACHE_ScanHandler(0, (uint8_t) (index + 1), (uint8_t) results.size(), &results[index]));
+        }
+    }
+
+    size_t count(SYS_SCANCACHE_EVENT event) {
+        size_t events = 0;
+        for (const Notification &notification : notifications) {
+            events += notification.event == event;
+        }
+        return events;
+    }
+};
+
+TEST_F(SysScanCacheTests, AttachesRequestsToScanInFlight)
+{
+    ASSERT_EQ(SYS_SCANCACHE_Request(0), SYS_SCANCACHE_RESULT_STARTED);
+    ASSERT_TRUE(SYS_SCANCACHE_IsScanning());
+    ASSERT_EQ(SYS_SCANCACHE_Request(0), SYS_SCANCACHE_RESULT_ATTACHED);
+    ASSERT_EQ(SYS_SCANCACHE_Request(60000), SYS_SCANCACHE_RESULT_ATTACHED);
+    ASSERT_EQ(scans, 1);
+
+    deliver({ bss(1, -40), bss(2, -60) });
+
+    ASSERT_FALSE(SYS_SCANCACHE_IsScanning());
+    ASSERT_EQ(SYS_SCANCACHE_Generation(), 1u);
+    ASSERT_EQ(SYS_SCANCACHE_Count(), 2);
+    ASSERT_EQ(count(SYS_SCANCACHE_EVENT_ADDED), 2u);
+    ASSERT_EQ(count(SYS_SCANCACHE_EVENT_SCAN_DONE), 1u);
+    ASSERT_EQ(notifications.back().generation, 1u);
+
+    SYS_SCANCACHE_STATS stats;
+    SYS_SCANCACHE_StatsGet(&stats);
+    ASSERT_EQ(stats.scans, 1u);
+    ASSERT_EQ(stats.coalesced, 2u);
+}
+
+TEST_F(SysScanCacheTests, ServesRecentTableWithoutScanning)
+{
+    /* Never scanned: a maximum age does not help */
+    ASSERT_EQ(SYS_SCANCACHE_Request(60000), SYS_SCANCACHE_RESULT_STARTED);
+    deliver({ bss(1, -40) });
+
+    sysScanCacheHostTick = 2000;
+    ASSERT_EQ(SYS_SCANCACHE_Request(5000), SYS_SCANCACHE_RESULT_CACHED);
+    ASSERT_EQ(SYS_SCANCACHE_Request(1000), SYS_SCANCACHE_RESULT_STARTED);
+    ASSERT_EQ(scans, 2);
+
+    SYS_SCANCACHE_ENTRY entry;
+    ASSERT_TRUE(SYS_SCANCACHE_Get(0, &entry));
+    ASSERT_EQ(entry.age, 2000u);
+    ASSERT_EQ(entry.generation, 1u);
+    ASSERT_FALSE(SYS_SCANCACHE_Get(1, &entry));
+}
+
+TEST_F(SysScanCacheTests, NotifiesChangedEntriesOnly)
+{
+    SYS_SCANCACHE_Request(0);
+    deliver({ bss(1, -40), bss(2, -60) });
+    notifications.clear();
+
+    sysScanCacheHostTick = 1000;
+    SYS_SCANCACHE_Request(0);
+    deliver({ bss(1, -40), bss(2, -50) });
+
+    ASSERT_EQ(notifications.size(), 2u);
+    ASSERT_EQ(notifications[0].event, SYS_SCANCACHE_EVENT_UPDATED);
+    ASSERT_EQ(notifications[0].lastBssidByte, 2);
+    ASSERT_EQ(notifications[0].generation, 2u);
+
+    /* Refreshed even if unchanged */
+    uint8_t bssid[WDRV_PIC32MZW_MAC_ADDR_LEN] = { 0, 0, 0, 0, 0, 1 };
+    SYS_SCANCACHE_ENTRY entry;
+    ASSERT_TRUE(SYS_SCANCACHE_Find(bssid, &entry));
+    ASSERT_EQ(entry.generation, 2u);
+    ASSERT_EQ(entry.age, 0u);
+    bssid[5] = 3;
+    ASSERT_FALSE(SYS_SCANCACHE_Find(bssid, &entry));
+}
+
+TEST_F(SysScanCacheTests, RemovesAgedEntriesAtEndOfScan)
+{
+    SYS_SCANCACHE_Request(0);
+    deliver({ bss(1, -40), bss(2, -60), bss(3, -70) });
+
+    sysScanCacheHostTick = 20000;
+    SYS_SCANCACHE_Request(0);
+    deliver({ bss(3, -70) });
+    ASSERT_EQ(SYS_SCANCACHE_Count(), 3);
+
+    sysScanCacheHostTick = 40000;
+    SYS_SCANCACHE_Request(0);
+    notifications.clear();
+    deliver({ bss(1, -40) });
+
+    /* Entry 2 not seen for 40 s, entry 3 for 20 s */
+    ASSERT_EQ(notifications.size(), 2u);
+    ASSERT_EQ(notifications[0].event, SYS_SCANCACHE_EVENT_REMOVED);
+    ASSERT_EQ(notifications[0].lastBssidByte, 2);
+    ASSERT_EQ(notifications[1].event, SYS_SCANCACHE_EVENT_SCAN_DONE);
+
+    SYS_SCANCACHE_ENTRY entry;
+    ASSERT_EQ(SYS_SCANCACHE_Count(), 2);
+    ASSERT_TRUE(SYS_SCANCACHE_Get(1, &entry));
+    ASSERT_EQ(entry.bssInfo.ctx.bssid.addr[5], 3);
+    ASSERT_EQ(entry.age, 20000u);
+}
+
+TEST_F(SysScanCacheTests, ReplacesOldestOrWeakestEntryWhenFull)
+{
+    SYS_SCANCACHE_Request(0);
+    deliver({ bss(1, -40), bss(2, -80), bss(3, -50), bss(4, -60) });
+
+    /* Entries of the previous scan go first, the weakest one first */
+    SYS_SCANCACHE_Request(0);
+    notifications.clear();
+    deliver({ bss(1, -40), bss(5, -90) });
+    ASSERT_EQ(notifications[0].event, SYS_SCANCACHE_EVENT_REMOVED);
+    ASSERT_EQ(notifications[0].lastBssidByte, 2);
+    ASSERT_EQ(notifications[1].event, SYS_SCANCACHE_EVENT_ADDED);
+    ASSERT_EQ(notifications[1].lastBssidByte, 5);
+
+    /* Table full of this scan: a weaker BSS is dropped, a stronger one
+       replaces the weakest */
+    SYS_SCANCACHE_Request(0);
+    notifications.clear();
+    deliver({ bss(1, -40), bss(3, -50), bss(4, -60), bss(5, -90), bss(6, -95), bss(7, -45) });
+    ASSERT_EQ(count(SYS_SCANCACHE_EVENT_ADDED), 1u);
+    ASSERT_EQ(count(SYS_SCANCACHE_EVENT_REMOVED), 1u);
+
+    uint8_t bssid[WDRV_PIC32MZW_MAC_ADDR_LEN] = { 0, 0, 0, 0, 0, 7 };
+    SYS_SCANCACHE_ENTRY entry;
+    ASSERT_TRUE(SYS_SCANCACHE_Find(bssid, &entry));
+    bssid[5] = 5;
+    ASSERT_FALSE(SYS_SCANCACHE_Find(bssid, &entry));
+
+    SYS_SCANCACHE_STATS stats;
+    SYS_SCANCACHE_StatsGet(&stats);
+    ASSERT_EQ(stats.dropped, 3u);
+}
+
+TEST_F(SysScanCacheTests, KeepsBssesInByteBudget)
+{
+    const char *longSsid = "A network name of 32 characters";
+
+    /* Four records with a 3 byte SSID fill the table */
+    SYS_SCANCACHE_Request(0);
+    deliver({ bss(1, -40), bss(2, -80), bss(3, -50), bss(4, -60) });
+    ASSERT_EQ(SYS_SCANCACHE_Count(), 4);
+
+    /* A 32 byte SSID takes the room of the three weakest entries */
+    SYS_SCANCACHE_Request(0);
+    notifications.clear();
+    deliver({ bss(5, -30, longSsid) });
+    ASSERT_EQ(notifications.size(), 5u);
+    ASSERT_EQ(notifications[0].lastBssidByte, 2);
+    ASSERT_EQ(notifications[1].lastBssidByte, 4);
+    ASSERT_EQ(notifications[2].lastBssidByte, 3);
+    ASSERT_EQ(count(SYS_SCANCACHE_EVENT_REMOVED), 3u);
+    ASSERT_EQ(notifications[3].event, SYS_SCANCACHE_EVENT_ADDED);
+    ASSERT_EQ(notifications[3].lastBssidByte, 5);
+
+    ASSERT_EQ(SYS_SCANCACHE_Count(), 2);
+    ASSERT_EQ(ssid(0), "AP1");
+    ASSERT_EQ(ssid(1), longSsid);
+
+    /* The record is expanded back into the driver information */
+    uint8_t bssid[WDRV_PIC32MZW_MAC_ADDR_LEN] = { 0, 0, 0, 0, 0, 5 };
+    SYS_SCANCACHE_ENTRY entry;
+    ASSERT_TRUE(SYS_SCANCACHE_Find(bssid, &entry));
+    ASSERT_EQ(entry.bssInfo.rssi, -30);
+    ASSERT_EQ(entry.bssInfo.ctx.channel, 6);
+    ASSERT_TRUE(entry.bssInfo.ctx.bssid.valid);
+    ASSERT_EQ(entry.generation, 2u);
+
+    /* A hidden BSS only takes a record */
+    SYS_SCANCACHE_Request(0);
+    notifications.clear();
+    deliver({ bss(1, -40), bss(5, -30, longSsid), bss(6, -90, "") });
+    ASSERT_EQ(count(SYS_SCANCACHE_EVENT_REMOVED), 0u);
+    ASSERT_EQ(SYS_SCANCACHE_Count(), 3);
+    ASSERT_EQ(ssid(2), "");
+
+    SYS_SCANCACHE_STATS stats;
+    SYS_SCANCACHE_StatsGet(&stats);
+    ASSERT_EQ(stats.dropped, 3u);
+}
+
+TEST_F(SysScanCacheTests, MovesSsidsWhenLengthChanges)
+{
+    SYS_SCANCACHE_Request(0);
+    deliver({ bss(1, -40), bss(2, -50), bss(3, -60), bss(4, -70, "") });
+
+    /* A hidden BSS revealing its SSID takes the 3 bytes left */
+    SYS_SCANCACHE_Request(0);
+    notifications.clear();
+    deliver({ bss(4, -70) });
+    ASSERT_EQ(notifications[0].event, SYS_SCANCACHE_EVENT_UPDATED);
+    ASSERT_EQ(SYS_SCANCACHE_Count(), 4);
+    ASSERT_EQ(ssid(3), "AP4");
+
+    /* A longer SSID moves the others and makes room: entry 3 is the
+       weakest of those seen the longest ago */
+    SYS_SCANCACHE_Request(0);
+    notifications.clear();
+    deliver({ bss(1, -40, "AP1 renamed") });
+    ASSERT_EQ(notifications.size(), 3u);
+    ASSERT_EQ(notifications[0].event, SYS_SCANCACHE_EVENT_REMOVED);
+    ASSERT_EQ(notifications[0].lastBssidByte, 3);
+    ASSERT_EQ(notifications[1].event, SYS_SCANCACHE_EVENT_UPDATED);
+    ASSERT_EQ(notifications[1].lastBssidByte, 1);
+
+    ASSERT_EQ(SYS_SCANCACHE_Count(), 3);
+    ASSERT_EQ(ssid(0), "AP1 renamed");
+    ASSERT_EQ(ssid(1), "AP2");
+    ASSERT_EQ(ssid(2), "AP4");
+}
+
+TEST_F(SysScanCacheTests, ReportsFailedAndLostScans)
+{
+    scanStarts = false;
+    ASSERT_EQ(SYS_SCANCACHE_Request(0), SYS_SCANCACHE_RESULT_ERROR);
+    ASSERT_FALSE(SYS_SCANCACHE_IsScanning());
+    ASSERT_EQ(count(SYS_SCANCACHE_EVENT_SCAN_FAILED), 1u);
+
+    /* The driver never completes the scan */
+    scanStarts = true;
+    ASSERT_EQ(SYS_SCANCACHE_Request(0), SYS_SCANCACHE_RESULT_STARTED);
+    sysScanCacheHostTick = 4000;
+    ASSERT_EQ(SYS_SCANCACHE_Request(0), SYS_SCANCACHE_RESULT_ATTACHED);
+    sysScanCacheHostTick = 6000;
+    ASSERT_EQ(SYS_SCANCACHE_Request(0), SYS_SCANCACHE_RESULT_STARTED);
+    ASSERT_EQ(count(SYS_SCANCACHE_EVENT_SCAN_FAILED), 2u);
+    ASSERT_EQ(scans, 3);
+
+    SYS_SCANCACHE_SetScanner(nullptr, nullptr);
+    deliver({});
+    ASSERT_EQ(SYS_SCANCACHE_Request(0), SYS_SCANCACHE_RESULT_ERROR);
+
+    SYS_SCANCACHE_STATS stats;
+    SYS_SCANCACHE_StatsGet(&stats);
+    ASSERT_EQ(stats.failures, 3u);
+}
+
+TEST_F(SysScanCacheTests, CompletesScanWithoutResults)
+{
+    SYS_SCANCACHE_Request(0);
+    deliver({});
+
+    ASSERT_EQ(SYS_SCANCACHE_Generation(), 1u);
+    ASSERT_EQ(SYS_SCANCACHE_Count(), 0);
+    ASSERT_EQ(notifications.size(), 1u);
+    ASSERT_EQ(notifications[0].event, SYS_SCANCACHE_EVENT_SCAN_DONE);
+
+    /* Client slots are released */
+    SYS_SCANCACHE_CLIENT_HANDLE client = SYS_SCANCACHE_Subscribe(notify, this);
+    ASSERT_NE(client, SYS_SCANCACHE_CLIENT_INVALID);
+    ASSERT_EQ(SYS_SCANCACHE_Subscribe(notify, this), SYS_SCANCACHE_CLIENT_INVALID);
+    SYS_SCANCACHE_Unsubscribe(client);
+    ASSERT_NE(SYS_SCANCACHE_Subscribe(notify, this), SYS_SCANCACHE_CLIENT_INVALID);
+}
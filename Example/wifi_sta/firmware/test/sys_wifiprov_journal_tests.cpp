@@ -0,0 +1,271 @@
+/** @file sys_wifiprov_journal_tests.cpp
+ *
+ * @brief Wi-Fi provisioning configuration journal tests, on simulated NVM.
+ */
+
+#include "sys_wifiprov_journal.h"
+#include "sys_wifiprov_nvm_ram.h"
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+#define NVM_ADDRESS         0x900FC000
+#define NVM_PAGES           4
+#define NVM_SLOTS           (pages * SYS_WIFIPROV_JOURNAL_ROWS_PER_PAGE)
+#define ERASE_POLLS         200
+#define WRITE_POLLS         10
+
+typedef struct {
+    uint32_t counter;
+    uint8_t data[236];
+} TestRecord_t;
+
+class WifiProvJournalTests : public ::testing::Test {
+protected:
+    SYS_WIFIPROV_JOURNAL journal;
+    uint32_t pages;
+
+    void SetUp() override {
+        initialize(NVM_PAGES);
+    }
+
+    void TearDown() override {
+        SYS_WIFIPROV_NVM_RAM_Deinitialize();
+    }
+
+    // Start over on an erased ring of the given number of pages.
+    void initialize(uint32_t pageCount) {
+        pages = pageCount;
+        ASSERT_TRUE(SYS_WIFIPROV_NVM_RAM_Initialize(NVM_ADDRESS, pages, ERASE_POLLS, WRITE_POLLS));
+        reboot();
+    }
+
+    void reboot() {
+        SYS_WIFIPROV_JOURNAL_Initialize(&journal, &sysWifiProvNvmRam, NVM_ADDRESS, pages);
+    }
+
+    static TestRecord_t record(uint32_t counter) {
+        TestRecord_t value;
+        value.counter = counter;
+        for (size_t index = 0; index < sizeof(value.data); index++) {
+            value.data[index] = (uint8_t) (counter + index);
+        }
+        return value;
+    }
+
+    SYS_WIFIPROV_JOURNAL_STATUS save(uint32_t counter) {
+        TestRecord_t value = record(counter);
+        SYS_WIFIPROV_JOURNAL_STATUS status;
+
+        if (!SYS_WIFIPROV_JOURNAL_Append(&journal, &value, sizeof(value))) {
+            return SYS_WIFIPROV_JOURNAL_STATUS_ERROR;
+        }
+        while ((status = SYS_WIFIPROV_JOURNAL_Tasks(&journal)) == SYS_WIFIPROV_JOURNAL_STATUS_BUSY);
+        return status;
+    }
+
+    void expectNewest(uint32_t counter) {
+        TestRecord_t expected = record(counter);
+        TestRecord_t actual;
+
+        reboot();
+        ASSERT_TRUE(SYS_WIFIPROV_JOURNAL_Find(&journal, &actual, sizeof(actual)));
+        ASSERT_EQ(actual.counter, expected.counter);
+        ASSERT_EQ(memcmp(&actual, &expected, sizeof(actual)), 0);
+    }
+
+    void newestRecordAcrossWraps() {
+        for (uint32_t counter = 1; counter <= 3 * NVM_SLOTS + 2; counter++) {
+            ASSERT_EQ(save(counter), SYS_WIFIPROV_JOURNAL_STATUS_READY);
+            expectNewest(counter);
+        }
+    }
+
+    // Tear a write at every row of the second pass, one ring at a time, in
+    // the magic, in the sequence number and in the payload.
+    void tornWriteAtEveryRow() {
+        const uint32_t tears[] = { 2, 6, SYS_WIFIPROV_JOURNAL_HEADER_SIZE + 20 };
+        const uint32_t slots = NVM_SLOTS;
+
+        for (uint32_t test = 0; test < slots * 3; test++) {
+            const uint32_t torn = test / 3;
+            initialize(pages);
+
+            uint32_t counter = 1;
+            for (; counter <= slots + torn; counter++) {
+                ASSERT_EQ(save(counter), SYS_WIFIPROV_JOURNAL_STATUS_READY);
+            }
+
+            SYS_WIFIPROV_NVM_RAM_TearNextWrite(tears[test % 3]);
+            ASSERT_EQ(save(1000), SYS_WIFIPROV_JOURNAL_STATUS_ERROR);
+            expectNewest(counter - 1);
+
+            for (uint32_t last = counter + 2 * slots; counter < last; counter++) {
+                ASSERT_EQ(save(counter), SYS_WIFIPROV_JOURNAL_STATUS_READY);
+                expectNewest(counter);
+            }
+        }
+    }
+};
+
+TEST_F(WifiProvJournalTests, EmptyJournal)
+{
+    TestRecord_t actual;
+    memset(&actual, 0xA5, sizeof(actual));
+
+    ASSERT_FALSE(SYS_WIFIPROV_JOURNAL_Find(&journal, &actual, sizeof(actual)));
+    ASSERT_EQ(actual.counter, 0xA5A5A5A5);
+}
+
+TEST_F(WifiProvJournalTests, NewestRecordAcrossWraps)
+{
+    newestRecordAcrossWraps();
+}
+
+TEST_F(WifiProvJournalTests, NewestRecordAcrossWrapsTwoPages)
+{
+    initialize(2);
+    newestRecordAcrossWraps();
+}
+
+TEST_F(WifiProvJournalTests, NewestRecordAcrossWrapsThreePages)
+{
+    initialize(3);
+    newestRecordAcrossWraps();
+}
+
+TEST_F(WifiProvJournalTests, RejectsOtherRecordLength)
+{
+    ASSERT_EQ(save(1), SYS_WIFIPROV_JOURNAL_STATUS_READY);
+
+    uint8_t shorter[sizeof(TestRecord_t) - 4];
+    reboot();
+    ASSERT_FALSE(SYS_WIFIPROV_JOURNAL_Find(&journal, shorter, sizeof(shorter)));
+}
+
+TEST_F(WifiProvJournalTests, ErasesOnlyWhenEnteringPage)
+{
+    const uint32_t saves = 10 * NVM_SLOTS;
+    SYS_WIFIPROV_NVM_RAM_STATS stats;
+
+    for (uint32_t counter = 1; counter <= saves; counter++) {
+        ASSERT_EQ(save(counter), SYS_WIFIPROV_JOURNAL_STATUS_READY);
+    }
+
+    SYS_WIFIPROV_NVM_RAM_Stats(&stats, false);
+    ASSERT_EQ(stats.rowWrites, saves);
+    ASSERT_EQ(stats.busyViolations, 0u);
+
+    // The first pass runs on blank pages: one erase per page per later pass.
+    ASSERT_EQ(stats.pageErases, (saves - NVM_SLOTS) / SYS_WIFIPROV_JOURNAL_ROWS_PER_PAGE);
+    for (uint32_t page = 0; page < NVM_PAGES; page++) {
+        ASSERT_EQ(SYS_WIFIPROV_NVM_RAM_PageErases(page), stats.pageErases / NVM_PAGES);
+    }
+}
+
+TEST_F(WifiProvJournalTests, WriteLatency)
+{
+    const uint32_t saves = 4 * NVM_SLOTS;
+    SYS_WIFIPROV_NVM_RAM_STATS stats;
+
+    for (uint32_t counter = 1; counter <= saves; counter++) {
+        ASSERT_EQ(save(counter), SYS_WIFIPROV_JOURNAL_STATUS_READY);
+    }
+
+    // An erase and a write per save would wait ERASE_POLLS + WRITE_POLLS.
+    SYS_WIFIPROV_NVM_RAM_Stats(&stats, false);
+    ASSERT_LE(stats.busyPolls / saves,
+            WRITE_POLLS + ERASE_POLLS / SYS_WIFIPROV_JOURNAL_ROWS_PER_PAGE);
+}
+
+TEST_F(WifiProvJournalTests, BootLookupReadsRingOnce)
+{
+    SYS_WIFIPROV_NVM_RAM_STATS stats;
+    TestRecord_t actual;
+
+    for (uint32_t counter = 1; counter <= 2 * NVM_SLOTS + 3; counter++) {
+        ASSERT_EQ(save(counter), SYS_WIFIPROV_JOURNAL_STATUS_READY);
+
+        reboot();
+        SYS_WIFIPROV_NVM_RAM_Stats(&stats, true);
+        ASSERT_TRUE(SYS_WIFIPROV_JOURNAL_Find(&journal, &actual, sizeof(actual)));
+        ASSERT_EQ(actual.counter, counter);
+
+        // Header and payload of every row, then the newest record again.
+        SYS_WIFIPROV_NVM_RAM_Stats(&stats, true);
+        ASSERT_LE(stats.reads, 2 * NVM_SLOTS + 2);
+    }
+}
+
+TEST_F(WifiProvJournalTests, TornWriteKeepsPreviousRecord)
+{
+    for (uint32_t counter = 1; counter <= NVM_SLOTS + 1; counter++) {
+        ASSERT_EQ(save(counter), SYS_WIFIPROV_JOURNAL_STATUS_READY);
+    }
+
+    // Reset in the middle of the header, then in the middle of the payload.
+    SYS_WIFIPROV_NVM_RAM_TearNextWrite(6);
+    ASSERT_EQ(save(100), SYS_WIFIPROV_JOURNAL_STATUS_ERROR);
+    expectNewest(NVM_SLOTS + 1);
+
+    SYS_WIFIPROV_NVM_RAM_TearNextWrite(SYS_WIFIPROV_JOURNAL_HEADER_SIZE + 20);
+    ASSERT_EQ(save(101), SYS_WIFIPROV_JOURNAL_STATUS_ERROR);
+    expectNewest(NVM_SLOTS + 1);
+
+    // The torn rows are skipped, not reprogrammed.
+    for (uint32_t counter = 200; counter < 200 + 2 * NVM_SLOTS; counter++) {
+        ASSERT_EQ(save(counter), SYS_WIFIPROV_JOURNAL_STATUS_READY);
+        expectNewest(counter);
+    }
+}
+
+TEST_F(WifiProvJournalTests, SkipsProgrammedRows)
+{
+    // A configuration left by the single-row layout and a stray row.
+    uint8_t *memory = SYS_WIFIPROV_NVM_RAM_Memory();
+    memset(memory + (NVM_PAGES - 1) * SYS_WIFIPROV_JOURNAL_PAGE_SIZE, 0x00, 256);
+    memset(memory + SYS_WIFIPROV_JOURNAL_PAGE_SIZE + SYS_WIFIPROV_JOURNAL_ROW_SIZE, 0x00, 256);
+
+    for (uint32_t counter = 1; counter <= 2 * NVM_SLOTS; counter++) {
+        ASSERT_EQ(save(counter), SYS_WIFIPROV_JOURNAL_STATUS_READY);
+        expectNewest(counter);
+    }
+}
+
+TEST_F(WifiProvJournalTests, TornWriteAtEveryRowTwoPages)
+{
+    initialize(2);
+    tornWriteAtEveryRow();
+}
+
+TEST_F(WifiProvJournalTests, TornWriteAtEveryRowThreePages)
+{
+    initialize(3);
+    tornWriteAtEveryRow();
+}
+
+TEST_F(WifiProvJournalTests, TornWriteAtEveryRowFourPages)
+{
+    tornWriteAtEveryRow();
+}
+
+TEST_F(WifiProvJournalTests, IgnoresTornHeaderSequence)
+{
+    uint8_t *memory = SYS_WIFIPROV_NVM_RAM_Memory();
+
+    for (uint32_t counter = 1; counter <= 3; counter++) {
+        ASSERT_EQ(save(counter), SYS_WIFIPROV_JOURNAL_STATUS_READY);
+    }
+
+    // A header cut short: valid magic, a sequence number about to wrap and
+    // the rest of the row left erased.
+    const uint32_t header[2] = { 0x4A575057, 0xFFFFFFFE };
+    memcpy(memory + 3 * SYS_WIFIPROV_JOURNAL_ROW_SIZE, header, sizeof(header));
+    expectNewest(3);
+
+    for (uint32_t counter = 4; counter <= 3 * NVM_SLOTS; counter++) {
+        ASSERT_EQ(save(counter), SYS_WIFIPROV_JOURNAL_STATUS_READY);
+        expectNewest(counter);
+    }
+}
@@ -0,0 +1,193 @@
+/** @file tcpip_heap_pool_tests.cpp
+ *
+ * @brief TCP/IP stack pool heap tests.
+ */
+
+extern "C" {
+#include "tcpip/src/tcpip_private.h"
+}
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+
+/* Block header size on the PIC32MZ */
+#define BLOCK_HEADER_SIZE   16
+
+class TcpipHeapPoolTests : public ::testing::Test {
+protected:
+    TCPIP_STACK_HEAP_POOL_ENTRY entries[3] = {
+        { .entrySize = 256, .nBlocks = 2, .nExpBlks = 0 },
+        { .entrySize = 64, .nBlocks = 4, .nExpBlks = 2 },
+        { .entrySize = 1024, .nBlocks = 1, .nExpBlks = 0 },
+    };
+    TCPIP_STACK_HEAP_POOL_CONFIG config = {
+        .heapType = TCPIP_STACK_HEAP_TYPE_INTERNAL_HEAP_POOL,
+        .heapFlags = TCPIP_STACK_HEAP_FLAG_ALLOC_UNCACHED,
+        .heapUsage = TCPIP_STACK_HEAP_USE_DEFAULT,
+        .malloc_fnc = malloc,
+        .calloc_fnc = calloc,
+        .free_fnc = free,
+        .nPoolEntries = 3,
+        .pEntries = entries,
+        .expansionHeapSize = 0,
+    };
+    TCPIP_STACK_HEAP_HANDLE heapH = 0;
+
+    void TearDown() override {
+        if (heapH) {
+            ASSERT_EQ(TCPIP_HEAP_Delete(heapH), TCPIP_STACK_HEAP_RES_OK);
+        }
+    }
+
+    void create() {
+        TCPIP_STACK_HEAP_RES res;
+        heapH = TCPIP_HEAP_CreateInternalPool(&config, &res);
+        ASSERT_NE(heapH, nullptr);
+        ASSERT_EQ(res, TCPIP_STACK_HEAP_RES_OK);
+    }
+
+    TCPIP_HEAP_POOL_ENTRY_LIST entry(int index) {
+        TCPIP_HEAP_POOL_ENTRY_LIST list;
+        EXPECT_TRUE(TCPIP_HEAP_POOL_EntryList(heapH, index, &list));
+        return list;
+    }
+};
+
+TEST_F(TcpipHeapPoolTests, EntriesAreSortedBySize)
+{
+    create();
+
+    ASSERT_EQ(TCPIP_HEAP_POOL_Entries(heapH), 3);
+    ASSERT_EQ(entry(0).blockSize, 64);
+    ASSERT_EQ(entry(1).blockSize, 256);
+    ASSERT_EQ(entry(2).blockSize, 1024);
+    ASSERT_EQ(entry(0).nBlocks, 4);
+    ASSERT_EQ(entry(0).totEntrySize, 4 * (64 + BLOCK_HEADER_SIZE));
+    ASSERT_EQ(TCPIP_HEAP_Size(heapH), (size_t) (4 * 80 + 2 * 272 + 1040));
+    ASSERT_EQ(TCPIP_HEAP_FreeSize(heapH), TCPIP_HEAP_Size(heapH));
+    ASSERT_FALSE(TCPIP_HEAP_POOL_EntryList(heapH, 3, nullptr));
+}
+
+TEST_F(TcpipHeapPoolTests, RejectsInvalidEntries)
+{
+    TCPIP_STACK_HEAP_RES res;
+
+    entries[1].entrySize = 256;
+    ASSERT_EQ(TCPIP_HEAP_CreateInternalPool(&config, &res), nullptr);
+    ASSERT_EQ(res, TCPIP_STACK_HEAP_RES_INIT_ERR);
+
+    entries[1].entrySize = 0;
+    ASSERT_EQ(TCPIP_HEAP_CreateInternalPool(&config, &res), nullptr);
+    ASSERT_EQ(res, TCPIP_STACK_HEAP_RES_INIT_ERR);
+}
+
+TEST_F(TcpipHeapPoolTests, ServesSmallestFittingEntry)
+{
+    create();
+
+    void *small = TCPIP_HEAP_Malloc(heapH, 64);
+    void *medium = TCPIP_HEAP_Malloc(heapH, 65);
+    ASSERT_NE(small, nullptr);
+    ASSERT_NE(medium, nullptr);
+    ASSERT_EQ((uintptr_t) small % BLOCK_HEADER_SIZE, 0u);
+    ASSERT_EQ(entry(0).freeBlocks, 3);
+    ASSERT_EQ(entry(1).freeBlocks, 1);
+    ASSERT_EQ(TCPIP_HEAP_Malloc(heapH, 1025), nullptr);
+    ASSERT_EQ(TCPIP_HEAP_LastError(heapH), TCPIP_STACK_HEAP_RES_NO_MEM);
+
+    ASSERT_EQ(TCPIP_HEAP_Free(heapH, small), (size_t) (64 + BLOCK_HEADER_SIZE));
+    ASSERT_EQ(TCPIP_HEAP_Free(heapH, medium), (size_t) (256 + BLOCK_HEADER_SIZE));
+    ASSERT_EQ(entry(0).maxUsedBlocks, 1);
+    ASSERT_EQ(entry(1).maxUsedBlocks, 1);
+    ASSERT_EQ(TCPIP_HEAP_HighWatermark(heapH), (size_t) (80 + 272));
+}
+
+TEST_F(TcpipHeapPoolTests, BorrowsFromLargerEntryUnlessStrict)
+{
+    create();
+
+    void *blocks[2];
+    blocks[0] = TCPIP_HEAP_Malloc(heapH, 200);
+    blocks[1] = TCPIP_HEAP_Malloc(heapH, 200);
+    void *borrowed = TCPIP_HEAP_Malloc(heapH, 200);
+    ASSERT_NE(borrowed, nullptr);
+    ASSERT_EQ(entry(2).freeBlocks, 0);
+    ASSERT_EQ(TCPIP_HEAP_Free(heapH, borrowed), (size_t) (1024 + BLOCK_HEADER_SIZE));
+    ASSERT_EQ(entry(2).freeBlocks, 1);
+
+    TCPIP_HEAP_Free(heapH, blocks[0]);
+    TCPIP_HEAP_Free(heapH, blocks[1]);
+    ASSERT_EQ(TCPIP_HEAP_Delete(heapH), TCPIP_STACK_HEAP_RES_OK);
+
+    config.heapFlags = (TCPIP_STACK_HEAP_FLAGS) (config.heapFlags | TCPIP_STACK_HEAP_FLAG_POOL_STRICT);
+    create();
+    blocks[0] = TCPIP_HEAP_Malloc(heapH, 200);
+    blocks[1] = TCPIP_HEAP_Malloc(heapH, 200);
+    ASSERT_EQ(TCPIP_HEAP_Malloc(heapH, 200), nullptr);
+    ASSERT_EQ(TCPIP_HEAP_LastError(heapH), TCPIP_STACK_HEAP_RES_NO_MEM);
+    TCPIP_HEAP_Free(heapH, blocks[0]);
+    TCPIP_HEAP_Free(heapH, blocks[1]);
+}
+
+TEST_F(TcpipHeapPoolTests, ExpandsEntryFromExpansionArea)
+{
+    config.heapFlags = (TCPIP_STACK_HEAP_FLAGS) (config.heapFlags | TCPIP_STACK_HEAP_FLAG_POOL_STRICT);
+    config.expansionHeapSize = 3 * (64 + BLOCK_HEADER_SIZE);
+    create();
+
+    void *blocks[7];
+    for (int index = 0; index < 7; index++) {
+        blocks[index] = TCPIP_HEAP_Malloc(heapH, 32);
+        ASSERT_NE(blocks[index], nullptr) << index;
+    }
+    /* Four initial blocks, then two expansions: two blocks and one block */
+    ASSERT_EQ(entry(0).nBlocks, 7);
+    ASSERT_EQ(entry(0).expansionSize, 0);
+    ASSERT_EQ(TCPIP_HEAP_Malloc(heapH, 32), nullptr);
+
+    for (int index = 0; index < 7; index++) {
+        ASSERT_EQ(TCPIP_HEAP_Free(heapH, blocks[index]), (size_t) (64 + BLOCK_HEADER_SIZE));
+    }
+    ASSERT_EQ(entry(0).freeBlocks, 7);
+    ASSERT_EQ(entry(0).maxUsedBlocks, 7);
+}
+
+TEST_F(TcpipHeapPoolTests, RejectsForeignPointers)
+{
+    create();
+
+    uint8_t foreign[64] = { 0 };
+    void *block = TCPIP_HEAP_Malloc(heapH, 64);
+
+    ASSERT_EQ(TCPIP_HEAP_Free(heapH, foreign + BLOCK_HEADER_SIZE), 0u);
+    ASSERT_EQ(TCPIP_HEAP_LastError(heapH), TCPIP_STACK_HEAP_RES_PTR_ERR);
+    ASSERT_EQ(TCPIP_HEAP_Delete(heapH), TCPIP_STACK_HEAP_RES_IN_USE);
+
+    ASSERT_NE(TCPIP_HEAP_Free(heapH, block), 0u);
+}
+
+TEST_F(TcpipHeapPoolTests, ReportsLargestBlockAndFragmentation)
+{
+    create();
+
+    ASSERT_EQ(TCPIP_HEAP_MaxSize(heapH), (size_t) (1024 + BLOCK_HEADER_SIZE));
+    /* The largest block is 1040 of the 1904 free bytes */
+    ASSERT_EQ(TCPIP_HEAP_FragmentationIndex(heapH), 1000u - 1040u * 1000u / 1904u);
+
+    void *large = TCPIP_HEAP_Malloc(heapH, 1024);
+    ASSERT_EQ(TCPIP_HEAP_MaxSize(heapH), (size_t) (256 + BLOCK_HEADER_SIZE));
+
+    void *medium[2] = { TCPIP_HEAP_Malloc(heapH, 256), TCPIP_HEAP_Malloc(heapH, 256) };
+    void *small[3] = { TCPIP_HEAP_Malloc(heapH, 8), TCPIP_HEAP_Malloc(heapH, 8), TCPIP_HEAP_Malloc(heapH, 8) };
+    /* Only one 64 byte block left: all the free space is one block */
+    ASSERT_EQ(TCPIP_HEAP_FreeSize(heapH), (size_t) (64 + BLOCK_HEADER_SIZE));
+    ASSERT_EQ(TCPIP_HEAP_FragmentationIndex(heapH), 0u);
+
+    TCPIP_HEAP_Free(heapH, large);
+    TCPIP_HEAP_Free(heapH, medium[0]);
+    TCPIP_HEAP_Free(heapH, medium[1]);
+    for (void *block : small) {
+        TCPIP_HEAP_Free(heapH, block);
+    }
+}
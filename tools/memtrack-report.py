@@ -0,0 +1,163 @@
+import sys, getopt, struct
+
+# Binary dump of SYS_MEMTRACK_Dump(), see system/memtrack/sys_memtrack.h
+MEMTRACK_MAGIC = 0x4B52544D
+MEMTRACK_VERSION = 1
+HEADER = struct.Struct('<IHHHHIIIII')
+TAG = struct.Struct('<6I')
+SITE = struct.Struct('<IIHBx')
+EVENT = struct.Struct('<IIIIBBxx')
+
+TAG_NAMES = ['other', 'rtos', 'osal', 'tcpip', 'tls', 'ffs']
+EVENT_KINDS = ['alloc', 'free', 'fail']
+
+USAGE = 'memtrack-report.py -i <console log or dump file> [-c <timeline csv>] [-w <timeline width>]'
+
+def tagName(tag):
+	if tag < len(TAG_NAMES):
+		return TAG_NAMES[tag]
+	return 'tag%d' % tag
+
+def readDump(fileName):
+	with open(fileName, 'rb') as fHdl:
+		data = fHdl.read()
+	if data[:4] == struct.pack('<I', MEMTRACK_MAGIC):
+		return data
+	# Console log of the "memtrack dump" command
+	hexData = ''
+	inDump = False
+	for line in data.decode('ascii', 'replace').splitlines():
+		line = line.strip()
+		if line.startswith('MEMTRACK-DUMP-BEGIN'):
+			hexData = ''
+			inDump = True
+		elif line.startswith('MEMTRACK-DUMP-END'):
+			inDump = False
+			dump = bytes.fromhex(hexData)
+			fields = line.split()
+			if len(fields) > 1 and int(fields[1]) != len(dump):
+				raise ValueError('dump is %d bytes, expected %s' % (len(dump), fields[1]))
+		elif inDump:
+			hexData += line
+	if hexData == '' or inDump:
+		raise ValueError('no complete dump in %s' % fileName)
+	return dump
+
+def parseDump(data):
+	(magic, version, tagCount, siteCount, eventCount, tickRate, heapSize,
+		peakBytes, dropped, foreignFrees) = HEADER.unpack_from(data, 0)
+	if magic != MEMTRACK_MAGIC or version != MEMTRACK_VERSION:
+		raise ValueError('not a memtrack dump (magic %08x version %d)' % (magic, version))
+	offset = HEADER.size
+	tags = []
+	for tag in range(tagCount):
+		tags.append(TAG.unpack_from(data, offset))
+		offset += TAG.size
+	sites = []
+	for site in range(siteCount):
+		sites.append(SITE.unpack_from(data, offset))
+		offset += SITE.size
+	events = []
+	for event in range(eventCount):
+		events.append(EVENT.unpack_from(data, offset))
+		offset += EVENT.size
+	return {'tickRate': tickRate, 'heapSize': heapSize, 'peakBytes': peakBytes,
+		'dropped': dropped, 'foreignFrees': foreignFrees,
+		'tags': tags, 'sites': sites, 'events': events}
+
+def printSummary(dump):
+	liveBytes = sum(tag[0] for tag in dump['tags'])
+	print('%-8s %10s %10s %8s %8s %8s %8s' % ('tag', 'live', 'peak', 'blocks', 'allocs', 'frees', 'fails'))
+	for tag, stats in enumerate(dump['tags']):
+		print('%-8s %10d %10d %8d %8d %8d %8d' % ((tagName(tag),) + stats))
+	print('live %d bytes, peak %d bytes' % (liveBytes, dump['peakBytes']))
+	if dump['heapSize']:
+		print('heap %d bytes, headroom at peak %d bytes (%d%%)' % (dump['heapSize'],
+			dump['heapSize'] - dump['peakBytes'],
+			100 * (dump['heapSize'] - dump['peakBytes']) // dump['heapSize']))
+	if dump['foreignFrees']:
+		print('%d untracked blocks freed through the tracker' % dump['foreignFrees'])
+	print('')
+	print('%-12s %-8s %10s %8s' % ('call site', 'tag', 'bytes', 'blocks'))
+	for caller, size, blocks, tag in dump['sites']:
+		print('0x%08x   %-8s %10d %8d' % (caller, tagName(tag), size, blocks))
+
+def printTimeline(dump, width):
+	events = dump['events']
+	print('')
+	if len(events) == 0:
+		print('no timeline events')
+		return
+	if dump['dropped']:
+		print('%d older events not in the timeline' % dump['dropped'])
+	first = events[0][0]
+	last = events[-1][0]
+	span = max(last - first, 1)
+	# Live bytes of every tag at the end of each column
+	tags = sorted(set(event[4] for event in events))
+	columns = {}
+	for tag in tags:
+		columns[tag] = [None] * width
+	for tick, caller, size, tagLive, tag, kind in events:
+		column = min((tick - first) * width // span, width - 1)
+		columns[tag][column] = tagLive
+	for tag in tags:
+		values = columns[tag]
+		level = 0
+		for column in range(width):
+			if values[column] is None:
+				values[column] = level
+			level = values[column]
+		peak = max(max(values), 1)
+		line = ''.join(' .:-=+*#%@'[min(value * 9 // peak + (value > 0), 9)] for value in values)
+		print('%-8s |%s| %d' % (tagName(tag), line, peak))
+	print('%-8s  %.3f s .. %.3f s' % ('', first / dump['tickRate'], last / dump['tickRate']))
+
+def writeCsv(dump, fileName):
+	with open(fileName, 'w') as file:
+		file.write('time,tag,event,size,tag_live_bytes,caller\n')
+		for tick, caller, size, tagLive, tag, kind in dump['events']:
+			eventKind = EVENT_KINDS[kind] if kind < len(EVENT_KINDS) else str(kind)
+			file.write('%.3f,%s,%s,%d,%d,0x%08x\n' % (tick / dump['tickRate'],
+				tagName(tag), eventKind, size, tagLive, caller))
+
+def main(argv):
+	dumpFile = None
+	csvFile = None
+	width = 64
+	try:
+		opts, args = getopt.getopt(argv,"hi:c:w:",["input=","csv=","width="])
+	except getopt.GetoptError:
+		print(USAGE)
+		sys.exit(2)
+
+	for opt, arg in opts:
+		if opt == '-h':
+			print(USAGE)
+			sys.exit()
+		elif opt in ("-i", "--input"):
+			dumpFile = arg
+		elif opt in ("-c", "--csv"):
+			csvFile = arg
+		elif opt in ("-w", "--width"):
+			width = int(arg)
+	if dumpFile is None:
+		print(USAGE)
+		sys.exit(2)
+
+	try:
+		dump = parseDump(readDump(dumpFile))
+	except (ValueError, struct.error) as e:
+		print(e)
+		return 1
+
+	printSummary(dump)
+	printTimeline(dump, width)
+	if csvFile is not None:
+		writeCsv(dump, csvFile)
+		print('timeline written to', csvFile)
+	return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))